@@ -18,6 +18,7 @@
 #include <LibCore/LocalServer.h>
 #include <LibCore/System.h>
 #include <LibCore/SystemServerTakeover.h>
+#include <LibGfx/HelperThreads.h>
 #include <LibIPC/ConnectionFromClient.h>
 #include <LibMain/Main.h>
 #include <LibWeb/Bindings/MainThreadVM.h>
@@ -72,6 +73,9 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
     Web::Platform::EventLoopPlugin::install(*new Ladybird::EventLoopPluginQt);
     Web::Platform::ImageCodecPlugin::install(*new Ladybird::ImageCodecPluginLadybird);
 
+    // Images are decoded and filtered in this process, so let the decoders and filters spread big images over the other cores.
+    Gfx::set_maximum_helper_thread_count(Gfx::helper_thread_count_for_online_processors());
+
     Web::ResourceLoader::initialize(RequestManagerQt::create());
     Web::WebSockets::WebSocketClientManager::initialize(Ladybird::WebSocketClientManagerLadybird::create());
 
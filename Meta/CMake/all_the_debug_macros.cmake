@@ -100,6 +100,7 @@ set(ITEM_RECTS_DEBUG ON)
 set(JOB_DEBUG ON)
 set(JPEG_DEBUG ON)
 set(JS_BYTECODE_DEBUG ON)
+set(JS_JIT_DEBUG ON)
 set(JS_MODULE_DEBUG ON)
 set(KEYBOARD_DEBUG ON)
 set(KEYBOARD_SHORTCUTS_DEBUG ON)
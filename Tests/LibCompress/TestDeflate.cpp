@@ -148,6 +148,58 @@ TEST_CASE(deflate_round_trip_compress_large)
     EXPECT(uncompressed.value() == original);
 }
 
+TEST_CASE(deflate_round_trip_compress_repetitions)
+{
+    // Runs of repeated patterns with different periods make for matches of all lengths, up to the longest possible one
+    auto original = ByteBuffer::create_uninitialized(Compress::DeflateCompressor::block_size * 3).release_value();
+    fill_with_random(original);
+    for (size_t offset = 0; offset + 4096 <= original.size(); offset += 4096) {
+        size_t period = 1 + offset / 4096 % 9;
+        for (size_t i = offset + period; i < offset + 3072; i++)
+            original[i] = original[i - period];
+    }
+
+    for (auto level : { Compress::DeflateCompressor::CompressionLevel::FAST, Compress::DeflateCompressor::CompressionLevel::GOOD, Compress::DeflateCompressor::CompressionLevel::GREAT }) {
+        auto compressed = Compress::DeflateCompressor::compress_all(original, level);
+        EXPECT(!compressed.is_error());
+        EXPECT(compressed.value().size() < original.size() / 2);
+        auto uncompressed = Compress::DeflateDecompressor::decompress_all(compressed.value());
+        EXPECT(!uncompressed.is_error());
+        EXPECT(uncompressed.value() == original);
+    }
+}
+
+TEST_CASE(deflate_round_trip_compress_in_parts)
+{
+    auto original = ByteBuffer::create_zeroed(Compress::DeflateCompressor::block_size * 3).release_value();
+    fill_with_random(original.bytes().trim(original.size() / 2));
+
+    // The parts are compressed independently, and only the last one marks the end of the stream
+    auto compress_part = [](ReadonlyBytes part, bool is_last_part) -> ErrorOr<ByteBuffer> {
+        AllocatingMemoryStream output_stream;
+        auto deflate_stream = TRY(Compress::DeflateCompressor::construct(MaybeOwned<Stream>(output_stream), Compress::DeflateCompressor::CompressionLevel::FAST));
+        TRY(deflate_stream->write_until_depleted(part));
+        if (is_last_part)
+            TRY(deflate_stream->final_flush());
+        else
+            TRY(deflate_stream->final_sync_flush());
+        auto buffer = TRY(ByteBuffer::create_uninitialized(output_stream.used_buffer_size()));
+        TRY(output_stream.read_until_filled(buffer));
+        return buffer;
+    };
+
+    ByteBuffer compressed;
+    size_t const part_size = 20000;
+    for (size_t offset = 0; offset < original.size(); offset += part_size) {
+        auto part = original.bytes().slice(offset, min(part_size, original.size() - offset));
+        compressed.append(MUST(compress_part(part, offset + part.size() == original.size())));
+    }
+
+    auto uncompressed = Compress::DeflateDecompressor::decompress_all(compressed);
+    EXPECT(!uncompressed.is_error());
+    EXPECT(uncompressed.value() == original);
+}
+
 TEST_CASE(deflate_compress_literals)
 {
     // This byte array is known to not produce any back references with our lz77 implementation even at the highest compression settings
@@ -4,6 +4,7 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/Array.h>
 #include <LibCrypto/Checksum/Adler32.h>
 #include <LibCrypto/Checksum/CRC32.h>
 #include <LibTest/TestCase.h>
@@ -20,6 +21,11 @@ TEST_CASE(test_adler32)
     do_test(DeprecatedString("abc").bytes(), 0x024d0127);
     do_test(DeprecatedString("message digest").bytes(), 0x29750586);
     do_test(DeprecatedString("abcdefghijklmnopqrstuvwxyz").bytes(), 0x90860b20);
+
+    // The sums are the biggest they can get with bytes that are all ones, and have to be reduced along the way.
+    Array<u8, 100000> ones;
+    ones.fill(0xff);
+    do_test(ones, 0x149a302c);
 }
 
 TEST_CASE(test_crc32)
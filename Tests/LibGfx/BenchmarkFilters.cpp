@@ -0,0 +1,76 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibTest/TestCase.h>
+
+#include <LibGfx/Bitmap.h>
+#include <LibGfx/Filters/BrightnessFilter.h>
+#include <LibGfx/Filters/ColorFilterChain.h>
+#include <LibGfx/Filters/ContrastFilter.h>
+#include <LibGfx/Filters/FastBoxBlurFilter.h>
+#include <LibGfx/Filters/GrayscaleFilter.h>
+#include <LibGfx/Filters/HueRotateFilter.h>
+#include <LibGfx/Filters/SharpenFilter.h>
+#include <LibGfx/Filters/StackBlurFilter.h>
+
+static NonnullRefPtr<Gfx::Bitmap> create_test_bitmap()
+{
+    int const bitmap_size = 1024;
+    auto bitmap = MUST(Gfx::Bitmap::create(Gfx::BitmapFormat::BGRA8888, { bitmap_size, bitmap_size }));
+    for (int y = 0; y < bitmap_size; ++y) {
+        for (int x = 0; x < bitmap_size; ++x)
+            bitmap->set_pixel(x, y, Color(x * 255 / bitmap_size, y * 255 / bitmap_size, (x ^ y) & 0xff, (x + y) % 256));
+    }
+    return bitmap;
+}
+
+BENCHMARK_CASE(stack_blur)
+{
+    int const run_count = 10;
+    auto bitmap = create_test_bitmap();
+
+    for (int run = 0; run < run_count; run++) {
+        Gfx::StackBlurFilter filter { *bitmap };
+        filter.process_rgba(20, Color::Transparent);
+    }
+}
+
+BENCHMARK_CASE(fast_box_blur)
+{
+    int const run_count = 10;
+    auto bitmap = create_test_bitmap();
+
+    for (int run = 0; run < run_count; run++) {
+        Gfx::FastBoxBlurFilter filter { *bitmap };
+        filter.apply_three_passes(10);
+    }
+}
+
+BENCHMARK_CASE(sharpen_convolution)
+{
+    int const run_count = 10;
+    auto bitmap = create_test_bitmap();
+
+    Gfx::SharpenFilter filter;
+    Gfx::GenericConvolutionFilter<3>::Parameters parameters { Gfx::Matrix<3, float>(0, -1, 0, -1, 5, -1, 0, -1, 0) };
+    for (int run = 0; run < run_count; run++)
+        filter.apply(*bitmap, bitmap->rect(), *bitmap, bitmap->rect(), parameters);
+}
+
+BENCHMARK_CASE(css_color_filters)
+{
+    int const run_count = 10;
+    auto bitmap = create_test_bitmap();
+
+    // Like `filter: grayscale(50%) brightness(120%) contrast(80%) hue-rotate(90deg)`.
+    Gfx::ColorFilterChain chain;
+    chain.append(make<Gfx::GrayscaleFilter>(0.5f));
+    chain.append(make<Gfx::BrightnessFilter>(1.2f));
+    chain.append(make<Gfx::ContrastFilter>(0.8f));
+    chain.append(make<Gfx::HueRotateFilter>(90.0f));
+    for (int run = 0; run < run_count; run++)
+        chain.apply(*bitmap, bitmap->rect(), *bitmap, bitmap->rect());
+}
@@ -6,9 +6,13 @@
 
 #include <LibTest/TestCase.h>
 
+#include <LibGfx/AntiAliasingPainter.h>
 #include <LibGfx/Bitmap.h>
+#include <LibGfx/Font/PathRasterizer.h>
 #include <LibGfx/Font/FontDatabase.h>
+#include <LibGfx/HelperThreads.h>
 #include <LibGfx/Painter.h>
+#include <LibGfx/PixelKernels.h>
 #include <stdio.h>
 
 BENCHMARK_CASE(diagonal_lines)
@@ -52,3 +56,286 @@ BENCHMARK_CASE(fill_with_gradient)
         painter.fill_rect_with_gradient(bitmap->rect(), Color::Blue, Color::Red);
     }
 }
+
+// The cases below run with the fastest pixel kernels the CPU supports, and again with the scalar ones to compare.
+template<typename Callback>
+static void with_pixel_kernels(Gfx::PixelKernels::Implementation implementation, Callback callback)
+{
+    auto default_implementation = Gfx::PixelKernels::implementation();
+    Gfx::PixelKernels::set_implementation(implementation);
+    callback();
+    Gfx::PixelKernels::set_implementation(default_implementation);
+}
+
+static NonnullRefPtr<Gfx::Bitmap> create_translucent_bitmap(Gfx::BitmapFormat format, int size)
+{
+    auto bitmap = Gfx::Bitmap::create(format, { size, size }).release_value_but_fixme_should_propagate_errors();
+    for (int y = 0; y < size; y++) {
+        for (int x = 0; x < size; x++)
+            bitmap->scanline(y)[x] = Color(x & 0xff, y & 0xff, (x + y) & 0xff, (x ^ y) & 0xff).value();
+    }
+    return bitmap;
+}
+
+static void fill_with_alpha(Gfx::PixelKernels::Implementation implementation)
+{
+    int const run_count = 100;
+    int const bitmap_size = 2000;
+
+    auto bitmap = Gfx::Bitmap::create(Gfx::BitmapFormat::BGRA8888, { bitmap_size, bitmap_size }).release_value_but_fixme_should_propagate_errors();
+    Gfx::Painter painter(bitmap);
+
+    with_pixel_kernels(implementation, [&] {
+        for (int run = 0; run < run_count; run++)
+            painter.fill_rect(bitmap->rect(), Color(0, 0, 255, 128));
+    });
+}
+
+BENCHMARK_CASE(fill_with_alpha)
+{
+    fill_with_alpha(Gfx::PixelKernels::implementation());
+}
+
+BENCHMARK_CASE(fill_with_alpha_scalar)
+{
+    fill_with_alpha(Gfx::PixelKernels::Implementation::Scalar);
+}
+
+static void blit_with_alpha(Gfx::PixelKernels::Implementation implementation)
+{
+    int const run_count = 100;
+    int const bitmap_size = 2000;
+
+    auto bitmap = Gfx::Bitmap::create(Gfx::BitmapFormat::BGRx8888, { bitmap_size, bitmap_size }).release_value_but_fixme_should_propagate_errors();
+    auto source = create_translucent_bitmap(Gfx::BitmapFormat::BGRA8888, bitmap_size);
+    Gfx::Painter painter(bitmap);
+
+    with_pixel_kernels(implementation, [&] {
+        for (int run = 0; run < run_count; run++)
+            painter.blit({ 0, 0 }, source, source->rect());
+    });
+}
+
+BENCHMARK_CASE(blit_with_alpha)
+{
+    blit_with_alpha(Gfx::PixelKernels::implementation());
+}
+
+BENCHMARK_CASE(blit_with_alpha_scalar)
+{
+    blit_with_alpha(Gfx::PixelKernels::Implementation::Scalar);
+}
+
+static void blit_with_opacity(Gfx::PixelKernels::Implementation implementation)
+{
+    int const run_count = 100;
+    int const bitmap_size = 2000;
+
+    auto bitmap = Gfx::Bitmap::create(Gfx::BitmapFormat::BGRA8888, { bitmap_size, bitmap_size }).release_value_but_fixme_should_propagate_errors();
+    auto source = create_translucent_bitmap(Gfx::BitmapFormat::BGRx8888, bitmap_size);
+    Gfx::Painter painter(bitmap);
+
+    with_pixel_kernels(implementation, [&] {
+        for (int run = 0; run < run_count; run++)
+            painter.blit({ 0, 0 }, source, source->rect(), 0.5f);
+    });
+}
+
+BENCHMARK_CASE(blit_with_opacity)
+{
+    blit_with_opacity(Gfx::PixelKernels::implementation());
+}
+
+BENCHMARK_CASE(blit_with_opacity_scalar)
+{
+    blit_with_opacity(Gfx::PixelKernels::Implementation::Scalar);
+}
+
+static void blit_rgba(Gfx::PixelKernels::Implementation implementation)
+{
+    int const run_count = 200;
+    int const bitmap_size = 2000;
+
+    auto bitmap = Gfx::Bitmap::create(Gfx::BitmapFormat::BGRx8888, { bitmap_size, bitmap_size }).release_value_but_fixme_should_propagate_errors();
+    auto source = create_translucent_bitmap(Gfx::BitmapFormat::RGBA8888, bitmap_size);
+    Gfx::Painter painter(bitmap);
+
+    with_pixel_kernels(implementation, [&] {
+        for (int run = 0; run < run_count; run++)
+            painter.blit({ 0, 0 }, source, source->rect(), 1.0f, false);
+    });
+}
+
+BENCHMARK_CASE(blit_rgba)
+{
+    blit_rgba(Gfx::PixelKernels::implementation());
+}
+
+BENCHMARK_CASE(blit_rgba_scalar)
+{
+    blit_rgba(Gfx::PixelKernels::Implementation::Scalar);
+}
+
+static void draw_scaled_bitmap_with_alpha(Gfx::PixelKernels::Implementation implementation)
+{
+    int const run_count = 50;
+    int const bitmap_size = 2000;
+
+    auto bitmap = Gfx::Bitmap::create(Gfx::BitmapFormat::BGRx8888, { bitmap_size, bitmap_size }).release_value_but_fixme_should_propagate_errors();
+    auto source = create_translucent_bitmap(Gfx::BitmapFormat::BGRA8888, bitmap_size * 2 / 3);
+    Gfx::Painter painter(bitmap);
+
+    with_pixel_kernels(implementation, [&] {
+        for (int run = 0; run < run_count; run++)
+            painter.draw_scaled_bitmap(bitmap->rect(), source, source->rect());
+    });
+}
+
+BENCHMARK_CASE(draw_scaled_bitmap_with_alpha)
+{
+    draw_scaled_bitmap_with_alpha(Gfx::PixelKernels::implementation());
+}
+
+BENCHMARK_CASE(draw_scaled_bitmap_with_alpha_scalar)
+{
+    draw_scaled_bitmap_with_alpha(Gfx::PixelKernels::Implementation::Scalar);
+}
+
+BENCHMARK_CASE(scaled)
+{
+    int const run_count = 10;
+    auto source = create_translucent_bitmap(Gfx::BitmapFormat::BGRA8888, 2000);
+
+    for (int run = 0; run < run_count; run++)
+        (void)MUST(source->scaled(0.15f, 0.15f));
+}
+
+static void scaled_with_filter(Gfx::ResamplingFilter filter)
+{
+    int const run_count = 10;
+    auto source = create_translucent_bitmap(Gfx::BitmapFormat::BGRA8888, 2000);
+
+    for (int run = 0; run < run_count; run++)
+        (void)MUST(source->scaled_with_filter({ 300, 300 }, filter));
+}
+
+BENCHMARK_CASE(scaled_with_box_filter)
+{
+    scaled_with_filter(Gfx::ResamplingFilter::Box);
+}
+
+BENCHMARK_CASE(scaled_with_bicubic_filter)
+{
+    scaled_with_filter(Gfx::ResamplingFilter::Bicubic);
+}
+
+BENCHMARK_CASE(scaled_with_lanczos3_filter)
+{
+    scaled_with_filter(Gfx::ResamplingFilter::Lanczos3);
+}
+
+BENCHMARK_CASE(scaled_with_lanczos3_filter_on_helper_threads)
+{
+    Gfx::set_maximum_helper_thread_count(3);
+    scaled_with_filter(Gfx::ResamplingFilter::Lanczos3);
+    Gfx::set_maximum_helper_thread_count(0);
+}
+
+BENCHMARK_CASE(draw_scaled_bitmap_with_lanczos)
+{
+    int const run_count = 10;
+    int const bitmap_size = 2000;
+
+    auto bitmap = Gfx::Bitmap::create(Gfx::BitmapFormat::BGRx8888, { bitmap_size, bitmap_size }).release_value_but_fixme_should_propagate_errors();
+    auto source = create_translucent_bitmap(Gfx::BitmapFormat::BGRA8888, bitmap_size * 2 / 3);
+    Gfx::Painter painter(bitmap);
+
+    for (int run = 0; run < run_count; run++)
+        painter.draw_scaled_bitmap(bitmap->rect(), source, source->rect(), 1.0f, Gfx::Painter::ScalingMode::Lanczos);
+}
+
+// A spiral of curves that overlap each other many times, like the shapes on SVG-heavy pages.
+static Gfx::Path create_curvy_path(float size)
+{
+    Gfx::Path path;
+    float center = size / 2;
+    path.move_to({ center, center });
+    for (int i = 1; i <= 200; i++) {
+        float angle = i * 0.7f;
+        float radius = center * i / 200;
+        Gfx::FloatPoint point { center + radius * cosf(angle), center + radius * sinf(angle) };
+        Gfx::FloatPoint control { center + radius * cosf(angle + 1.5f), center - radius * sinf(angle - 1.5f) };
+        path.quadratic_bezier_curve_to(control, point);
+    }
+    path.close();
+    return path;
+}
+
+static void fill_path_antialiased(Gfx::Painter::WindingRule winding_rule)
+{
+    int const run_count = 50;
+    int const bitmap_size = 1000;
+
+    auto bitmap = Gfx::Bitmap::create(Gfx::BitmapFormat::BGRx8888, { bitmap_size, bitmap_size }).release_value_but_fixme_should_propagate_errors();
+    Gfx::Painter painter(bitmap);
+    Gfx::AntiAliasingPainter aa_painter(painter);
+    auto path = create_curvy_path(bitmap_size);
+
+    for (int run = 0; run < run_count; run++)
+        aa_painter.fill_path(path, Color(0, 0, 255, 200), winding_rule);
+}
+
+BENCHMARK_CASE(fill_path_antialiased_nonzero)
+{
+    fill_path_antialiased(Gfx::Painter::WindingRule::Nonzero);
+}
+
+BENCHMARK_CASE(fill_path_antialiased_even_odd)
+{
+    fill_path_antialiased(Gfx::Painter::WindingRule::EvenOdd);
+}
+
+BENCHMARK_CASE(stroke_path_antialiased)
+{
+    int const run_count = 50;
+    int const bitmap_size = 1000;
+
+    auto bitmap = Gfx::Bitmap::create(Gfx::BitmapFormat::BGRx8888, { bitmap_size, bitmap_size }).release_value_but_fixme_should_propagate_errors();
+    Gfx::Painter painter(bitmap);
+    Gfx::AntiAliasingPainter aa_painter(painter);
+    auto path = create_curvy_path(bitmap_size);
+
+    for (int run = 0; run < run_count; run++)
+        aa_painter.stroke_path(path, Color::Blue, 3);
+}
+
+// Small outlines with many strokes, like the glyphs of CJK text.
+BENCHMARK_CASE(rasterize_glyph_outlines)
+{
+    int const glyph_count = 20000;
+    int const glyph_size = 24;
+
+    Gfx::Path path;
+    for (int stroke = 0; stroke < 8; stroke++) {
+        float y = 2.5f + stroke * 2.6f;
+        path.move_to({ 2.3f, y });
+        path.line_to({ 21.7f, y + 0.4f });
+        path.line_to({ 21.7f, y + 1.6f });
+        path.line_to({ 2.3f, y + 1.2f });
+        path.close();
+    }
+    for (int stroke = 0; stroke < 4; stroke++) {
+        float x = 3.2f + stroke * 5.1f;
+        path.move_to({ x, 1.5f });
+        path.cubic_bezier_curve_to({ x + 2, 8 }, { x - 2, 16 }, { x + 0.5f, 22.5f });
+        path.line_to({ x + 2, 22.5f });
+        path.cubic_bezier_curve_to({ x, 16 }, { x + 4, 8 }, { x + 1.5f, 1.5f });
+        path.close();
+    }
+
+    for (int glyph = 0; glyph < glyph_count; glyph++) {
+        Gfx::PathRasterizer rasterizer({ glyph_size, glyph_size });
+        rasterizer.draw_path(path);
+        (void)rasterizer.accumulate();
+    }
+}
@@ -0,0 +1,80 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibCore/ElapsedTimer.h>
+#include <LibCore/File.h>
+#include <LibGfx/HelperThreads.h>
+#include <LibGfx/ImageFormats/PNGLoader.h>
+#include <LibGfx/ImageFormats/PNGWriter.h>
+#include <LibGfx/ImageFormats/QOIWriter.h>
+#include <LibTest/TestCase.h>
+
+#ifdef AK_OS_SERENITY
+#    define TEST_INPUT(x) ("/usr/Tests/LibGfx/test-inputs/" x)
+#else
+#    define TEST_INPUT(x) ("test-inputs/" x)
+#endif
+
+static NonnullRefPtr<Gfx::Bitmap> load_png(StringView path)
+{
+    auto data = MUST(MUST(Core::File::open(path, Core::File::OpenMode::Read))->read_until_eof());
+    auto plugin_decoder = MUST(Gfx::PNGImageDecoderPlugin::create(data));
+    return *MUST(plugin_decoder->frame(0)).image;
+}
+
+// FIXME: Enable formatting when the patch will be mainstream
+//        https://github.com/llvm/llvm-project/commit/fd86789962964a98157e8159c3d95cdc241942e3
+// clang-format off
+auto screen_contents = load_png(TEST_INPUT("screen_contents.png"sv));
+auto big_image = load_png(TEST_INPUT("big_image.png"sv));
+// clang-format on
+
+// The time of each encoding is reported alongside how many bytes of pixels it gets through per second, and how much
+// smaller it makes them.
+static void encode_and_report(StringView mode, Gfx::Bitmap const& bitmap, Function<ErrorOr<ByteBuffer>()> const& encode)
+{
+    auto timer = Core::ElapsedTimer::start_new();
+    auto encoded = MUST(encode());
+    auto microseconds = max(timer.elapsed_time().to_microseconds(), 1);
+    outln("{}x{} {}: {:.1} MB/s, compression ratio {:.2}", bitmap.width(), bitmap.height(), mode,
+        static_cast<double>(bitmap.size_in_bytes()) / microseconds, static_cast<double>(bitmap.size_in_bytes()) / encoded.size());
+}
+
+static void encode_png_and_report(StringView mode, Gfx::Bitmap const& bitmap, Gfx::PNGWriterOptions options)
+{
+    encode_and_report(mode, bitmap, [&] { return Gfx::PNGWriter::encode(bitmap, options); });
+}
+
+BENCHMARK_CASE(png_best)
+{
+    encode_png_and_report("PNG, best compression"sv, screen_contents, {});
+    encode_png_and_report("PNG, best compression"sv, big_image, {});
+}
+
+BENCHMARK_CASE(png_fast)
+{
+    encode_png_and_report("PNG, fast"sv, screen_contents, Gfx::PNGWriterOptions::fast());
+    encode_png_and_report("PNG, fast"sv, big_image, Gfx::PNGWriterOptions::fast());
+}
+
+BENCHMARK_CASE(png_fast_with_helper_threads)
+{
+    Gfx::set_maximum_helper_thread_count(3);
+    encode_png_and_report("PNG, fast with 3 helper threads"sv, screen_contents, Gfx::PNGWriterOptions::fast(true));
+    encode_png_and_report("PNG, fast with 3 helper threads"sv, big_image, Gfx::PNGWriterOptions::fast(true));
+    Gfx::set_maximum_helper_thread_count(0);
+}
+
+BENCHMARK_CASE(png_uncompressed)
+{
+    encode_png_and_report("PNG, uncompressed"sv, screen_contents, { .compression_level = Compress::ZlibCompressionLevel::Fastest });
+}
+
+BENCHMARK_CASE(qoi)
+{
+    encode_and_report("QOI"sv, screen_contents, [&] { return Gfx::QOIWriter::encode(screen_contents); });
+    encode_and_report("QOI"sv, big_image, [&] { return Gfx::QOIWriter::encode(big_image); });
+}
@@ -5,6 +5,8 @@
  */
 
 #include <LibCore/File.h>
+#include <LibGfx/HelperThreads.h>
+#include <LibGfx/ImageFormats/ImageDecoder.h>
 #include <LibGfx/ImageFormats/JPEGLoader.h>
 #include <LibTest/TestCase.h>
 
@@ -21,6 +23,7 @@ auto small_image = Core::File::open(TEST_INPUT("rgb24.jpg"sv), Core::File::OpenM
 auto big_image = Core::File::open(TEST_INPUT("big_image.jpg"sv), Core::File::OpenMode::Read).release_value()->read_until_eof().release_value();
 auto rgb_image = Core::File::open(TEST_INPUT("rgb_components.jpg"sv), Core::File::OpenMode::Read).release_value()->read_until_eof().release_value();
 auto several_scans = Core::File::open(TEST_INPUT("several_scans.jpg"sv), Core::File::OpenMode::Read).release_value()->read_until_eof().release_value();
+auto progressive_image = Core::File::open(TEST_INPUT("successive_approximation.jpg"sv), Core::File::OpenMode::Read).release_value()->read_until_eof().release_value();
 // clang-format on
 
 BENCHMARK_CASE(small_image)
@@ -35,6 +38,14 @@ BENCHMARK_CASE(big_image)
     MUST(plugin_decoder->frame(0));
 }
 
+BENCHMARK_CASE(big_image_with_helper_threads)
+{
+    Gfx::set_maximum_helper_thread_count(3);
+    auto plugin_decoder = MUST(Gfx::JPEGImageDecoderPlugin::create(big_image));
+    MUST(plugin_decoder->frame(0));
+    Gfx::set_maximum_helper_thread_count(0);
+}
+
 BENCHMARK_CASE(rgb_image)
 {
     auto plugin_decoder = MUST(Gfx::JPEGImageDecoderPlugin::create(rgb_image));
@@ -46,3 +57,9 @@ BENCHMARK_CASE(several_scans)
     auto plugin_decoder = MUST(Gfx::JPEGImageDecoderPlugin::create(several_scans));
     MUST(plugin_decoder->frame(0));
 }
+
+BENCHMARK_CASE(progressive_image)
+{
+    auto plugin_decoder = MUST(Gfx::JPEGImageDecoderPlugin::create(progressive_image));
+    MUST(plugin_decoder->frame(0));
+}
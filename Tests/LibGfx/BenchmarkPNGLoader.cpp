@@ -0,0 +1,47 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibCore/File.h>
+#include <LibGfx/ImageFormats/PNGLoader.h>
+#include <LibTest/TestCase.h>
+
+#ifdef AK_OS_SERENITY
+#    define TEST_INPUT(x) ("/usr/Tests/LibGfx/test-inputs/" x)
+#else
+#    define TEST_INPUT(x) ("test-inputs/" x)
+#endif
+
+// FIXME: Enable formatting when the patch will be mainstream
+//        https://github.com/llvm/llvm-project/commit/fd86789962964a98157e8159c3d95cdc241942e3
+// clang-format off
+auto small_image = Core::File::open(TEST_INPUT("buggie.png"sv), Core::File::OpenMode::Read).release_value()->read_until_eof().release_value();
+auto big_image = Core::File::open(TEST_INPUT("big_image.png"sv), Core::File::OpenMode::Read).release_value()->read_until_eof().release_value();
+auto interlaced_image = Core::File::open(TEST_INPUT("filters-rgba-interlaced.png"sv), Core::File::OpenMode::Read).release_value()->read_until_eof().release_value();
+// clang-format on
+
+BENCHMARK_CASE(small_image)
+{
+    auto plugin_decoder = MUST(Gfx::PNGImageDecoderPlugin::create(small_image));
+    MUST(plugin_decoder->frame(0));
+}
+
+BENCHMARK_CASE(big_image)
+{
+    auto plugin_decoder = MUST(Gfx::PNGImageDecoderPlugin::create(big_image));
+    MUST(plugin_decoder->frame(0));
+}
+
+BENCHMARK_CASE(big_image_half_downloaded)
+{
+    auto plugin_decoder = MUST(Gfx::PNGImageDecoderPlugin::create(big_image.bytes().trim(big_image.size() / 2)));
+    MUST(plugin_decoder->partial_frame());
+}
+
+BENCHMARK_CASE(interlaced_image)
+{
+    auto plugin_decoder = MUST(Gfx::PNGImageDecoderPlugin::create(interlaced_image));
+    MUST(plugin_decoder->frame(0));
+}
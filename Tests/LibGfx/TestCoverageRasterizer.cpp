@@ -0,0 +1,183 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibGfx/AntiAliasingPainter.h>
+#include <LibGfx/Bitmap.h>
+#include <LibGfx/CoverageRasterizer.h>
+#include <LibGfx/Painter.h>
+#include <LibGfx/Path.h>
+#include <LibTest/TestCase.h>
+
+// Rasterizes into a grid of coverage values, which also checks that every pixel is only reported once.
+static Vector<Vector<int>> rasterize(Gfx::CoverageRasterizer& rasterizer, Gfx::WindingRule winding_rule = Gfx::WindingRule::Nonzero)
+{
+    auto bounds = rasterizer.bounds();
+    Vector<Vector<int>> coverage;
+    coverage.resize(bounds.height());
+    for (auto& row : coverage)
+        row.resize(bounds.width());
+
+    auto set_coverage = [&](int y, int x, u8 value) {
+        auto& cell = coverage[y - bounds.y()][x - bounds.x()];
+        EXPECT_EQ(cell, 0);
+        cell = value;
+    };
+    rasterizer.rasterize(
+        winding_rule,
+        [&](int y, int x, int length, u8 value) {
+            EXPECT(bounds.contains(Gfx::IntRect { x, y, length, 1 }));
+            for (int i = 0; i < length; ++i)
+                set_coverage(y, x + i, value);
+        },
+        [&](int y, int x, ReadonlyBytes values) {
+            EXPECT(bounds.contains(Gfx::IntRect { x, y, static_cast<int>(values.size()), 1 }));
+            for (size_t i = 0; i < values.size(); ++i)
+                set_coverage(y, x + i, values[i]);
+        });
+    return coverage;
+}
+
+static void add_rect(Gfx::CoverageRasterizer& rasterizer, Gfx::FloatRect const& rect, bool clockwise = true)
+{
+    auto right = rect.x() + rect.width();
+    auto bottom = rect.y() + rect.height();
+    Gfx::FloatPoint points[] { rect.location(), { right, rect.y() }, { right, bottom }, { rect.x(), bottom } };
+    if (!clockwise)
+        swap(points[1], points[3]);
+    rasterizer.add_polygon(points);
+}
+
+TEST_CASE(pixel_aligned_rect)
+{
+    Gfx::CoverageRasterizer rasterizer({ 0, 0, 40, 40 });
+    add_rect(rasterizer, { 3, 5, 30, 20 });
+    auto coverage = rasterize(rasterizer);
+    for (int y = 0; y < 40; ++y) {
+        for (int x = 0; x < 40; ++x) {
+            bool inside = x >= 3 && x < 33 && y >= 5 && y < 25;
+            EXPECT_EQ(coverage[y][x], inside ? 255 : 0);
+        }
+    }
+}
+
+TEST_CASE(half_pixel_edges)
+{
+    Gfx::CoverageRasterizer rasterizer({ 0, 0, 10, 10 });
+    add_rect(rasterizer, { 2.5f, 2.5f, 5, 5 });
+    auto coverage = rasterize(rasterizer);
+    EXPECT_EQ(coverage[2][2], 64);
+    EXPECT_EQ(coverage[2][4], 128);
+    EXPECT_EQ(coverage[4][2], 128);
+    EXPECT_EQ(coverage[4][4], 255);
+    EXPECT_EQ(coverage[7][7], 64);
+    EXPECT_EQ(coverage[8][8], 0);
+}
+
+TEST_CASE(winding_rules)
+{
+    auto add_nested_rects = [](Gfx::CoverageRasterizer& rasterizer, bool inner_clockwise) {
+        add_rect(rasterizer, { 0, 0, 20, 20 });
+        add_rect(rasterizer, { 5, 5, 10, 10 }, inner_clockwise);
+    };
+
+    Gfx::CoverageRasterizer rasterizer({ 0, 0, 20, 20 });
+    add_nested_rects(rasterizer, true);
+    EXPECT_EQ(rasterize(rasterizer, Gfx::WindingRule::Nonzero)[10][10], 255);
+    add_nested_rects(rasterizer, true);
+    EXPECT_EQ(rasterize(rasterizer, Gfx::WindingRule::EvenOdd)[10][10], 0);
+    add_nested_rects(rasterizer, false);
+    EXPECT_EQ(rasterize(rasterizer, Gfx::WindingRule::Nonzero)[10][10], 0);
+    add_nested_rects(rasterizer, false);
+    auto coverage = rasterize(rasterizer, Gfx::WindingRule::EvenOdd);
+    EXPECT_EQ(coverage[10][10], 0);
+    EXPECT_EQ(coverage[2][2], 255);
+}
+
+TEST_CASE(outline_outside_of_bounds)
+{
+    // The rasterized pixels are all inside the rect, but its left, top and bottom edges are not.
+    Gfx::CoverageRasterizer rasterizer({ 10, 10, 20, 20 });
+    add_rect(rasterizer, { -5.5f, -100, 30, 200 });
+    auto coverage = rasterize(rasterizer);
+    for (int y = 0; y < 20; ++y) {
+        EXPECT_EQ(coverage[y][0], 255);
+        EXPECT_EQ(coverage[y][13], 255);
+        EXPECT_EQ(coverage[y][14], 128);
+        EXPECT_EQ(coverage[y][15], 0);
+    }
+}
+
+TEST_CASE(coverage_adds_up_to_area)
+{
+    Gfx::CoverageRasterizer rasterizer({ 0, 0, 100, 60 });
+    Gfx::FloatPoint triangle[] { { 3.3f, 1.7f }, { 97.1f, 20.2f }, { 40.6f, 58.9f } };
+    rasterizer.add_polygon(triangle);
+    float sum = 0;
+    for (auto const& row : rasterize(rasterizer)) {
+        for (auto value : row)
+            sum += value / 255.0f;
+    }
+    float area = 0.5f * fabsf((triangle[1].x() - triangle[0].x()) * (triangle[2].y() - triangle[0].y()) - (triangle[2].x() - triangle[0].x()) * (triangle[1].y() - triangle[0].y()));
+    EXPECT(fabsf(sum - area) < 1.0f);
+}
+
+TEST_CASE(uniform_spans_between_edges)
+{
+    Gfx::CoverageRasterizer rasterizer({ 0, 0, 192, 16 });
+    add_rect(rasterizer, { 0.5f, 0, 191, 16 });
+    int covered_by_uniform_spans = 0;
+    rasterizer.rasterize(
+        Gfx::WindingRule::Nonzero,
+        [&](int, int, int length, u8 coverage) {
+            EXPECT_EQ(coverage, 255);
+            covered_by_uniform_spans += length;
+        },
+        [&](int, int, ReadonlyBytes) {});
+    // Only the first and last tile of each row have edges in them.
+    EXPECT_EQ(covered_by_uniform_spans, 16 * (192 - 2 * Gfx::CoverageRasterizer::tile_size));
+}
+
+TEST_CASE(painter_antialiased_fill_path)
+{
+    auto bitmap = MUST(Gfx::Bitmap::create(Gfx::BitmapFormat::BGRA8888, { 20, 20 }));
+    bitmap->fill(Color::Transparent);
+    Gfx::Painter painter(bitmap);
+    painter.translate(2, 0);
+    Gfx::AntiAliasingPainter aa_painter(painter);
+
+    Gfx::Path path;
+    path.move_to({ 0, 0 });
+    path.line_to({ 10, 0 });
+    path.line_to({ 10, 10.5f });
+    path.line_to({ 0, 10.5f });
+    aa_painter.fill_path(path, Color::Red);
+
+    EXPECT_EQ(bitmap->get_pixel(1, 5), Color::Transparent);
+    EXPECT_EQ(bitmap->get_pixel(2, 0), Color::Red);
+    EXPECT_EQ(bitmap->get_pixel(11, 9), Color::Red);
+    EXPECT_EQ(bitmap->get_pixel(12, 5), Color::Transparent);
+    EXPECT_EQ(bitmap->get_pixel(5, 10), Color(Color::Red).with_alpha(128));
+}
+
+TEST_CASE(painter_stroke_path_does_not_overlap)
+{
+    auto bitmap = MUST(Gfx::Bitmap::create(Gfx::BitmapFormat::BGRA8888, { 20, 20 }));
+    bitmap->fill(Color::Transparent);
+    Gfx::Painter painter(bitmap);
+    Gfx::AntiAliasingPainter aa_painter(painter);
+
+    Gfx::Path path;
+    path.move_to({ 2, 10 });
+    path.line_to({ 18, 10 });
+    path.line_to({ 10, 10 });
+    path.line_to({ 10, 2 });
+    aa_painter.stroke_path(path, Color(255, 0, 0, 128), 2);
+
+    // Where the lines overlap, the color is only blended once.
+    EXPECT_EQ(bitmap->get_pixel(10, 10), Color(255, 0, 0, 128));
+    EXPECT_EQ(bitmap->get_pixel(14, 9), Color(255, 0, 0, 128));
+    EXPECT_EQ(bitmap->get_pixel(14, 12), Color::Transparent);
+}
@@ -0,0 +1,318 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Array.h>
+#include <AK/Atomic.h>
+#include <AK/Random.h>
+#include <LibGfx/Bitmap.h>
+#include <LibGfx/Filters/BoxBlurFilter.h>
+#include <LibGfx/Filters/BrightnessFilter.h>
+#include <LibGfx/Filters/ColorFilterChain.h>
+#include <LibGfx/Filters/FastBoxBlurFilter.h>
+#include <LibGfx/Filters/GrayscaleFilter.h>
+#include <LibGfx/Filters/HueRotateFilter.h>
+#include <LibGfx/Filters/InvertFilter.h>
+#include <LibGfx/Filters/LaplacianFilter.h>
+#include <LibGfx/Filters/SaturateFilter.h>
+#include <LibGfx/Filters/SepiaFilter.h>
+#include <LibGfx/Filters/StackBlurFilter.h>
+#include <LibGfx/HelperThreads.h>
+#include <LibTest/TestCase.h>
+
+using Gfx::Color;
+
+static NonnullRefPtr<Gfx::Bitmap> create_random_bitmap(Gfx::IntSize size, Gfx::BitmapFormat format = Gfx::BitmapFormat::BGRA8888)
+{
+    auto bitmap = MUST(Gfx::Bitmap::create(format, size));
+    for (int y = 0; y < size.height(); ++y) {
+        for (int x = 0; x < size.width(); ++x) {
+            // A few fully transparent pixels, since the blurs treat those specially.
+            auto value = get_random<u32>();
+            bitmap->scanline(y)[x] = (value & 0x7) == 0 ? (value & 0x00ffffff) : value;
+        }
+    }
+    return bitmap;
+}
+
+static void expect_same_pixels(Gfx::Bitmap const& a, Gfx::Bitmap const& b, int tolerance = 0)
+{
+    VERIFY(a.size() == b.size());
+    for (int y = 0; y < a.height(); ++y) {
+        for (int x = 0; x < a.width(); ++x) {
+            auto pixel_a = a.get_pixel(x, y);
+            auto pixel_b = b.get_pixel(x, y);
+            EXPECT(abs(pixel_a.red() - pixel_b.red()) <= tolerance);
+            EXPECT(abs(pixel_a.green() - pixel_b.green()) <= tolerance);
+            EXPECT(abs(pixel_a.blue() - pixel_b.blue()) <= tolerance);
+            EXPECT_EQ(pixel_a.alpha(), pixel_b.alpha());
+            if (abs(pixel_a.red() - pixel_b.red()) > tolerance || pixel_a.alpha() != pixel_b.alpha())
+                return;
+        }
+    }
+}
+
+template<typename Callback>
+static void with_helper_threads(size_t thread_count, Callback callback)
+{
+    auto previous_thread_count = Gfx::maximum_helper_thread_count();
+    Gfx::set_maximum_helper_thread_count(thread_count);
+    callback();
+    Gfx::set_maximum_helper_thread_count(previous_thread_count);
+}
+
+TEST_CASE(for_each_band_of_lines_covers_every_line_once)
+{
+    for (size_t thread_count : { 0, 3 }) {
+        with_helper_threads(thread_count, [] {
+            for (int line_count : { 1, 31, 32, 1000, 1001 }) {
+                Array<Atomic<int>, 1001> visits {};
+                Gfx::for_each_band_of_lines(line_count, 1000, [&](int first_line, int end_line) {
+                    EXPECT(first_line < end_line);
+                    for (int line = first_line; line < end_line; ++line)
+                        ++visits[line];
+                });
+                for (int line = 0; line < line_count; ++line)
+                    EXPECT_EQ(visits[line].load(), 1);
+            }
+        });
+    }
+}
+
+TEST_CASE(for_each_band_of_lines_can_be_nested)
+{
+    with_helper_threads(3, [] {
+        Array<Atomic<int>, 32 * 32> visits {};
+        Gfx::for_each_band_of_lines(32, 100000, [&](int first_outer_line, int end_outer_line) {
+            for (int outer_line = first_outer_line; outer_line < end_outer_line; ++outer_line) {
+                Gfx::for_each_band_of_lines(32, 100000, [&](int first_line, int end_line) {
+                    for (int line = first_line; line < end_line; ++line)
+                        ++visits[outer_line * 32 + line];
+                });
+            }
+        });
+        for (auto& count : visits)
+            EXPECT_EQ(count.load(), 1);
+    });
+}
+
+TEST_CASE(matrix_filter_matches_per_pixel_conversion)
+{
+    auto bitmap = create_random_bitmap({ 67, 13 });
+    auto filtered = MUST(bitmap->clone());
+
+    Gfx::HueRotateFilter filter { 123.0f };
+    filter.apply(*filtered, filtered->rect(), *bitmap, bitmap->rect());
+
+    // The vector conversion must match the scalar one in MatrixFilter::convert_color() exactly.
+    struct ScalarHueRotateFilter final : public Gfx::HueRotateFilter {
+        using HueRotateFilter::HueRotateFilter;
+        virtual void convert_colors(Span<Color> colors) override { ColorFilter::convert_colors(colors); }
+    };
+    auto expected = MUST(bitmap->clone());
+    ScalarHueRotateFilter scalar_filter { 123.0f };
+    scalar_filter.apply(*expected, expected->rect(), *bitmap, bitmap->rect());
+
+    expect_same_pixels(*filtered, *expected);
+}
+
+TEST_CASE(color_filter_chain_matches_applying_filters_one_by_one)
+{
+    auto bitmap = create_random_bitmap({ 101, 37 });
+
+    auto expected = MUST(bitmap->clone());
+    auto apply = [&](Gfx::ColorFilter&& filter) {
+        filter.apply(*expected, expected->rect(), *expected, expected->rect());
+    };
+    apply(Gfx::GrayscaleFilter { 0.5f });
+    apply(Gfx::BrightnessFilter { 1.5f });
+    apply(Gfx::SaturateFilter { 2.0f });
+    apply(Gfx::InvertFilter { 0.25f });
+    apply(Gfx::SepiaFilter { 0.75f });
+
+    Gfx::ColorFilterChain chain;
+    chain.append(make<Gfx::GrayscaleFilter>(0.5f));
+    chain.append(make<Gfx::BrightnessFilter>(1.5f));
+    chain.append(make<Gfx::SaturateFilter>(2.0f));
+    chain.append(make<Gfx::InvertFilter>(0.25f));
+    chain.append(make<Gfx::SepiaFilter>(0.75f));
+    auto chained = MUST(bitmap->clone());
+    chain.apply(*chained, chained->rect(), *chained, chained->rect());
+
+    expect_same_pixels(*chained, *expected);
+}
+
+TEST_CASE(color_filter_into_part_of_other_bitmap)
+{
+    auto source = create_random_bitmap({ 40, 30 }, Gfx::BitmapFormat::BGRx8888);
+    auto target = MUST(Gfx::Bitmap::create(Gfx::BitmapFormat::BGRA8888, { 50, 50 }));
+    target->fill(Color::Transparent);
+
+    Gfx::InvertFilter filter;
+    filter.apply(*target, { 5, 7, 20, 10 }, *source, { 3, 4, 20, 10 });
+
+    for (int y = 0; y < target->height(); ++y) {
+        for (int x = 0; x < target->width(); ++x) {
+            if (Gfx::IntRect { 5, 7, 20, 10 }.contains(x, y))
+                EXPECT_EQ(target->get_pixel(x, y), source->get_pixel(x - 2, y - 3).inverted());
+            else
+                EXPECT_EQ(target->get_pixel(x, y), Color(Color::Transparent));
+        }
+    }
+}
+
+// The straightforward way to convolve, like GenericConvolutionFilter used to do it.
+template<size_t N>
+static NonnullRefPtr<Gfx::Bitmap> convolve_naively(Gfx::Bitmap const& source, Gfx::Matrix<N, float> const& kernel, bool should_wrap)
+{
+    auto target = MUST(Gfx::Bitmap::create(source.format(), source.size()));
+    ssize_t const offset = N / 2;
+    for (int i = 0; i < source.width(); ++i) {
+        for (int j = 0; j < source.height(); ++j) {
+            FloatVector3 value(0, 0, 0);
+            for (ssize_t k = 0; k < (ssize_t)N; ++k) {
+                auto ki = i + k - offset;
+                if (ki < 0 || ki >= source.width()) {
+                    if (!should_wrap)
+                        continue;
+                    ki = (ki + source.width()) % source.width();
+                }
+                for (ssize_t l = 0; l < (ssize_t)N; ++l) {
+                    auto lj = j + l - offset;
+                    if (lj < 0 || lj >= source.height()) {
+                        if (!should_wrap)
+                            continue;
+                        lj = (lj + source.height()) % source.height();
+                    }
+                    auto pixel = source.get_pixel(ki, lj);
+                    value = value + FloatVector3(pixel.red(), pixel.green(), pixel.blue()) * kernel.elements()[k][l];
+                }
+            }
+            value.clamp(0, 255);
+            target->set_pixel(i, j, Color(value.x(), value.y(), value.z(), source.get_pixel(i, j).alpha()));
+        }
+    }
+    return target;
+}
+
+TEST_CASE(convolution_matches_naive_convolution)
+{
+    auto bitmap = create_random_bitmap({ 53, 41 });
+    Gfx::Matrix<5, float> kernel;
+    for (size_t i = 0; i < 5; ++i) {
+        for (size_t j = 0; j < 5; ++j)
+            kernel.elements()[i][j] = static_cast<float>(i * 5 + j) / 100.0f - 0.05f;
+    }
+
+    for (bool should_wrap : { false, true }) {
+        auto expected = convolve_naively(*bitmap, kernel, should_wrap);
+
+        Gfx::GenericConvolutionFilter<5> filter;
+        Gfx::GenericConvolutionFilter<5>::Parameters parameters { kernel, should_wrap };
+        auto filtered = MUST(Gfx::Bitmap::create(bitmap->format(), bitmap->size()));
+        filter.apply(*filtered, filtered->rect(), *bitmap, bitmap->rect(), parameters);
+
+        // The kernel is summed up in a different order, which can change the float rounding by a bit.
+        expect_same_pixels(*filtered, *expected, 1);
+    }
+}
+
+TEST_CASE(convolution_in_place)
+{
+    auto bitmap = create_random_bitmap({ 40, 40 });
+    auto separate_target = MUST(Gfx::Bitmap::create(bitmap->format(), bitmap->size()));
+    separate_target->fill(Color::Transparent);
+
+    Gfx::LaplacianFilter filter;
+    Gfx::GenericConvolutionFilter<3>::Parameters parameters { Gfx::Matrix<3, float>(-1, -1, -1, -1, 8, -1, -1, -1, -1), false };
+    Gfx::IntRect const target_rect { 10, 5, 20, 30 };
+    filter.apply(*separate_target, target_rect, *bitmap, bitmap->rect(), parameters);
+    filter.apply(*bitmap, target_rect, *bitmap, bitmap->rect(), parameters);
+
+    for (int y = target_rect.top(); y < target_rect.top() + target_rect.height(); ++y) {
+        for (int x = target_rect.left(); x < target_rect.left() + target_rect.width(); ++x)
+            EXPECT_EQ(bitmap->get_pixel(x, y), separate_target->get_pixel(x, y));
+    }
+}
+
+TEST_CASE(stack_blur_of_uniform_bitmap)
+{
+    auto bitmap = MUST(Gfx::Bitmap::create(Gfx::BitmapFormat::BGRA8888, { 30, 20 }));
+    bitmap->fill(Color(200, 100, 50));
+
+    Gfx::StackBlurFilter filter { *bitmap };
+    filter.process_rgba(5, Color::Transparent);
+
+    auto pixel = bitmap->get_pixel(0, 0);
+    for (int y = 0; y < bitmap->height(); ++y) {
+        for (int x = 0; x < bitmap->width(); ++x)
+            EXPECT_EQ(bitmap->get_pixel(x, y), pixel);
+    }
+    EXPECT(abs(pixel.red() - 200) <= 1);
+    EXPECT(abs(pixel.green() - 100) <= 1);
+    EXPECT(abs(pixel.blue() - 50) <= 1);
+}
+
+TEST_CASE(stack_blur_keeps_transparent_areas_transparent)
+{
+    auto bitmap = MUST(Gfx::Bitmap::create(Gfx::BitmapFormat::BGRA8888, { 100, 100 }));
+    bitmap->fill(Color::Transparent);
+    for (int y = 40; y < 60; ++y) {
+        for (int x = 40; x < 60; ++x)
+            bitmap->set_pixel(x, y, Color::Black);
+    }
+
+    Gfx::StackBlurFilter filter { *bitmap };
+    filter.process_rgba(8, Color::Transparent);
+
+    EXPECT_EQ(bitmap->get_pixel(0, 0), Color(Color::Transparent));
+    EXPECT_EQ(bitmap->get_pixel(99, 50), Color(Color::Transparent));
+    EXPECT(bitmap->get_pixel(50, 50).alpha() > 200);
+    EXPECT(bitmap->get_pixel(35, 50).alpha() > 0);
+    EXPECT(bitmap->get_pixel(35, 50).alpha() < bitmap->get_pixel(42, 50).alpha());
+}
+
+TEST_CASE(fast_box_blur_of_uniform_bitmap)
+{
+    auto bitmap = MUST(Gfx::Bitmap::create(Gfx::BitmapFormat::BGRx8888, { 30, 20 }));
+    bitmap->fill(Color(200, 100, 50));
+
+    Gfx::FastBoxBlurFilter filter { *bitmap };
+    filter.apply_three_passes(4);
+
+    for (int y = 0; y < bitmap->height(); ++y) {
+        for (int x = 0; x < bitmap->width(); ++x)
+            EXPECT_EQ(bitmap->get_pixel(x, y), Color(200, 100, 50));
+    }
+}
+
+TEST_CASE(filters_give_the_same_result_on_helper_threads)
+{
+    auto bitmap = create_random_bitmap({ 700, 600 });
+
+    auto apply_all_filters = [&] {
+        auto result = MUST(bitmap->clone());
+        Gfx::StackBlurFilter { *result }.process_rgba(7, Color::Transparent);
+        Gfx::FastBoxBlurFilter { *result }.apply_single_pass(3, 2);
+
+        Gfx::BoxBlurFilter<3> box_blur;
+        Gfx::GenericConvolutionFilter<3>::Parameters parameters { Gfx::Matrix<3, float>(1, 1, 1, 1, 1, 1, 1, 1, 1) };
+        Gfx::normalize(parameters.kernel());
+        box_blur.apply(*result, result->rect(), *result, result->rect(), parameters);
+
+        Gfx::ColorFilterChain chain;
+        chain.append(make<Gfx::HueRotateFilter>(45.0f));
+        chain.append(make<Gfx::GrayscaleFilter>(0.5f));
+        chain.apply(*result, result->rect(), *result, result->rect());
+        return result;
+    };
+
+    NonnullRefPtr<Gfx::Bitmap> on_one_thread = bitmap;
+    with_helper_threads(0, [&] { on_one_thread = apply_all_filters(); });
+    NonnullRefPtr<Gfx::Bitmap> on_several_threads = bitmap;
+    with_helper_threads(3, [&] { on_several_threads = apply_all_filters(); });
+
+    expect_same_pixels(*on_one_thread, *on_several_threads);
+}
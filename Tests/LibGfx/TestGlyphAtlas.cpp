@@ -0,0 +1,142 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibGfx/Bitmap.h>
+#include <LibGfx/Font/GlyphAtlas.h>
+#include <LibTest/TestCase.h>
+
+using Gfx::GlyphAtlas;
+
+static GlyphAtlas::Key key_for_glyph(u32 glyph_id)
+{
+    return { .typeface_id = 1, .x_scale = 1, .y_scale = 1, .glyph_id = glyph_id, .subpixel_offset = { 0, 0 } };
+}
+
+static RefPtr<Gfx::Bitmap> create_glyph(int width, int height, Gfx::Color color)
+{
+    auto bitmap = MUST(Gfx::Bitmap::create(Gfx::BitmapFormat::BGRA8888, { width, height }));
+    bitmap->fill(color);
+    return bitmap;
+}
+
+TEST_CASE(caches_glyphs)
+{
+    GlyphAtlas atlas;
+    size_t rasterized = 0;
+    Function<RefPtr<Gfx::Bitmap>()> rasterize = [&] {
+        ++rasterized;
+        return create_glyph(10, 12, Gfx::Color::Red);
+    };
+
+    auto first = atlas.ensure(key_for_glyph(1), rasterize);
+    auto second = atlas.ensure(key_for_glyph(1), rasterize);
+    EXPECT_EQ(rasterized, 1u);
+    EXPECT_EQ(first.bitmap.ptr(), second.bitmap.ptr());
+    EXPECT_EQ(first.rect, second.rect);
+    EXPECT_EQ(first.rect.size(), Gfx::IntSize(10, 12));
+
+    // A different subpixel offset is a different glyph.
+    auto offset_key = key_for_glyph(1);
+    offset_key.subpixel_offset = { 1, 0 };
+    (void)atlas.ensure(offset_key, rasterize);
+    EXPECT_EQ(rasterized, 2u);
+
+    auto statistics = atlas.statistics();
+    EXPECT_EQ(statistics.hits, 1u);
+    EXPECT_EQ(statistics.misses, 2u);
+    EXPECT_EQ(statistics.glyph_count, 2u);
+    EXPECT_EQ(statistics.page_count, 1u);
+}
+
+TEST_CASE(copies_glyph_pixels)
+{
+    GlyphAtlas atlas;
+    auto red = atlas.ensure(key_for_glyph(1), [] { return create_glyph(5, 7, Gfx::Color::Red); });
+    auto blue = atlas.ensure(key_for_glyph(2), [] { return create_glyph(6, 7, Gfx::Color::Blue); });
+    EXPECT_EQ(red.bitmap.ptr(), blue.bitmap.ptr());
+    EXPECT(!red.rect.intersects(blue.rect));
+
+    for (int y = red.rect.top(); y <= red.rect.bottom(); ++y) {
+        for (int x = red.rect.left(); x <= red.rect.right(); ++x)
+            EXPECT_EQ(red.bitmap->get_pixel(x, y), Gfx::Color(Gfx::Color::Red));
+    }
+    for (int y = blue.rect.top(); y <= blue.rect.bottom(); ++y) {
+        for (int x = blue.rect.left(); x <= blue.rect.right(); ++x)
+            EXPECT_EQ(blue.bitmap->get_pixel(x, y), Gfx::Color(Gfx::Color::Blue));
+    }
+}
+
+TEST_CASE(caches_empty_glyphs)
+{
+    GlyphAtlas atlas;
+    size_t rasterized = 0;
+    Function<RefPtr<Gfx::Bitmap>()> rasterize = [&]() -> RefPtr<Gfx::Bitmap> {
+        ++rasterized;
+        return nullptr;
+    };
+
+    EXPECT(!atlas.ensure(key_for_glyph(1), rasterize).bitmap);
+    EXPECT(!atlas.ensure(key_for_glyph(1), rasterize).bitmap);
+    EXPECT_EQ(rasterized, 1u);
+    EXPECT_EQ(atlas.statistics().page_count, 0u);
+}
+
+TEST_CASE(big_glyphs_get_their_own_page)
+{
+    GlyphAtlas atlas;
+    auto small = atlas.ensure(key_for_glyph(1), [] { return create_glyph(10, 10, Gfx::Color::Red); });
+    auto big = atlas.ensure(key_for_glyph(2), [] { return create_glyph(300, 20, Gfx::Color::Red); });
+    EXPECT_NE(small.bitmap.ptr(), big.bitmap.ptr());
+    EXPECT_EQ(big.bitmap->size(), Gfx::IntSize(300, 20));
+    EXPECT_EQ(big.rect, big.bitmap->rect());
+
+    // Small glyphs still go into the shared page.
+    auto another_small = atlas.ensure(key_for_glyph(3), [] { return create_glyph(10, 10, Gfx::Color::Red); });
+    EXPECT_EQ(small.bitmap.ptr(), another_small.bitmap.ptr());
+}
+
+TEST_CASE(evicts_least_recently_used_page)
+{
+    GlyphAtlas atlas;
+    auto page_bytes = static_cast<size_t>(GlyphAtlas::page_size) * GlyphAtlas::page_size * sizeof(u32);
+    atlas.set_memory_budget(2 * page_bytes);
+
+    // Three of these fit next to each other with their padding, so each page holds nine of them.
+    Function<RefPtr<Gfx::Bitmap>()> rasterize = [] { return create_glyph(GlyphAtlas::max_packed_glyph_size, GlyphAtlas::max_packed_glyph_size, Gfx::Color::Red); };
+    for (u32 glyph_id = 0; glyph_id < 18; ++glyph_id)
+        (void)atlas.ensure(key_for_glyph(glyph_id), rasterize);
+    EXPECT_EQ(atlas.statistics().page_count, 2u);
+    EXPECT_EQ(atlas.statistics().evicted_pages, 0u);
+
+    // Using a glyph from the first page makes the second one the least recently used.
+    (void)atlas.ensure(key_for_glyph(0), rasterize);
+    (void)atlas.ensure(key_for_glyph(18), rasterize);
+
+    auto statistics = atlas.statistics();
+    EXPECT_EQ(statistics.page_count, 2u);
+    EXPECT_EQ(statistics.evicted_pages, 1u);
+    EXPECT_EQ(statistics.evicted_glyphs, 9u);
+    EXPECT_EQ(statistics.glyph_count, 10u);
+    EXPECT(statistics.memory_used <= statistics.memory_budget);
+
+    auto misses = statistics.misses;
+    (void)atlas.ensure(key_for_glyph(1), rasterize);
+    EXPECT_EQ(atlas.statistics().misses, misses);
+    (void)atlas.ensure(key_for_glyph(9), rasterize);
+    EXPECT_EQ(atlas.statistics().misses, misses + 1);
+}
+
+TEST_CASE(shrinking_the_budget_evicts_pages)
+{
+    GlyphAtlas atlas;
+    (void)atlas.ensure(key_for_glyph(1), [] { return create_glyph(10, 10, Gfx::Color::Red); });
+    (void)atlas.ensure(key_for_glyph(2), [] { return create_glyph(400, 400, Gfx::Color::Red); });
+    EXPECT_EQ(atlas.statistics().page_count, 2u);
+
+    atlas.set_memory_budget(0);
+    EXPECT_EQ(atlas.statistics().page_count, 0u);
+    EXPECT_EQ(atlas.statistics().glyph_count, 0u);
+}
@@ -7,6 +7,7 @@
 
 #include <AK/DeprecatedString.h>
 #include <LibCore/MappedFile.h>
+#include <LibGfx/HelperThreads.h>
 #include <LibGfx/ImageFormats/BMPLoader.h>
 #include <LibGfx/ImageFormats/GIFLoader.h>
 #include <LibGfx/ImageFormats/ICOLoader.h>
@@ -156,6 +157,110 @@ TEST_CASE(test_jpeg_sof2_successive_aproximation)
     EXPECT_EQ(frame.image->size(), Gfx::IntSize(600, 800));
 }
 
+static void expect_same_pixels(Gfx::Bitmap const& a, Gfx::Bitmap const& b)
+{
+    EXPECT_EQ(a.size(), b.size());
+    for (int y = 0; y < a.height(); ++y) {
+        if (memcmp(a.scanline(y), b.scanline(y), a.width() * sizeof(Gfx::ARGB32)) != 0) {
+            FAIL(DeprecatedString::formatted("Row {} differs", y));
+            return;
+        }
+    }
+}
+
+static RefPtr<Gfx::Bitmap> decode_jpeg(StringView path)
+{
+    auto file = MUST(Core::MappedFile::map(path));
+    auto plugin_decoder = MUST(Gfx::JPEGImageDecoderPlugin::create(file->bytes()));
+    EXPECT(plugin_decoder->initialize());
+    return MUST(plugin_decoder->frame(0)).image;
+}
+
+TEST_CASE(test_jpeg_restart_intervals)
+{
+    // The same 4:2:0 image, encoded with and without restart intervals.
+    auto with_restarts = decode_jpeg(TEST_INPUT("restart_intervals.jpg"sv));
+    auto without_restarts = decode_jpeg(TEST_INPUT("no_restart_intervals.jpg"sv));
+    EXPECT_EQ(with_restarts->size(), Gfx::IntSize(200, 150));
+    expect_same_pixels(*with_restarts, *without_restarts);
+}
+
+struct ReferencePixel {
+    Gfx::IntPoint position;
+    Gfx::Color color;
+};
+
+static void expect_pixels_close_to(Gfx::Bitmap const& bitmap, ReadonlySpan<ReferencePixel> reference_pixels, int tolerance)
+{
+    for (auto const& reference : reference_pixels) {
+        auto color = bitmap.get_pixel(reference.position);
+        auto difference = max(abs(color.red() - reference.color.red()), max(abs(color.green() - reference.color.green()), abs(color.blue() - reference.color.blue())));
+        if (difference > tolerance)
+            FAIL(DeprecatedString::formatted("Pixel at {} is {}, expected {}", reference.position, color, reference.color));
+    }
+}
+
+TEST_CASE(test_jpeg_idct_accuracy)
+{
+    // This image stores RGB directly, so its pixels are just the output of the IDCT. The reference values were decoded
+    // with libjpeg's floating-point IDCT, which the integer IDCT should match to within 1.
+    static constexpr ReferencePixel reference_pixels[] = {
+        { { 0, 0 }, Gfx::Color(0, 9, 17) },
+        { { 7, 7 }, Gfx::Color(133, 75, 17) },
+        { { 8, 8 }, Gfx::Color(131, 72, 17) },
+        { { 100, 37 }, Gfx::Color(115, 65, 17) },
+        { { 160, 0 }, Gfx::Color(1, 7, 17) },
+        { { 143, 361 }, Gfx::Color(63, 29, 19) },
+        { { 295, 400 }, Gfx::Color(46, 30, 17) },
+        { { 450, 123 }, Gfx::Color(61, 37, 17) },
+        { { 512, 256 }, Gfx::Color(44, 29, 17) },
+        { { 544, 391 }, Gfx::Color(31, 27, 21) },
+        { { 333, 555 }, Gfx::Color(30, 22, 17) },
+        { { 17, 640 }, Gfx::Color(42, 28, 17) },
+        { { 591, 0 }, Gfx::Color(1, 7, 17) },
+        { { 0, 799 }, Gfx::Color(30, 22, 17) },
+        { { 591, 799 }, Gfx::Color(1, 7, 17) },
+    };
+
+    auto bitmap = decode_jpeg(TEST_INPUT("rgb_components.jpg"sv));
+    EXPECT_EQ(bitmap->size(), Gfx::IntSize(592, 800));
+    expect_pixels_close_to(*bitmap, reference_pixels, 1);
+}
+
+TEST_CASE(test_jpeg_ycbcr_420_reference_pixels)
+{
+    // The reference values were decoded with libjpeg's integer IDCT and without "fancy" upsampling.
+    static constexpr ReferencePixel reference_pixels[] = {
+        { { 0, 0 }, Gfx::Color(52, 135, 203) },
+        { { 15, 15 }, Gfx::Color(77, 142, 16) },
+        { { 16, 16 }, Gfx::Color(92, 149, 18) },
+        { { 57, 31 }, Gfx::Color(152, 66, 189) },
+        { { 170, 40 }, Gfx::Color(130, 33, 211) },
+        { { 100, 75 }, Gfx::Color(239, 53, 40) },
+        { { 123, 98 }, Gfx::Color(128, 136, 115) },
+        { { 199, 0 }, Gfx::Color(193, 217, 217) },
+        { { 0, 149 }, Gfx::Color(137, 111, 185) },
+        { { 199, 149 }, Gfx::Color(62, 61, 191) },
+    };
+
+    auto bitmap = decode_jpeg(TEST_INPUT("no_restart_intervals.jpg"sv));
+    EXPECT_EQ(bitmap->size(), Gfx::IntSize(200, 150));
+    expect_pixels_close_to(*bitmap, reference_pixels, 1);
+}
+
+TEST_CASE(test_jpeg_helper_threads)
+{
+    auto serial = decode_jpeg(TEST_INPUT("big_image.jpg"sv));
+
+    auto previous_thread_count = Gfx::maximum_helper_thread_count();
+    Gfx::set_maximum_helper_thread_count(3);
+    auto parallel = decode_jpeg(TEST_INPUT("big_image.jpg"sv));
+    Gfx::set_maximum_helper_thread_count(previous_thread_count);
+
+    EXPECT_EQ(serial->size(), Gfx::IntSize(3000, 2000));
+    expect_same_pixels(*serial, *parallel);
+}
+
 TEST_CASE(test_pbm)
 {
     auto file = MUST(Core::MappedFile::map(TEST_INPUT("buggie-raw.pbm"sv)));
@@ -201,6 +306,78 @@ TEST_CASE(test_png)
     EXPECT(frame.duration == 0);
 }
 
+// The filters-*.png images use every filter type, one after another. Their samples are computed like this, and
+// 16-bit samples have this value in their high byte.
+static u8 filter_test_sample(int x, int y, int channel)
+{
+    return (x * x * 3 + y * 7 + channel * 50 + x * y + (x >> 2) * (y >> 1)) & 0xff;
+}
+
+static Gfx::Color filter_test_color(int x, int y, bool is_grayscale, bool has_alpha)
+{
+    if (is_grayscale) {
+        auto gray = filter_test_sample(x, y, 0);
+        return Gfx::Color(gray, gray, gray, has_alpha ? filter_test_sample(x, y, 1) : 0xff);
+    }
+    return Gfx::Color(filter_test_sample(x, y, 0), filter_test_sample(x, y, 1), filter_test_sample(x, y, 2), has_alpha ? filter_test_sample(x, y, 3) : 0xff);
+}
+
+static void expect_filter_test_pixels(Gfx::Bitmap const& bitmap, int height, bool is_grayscale, bool has_alpha)
+{
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < bitmap.width(); ++x) {
+            if (bitmap.get_pixel(x, y) != filter_test_color(x, y, is_grayscale, has_alpha)) {
+                FAIL(DeprecatedString::formatted("Pixel {},{} is {}", x, y, bitmap.get_pixel(x, y)));
+                return;
+            }
+        }
+    }
+}
+
+TEST_CASE(test_png_filters)
+{
+    struct TestImage {
+        StringView path;
+        bool is_grayscale;
+        bool has_alpha;
+    };
+    Array test_images {
+        TestImage { TEST_INPUT("filters-gray.png"sv), true, false },
+        TestImage { TEST_INPUT("filters-gray-alpha.png"sv), true, true },
+        TestImage { TEST_INPUT("filters-rgb.png"sv), false, false },
+        TestImage { TEST_INPUT("filters-rgb-16.png"sv), false, false },
+        TestImage { TEST_INPUT("filters-rgba.png"sv), false, true },
+        TestImage { TEST_INPUT("filters-rgba-16.png"sv), false, true },
+        TestImage { TEST_INPUT("filters-rgba-interlaced.png"sv), false, true },
+    };
+
+    for (auto const& test_image : test_images) {
+        auto file = MUST(Core::MappedFile::map(test_image.path));
+        auto plugin_decoder = MUST(Gfx::PNGImageDecoderPlugin::create(file->bytes()));
+        auto frame = MUST(plugin_decoder->frame(0));
+        EXPECT_EQ(frame.image->size(), Gfx::IntSize(37, 19));
+        expect_filter_test_pixels(*frame.image, 19, test_image.is_grayscale, test_image.has_alpha);
+    }
+}
+
+TEST_CASE(test_png_partial_frame)
+{
+    auto file = MUST(Core::MappedFile::map(TEST_INPUT("filters-rgba.png"sv)));
+
+    auto plugin_decoder = MUST(Gfx::PNGImageDecoderPlugin::create(file->bytes()));
+    auto frame = MUST(plugin_decoder->partial_frame());
+    EXPECT_EQ(frame.decoded_height, 19);
+
+    // Pretend that the image data hasn't been downloaded completely.
+    plugin_decoder = MUST(Gfx::PNGImageDecoderPlugin::create(file->bytes().trim(file->size() * 2 / 3)));
+    EXPECT(plugin_decoder->frame(0).is_error());
+    frame = MUST(plugin_decoder->partial_frame());
+    EXPECT_EQ(frame.image->size(), Gfx::IntSize(37, 19));
+    EXPECT(frame.decoded_height > 0);
+    EXPECT(frame.decoded_height < 19);
+    expect_filter_test_pixels(*frame.image, frame.decoded_height, false, true);
+}
+
 TEST_CASE(test_ppm)
 {
     auto file = MUST(Core::MappedFile::map(TEST_INPUT("buggie-raw.ppm"sv)));
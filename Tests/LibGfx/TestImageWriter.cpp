@@ -0,0 +1,90 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/DeprecatedString.h>
+#include <AK/MemoryStream.h>
+#include <LibCore/MappedFile.h>
+#include <LibGfx/HelperThreads.h>
+#include <LibGfx/ImageFormats/PNGLoader.h>
+#include <LibGfx/ImageFormats/PNGWriter.h>
+#include <LibGfx/ImageFormats/QOILoader.h>
+#include <LibGfx/ImageFormats/QOIWriter.h>
+#include <LibTest/TestCase.h>
+#include <string.h>
+
+#ifdef AK_OS_SERENITY
+#    define TEST_INPUT(x) ("/usr/Tests/LibGfx/test-inputs/" x)
+#else
+#    define TEST_INPUT(x) ("test-inputs/" x)
+#endif
+
+static NonnullRefPtr<Gfx::Bitmap> screen_contents()
+{
+    auto file = MUST(Core::MappedFile::map(TEST_INPUT("screen_contents.png"sv)));
+    auto plugin_decoder = MUST(Gfx::PNGImageDecoderPlugin::create(file->bytes()));
+    return *MUST(plugin_decoder->frame(0)).image;
+}
+
+static void expect_same_pixels(Gfx::Bitmap const& a, Gfx::Bitmap const& b)
+{
+    EXPECT_EQ(a.size(), b.size());
+    for (int y = 0; y < a.height(); ++y) {
+        if (memcmp(a.scanline(y), b.scanline(y), a.width() * sizeof(Gfx::ARGB32)) != 0) {
+            FAIL(DeprecatedString::formatted("Row {} differs", y));
+            return;
+        }
+    }
+}
+
+static void expect_png_round_trip(Gfx::Bitmap const& bitmap, Gfx::PNGWriterOptions options)
+{
+    auto encoded = MUST(Gfx::PNGWriter::encode(bitmap, options));
+    auto plugin_decoder = MUST(Gfx::PNGImageDecoderPlugin::create(encoded));
+    expect_same_pixels(bitmap, *MUST(plugin_decoder->frame(0)).image);
+}
+
+TEST_CASE(test_png_round_trip)
+{
+    // The best compression takes a while, so it gets a part of the image with a bit of everything.
+    auto bitmap = screen_contents();
+    expect_png_round_trip(*MUST(bitmap->cropped({ 120, 480, 333, 111 })), {});
+
+    expect_png_round_trip(*bitmap, { .compression_level = Compress::ZlibCompressionLevel::Fastest });
+    expect_png_round_trip(*bitmap, Gfx::PNGWriterOptions::fast());
+}
+
+TEST_CASE(test_png_helper_threads)
+{
+    auto bitmap = screen_contents();
+    auto serial = MUST(Gfx::PNGWriter::encode(*bitmap, Gfx::PNGWriterOptions::fast()));
+
+    auto previous_thread_count = Gfx::maximum_helper_thread_count();
+    Gfx::set_maximum_helper_thread_count(3);
+    auto parallel = MUST(Gfx::PNGWriter::encode(*bitmap, Gfx::PNGWriterOptions::fast(true)));
+    Gfx::set_maximum_helper_thread_count(previous_thread_count);
+
+    // The parts compressed by different threads can't refer back to each other, which costs a little.
+    EXPECT(parallel.size() >= serial.size());
+    EXPECT(parallel.size() < serial.size() + serial.size() / 50);
+
+    auto plugin_decoder = MUST(Gfx::PNGImageDecoderPlugin::create(parallel));
+    expect_same_pixels(*bitmap, *MUST(plugin_decoder->frame(0)).image);
+}
+
+TEST_CASE(test_qoi_round_trip)
+{
+    auto bitmap = screen_contents();
+    auto encoded = MUST(Gfx::QOIWriter::encode(*bitmap));
+
+    AllocatingMemoryStream stream;
+    MUST(Gfx::QOIWriter::encode(stream, *bitmap));
+    auto streamed = MUST(ByteBuffer::create_uninitialized(stream.used_buffer_size()));
+    MUST(stream.read_until_filled(streamed));
+    EXPECT(encoded == streamed);
+
+    auto plugin_decoder = MUST(Gfx::QOIImageDecoderPlugin::create(encoded));
+    expect_same_pixels(*bitmap, *MUST(plugin_decoder->frame(0)).image);
+}
@@ -0,0 +1,126 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Array.h>
+#include <AK/Random.h>
+#include <AK/Vector.h>
+#include <LibGfx/PixelKernels.h>
+#include <LibTest/TestCase.h>
+
+using Gfx::Color;
+using Gfx::PixelKernels::Destination;
+using Gfx::PixelKernels::Implementation;
+
+static constexpr Array implementations { Implementation::Scalar, Implementation::Vector128, Implementation::Vector256 };
+
+template<typename Callback>
+static void for_each_supported_implementation(Callback callback)
+{
+    auto default_implementation = Gfx::PixelKernels::implementation();
+    for (auto implementation : implementations) {
+        if (!Gfx::PixelKernels::is_supported(implementation))
+            continue;
+        Gfx::PixelKernels::set_implementation(implementation);
+        callback();
+    }
+    Gfx::PixelKernels::set_implementation(default_implementation);
+}
+
+static Color random_color_with_alpha(u8 alpha)
+{
+    return Color::from_argb(get_random<u32>()).with_alpha(alpha);
+}
+
+TEST_CASE(blend_matches_color_blend)
+{
+    // Every pair of alpha values, in runs of lengths that don't divide evenly into vectors.
+    Vector<u32> source;
+    Vector<u32> destination;
+    for (u32 src_alpha = 0; src_alpha < 256; ++src_alpha) {
+        for (u32 dst_alpha = 0; dst_alpha < 256; ++dst_alpha) {
+            source.append(random_color_with_alpha(src_alpha).value());
+            destination.append(random_color_with_alpha(dst_alpha).value());
+        }
+    }
+    source.append(Color(Color::Transparent).value());
+    destination.append(Color(Color::Transparent).value());
+
+    for_each_supported_implementation([&] {
+        for (auto destination_kind : { Destination::HasAlpha, Destination::Opaque }) {
+            auto blended = destination;
+            for (size_t offset = 0; offset < blended.size(); offset += 13)
+                Gfx::PixelKernels::blend(blended.data() + offset, source.data() + offset, min<size_t>(13, blended.size() - offset), destination_kind);
+
+            for (size_t i = 0; i < blended.size(); ++i) {
+                auto dst = destination_kind == Destination::Opaque ? Color::from_rgb(destination[i]) : Color::from_argb(destination[i]);
+                EXPECT_EQ(blended[i], dst.blend(Color::from_argb(source[i])).value());
+            }
+        }
+    });
+}
+
+TEST_CASE(blend_color_matches_color_blend)
+{
+    Vector<u32> destination;
+    for (u32 dst_alpha = 0; dst_alpha < 256; ++dst_alpha)
+        destination.append(random_color_with_alpha(dst_alpha).value());
+
+    for_each_supported_implementation([&] {
+        for (u32 src_alpha = 0; src_alpha < 256; src_alpha += 5) {
+            auto color = random_color_with_alpha(src_alpha);
+            auto blended = destination;
+            Gfx::PixelKernels::blend(blended.data(), color, blended.size() - 3);
+
+            for (size_t i = 0; i < blended.size() - 3; ++i)
+                EXPECT_EQ(blended[i], Color::from_argb(destination[i]).blend(color).value());
+            for (size_t i = blended.size() - 3; i < blended.size(); ++i)
+                EXPECT_EQ(blended[i], destination[i]);
+        }
+    });
+}
+
+TEST_CASE(blend_multiplied_matches_blending_multiplied_colors)
+{
+    Vector<u32> source;
+    Vector<u32> destination;
+    for (u32 alpha = 0; alpha < 256; ++alpha) {
+        source.append(random_color_with_alpha(alpha).value());
+        destination.append(random_color_with_alpha(255 - alpha).value());
+    }
+
+    for_each_supported_implementation([&] {
+        for (u32 color_alpha = 0; color_alpha < 256; color_alpha += 15) {
+            auto color = random_color_with_alpha(color_alpha);
+            auto blended = destination;
+            Gfx::PixelKernels::blend_multiplied(blended.data(), source.data(), color, blended.size() - 3);
+
+            for (size_t i = 0; i < blended.size() - 3; ++i) {
+                auto src = Color::from_argb(source[i]);
+                auto expected = src.alpha() == 0 ? destination[i] : Color::from_argb(destination[i]).blend(src.multiply(color)).value();
+                EXPECT_EQ(blended[i], expected);
+            }
+            for (size_t i = blended.size() - 3; i < blended.size(); ++i)
+                EXPECT_EQ(blended[i], destination[i]);
+        }
+    });
+}
+
+TEST_CASE(swap_red_and_blue)
+{
+    Array<u32, 19> pixels;
+    for (size_t i = 0; i < pixels.size(); ++i)
+        pixels[i] = 0x11223344 + i;
+
+    for_each_supported_implementation([&] {
+        Array<u32, 19> swapped;
+        Gfx::PixelKernels::swap_red_and_blue(swapped.data(), pixels.data(), pixels.size());
+        for (size_t i = 0; i < pixels.size(); ++i)
+            EXPECT_EQ(swapped[i], 0x11443322 + (i << 16));
+
+        Gfx::PixelKernels::swap_red_and_blue(swapped.data(), swapped.data(), swapped.size());
+        EXPECT_EQ(swapped, pixels);
+    });
+}
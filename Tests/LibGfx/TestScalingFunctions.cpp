@@ -5,6 +5,7 @@
  */
 
 #include <LibGfx/Bitmap.h>
+#include <LibGfx/HelperThreads.h>
 #include <LibGfx/Painter.h>
 #include <LibTest/TestCase.h>
 
@@ -64,3 +65,130 @@ TEST_CASE(test_bitmap_scaling_uses_premultiplied_alpha)
     auto bottom_right_pixel = scaled_bitmap->get_pixel(scaled_bitmap->rect().bottom_right());
     EXPECT_EQ(bottom_right_pixel, Color::Transparent);
 }
+
+// The resampling filters reach further than one pixel, so the source is large enough for the bottom right to be out of
+// reach of the opaque pixel. Pixel (2, 2) is halfway between that pixel and its transparent neighbor.
+static void expect_resampling_uses_premultiplied_alpha(Gfx::Bitmap const& scaled_bitmap)
+{
+    EXPECT_EQ(scaled_bitmap.get_pixel(0, 0), Color::White);
+
+    auto halfway_pixel = scaled_bitmap.get_pixel(2, 2);
+    EXPECT(halfway_pixel.alpha() > 0);
+    EXPECT(halfway_pixel.alpha() < 255);
+    EXPECT_EQ(halfway_pixel.with_alpha(0), Color(Color::White).with_alpha(0));
+
+    EXPECT_EQ(scaled_bitmap.get_pixel(scaled_bitmap.rect().bottom_right()), Color::Transparent);
+}
+
+TEST_CASE(test_painter_resampling_uses_premultiplied_alpha)
+{
+    for (auto scaling_mode : { Gfx::Painter::ScalingMode::Bicubic, Gfx::Painter::ScalingMode::Lanczos }) {
+        auto src_bitmap = MUST(Gfx::Bitmap::create(Gfx::BitmapFormat::BGRA8888, { 4, 4 }));
+        src_bitmap->fill(Color::Transparent);
+        src_bitmap->set_pixel({ 0, 0 }, Color::White);
+
+        auto scaled_bitmap = MUST(Gfx::Bitmap::create(Gfx::BitmapFormat::BGRA8888, { 10, 10 }));
+        scaled_bitmap->fill(Color::Transparent);
+
+        Gfx::Painter painter(scaled_bitmap);
+        painter.draw_scaled_bitmap(scaled_bitmap->rect(), src_bitmap, src_bitmap->rect(), 1.0f, scaling_mode);
+        expect_resampling_uses_premultiplied_alpha(scaled_bitmap);
+    }
+}
+
+TEST_CASE(test_bitmap_scaled_with_filter_uses_premultiplied_alpha)
+{
+    for (auto filter : { Gfx::ResamplingFilter::Bilinear, Gfx::ResamplingFilter::Bicubic, Gfx::ResamplingFilter::Lanczos3 }) {
+        auto src_bitmap = MUST(Gfx::Bitmap::create(Gfx::BitmapFormat::BGRA8888, { 4, 4 }));
+        src_bitmap->fill(Color::Transparent);
+        src_bitmap->set_pixel({ 0, 0 }, Color::White);
+
+        auto scaled_bitmap = MUST(src_bitmap->scaled_with_filter({ 10, 10 }, filter));
+        EXPECT_EQ(scaled_bitmap->width(), 10);
+        EXPECT_EQ(scaled_bitmap->height(), 10);
+        expect_resampling_uses_premultiplied_alpha(scaled_bitmap);
+    }
+}
+
+TEST_CASE(test_scaled_with_filter_keeps_solid_colors)
+{
+    auto src_bitmap = MUST(Gfx::Bitmap::create(Gfx::BitmapFormat::BGRA8888, { 37, 23 }));
+    src_bitmap->fill(Color(10, 200, 30, 100));
+
+    for (auto filter : { Gfx::ResamplingFilter::Box, Gfx::ResamplingFilter::Bilinear, Gfx::ResamplingFilter::Bicubic, Gfx::ResamplingFilter::Lanczos3 }) {
+        for (auto size : { Gfx::IntSize { 5, 4 }, Gfx::IntSize { 37, 23 }, Gfx::IntSize { 80, 61 } }) {
+            auto scaled_bitmap = MUST(src_bitmap->scaled_with_filter(size, filter));
+            for (int y = 0; y < size.height(); ++y) {
+                for (int x = 0; x < size.width(); ++x)
+                    EXPECT_EQ(scaled_bitmap->get_pixel(x, y), Color(10, 200, 30, 100));
+            }
+        }
+    }
+}
+
+TEST_CASE(test_box_filter_averages_covered_pixels)
+{
+    auto src_bitmap = MUST(Gfx::Bitmap::create(Gfx::BitmapFormat::BGRx8888, { 8, 8 }));
+    for (int y = 0; y < 8; ++y) {
+        for (int x = 0; x < 8; ++x)
+            src_bitmap->set_pixel(x, y, (x + y) % 2 ? Color::White : Color::Black);
+    }
+
+    auto scaled_bitmap = MUST(src_bitmap->scaled_with_filter({ 2, 2 }, Gfx::ResamplingFilter::Box));
+    for (int y = 0; y < 2; ++y) {
+        for (int x = 0; x < 2; ++x)
+            EXPECT_EQ(scaled_bitmap->get_pixel(x, y), Color(128, 128, 128));
+    }
+}
+
+TEST_CASE(test_scaled_with_filter_on_helper_threads)
+{
+    auto src_bitmap = MUST(Gfx::Bitmap::create(Gfx::BitmapFormat::BGRA8888, { 1000, 700 }));
+    for (int y = 0; y < src_bitmap->height(); ++y) {
+        for (int x = 0; x < src_bitmap->width(); ++x)
+            src_bitmap->set_pixel(x, y, Color(x & 0xff, y & 0xff, (x * y) & 0xff, (x + y) & 0xff));
+    }
+
+    auto scaled_bitmap = MUST(src_bitmap->scaled_with_filter({ 300, 210 }, Gfx::ResamplingFilter::Lanczos3));
+
+    auto previous_thread_count = Gfx::maximum_helper_thread_count();
+    Gfx::set_maximum_helper_thread_count(3);
+    auto threaded_scaled_bitmap = MUST(src_bitmap->scaled_with_filter({ 300, 210 }, Gfx::ResamplingFilter::Lanczos3));
+    Gfx::set_maximum_helper_thread_count(previous_thread_count);
+
+    for (int y = 0; y < scaled_bitmap->height(); ++y) {
+        for (int x = 0; x < scaled_bitmap->width(); ++x)
+            EXPECT_EQ(threaded_scaled_bitmap->get_pixel(x, y), scaled_bitmap->get_pixel(x, y));
+    }
+}
+
+// Only the visible part of the scaled bitmap gets resampled, which has to match the same part of the whole one.
+TEST_CASE(test_painter_resampling_with_clip_rect)
+{
+    auto src_bitmap = MUST(Gfx::Bitmap::create(Gfx::BitmapFormat::BGRA8888, { 50, 40 }));
+    for (int y = 0; y < src_bitmap->height(); ++y) {
+        for (int x = 0; x < src_bitmap->width(); ++x)
+            src_bitmap->set_pixel(x, y, Color(x * 5, y * 6, (x * y) & 0xff, 128 + x));
+    }
+
+    auto scaled_bitmap = MUST(Gfx::Bitmap::create(Gfx::BitmapFormat::BGRA8888, { 23, 17 }));
+    scaled_bitmap->fill(Color::Transparent);
+    Gfx::Painter painter(scaled_bitmap);
+    painter.draw_scaled_bitmap(scaled_bitmap->rect(), src_bitmap, src_bitmap->rect(), 1.0f, Gfx::Painter::ScalingMode::Bicubic);
+
+    auto clipped_bitmap = MUST(Gfx::Bitmap::create(Gfx::BitmapFormat::BGRA8888, { 23, 17 }));
+    clipped_bitmap->fill(Color::Transparent);
+    Gfx::IntRect clip_rect { 5, 3, 10, 9 };
+    Gfx::Painter clipped_painter(clipped_bitmap);
+    clipped_painter.add_clip_rect(clip_rect);
+    clipped_painter.draw_scaled_bitmap(clipped_bitmap->rect(), src_bitmap, src_bitmap->rect(), 1.0f, Gfx::Painter::ScalingMode::Bicubic);
+
+    for (int y = 0; y < clipped_bitmap->height(); ++y) {
+        for (int x = 0; x < clipped_bitmap->width(); ++x) {
+            if (clip_rect.contains(x, y))
+                EXPECT_EQ(clipped_bitmap->get_pixel(x, y), scaled_bitmap->get_pixel(x, y));
+            else
+                EXPECT_EQ(clipped_bitmap->get_pixel(x, y), Color::Transparent);
+        }
+    }
+}
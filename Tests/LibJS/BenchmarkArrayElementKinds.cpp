@@ -0,0 +1,134 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/DeprecatedString.h>
+#include <LibJS/AST.h>
+#include <LibJS/Bytecode/Generator.h>
+#include <LibJS/Bytecode/Interpreter.h>
+#include <LibJS/Interpreter.h>
+#include <LibJS/Runtime/VM.h>
+#include <LibJS/Script.h>
+#include <LibTest/TestCase.h>
+
+// Each kernel runs once on arrays that keep their elements in one of the packed numeric element kinds, and once on
+// the same arrays after they were forced to store generic values, which is how every array was stored before.
+
+static constexpr StringView common_source = R"~~~(
+const length = 100000;
+const rounds = 20;
+
+function makeInt32Array() {
+    const array = [];
+    for (let i = 0; i < length; ++i)
+        array.push(i & 0xff);
+    return array;
+}
+
+function makeDoubleArray() {
+    const array = [];
+    for (let i = 0; i < length; ++i)
+        array.push((i & 0xff) + 0.5);
+    return array;
+}
+
+function forceGenericValues(array) {
+    array.push("not a number");
+    array.pop();
+    return array;
+}
+
+function sum(array) {
+    let result = 0;
+    for (let round = 0; round < rounds; ++round) {
+        for (let i = 0; i < array.length; ++i)
+            result += array[i];
+    }
+    return result;
+}
+
+function dot(lhs, rhs) {
+    let result = 0;
+    for (let round = 0; round < rounds; ++round) {
+        for (let i = 0; i < lhs.length; ++i)
+            result += lhs[i] * rhs[i];
+    }
+    return result;
+}
+
+function scale(array) {
+    for (let round = 0; round < rounds; ++round) {
+        for (let i = 0; i < array.length; ++i)
+            array[i] = array[i] * 3 - array[i] * 2;
+    }
+}
+
+function search(array) {
+    let found = 0;
+    for (let round = 0; round < rounds * 10; ++round) {
+        if (array.indexOf(1000) === -1 && !array.includes(-1))
+            ++found;
+    }
+    return found;
+}
+)~~~"sv;
+
+static void run_kernel(StringView kernel)
+{
+    auto source = DeprecatedString::formatted("{}\n{}", common_source, kernel);
+
+    auto vm = MUST(JS::VM::create());
+    auto ast_interpreter = JS::Interpreter::create<JS::GlobalObject>(*vm);
+
+    auto script_or_error = JS::Script::parse(source, ast_interpreter->realm());
+    EXPECT(!script_or_error.is_error());
+    if (script_or_error.is_error())
+        return;
+
+    JS::Bytecode::Interpreter bytecode_interpreter(ast_interpreter->realm());
+    auto executable = MUST(JS::Bytecode::Generator::generate(script_or_error.value()->parse_node()));
+    auto result = bytecode_interpreter.run(*executable);
+    EXPECT(!result.is_error());
+}
+
+BENCHMARK_CASE(sum_int32_elements)
+{
+    run_kernel("sum(makeInt32Array());"sv);
+}
+
+BENCHMARK_CASE(sum_int32_elements_as_generic_values)
+{
+    run_kernel("sum(forceGenericValues(makeInt32Array()));"sv);
+}
+
+BENCHMARK_CASE(dot_product_double_elements)
+{
+    run_kernel("dot(makeDoubleArray(), makeDoubleArray());"sv);
+}
+
+BENCHMARK_CASE(dot_product_double_elements_as_generic_values)
+{
+    run_kernel("dot(forceGenericValues(makeDoubleArray()), forceGenericValues(makeDoubleArray()));"sv);
+}
+
+BENCHMARK_CASE(scale_int32_elements)
+{
+    run_kernel("scale(makeInt32Array());"sv);
+}
+
+BENCHMARK_CASE(scale_int32_elements_as_generic_values)
+{
+    run_kernel("scale(forceGenericValues(makeInt32Array()));"sv);
+}
+
+BENCHMARK_CASE(search_double_elements)
+{
+    run_kernel("search(makeDoubleArray());"sv);
+}
+
+BENCHMARK_CASE(search_double_elements_as_generic_values)
+{
+    run_kernel("search(forceGenericValues(makeDoubleArray()));"sv);
+}
@@ -0,0 +1,118 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/DeprecatedString.h>
+#include <LibJS/AST.h>
+#include <LibJS/Bytecode/Generator.h>
+#include <LibJS/Bytecode/Interpreter.h>
+#include <LibJS/Interpreter.h>
+#include <LibJS/Runtime/VM.h>
+#include <LibJS/Script.h>
+#include <LibTest/TestCase.h>
+
+// The documents are built once per kernel and then parsed and/or stringified a number of times. Records all share the
+// same keys (as they would in most real world API responses), while the config is a deep tree of differently shaped objects.
+
+static constexpr StringView common_source = R"~~~(
+const rounds = 20;
+
+function makeRecords() {
+    const records = [];
+    for (let i = 0; i < 5000; ++i) {
+        records.push({
+            id: i,
+            name: "record " + i,
+            active: (i & 1) === 0,
+            score: i * 0.25,
+            tags: ["alpha", "beta", "gamma"],
+            position: { x: i, y: -i },
+        });
+    }
+    return JSON.stringify(records);
+}
+
+function makeConfig() {
+    function makeNode(depth, index) {
+        const node = { ["key" + index]: index, label: "node\t\"" + depth + "\"" };
+        if (depth > 0) {
+            node.children = [];
+            for (let i = 0; i < 4; ++i)
+                node.children.push(makeNode(depth - 1, i * depth));
+        }
+        return node;
+    }
+    return JSON.stringify(makeNode(6, 0));
+}
+
+function makeNumbers() {
+    const numbers = [];
+    for (let i = 0; i < 50000; ++i)
+        numbers.push(i % 3 === 0 ? i : i / 8);
+    return JSON.stringify(numbers);
+}
+
+function parse(text) {
+    let result;
+    for (let round = 0; round < rounds; ++round)
+        result = JSON.parse(text);
+    return result;
+}
+
+function stringify(value) {
+    let result;
+    for (let round = 0; round < rounds; ++round)
+        result = JSON.stringify(value);
+    return result;
+}
+)~~~"sv;
+
+static void run_kernel(StringView kernel)
+{
+    auto source = DeprecatedString::formatted("{}\n{}", common_source, kernel);
+
+    auto vm = MUST(JS::VM::create());
+    auto ast_interpreter = JS::Interpreter::create<JS::GlobalObject>(*vm);
+
+    auto script_or_error = JS::Script::parse(source, ast_interpreter->realm());
+    EXPECT(!script_or_error.is_error());
+    if (script_or_error.is_error())
+        return;
+
+    JS::Bytecode::Interpreter bytecode_interpreter(ast_interpreter->realm());
+    auto executable = MUST(JS::Bytecode::Generator::generate(script_or_error.value()->parse_node()));
+    auto result = bytecode_interpreter.run(*executable);
+    EXPECT(!result.is_error());
+}
+
+BENCHMARK_CASE(parse_records)
+{
+    run_kernel("parse(makeRecords());"sv);
+}
+
+BENCHMARK_CASE(parse_config)
+{
+    run_kernel("parse(makeConfig());"sv);
+}
+
+BENCHMARK_CASE(parse_numbers)
+{
+    run_kernel("parse(makeNumbers());"sv);
+}
+
+BENCHMARK_CASE(stringify_records)
+{
+    run_kernel("stringify(JSON.parse(makeRecords()));"sv);
+}
+
+BENCHMARK_CASE(stringify_config)
+{
+    run_kernel("stringify(JSON.parse(makeConfig()));"sv);
+}
+
+BENCHMARK_CASE(stringify_numbers)
+{
+    run_kernel("stringify(JSON.parse(makeNumbers()));"sv);
+}
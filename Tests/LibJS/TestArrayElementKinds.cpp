@@ -0,0 +1,79 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibJS/AST.h>
+#include <LibJS/Bytecode/Generator.h>
+#include <LibJS/Bytecode/Interpreter.h>
+#include <LibJS/Interpreter.h>
+#include <LibJS/Runtime/Array.h>
+#include <LibJS/Runtime/VM.h>
+#include <LibJS/Script.h>
+#include <LibTest/TestCase.h>
+
+using ElementKind = JS::SimpleIndexedPropertyStorage::ElementKind;
+
+static Optional<ElementKind> element_kind_of(JS::Object const& object)
+{
+    auto const* storage = object.indexed_properties().simple_storage();
+    if (!storage)
+        return {};
+    return storage->element_kind();
+}
+
+// Runs the given script and returns the element kind of the array it stores in `result`.
+static Optional<ElementKind> element_kind_of_result(StringView source)
+{
+    auto vm = MUST(JS::VM::create());
+    auto ast_interpreter = JS::Interpreter::create<JS::GlobalObject>(*vm);
+    auto& realm = ast_interpreter->realm();
+
+    auto script = MUST(JS::Script::parse(source, realm));
+    JS::Bytecode::Interpreter bytecode_interpreter(realm);
+    auto executable = MUST(JS::Bytecode::Generator::generate(script->parse_node()));
+    MUST(bytecode_interpreter.run(*executable));
+
+    auto result = MUST(realm.global_object().get("result"));
+    VERIFY(result.is_object() && is<JS::Array>(result.as_object()));
+    return element_kind_of(result.as_object());
+}
+
+TEST_CASE(array_literals)
+{
+    EXPECT_EQ(element_kind_of_result("result = [1, 2, 3];"sv), ElementKind::PackedInt32);
+    EXPECT_EQ(element_kind_of_result("result = [1, 2.5, -0];"sv), ElementKind::PackedDouble);
+    EXPECT_EQ(element_kind_of_result("result = [1, NaN, Infinity];"sv), ElementKind::PackedDouble);
+    EXPECT_EQ(element_kind_of_result("result = [1, 'two', 3];"sv), ElementKind::Values);
+    EXPECT_EQ(element_kind_of_result("result = [1, , 3];"sv), ElementKind::Values);
+    EXPECT_EQ(element_kind_of_result("result = [1, 2, 3]; result[1] = 2.5;"sv), ElementKind::PackedDouble);
+    EXPECT_EQ(element_kind_of_result("result = [1, 2.5]; result.push({}); result.pop();"sv), ElementKind::Values);
+}
+
+TEST_CASE(arrays_created_from_a_list_of_values)
+{
+    auto vm = MUST(JS::VM::create());
+    auto ast_interpreter = JS::Interpreter::create<JS::GlobalObject>(*vm);
+    auto& realm = ast_interpreter->realm();
+
+    auto int32_array = MUST(JS::Array::create(realm, 0));
+    int32_array->set_indexed_property_elements({ JS::Value(1), JS::Value(2), JS::Value(3) });
+    EXPECT_EQ(element_kind_of(*int32_array), ElementKind::PackedInt32);
+    EXPECT_EQ(int32_array->indexed_properties().array_like_size(), 3u);
+    EXPECT_EQ(int32_array->indexed_properties().get(2)->value.as_double(), 3.0);
+
+    auto double_array = MUST(JS::Array::create(realm, 0));
+    double_array->set_indexed_property_elements({ JS::Value(1), JS::Value(2.5) });
+    EXPECT_EQ(element_kind_of(*double_array), ElementKind::PackedDouble);
+    EXPECT_EQ(double_array->indexed_properties().get(1)->value.as_double(), 2.5);
+
+    auto value_array = MUST(JS::Array::create(realm, 0));
+    value_array->set_indexed_property_elements({ JS::Value(1), JS::js_null() });
+    EXPECT_EQ(element_kind_of(*value_array), ElementKind::Values);
+
+    auto holey_array = MUST(JS::Array::create(realm, 0));
+    holey_array->set_indexed_property_elements({ JS::Value(1), JS::Value() });
+    EXPECT_EQ(element_kind_of(*holey_array), ElementKind::Values);
+    EXPECT(!holey_array->indexed_properties().has_index(1));
+}
@@ -4,6 +4,7 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/TemporaryChange.h>
 #include <LibJS/AST.h>
 #include <LibJS/Bytecode/Generator.h>
 #include <LibJS/Bytecode/Interpreter.h>
@@ -45,6 +46,25 @@
     EXPECT_NO_EXCEPTION(executable)               \
     EXPECT_NO_EXCEPTION_WITH_OPTIMIZATIONS(executable)
 
+#define EXPECT_NO_EXCEPTION_FULLY_OPTIMIZED(source)                                                                                \
+    TemporaryChange optimize_bytecode { JS::Bytecode::g_optimize_bytecode, true };                                                 \
+    SETUP_AND_PARSE("(() => {\n" source "\n})()")                                                                                  \
+    auto executable = MUST(JS::Bytecode::Generator::generate(program));                                                            \
+    JS::Bytecode::Interpreter::optimization_pipeline(JS::Bytecode::Interpreter::OptimizationLevel::Optimize).perform(*executable); \
+    auto result = bytecode_interpreter.run(*executable);                                                                           \
+    EXPECT(!result.is_error());                                                                                                    \
+    if (result.is_error())                                                                                                         \
+        dbgln("Error: {}", MUST(result.throw_completion().value()->to_deprecated_string(vm)));
+
+#define EXPECT_NO_EXCEPTION_WITH_JIT(source)                            \
+    TemporaryChange use_jit { JS::Bytecode::g_use_jit, true };          \
+    SETUP_AND_PARSE("(() => {\n" source "\n})()")                       \
+    auto executable = MUST(JS::Bytecode::Generator::generate(program)); \
+    auto result = bytecode_interpreter.run(*executable);                \
+    EXPECT(!result.is_error());                                         \
+    if (result.is_error())                                              \
+        dbgln("Error: {}", MUST(result.throw_completion().value()->to_deprecated_string(vm)));
+
 TEST_CASE(empty_program)
 {
     EXPECT_NO_EXCEPTION_ALL("");
@@ -139,3 +159,72 @@ TEST_CASE(catch_exception)
                             "if (hitCatch !== true) throw new Exception('failed');\n"
                             "if (hitFinally !== true) throw new Exception('failed');");
 }
+
+TEST_CASE(constant_folding)
+{
+    EXPECT_NO_EXCEPTION_FULLY_OPTIMIZED("if (2 + 3 * 4 !== 14) throw new Exception('failed');\n"
+                                        "if ((7 & 3) !== 3 || (1 << 31) !== -2147483648 || (-1 >>> 0) !== 4294967295) throw new Exception('failed');\n"
+                                        "if (5 % -3 !== 2 || -5 % 3 !== -2 || 1 / -0 !== -Infinity) throw new Exception('failed');\n"
+                                        "if (!(null == undefined) || null === undefined || !(NaN !== NaN)) throw new Exception('failed');\n"
+                                        "if (1 < 2) { } else throw new Exception('failed');");
+}
+
+TEST_CASE(copy_propagation_and_dead_stores)
+{
+    EXPECT_NO_EXCEPTION_FULLY_OPTIMIZED("function sum(n) { let s = 0; for (let i = 0; i < n; i++) s = s + i * 3; return s; }\n"
+                                        "if (sum(10) !== 135) throw new Exception('failed');\n"
+                                        "let a = [1, 2, 3];\n"
+                                        "let b = a;\n"
+                                        "b[0] = a[1] + a[2];\n"
+                                        "if (a[0] !== 5) throw new Exception('failed');\n"
+                                        "let x = 0;\n"
+                                        "try { x = 1; undefinedFunction(); x = 2; } catch (e) { if (x !== 1) throw new Exception('failed'); }\n"
+                                        "function* g() { let y = 1; yield y; y++; yield y; }\n"
+                                        "if ([...g()].join() !== '1,2') throw new Exception('failed');");
+}
+
+TEST_CASE(jit_compiles_simple_executables)
+{
+    TemporaryChange use_jit { JS::Bytecode::g_use_jit, true };
+    SETUP_AND_PARSE("let s = 0; for (let i = 0; i < 10; i++) s += i;");
+    auto executable = MUST(JS::Bytecode::Generator::generate(program));
+#if ARCH(X86_64)
+    EXPECT(executable->get_or_create_native_executable() != nullptr);
+#else
+    EXPECT(executable->get_or_create_native_executable() == nullptr);
+#endif
+    auto result = bytecode_interpreter.run(*executable);
+    EXPECT(!result.is_error());
+}
+
+TEST_CASE(jit_int32_arithmetic_and_comparisons)
+{
+    EXPECT_NO_EXCEPTION_WITH_JIT("let s = 0; for (let i = 0; i < 100; i++) s = s + i * 3 - 1;\n"
+                                 "if (s !== 14750) throw new Exception('failed');\n"
+                                 "let b = 0; for (let i = 0; i < 32; ++i) b = (b << 1) ^ (i & 5) | (i >> 2);\n"
+                                 "if (b !== 1673789439) throw new Exception('failed');\n"
+                                 "if ((-1 >>> 0) !== 4294967295 || ~5 !== -6) throw new Exception('failed');\n"
+                                 "let c = 0; for (let i = 10; i > 0; i--) { if (i <= 5 && i >= 3) c++; }\n"
+                                 "if (c !== 3) throw new Exception('failed');");
+}
+
+TEST_CASE(jit_falls_back_for_non_int32_values)
+{
+    EXPECT_NO_EXCEPTION_WITH_JIT("let x = 2147483647; x++;\n"
+                                 "if (x !== 2147483648) throw new Exception('failed');\n"
+                                 "let y = 0.5; for (let i = 0; i < 4; i++) y = y * 2;\n"
+                                 "if (y !== 8) throw new Exception('failed');\n"
+                                 "if ('a' + 1 !== 'a1' || 1 + '1' !== '11') throw new Exception('failed');\n"
+                                 "let n = null; let u; if ((n ?? 3) !== 3 || (u ?? 4) !== 4) throw new Exception('failed');");
+}
+
+TEST_CASE(jit_calls_and_exceptions)
+{
+    EXPECT_NO_EXCEPTION_WITH_JIT("function fib(n) { return n < 2 ? n : fib(n - 1) + fib(n - 2); }\n"
+                                 "if (fib(15) !== 610) throw new Exception('failed');\n"
+                                 "let caught = 0;\n"
+                                 "for (let i = 0; i < 5; i++) { try { if (i % 2) undefinedFunction(); } catch (e) { caught++; } }\n"
+                                 "if (caught !== 2) throw new Exception('failed');\n"
+                                 "function* g() { for (let i = 0; i < 3; i++) yield i; }\n"
+                                 "if ([...g()].join() !== '0,1,2') throw new Exception('failed');");
+}
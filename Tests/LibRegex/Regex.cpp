@@ -1135,3 +1135,192 @@ TEST_CASE(inversion_state_in_char_class)
         EXPECT_EQ(result.capture_group_matches.first()[1].view.to_deprecated_string(), "}"sv);
     }
 }
+
+TEST_CASE(lazy_dfa_finds_the_same_matches)
+{
+    // These patterns are all run by the lazy DFA, which has to pick the same matches the backtracking VM would.
+    constexpr auto first_match = combine_flags(ECMAScriptFlags::Global, (ECMAScriptFlags)regex::AllFlags::SingleMatch);
+    constexpr auto global_multiline = combine_flags(ECMAScriptFlags::Global, ECMAScriptFlags::Multiline);
+
+    struct _test {
+        StringView pattern;
+        StringView subject;
+        ECMAScriptFlags options {};
+        Vector<StringView> matches {};
+        Vector<StringView> capture_groups {};
+    };
+    // clang-format off
+    _test const tests[] {
+        { "a|ab"sv, "ab"sv, first_match, { "a"sv } },
+        { "ab|a"sv, "ab"sv, first_match, { "ab"sv } },
+        { "a*"sv, "aaab"sv, first_match, { "aaa"sv } },
+        { "a*?b"sv, "aaab"sv, first_match, { "aaab"sv } },
+        { "a+?"sv, "aaab"sv, first_match, { "a"sv } },
+        { "(a|ab)(c|bcd)(d*)"sv, "abcd"sv, first_match, { "abcd"sv }, { "a"sv, "bcd"sv } },
+        { "(?:a|b)*c"sv, "xababc"sv, first_match, { "ababc"sv } },
+        { "(a*)*b"sv, "aab"sv, first_match, { "aab"sv } },
+        { "^(?:a|aa)*$"sv, "aaaa"sv, {}, { "aaaa"sv } },
+        { "\\bfoo\\b"sv, "a foo b foobar"sv, ECMAScriptFlags::Global, { "foo"sv } },
+        { "\\Boo"sv, "foo oo"sv, ECMAScriptFlags::Global, { "oo"sv } },
+        { "^ab"sv, "ab\nab"sv, global_multiline, { "ab"sv, "ab"sv } },
+        { "b$"sv, "ab\nab"sv, global_multiline, { "b"sv, "b"sv } },
+        { "hello"sv, "Say HeLLo, hello"sv, combine_flags(ECMAScriptFlags::Global, ECMAScriptFlags::Insensitive), { "HeLLo"sv, "hello"sv } },
+        { "[0-9]+-[0-9]+"sv, "1-2 33-44 5 6-"sv, ECMAScriptFlags::Global, { "1-2"sv, "33-44"sv } },
+        { "x*"sv, "axb"sv, ECMAScriptFlags::Global, { ""sv, "x"sv, ""sv, ""sv } },
+    };
+    // clang-format on
+
+    for (auto& test : tests) {
+        Regex<ECMA262> re(test.pattern, test.options);
+        auto result = re.match(test.subject);
+        EXPECT_EQ(result.success, !test.matches.is_empty());
+        EXPECT_EQ(result.matches.size(), test.matches.size());
+        for (size_t i = 0; i < min(result.matches.size(), test.matches.size()); ++i)
+            EXPECT_EQ(result.matches[i].view.to_deprecated_string(), test.matches[i]);
+        if (!test.capture_groups.is_empty()) {
+            for (size_t i = 0; i < test.capture_groups.size(); ++i)
+                EXPECT_EQ(result.capture_group_matches.first()[i].view.to_deprecated_string(), test.capture_groups[i]);
+        }
+    }
+}
+
+TEST_CASE(lazy_dfa_falls_back_to_backtracking)
+{
+    // Backreferences and lookarounds can't be run by the DFA.
+    {
+        Regex<ECMA262> re("(a+)b\\1"sv, ECMAScriptFlags::Global);
+        auto result = re.match("aabaa abaa"sv);
+        EXPECT_EQ(result.matches.size(), 2u);
+        EXPECT_EQ(result.matches[0].view.to_deprecated_string(), "aabaa"sv);
+        EXPECT_EQ(result.matches[1].view.to_deprecated_string(), "aba"sv);
+    }
+    {
+        Regex<ECMA262> re("foo(?!bar)"sv, ECMAScriptFlags::Global);
+        auto result = re.match("foobar foobaz"sv);
+        EXPECT_EQ(result.matches.size(), 1u);
+        EXPECT_EQ(result.matches[0].global_offset, 7u);
+    }
+}
+
+TEST_CASE(optimizer_finds_required_literals)
+{
+    struct _test {
+        StringView pattern;
+        StringView literal_prefix;
+        StringView required_literal;
+        size_t first_byte_count { 0 };
+    };
+    // clang-format off
+    _test const tests[] {
+        { "hello"sv, "hello"sv, "hello"sv },
+        { "\\bfoo(bar|baz)quux"sv, "foo"sv, "quux"sv },
+        { "^GET /[a-z]+ HTTP"sv, "GET /"sv, "GET /"sv },
+        { "[0-9]+px"sv, ""sv, "px"sv, 10 },
+        { "(a|b)c"sv, ""sv, "c"sv, 2 },
+        { "[a-z]+@example\\.com"sv, ""sv, "@example.com"sv, 26 },
+        { "a|b"sv, ""sv, ""sv, 2 },
+        { "x*"sv, ""sv, ""sv },
+        { "(a)b\\1"sv, "ab"sv, "ab"sv },
+    };
+    // clang-format on
+
+    for (auto& test : tests) {
+        Regex<ECMA262> re(test.pattern);
+        auto& data = re.parser_result.optimization_data;
+        EXPECT_EQ(data.literal_prefix, test.literal_prefix);
+        EXPECT_EQ(data.required_literal, test.required_literal);
+        size_t first_byte_count = 0;
+        if (data.first_bytes.has_value()) {
+            for (auto is_first_byte : *data.first_bytes)
+                first_byte_count += is_first_byte ? 1 : 0;
+        }
+        EXPECT_EQ(first_byte_count, test.first_byte_count);
+    }
+}
+
+TEST_CASE(prefilter_skips_start_positions)
+{
+    auto subject = DeprecatedString::formatted("{}width: 12px", DeprecatedString::repeated('-', 1000));
+    {
+        Regex<ECMA262> re("[0-9]+px"sv, ECMAScriptFlags::Global);
+        auto result = re.match(subject);
+        EXPECT_EQ(result.matches.size(), 1u);
+        EXPECT_EQ(result.matches[0].view.to_deprecated_string(), "12px"sv);
+        EXPECT_EQ(re.matcher->statistics().start_positions_tried, 1u);
+        EXPECT(re.matcher->statistics().start_positions_skipped >= 1000);
+    }
+    {
+        Regex<ECMA262> re("width: [0-9]+"sv, ECMAScriptFlags::Global);
+        auto result = re.match(subject);
+        EXPECT_EQ(result.matches.size(), 1u);
+        EXPECT_EQ(result.matches[0].global_offset, 1000u);
+    }
+    {
+        Regex<ECMA262> re("[a-z]+@example\\.com"sv, ECMAScriptFlags::Global);
+        EXPECT_EQ(re.match(subject).success, false);
+        EXPECT_EQ(re.matcher->statistics().start_positions_tried, 0u);
+        EXPECT_EQ(re.matcher->statistics().views_rejected, 1u);
+    }
+    {
+        // The literals don't apply if the case of the input is ignored.
+        Regex<ECMA262> re("WIDTH"sv, ECMAScriptFlags::Global);
+        EXPECT_EQ(re.match(subject).success, false);
+        EXPECT_EQ(re.match(subject, ECMAScriptFlags::Insensitive).success, true);
+    }
+}
+
+// Built on first use, so that runs which skip the benchmarks don't pay for it.
+static DeprecatedString const& haystack()
+{
+    static auto const haystack = [] {
+        StringBuilder builder;
+        for (size_t i = 0; builder.length() < 1 * MiB; ++i)
+            builder.appendff("word{} {}-{}, ", i, i * 7 % 100, i % 13);
+        return builder.to_deprecated_string();
+    }();
+    return haystack;
+}
+
+BENCHMARK_CASE(lazy_dfa_pathological_alternation)
+{
+    // The backtracking VM takes exponential time to reject this.
+    Regex<ECMA262> re("^(?:a|aa)*$"sv);
+    auto result = re.match(DeprecatedString::formatted("{}b", DeprecatedString::repeated('a', 5000)));
+    EXPECT_EQ(result.success, false);
+}
+
+BENCHMARK_CASE(lazy_dfa_global_search)
+{
+    Regex<ECMA262> re("[0-9]+-1[0-2]\\b"sv, ECMAScriptFlags::Global);
+    auto result = re.match(haystack());
+    EXPECT_EQ(result.success, true);
+    EXPECT(result.matches.size() > 1000);
+}
+
+BENCHMARK_CASE(lazy_dfa_search_without_match)
+{
+    Regex<PosixExtended> re("word[0-9]+ (foo|bar)+"sv);
+    RegexResult result;
+    EXPECT_EQ(re.search(haystack(), result), false);
+}
+
+BENCHMARK_CASE(prefilter_required_literal)
+{
+    Regex<ECMA262> re("[a-z]+@example\\.com"sv, ECMAScriptFlags::Global);
+    EXPECT_EQ(re.match(haystack()).success, false);
+}
+
+BENCHMARK_CASE(prefilter_literal_prefix)
+{
+    Regex<ECMA262> re("-1[0-2],"sv, ECMAScriptFlags::Global);
+    auto result = re.match(haystack());
+    EXPECT(result.matches.size() > 1000);
+    EXPECT(re.matcher->statistics().start_positions_skipped > re.matcher->statistics().start_positions_tried);
+}
+
+BENCHMARK_CASE(prefilter_first_bytes)
+{
+    Regex<ECMA262> re("(?:5|6)[0-9]-"sv, ECMAScriptFlags::Global);
+    auto result = re.match(haystack());
+    EXPECT(result.matches.size() > 1000);
+}
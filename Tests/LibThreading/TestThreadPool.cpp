@@ -0,0 +1,70 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Array.h>
+#include <AK/Atomic.h>
+#include <AK/Vector.h>
+#include <LibTest/TestCase.h>
+#include <LibThreading/ThreadPool.h>
+
+TEST_CASE(every_job_runs_exactly_once)
+{
+    auto pool = MUST(Threading::ThreadPool::try_create(4));
+    EXPECT_EQ(pool->concurrency(), 5u);
+
+    Array<Atomic<u32>, 1000> run_counts {};
+    pool->for_each(run_counts.size(), [&](size_t index) {
+        run_counts[index].fetch_add(1);
+    });
+
+    for (auto& count : run_counts)
+        EXPECT_EQ(count.load(), 1u);
+}
+
+TEST_CASE(pool_can_be_reused)
+{
+    auto pool = MUST(Threading::ThreadPool::try_create(3));
+
+    Atomic<size_t> total { 0 };
+    for (size_t round = 0; round < 200; ++round) {
+        pool->for_each(round % 7, [&](size_t index) {
+            total.fetch_add(index + 1);
+        });
+    }
+
+    size_t expected_total = 0;
+    for (size_t round = 0; round < 200; ++round) {
+        auto job_count = round % 7;
+        expected_total += job_count * (job_count + 1) / 2;
+    }
+    EXPECT_EQ(total.load(), expected_total);
+}
+
+TEST_CASE(pool_without_threads_runs_jobs_inline)
+{
+    auto pool = MUST(Threading::ThreadPool::try_create(0));
+    EXPECT_EQ(pool->concurrency(), 1u);
+
+    Vector<size_t> order;
+    pool->for_each(5, [&](size_t index) {
+        order.append(index);
+    });
+    EXPECT_EQ(order, (Vector<size_t> { 0, 1, 2, 3, 4 }));
+}
+
+TEST_CASE(jobs_know_they_are_running_in_a_pool)
+{
+    auto pool = MUST(Threading::ThreadPool::try_create(3));
+    EXPECT(!Threading::ThreadPool::is_running_a_job_on_current_thread());
+
+    Atomic<size_t> jobs_outside_of_pool { 0 };
+    pool->for_each(100, [&](size_t) {
+        if (!Threading::ThreadPool::is_running_a_job_on_current_thread())
+            jobs_outside_of_pool.fetch_add(1);
+    });
+    EXPECT_EQ(jobs_outside_of_pool.load(), 0u);
+    EXPECT(!Threading::ThreadPool::is_running_a_job_on_current_thread());
+}
@@ -0,0 +1,804 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/MemoryStream.h>
+#include <AK/OwnPtr.h>
+#include <LibTest/TestCase.h>
+#include <LibWasm/AbstractMachine/AbstractMachine.h>
+#include <LibWasm/AbstractMachine/BytecodeInterpreter.h>
+#include <LibWasm/Opcode.h>
+#include <LibWasm/Types.h>
+
+// Every function is run once through its precompiled form, and once through the stack-based interpreter, which is how
+// all functions were executed before they got precompiled. Both have to agree on the results.
+
+using namespace Wasm::Instructions;
+
+namespace {
+
+struct StackBasedInterpreter final : public Wasm::BytecodeInterpreter {
+    virtual bool may_run_precompiled_code() const override { return false; }
+};
+
+constexpr u8 i32_type = 0x7f;
+constexpr u8 i64_type = 0x7e;
+constexpr u8 f64_type = 0x7c;
+constexpr u8 empty_block_type = 0x40;
+
+class Code {
+public:
+    Code& op(Wasm::OpCode opcode)
+    {
+        if (opcode.value() > 0xff) {
+            m_bytes.append(opcode.value() >> 8);
+            return u(opcode.value() & 0xff);
+        }
+        m_bytes.append(opcode.value());
+        return *this;
+    }
+
+    Code& byte(u8 value)
+    {
+        m_bytes.append(value);
+        return *this;
+    }
+
+    Code& u(u32 value)
+    {
+        do {
+            u8 byte = value & 0x7f;
+            value >>= 7;
+            m_bytes.append(value != 0 ? byte | 0x80 : byte);
+        } while (value != 0);
+        return *this;
+    }
+
+    Code& s(i64 value)
+    {
+        while (true) {
+            u8 byte = value & 0x7f;
+            value >>= 7;
+            if ((value == 0 && !(byte & 0x40)) || (value == -1 && (byte & 0x40))) {
+                m_bytes.append(byte);
+                return *this;
+            }
+            m_bytes.append(byte | 0x80);
+        }
+    }
+
+    // The structured instructions are only represented as opcodes after parsing.
+    Code& else_() { return byte(0x05); }
+    Code& end() { return byte(0x0b); }
+
+    Code& i32(i32 value) { return op(i32_const).s(value); }
+    Code& i64(i64 value) { return op(i64_const).s(value); }
+    Code& f64(double value)
+    {
+        op(f64_const);
+        auto bits = bit_cast<u64>(value);
+        for (size_t i = 0; i < sizeof(bits); ++i)
+            m_bytes.append(bits >> (i * 8));
+        return *this;
+    }
+    Code& get(u32 local) { return op(local_get).u(local); }
+    Code& set(u32 local) { return op(local_set).u(local); }
+    Code& tee(u32 local) { return op(local_tee).u(local); }
+    Code& memory(Wasm::OpCode opcode, u32 offset = 0) { return op(opcode).u(0).u(offset); }
+    Code& append(Code const& other)
+    {
+        m_bytes.extend(other.m_bytes);
+        return *this;
+    }
+
+    Vector<u8> const& bytes() const { return m_bytes; }
+
+private:
+    Vector<u8> m_bytes;
+};
+
+class ModuleBuilder {
+public:
+    u32 add_type(Vector<u8> parameters, Vector<u8> results)
+    {
+        m_types.append(move(parameters));
+        m_types.append(move(results));
+        return m_types.size() / 2 - 1;
+    }
+
+    // Imported functions come first in the function index space, so they have to be added before any other function.
+    u32 add_function_import(StringView name, u32 type)
+    {
+        VERIFY(m_functions.is_empty());
+        m_function_imports.append({ name, type });
+        return m_function_imports.size() - 1;
+    }
+
+    u32 add_function(StringView name, u32 type, Vector<u8> locals, Code const& body)
+    {
+        m_functions.append({ name, type, move(locals), body });
+        return m_function_imports.size() + m_functions.size() - 1;
+    }
+
+    void set_memory(u32 pages) { m_memory_pages = pages; }
+    void set_table(Vector<u32> functions) { m_table = move(functions); }
+    void add_global(u8 type, Code const& initializer) { m_globals.append({ type, initializer }); }
+
+    ByteBuffer build() const
+    {
+        Code module;
+        module.byte(0).byte('a').byte('s').byte('m').byte(1).byte(0).byte(0).byte(0);
+
+        Code types;
+        types.u(m_types.size() / 2);
+        for (size_t i = 0; i < m_types.size(); i += 2) {
+            types.byte(0x60).u(m_types[i].size());
+            for (auto type : m_types[i])
+                types.byte(type);
+            types.u(m_types[i + 1].size());
+            for (auto type : m_types[i + 1])
+                types.byte(type);
+        }
+        append_section(module, 1, types);
+
+        if (!m_function_imports.is_empty()) {
+            Code imports;
+            imports.u(m_function_imports.size());
+            for (auto& import : m_function_imports) {
+                imports.u(3).byte('e').byte('n').byte('v');
+                imports.u(import.name.length());
+                for (auto c : import.name)
+                    imports.byte(c);
+                imports.byte(0).u(import.type);
+            }
+            append_section(module, 2, imports);
+        }
+
+        Code functions;
+        functions.u(m_functions.size());
+        for (auto& function : m_functions)
+            functions.u(function.type);
+        append_section(module, 3, functions);
+
+        if (!m_table.is_empty()) {
+            Code table;
+            table.u(1).byte(0x70).byte(0).u(m_table.size());
+            append_section(module, 4, table);
+        }
+
+        if (m_memory_pages.has_value()) {
+            Code memory;
+            memory.u(1).byte(0).u(*m_memory_pages);
+            append_section(module, 5, memory);
+        }
+
+        if (!m_globals.is_empty()) {
+            Code globals;
+            globals.u(m_globals.size());
+            for (auto& global : m_globals)
+                globals.byte(global.type).byte(1).append(global.initializer).end();
+            append_section(module, 6, globals);
+        }
+
+        Code exports;
+        exports.u(m_functions.size());
+        for (size_t i = 0; i < m_functions.size(); ++i) {
+            exports.u(m_functions[i].name.length());
+            for (auto c : m_functions[i].name)
+                exports.byte(c);
+            exports.byte(0).u(m_function_imports.size() + i);
+        }
+        append_section(module, 7, exports);
+
+        if (!m_table.is_empty()) {
+            Code elements;
+            elements.u(1).u(0).i32(0).end().u(m_table.size());
+            for (auto function : m_table)
+                elements.u(function);
+            append_section(module, 9, elements);
+        }
+
+        Code code;
+        code.u(m_functions.size());
+        for (auto& function : m_functions) {
+            Code entry;
+            entry.u(function.locals.size());
+            for (auto type : function.locals)
+                entry.u(1).byte(type);
+            entry.append(function.body).end();
+            code.u(entry.bytes().size()).append(entry);
+        }
+        append_section(module, 10, code);
+
+        return MUST(ByteBuffer::copy(module.bytes()));
+    }
+
+private:
+    static void append_section(Code& module, u8 id, Code const& contents)
+    {
+        module.byte(id).u(contents.bytes().size()).append(contents);
+    }
+
+    struct Function {
+        StringView name;
+        u32 type;
+        Vector<u8> locals;
+        Code body;
+    };
+
+    struct Global {
+        u8 type;
+        Code initializer;
+    };
+
+    struct FunctionImport {
+        StringView name;
+        u32 type;
+    };
+
+    Vector<Vector<u8>> m_types;
+    Vector<FunctionImport> m_function_imports;
+    Vector<Function> m_functions;
+    Vector<Global> m_globals;
+    Vector<u32> m_table;
+    Optional<u32> m_memory_pages;
+};
+
+class Instance {
+public:
+    // The host functions satisfy the module's function imports, in order.
+    explicit Instance(ModuleBuilder const& builder, Wasm::MemoryInstance::Backing memory_backing = Wasm::MemoryInstance::Backing::ByteBuffer, Vector<Wasm::HostFunction> host_functions = {})
+    {
+        if (memory_backing == Wasm::MemoryInstance::Backing::GuardPages)
+            m_machine.enable_guard_page_backed_memories();
+
+        auto bytes = builder.build();
+        FixedMemoryStream stream { bytes.bytes() };
+        auto module = Wasm::Module::parse(stream);
+        if (module.is_error())
+            FAIL(Wasm::parse_error_to_deprecated_string(module.error()));
+        VERIFY(!module.is_error());
+        m_module = make<Wasm::Module>(module.release_value());
+
+        Vector<Wasm::ExternValue> imports;
+        for (auto& host_function : host_functions)
+            imports.append(*m_machine.store().allocate(move(host_function)));
+
+        auto instance = m_machine.instantiate(*m_module, move(imports));
+        if (instance.is_error())
+            FAIL(instance.error().error);
+        VERIFY(!instance.is_error());
+        m_instance = instance.release_value();
+    }
+
+    Wasm::FunctionAddress function(StringView name) const
+    {
+        for (auto& entry : m_instance->exports()) {
+            if (entry.name() == name)
+                return entry.value().get<Wasm::FunctionAddress>();
+        }
+        VERIFY_NOT_REACHED();
+    }
+
+    Wasm::MemoryInstance& memory()
+    {
+        return *m_machine.store().get(m_instance->memories().first());
+    }
+
+    bool is_precompiled(StringView name)
+    {
+        auto* instance = m_machine.store().get(function(name));
+        return instance->get<Wasm::WasmFunction>().precompiled() != nullptr;
+    }
+
+    Wasm::Result invoke(Wasm::Interpreter& interpreter, StringView name, Vector<Wasm::Value> arguments)
+    {
+        return m_machine.invoke(interpreter, function(name), move(arguments));
+    }
+
+    // Runs the function with both interpreters, and returns the raw bits of its first result, if it didn't trap.
+    Optional<u64> run(StringView name, Vector<Wasm::Value> arguments = {})
+    {
+        Wasm::BytecodeInterpreter precompiled_interpreter;
+        StackBasedInterpreter stack_based_interpreter;
+        auto precompiled = invoke(precompiled_interpreter, name, arguments);
+        auto stack_based = invoke(stack_based_interpreter, name, arguments);
+
+        EXPECT_EQ(precompiled.is_trap(), stack_based.is_trap());
+        if (precompiled.is_trap() || stack_based.is_trap())
+            return {};
+
+        EXPECT_EQ(precompiled.values().size(), stack_based.values().size());
+        for (size_t i = 0; i < min(precompiled.values().size(), stack_based.values().size()); ++i)
+            EXPECT_EQ(raw_bits(precompiled.values()[i]), raw_bits(stack_based.values()[i]));
+
+        if (precompiled.values().is_empty())
+            return 0;
+        return raw_bits(precompiled.values().last());
+    }
+
+private:
+    static u64 raw_bits(Wasm::Value const& value)
+    {
+        return value.value().visit(
+            [](i32 value) -> u64 { return bit_cast<u32>(value); },
+            [](i64 value) -> u64 { return bit_cast<u64>(value); },
+            [](float value) -> u64 { return bit_cast<u32>(value); },
+            [](double value) -> u64 { return bit_cast<u64>(value); },
+            [](Wasm::Reference const&) -> u64 { VERIFY_NOT_REACHED(); });
+    }
+
+    Wasm::AbstractMachine m_machine;
+    OwnPtr<Wasm::Module> m_module;
+    OwnPtr<Wasm::ModuleInstance> m_instance;
+};
+
+// (i32) -> i32, recursive.
+void add_fibonacci(ModuleBuilder& builder)
+{
+    auto type = builder.add_type({ i32_type }, { i32_type });
+    Code body;
+    body.get(0).i32(2).op(i32_lts).op(if_).byte(i32_type)
+        .get(0)
+        .else_()
+        .get(0).i32(1).op(i32_sub).op(call).u(0)
+        .get(0).i32(2).op(i32_sub).op(call).u(0)
+        .op(i32_add)
+        .end();
+    builder.add_function("fibonacci"sv, type, {}, body);
+}
+
+// (i32) -> i64, sums up the numbers below the argument.
+void add_loop_sum(ModuleBuilder& builder)
+{
+    auto type = builder.add_type({ i32_type }, { i64_type });
+    Code body;
+    body.op(block).byte(empty_block_type)
+        .op(loop).byte(empty_block_type)
+        .get(0).op(i32_eqz).op(br_if).u(1)
+        .get(0).i32(1).op(i32_sub).tee(0)
+        .op(i64_extend_ui32).get(1).op(i64_add).set(1)
+        .op(br).u(0)
+        .end()
+        .end()
+        .get(1);
+    builder.add_function("loop_sum"sv, type, { i64_type }, body);
+}
+
+// (i32) -> i32, counts the primes below the argument using memory as the sieve.
+void add_sieve(ModuleBuilder& builder)
+{
+    auto type = builder.add_type({ i32_type }, { i32_type });
+    // Locals: 1 = i, 2 = j, 3 = count
+    Code body;
+    body.i32(0).i32(0).get(0).op(memory_fill).byte(0)
+        .i32(2).set(1)
+        .op(block).byte(empty_block_type)
+        .op(loop).byte(empty_block_type)
+        .get(1).get(0).op(i32_ges).op(br_if).u(1)
+        .get(1).memory(i32_load8_u).op(i32_eqz)
+        .op(if_).byte(empty_block_type)
+        .get(3).i32(1).op(i32_add).set(3)
+        .get(1).get(1).op(i32_add).set(2)
+        .op(block).byte(empty_block_type)
+        .op(loop).byte(empty_block_type)
+        .get(2).get(0).op(i32_ges).op(br_if).u(1)
+        .get(2).i32(1).memory(i32_store8)
+        .get(2).get(1).op(i32_add).set(2)
+        .op(br).u(0)
+        .end()
+        .end()
+        .end()
+        .get(1).i32(1).op(i32_add).set(1)
+        .op(br).u(0)
+        .end()
+        .end()
+        .get(3);
+    builder.add_function("sieve"sv, type, { i32_type, i32_type, i32_type }, body);
+}
+
+// (i32) -> f64, multiplies two n*n matrices of doubles and returns the sum of the result.
+void add_matrix_multiply(ModuleBuilder& builder)
+{
+    auto type = builder.add_type({ i32_type }, { f64_type });
+    // Locals: 1 = i, 2 = j, 3 = k, 4 = sum, 5 = total, 6 = second matrix, 7 = result matrix, 8 = first matrix (always 0)
+    auto element = [](u32 matrix, u32 row, u32 column) {
+        Code code;
+        code.get(row).get(0).op(i32_mul).get(column).op(i32_add).i32(3).op(i32_shl).get(matrix).op(i32_add);
+        return code;
+    };
+    auto for_each = [](u32 index, Code const& inner) {
+        Code code;
+        code.i32(0).set(index)
+            .op(block).byte(empty_block_type)
+            .op(loop).byte(empty_block_type)
+            .get(index).get(0).op(i32_ges).op(br_if).u(1)
+            .append(inner)
+            .get(index).i32(1).op(i32_add).set(index)
+            .op(br).u(0)
+            .end()
+            .end();
+        return code;
+    };
+
+    // Fill the first matrix (at 0) with i + j and the second one with i - j.
+    Code fill;
+    fill.append(element(8, 1, 2)).get(1).get(2).op(i32_add).op(f64_convert_si32).memory(f64_store)
+        .append(element(6, 1, 2)).get(1).get(2).op(i32_sub).op(f64_convert_si32).memory(f64_store);
+
+    Code dot_product;
+    dot_product.get(4)
+        .append(element(8, 1, 3)).memory(f64_load)
+        .append(element(6, 3, 2)).memory(f64_load)
+        .op(f64_mul).op(f64_add).set(4);
+
+    Code multiply;
+    multiply.f64(0).set(4)
+        .append(for_each(3, dot_product))
+        .append(element(7, 1, 2)).get(4).memory(f64_store)
+        .get(5).get(4).op(f64_add).set(5);
+
+    Code body;
+    body.get(0).get(0).op(i32_mul).i32(3).op(i32_shl).tee(6).get(6).op(i32_add).set(7)
+        .append(for_each(1, for_each(2, fill)))
+        .append(for_each(1, for_each(2, multiply)))
+        .get(5);
+    builder.add_function("matrix_multiply"sv, type, { i32_type, i32_type, i32_type, f64_type, f64_type, i32_type, i32_type, i32_type }, body);
+}
+
+}
+
+TEST_CASE(compute_kernels)
+{
+    ModuleBuilder builder;
+    builder.set_memory(4);
+    add_fibonacci(builder);
+    add_loop_sum(builder);
+    add_sieve(builder);
+    add_matrix_multiply(builder);
+    Instance instance { builder };
+
+    EXPECT(instance.is_precompiled("fibonacci"sv));
+    EXPECT(instance.is_precompiled("loop_sum"sv));
+    EXPECT(instance.is_precompiled("sieve"sv));
+    EXPECT(instance.is_precompiled("matrix_multiply"sv));
+
+    EXPECT_EQ(instance.run("fibonacci"sv, { Wasm::Value(15) }), 610u);
+    EXPECT_EQ(instance.run("loop_sum"sv, { Wasm::Value(1000) }), 499500u);
+    EXPECT_EQ(instance.run("sieve"sv, { Wasm::Value(10000) }), 1229u);
+    // Sum over i, j, k of (i + k) * (k - j) for n = 10
+    EXPECT_EQ(instance.run("matrix_multiply"sv, { Wasm::Value(10) }), bit_cast<u64>(8250.0));
+}
+
+TEST_CASE(traps)
+{
+    ModuleBuilder builder;
+    builder.set_memory(1);
+    auto binary = builder.add_type({ i32_type, i32_type }, { i32_type });
+    auto unary = builder.add_type({ i32_type }, { i32_type });
+    builder.add_function("divide"sv, binary, {}, Code {}.get(0).get(1).op(i32_divs));
+    builder.add_function("remainder"sv, binary, {}, Code {}.get(0).get(1).op(i32_rems));
+    builder.add_function("load"sv, unary, {}, Code {}.get(0).memory(i32_load, 4));
+    builder.add_function("store"sv, unary, {}, Code {}.get(0).get(0).op(i64_extend_si32).memory(i64_store16).i32(1));
+    builder.add_function("fill"sv, unary, {}, Code {}.get(0).i32(1).i32(16).op(memory_fill).byte(0).i32(1));
+    builder.add_function("unreachable"sv, unary, {}, Code {}.get(0).op(if_).byte(empty_block_type).op(unreachable).end().i32(7));
+    builder.add_function("truncate"sv, unary, {}, Code {}.get(0).op(f32_reinterpret_i32).op(i32_trunc_sf32));
+    Instance instance { builder };
+
+    EXPECT_EQ(instance.run("divide"sv, { Wasm::Value(7), Wasm::Value(-2) }), static_cast<u32>(-3));
+    EXPECT_EQ(instance.run("divide"sv, { Wasm::Value(7), Wasm::Value(0) }), Optional<u64> {});
+    EXPECT_EQ(instance.run("divide"sv, { Wasm::Value(NumericLimits<i32>::min()), Wasm::Value(-1) }), Optional<u64> {});
+    EXPECT_EQ(instance.run("remainder"sv, { Wasm::Value(NumericLimits<i32>::min()), Wasm::Value(-1) }), 0u);
+    EXPECT_EQ(instance.run("load"sv, { Wasm::Value(65528) }), 0u);
+    EXPECT_EQ(instance.run("load"sv, { Wasm::Value(65529) }), Optional<u64> {});
+    EXPECT_EQ(instance.run("load"sv, { Wasm::Value(-1) }), Optional<u64> {});
+    EXPECT_EQ(instance.run("store"sv, { Wasm::Value(65534) }), 1u);
+    EXPECT_EQ(instance.run("store"sv, { Wasm::Value(65535) }), Optional<u64> {});
+    EXPECT_EQ(instance.run("fill"sv, { Wasm::Value(65520) }), 1u);
+    EXPECT_EQ(instance.run("unreachable"sv, { Wasm::Value(0) }), 7u);
+    EXPECT_EQ(instance.run("unreachable"sv, { Wasm::Value(1) }), Optional<u64> {});
+    EXPECT_EQ(instance.run("truncate"sv, { Wasm::Value(bit_cast<i32>(-2.5f)) }), static_cast<u32>(-2));
+    EXPECT_EQ(instance.run("truncate"sv, { Wasm::Value(bit_cast<i32>(__builtin_nanf(""))) }), Optional<u64> {});
+}
+
+TEST_CASE(control_flow)
+{
+    ModuleBuilder builder;
+    auto unary = builder.add_type({ i32_type }, { i32_type });
+    auto two_results = builder.add_type({}, { i32_type, i32_type });
+    auto loop_type = builder.add_type({ i32_type }, { i32_type });
+
+    Code branch_table;
+    branch_table.op(block).byte(empty_block_type)
+        .op(block).byte(empty_block_type)
+        .op(block).byte(empty_block_type)
+        .get(0).op(br_table).u(2).u(0).u(1).u(2)
+        .end()
+        .i32(100).op(return_)
+        .end()
+        .i32(200).op(return_)
+        .end()
+        .i32(300);
+    builder.add_function("branch_table"sv, unary, {}, branch_table);
+
+    // Branches carrying a value out of nested blocks.
+    Code branch_with_value;
+    branch_with_value.op(block).byte(i32_type)
+        .i32(1)
+        .op(block).byte(i32_type)
+        .i32(10).get(0).op(br_if).u(1)
+        .op(drop).i32(20)
+        .end()
+        .op(i32_add)
+        .end();
+    builder.add_function("branch_with_value"sv, unary, {}, branch_with_value);
+
+    Code multi_value;
+    multi_value.op(block).u(two_results)
+        .get(0).i32(3)
+        .end()
+        .op(i32_sub);
+    builder.add_function("multi_value"sv, unary, {}, multi_value);
+
+    // Counts the argument down to zero, passing the counter as a loop parameter.
+    Code loop_parameters;
+    loop_parameters.i32(0).get(0)
+        .op(loop).u(loop_type)
+        .tee(0).op(i32_eqz).op(if_).byte(empty_block_type)
+        .get(0).op(return_)
+        .end()
+        .i32(1).op(i32_add)
+        .get(0).i32(1).op(i32_sub)
+        .op(br).u(0)
+        .end()
+        .op(drop).op(unreachable);
+    builder.add_function("loop_parameters"sv, unary, {}, Code {}.append(loop_parameters));
+
+    Code select_;
+    select_.i32(10).i32(20).get(0).op(Wasm::Instructions::select);
+    builder.add_function("select"sv, unary, {}, select_);
+
+    // Locals that are still on the stack when they're overwritten.
+    Code swap;
+    swap.i32(7).set(1)
+        .get(0).get(1).set(0).set(1)
+        .get(0).i32(100).op(i32_mul).get(1).op(i32_add);
+    builder.add_function("swap"sv, unary, { i32_type }, swap);
+
+    Code tee;
+    tee.get(0).get(0).i32(1).op(i32_add).tee(0).get(0).op(i32_mul).op(i32_add);
+    builder.add_function("tee"sv, unary, {}, tee);
+
+    Instance instance { builder };
+    EXPECT(instance.is_precompiled("branch_table"sv));
+
+    EXPECT_EQ(instance.run("branch_table"sv, { Wasm::Value(0) }), 100u);
+    EXPECT_EQ(instance.run("branch_table"sv, { Wasm::Value(1) }), 200u);
+    EXPECT_EQ(instance.run("branch_table"sv, { Wasm::Value(2) }), 300u);
+    EXPECT_EQ(instance.run("branch_table"sv, { Wasm::Value(3) }), 300u);
+    EXPECT_EQ(instance.run("branch_table"sv, { Wasm::Value(-1) }), 300u);
+    EXPECT_EQ(instance.run("branch_with_value"sv, { Wasm::Value(1) }), 10u);
+    EXPECT_EQ(instance.run("branch_with_value"sv, { Wasm::Value(0) }), 21u);
+    EXPECT_EQ(instance.run("multi_value"sv, { Wasm::Value(10) }), 7u);
+    EXPECT_EQ(instance.run("select"sv, { Wasm::Value(1) }), 10u);
+    EXPECT_EQ(instance.run("select"sv, { Wasm::Value(0) }), 20u);
+    EXPECT_EQ(instance.run("swap"sv, { Wasm::Value(3) }), 703u);
+    EXPECT_EQ(instance.run("tee"sv, { Wasm::Value(3) }), 19u);
+
+    // The stack-based interpreter gives loops the arity of their results rather than their parameters.
+    Wasm::BytecodeInterpreter interpreter;
+    auto result = instance.invoke(interpreter, "loop_parameters"sv, { Wasm::Value(5) });
+    EXPECT(!result.is_trap());
+    EXPECT_EQ(result.values().first().to<i32>(), 0);
+}
+
+TEST_CASE(calls_globals_and_memory)
+{
+    ModuleBuilder builder;
+    builder.set_memory(1);
+    builder.add_global(i32_type, Code {}.i32(5));
+    auto unary = builder.add_type({ i32_type }, { i32_type });
+    auto binary = builder.add_type({ i32_type, i32_type }, { i32_type });
+    auto nullary = builder.add_type({}, { i32_type });
+
+    auto add = builder.add_function("add"sv, binary, {}, Code {}.get(0).get(1).op(i32_add));
+    auto subtract = builder.add_function("subtract"sv, binary, {}, Code {}.get(0).get(1).op(i32_sub));
+    auto negate = builder.add_function("negate"sv, unary, {}, Code {}.i32(0).get(0).op(i32_sub));
+    builder.set_table({ add, subtract, negate });
+
+    builder.add_function("call_indirect"sv, binary, {}, Code {}.i32(10).get(1).get(0).op(call_indirect).u(binary).u(0));
+    builder.add_function("counter"sv, nullary, {}, Code {}.op(global_get).u(0).i32(1).op(i32_add).op(global_set).u(0).op(global_get).u(0));
+    builder.add_function("grow"sv, unary, {}, Code {}.get(0).op(memory_grow).byte(0).op(drop).op(memory_size).byte(0));
+    builder.add_function("copy"sv, unary, {}, Code {}.i32(0).i32(0x01020304).memory(i32_store).get(0).i32(0).i32(4).op(memory_copy).byte(0).byte(0).get(0).memory(i32_load));
+
+    Instance instance { builder };
+
+    EXPECT_EQ(instance.run("call_indirect"sv, { Wasm::Value(0), Wasm::Value(3) }), 13u);
+    EXPECT_EQ(instance.run("call_indirect"sv, { Wasm::Value(1), Wasm::Value(3) }), 7u);
+    EXPECT_EQ(instance.run("call_indirect"sv, { Wasm::Value(3), Wasm::Value(3) }), Optional<u64> {});
+
+    // The stack-based interpreter doesn't check the signature of indirect callees.
+    Wasm::BytecodeInterpreter interpreter;
+    EXPECT(instance.invoke(interpreter, "call_indirect"sv, { Wasm::Value(2), Wasm::Value(3) }).is_trap());
+
+    EXPECT_EQ(instance.run("copy"sv, { Wasm::Value(2) }), 0x01020304u);
+
+    // These modify the instance, so each interpreter gets its own.
+    auto check_stateful_functions = [&](Wasm::Interpreter& interpreter) {
+        Instance instance { builder };
+        EXPECT_EQ(instance.invoke(interpreter, "counter"sv, {}).values().first().to<i32>(), 6);
+        EXPECT_EQ(instance.invoke(interpreter, "counter"sv, {}).values().first().to<i32>(), 7);
+        EXPECT_EQ(instance.invoke(interpreter, "grow"sv, { Wasm::Value(1) }).values().first().to<i32>(), 2);
+        EXPECT_EQ(instance.invoke(interpreter, "grow"sv, { Wasm::Value(0) }).values().first().to<i32>(), 2);
+    };
+    Wasm::BytecodeInterpreter precompiled_interpreter;
+    StackBasedInterpreter stack_based_interpreter;
+    check_stateful_functions(precompiled_interpreter);
+    check_stateful_functions(stack_based_interpreter);
+
+    // The stack-based interpreter doesn't treat the page count as unsigned.
+    EXPECT_EQ(instance.invoke(precompiled_interpreter, "grow"sv, { Wasm::Value(-1) }).values().first().to<i32>(), 1);
+}
+
+// Host functions may allocate in the store, which can move every memory instance in it.
+static void check_host_calls_that_allocate_in_the_store(Wasm::MemoryInstance::Backing memory_backing)
+{
+    ModuleBuilder builder;
+    auto no_results = builder.add_type({}, {});
+    auto unary = builder.add_type({ i32_type }, { i32_type });
+    auto allocate = builder.add_function_import("allocate_memories"sv, no_results);
+    builder.set_memory(1);
+    builder.add_function("store_call_load"sv, unary, {}, Code {}.i32(8).get(0).memory(i32_store).op(call).u(allocate).i32(8).memory(i32_load).op(memory_size).byte(0).op(i32_add));
+    builder.add_function("call_load"sv, unary, {}, Code {}.op(call).u(allocate).get(0).memory(i32_load));
+    builder.add_function("call_grow"sv, unary, {}, Code {}.op(call).u(allocate).get(0).op(memory_grow).byte(0));
+
+    auto create_instance = [&] {
+        Vector<Wasm::HostFunction> host_functions;
+        host_functions.empend(
+            [](Wasm::Configuration& configuration, Vector<Wasm::Value>&) {
+                for (size_t i = 0; i < 32; ++i)
+                    VERIFY(configuration.store().allocate(Wasm::MemoryType { Wasm::Limits { 0 } }).has_value());
+                return Wasm::Result { Vector<Wasm::Value> {} };
+            },
+            Wasm::FunctionType { {}, {} });
+        return make<Instance>(builder, memory_backing, move(host_functions));
+    };
+
+    auto instance = create_instance();
+    EXPECT(instance->is_precompiled("store_call_load"sv));
+    EXPECT_EQ(instance->run("store_call_load"sv, { Wasm::Value(1234) }), 1235u);
+    EXPECT_EQ(instance->run("call_load"sv, { Wasm::Value(65532) }), 0u);
+    EXPECT_EQ(instance->run("call_load"sv, { Wasm::Value(65533) }), Optional<u64> {});
+
+    // This modifies the instance, so each interpreter gets its own.
+    auto check_growing = [&](Wasm::Interpreter& interpreter) {
+        auto instance = create_instance();
+        EXPECT_EQ(instance->invoke(interpreter, "call_grow"sv, { Wasm::Value(1) }).values().first().to<i32>(), 1);
+        EXPECT_EQ(instance->memory().size(), 2u * Wasm::Constants::page_size);
+    };
+    Wasm::BytecodeInterpreter precompiled_interpreter;
+    StackBasedInterpreter stack_based_interpreter;
+    check_growing(precompiled_interpreter);
+    check_growing(stack_based_interpreter);
+}
+
+TEST_CASE(host_calls_that_allocate_in_the_store)
+{
+    check_host_calls_that_allocate_in_the_store(Wasm::MemoryInstance::Backing::ByteBuffer);
+    if (Wasm::GuardedMemory::is_supported())
+        check_host_calls_that_allocate_in_the_store(Wasm::MemoryInstance::Backing::GuardPages);
+}
+
+TEST_CASE(guard_page_backed_memory)
+{
+    if (!Wasm::GuardedMemory::is_supported())
+        return;
+
+    ModuleBuilder builder;
+    builder.set_memory(1);
+    auto unary = builder.add_type({ i32_type }, { i32_type });
+    auto nullary = builder.add_type({}, { i32_type });
+    builder.add_function("load"sv, unary, {}, Code {}.get(0).memory(i32_load, 4));
+    builder.add_function("load_with_large_offset"sv, unary, {}, Code {}.get(0).memory(i64_load, NumericLimits<u32>::max()).op(i32_wrap_i64));
+    builder.add_function("store"sv, unary, {}, Code {}.get(0).get(0).memory(i32_store).get(0).memory(i32_load));
+    builder.add_function("grow"sv, unary, {}, Code {}.get(0).op(memory_grow).byte(0));
+    // Traps in a nested call have to unwind to the right caller.
+    auto load = builder.add_function("load_in_callee"sv, unary, {}, Code {}.get(0).memory(i32_load));
+    builder.add_function("load_through_call"sv, unary, {}, Code {}.i32(1).get(0).op(call).u(load).op(i32_add));
+    builder.add_function("size"sv, nullary, {}, Code {}.op(memory_size).byte(0));
+    add_sieve(builder);
+    add_matrix_multiply(builder);
+    Instance instance { builder, Wasm::MemoryInstance::Backing::GuardPages };
+
+    EXPECT_NE(instance.memory().guarded_memory(), nullptr);
+    EXPECT(instance.is_precompiled("load"sv));
+
+    EXPECT_EQ(instance.run("load"sv, { Wasm::Value(65528) }), 0u);
+    EXPECT_EQ(instance.run("load"sv, { Wasm::Value(65529) }), Optional<u64> {});
+    EXPECT_EQ(instance.run("load"sv, { Wasm::Value(-1) }), Optional<u64> {});
+    EXPECT_EQ(instance.run("load_with_large_offset"sv, { Wasm::Value(-1) }), Optional<u64> {});
+    EXPECT_EQ(instance.run("load_with_large_offset"sv, { Wasm::Value(0) }), Optional<u64> {});
+    EXPECT_EQ(instance.run("store"sv, { Wasm::Value(65532) }), 65532u);
+    EXPECT_EQ(instance.run("store"sv, { Wasm::Value(65533) }), Optional<u64> {});
+    EXPECT_EQ(instance.run("load_through_call"sv, { Wasm::Value(65536) }), Optional<u64> {});
+    EXPECT_EQ(instance.run("load_through_call"sv, { Wasm::Value(65532) }), 65533u);
+    EXPECT_EQ(instance.run("sieve"sv, { Wasm::Value(10000) }), 1229u);
+    EXPECT_EQ(instance.run("matrix_multiply"sv, { Wasm::Value(10) }), bit_cast<u64>(8250.0));
+
+    // Growing makes the new pages accessible without moving the existing ones.
+    auto* data = instance.memory().bytes().data();
+    Wasm::BytecodeInterpreter interpreter;
+    EXPECT_EQ(instance.invoke(interpreter, "grow"sv, { Wasm::Value(2) }).values().first().to<i32>(), 1);
+    EXPECT_EQ(instance.memory().bytes().data(), data);
+    EXPECT_EQ(instance.run("size"sv), 3u);
+    EXPECT_EQ(instance.run("store"sv, { Wasm::Value(3 * 65536 - 4) }), 3u * 65536 - 4);
+    EXPECT_EQ(instance.run("store"sv, { Wasm::Value(3 * 65536 - 3) }), Optional<u64> {});
+}
+
+template<typename InterpreterType>
+static void run_benchmark(StringView name, Vector<Wasm::Value> arguments, Wasm::MemoryInstance::Backing memory_backing = Wasm::MemoryInstance::Backing::ByteBuffer)
+{
+    ModuleBuilder builder;
+    builder.set_memory(16);
+    add_fibonacci(builder);
+    add_loop_sum(builder);
+    add_sieve(builder);
+    add_matrix_multiply(builder);
+    Instance instance { builder, memory_backing };
+
+    InterpreterType interpreter;
+    auto result = instance.invoke(interpreter, name, move(arguments));
+    EXPECT(!result.is_trap());
+}
+
+BENCHMARK_CASE(fibonacci)
+{
+    run_benchmark<Wasm::BytecodeInterpreter>("fibonacci"sv, { Wasm::Value(27) });
+}
+
+BENCHMARK_CASE(fibonacci_stack_based)
+{
+    run_benchmark<StackBasedInterpreter>("fibonacci"sv, { Wasm::Value(27) });
+}
+
+BENCHMARK_CASE(loop_sum)
+{
+    run_benchmark<Wasm::BytecodeInterpreter>("loop_sum"sv, { Wasm::Value(5000000) });
+}
+
+BENCHMARK_CASE(loop_sum_stack_based)
+{
+    run_benchmark<StackBasedInterpreter>("loop_sum"sv, { Wasm::Value(5000000) });
+}
+
+BENCHMARK_CASE(sieve)
+{
+    run_benchmark<Wasm::BytecodeInterpreter>("sieve"sv, { Wasm::Value(1000000) });
+}
+
+BENCHMARK_CASE(sieve_stack_based)
+{
+    run_benchmark<StackBasedInterpreter>("sieve"sv, { Wasm::Value(1000000) });
+}
+
+BENCHMARK_CASE(sieve_guard_pages)
+{
+    run_benchmark<Wasm::BytecodeInterpreter>("sieve"sv, { Wasm::Value(1000000) }, Wasm::MemoryInstance::Backing::GuardPages);
+}
+
+BENCHMARK_CASE(matrix_multiply)
+{
+    run_benchmark<Wasm::BytecodeInterpreter>("matrix_multiply"sv, { Wasm::Value(100) });
+}
+
+BENCHMARK_CASE(matrix_multiply_stack_based)
+{
+    run_benchmark<StackBasedInterpreter>("matrix_multiply"sv, { Wasm::Value(100) });
+}
+
+BENCHMARK_CASE(matrix_multiply_guard_pages)
+{
+    run_benchmark<Wasm::BytecodeInterpreter>("matrix_multiply"sv, { Wasm::Value(100) }, Wasm::MemoryInstance::Backing::GuardPages);
+}
@@ -0,0 +1,58 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include "TestPage.h"
+#include <AK/StringBuilder.h>
+#include <LibTest/TestCase.h>
+#include <LibWeb/DOM/Text.h>
+#include <LibWeb/HTML/HTMLBodyElement.h>
+
+// A page with a lot of independent paragraphs and a few boxes that establish their own formatting context.
+static DeprecatedString make_document_html(size_t paragraph_count)
+{
+    StringBuilder builder;
+    builder.append("<!DOCTYPE html><html><body>"sv);
+    for (size_t i = 0; i < paragraph_count; ++i) {
+        if (i % 10 == 0)
+            builder.appendff("<div style=\"display: flow-root\"><p>Section {}</p><p>Some text in a box of its own.</p></div>", i);
+        builder.appendff("<p>Paragraph {} with <b>some</b> <i>inline</i> content that is long enough to wrap across more than one line "
+                         "when it is laid out in a viewport that is eight hundred pixels wide.</p>",
+            i);
+    }
+    builder.append("</body></html>"sv);
+    return builder.to_deprecated_string();
+}
+
+static Vector<Web::DOM::Text*> text_nodes_in(Web::DOM::Document& document)
+{
+    Vector<Web::DOM::Text*> text_nodes;
+    document.body()->for_each_in_subtree_of_type<Web::DOM::Text>([&](auto& text) {
+        if (text.layout_node())
+            text_nodes.append(&text);
+        return IterationDecision::Continue;
+    });
+    return text_nodes;
+}
+
+BENCHMARK_CASE(relayout_after_text_change)
+{
+    auto& document = load_document(make_document_html(2000));
+    auto text_nodes = text_nodes_in(document);
+
+    for (size_t i = 0; i < 200; ++i) {
+        auto& text = *text_nodes[(i * 7919) % text_nodes.size()];
+        text.set_data(DeprecatedString::formatted("Changed text number {}", i));
+        document.update_layout();
+    }
+}
+
+BENCHMARK_CASE(full_layout)
+{
+    auto& document = load_document(make_document_html(2000));
+
+    for (size_t i = 0; i < 20; ++i)
+        document.force_layout();
+}
@@ -0,0 +1,151 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibGfx/Bitmap.h>
+#include <LibGfx/Painter.h>
+#include <LibTest/TestCase.h>
+#include <LibWeb/Painting/RecordingPainter.h>
+
+using Web::Painting::DisplayList;
+using Web::Painting::RecordingPainter;
+
+static Gfx::IntRect const viewport_rect { 0, 0, 100, 100 };
+
+static void record_boxes(DisplayList& display_list, Color second_box_color)
+{
+    RecordingPainter painter(display_list, viewport_rect);
+    painter.fill_rect(viewport_rect, Color::White);
+    painter.translate(10, 10);
+    painter.fill_rect({ 0, 0, 20, 20 }, Color::Red);
+    painter.add_clip_rect({ 40, 40, 10, 10 });
+    painter.fill_rect({ 40, 40, 20, 20 }, second_box_color);
+}
+
+static NonnullRefPtr<Gfx::Bitmap> create_bitmap()
+{
+    return MUST(Gfx::Bitmap::create(Gfx::BitmapFormat::BGRA8888, viewport_rect.size()));
+}
+
+TEST_CASE(replay_applies_translation_and_clip)
+{
+    DisplayList display_list;
+    record_boxes(display_list, Color::Blue);
+
+    auto bitmap = create_bitmap();
+    Gfx::Painter painter(bitmap);
+    display_list.execute(painter);
+
+    EXPECT_EQ(bitmap->get_pixel(5, 5), Color(Color::White));
+    EXPECT_EQ(bitmap->get_pixel(15, 15), Color(Color::Red));
+    EXPECT_EQ(bitmap->get_pixel(55, 55), Color(Color::Blue));
+    EXPECT_EQ(bitmap->get_pixel(65, 65), Color(Color::White));
+}
+
+TEST_CASE(damage_covers_only_changed_commands)
+{
+    DisplayList first;
+    record_boxes(first, Color::Blue);
+
+    DisplayList same;
+    record_boxes(same, Color::Blue);
+    EXPECT(same.compute_damage(first, viewport_rect).is_empty());
+
+    DisplayList changed;
+    record_boxes(changed, Color::Green);
+    EXPECT_EQ(changed.compute_damage(first, viewport_rect), Gfx::IntRect(50, 50, 10, 10));
+}
+
+TEST_CASE(damaged_replay_matches_full_replay)
+{
+    DisplayList first;
+    record_boxes(first, Color::Blue);
+    DisplayList second;
+    record_boxes(second, Color::Green);
+
+    auto incremental_bitmap = create_bitmap();
+    Gfx::Painter incremental_painter(incremental_bitmap);
+    first.execute(incremental_painter);
+    second.execute(incremental_painter, second.compute_damage(first, viewport_rect));
+
+    auto full_bitmap = create_bitmap();
+    Gfx::Painter full_painter(full_bitmap);
+    second.execute(full_painter);
+
+    for (int y = 0; y < viewport_rect.height(); ++y) {
+        for (int x = 0; x < viewport_rect.width(); ++x)
+            EXPECT_EQ(incremental_bitmap->get_pixel(x, y), full_bitmap->get_pixel(x, y));
+    }
+}
+
+TEST_CASE(paint_functions_damage_their_bounding_rect)
+{
+    auto record = [](DisplayList& display_list) {
+        RecordingPainter painter(display_list, viewport_rect);
+        painter.fill_rect(viewport_rect, Color::White);
+        painter.translate(5, 5);
+        painter.paint_with(Gfx::IntRect { 0, 0, 10, 10 }, [](Gfx::Painter& painter) {
+            painter.fill_rect({ 0, 0, 10, 10 }, Color::Black);
+        });
+        painter.sample_with({}, [](Gfx::Painter&) {});
+    };
+
+    DisplayList first;
+    record(first);
+    DisplayList second;
+    record(second);
+    EXPECT_EQ(second.compute_damage(first, viewport_rect), Gfx::IntRect(5, 5, 10, 10));
+
+    auto bitmap = create_bitmap();
+    Gfx::Painter painter(bitmap);
+    second.execute(painter);
+    EXPECT_EQ(bitmap->get_pixel(4, 4), Color(Color::White));
+    EXPECT_EQ(bitmap->get_pixel(14, 14), Color(Color::Black));
+    EXPECT_EQ(bitmap->get_pixel(15, 15), Color(Color::White));
+}
+
+TEST_CASE(inserted_commands_only_damage_their_own_area)
+{
+    DisplayList first;
+    record_boxes(first, Color::Blue);
+
+    DisplayList second;
+    {
+        RecordingPainter painter(second, viewport_rect);
+        painter.fill_rect(viewport_rect, Color::White);
+        painter.fill_rect({ 70, 5, 10, 10 }, Color::Black);
+        painter.translate(10, 10);
+        painter.fill_rect({ 0, 0, 20, 20 }, Color::Red);
+        painter.add_clip_rect({ 40, 40, 10, 10 });
+        painter.fill_rect({ 40, 40, 20, 20 }, Color::Blue);
+    }
+    EXPECT_EQ(second.compute_damage(first, viewport_rect), Gfx::IntRect(70, 5, 10, 10));
+    EXPECT_EQ(first.compute_damage(second, viewport_rect), Gfx::IntRect(70, 5, 10, 10));
+}
+
+TEST_CASE(replaying_in_tiles_matches_full_replay)
+{
+    DisplayList display_list;
+    record_boxes(display_list, Color::Blue);
+
+    auto full_bitmap = create_bitmap();
+    Gfx::Painter full_painter(full_bitmap);
+    display_list.execute(full_painter);
+
+    static constexpr int tile_size = 32;
+    for (int tile_y = 0; tile_y < viewport_rect.height(); tile_y += tile_size) {
+        for (int tile_x = 0; tile_x < viewport_rect.width(); tile_x += tile_size) {
+            auto tile = MUST(Gfx::Bitmap::create(Gfx::BitmapFormat::BGRA8888, { tile_size, tile_size }));
+            Gfx::Painter tile_painter(tile);
+            tile_painter.translate(-tile_x, -tile_y);
+            display_list.execute(tile_painter, Gfx::IntRect { tile_x, tile_y, tile_size, tile_size });
+
+            for (int y = 0; y < tile_size && tile_y + y < viewport_rect.height(); ++y) {
+                for (int x = 0; x < tile_size && tile_x + x < viewport_rect.width(); ++x)
+                    EXPECT_EQ(tile->get_pixel(x, y), full_bitmap->get_pixel(tile_x + x, tile_y + y));
+            }
+        }
+    }
+}
@@ -76,6 +76,28 @@ static Vector<Token> run_tokenizer(StringView input)
     return tokens;
 }
 
+static Vector<Token> run_tokenizer_on_chunks(StringView input, size_t chunk_size)
+{
+    Vector<Token> tokens;
+    Tokenizer tokenizer;
+    tokenizer.open_input_stream();
+    auto take_tokens = [&] {
+        while (true) {
+            auto maybe_token = tokenizer.next_token();
+            if (!maybe_token.has_value())
+                break;
+            tokens.append(maybe_token.release_value());
+        }
+    };
+    for (size_t offset = 0; offset < input.length(); offset += chunk_size) {
+        tokenizer.append_to_input_stream(input.substring_view(offset, min(chunk_size, input.length() - offset)));
+        take_tokens();
+    }
+    tokenizer.close_input_stream();
+    take_tokens();
+    return tokens;
+}
+
 // FIXME: It's not very nice to rely on the format of HTMLToken::to_string() to stay the same.
 static u32 hash_tokens(Vector<Token> const& tokens)
 {
@@ -197,9 +219,15 @@ TEST_CASE(doctype)
     EXPECT_END_TAG_TOKEN(html);
 }
 
-// NOTE: This relies on the format of HTMLToken::to_string() staying the same.
-//       If that changes, or something is added to the test HTML, the hash needs to be adjusted.
-TEST_CASE(regression)
+TEST_CASE(input_arriving_in_chunks)
+{
+    auto input = "<!DOCTYPE html PUBLIC \"-//W3C//DTD HTML 4.01//EN\">\r\n<p class=\"a&amp;b\" id=x>Fish &amp chips &notin; &CounterClockwiseContourIntegral;</p>\r\n<!-- x --><![CDATA[y]]>&#x41;\r"sv;
+    auto expected_hash = hash_tokens(run_tokenizer(input));
+    for (size_t chunk_size = 1; chunk_size <= input.length(); ++chunk_size)
+        EXPECT_EQ(hash_tokens(run_tokenizer_on_chunks(input, chunk_size)), expected_hash);
+}
+
+static DeprecatedString read_test_html()
 {
     // This makes sure that the tests will run both on target and in Lagom.
 #ifdef AK_OS_SERENITY
@@ -212,8 +240,21 @@ TEST_CASE(regression)
     auto file_size = MUST(file->size());
     auto content = MUST(ByteBuffer::create_uninitialized(file_size));
     MUST(file->read_until_filled(content.bytes()));
-    DeprecatedString file_contents { content.bytes() };
-    auto tokens = run_tokenizer(file_contents);
+    return DeprecatedString { content.bytes() };
+}
+
+// NOTE: This relies on the format of HTMLToken::to_string() staying the same.
+//       If that changes, or something is added to the test HTML, the hash needs to be adjusted.
+TEST_CASE(regression)
+{
+    auto tokens = run_tokenizer(read_test_html());
     u32 hash = hash_tokens(tokens);
     EXPECT_EQ(hash, 710375345u);
 }
+
+TEST_CASE(regression_input_arriving_in_small_chunks)
+{
+    // The input outgrows its buffer a few times while the tokenizer is in the middle of it.
+    auto tokens = run_tokenizer_on_chunks(read_test_html(), 7);
+    EXPECT_EQ(hash_tokens(tokens), 710375345u);
+}
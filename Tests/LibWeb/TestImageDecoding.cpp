@@ -0,0 +1,112 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibCore/EventLoop.h>
+#include <LibGfx/Bitmap.h>
+#include <LibGfx/ImageFormats/ImageDecoder.h>
+#include <LibGfx/ImageFormats/PNGWriter.h>
+#include <LibTest/TestCase.h>
+#include <LibWeb/Platform/EventLoopPluginSerenity.h>
+#include <LibWeb/Platform/ImageCodecPlugin.h>
+#include <pthread.h>
+
+// Decodes with LibGfx in-process, like Ladybird does, and leaves decode_image_async() to the default implementation.
+class TestImageCodecPlugin final : public Web::Platform::ImageCodecPlugin {
+public:
+    virtual Optional<Web::Platform::DecodedImage> decode_image(ReadonlyBytes data) override
+    {
+        auto decoder = Gfx::ImageDecoder::try_create_for_raw_bytes(data);
+        if (!decoder || !decoder->frame_count())
+            return {};
+
+        Web::Platform::DecodedImage decoded_image;
+        decoded_image.is_animated = decoder->is_animated();
+        decoded_image.loop_count = decoder->loop_count();
+        for (size_t i = 0; i < decoder->frame_count(); ++i) {
+            auto frame_or_error = decoder->frame(i);
+            if (frame_or_error.is_error())
+                return {};
+            auto frame = frame_or_error.release_value();
+            decoded_image.frames.append({ move(frame.image), static_cast<size_t>(frame.duration) });
+        }
+        return decoded_image;
+    }
+};
+
+static void install_plugins()
+{
+    static bool installed = false;
+    if (installed)
+        return;
+    Web::Platform::EventLoopPlugin::install(*new Web::Platform::EventLoopPluginSerenity);
+    Web::Platform::ImageCodecPlugin::install(*new TestImageCodecPlugin);
+    installed = true;
+}
+
+struct DecodeResult {
+    Optional<Web::Platform::DecodedImage> image;
+    pthread_t thread;
+};
+
+// Starts an asynchronous decode and runs the event loop until its callback has been invoked.
+static Optional<DecodeResult> decode_and_wait(Core::EventLoop& event_loop, ReadonlyBytes data)
+{
+    Optional<DecodeResult> result;
+    Web::Platform::ImageCodecPlugin::the().decode_image_async(data, [&](Optional<Web::Platform::DecodedImage> image) {
+        result = DecodeResult { move(image), pthread_self() };
+    });
+
+    // The callback must not run before the caller had a chance to return to the event loop.
+    EXPECT(!result.has_value());
+
+    for (size_t i = 0; i < 100 && !result.has_value(); ++i)
+        event_loop.pump(Core::EventLoop::WaitMode::PollForEvents);
+    return result;
+}
+
+TEST_CASE(async_decode_calls_back_on_the_event_loop)
+{
+    Core::EventLoop event_loop;
+    install_plugins();
+
+    auto bitmap = TRY_OR_FAIL(Gfx::Bitmap::create(Gfx::BitmapFormat::BGRA8888, { 3, 2 }));
+    bitmap->fill(Color::Black);
+    bitmap->set_pixel(2, 1, Color::Red);
+    auto png = TRY_OR_FAIL(Gfx::PNGWriter::encode(*bitmap));
+
+    auto result = decode_and_wait(event_loop, png);
+    EXPECT(result.has_value());
+    if (!result.has_value())
+        return;
+
+    EXPECT(pthread_equal(result->thread, pthread_self()));
+    EXPECT(result->image.has_value());
+    if (!result->image.has_value())
+        return;
+
+    auto& image = result->image.value();
+    EXPECT(!image.is_animated);
+    EXPECT_EQ(image.frames.size(), 1u);
+    auto& decoded_bitmap = *image.frames[0].bitmap;
+    EXPECT_EQ(decoded_bitmap.size(), Gfx::IntSize(3, 2));
+    EXPECT_EQ(decoded_bitmap.get_pixel(0, 0), Color(Color::Black));
+    EXPECT_EQ(decoded_bitmap.get_pixel(2, 1), Color(Color::Red));
+}
+
+TEST_CASE(async_decode_reports_failure_on_the_event_loop)
+{
+    Core::EventLoop event_loop;
+    install_plugins();
+
+    auto garbage = "This is not an image."sv;
+    auto result = decode_and_wait(event_loop, garbage.bytes());
+    EXPECT(result.has_value());
+    if (!result.has_value())
+        return;
+
+    EXPECT(pthread_equal(result->thread, pthread_self()));
+    EXPECT(!result->image.has_value());
+}
@@ -0,0 +1,73 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include "TestPage.h"
+#include <AK/StringBuilder.h>
+#include <LibTest/TestCase.h>
+#include <LibWeb/DOM/Text.h>
+#include <LibWeb/HTML/HTMLBodyElement.h>
+#include <LibWeb/Layout/Viewport.h>
+#include <LibWeb/Painting/PaintableBox.h>
+
+// Paragraphs that wrap across several lines, with a few boxes that establish their own formatting context.
+static DeprecatedString make_document_html(size_t paragraph_count)
+{
+    StringBuilder builder;
+    builder.append("<!DOCTYPE html><html><body>"sv);
+    for (size_t i = 0; i < paragraph_count; ++i) {
+        if (i % 10 == 0)
+            builder.appendff("<div style=\"display: flow-root\"><p>Section {}</p><p>Some text in a box of its own.</p></div>", i);
+        builder.appendff("<p>Paragraph {} with <b>some</b> <i>inline</i> content that is long enough to wrap across more than one line "
+                         "when it is laid out in a viewport that is eight hundred pixels wide.</p>",
+            i);
+    }
+    builder.append("</body></html>"sv);
+    return builder.to_deprecated_string();
+}
+
+static Vector<Web::DOM::Text*> text_nodes_in(Web::DOM::Document& document)
+{
+    Vector<Web::DOM::Text*> text_nodes;
+    document.body()->for_each_in_subtree_of_type<Web::DOM::Text>([&](auto& text) {
+        if (text.layout_node())
+            text_nodes.append(&text);
+        return IterationDecision::Continue;
+    });
+    return text_nodes;
+}
+
+static Vector<Web::CSSPixelRect> box_rects_in(Web::DOM::Document& document)
+{
+    Vector<Web::CSSPixelRect> rects;
+    document.layout_node()->for_each_in_inclusive_subtree_of_type<Web::Layout::Box>([&](auto& box) {
+        rects.append(box.paint_box()->absolute_border_box_rect());
+        return IterationDecision::Continue;
+    });
+    return rects;
+}
+
+TEST_CASE(relayout_after_text_change_matches_full_layout)
+{
+    auto& document = load_document(make_document_html(50));
+    auto text_nodes = text_nodes_in(document);
+    EXPECT(text_nodes.size() > 20);
+    if (text_nodes.size() <= 20)
+        return;
+
+    // Change text in a few places, so that some paragraphs grow by a line and others shrink.
+    text_nodes[3]->set_data(DeprecatedString::repeated("grow "sv, 200));
+    text_nodes[7]->set_data("shrink");
+    text_nodes[text_nodes.size() / 2]->set_data(DeprecatedString::repeated("more "sv, 100));
+    document.update_layout();
+    auto incremental_rects = box_rects_in(document);
+
+    document.force_layout();
+    auto full_rects = box_rects_in(document);
+
+    EXPECT_EQ(incremental_rects.size(), full_rects.size());
+    for (size_t i = 0; i < min(incremental_rects.size(), full_rects.size()); ++i)
+        EXPECT_EQ(incremental_rects[i], full_rects[i]);
+}
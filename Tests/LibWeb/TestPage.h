@@ -0,0 +1,69 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <LibCore/AnonymousBuffer.h>
+#include <LibCore/EventLoop.h>
+#include <LibGfx/Font/FontDatabase.h>
+#include <LibGfx/Palette.h>
+#include <LibGfx/SystemTheme.h>
+#include <LibWeb/Bindings/MainThreadVM.h>
+#include <LibWeb/DOM/Document.h>
+#include <LibWeb/HTML/BrowsingContext.h>
+#include <LibWeb/Loader/FrameLoader.h>
+#include <LibWeb/Page/Page.h>
+#include <LibWeb/Platform/EventLoopPluginSerenity.h>
+#include <LibWeb/Platform/FontPluginSerenity.h>
+
+// A page without a window, for tests that need a laid out document.
+class TestPageClient final : public Web::PageClient {
+public:
+    TestPageClient()
+        : m_page(make<Web::Page>(*this))
+    {
+        auto buffer = MUST(Core::AnonymousBuffer::create_with_size(sizeof(Gfx::SystemTheme)));
+        m_palette_impl = Gfx::PaletteImpl::create_with_anonymous_buffer(buffer);
+    }
+
+    virtual Web::Page& page() override { return *m_page; }
+    virtual Web::Page const& page() const override { return *m_page; }
+    virtual bool is_connection_open() const override { return true; }
+    virtual Gfx::Palette palette() const override { return Gfx::Palette(*m_palette_impl); }
+    virtual Web::DevicePixelRect screen_rect() const override { return { 0, 0, 800, 600 }; }
+    virtual float device_pixels_per_css_pixel() const override { return 1.0f; }
+    virtual Web::CSS::PreferredColorScheme preferred_color_scheme() const override { return Web::CSS::PreferredColorScheme::Auto; }
+    virtual void paint(Web::DevicePixelRect const&, Gfx::Bitmap&) override { }
+    virtual void request_file(Web::FileRequest) override { }
+
+private:
+    NonnullOwnPtr<Web::Page> m_page;
+    RefPtr<Gfx::PaletteImpl> m_palette_impl;
+};
+
+// Loads the given HTML into an 800x600 viewport and lays it out. Every call replaces the previous document.
+inline Web::DOM::Document& load_document(StringView html)
+{
+    static Core::EventLoop event_loop;
+    static OwnPtr<TestPageClient> page_client;
+    if (!page_client) {
+#ifndef AK_OS_SERENITY
+        Gfx::FontDatabase::set_default_fonts_lookup_path("../../Base/res/fonts");
+        Web::FrameLoader::set_default_favicon_path("../../Base/res/icons/16x16/app-browser.png");
+#endif
+        Web::Platform::EventLoopPlugin::install(*new Web::Platform::EventLoopPluginSerenity);
+        Web::Platform::FontPlugin::install(*new Web::Platform::FontPluginSerenity);
+        MUST(Web::Bindings::initialize_main_thread_vm());
+        page_client = make<TestPageClient>();
+        page_client->page().top_level_browsing_context().set_viewport_rect({ 0, 0, 800, 600 });
+    }
+
+    auto& page = page_client->page();
+    page.load_html(html, AK::URL("about:blank"));
+    auto& document = *page.top_level_browsing_context().active_document();
+    document.update_layout();
+    return document;
+}
@@ -0,0 +1,204 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include "TestPage.h"
+#include <LibTest/TestCase.h>
+#include <LibWeb/CSS/StyleComputer.h>
+#include <LibWeb/HTML/HTMLInputElement.h>
+#include <LibWeb/Layout/Node.h>
+
+// The siblings in these tests are found through their parent, since giving them an id would make their attributes differ.
+static Vector<Web::DOM::Element*> children_of(Web::DOM::Document& document, StringView parent_id)
+{
+    auto parent = document.get_element_by_id(parent_id);
+    VERIFY(parent);
+    Vector<Web::DOM::Element*> children;
+    for (auto* child = parent->first_element_child().ptr(); child; child = child->next_element_sibling())
+        children.append(child);
+    return children;
+}
+
+static Gfx::Color color_of(Web::DOM::Element const& element)
+{
+    VERIFY(element.layout_node());
+    return element.layout_node()->computed_values().color();
+}
+
+static bool share_style(Web::DOM::Element const& a, Web::DOM::Element const& b)
+{
+    return a.computed_css_values() && a.computed_css_values() == b.computed_css_values();
+}
+
+TEST_CASE(identical_siblings_share_their_style)
+{
+    auto& document = load_document(R"html(
+        <style>.note { color: rgb(0, 128, 0); }</style>
+        <div id="parent">
+            <p class="note">First</p>
+            <p class="note">Second</p>
+            <p class="note">Third</p>
+        </div>)html"sv);
+    auto children = children_of(document, "parent"sv);
+    EXPECT_EQ(children.size(), 3u);
+    if (children.size() != 3)
+        return;
+
+    EXPECT(share_style(*children[0], *children[1]));
+    EXPECT(share_style(*children[0], *children[2]));
+    EXPECT_EQ(color_of(*children[2]), Gfx::Color(0, 128, 0));
+
+    document.invalidate_style();
+    document.update_style();
+    EXPECT(share_style(*children[0], *children[1]));
+    EXPECT(share_style(*children[0], *children[2]));
+    EXPECT(document.style_computer().statistics().styles_shared >= 2);
+}
+
+TEST_CASE(siblings_with_different_attributes_do_not_share_their_style)
+{
+    auto& document = load_document(R"html(
+        <style>.note { color: rgb(0, 128, 0); }</style>
+        <div id="parent">
+            <p class="note">First</p>
+            <p>Second</p>
+        </div>)html"sv);
+    auto children = children_of(document, "parent"sv);
+    EXPECT_EQ(children.size(), 2u);
+    if (children.size() != 2)
+        return;
+
+    EXPECT(!share_style(*children[0], *children[1]));
+    EXPECT_EQ(color_of(*children[0]), Gfx::Color(0, 128, 0));
+    EXPECT_NE(color_of(*children[1]), Gfx::Color(0, 128, 0));
+}
+
+TEST_CASE(hovered_siblings_do_not_share_their_style)
+{
+    auto& document = load_document(R"html(
+        <style>p:hover { color: rgb(255, 0, 0); }</style>
+        <div id="parent">
+            <p>First</p>
+            <p>Second</p>
+            <p>Third</p>
+        </div>)html"sv);
+    auto children = children_of(document, "parent"sv);
+    EXPECT_EQ(children.size(), 3u);
+    if (children.size() != 3)
+        return;
+    EXPECT(share_style(*children[0], *children[1]));
+
+    // A hovered candidate must not hand its style to the next sibling, and a hovered element must not take the style
+    // of the sibling before it.
+    document.set_hovered_node(children[0]);
+    document.update_layout();
+    EXPECT(!share_style(*children[0], *children[1]));
+    EXPECT_EQ(color_of(*children[0]), Gfx::Color(255, 0, 0));
+    EXPECT_NE(color_of(*children[1]), Gfx::Color(255, 0, 0));
+
+    document.set_hovered_node(children[2]);
+    document.update_layout();
+    EXPECT(!share_style(*children[1], *children[2]));
+    EXPECT_NE(color_of(*children[1]), Gfx::Color(255, 0, 0));
+    EXPECT_EQ(color_of(*children[2]), Gfx::Color(255, 0, 0));
+
+    document.set_hovered_node(nullptr);
+}
+
+TEST_CASE(siblings_matched_by_structural_pseudo_classes_do_not_share_their_style)
+{
+    auto& document = load_document(R"html(
+        <style>
+            p:first-child { color: rgb(255, 0, 0); }
+            span:nth-child(2) { color: rgb(0, 0, 255); }
+        </style>
+        <div id="paragraphs">
+            <p>First</p>
+            <p>Second</p>
+        </div>
+        <div id="spans">
+            <span>First</span>
+            <span>Second</span>
+            <span>Third</span>
+        </div>)html"sv);
+    auto paragraphs = children_of(document, "paragraphs"sv);
+    auto spans = children_of(document, "spans"sv);
+    EXPECT_EQ(paragraphs.size(), 2u);
+    EXPECT_EQ(spans.size(), 3u);
+    if (paragraphs.size() != 2 || spans.size() != 3)
+        return;
+
+    EXPECT(!share_style(*paragraphs[0], *paragraphs[1]));
+    EXPECT_EQ(color_of(*paragraphs[0]), Gfx::Color(255, 0, 0));
+    EXPECT_NE(color_of(*paragraphs[1]), Gfx::Color(255, 0, 0));
+
+    EXPECT(!share_style(*spans[0], *spans[1]));
+    EXPECT(!share_style(*spans[1], *spans[2]));
+    EXPECT_NE(color_of(*spans[0]), Gfx::Color(0, 0, 255));
+    EXPECT_EQ(color_of(*spans[1]), Gfx::Color(0, 0, 255));
+    EXPECT_NE(color_of(*spans[2]), Gfx::Color(0, 0, 255));
+}
+
+TEST_CASE(form_controls_in_different_states_do_not_share_their_style)
+{
+    auto& document = load_document(R"html(
+        <style>input:checked { color: rgb(255, 0, 0); }</style>
+        <div id="parent">
+            <input type="checkbox">
+            <input type="checkbox">
+        </div>)html"sv);
+    auto children = children_of(document, "parent"sv);
+    EXPECT_EQ(children.size(), 2u);
+    if (children.size() != 2)
+        return;
+
+    // Checking the box changes its state, but not its attributes.
+    verify_cast<Web::HTML::HTMLInputElement>(*children[0]).set_checked(true);
+    document.update_layout();
+
+    EXPECT(!share_style(*children[0], *children[1]));
+    EXPECT_EQ(color_of(*children[0]), Gfx::Color(255, 0, 0));
+    EXPECT_NE(color_of(*children[1]), Gfx::Color(255, 0, 0));
+}
+
+TEST_CASE(siblings_with_inline_style_do_not_share_their_style)
+{
+    auto& document = load_document(R"html(
+        <div id="parent">
+            <p style="color: rgb(255, 0, 0)">First</p>
+            <p style="color: rgb(255, 0, 0)">Second</p>
+        </div>)html"sv);
+    auto children = children_of(document, "parent"sv);
+    EXPECT_EQ(children.size(), 2u);
+    if (children.size() != 2)
+        return;
+
+    EXPECT(!share_style(*children[0], *children[1]));
+    EXPECT_EQ(color_of(*children[0]), Gfx::Color(255, 0, 0));
+    EXPECT_EQ(color_of(*children[1]), Gfx::Color(255, 0, 0));
+}
+
+TEST_CASE(ancestor_filter_is_empty_after_a_style_update)
+{
+    auto& document = load_document(R"html(
+        <div id="outer" class="a b">
+            <section class="c"><p id="inner">Text <b class="d">bold</b></p></section>
+            <ul><li>One</li><li class="e">Two</li></ul>
+        </div>)html"sv);
+    auto& style_computer = document.style_computer();
+    EXPECT(style_computer.ancestor_filter().is_empty());
+
+    // A full style update walks every element, and a partial one only the path down to the changed element.
+    document.invalidate_style();
+    document.update_style();
+    EXPECT(style_computer.statistics().styles_computed > 0);
+    EXPECT(style_computer.ancestor_filter().is_empty());
+
+    auto inner = document.get_element_by_id("inner"sv);
+    VERIFY(inner);
+    MUST(inner->set_attribute("class", "changed"));
+    document.update_style();
+    EXPECT(style_computer.ancestor_filter().is_empty());
+}
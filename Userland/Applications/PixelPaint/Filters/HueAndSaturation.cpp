@@ -8,6 +8,7 @@
 #include "../FilterParams.h"
 #include <LibGUI/Label.h>
 #include <LibGUI/ValueSlider.h>
+#include <LibGfx/Filters/ColorFilterChain.h>
 #include <LibGfx/Filters/HueRotateFilter.h>
 #include <LibGfx/Filters/SaturateFilter.h>
 #include <LibGfx/Filters/TintFilter.h>
@@ -16,15 +17,14 @@ namespace PixelPaint::Filters {
 
 void HueAndSaturation::apply(Gfx::Bitmap& target_bitmap) const
 {
-    auto apply_filter = [&](auto filter) {
-        filter.apply(target_bitmap, target_bitmap.rect(), target_bitmap, target_bitmap.rect());
-    };
-    apply_filter(Gfx::HueRotateFilter { m_hue + 360 });
-    apply_filter(Gfx::SaturateFilter { m_saturation / 100 + 1 });
+    Gfx::ColorFilterChain filters;
+    filters.append(make<Gfx::HueRotateFilter>(m_hue + 360));
+    filters.append(make<Gfx::SaturateFilter>(m_saturation / 100 + 1));
     auto lightness = m_lightness / 100;
-    apply_filter(lightness < 0
-            ? Gfx::TintFilter(Gfx::Color::Black, -lightness)
-            : Gfx::TintFilter(Gfx::Color::White, lightness));
+    filters.append(lightness < 0
+            ? make<Gfx::TintFilter>(Gfx::Color::Black, -lightness)
+            : make<Gfx::TintFilter>(Gfx::Color::White, lightness));
+    filters.apply(target_bitmap, target_bitmap.rect(), target_bitmap, target_bitmap.rect());
 }
 
 ErrorOr<RefPtr<GUI::Widget>> HueAndSaturation::get_settings_widget()
@@ -16,6 +16,7 @@
 #include <LibGUI/MessageBox.h>
 #include <LibGUI/Statusbar.h>
 #include <LibGUI/Window.h>
+#include <LibGfx/HelperThreads.h>
 #include <LibGfx/Painter.h>
 #include <LibMain/Main.h>
 
@@ -39,6 +40,9 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
     TRY(Core::System::unveil("/etc/FileIconProvider.ini", "r"));
     TRY(Core::System::unveil(nullptr, nullptr));
 
+    // Filters on big bitmaps are applied by several threads, while the thread that asked for them keeps working too.
+    Gfx::set_maximum_helper_thread_count(Gfx::helper_thread_count_for_online_processors());
+
     auto app_icon = GUI::Icon::default_icon("app-pixel-paint"sv);
 
     PixelPaint::g_icon_bag = TRY(PixelPaint::IconBag::create());
@@ -10,11 +10,16 @@
 #include <AK/BinaryHeap.h>
 #include <AK/BinarySearch.h>
 #include <AK/BitStream.h>
+#include <AK/BuiltinWrappers.h>
 #include <AK/MemoryStream.h>
+#include <AK/Platform.h>
+#include <AK/SIMD.h>
 #include <string.h>
 
 #include <LibCompress/Deflate.h>
 
+#pragma GCC diagnostic ignored "-Wpsabi"
+
 namespace Compress {
 
 static constexpr u8 deflate_special_code_length_copy = 16;
@@ -550,30 +555,83 @@ void DeflateCompressor::close()
 {
 }
 
+static constexpr u32 knuth_constant = 2654435761; // shares no common factors with 2^32
+
 // Knuth's multiplicative hash on 4 bytes
 u16 DeflateCompressor::hash_sequence(u8 const* bytes)
 {
-    constexpr const u32 knuth_constant = 2654435761; // shares no common factors with 2^32
     return ((bytes[0] | bytes[1] << 8 | bytes[2] << 16 | bytes[3] << 24) * knuth_constant) >> (32 - hash_bits);
 }
 
+#if ARCH(X86_64)
+// Neighbouring positions share three of the four bytes that they are hashed from, so the bytes of eight positions can be
+// shuffled out of a single 16-byte load, and hashed together. Without AVX2, the shuffle is slower than hashing them one
+// by one. Returns how many positions were hashed.
+[[gnu::target("avx2")]] static size_t hash_sequences_avx2(u8 const* bytes, size_t size, u16* hashes)
+{
+    using AK::SIMD::u16x8;
+    using AK::SIMD::u32x8;
+    using AK::SIMD::u8x16;
+
+    size_t i = 0;
+    for (; i + sizeof(u8x16) <= size; i += 8) {
+        u8x16 sixteen_bytes;
+        __builtin_memcpy(&sixteen_bytes, bytes + i, sizeof(sixteen_bytes));
+        auto shuffled_bytes = __builtin_shufflevector(sixteen_bytes, sixteen_bytes,
+            0, 1, 2, 3, 1, 2, 3, 4, 2, 3, 4, 5, 3, 4, 5, 6, 4, 5, 6, 7, 5, 6, 7, 8, 6, 7, 8, 9, 7, 8, 9, 10);
+        u32x8 sequences;
+        __builtin_memcpy(&sequences, &shuffled_bytes, sizeof(sequences));
+        auto eight_hashes = __builtin_convertvector((sequences * knuth_constant) >> (32 - DeflateCompressor::hash_bits), u16x8);
+        __builtin_memcpy(hashes + i, &eight_hashes, sizeof(eight_hashes));
+    }
+    return i;
+}
+#endif
+
+void DeflateCompressor::hash_pending_block()
+{
+    if (m_pending_block_size < min_match_length)
+        return;
+
+    auto const* block = pending_block().data();
+    size_t const hash_count = m_pending_block_size - min_match_length + 1;
+
+    size_t i = 0;
+#if ARCH(X86_64)
+    static bool const supports_avx2 = __builtin_cpu_supports("avx2");
+    if (supports_avx2)
+        i = hash_sequences_avx2(block, m_pending_block_size, m_pending_block_hashes);
+#endif
+    for (; i < hash_count; i++)
+        m_pending_block_hashes[i] = hash_sequence(block + i);
+}
+
 size_t DeflateCompressor::compare_match_candidate(size_t start, size_t candidate, size_t previous_match_length, size_t maximum_match_length)
 {
     VERIFY(previous_match_length < maximum_match_length);
 
-    // We firstly check that the match is at least (prev_match_length + 1) long, we check backwards as there's a higher chance the end mismatches
-    for (ssize_t i = previous_match_length; i >= 0; i--) {
-        if (m_rolling_window[start + i] != m_rolling_window[candidate + i])
-            return 0;
+    // We firstly check that the match is at least (prev_match_length + 1) long, the end is checked first as there's a higher chance it mismatches
+    if (m_rolling_window[start + previous_match_length] != m_rolling_window[candidate + previous_match_length])
+        return 0;
+
+    // Then we find the actual length, comparing 8 bytes at a time for as long as possible
+    size_t match_length = 0;
+    for (; match_length + sizeof(u64) <= maximum_match_length; match_length += sizeof(u64)) {
+        u64 start_bytes;
+        u64 candidate_bytes;
+        __builtin_memcpy(&start_bytes, &m_rolling_window[start + match_length], sizeof(u64));
+        __builtin_memcpy(&candidate_bytes, &m_rolling_window[candidate + match_length], sizeof(u64));
+        if (auto difference = start_bytes ^ candidate_bytes; difference != 0) {
+            match_length += count_trailing_zeroes(difference) / 8;
+            break;
+        }
     }
-
-    // Find the actual length
-    auto match_length = previous_match_length + 1;
     while (match_length < maximum_match_length && m_rolling_window[start + match_length] == m_rolling_window[candidate + match_length]) {
         match_length++;
     }
 
-    VERIFY(match_length > previous_match_length);
+    if (match_length <= previous_match_length)
+        return 0;
     VERIFY(match_length <= maximum_match_length);
     return match_length;
 }
@@ -607,8 +665,8 @@ size_t DeflateCompressor::find_back_match(size_t start, u16 hash, size_t previou
             match_position = candidate;
             previous_match_length = match_length;
 
-            if (match_length == maximum_match_length)
-                return match_length; // bail if we got the maximum possible length
+            if (match_length >= min(maximum_match_length, m_compression_constants.great_match_length))
+                return match_length; // bail if we got the maximum possible length, or one that's great already
         }
 
         candidate = m_hash_prev[candidate % window_size];
@@ -729,14 +787,19 @@ void DeflateCompressor::lz77_compress_block()
 
     VERIFY(m_compression_constants.great_match_length <= max_match_length);
 
+    // The fastest level doesn't hash the bytes inside of matches that are longer than this, like zlib's deflate_fast()
+    auto const max_insert_length = m_compression_level == CompressionLevel::FAST ? m_compression_constants.max_lazy_length : max_match_length;
+
+    hash_pending_block();
+
     // our block starts at block_size and is m_pending_block_size in length
     auto block_end = block_size + m_pending_block_size;
     size_t current_position;
     for (current_position = block_size; current_position < block_end - min_match_length + 1; current_position++) {
-        auto hash = hash_sequence(&m_rolling_window[current_position]);
+        auto hash = m_pending_block_hashes[current_position - block_size];
         size_t match_position;
         auto match_length = find_back_match(current_position, hash, previous_match_length,
-            min(m_compression_constants.great_match_length, block_end - current_position), match_position);
+            min(max_match_length, block_end - current_position), match_position);
 
         insert_hash(current_position, hash);
 
@@ -745,8 +808,10 @@ void DeflateCompressor::lz77_compress_block()
             emit_back_reference((current_position - 1) - previous_match_position, previous_match_length);
 
             // skip all the bytes that are included in this match
-            for (size_t j = current_position + 1; j < min(current_position - 1 + previous_match_length, block_end - min_match_length + 1); j++) {
-                insert_hash(j, hash_sequence(&m_rolling_window[j]));
+            if (previous_match_length <= max_insert_length) {
+                for (size_t j = current_position + 1; j < min(current_position - 1 + previous_match_length, block_end - min_match_length + 1); j++) {
+                    insert_hash(j, m_pending_block_hashes[j - block_size]);
+                }
             }
             current_position = (current_position - 1) + previous_match_length - 1;
             previous_match_length = 0;
@@ -1062,6 +1127,23 @@ ErrorOr<void> DeflateCompressor::final_flush()
     return {};
 }
 
+ErrorOr<void> DeflateCompressor::final_sync_flush()
+{
+    VERIFY(!m_finished);
+    if (m_pending_block_size != 0)
+        TRY(flush());
+    m_finished = true;
+
+    // An empty uncompressed block that isn't the final one ends the output on a byte boundary
+    TRY(m_output_stream->write_bits(0b0u, 1));
+    TRY(m_output_stream->write_bits(0b00u, 2));
+    TRY(m_output_stream->align_to_byte_boundary());
+    TRY(m_output_stream->write_value<LittleEndian<u16>>(0));
+    TRY(m_output_stream->write_value<LittleEndian<u16>>(0xffff));
+    TRY(m_output_stream->flush_buffer_to_stream());
+    return {};
+}
+
 ErrorOr<ByteBuffer> DeflateCompressor::compress_all(ReadonlyBytes bytes, CompressionLevel compression_level)
 {
     auto output_stream = TRY(try_make<AllocatingMemoryStream>());
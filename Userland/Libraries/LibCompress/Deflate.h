@@ -165,6 +165,11 @@ public:
     virtual void close() override;
     ErrorOr<void> final_flush();
 
+    // Ends the output like final_flush(), but without marking the end of the deflate stream. The output is padded to a
+    // whole byte instead, so that the output of another DeflateCompressor can follow it. This allows compressing the
+    // parts of a big input at the same time.
+    ErrorOr<void> final_sync_flush();
+
     static ErrorOr<ByteBuffer> compress_all(ReadonlyBytes bytes, CompressionLevel = CompressionLevel::GOOD);
 
 private:
@@ -174,6 +179,7 @@ private:
 
     // LZ77 Compression
     static u16 hash_sequence(u8 const* bytes);
+    void hash_pending_block();
     size_t compare_match_candidate(size_t start, size_t candidate, size_t prev_match_length, size_t max_match_length);
     size_t find_back_match(size_t start, u16 hash, size_t previous_match_length, size_t max_match_length, size_t& match_position);
     void lz77_compress_block();
@@ -219,6 +225,9 @@ private:
     // LZ77 Chained hash table
     u16 m_hash_head[1 << hash_bits];
     u16 m_hash_prev[window_size];
+
+    // The hash_sequence() of each position in the pending block, which are all computed before looking for matches.
+    u16 m_pending_block_hashes[block_size];
 };
 
 }
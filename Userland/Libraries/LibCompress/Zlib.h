@@ -49,6 +49,9 @@ public:
     Optional<ByteBuffer> decompress();
     u32 checksum();
 
+    // The deflate stream between the header and the checksum, for decompressing the data bit by bit.
+    ReadonlyBytes compressed_data() const { return m_data_bytes; }
+
     static Optional<ZlibDecompressor> try_create(ReadonlyBytes data);
     static Optional<ByteBuffer> decompress_all(ReadonlyBytes);
 
@@ -76,6 +79,10 @@ public:
 
     static ErrorOr<ByteBuffer> compress_all(ReadonlyBytes bytes, ZlibCompressionLevel = ZlibCompressionLevel::Default);
 
+    // The header that streams compressed at the given level start with, for putting a zlib stream together from deflate
+    // data that was compressed in parts.
+    static ZlibHeader header_for(ZlibCompressionMethod, ZlibCompressionLevel);
+
 private:
     ZlibCompressor(MaybeOwned<Stream> stream, NonnullOwnPtr<Stream> compressor_stream);
     ErrorOr<void> write_header(ZlibCompressionMethod, ZlibCompressionLevel);
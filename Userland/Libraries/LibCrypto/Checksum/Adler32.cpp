@@ -12,9 +12,19 @@ namespace Crypto::Checksum {
 
 void Adler32::update(ReadonlyBytes data)
 {
-    for (size_t i = 0; i < data.size(); i++) {
-        m_state_a = (m_state_a + data.at(i)) % 65521;
-        m_state_b = (m_state_b + m_state_a) % 65521;
+    // This is the most bytes that can be added up before m_state_b could overflow, so the sums only have to be
+    // reduced once for each chunk of them instead of after every byte.
+    static constexpr size_t bytes_per_chunk = 5552;
+
+    while (!data.is_empty()) {
+        auto chunk = data.trim(bytes_per_chunk);
+        for (auto byte : chunk) {
+            m_state_a += byte;
+            m_state_b += m_state_a;
+        }
+        m_state_a %= 65521;
+        m_state_b %= 65521;
+        data = data.slice(chunk.size());
     }
 };
 
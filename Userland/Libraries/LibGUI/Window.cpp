@@ -24,6 +24,7 @@
 #include <LibGUI/Widget.h>
 #include <LibGUI/Window.h>
 #include <LibGfx/Bitmap.h>
+#include <LibGfx/DisjointRectSet.h>
 #include <fcntl.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -53,10 +54,19 @@ public:
     Gfx::IntSize visible_size() const { return m_visible_size; }
     void set_visible_size(Gfx::IntSize visible_size) { m_visible_size = visible_size; }
 
+    // Only used for the backing stores of a frame ring.
+    u32 ring_index() const { return m_ring_index; }
+    void set_ring_index(u32 ring_index) { m_ring_index = ring_index; }
+
+    // Areas that were painted in other frames of the ring since this backing store was last painted.
+    Gfx::DisjointIntRectSet& stale_rects() { return m_stale_rects; }
+
 private:
     NonnullRefPtr<Gfx::Bitmap> m_bitmap;
     const i32 m_serial;
     Gfx::IntSize m_visible_size;
+    u32 m_ring_index { 0 };
+    Gfx::DisjointIntRectSet m_stale_rects;
 };
 
 static NeverDestroyed<HashTable<Window*>> all_windows;
@@ -201,8 +211,7 @@ void Window::server_did_destroy()
     m_window_id = 0;
     m_visible = false;
     m_pending_paint_event_rects.clear();
-    m_back_store = nullptr;
-    m_front_store = nullptr;
+    discard_backing_stores();
     m_cursor = Gfx::StandardCursor::None;
 }
 
@@ -282,9 +291,7 @@ void Window::set_rect(Gfx::IntRect const& a_rect)
     }
     auto window_rect = ConnectionToWindowServer::the().set_window_rect(m_window_id, a_rect);
     if (m_back_store && m_back_store->size() != window_rect.size())
-        m_back_store = nullptr;
-    if (m_front_store && m_front_store->size() != window_rect.size())
-        m_front_store = nullptr;
+        discard_backing_stores();
     if (m_main_widget)
         m_main_widget->resize(window_rect.size());
 }
@@ -424,20 +431,23 @@ void Window::handle_multi_paint_event(MultiPaintEvent& event)
     }
     VERIFY(!rects.is_empty());
 
-    // Throw away our backing store if its size is different, and we've stopped resizing or double buffering is disabled.
-    // This ensures that we shrink the backing store after a resize, and that we do not get flickering artifacts when
+    // Throw away our backing stores if their size is different, and we've stopped resizing or double buffering is disabled.
+    // This ensures that we shrink the backing stores after a resize, and that we do not get flickering artifacts when
     // directly painting into a shared active backing store.
     if (m_back_store && (!m_resizing || !m_double_buffering_enabled) && m_back_store->size() != event.window_size())
-        m_back_store = nullptr;
+        discard_backing_stores();
 
-    // Discard our backing store if it's unable to contain the new window size. Smaller is fine though, that prevents
+    // Discard our backing stores if they're unable to contain the new window size. Smaller is fine though, that prevents
     // lots of backing store allocations during a resize.
     if (m_back_store && !m_back_store->size().contains(event.window_size()))
-        m_back_store = nullptr;
+        discard_backing_stores();
 
     bool created_new_backing_store = false;
     if (!m_back_store) {
-        m_back_store = create_backing_store(backing_store_size(event.window_size())).release_value_but_fixme_should_propagate_errors();
+        if (m_double_buffering_enabled)
+            create_frame_ring(backing_store_size(event.window_size())).release_value_but_fixme_should_propagate_errors();
+        else
+            m_back_store = create_backing_store(backing_store_size(event.window_size())).release_value_but_fixme_should_propagate_errors();
         created_new_backing_store = true;
     } else if (m_double_buffering_enabled) {
         bool was_purged = false;
@@ -451,6 +461,8 @@ void Window::handle_multi_paint_event(MultiPaintEvent& event)
             dbgln("Not enough memory to make backing store non-volatile. Falling back to single-buffered mode.");
             m_double_buffering_enabled = false;
             m_back_store = move(m_front_store);
+            m_spare_store = nullptr;
+            m_frame_ring_state_buffer = {};
             created_new_backing_store = true;
         } else if (was_purged) {
             // The backing store bitmap was cleared, but it does have memory.
@@ -869,8 +881,7 @@ void Window::set_has_alpha_channel(bool value)
         return;
 
     m_pending_paint_event_rects.clear();
-    m_back_store = nullptr;
-    m_front_store = nullptr;
+    discard_backing_stores();
 
     ConnectionToWindowServer::the().async_set_window_has_alpha_channel(m_window_id, value);
     update();
@@ -939,25 +950,88 @@ void Window::set_current_backing_store(WindowBackingStore& backing_store, bool f
 
 void Window::flip(Vector<Gfx::IntRect, 32> const& dirty_rects)
 {
-    swap(m_front_store, m_back_store);
+    auto& state = *reinterpret_cast<WindowServer::FrameRingState*>(m_frame_ring_state_buffer.data<void>());
+    auto& frame = state.frames[m_back_store->ring_index()];
+    frame.visible_width = m_back_store->visible_size().width();
+    frame.visible_height = m_back_store->visible_size().height();
+    frame.ready_time_us = Time::now_monotonic().to_microseconds();
 
-    set_current_backing_store(*m_front_store);
+    // Hand the frame we just painted to WindowServer, and take whichever buffer it isn't using in return.
+    auto published_buffer = WindowServer::FrameRingState::encode_pending_buffer(m_back_store->ring_index(), ++m_frame_sequence, true);
+    auto previous_pending_buffer = state.pending_buffer.exchange(published_buffer, AK::memory_order_acq_rel);
+    auto next_ring_index = WindowServer::FrameRingState::buffer_index_of(previous_pending_buffer);
 
-    if (!m_back_store || m_back_store->size() != m_front_store->size()) {
-        m_back_store = create_backing_store(m_front_store->size()).release_value_but_fixme_should_propagate_errors();
-        memcpy(m_back_store->bitmap().scanline(0), m_front_store->bitmap().scanline(0), m_front_store->bitmap().size_in_bytes());
-        m_back_store->bitmap().set_volatile();
-        return;
+    for (auto& dirty_rect : dirty_rects) {
+        m_front_store->stale_rects().add(dirty_rect);
+        m_spare_store->stale_rects().add(dirty_rect);
     }
 
-    // Copy whatever was painted from the front to the back.
+    swap(m_front_store, m_back_store);
+    if (m_back_store->ring_index() != next_ring_index)
+        swap(m_back_store, m_spare_store);
+    VERIFY(m_back_store->ring_index() == next_ring_index);
+
+    // Copy whatever was painted since this buffer was last painted from the frame we just published.
     Painter painter(m_back_store->bitmap());
-    for (auto& dirty_rect : dirty_rects)
-        painter.blit(dirty_rect.location(), m_front_store->bitmap(), dirty_rect, 1.0f, false);
+    for (auto& stale_rect : m_back_store->stale_rects().rects())
+        painter.blit(stale_rect.location(), m_front_store->bitmap(), stale_rect, 1.0f, false);
+    m_back_store->stale_rects().clear_with_capacity();
 
     m_back_store->bitmap().set_volatile();
 }
 
+ErrorOr<void> Window::create_frame_ring(Gfx::IntSize size)
+{
+    auto state_buffer = TRY(Core::AnonymousBuffer::create_with_size(sizeof(WindowServer::FrameRingState)));
+    new (state_buffer.data<void>()) WindowServer::FrameRingState;
+
+    Array<OwnPtr<WindowBackingStore>, WindowServer::FrameRingState::buffer_count> stores;
+    Vector<Gfx::ShareableBitmap> bitmaps;
+    Vector<i32> serials;
+    for (u32 i = 0; i < WindowServer::FrameRingState::buffer_count; ++i) {
+        auto store = TRY(create_backing_store(size));
+        store->set_ring_index(i);
+        // Nothing has been painted into the other buffers yet, so they'll have to be brought up to date completely.
+        if (i != WindowServer::FrameRingState::initial_client_buffer_index)
+            store->stale_rects().add({ {}, size });
+        TRY(bitmaps.try_append(store->bitmap().to_shareable_bitmap()));
+        TRY(serials.try_append(store->serial()));
+        stores[i] = move(store);
+    }
+
+    m_back_store = move(stores[WindowServer::FrameRingState::initial_client_buffer_index]);
+    m_front_store = move(stores[WindowServer::FrameRingState::initial_pending_buffer_index]);
+    m_spare_store = move(stores[WindowServer::FrameRingState::initial_server_buffer_index]);
+    m_frame_ring_state_buffer = move(state_buffer);
+    m_frame_sequence = 0;
+
+    ConnectionToWindowServer::the().async_set_window_frame_ring(m_window_id, m_frame_ring_state_buffer, move(bitmaps), move(serials));
+    return {};
+}
+
+void Window::discard_backing_stores()
+{
+    m_back_store = nullptr;
+    m_front_store = nullptr;
+    m_spare_store = nullptr;
+    m_frame_ring_state_buffer = {};
+}
+
+Optional<WindowServer::FrameRingStatistics> Window::frame_statistics() const
+{
+    if (!m_frame_ring_state_buffer.is_valid())
+        return {};
+
+    auto const& state = *reinterpret_cast<WindowServer::FrameRingState const*>(m_frame_ring_state_buffer.data<void>());
+    WindowServer::FrameRingStatistics statistics;
+    statistics.frames_presented = state.frames_presented.load(AK::memory_order_relaxed);
+    statistics.frames_dropped = state.frames_dropped.load(AK::memory_order_relaxed);
+    if (statistics.frames_presented > 0)
+        statistics.average_latency = Time::from_microseconds(state.total_latency_us.load(AK::memory_order_relaxed) / statistics.frames_presented);
+    statistics.longest_latency = Time::from_microseconds(state.longest_latency_us.load(AK::memory_order_relaxed));
+    return statistics;
+}
+
 ErrorOr<NonnullOwnPtr<WindowBackingStore>> Window::create_backing_store(Gfx::IntSize size)
 {
     auto format = m_has_alpha_channel ? Gfx::BitmapFormat::BGRA8888 : Gfx::BitmapFormat::BGRx8888;
@@ -1186,24 +1260,36 @@ void Window::notify_state_changed(Badge<ConnectionToWindowServer>, bool minimize
 
     m_maximized = maximized;
 
-    // When double buffering is enabled, minimization/occlusion means we can mark the front bitmap volatile (in addition to the back bitmap.)
+    // When double buffering is enabled, minimization/occlusion means we can mark the front and spare bitmaps volatile (in addition to the back bitmap.)
     // When double buffering is disabled, there is only the back bitmap (which we can now mark volatile!)
-    auto& store = m_double_buffering_enabled ? m_front_store : m_back_store;
-    if (!store)
+    if (!m_back_store)
         return;
-    if (minimized || occluded) {
-        store->bitmap().set_volatile();
-    } else {
+    Array<WindowBackingStore*, 2> stores { m_back_store.ptr(), nullptr };
+    if (m_double_buffering_enabled)
+        stores = { m_front_store.ptr(), m_spare_store.ptr() };
+
+    for (auto* store : stores) {
+        if (!store)
+            continue;
+        if (minimized || occluded) {
+            store->bitmap().set_volatile();
+            continue;
+        }
         bool was_purged = false;
         bool bitmap_has_memory = store->bitmap().set_nonvolatile(was_purged);
         if (!bitmap_has_memory) {
             // Not enough memory to make the bitmap non-volatile. Lose the bitmap and schedule an update.
             // Let the paint system figure out what to do.
-            store = nullptr;
+            discard_backing_stores();
             update();
-        } else if (was_purged) {
+            return;
+        }
+        if (was_purged) {
             // The bitmap memory was purged by the kernel, but we have all-new zero-filled pages.
-            // Schedule an update to regenerate the bitmap.
+            // Schedule an update to regenerate the bitmap. A buffer of the frame ring also has to be brought up to date
+            // completely the next time it's painted into.
+            if (m_double_buffering_enabled)
+                store->stale_rects().add({ {}, store->size() });
             update();
         }
     }
@@ -13,6 +13,7 @@
 #include <AK/OwnPtr.h>
 #include <AK/Variant.h>
 #include <AK/WeakPtr.h>
+#include <LibCore/AnonymousBuffer.h>
 #include <LibCore/Object.h>
 #include <LibGUI/FocusSource.h>
 #include <LibGUI/Forward.h>
@@ -22,6 +23,7 @@
 #include <LibGfx/Forward.h>
 #include <LibGfx/Rect.h>
 #include <LibGfx/StandardCursor.h>
+#include <Services/WindowServer/FrameRing.h>
 
 namespace GUI {
 
@@ -177,6 +179,9 @@ public:
 
     Gfx::Bitmap* back_bitmap();
 
+    // Counters for the frames this window has handed to WindowServer, if it is double buffered.
+    Optional<WindowServer::FrameRingStatistics> frame_statistics() const;
+
     Gfx::IntSize size_increment() const { return m_size_increment; }
     void set_size_increment(Gfx::IntSize);
     Gfx::IntSize base_size() const { return m_base_size; }
@@ -274,6 +279,8 @@ private:
     void server_did_destroy();
 
     ErrorOr<NonnullOwnPtr<WindowBackingStore>> create_backing_store(Gfx::IntSize);
+    ErrorOr<void> create_frame_ring(Gfx::IntSize);
+    void discard_backing_stores();
     Gfx::IntSize backing_store_size(Gfx::IntSize) const;
     void set_current_backing_store(WindowBackingStore&, bool flush_immediately = false) const;
     void flip(Vector<Gfx::IntRect, 32> const& dirty_rects);
@@ -285,6 +292,9 @@ private:
 
     OwnPtr<WindowBackingStore> m_front_store;
     OwnPtr<WindowBackingStore> m_back_store;
+    OwnPtr<WindowBackingStore> m_spare_store;
+    Core::AnonymousBuffer m_frame_ring_state_buffer;
+    u32 m_frame_sequence { 0 };
 
     NonnullRefPtr<Menubar> m_menubar;
 
@@ -220,62 +220,102 @@ void AntiAliasingPainter::fill_path(Path const& path, PaintStyle const& paint_st
     m_underlying_painter.antialiased_fill_path(path, paint_style, rule, m_transform.translation());
 }
 
+// Strokes the lines of the path by outlining each run of connected lines on both sides, with butt caps at the ends of
+// open runs. The outlines go forward on the left and back on the right, so the stroke winds the same way everywhere and
+// the parts where it overlaps itself only get painted once with the nonzero winding rule.
 void AntiAliasingPainter::stroke_path(Path const& path, Color color, float thickness)
 {
-    FloatPoint cursor;
-    bool previous_was_line = false;
-    FloatLine last_line;
-    Optional<FloatLine> first_line;
-
-    for (auto& segment : path.segments()) {
-        switch (segment->type()) {
-        case Segment::Type::Invalid:
-            VERIFY_NOT_REACHED();
-        case Segment::Type::MoveTo:
-            cursor = segment->point();
-            break;
-        case Segment::Type::LineTo:
-            draw_line(cursor, segment->point(), color, thickness);
-            if (thickness > 1) {
-                if (!first_line.has_value())
-                    first_line = FloatLine(cursor, segment->point());
-                if (previous_was_line)
-                    stroke_segment_intersection(cursor, segment->point(), last_line, color, thickness);
-                last_line.set_a(cursor);
-                last_line.set_b(segment->point());
-            }
-            cursor = segment->point();
-            break;
-        case Segment::Type::QuadraticBezierCurveTo: {
-            auto through = static_cast<QuadraticBezierCurveSegment const&>(*segment).through();
-            draw_quadratic_bezier_curve(through, cursor, segment->point(), color, thickness);
-            cursor = segment->point();
-            break;
+    if (thickness <= 0 || color.alpha() == 0)
+        return;
+
+    // The default miter limit of SVG, past which joins are beveled.
+    constexpr float miter_limit = 4;
+    auto translation = m_underlying_painter.translation().to_type<float>();
+    auto stroke_bounds = m_transform.map(path.bounding_box()).inflated(miter_limit * thickness, miter_limit * thickness).translated(translation);
+    CoverageRasterizer rasterizer(enclosing_int_rect(stroke_bounds).intersected(m_underlying_painter.clip_rect()));
+    if (rasterizer.bounds().is_empty())
+        return;
+
+    float half_thickness = thickness / 2;
+
+    struct StrokedLine {
+        FloatPoint from;
+        FloatPoint to;
+        FloatPoint normal;
+        float length;
+    };
+    Vector<StrokedLine> run;
+    Vector<FloatPoint> left_side;
+    Vector<FloatPoint> right_side;
+
+    // Adds the points where the outline on one side goes from the previous line to the next one.
+    auto add_join = [&](Vector<FloatPoint>& side, float direction, StrokedLine const& previous, StrokedLine const& next) {
+        auto previous_offset = previous.normal * direction;
+        auto next_offset = next.normal * direction;
+        auto point = next.from;
+        auto cosine = (previous.normal.x() * next.normal.x() + previous.normal.y() * next.normal.y()) / (half_thickness * half_thickness);
+        auto sine = (previous.normal.x() * next.normal.y() - previous.normal.y() * next.normal.x()) / (half_thickness * half_thickness);
+        bool is_inside_of_turn = sine * direction > 0;
+
+        // On the inside, the offset lines meet where they cross, unless the lines are too short for that. On the outside,
+        // they meet at the tip of the miter, which is 1 / sin(angle / 2) times as long as the stroke is thick.
+        bool offset_lines_cross = half_thickness * fabsf(sine) <= min(previous.length, next.length) * (1 + cosine);
+        bool miter_is_short_enough = (1 + cosine) / 2 >= 1 / (miter_limit * miter_limit);
+        if (is_inside_of_turn ? offset_lines_cross : miter_is_short_enough) {
+            side.append(point + (previous_offset + next_offset) / (1 + cosine));
+            return;
+        }
+        side.append(point + previous_offset);
+        if (is_inside_of_turn)
+            side.append(point);
+        side.append(point + next_offset);
+    };
+
+    auto finish_run = [&] {
+        if (run.is_empty())
+            return;
+        bool is_closed = run.size() > 1 && run.last().to == run.first().from;
+        left_side.clear_with_capacity();
+        right_side.clear_with_capacity();
+        if (is_closed) {
+            add_join(left_side, 1, run.last(), run.first());
+            add_join(right_side, -1, run.last(), run.first());
+        } else {
+            left_side.append(run.first().from + run.first().normal);
+            right_side.append(run.first().from - run.first().normal);
         }
-        case Segment::Type::CubicBezierCurveTo: {
-            auto& curve = static_cast<CubicBezierCurveSegment const&>(*segment);
-            auto through_0 = curve.through_0();
-            auto through_1 = curve.through_1();
-            draw_cubic_bezier_curve(through_0, through_1, cursor, segment->point(), color, thickness);
-            cursor = segment->point();
-            break;
+        for (size_t i = 1; i < run.size(); ++i) {
+            add_join(left_side, 1, run[i - 1], run[i]);
+            add_join(right_side, -1, run[i - 1], run[i]);
         }
-        case Segment::Type::EllipticalArcTo:
-            auto& arc = static_cast<EllipticalArcSegment const&>(*segment);
-            draw_elliptical_arc(cursor, segment->point(), arc.center(), arc.radii(), arc.x_axis_rotation(), arc.theta_1(), arc.theta_delta(), color, thickness);
-            cursor = segment->point();
-            break;
+        if (is_closed) {
+            rasterizer.add_polygon(left_side);
+            right_side.reverse();
+            rasterizer.add_polygon(right_side);
+        } else {
+            left_side.append(run.last().to + run.last().normal);
+            right_side.append(run.last().to - run.last().normal);
+            right_side.reverse();
+            left_side.extend(right_side);
+            rasterizer.add_polygon(left_side);
         }
+        run.clear_with_capacity();
+    };
 
-        previous_was_line = segment->type() == Segment::Type::LineTo;
-    }
+    path.for_each_line([&](FloatPoint from, FloatPoint to, bool starts_subpath) {
+        from = m_transform.map(from) + translation;
+        to = m_transform.map(to) + translation;
+        if (starts_subpath || (!run.is_empty() && run.last().to != from))
+            finish_run();
+        auto length = from.distance_from(to);
+        if (length == 0)
+            return;
+        auto direction = (to - from) / length;
+        run.append({ from, to, { -direction.y() * half_thickness, direction.x() * half_thickness }, length });
+    });
+    finish_run();
 
-    // Check if the figure was started and closed as line at the same position.
-    if (thickness > 1 && previous_was_line && path.segments().size() >= 2 && path.segments().first()->point() == cursor
-        && (path.segments().first()->type() == Segment::Type::LineTo
-            || (path.segments().first()->type() == Segment::Type::MoveTo && path.segments()[1]->type() == Segment::Type::LineTo))) {
-        stroke_segment_intersection(first_line.value().a(), first_line.value().b(), last_line, color, thickness);
-    }
+    m_underlying_painter.fill_coverage(rasterizer, WindingRule::Nonzero, color);
 }
 
 void AntiAliasingPainter::draw_elliptical_arc(FloatPoint p1, FloatPoint p2, FloatPoint center, FloatSize radii, float x_axis_rotation, float theta_1, float theta_delta, Color color, float thickness, Painter::LineStyle style)
@@ -690,77 +730,4 @@ void AntiAliasingPainter::fill_rect_with_rounded_corners(IntRect const& a_rect,
         fill_corner(bottom_right_corner, bounding_rect.bottom_right(), bottom_right);
 }
 
-void AntiAliasingPainter::stroke_segment_intersection(FloatPoint current_line_a, FloatPoint current_line_b, FloatLine const& previous_line, Color color, float thickness)
-{
-    // FIXME: This is currently drawn in slightly the wrong place most of the time.
-    // FIXME: This is sometimes drawn when the intersection would not be visible anyway.
-
-    // Starting point of the current line is where the last line ended... this is an intersection.
-    auto intersection = current_line_a;
-
-    // If both are straight lines we can simply draw a rectangle at the intersection (or nothing).
-    auto current_vertical = current_line_a.x() == current_line_b.x();
-    auto current_horizontal = current_line_a.y() == current_line_b.y();
-    auto previous_vertical = previous_line.a().x() == previous_line.b().x();
-    auto previous_horizontal = previous_line.a().y() == previous_line.b().y();
-    if (previous_horizontal && current_horizontal)
-        return;
-    if (previous_vertical && current_vertical)
-        return;
-    if ((previous_horizontal || previous_vertical) && (current_horizontal || current_vertical)) {
-        intersection = m_transform.map(current_line_a);
-        // Note: int_thickness used here to match behaviour of draw_line()
-        int int_thickness = AK::ceil(thickness);
-        return fill_rect(FloatRect(intersection, { thickness, thickness }).translated(-int_thickness / 2), color);
-    }
-
-    auto previous_line_a = previous_line.a();
-    float scale_to_move_current = (thickness / 2) / intersection.distance_from(current_line_b);
-    float scale_to_move_previous = (thickness / 2) / intersection.distance_from(previous_line_a);
-
-    // Move the point on the line by half of the thickness.
-    float offset_current_edge_x = scale_to_move_current * (current_line_b.x() - intersection.x());
-    float offset_current_edge_y = scale_to_move_current * (current_line_b.y() - intersection.y());
-    float offset_prev_edge_x = scale_to_move_previous * (previous_line_a.x() - intersection.x());
-    float offset_prev_edge_y = scale_to_move_previous * (previous_line_a.y() - intersection.y());
-
-    // Rotate the point by 90 and 270 degrees to get the points for both edges.
-    FloatPoint current_rotated_90deg(-offset_current_edge_y, offset_current_edge_x);
-    FloatPoint previous_rotated_90deg(-offset_prev_edge_y, offset_prev_edge_x);
-    auto current_rotated_270deg = intersection - current_rotated_90deg;
-    auto previous_rotated_270deg = intersection - previous_rotated_90deg;
-
-    // Translate coordinates to the intersection point.
-    current_rotated_90deg += intersection;
-    previous_rotated_90deg += intersection;
-
-    FloatLine outer_line_current_90(current_rotated_90deg, current_line_b - (intersection - current_rotated_90deg));
-    FloatLine outer_line_current_270(current_rotated_270deg, current_line_b - (intersection - current_rotated_270deg));
-    FloatLine outer_line_prev_270(previous_rotated_270deg, previous_line_a - (intersection - previous_rotated_270deg));
-    FloatLine outer_line_prev_90(previous_rotated_90deg, previous_line_a - (intersection - previous_rotated_90deg));
-
-    auto edge_spike_90 = outer_line_current_90.intersected(outer_line_prev_270);
-    Optional<FloatPoint> edge_spike_270;
-
-    if (edge_spike_90.has_value()) {
-        edge_spike_270 = intersection + (intersection - *edge_spike_90);
-    } else {
-        edge_spike_270 = outer_line_current_270.intersected(outer_line_prev_90);
-        if (edge_spike_270.has_value())
-            edge_spike_90 = intersection + (intersection - *edge_spike_270);
-    }
-
-    Path intersection_edge_path;
-    intersection_edge_path.move_to(current_rotated_90deg);
-    if (edge_spike_90.has_value())
-        intersection_edge_path.line_to(*edge_spike_90);
-    intersection_edge_path.line_to(previous_rotated_270deg);
-    intersection_edge_path.line_to(current_rotated_270deg);
-    if (edge_spike_270.has_value())
-        intersection_edge_path.line_to(*edge_spike_270);
-    intersection_edge_path.line_to(previous_rotated_90deg);
-    intersection_edge_path.close();
-    fill_path(intersection_edge_path, color);
-}
-
 }
@@ -447,6 +447,15 @@ ErrorOr<NonnullRefPtr<Gfx::Bitmap>> Bitmap::scaled(float sx, float sy) const
     return new_bitmap;
 }
 
+ErrorOr<NonnullRefPtr<Gfx::Bitmap>> Bitmap::scaled_with_filter(IntSize size, ResamplingFilter filter) const
+{
+    VERIFY(!size.is_empty());
+    auto new_bitmap = TRY(Gfx::Bitmap::create(has_alpha_channel() ? BitmapFormat::BGRA8888 : BitmapFormat::BGRx8888, size, scale()));
+    auto physical_size = new_bitmap->physical_size();
+    TRY(resample(*new_bitmap, *this, FloatRect { 0, 0, physical_width(), physical_height() }, physical_size, { {}, physical_size }, filter));
+    return new_bitmap;
+}
+
 ErrorOr<NonnullRefPtr<Gfx::Bitmap>> Bitmap::cropped(Gfx::IntRect crop, Optional<BitmapFormat> new_bitmap_format) const
 {
     auto new_bitmap = TRY(Gfx::Bitmap::create(new_bitmap_format.value_or(format()), { crop.width(), crop.height() }, scale()));
@@ -15,6 +15,7 @@
 #include <LibGfx/Color.h>
 #include <LibGfx/Forward.h>
 #include <LibGfx/Rect.h>
+#include <LibGfx/Resampler.h>
 
 #define ENUMERATE_IMAGE_FORMATS             \
     __ENUMERATE_IMAGE_FORMAT(pbm, ".pbm")   \
@@ -120,6 +121,8 @@ public:
     ErrorOr<NonnullRefPtr<Gfx::Bitmap>> flipped(Gfx::Orientation) const;
     ErrorOr<NonnullRefPtr<Gfx::Bitmap>> scaled(int sx, int sy) const;
     ErrorOr<NonnullRefPtr<Gfx::Bitmap>> scaled(float sx, float sy) const;
+    // Unlike scaled(), this takes every pixel into account when scaling down, so it doesn't alias.
+    ErrorOr<NonnullRefPtr<Gfx::Bitmap>> scaled_with_filter(IntSize, ResamplingFilter) const;
     ErrorOr<NonnullRefPtr<Gfx::Bitmap>> cropped(Gfx::IntRect, Optional<BitmapFormat> new_bitmap_format = {}) const;
     ErrorOr<NonnullRefPtr<Gfx::Bitmap>> to_bitmap_backed_by_anonymous_buffer() const;
     [[nodiscard]] ErrorOr<ByteBuffer> serialize_to_byte_buffer() const;
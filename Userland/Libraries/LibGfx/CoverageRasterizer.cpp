@@ -0,0 +1,335 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/IntegralMath.h>
+#include <AK/SIMDExtras.h>
+#include <LibGfx/CoverageRasterizer.h>
+#include <LibGfx/Path.h>
+#include <math.h>
+
+#pragma GCC diagnostic ignored "-Wpsabi"
+
+namespace Gfx {
+
+using namespace AK::SIMD;
+
+CoverageRasterizer::CoverageRasterizer(IntRect const& bounds)
+    : m_bounds(bounds)
+{
+    if (!m_bounds.is_empty())
+        m_bands.resize(ceil_div(m_bounds.height(), tile_size));
+}
+
+static FloatPoint point_at_y(FloatPoint from, FloatPoint to, float y)
+{
+    float t = (y - from.y()) / (to.y() - from.y());
+    return { from.x() + t * (to.x() - from.x()), y };
+}
+
+static FloatPoint point_at_x(FloatPoint from, FloatPoint to, float x)
+{
+    float t = (x - from.x()) / (to.x() - from.x());
+    return { x, from.y() + t * (to.y() - from.y()) };
+}
+
+void CoverageRasterizer::add_line(FloatPoint from, FloatPoint to)
+{
+    if (m_bounds.is_empty() || from.y() == to.y())
+        return;
+
+    auto origin = m_bounds.location().to_type<float>();
+    from -= origin;
+    to -= origin;
+
+    // Lines only cover pixels in the rows they pass through.
+    float const height = m_bounds.height();
+    if (max(from.y(), to.y()) <= 0.0f || min(from.y(), to.y()) >= height)
+        return;
+    auto clipped_from = from;
+    auto clipped_to = to;
+    if (from.y() < 0.0f || from.y() > height)
+        clipped_from = point_at_y(from, to, clamp(from.y(), 0.0f, height));
+    if (to.y() < 0.0f || to.y() > height)
+        clipped_to = point_at_y(from, to, clamp(to.y(), 0.0f, height));
+    add_line_inside_rows(clipped_from, clipped_to);
+}
+
+// The parts of a line that are left of the bounds become a vertical line on the left edge, since they cover whole
+// pixels of the row from there on. The parts that are right of the bounds don't cover anything.
+void CoverageRasterizer::add_line_inside_rows(FloatPoint from, FloatPoint to)
+{
+    float const width = m_bounds.width();
+    if (min(from.x(), to.x()) >= 0.0f && max(from.x(), to.x()) <= width)
+        return add_line_to_bands(from, to);
+
+    FloatPoint points[4] { from };
+    size_t point_count = 1;
+    auto add_crossing = [&](float x) {
+        if ((from.x() < x) != (to.x() < x) && from.x() != x && to.x() != x)
+            points[point_count++] = point_at_x(from, to, x);
+    };
+    // The crossings have to be in the order of the line.
+    if (from.x() < to.x()) {
+        add_crossing(0.0f);
+        add_crossing(width);
+    } else {
+        add_crossing(width);
+        add_crossing(0.0f);
+    }
+    points[point_count++] = to;
+
+    for (size_t i = 0; i + 1 < point_count; ++i) {
+        auto a = points[i];
+        auto b = points[i + 1];
+        if (a.x() + b.x() >= 2.0f * width)
+            continue;
+        a.set_x(clamp(a.x(), 0.0f, width));
+        b.set_x(clamp(b.x(), 0.0f, width));
+        add_line_to_bands(a, b);
+    }
+}
+
+void CoverageRasterizer::append_to_band(int band, Line const& line)
+{
+    // Bands can collect many thousands of lines, so they grow faster than vectors usually do.
+    auto& lines = m_bands[band];
+    if (lines.size() == lines.capacity())
+        lines.ensure_capacity(max<size_t>(64, lines.capacity() * 2));
+    lines.unchecked_append(line);
+}
+
+void CoverageRasterizer::add_line_to_bands(FloatPoint from, FloatPoint to)
+{
+    if (from.y() == to.y())
+        return;
+
+    float const top = min(from.y(), to.y());
+    float const bottom = max(from.y(), to.y());
+    int const first_band = static_cast<int>(top) / tile_size;
+    int const end_band = min(ceil_div(static_cast<int>(ceilf(bottom)), tile_size), static_cast<int>(m_bands.size()));
+
+    // Most lines of flattened curves are short enough to be inside a single band.
+    if (end_band == first_band + 1) {
+        float const band_top = first_band * tile_size;
+        append_to_band(first_band, { from.translated(0, -band_top), to.translated(0, -band_top) });
+        return;
+    }
+
+    for (int band = first_band; band < end_band; ++band) {
+        float const band_top = band * tile_size;
+        float const band_bottom = band_top + tile_size;
+        auto band_from = from.y() < band_top || from.y() > band_bottom ? point_at_y(from, to, clamp(from.y(), band_top, band_bottom)) : from;
+        auto band_to = to.y() < band_top || to.y() > band_bottom ? point_at_y(from, to, clamp(to.y(), band_top, band_bottom)) : to;
+        if (band_from.y() == band_to.y())
+            continue;
+        append_to_band(band, { band_from.translated(0, -band_top), band_to.translated(0, -band_top) });
+    }
+}
+
+void CoverageRasterizer::add_path(Path const& path, FloatPoint offset)
+{
+    // The lines are accumulated in any order, so the ones that the path keeps around for the scanline filler will do.
+    for (auto const& line : path.split_lines())
+        add_line(line.from + offset, line.to + offset);
+
+    // Filling closes every subpath with a line back to where it started.
+    Optional<FloatPoint> subpath_start;
+    FloatPoint cursor;
+    auto close_subpath = [&] {
+        if (subpath_start.has_value() && cursor != *subpath_start)
+            add_line(cursor + offset, *subpath_start + offset);
+    };
+    for (auto const& segment : path.segments()) {
+        if (segment->type() == Segment::Type::MoveTo) {
+            close_subpath();
+            subpath_start = segment->point();
+        } else if (!subpath_start.has_value()) {
+            subpath_start = cursor;
+        }
+        cursor = segment->point();
+    }
+    close_subpath();
+}
+
+void CoverageRasterizer::add_polygon(ReadonlySpan<FloatPoint> points)
+{
+    for (size_t i = 0; i < points.size(); ++i)
+        add_line(points[i], points[(i + 1) % points.size()]);
+}
+
+// Adds the signed area that the line covers in each pixel to the cell of that pixel, and the rest of the height it
+// spans in a row to the cell after it. Lines going down count positive, lines going up negative.
+void CoverageRasterizer::accumulate_line(Line const& line, float* cells) const
+{
+    auto from = line.from;
+    auto to = line.to;
+    float direction = 1.0f;
+    if (from.y() > to.y()) {
+        swap(from, to);
+        direction = -1.0f;
+    }
+
+    float const width = m_bounds.width();
+    float const dxdy = (to.x() - from.x()) / (to.y() - from.y());
+    float x = from.x();
+    int const end_row = min(static_cast<int>(ceilf(to.y())), tile_size);
+    for (int y = static_cast<int>(from.y()); y < end_row; ++y) {
+        float* row = cells + y * m_stride;
+        float const dy = min(y + 1.0f, to.y()) - max(static_cast<float>(y), from.y());
+        float const next_x = clamp(x + dxdy * dy, 0.0f, width);
+        float const d = dy * direction;
+
+        float const x0 = min(x, next_x);
+        float const x1 = max(x, next_x);
+        float const x0_floor = floorf(x0);
+        float const x1_ceil = ceilf(x1);
+        int const x0_index = static_cast<int>(x0_floor);
+        int const x1_index = static_cast<int>(x1_ceil);
+
+        if (x1_index <= x0_index + 1) {
+            // Within a single pixel, the line covers the part of it that is right of its average x.
+            float const average_x = 0.5f * (x + next_x) - x0_floor;
+            row[x0_index] += d - d * average_x;
+            row[x0_index + 1] += d * average_x;
+        } else {
+            // The covered area grows quadratically in the first and last pixels, and linearly in the ones between.
+            float const slope = 1.0f / (x1 - x0);
+            float const x0_fraction = x0 - x0_floor;
+            float const first_area = 0.5f * slope * (1.0f - x0_fraction) * (1.0f - x0_fraction);
+            float const x1_fraction = x1 - x1_ceil + 1.0f;
+            float const last_area = 0.5f * slope * x1_fraction * x1_fraction;
+            row[x0_index] += d * first_area;
+            if (x1_index == x0_index + 2) {
+                row[x0_index + 1] += d * (1.0f - first_area - last_area);
+            } else {
+                float const second_area = slope * (1.5f - x0_fraction);
+                row[x0_index + 1] += d * (second_area - first_area);
+                for (int i = x0_index + 2; i < x1_index - 1; ++i)
+                    row[i] += d * slope;
+                float const area_before_last = second_area + (x1_index - x0_index - 3) * slope;
+                row[x1_index - 1] += d * (1.0f - area_before_last - last_area);
+            }
+            row[x1_index] += d * last_area;
+        }
+        x = next_x;
+    }
+}
+
+template<WindingRule winding_rule>
+ALWAYS_INLINE static f32x4 coverage_from_sum(f32x4 sum)
+{
+    f32x4 const one = expand4(1.0f);
+    f32x4 coverage = sum < 0.0f ? -sum : sum;
+    if constexpr (winding_rule == WindingRule::EvenOdd) {
+        // Every other time the outline is crossed, the coverage goes back down.
+        coverage -= 2.0f * to_f32x4(to_i32x4(coverage * 0.5f));
+        return coverage > one ? 2.0f - coverage : coverage;
+    }
+    return coverage > one ? one : coverage;
+}
+
+template<WindingRule winding_rule>
+static u8 coverage_from_sum(float sum)
+{
+    return static_cast<u8>(coverage_from_sum<winding_rule>(expand4(sum))[0] * 255.0f + 0.5f);
+}
+
+// Adds up `count` cells (a multiple of 4) four at a time, converts the sums to coverage, and clears the cells for the
+// next band. Returns the sum at the end.
+template<WindingRule winding_rule>
+static float accumulate_cells(float* cells, u8* coverage, size_t count, float sum)
+{
+    f32x4 const zero {};
+    f32x4 carry = expand4(sum);
+    for (size_t i = 0; i < count; i += 4) {
+        f32x4 values;
+        __builtin_memcpy(&values, cells + i, sizeof(values));
+        __builtin_memcpy(cells + i, &zero, sizeof(zero));
+
+        // A prefix sum in two steps: add the neighbor one lane over, then the pair two lanes over.
+        values += __builtin_shufflevector(values, zero, 4, 0, 1, 2);
+        values += __builtin_shufflevector(values, zero, 4, 5, 0, 1);
+        values += carry;
+        carry = __builtin_shufflevector(values, values, 3, 3, 3, 3);
+
+        auto bytes = to_u8x4(to_i32x4(coverage_from_sum<winding_rule>(values) * 255.0f + 0.5f));
+        __builtin_memcpy(coverage + i, &bytes, sizeof(bytes));
+    }
+    return carry[0];
+}
+
+template<WindingRule winding_rule>
+static void rasterize_rows(CoverageRasterizer::UniformSpanCallback const& uniform_span, CoverageRasterizer::VaryingSpanCallback const& varying_span, IntRect const& bounds, int first_row, int row_count, float* cells, size_t stride, ReadonlySpan<bool> touched_tiles, Bytes coverage)
+{
+    int const tile_size = CoverageRasterizer::tile_size;
+    int const width = bounds.width();
+    int const tile_count = ceil_div(width, tile_size);
+
+    for (int row = 0; row < row_count; ++row) {
+        float* row_cells = cells + row * stride;
+        int const y = bounds.y() + first_row + row;
+        float sum = 0.0f;
+        int tile = 0;
+        while (tile < tile_count) {
+            bool const touched = touched_tiles[tile];
+            int end_tile = tile + 1;
+            while (end_tile < tile_count && touched_tiles[end_tile] == touched)
+                ++end_tile;
+            int const x = tile * tile_size;
+            int const end_x = min(end_tile * tile_size, width);
+
+            if (touched) {
+                sum = accumulate_cells<winding_rule>(row_cells + x, coverage.data() + x, (end_tile - tile) * tile_size, sum);
+                varying_span(y, bounds.x() + x, coverage.slice(x, end_x - x));
+            } else if (auto uniform_coverage = coverage_from_sum<winding_rule>(sum); uniform_coverage > 0) {
+                uniform_span(y, bounds.x() + x, end_x - x, uniform_coverage);
+            }
+            tile = end_tile;
+        }
+
+        // Lines on the right edge add to the cells past the last tile.
+        if (touched_tiles[tile_count])
+            __builtin_memset(row_cells + tile_count * tile_size, 0, tile_size * sizeof(float));
+    }
+}
+
+void CoverageRasterizer::rasterize(WindingRule winding_rule, UniformSpanCallback const& uniform_span, VaryingSpanCallback const& varying_span)
+{
+    if (m_bounds.is_empty())
+        return;
+
+    int const tile_count = ceil_div(m_bounds.width(), tile_size);
+    m_stride = (tile_count + 1) * tile_size;
+    m_cells.resize(m_stride * tile_size);
+    m_touched_tiles.resize(tile_count + 1);
+    m_coverage.resize(tile_count * tile_size);
+
+    for (size_t band = 0; band < m_bands.size(); ++band) {
+        auto& lines = m_bands[band];
+        if (lines.is_empty())
+            continue;
+
+        m_touched_tiles.span().fill(false);
+        for (auto const& line : lines) {
+            accumulate_line(line, m_cells.data());
+            // Lines add to the cells of the pixels they pass through, and one more.
+            int first_tile = static_cast<int>(min(line.from.x(), line.to.x())) / tile_size;
+            int last_tile = (static_cast<int>(max(line.from.x(), line.to.x())) + 1) / tile_size;
+            for (int tile = first_tile; tile <= min(last_tile, tile_count); ++tile)
+                m_touched_tiles[tile] = true;
+        }
+        lines.clear_with_capacity();
+
+        int const first_row = band * tile_size;
+        int const row_count = min(tile_size, m_bounds.height() - first_row);
+        if (winding_rule == WindingRule::EvenOdd)
+            rasterize_rows<WindingRule::EvenOdd>(uniform_span, varying_span, m_bounds, first_row, row_count, m_cells.data(), m_stride, m_touched_tiles, m_coverage);
+        else
+            rasterize_rows<WindingRule::Nonzero>(uniform_span, varying_span, m_bounds, first_row, row_count, m_cells.data(), m_stride, m_touched_tiles, m_coverage);
+    }
+}
+
+}
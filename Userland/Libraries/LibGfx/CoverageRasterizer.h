@@ -0,0 +1,73 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Function.h>
+#include <AK/Span.h>
+#include <AK/Vector.h>
+#include <LibGfx/Forward.h>
+#include <LibGfx/Point.h>
+#include <LibGfx/Rect.h>
+
+namespace Gfx {
+
+enum class WindingRule {
+    Nonzero,
+    EvenOdd,
+};
+
+// Rasterizes outlines with analytic anti-aliasing, for filling paths, stroking them and drawing glyphs.
+//
+// Every line adds the area it covers in each pixel to an accumulation buffer, with its sign depending on whether the
+// line goes up or down. Adding up a row of that buffer from left to right gives the coverage of each pixel. The lines
+// are binned into bands of `tile_size` rows. Only the tiles of a band that lines pass through get accumulated, all
+// pixels in between them are covered the same.
+class CoverageRasterizer {
+public:
+    static constexpr int tile_size = 16;
+
+    // Only the pixels inside `bounds` get rasterized, but lines to their left still cover them.
+    explicit CoverageRasterizer(IntRect const& bounds);
+
+    IntRect const& bounds() const { return m_bounds; }
+
+    void add_line(FloatPoint from, FloatPoint to);
+    // Adds each subpath of the path as a closed outline, the way filling it would.
+    void add_path(Path const&, FloatPoint offset = {});
+    void add_polygon(ReadonlySpan<FloatPoint>);
+
+    using UniformSpanCallback = Function<void(int y, int x, int length, u8 coverage)>;
+    using VaryingSpanCallback = Function<void(int y, int x, ReadonlyBytes coverage)>;
+
+    // Calls `uniform_span` for runs of pixels in a row that are all covered the same, and `varying_span` for the others.
+    // Pixels that aren't covered at all may be left out. The lines are gone afterwards.
+    void rasterize(WindingRule, UniformSpanCallback const& uniform_span, VaryingSpanCallback const& varying_span);
+
+private:
+    // A line within one band, relative to the top left of that band.
+    struct Line {
+        FloatPoint from;
+        FloatPoint to;
+    };
+
+    void add_line_inside_rows(FloatPoint from, FloatPoint to);
+    void add_line_to_bands(FloatPoint from, FloatPoint to);
+    void append_to_band(int band, Line const&);
+    void accumulate_line(Line const&, float* cells) const;
+
+    IntRect m_bounds;
+    Vector<Vector<Line>> m_bands;
+
+    // The accumulation buffer has room for one more tile than a row needs, since lines at the right edge of the
+    // bounds add to the two cells after their pixel.
+    size_t m_stride { 0 };
+    Vector<float> m_cells;
+    Vector<bool> m_touched_tiles;
+    Vector<u8> m_coverage;
+};
+
+}
@@ -10,6 +10,7 @@
 #include <LibGfx/Color.h>
 #include <LibGfx/Painter.h>
 #include <LibGfx/Path.h>
+#include <LibGfx/PixelKernels.h>
 
 #if defined(AK_COMPILER_GCC)
 #    pragma GCC optimize("O3")
@@ -17,63 +18,20 @@
 
 namespace Gfx {
 
-template<typename T, typename TColorOrFunction>
-ALWAYS_INLINE void Painter::draw_scanline_for_fill_path(int y, T x_start, T x_end, TColorOrFunction color)
+template<typename TColorOrFunction>
+ALWAYS_INLINE void Painter::draw_scanline_for_fill_path(int y, int x_start, int x_end, TColorOrFunction color)
 {
     // Fill path should scale the scanlines before calling this.
     VERIFY(scale() == 1);
 
-    constexpr bool is_floating_point = IsSameIgnoringCV<T, float>;
     constexpr bool has_constant_color = IsSameIgnoringCV<TColorOrFunction, Color>;
 
-    int x1 = 0;
-    int x2 = 0;
-    u8 left_subpixel_alpha = 0;
-    u8 right_subpixel_alpha = 0;
-    if constexpr (is_floating_point) {
-        x1 = ceilf(x_start);
-        x2 = floorf(x_end);
-        left_subpixel_alpha = (x1 - x_start) * 255;
-        right_subpixel_alpha = (x_end - x2) * 255;
-        x1 -= left_subpixel_alpha > 0;
-        x2 += right_subpixel_alpha > 0;
-    } else {
-        x1 = x_start;
-        x2 = x_end;
-    }
-
-    IntRect scanline(x1, y, x2 - x1, 1);
+    IntRect scanline(x_start, y, x_end - x_start, 1);
     scanline = scanline.translated(translation());
     auto clipped = scanline.intersected(clip_rect());
     if (clipped.is_empty())
         return;
 
-    auto get_color = [&](int offset) {
-        if constexpr (has_constant_color) {
-            return color;
-        } else {
-            return color(offset);
-        }
-    };
-
-    if constexpr (is_floating_point) {
-        // Paint left and right subpixels (then remove them from the scanline).
-        auto get_color_with_alpha = [&](int offset, u8 alpha) {
-            auto color_at_offset = get_color(offset);
-            u8 color_alpha = (alpha * color_at_offset.alpha()) / 255;
-            return color_at_offset.with_alpha(color_alpha);
-        };
-        bool paint_left_subpixel = clipped.left() == scanline.left() && left_subpixel_alpha;
-        bool paint_right_subpixel = clipped.right() == scanline.right() && right_subpixel_alpha;
-        if (paint_left_subpixel)
-            set_physical_pixel(clipped.top_left(), get_color_with_alpha(0, left_subpixel_alpha), true);
-        if (paint_right_subpixel)
-            set_physical_pixel(clipped.top_right(), get_color_with_alpha(scanline.width(), right_subpixel_alpha), true);
-        clipped.shrink(0, paint_right_subpixel, 0, paint_left_subpixel);
-        if (clipped.is_empty())
-            return;
-    }
-
     if constexpr (has_constant_color) {
         if (color.alpha() == 255) {
             // Speedy path: Constant color and no alpha blending.
@@ -83,7 +41,10 @@ ALWAYS_INLINE void Painter::draw_scanline_for_fill_path(int y, T x_start, T x_en
     }
 
     for (int x = clipped.x(); x <= clipped.right(); x++) {
-        set_physical_pixel({ x, clipped.y() }, get_color(x - scanline.x()), true);
+        if constexpr (has_constant_color)
+            set_physical_pixel({ x, clipped.y() }, color, true);
+        else
+            set_physical_pixel({ x, clipped.y() }, color(x - scanline.x()), true);
     }
 }
 
@@ -109,21 +70,15 @@ ALWAYS_INLINE void Painter::draw_scanline_for_fill_path(int y, T x_start, T x_en
         from.set_x(previous_to.value().x());
 }
 
-template<Painter::FillPathMode fill_path_mode, typename ColorOrFunction>
-void Painter::fill_path_impl(Path const& path, ColorOrFunction color, Gfx::Painter::WindingRule winding_rule, Optional<FloatPoint> offset)
+template<typename ColorOrFunction>
+void Painter::fill_path_impl(Path const& path, ColorOrFunction color, Gfx::Painter::WindingRule winding_rule)
 {
-    using GridCoordinateType = Conditional<fill_path_mode == FillPathMode::PlaceOnIntGrid, int, float>;
+    using GridCoordinateType = int;
     using PointType = Point<GridCoordinateType>;
 
     auto draw_scanline = [&](int y, GridCoordinateType x1, GridCoordinateType x2) {
-        const auto draw_offset = offset.value_or({ 0, 0 });
         // Note: .to_floored() is used here to be consistent with enclosing_int_rect()
-        const auto draw_origin = (path.bounding_box().top_left() + draw_offset).to_floored<int>();
-        // FIMXE: Offset is added here to handle floating point translations in the AA painter,
-        // really this should be done there but this function is a bit too specialised.
-        y = floorf(y + draw_offset.y());
-        x1 += draw_offset.x();
-        x2 += draw_offset.x();
+        const auto draw_origin = path.bounding_box().top_left().to_floored<int>();
         if (x1 > x2)
             swap(x1, x2);
         if constexpr (IsSameIgnoringCV<ColorOrFunction, Color>) {
@@ -191,7 +146,7 @@ void Painter::fill_path_impl(Path const& path, ColorOrFunction color, Gfx::Paint
             quick_sort(active_list, [](auto const& line0, auto const& line1) {
                 return line1.x < line0.x;
             });
-            if constexpr (fill_path_mode == FillPathMode::PlaceOnIntGrid && FILL_PATH_DEBUG) {
+            if constexpr (FILL_PATH_DEBUG) {
                 if ((int)scanline % 10 == 0) {
                     draw_text(Gfx::Rect<GridCoordinateType>(active_list.last().x - 20, scanline, 20, 10), DeprecatedString::number((int)scanline));
                 }
@@ -206,12 +161,7 @@ void Painter::fill_path_impl(Path const& path, ColorOrFunction color, Gfx::Paint
                     PointType from, to;
                     PointType truncated_from { previous.x, scanline };
                     PointType truncated_to { current.x, scanline };
-                    if constexpr (fill_path_mode == FillPathMode::PlaceOnIntGrid) {
-                        approximately_place_on_int_grid({ previous.x, scanline }, { current.x, scanline }, from, to, previous_to);
-                    } else {
-                        from = truncated_from;
-                        to = truncated_to;
-                    }
+                    approximately_place_on_int_grid({ previous.x, scanline }, { current.x, scanline }, from, to, previous_to);
 
                     if (is_inside_shape(winding_number)) {
                         // The points between this segment and the previous are
@@ -272,28 +222,92 @@ void Painter::fill_path_impl(Path const& path, ColorOrFunction color, Gfx::Paint
 void Painter::fill_path(Path const& path, Color color, WindingRule winding_rule)
 {
     VERIFY(scale() == 1); // FIXME: Add scaling support.
-    fill_path_impl<FillPathMode::PlaceOnIntGrid>(path, color, winding_rule);
+    fill_path_impl(path, color, winding_rule);
 }
 
 void Painter::fill_path(Path const& path, PaintStyle const& paint_style, Painter::WindingRule rule)
 {
     VERIFY(scale() == 1); // FIXME: Add scaling support.
     paint_style.paint(enclosing_int_rect(path.bounding_box()), [&](PaintStyle::SamplerFunction sampler) {
-        fill_path_impl<FillPathMode::PlaceOnIntGrid>(path, move(sampler), rule);
+        fill_path_impl(path, move(sampler), rule);
     });
 }
 
+void Painter::fill_coverage(CoverageRasterizer& rasterizer, WindingRule winding_rule, Color color)
+{
+    if (color.alpha() == 0)
+        return;
+
+    auto destination = m_target->has_alpha_channel() ? PixelKernels::Destination::HasAlpha : PixelKernels::Destination::Opaque;
+    rasterizer.rasterize(
+        winding_rule,
+        [&](int y, int x, int length, u8 coverage) {
+            auto* dst = m_target->scanline(y) + x;
+            if (coverage == 255 && color.alpha() == 255)
+                fast_u32_fill(dst, color.value(), length);
+            else
+                PixelKernels::blend(dst, color.with_alpha(color.alpha() * coverage / 255), length, destination);
+        },
+        [&](int y, int x, ReadonlyBytes coverage) {
+            // The coverage becomes the alpha of a white source, that blend_multiplied() tints with the color.
+            ARGB32 chunk[CoverageRasterizer::tile_size * 16];
+            auto* dst = m_target->scanline(y) + x;
+            for (size_t offset = 0; offset < coverage.size(); offset += array_size(chunk)) {
+                auto length = min(array_size(chunk), coverage.size() - offset);
+                for (size_t i = 0; i < length; ++i)
+                    chunk[i] = (static_cast<ARGB32>(coverage[offset + i]) << 24) | 0xffffff;
+                PixelKernels::blend_multiplied(dst + offset, chunk, color, length);
+            }
+        });
+}
+
+void Painter::fill_coverage(CoverageRasterizer& rasterizer, WindingRule winding_rule, PaintStyle::SamplerFunction const& sampler, IntPoint sampler_origin)
+{
+    auto destination = m_target->has_alpha_channel() ? PixelKernels::Destination::HasAlpha : PixelKernels::Destination::Opaque;
+    ARGB32 chunk[CoverageRasterizer::tile_size * 16];
+    auto blend_span = [&](int y, int x, int length, auto coverage_at) {
+        auto* dst = m_target->scanline(y) + x;
+        for (int offset = 0; offset < length; offset += array_size(chunk)) {
+            auto chunk_length = min<int>(array_size(chunk), length - offset);
+            for (int i = 0; i < chunk_length; ++i) {
+                auto color = sampler(IntPoint { x + offset + i, y } - sampler_origin);
+                chunk[i] = color.with_alpha(color.alpha() * coverage_at(offset + i) / 255).value();
+            }
+            PixelKernels::blend(dst + offset, chunk, chunk_length, destination);
+        }
+    };
+    rasterizer.rasterize(
+        winding_rule,
+        [&](int y, int x, int length, u8 coverage) {
+            blend_span(y, x, length, [&](int) { return coverage; });
+        },
+        [&](int y, int x, ReadonlyBytes coverage) {
+            blend_span(y, x, coverage.size(), [&](int i) { return coverage[i]; });
+        });
+}
+
+// The outline is rasterized with analytic coverage, within the part of its bounding box that is not clipped away.
 void Painter::antialiased_fill_path(Path const& path, Color color, WindingRule rule, FloatPoint translation)
 {
     VERIFY(scale() == 1); // FIXME: Add scaling support.
-    fill_path_impl<FillPathMode::AllowFloatingPoints>(path, color, rule, translation);
+    auto offset = translation + this->translation().to_type<float>();
+    CoverageRasterizer rasterizer(enclosing_int_rect(path.bounding_box().translated(offset)).intersected(clip_rect()));
+    rasterizer.add_path(path, offset);
+    fill_coverage(rasterizer, rule, color);
 }
 
 void Painter::antialiased_fill_path(Path const& path, PaintStyle const& paint_style, WindingRule rule, FloatPoint translation)
 {
     VERIFY(scale() == 1); // FIXME: Add scaling support.
+    auto offset = translation + this->translation().to_type<float>();
+    CoverageRasterizer rasterizer(enclosing_int_rect(path.bounding_box().translated(offset)).intersected(clip_rect()));
+    if (rasterizer.bounds().is_empty())
+        return;
+    rasterizer.add_path(path, offset);
+    // Note: .to_floored() is used here to be consistent with enclosing_int_rect()
+    auto sampler_origin = (path.bounding_box().top_left() + offset).to_floored<int>();
     paint_style.paint(enclosing_int_rect(path.bounding_box()), [&](PaintStyle::SamplerFunction sampler) {
-        fill_path_impl<FillPathMode::AllowFloatingPoints>(path, move(sampler), rule, translation);
+        fill_coverage(rasterizer, rule, sampler, sampler_origin);
     });
 }
 
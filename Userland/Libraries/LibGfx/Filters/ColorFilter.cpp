@@ -0,0 +1,57 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Vector.h>
+#include <LibGfx/Filters/ColorFilter.h>
+#include <LibGfx/HelperThreads.h>
+
+namespace Gfx {
+
+void ColorFilter::apply_filters(Bitmap& target_bitmap, IntRect const& target_rect, Bitmap const& source_bitmap, IntRect const& source_rect, ReadonlySpan<ColorFilter*> filters)
+{
+    VERIFY(source_rect.size() == target_rect.size());
+    VERIFY(target_bitmap.rect().contains(target_rect));
+    VERIFY(source_bitmap.rect().contains(source_rect));
+
+    auto is_32_bit = [](BitmapFormat format) {
+        return format == BitmapFormat::BGRx8888 || format == BitmapFormat::BGRA8888;
+    };
+    bool const source_has_alpha = source_bitmap.format() == BitmapFormat::BGRA8888;
+    bool const can_access_rows_directly = is_32_bit(source_bitmap.format()) && is_32_bit(target_bitmap.format());
+
+    for_each_band_of_lines(source_rect.height(), source_rect.width(), [&](int first_row, int end_row) {
+        Vector<Color, 1024> colors;
+        colors.resize(source_rect.width());
+
+        for (auto y = first_row; y < end_row; ++y) {
+            int const source_y = y + source_rect.y();
+            int const target_y = y + target_rect.y();
+
+            if (can_access_rows_directly) {
+                auto const* source_row = source_bitmap.scanline(source_y) + source_rect.x();
+                for (auto x = 0; x < source_rect.width(); ++x)
+                    colors[x] = source_has_alpha ? Color::from_argb(source_row[x]) : Color::from_rgb(source_row[x]);
+            } else {
+                for (auto x = 0; x < source_rect.width(); ++x)
+                    colors[x] = source_bitmap.get_pixel(x + source_rect.x(), source_y);
+            }
+
+            for (auto* filter : filters)
+                filter->convert_colors(colors.span());
+
+            if (can_access_rows_directly) {
+                auto* target_row = target_bitmap.scanline(target_y) + target_rect.x();
+                for (auto x = 0; x < source_rect.width(); ++x)
+                    target_row[x] = colors[x].value();
+            } else {
+                for (auto x = 0; x < source_rect.width(); ++x)
+                    target_bitmap.set_pixel(x + target_rect.x(), target_y, colors[x]);
+            }
+        }
+    });
+}
+
+}
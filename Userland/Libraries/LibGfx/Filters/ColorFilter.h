@@ -7,6 +7,7 @@
 #pragma once
 
 #include "Filter.h"
+#include <AK/Span.h>
 
 namespace Gfx {
 
@@ -26,23 +27,23 @@ public:
 
     virtual void apply(Bitmap& target_bitmap, IntRect const& target_rect, Bitmap const& source_bitmap, IntRect const& source_rect) override
     {
-        VERIFY(source_rect.size() == target_rect.size());
-        VERIFY(target_bitmap.rect().contains(target_rect));
-        VERIFY(source_bitmap.rect().contains(source_rect));
-
-        for (auto y = 0; y < source_rect.height(); ++y) {
-            ssize_t source_y = y + source_rect.y();
-            ssize_t target_y = y + target_rect.y();
-            for (auto x = 0; x < source_rect.width(); ++x) {
-                ssize_t source_x = x + source_rect.x();
-                ssize_t target_x = x + target_rect.x();
-
-                auto source_pixel = source_bitmap.get_pixel(source_x, source_y);
-                auto target_color = convert_color(source_pixel);
-
-                target_bitmap.set_pixel(target_x, target_y, m_amount < 1.0f && !amount_handled_in_filter() ? source_pixel.mixed_with(target_color, m_amount) : target_color);
-            }
+        ColorFilter* filters[] = { this };
+        apply_filters(target_bitmap, target_rect, source_bitmap, source_rect, filters);
+    }
+
+    // Applies each of the filters in turn, but only reads and writes every pixel once.
+    static void apply_filters(Bitmap& target_bitmap, IntRect const& target_rect, Bitmap const& source_bitmap, IntRect const& source_rect, ReadonlySpan<ColorFilter*> filters);
+
+    // Converts a row of colors in place. This may be called from several threads at once.
+    virtual void convert_colors(Span<Color> colors)
+    {
+        if (m_amount < 1.0f && !amount_handled_in_filter()) {
+            for (auto& color : colors)
+                color = color.mixed_with(convert_color(color), m_amount);
+            return;
         }
+        for (auto& color : colors)
+            color = convert_color(color);
     }
 
 protected:
@@ -0,0 +1,50 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/NonnullOwnPtr.h>
+#include <AK/StringView.h>
+#include <AK/Vector.h>
+#include <LibGfx/Filters/ColorFilter.h>
+
+namespace Gfx {
+
+// Applies a list of color filters in one pass over the bitmap, rather than one pass per filter.
+class ColorFilterChain final : public Filter {
+public:
+    ColorFilterChain() = default;
+    virtual ~ColorFilterChain() = default;
+
+    virtual StringView class_name() const override { return "ColorFilterChain"sv; }
+
+    void append(NonnullOwnPtr<ColorFilter> filter)
+    {
+        m_filter_pointers.append(filter.ptr());
+        m_filters.append(move(filter));
+    }
+
+    bool is_empty() const { return m_filters.is_empty(); }
+
+    void clear()
+    {
+        m_filter_pointers.clear();
+        m_filters.clear();
+    }
+
+    virtual void apply(Bitmap& target_bitmap, IntRect const& target_rect, Bitmap const& source_bitmap, IntRect const& source_rect) override
+    {
+        if (is_empty())
+            return;
+        ColorFilter::apply_filters(target_bitmap, target_rect, source_bitmap, source_rect, m_filter_pointers);
+    }
+
+private:
+    Vector<NonnullOwnPtr<ColorFilter>> m_filters;
+    Vector<ColorFilter*> m_filter_pointers;
+};
+
+}
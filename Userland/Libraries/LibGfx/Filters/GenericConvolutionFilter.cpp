@@ -0,0 +1,114 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/BitCast.h>
+#include <AK/SIMDExtras.h>
+#include <AK/SIMDMath.h>
+#include <AK/Vector.h>
+#include <LibGfx/Filters/GenericConvolutionFilter.h>
+#include <LibGfx/HelperThreads.h>
+
+#pragma GCC diagnostic ignored "-Wpsabi"
+
+namespace Gfx::Detail {
+
+using namespace AK::SIMD;
+
+// Returns the line of the bitmap to read for `line`, or -1 if that line doesn't contribute to the result.
+static int resolve_line(int line, int first_line, int last_line, int bitmap_size, bool should_wrap)
+{
+    if (line < first_line || line > last_line) {
+        if (!should_wrap)
+            return -1;
+        // FIXME: Wrap around inside the source rect rather than the whole bitmap.
+        line = (line + bitmap_size) % bitmap_size;
+    }
+    if (line < 0 || line >= bitmap_size)
+        return -1;
+    return line;
+}
+
+void apply_convolution(Bitmap& output, IntPoint output_position, IntRect const& target_rect, Bitmap const& source, IntRect const& source_rect, ReadonlySpan<float> kernel, int kernel_size, bool should_wrap)
+{
+    VERIFY(source.format() == BitmapFormat::BGRx8888 || source.format() == BitmapFormat::BGRA8888);
+    VERIFY(output.format() == BitmapFormat::BGRx8888 || output.format() == BitmapFormat::BGRA8888);
+    VERIFY(kernel.size() == static_cast<size_t>(kernel_size * kernel_size));
+
+    int const offset = kernel_size / 2;
+    int const width = target_rect.width();
+    u32 const alpha_mask = source.format() == BitmapFormat::BGRx8888 ? 0xff000000 : 0;
+
+    // The kernel is stored column by column, but rows of the bitmap are quicker to read one after the other.
+    Vector<float, 49> weights;
+    weights.resize(kernel_size * kernel_size);
+    for (int k = 0; k < kernel_size; ++k) {
+        for (int l = 0; l < kernel_size; ++l)
+            weights[l * kernel_size + k] = kernel[k * kernel_size + l];
+    }
+
+    // The source column that kernel column k reads for target column x is at column_indices[k * width + x].
+    Vector<int> column_indices;
+    column_indices.resize(kernel_size * width);
+    for (int k = 0; k < kernel_size; ++k) {
+        for (int x = 0; x < width; ++x)
+            column_indices[k * width + x] = resolve_line(target_rect.x() + x + k - offset, source_rect.x(), source_rect.right(), source.width(), should_wrap);
+    }
+
+    // Away from the edges of the source rect, every pixel reads the kernel_size columns around it.
+    int const interior_begin = clamp(source_rect.x() + offset - target_rect.x(), 0, width);
+    int const interior_end = clamp(source_rect.right() - offset - target_rect.x() + 1, interior_begin, width);
+
+    for_each_band_of_lines(target_rect.height(), width * kernel_size, [&](int first_row, int end_row) {
+        Vector<ARGB32 const*, 8> source_rows;
+        source_rows.resize(kernel_size);
+
+        for (int y = first_row; y < end_row; ++y) {
+            int const target_y = target_rect.y() + y;
+            for (int l = 0; l < kernel_size; ++l) {
+                auto source_y = resolve_line(target_y + l - offset, source_rect.y(), source_rect.bottom(), source.height(), should_wrap);
+                source_rows[l] = source_y >= 0 ? source.scanline(source_y) : nullptr;
+            }
+
+            auto const* center_row = source.scanline(target_y) + target_rect.x();
+            auto* output_row = output.scanline(output_position.y() + y) + output_position.x();
+
+            auto convolve_pixel = [&](int x, auto column_for_kernel_column) {
+                f32x4 sum {};
+                for (int l = 0; l < kernel_size; ++l) {
+                    auto const* source_row = source_rows[l];
+                    if (!source_row)
+                        continue;
+                    auto const* row_weights = &weights[l * kernel_size];
+                    for (int k = 0; k < kernel_size; ++k) {
+                        auto source_x = column_for_kernel_column(k);
+                        if (source_x < 0)
+                            continue;
+                        sum += to_f32x4(bit_cast<u8x4>(source_row[source_x])) * row_weights[k];
+                    }
+                }
+
+                // Truncate the clamped sums like the Color constructor does, and keep the alpha of the center pixel.
+                auto const rgb = bit_cast<u32>(to_u8x4(to_i32x4(clamp(sum, 0.0f, 255.0f)))) & 0x00ffffff;
+                output_row[x] = rgb | ((center_row[x] | alpha_mask) & 0xff000000);
+            };
+
+            auto convolve_edge_pixel = [&](int x) {
+                convolve_pixel(x, [&](int k) { return column_indices[k * width + x]; });
+            };
+
+            for (int x = 0; x < interior_begin; ++x)
+                convolve_edge_pixel(x);
+            for (int x = interior_begin; x < interior_end; ++x) {
+                int const first_column = target_rect.x() + x - offset;
+                convolve_pixel(x, [&](int k) { return first_column + k; });
+            }
+            for (int x = interior_end; x < width; ++x)
+                convolve_edge_pixel(x);
+        }
+    });
+}
+
+}
@@ -7,12 +7,20 @@
 #pragma once
 
 #include "Filter.h"
+#include <AK/Span.h>
 #include <AK/StringView.h>
 #include <LibGfx/Matrix.h>
 #include <LibGfx/Matrix4x4.h>
 
 namespace Gfx {
 
+namespace Detail {
+
+// Writes the convolved pixels of target_rect to output, starting at output_position.
+void apply_convolution(Bitmap& output, IntPoint output_position, IntRect const& target_rect, Bitmap const& source, IntRect const& source_rect, ReadonlySpan<float> kernel, int kernel_size, bool should_wrap);
+
+}
+
 template<size_t N, typename T>
 static constexpr void normalize(Matrix<N, T>& matrix)
 {
@@ -73,7 +81,7 @@ public:
         apply_with_cache(target_bitmap, target_rect, source_bitmap, source_rect, gcf_params, apply_cache);
     }
 
-    void apply_with_cache(Bitmap& target, IntRect target_rect, Bitmap const& source, IntRect const& source_rect, GenericConvolutionFilter::Parameters const& parameters, ApplyCache& apply_cache)
+    void apply_with_cache(Bitmap& target, IntRect const& target_rect, Bitmap const& source, IntRect const& source_rect, GenericConvolutionFilter::Parameters const& parameters, ApplyCache& apply_cache)
     {
         // The target area (where the filter is applied) must be entirely
         // contained by the source area. source_rect should be describing
@@ -90,64 +98,23 @@ public:
         // is applied on multiple areas of the same bitmap, at which point
         // we would need to be able to access unmodified pixels if the
         // areas are (almost) adjacent.
-        int source_delta_x = target_rect.x() - source_rect.x();
-        int source_delta_y = target_rect.y() - source_rect.y();
-        if (&target == &source && (!apply_cache.m_target || !apply_cache.m_target->size().contains(source_rect.size()))) {
-            // TODO: We probably don't need the entire source_rect, we could inflate
-            // the target_rect appropriately
-            apply_cache.m_target = Gfx::Bitmap::create(source.format(), source_rect.size()).release_value_but_fixme_should_propagate_errors();
-            target_rect.translate_by(-target_rect.location());
+        if (&target != &source) {
+            Detail::apply_convolution(target, target_rect.location(), target_rect, source, source_rect, kernel_span(parameters), N, parameters.should_wrap());
+            return;
         }
 
-        Bitmap* render_target_bitmap = (&target != &source) ? &target : apply_cache.m_target.ptr();
-
-        // FIXME: Help! I am naive!
-        constexpr static ssize_t offset = N / 2;
-        for (auto i_ = 0; i_ < target_rect.width(); ++i_) {
-            ssize_t i = i_ + target_rect.x();
-            for (auto j_ = 0; j_ < target_rect.height(); ++j_) {
-                ssize_t j = j_ + target_rect.y();
-                FloatVector3 value(0, 0, 0);
-                for (auto k = 0l; k < (ssize_t)N; ++k) {
-                    auto ki = i + k - offset;
-                    if (ki < source_rect.x() || ki > source_rect.right()) {
-                        if (parameters.should_wrap())
-                            ki = (ki + source.size().width()) % source.size().width(); // TODO: fix up using source_rect
-                        else
-                            continue;
-                    }
-
-                    for (auto l = 0l; l < (ssize_t)N; ++l) {
-                        auto lj = j + l - offset;
-                        if (lj < source_rect.y() || lj > source_rect.bottom()) {
-                            if (parameters.should_wrap())
-                                lj = (lj + source.size().height()) % source.size().height(); // TODO: fix up using source_rect
-                            else
-                                continue;
-                        }
-
-                        auto pixel = source.get_pixel(ki, lj);
-                        FloatVector3 pixel_value(pixel.red(), pixel.green(), pixel.blue());
-
-                        value = value + pixel_value * parameters.kernel().elements()[k][l];
-                    }
-                }
-
-                value.clamp(0, 255);
-                render_target_bitmap->set_pixel(i, j, Color(value.x(), value.y(), value.z(), source.get_pixel(i + source_delta_x, j + source_delta_y).alpha()));
-            }
-        }
+        if (!apply_cache.m_target || !apply_cache.m_target->size().contains(target_rect.size()))
+            apply_cache.m_target = Gfx::Bitmap::create(source.format(), target_rect.size()).release_value_but_fixme_should_propagate_errors();
 
-        if (render_target_bitmap != &target) {
-            // FIXME: Substitute for some sort of faster "blit" method.
-            for (auto i_ = 0; i_ < target_rect.width(); ++i_) {
-                auto i = i_ + target_rect.x();
-                for (auto j_ = 0; j_ < target_rect.height(); ++j_) {
-                    auto j = j_ + target_rect.y();
-                    target.set_pixel(i, j, render_target_bitmap->get_pixel(i_, j_));
-                }
-            }
-        }
+        Detail::apply_convolution(*apply_cache.m_target, {}, target_rect, source, source_rect, kernel_span(parameters), N, parameters.should_wrap());
+        for (auto y = 0; y < target_rect.height(); ++y)
+            __builtin_memcpy(target.scanline(target_rect.y() + y) + target_rect.x(), apply_cache.m_target->scanline(y), target_rect.width() * sizeof(ARGB32));
+    }
+
+private:
+    static ReadonlySpan<float> kernel_span(GenericConvolutionFilter::Parameters const& parameters)
+    {
+        return { &parameters.kernel().elements()[0][0], N * N };
     }
 };
 
@@ -0,0 +1,42 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/BitCast.h>
+#include <AK/SIMDExtras.h>
+#include <AK/SIMDMath.h>
+#include <LibGfx/Filters/MatrixFilter.h>
+
+#pragma GCC diagnostic ignored "-Wpsabi"
+
+namespace Gfx {
+
+using namespace AK::SIMD;
+
+void MatrixFilter::convert_colors(Span<Color> colors)
+{
+    if (m_amount < 1.0f && !amount_handled_in_filter()) {
+        ColorFilter::convert_colors(colors);
+        return;
+    }
+
+    // The vector lanes are in memory order (blue, green, red, alpha), so each of these holds one column of the matrix.
+    auto const& elements = m_operation.elements();
+    f32x4 const red_column { elements[2][0], elements[1][0], elements[0][0], 0 };
+    f32x4 const green_column { elements[2][1], elements[1][1], elements[0][1], 0 };
+    f32x4 const blue_column { elements[2][2], elements[1][2], elements[0][2], 0 };
+
+    for (auto& color : colors) {
+        auto const value = color.value();
+        auto const channels = to_f32x4(bit_cast<u8x4>(value));
+        auto const product = channels[2] * red_column + channels[1] * green_column + channels[0] * blue_column;
+
+        // Clamping before truncating gives the same channels as convert_color(), which does it the other way around.
+        auto const converted = to_u8x4(to_i32x4(clamp(product, 0.0f, 255.0f)));
+        color = Color::from_argb((bit_cast<u32>(converted) & 0x00ffffff) | (value & 0xff000000));
+    }
+}
+
+}
@@ -19,6 +19,8 @@ public:
     {
     }
 
+    virtual void convert_colors(Span<Color>) override;
+
 protected:
     Color convert_color(Color original) override
     {
@@ -10,13 +10,20 @@
 #endif
 
 #include <AK/Array.h>
+#include <AK/BitCast.h>
+#include <AK/FixedArray.h>
 #include <AK/IntegralMath.h>
 #include <AK/Math.h>
-#include <AK/Vector.h>
+#include <AK/SIMDExtras.h>
 #include <LibGfx/Filters/StackBlurFilter.h>
+#include <LibGfx/HelperThreads.h>
+
+#pragma GCC diagnostic ignored "-Wpsabi"
 
 namespace Gfx {
 
+using namespace AK::SIMD;
+
 using uint = unsigned;
 
 constexpr size_t MAX_RADIUS = 256;
@@ -42,23 +49,18 @@ constexpr auto mult_table = [] {
 // Note: This is named to be consistent with the algorithm, but it's actually a simple circular buffer.
 struct BlurStack {
     BlurStack(size_t size)
+        : m_data(FixedArray<u32x4>::must_create_but_fixme_should_propagate_errors(size))
     {
-        m_data.resize(size);
     }
 
     struct Iterator {
         friend BlurStack;
 
-        ALWAYS_INLINE Color& operator*()
+        ALWAYS_INLINE u32x4& operator*()
         {
             return m_data.at(m_idx);
         }
 
-        ALWAYS_INLINE Color* operator->()
-        {
-            return &m_data.at(m_idx);
-        }
-
         ALWAYS_INLINE Iterator operator++()
         {
             // Note: This seemed to profile slightly better than %
@@ -75,238 +77,118 @@ struct BlurStack {
         }
 
     private:
-        Iterator(size_t idx, Span<Color> data)
+        Iterator(size_t idx, Span<u32x4> data)
             : m_idx(idx)
             , m_data(data)
         {
         }
 
         size_t m_idx;
-        Span<Color> m_data;
+        Span<u32x4> m_data;
     };
 
     Iterator iterator_from_position(size_t position)
     {
         VERIFY(position < m_data.size());
-        return Iterator(position, m_data);
+        return Iterator(position, m_data.span());
     }
 
 private:
-    Vector<Color, 512> m_data;
+    FixedArray<u32x4> m_data;
 };
 
-// This is an implementation of StackBlur by Mario Klingemann (https://observablehq.com/@jobleonard/mario-klingemans-stackblur)
-// (Link is to a secondary source as the original site is now down)
-FLATTEN void StackBlurFilter::process_rgba(u8 radius, Color fill_color)
+// Blurs one row or column of `length` pixels in place, where pixel i is at pixels[i * stride].
+// The four channels of each pixel are summed at once, in the memory order of the pixel (blue, green, red, alpha).
+ALWAYS_INLINE static void blur_line(ARGB32* pixels, size_t stride, uint length, uint radius, ARGB32 fill_color, BlurStack& blur_stack)
 {
-    // TODO: Implement a plain RGB version of this (if required)
-
-    if (radius == 0)
-        return;
-
-    fill_color = fill_color.with_alpha(0);
-
-    uint width = m_bitmap.width();
-    uint height = m_bitmap.height();
-
-    uint div = 2 * radius + 1;
-    uint radius_plus_1 = radius + 1;
-    uint sum_factor = radius_plus_1 * (radius_plus_1 + 1) / 2;
-
-    auto get_pixel = [&](int x, int y) {
-        auto color = m_bitmap.get_pixel<StorageFormat::BGRA8888>(x, y);
-        if (color.alpha() == 0)
-            return fill_color;
-        return color;
-    };
+    uint const radius_plus_1 = radius + 1;
+    uint const sum_factor = radius_plus_1 * (radius_plus_1 + 1) / 2;
+    auto const sum_mult = mult_table[radius - 1];
+    auto const sum_shift = shift_table[radius - 1];
 
-    auto set_pixel = [&](int x, int y, Color color) {
-        return m_bitmap.set_pixel<StorageFormat::BGRA8888>(x, y, color);
+    auto get_pixel = [&](uint i) {
+        auto value = pixels[i * stride];
+        if ((value >> 24) == 0)
+            value = fill_color;
+        return to_u32x4(bit_cast<u8x4>(value));
     };
 
-    BlurStack blur_stack { div };
     auto const stack_start = blur_stack.iterator_from_position(0);
     auto const stack_end = blur_stack.iterator_from_position(radius_plus_1);
     auto stack_iterator = stack_start;
 
-    auto const sum_mult = mult_table[radius - 1];
-    auto const sum_shift = shift_table[radius - 1];
-
-    for (uint y = 0; y < height; y++) {
-        stack_iterator = stack_start;
-
-        auto color = get_pixel(0, y);
-        for (uint i = 0; i < radius_plus_1; i++)
-            *(stack_iterator++) = color;
-
-        // All the sums here work to approximate a gaussian.
-        // Note: Only about 17 bits are actually used in each sum.
-        uint red_in_sum = 0;
-        uint green_in_sum = 0;
-        uint blue_in_sum = 0;
-        uint alpha_in_sum = 0;
-        uint red_out_sum = radius_plus_1 * color.red();
-        uint green_out_sum = radius_plus_1 * color.green();
-        uint blue_out_sum = radius_plus_1 * color.blue();
-        uint alpha_out_sum = radius_plus_1 * color.alpha();
-        uint red_sum = sum_factor * color.red();
-        uint green_sum = sum_factor * color.green();
-        uint blue_sum = sum_factor * color.blue();
-        uint alpha_sum = sum_factor * color.alpha();
-
-        for (uint i = 1; i <= radius; i++) {
-            auto color = get_pixel(min(i, width - 1), y);
-
-            auto bias = radius_plus_1 - i;
-            *stack_iterator = color;
-            red_sum += color.red() * bias;
-            green_sum += color.green() * bias;
-            blue_sum += color.blue() * bias;
-            alpha_sum += color.alpha() * bias;
-
-            red_in_sum += color.red();
-            green_in_sum += color.green();
-            blue_in_sum += color.blue();
-            alpha_in_sum += color.alpha();
-
-            ++stack_iterator;
-        }
+    auto color = get_pixel(0);
+    for (uint i = 0; i < radius_plus_1; i++)
+        *(stack_iterator++) = color;
+
+    // All the sums here work to approximate a gaussian.
+    // Note: Only about 17 bits are actually used in each sum.
+    u32x4 in_sum {};
+    u32x4 out_sum = radius_plus_1 * color;
+    u32x4 sum = sum_factor * color;
+
+    for (uint i = 1; i <= radius; i++) {
+        auto color = get_pixel(min(i, length - 1));
+        *stack_iterator = color;
+        sum += color * (radius_plus_1 - i);
+        in_sum += color;
+        ++stack_iterator;
+    }
 
-        auto stack_in_iterator = stack_start;
-        auto stack_out_iterator = stack_end;
-
-        for (uint x = 0; x < width; x++) {
-            auto alpha = (alpha_sum * sum_mult) >> sum_shift;
-            if (alpha != 0)
-                set_pixel(x, y, Color((red_sum * sum_mult) >> sum_shift, (green_sum * sum_mult) >> sum_shift, (blue_sum * sum_mult) >> sum_shift, alpha));
-            else
-                set_pixel(x, y, fill_color);
-
-            red_sum -= red_out_sum;
-            green_sum -= green_out_sum;
-            blue_sum -= blue_out_sum;
-            alpha_sum -= alpha_out_sum;
-
-            red_out_sum -= stack_in_iterator->red();
-            green_out_sum -= stack_in_iterator->green();
-            blue_out_sum -= stack_in_iterator->blue();
-            alpha_out_sum -= stack_in_iterator->alpha();
-
-            auto color = get_pixel(min(x + radius_plus_1, width - 1), y);
-            *stack_in_iterator = color;
-            red_in_sum += color.red();
-            green_in_sum += color.green();
-            blue_in_sum += color.blue();
-            alpha_in_sum += color.alpha();
-
-            red_sum += red_in_sum;
-            green_sum += green_in_sum;
-            blue_sum += blue_in_sum;
-            alpha_sum += alpha_in_sum;
-
-            ++stack_in_iterator;
-
-            color = *stack_out_iterator;
-            red_out_sum += color.red();
-            green_out_sum += color.green();
-            blue_out_sum += color.blue();
-            alpha_out_sum += color.alpha();
-
-            red_in_sum -= color.red();
-            green_in_sum -= color.green();
-            blue_in_sum -= color.blue();
-            alpha_in_sum -= color.alpha();
-
-            ++stack_out_iterator;
-        }
+    auto stack_in_iterator = stack_start;
+    auto stack_out_iterator = stack_end;
+
+    for (uint i = 0; i < length; i++) {
+        auto const result = (sum * sum_mult) >> sum_shift;
+        if (result[3] != 0)
+            pixels[i * stride] = bit_cast<ARGB32>(to_u8x4(result));
+        else
+            pixels[i * stride] = fill_color;
+
+        sum -= out_sum;
+        out_sum -= *stack_in_iterator;
+
+        auto color = get_pixel(min(i + radius_plus_1, length - 1));
+        *stack_in_iterator = color;
+        in_sum += color;
+        sum += in_sum;
+        ++stack_in_iterator;
+
+        color = *stack_out_iterator;
+        out_sum += color;
+        in_sum -= color;
+        ++stack_out_iterator;
     }
+}
 
-    for (uint x = 0; x < width; x++) {
-        stack_iterator = stack_start;
-
-        auto color = get_pixel(x, 0);
-        for (uint i = 0; i < radius_plus_1; i++)
-            *(stack_iterator++) = color;
-
-        uint red_in_sum = 0;
-        uint green_in_sum = 0;
-        uint blue_in_sum = 0;
-        uint alpha_in_sum = 0;
-        uint red_out_sum = radius_plus_1 * color.red();
-        uint green_out_sum = radius_plus_1 * color.green();
-        uint blue_out_sum = radius_plus_1 * color.blue();
-        uint alpha_out_sum = radius_plus_1 * color.alpha();
-        uint red_sum = sum_factor * color.red();
-        uint green_sum = sum_factor * color.green();
-        uint blue_sum = sum_factor * color.blue();
-        uint alpha_sum = sum_factor * color.alpha();
-
-        for (uint i = 1; i <= radius; i++) {
-            auto color = get_pixel(x, min(i, height - 1));
-
-            auto bias = radius_plus_1 - i;
-            *stack_iterator = color;
-            red_sum += color.red() * bias;
-            green_sum += color.green() * bias;
-            blue_sum += color.blue() * bias;
-            alpha_sum += color.alpha() * bias;
-
-            red_in_sum += color.red();
-            green_in_sum += color.green();
-            blue_in_sum += color.blue();
-            alpha_in_sum += color.alpha();
-
-            ++stack_iterator;
-        }
+// This is an implementation of StackBlur by Mario Klingemann (https://observablehq.com/@jobleonard/mario-klingemans-stackblur)
+// (Link is to a secondary source as the original site is now down)
+FLATTEN void StackBlurFilter::process_rgba(u8 radius, Color fill_color)
+{
+    // TODO: Implement a plain RGB version of this (if required)
 
-        auto stack_in_iterator = stack_start;
-        auto stack_out_iterator = stack_end;
-
-        for (uint y = 0; y < height; y++) {
-            auto alpha = (alpha_sum * sum_mult) >> sum_shift;
-            if (alpha != 0)
-                set_pixel(x, y, Color((red_sum * sum_mult) >> sum_shift, (green_sum * sum_mult) >> sum_shift, (blue_sum * sum_mult) >> sum_shift, alpha));
-            else
-                set_pixel(x, y, fill_color);
-
-            red_sum -= red_out_sum;
-            green_sum -= green_out_sum;
-            blue_sum -= blue_out_sum;
-            alpha_sum -= alpha_out_sum;
-
-            red_out_sum -= stack_in_iterator->red();
-            green_out_sum -= stack_in_iterator->green();
-            blue_out_sum -= stack_in_iterator->blue();
-            alpha_out_sum -= stack_in_iterator->alpha();
-
-            auto color = get_pixel(x, min(y + radius_plus_1, height - 1));
-            *stack_in_iterator = color;
-            red_in_sum += color.red();
-            green_in_sum += color.green();
-            blue_in_sum += color.blue();
-            alpha_in_sum += color.alpha();
-
-            red_sum += red_in_sum;
-            green_sum += green_in_sum;
-            blue_sum += blue_in_sum;
-            alpha_sum += alpha_in_sum;
-
-            ++stack_in_iterator;
-
-            color = *stack_out_iterator;
-            red_out_sum += color.red();
-            green_out_sum += color.green();
-            blue_out_sum += color.blue();
-            alpha_out_sum += color.alpha();
-
-            red_in_sum -= color.red();
-            green_in_sum -= color.green();
-            blue_in_sum -= color.blue();
-            alpha_in_sum -= color.alpha();
-
-            ++stack_out_iterator;
-        }
-    }
+    if (radius == 0)
+        return;
+
+    auto const fill_value = fill_color.with_alpha(0).value();
+
+    int const width = m_bitmap.width();
+    int const height = m_bitmap.height();
+    size_t const pitch = m_bitmap.pitch() / sizeof(ARGB32);
+    uint const div = 2 * radius + 1;
+
+    // Every row (and then every column) is blurred on its own, so they can be shared between threads.
+    for_each_band_of_lines(height, width, [&](int first_row, int end_row) {
+        BlurStack blur_stack { div };
+        for (int y = first_row; y < end_row; y++)
+            blur_line(m_bitmap.scanline(y), 1, width, radius, fill_value, blur_stack);
+    });
+
+    for_each_band_of_lines(width, height, [&](int first_column, int end_column) {
+        BlurStack blur_stack { div };
+        for (int x = first_column; x < end_column; x++)
+            blur_line(m_bitmap.scanline(0) + x, pitch, height, radius, fill_value, blur_stack);
+    });
 }
 
 }
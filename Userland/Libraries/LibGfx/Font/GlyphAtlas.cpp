@@ -0,0 +1,187 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibGfx/Font/GlyphAtlas.h>
+
+namespace Gfx {
+
+// Keeps glyphs from touching each other, so that sampling one never picks up pixels from its neighbours.
+static constexpr int glyph_padding = 1;
+
+GlyphAtlas& GlyphAtlas::the()
+{
+    static GlyphAtlas s_the;
+    return s_the;
+}
+
+GlyphAtlas::Entry GlyphAtlas::ensure(Key const& key, Function<RefPtr<Bitmap>()> const& rasterize)
+{
+    if (auto it = m_glyphs.find(key); it != m_glyphs.end()) {
+        ++m_hits;
+        auto& glyph = it->value;
+        if (!glyph.page)
+            return {};
+        glyph.page->last_used = ++m_clock;
+        return { glyph.page->bitmap, glyph.rect };
+    }
+
+    ++m_misses;
+    auto bitmap = rasterize();
+    if (!bitmap || bitmap->size().is_empty()) {
+        m_glyphs.set(key, {});
+        return {};
+    }
+
+    auto glyph_or_error = add(key, *bitmap);
+    if (glyph_or_error.is_error()) {
+        // Not being able to cache a glyph shouldn't keep it from being drawn.
+        dbgln("GlyphAtlas: Failed to add glyph: {}", glyph_or_error.error());
+        return { bitmap, bitmap->rect() };
+    }
+    auto glyph = glyph_or_error.release_value();
+    return { glyph.page->bitmap, glyph.rect };
+}
+
+Optional<IntRect> GlyphAtlas::allocate_in_page(Page& page, IntSize size)
+{
+    int width = size.width() + glyph_padding;
+    int height = size.height() + glyph_padding;
+
+    for (auto& shelf : page.shelves) {
+        // Glyphs go onto shelves that fit them without wasting too much space above them.
+        if (shelf.height < height || shelf.height > height + height / 4 + 2)
+            continue;
+        if (shelf.next_x + width > page.bitmap->width())
+            continue;
+        IntRect rect { { shelf.next_x, shelf.y }, size };
+        shelf.next_x += width;
+        return rect;
+    }
+
+    if (page.next_shelf_y + height > page.bitmap->height())
+        return {};
+    page.shelves.append({ .y = page.next_shelf_y, .height = height, .next_x = width });
+    IntRect rect { { 0, page.next_shelf_y }, size };
+    page.next_shelf_y += height;
+    return rect;
+}
+
+ErrorOr<GlyphAtlas::Page*> GlyphAtlas::create_page(IntSize size, PageKind kind)
+{
+    auto page_bytes = Bitmap::size_in_bytes(Bitmap::minimum_pitch(size.width(), BitmapFormat::BGRA8888), size.height());
+    while (!m_pages.is_empty() && memory_used() + page_bytes > m_memory_budget)
+        evict_least_recently_used_page();
+
+    auto bitmap = TRY(Bitmap::create(BitmapFormat::BGRA8888, size));
+    bitmap->fill(Color::Transparent);
+    TRY(m_pages.try_append(TRY(adopt_nonnull_own_or_enomem(new (nothrow) Page { .bitmap = move(bitmap), .kind = kind }))));
+    return m_pages.last().ptr();
+}
+
+void GlyphAtlas::evict_least_recently_used_page()
+{
+    size_t least_recently_used = 0;
+    for (size_t i = 1; i < m_pages.size(); ++i) {
+        if (m_pages[i]->last_used < m_pages[least_recently_used]->last_used)
+            least_recently_used = i;
+    }
+
+    // The page's bitmap is never reused, so glyphs that are still being drawn from it stay intact.
+    auto& page = *m_pages[least_recently_used];
+    for (auto const& key : page.keys)
+        m_glyphs.remove(key);
+    ++m_evicted_pages;
+    m_evicted_glyphs += page.keys.size();
+    m_pages.remove(least_recently_used);
+}
+
+size_t GlyphAtlas::memory_used() const
+{
+    size_t memory_used = 0;
+    for (auto const& page : m_pages)
+        memory_used += page->bitmap->size_in_bytes();
+    return memory_used;
+}
+
+ErrorOr<GlyphAtlas::CachedGlyph> GlyphAtlas::add(Key const& key, Bitmap const& glyph)
+{
+    auto size = glyph.size();
+    Page* page = nullptr;
+    Optional<IntRect> rect;
+
+    if (size.width() > max_packed_glyph_size || size.height() > max_packed_glyph_size) {
+        page = TRY(create_page(size, PageKind::SingleGlyph));
+        rect = glyph.rect();
+    } else {
+        for (auto& candidate : m_pages.in_reverse()) {
+            if (candidate->kind != PageKind::Shared)
+                continue;
+            rect = allocate_in_page(*candidate, size);
+            if (rect.has_value()) {
+                page = candidate.ptr();
+                break;
+            }
+        }
+        if (!page) {
+            page = TRY(create_page({ page_size, page_size }, PageKind::Shared));
+            rect = allocate_in_page(*page, size);
+        }
+    }
+    VERIFY(rect.has_value());
+
+    TRY(page->keys.try_append(key));
+    for (int y = 0; y < size.height(); ++y) {
+        auto* destination = page->bitmap->scanline(rect->y() + y) + rect->x();
+        if (glyph.format() == BitmapFormat::BGRA8888) {
+            memcpy(destination, glyph.scanline(y), size.width() * sizeof(ARGB32));
+            continue;
+        }
+        for (int x = 0; x < size.width(); ++x)
+            destination[x] = glyph.get_pixel(x, y).value();
+    }
+
+    page->last_used = ++m_clock;
+    CachedGlyph cached_glyph { page, *rect };
+    TRY(m_glyphs.try_set(key, cached_glyph));
+    return cached_glyph;
+}
+
+void GlyphAtlas::set_memory_budget(size_t memory_budget)
+{
+    m_memory_budget = memory_budget;
+    while (!m_pages.is_empty() && memory_used() > m_memory_budget)
+        evict_least_recently_used_page();
+}
+
+GlyphAtlas::Statistics GlyphAtlas::statistics() const
+{
+    return {
+        .hits = m_hits,
+        .misses = m_misses,
+        .evicted_pages = m_evicted_pages,
+        .evicted_glyphs = m_evicted_glyphs,
+        .glyph_count = m_glyphs.size(),
+        .page_count = m_pages.size(),
+        .memory_used = memory_used(),
+        .memory_budget = m_memory_budget,
+    };
+}
+
+void GlyphAtlas::reset_statistics()
+{
+    m_hits = 0;
+    m_misses = 0;
+    m_evicted_pages = 0;
+    m_evicted_glyphs = 0;
+}
+
+void GlyphAtlas::clear()
+{
+    m_glyphs.clear();
+    m_pages.clear();
+}
+
+}
@@ -0,0 +1,132 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Function.h>
+#include <AK/HashMap.h>
+#include <AK/NonnullOwnPtr.h>
+#include <AK/Optional.h>
+#include <AK/Vector.h>
+#include <LibGfx/Bitmap.h>
+#include <LibGfx/Font/Font.h>
+
+namespace Gfx {
+
+// A process-wide cache of rasterized glyphs, packed into a few large bitmaps ("pages"). Once the pages take up more
+// memory than the budget allows, the least recently used page is dropped along with all of its glyphs.
+// Like the fonts that use it, it isn't thread-safe.
+class GlyphAtlas {
+    AK_MAKE_NONCOPYABLE(GlyphAtlas);
+    AK_MAKE_NONMOVABLE(GlyphAtlas);
+
+public:
+    static constexpr int page_size = 1024;
+    // Glyphs bigger than this get a page of their own.
+    static constexpr int max_packed_glyph_size = 256;
+    static constexpr size_t default_memory_budget = 32 * MiB;
+
+    struct Key {
+        u64 typeface_id { 0 };
+        float x_scale { 0 };
+        float y_scale { 0 };
+        u32 glyph_id { 0 };
+        GlyphSubpixelOffset subpixel_offset { 0, 0 };
+
+        bool operator==(Key const&) const = default;
+    };
+
+    struct Entry {
+        // Null for glyphs without any pixels.
+        RefPtr<Bitmap> bitmap;
+        IntRect rect;
+    };
+
+    struct Statistics {
+        size_t hits { 0 };
+        size_t misses { 0 };
+        size_t evicted_pages { 0 };
+        size_t evicted_glyphs { 0 };
+        size_t glyph_count { 0 };
+        size_t page_count { 0 };
+        size_t memory_used { 0 };
+        size_t memory_budget { 0 };
+    };
+
+    static GlyphAtlas& the();
+
+    GlyphAtlas() = default;
+
+    // Returns the cached glyph, or rasterizes it with the callback and adds it to the atlas.
+    Entry ensure(Key const&, Function<RefPtr<Bitmap>()> const& rasterize);
+
+    size_t memory_budget() const { return m_memory_budget; }
+    void set_memory_budget(size_t);
+
+    Statistics statistics() const;
+    void reset_statistics();
+    void clear();
+
+private:
+    struct Shelf {
+        int y { 0 };
+        int height { 0 };
+        int next_x { 0 };
+    };
+
+    enum class PageKind {
+        Shared,
+        SingleGlyph,
+    };
+
+    struct Page {
+        NonnullRefPtr<Bitmap> bitmap;
+        PageKind kind { PageKind::Shared };
+        Vector<Shelf> shelves {};
+        int next_shelf_y { 0 };
+        u64 last_used { 0 };
+        Vector<Key> keys {};
+    };
+
+    struct CachedGlyph {
+        Page* page { nullptr };
+        IntRect rect;
+    };
+
+    Optional<IntRect> allocate_in_page(Page&, IntSize);
+    ErrorOr<Page*> create_page(IntSize, PageKind);
+    void evict_least_recently_used_page();
+    size_t memory_used() const;
+    ErrorOr<CachedGlyph> add(Key const&, Bitmap const&);
+
+    HashMap<Key, CachedGlyph> m_glyphs;
+    Vector<NonnullOwnPtr<Page>> m_pages;
+    size_t m_memory_budget { default_memory_budget };
+    u64 m_clock { 0 };
+
+    size_t m_hits { 0 };
+    size_t m_misses { 0 };
+    size_t m_evicted_pages { 0 };
+    size_t m_evicted_glyphs { 0 };
+};
+
+}
+
+namespace AK {
+
+template<>
+struct Traits<Gfx::GlyphAtlas::Key> : public GenericTraits<Gfx::GlyphAtlas::Key> {
+    static unsigned hash(Gfx::GlyphAtlas::Key const& key)
+    {
+        auto hash = u64_hash(key.typeface_id);
+        hash = pair_int_hash(hash, bit_cast<u32>(key.x_scale));
+        hash = pair_int_hash(hash, bit_cast<u32>(key.y_scale));
+        hash = pair_int_hash(hash, key.glyph_id);
+        return pair_int_hash(hash, (key.subpixel_offset.x << 8) | key.subpixel_offset.y);
+    }
+};
+
+}
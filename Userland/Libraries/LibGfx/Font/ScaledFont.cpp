@@ -71,16 +71,18 @@ ALWAYS_INLINE float ScaledFont::unicode_view_width(T const& view) const
     return longest_width;
 }
 
-RefPtr<Gfx::Bitmap> ScaledFont::rasterize_glyph(u32 glyph_id, GlyphSubpixelOffset subpixel_offset) const
-{
-    GlyphIndexWithSubpixelOffset index { glyph_id, subpixel_offset };
-    auto glyph_iterator = m_cached_glyph_bitmaps.find(index);
-    if (glyph_iterator != m_cached_glyph_bitmaps.end())
-        return glyph_iterator->value;
-
-    auto glyph_bitmap = m_font->rasterize_glyph(glyph_id, m_x_scale, m_y_scale, subpixel_offset);
-    m_cached_glyph_bitmaps.set(index, glyph_bitmap);
-    return glyph_bitmap;
+GlyphAtlas::Entry ScaledFont::rasterize_glyph(u32 glyph_id, GlyphSubpixelOffset subpixel_offset) const
+{
+    GlyphAtlas::Key key {
+        .typeface_id = m_font->unique_id(),
+        .x_scale = m_x_scale,
+        .y_scale = m_y_scale,
+        .glyph_id = glyph_id,
+        .subpixel_offset = subpixel_offset,
+    };
+    return GlyphAtlas::the().ensure(key, [&] {
+        return m_font->rasterize_glyph(glyph_id, m_x_scale, m_y_scale, subpixel_offset);
+    });
 }
 
 Gfx::Glyph ScaledFont::glyph(u32 code_point) const
@@ -91,9 +93,9 @@ Gfx::Glyph ScaledFont::glyph(u32 code_point) const
 Gfx::Glyph ScaledFont::glyph(u32 code_point, GlyphSubpixelOffset subpixel_offset) const
 {
     auto id = glyph_id_for_code_point(code_point);
-    auto bitmap = rasterize_glyph(id, subpixel_offset);
+    auto glyph = rasterize_glyph(id, subpixel_offset);
     auto metrics = glyph_metrics(id);
-    return Gfx::Glyph(bitmap, metrics.left_side_bearing, metrics.advance_width, metrics.ascender, m_font->has_color_bitmaps());
+    return Gfx::Glyph(glyph.bitmap, glyph.rect, metrics.left_side_bearing, metrics.advance_width, metrics.ascender, m_font->has_color_bitmaps());
 }
 
 float ScaledFont::glyph_left_bearing(u32 code_point) const
@@ -6,6 +6,7 @@
 
 #pragma once
 
+#include <AK/Atomic.h>
 #include <AK/Noncopyable.h>
 #include <AK/RefCounted.h>
 #include <LibGfx/Font/Font.h>
@@ -48,6 +49,18 @@ public:
     virtual u8 slope() const = 0;
     virtual bool is_fixed_width() const = 0;
     virtual bool has_color_bitmaps() const = 0;
+
+    // Tells typefaces apart in caches that may outlive them, unlike their address.
+    u64 unique_id() const { return m_unique_id; }
+
+private:
+    static u64 next_unique_id()
+    {
+        static Atomic<u64> s_next_unique_id { 1 };
+        return s_next_unique_id.fetch_add(1);
+    }
+
+    u64 m_unique_id { next_unique_id() };
 };
 
 }
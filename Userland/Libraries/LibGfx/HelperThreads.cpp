@@ -0,0 +1,123 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Atomic.h>
+#include <AK/IntegralMath.h>
+#include <AK/Optional.h>
+#include <AK/Vector.h>
+#include <LibGfx/HelperThreads.h>
+#include <LibThreading/ThreadPool.h>
+#include <unistd.h>
+
+namespace Gfx {
+
+static Atomic<size_t> s_maximum_helper_thread_count { 0 };
+
+// The pool is only touched by the thread that managed to set the busy flag, and lives until the process exits.
+static Atomic<bool> s_helper_thread_pool_is_busy { false };
+static Threading::ThreadPool* s_helper_thread_pool { nullptr };
+
+size_t maximum_helper_thread_count()
+{
+    return s_maximum_helper_thread_count;
+}
+
+void set_maximum_helper_thread_count(size_t thread_count)
+{
+    s_maximum_helper_thread_count = thread_count;
+}
+
+size_t helper_thread_count_for_online_processors()
+{
+    static constexpr size_t max_helper_threads = 7;
+    auto processor_count = sysconf(_SC_NPROCESSORS_ONLN);
+    if (processor_count <= 1)
+        return 0;
+    return min(static_cast<size_t>(processor_count) - 1, max_helper_threads);
+}
+
+int lines_per_band(int line_count, size_t pixel_count, int minimum_lines_per_band)
+{
+    auto helper_thread_count = maximum_helper_thread_count();
+    if (helper_thread_count == 0 || pixel_count < minimum_pixel_count_for_helper_threads || line_count < 2 * minimum_lines_per_band)
+        return max(line_count, 1);
+    return max(ceil_div(line_count, static_cast<int>(helper_thread_count + 1) * 2), minimum_lines_per_band);
+}
+
+// Returns the pool, sized for the current maximum, if the calling thread may hand a job to it. It must then be given
+// back with release_helper_thread_pool().
+static Threading::ThreadPool* acquire_helper_thread_pool()
+{
+    if (Threading::ThreadPool::is_running_a_job_on_current_thread())
+        return nullptr;
+    if (s_helper_thread_pool_is_busy.exchange(true))
+        return nullptr;
+
+    auto thread_count = maximum_helper_thread_count();
+    if (!s_helper_thread_pool || s_helper_thread_pool->concurrency() != thread_count + 1) {
+        delete s_helper_thread_pool;
+        s_helper_thread_pool = nullptr;
+
+        auto thread_pool_or_error = Threading::ThreadPool::try_create(thread_count, "GfxHelper"sv);
+        if (thread_pool_or_error.is_error()) {
+            s_helper_thread_pool_is_busy = false;
+            return nullptr;
+        }
+        s_helper_thread_pool = thread_pool_or_error.release_value().leak_ptr();
+    }
+    return s_helper_thread_pool;
+}
+
+static void release_helper_thread_pool()
+{
+    s_helper_thread_pool_is_busy = false;
+}
+
+ErrorOr<void> try_for_each_band_of_lines(int line_count, int lines_per_band, Function<ErrorOr<void>(int first_line, int end_line)> const& callback)
+{
+    if (line_count <= 0)
+        return {};
+
+    VERIFY(lines_per_band > 0);
+    int const band_count = ceil_div(line_count, lines_per_band);
+    if (band_count == 1)
+        return callback(0, line_count);
+
+    Vector<Optional<Error>> errors;
+    TRY(errors.try_resize(band_count));
+    Function<void(size_t)> run_band = [&](size_t band) {
+        int const first_line = band * lines_per_band;
+        if (auto result = callback(first_line, min(first_line + lines_per_band, line_count)); result.is_error())
+            errors[band] = result.release_error();
+    };
+
+    if (auto* pool = acquire_helper_thread_pool()) {
+        pool->for_each(band_count, run_band);
+        release_helper_thread_pool();
+    } else {
+        for (int band = 0; band < band_count; ++band)
+            run_band(band);
+    }
+
+    for (auto& error : errors) {
+        if (error.has_value())
+            return error.release_value();
+    }
+    return {};
+}
+
+void for_each_band_of_lines(int line_count, int pixels_per_line, Function<void(int first_line, int end_line)> const& callback)
+{
+    static constexpr int minimum_lines_per_band = 16;
+
+    auto const pixel_count = static_cast<size_t>(max(line_count, 0)) * max(pixels_per_line, 0);
+    MUST(try_for_each_band_of_lines(line_count, lines_per_band(line_count, pixel_count, minimum_lines_per_band), [&](int first_line, int end_line) -> ErrorOr<void> {
+        callback(first_line, end_line);
+        return {};
+    }));
+}
+
+}
@@ -0,0 +1,42 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Error.h>
+#include <AK/Function.h>
+#include <AK/Types.h>
+
+namespace Gfx {
+
+// Big images are decoded, encoded, scaled and filtered in bands of lines, which are shared out between the calling
+// thread and up to this many threads of a pool that the whole process shares. This is 0 (so everything happens on the
+// calling thread) unless the process asks for more, since not every process is allowed to create threads.
+size_t maximum_helper_thread_count();
+void set_maximum_helper_thread_count(size_t);
+
+// One helper thread for each online processor besides the one the calling thread is on, but not too many of them.
+size_t helper_thread_count_for_online_processors();
+
+// Starting the threads takes longer than working on fewer pixels than this.
+static constexpr size_t minimum_pixel_count_for_helper_threads = 512 * 512;
+
+// How many of the `line_count` lines of a job on `pixel_count` pixels go in each band. A few bands per thread even out
+// how long each of them takes, but none of them is smaller than `minimum_lines_per_band`. Small jobs, and all jobs in a
+// process without helper threads, are a single band.
+int lines_per_band(int line_count, size_t pixel_count, int minimum_lines_per_band);
+
+// Calls `callback` for consecutive bands [first_line, end_line) of `lines_per_band` lines (except for the last one) that
+// together cover the lines [0, line_count). The bands run at the same time on different threads, unless the helper
+// threads are busy with another job or the calling thread is itself a pool thread, in which case they all run on the
+// calling thread. So the callback must not write to anything outside of the lines it was given. If some bands fail, the
+// error of the first one is returned once all of them are done.
+ErrorOr<void> try_for_each_band_of_lines(int line_count, int lines_per_band, Function<ErrorOr<void>(int first_line, int end_line)> const& callback);
+
+// Like the above, for jobs that can't fail and that split lines of `pixels_per_line` pixels into bands of at least 16.
+void for_each_band_of_lines(int line_count, int pixels_per_line, Function<void(int first_line, int end_line)> const& callback);
+
+}
@@ -25,6 +25,12 @@ struct ImageFrameDescriptor {
     int duration { 0 };
 };
 
+struct PartialImageFrameDescriptor {
+    RefPtr<Bitmap> image;
+    // The number of rows at the top of the image that have been decoded, the others are blank.
+    int decoded_height { 0 };
+};
+
 class ImageDecoderPlugin {
 public:
     virtual ~ImageDecoderPlugin() = default;
@@ -42,6 +48,14 @@ public:
     virtual ErrorOr<ImageFrameDescriptor> frame(size_t index) = 0;
     virtual ErrorOr<Optional<ReadonlyBytes>> icc_data() = 0;
 
+    // Decodes as much of the first frame as the data allows, so that an image can be shown before all of it has been
+    // downloaded. Decoders that can't make sense of incomplete data only return complete frames.
+    virtual ErrorOr<PartialImageFrameDescriptor> partial_frame()
+    {
+        auto frame = TRY(this->frame(0));
+        return PartialImageFrameDescriptor { frame.image, frame.image->height() };
+    }
+
 protected:
     ImageDecoderPlugin() = default;
 };
@@ -60,6 +74,7 @@ public:
     size_t loop_count() const { return m_plugin->loop_count(); }
     size_t frame_count() const { return m_plugin->frame_count(); }
     ErrorOr<ImageFrameDescriptor> frame(size_t index) const { return m_plugin->frame(index); }
+    ErrorOr<PartialImageFrameDescriptor> partial_frame() const { return m_plugin->partial_frame(); }
     ErrorOr<Optional<ReadonlyBytes>> icc_data() const { return m_plugin->icc_data(); }
 
 private:
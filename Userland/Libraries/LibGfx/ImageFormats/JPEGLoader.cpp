@@ -11,10 +11,16 @@
 #include <AK/HashMap.h>
 #include <AK/Math.h>
 #include <AK/MemoryStream.h>
+#include <AK/Platform.h>
+#include <AK/SIMD.h>
 #include <AK/String.h>
 #include <AK/Try.h>
 #include <AK/Vector.h>
+#include <LibGfx/HelperThreads.h>
 #include <LibGfx/ImageFormats/JPEGLoader.h>
+#include <LibGfx/PixelKernels.h>
+
+#pragma GCC diagnostic ignored "-Wpsabi"
 
 #define JPEG_INVALID 0X0000
 
@@ -79,6 +85,8 @@
 
 namespace Gfx {
 
+using namespace AK::SIMD;
+
 constexpr static u8 zigzag_map[64] {
     0, 1, 8, 16, 9, 2, 3, 10,
     17, 24, 32, 25, 18, 11, 4, 5,
@@ -96,26 +104,14 @@ using Marker = u16;
  * MCU means group of data units that are coded together. A data unit is an 8x8
  * block of component data. In interleaved scans, number of non-interleaved data
  * units of a component C is Ch * Cv, where Ch and Cv represent the horizontal &
- * vertical subsampling factors of the component, respectively. A MacroBlock is
- * an 8x8 block of RGB values before encoding, and 8x8 block of YCbCr values when
- * we're done decoding the huffman stream.
+ * vertical subsampling factors of the component, respectively. A Macroblock holds
+ * the quantized DCT coefficients of one 8x8 block of each component. Subsampled
+ * components only use the macroblocks in the top left corner of each MCU.
  */
 struct Macroblock {
-    union {
-        i16 y[64] = { 0 };
-        i16 r[64];
-    };
-
-    union {
-        i16 cb[64] = { 0 };
-        i16 g[64];
-    };
-
-    union {
-        i16 cr[64] = { 0 };
-        i16 b[64];
-    };
-
+    i16 y[64] = { 0 };
+    i16 cb[64] = { 0 };
+    i16 cr[64] = { 0 };
     i16 k[64] = { 0 };
 };
 
@@ -146,11 +142,17 @@ struct Component {
     u8 index { 0 };
 };
 
+struct HuffmanTableSpec;
+
 struct ScanComponent {
     // B.2.3 - Scan header syntax
     Component& component;
     u8 dc_destination_id { 0 }; // Tdj, DC entropy coding table destination selector
     u8 ac_destination_id { 0 }; // Taj, AC entropy coding table destination selector
+
+    // The tables that the selectors point to, once the scan is ready to be decoded.
+    HuffmanTableSpec const* dc_table { nullptr };
+    HuffmanTableSpec const* ac_table { nullptr };
 };
 
 struct StartOfFrame {
@@ -183,13 +185,27 @@ struct HuffmanTableSpec {
     u8 destination_id { 0 };
     u8 code_counts[16] = { 0 };
     Vector<u8> symbols;
-    Vector<u16> codes;
+
+    // F.2.2.3 - Decoder tables
+    // The codes of each length L are consecutive and end at max_code[L], which is -1 if there are none. The symbol of
+    // a code is at symbols[code + value_offset[L]].
+    i32 max_code[17] = { 0 };
+    i32 value_offset[17] = { 0 };
+
+    // Codes that are at most lookup_bits long are decoded with a single lookup, indexed by the next lookup_bits bits
+    // of the stream. Entries hold the length of the code in their high byte and its symbol in the low byte, or are 0
+    // if the code is longer.
+    static constexpr u8 lookup_bits = 9;
+    u16 lookup[1 << lookup_bits] = { 0 };
 };
 
 struct HuffmanStreamState {
-    Vector<u8> stream;
-    u8 bit_offset { 0 };
+    ReadonlyBytes stream;
     size_t byte_offset { 0 };
+
+    // The next bits of the stream, most significant bit first. Past the end of the stream, it gets filled with zeroes.
+    u64 bit_buffer { 0 };
+    u8 bit_count { 0 };
 };
 
 struct ICCMultiChunkState {
@@ -206,9 +222,10 @@ struct Scan {
     u8 successive_approximation_high {}; // Ah
     u8 successive_approximation_low {};  // Al
 
-    HuffmanStreamState huffman_stream;
-
-    u64 end_of_bands_run_count { 0 };
+    // The entropy-coded data of the scan, without the stuffed zero bytes and the restart markers.
+    Vector<u8> huffman_stream;
+    // Where each restart interval but the first one starts in huffman_stream.
+    Vector<size_t> restart_offsets;
 
     // See the note on Figure B.4 - Scan header syntax
     bool are_components_interleaved() const
@@ -217,6 +234,14 @@ struct Scan {
     }
 };
 
+// Everything that starts over at the beginning of each restart interval. Several threads can decode different restart
+// intervals of the same scan at once, as long as each of them has its own DecodingState.
+struct DecodingState {
+    HuffmanStreamState huffman_stream;
+    Array<i32, 4> previous_dc_values {};
+    u64 end_of_bands_run_count { 0 };
+};
+
 enum class ColorTransform {
     // https://www.itu.int/rec/dologin_pub.asp?lang=e&id=T-REC-T.872-201206-I!!PDF-E&type=items
     // 6.5.3 - APP14 marker segment for colour encoding
@@ -225,6 +250,17 @@ enum class ColorTransform {
     YCCK = 2,
 };
 
+// What the components of the image stand for, and so how they turn into RGB.
+enum class ColorEncoding {
+    Grayscale,
+    YCbCr,
+    RGB,
+    CMYK,
+    // Adobe applications write CMYK data with 0 meaning full ink coverage.
+    InvertedCMYK,
+    YCCK,
+};
+
 struct JPEGLoadingContext {
     enum State {
         NotDecoded = 0,
@@ -246,64 +282,123 @@ struct JPEGLoadingContext {
 
     Vector<Component, 4> components;
     RefPtr<Gfx::Bitmap> bitmap;
+    ColorEncoding color_encoding { ColorEncoding::YCbCr };
     u16 dc_restart_interval { 0 };
     HashMap<u8, HuffmanTableSpec> dc_tables;
     HashMap<u8, HuffmanTableSpec> ac_tables;
-    Array<i32, 4> previous_dc_values {};
     MacroblockMeta mblock_meta;
     OwnPtr<FixedMemoryStream> stream;
 
+    // A sequential image whose only scan holds every component is turned into pixels one MCU row at a time, while the
+    // scan is being decoded. Any other image needs the coefficients of all of its macroblocks until its last scan.
+    Vector<Macroblock> macroblocks;
+    bool was_composed_while_decoding { false };
+
     Optional<ColorTransform> color_transform {};
 
     Optional<ICCMultiChunkState> icc_multi_chunk_state;
     Optional<ByteBuffer> icc_data;
 };
 
-static void generate_huffman_codes(HuffmanTableSpec& table)
+static ErrorOr<void> generate_huffman_codes(HuffmanTableSpec& table)
 {
-    unsigned code = 0;
-    for (auto number_of_codes : table.code_counts) {
-        for (int i = 0; i < number_of_codes; i++)
-            table.codes.append(code++);
+    // C.2 - Conversion of Huffman table specifications to tables of codes and code lengths
+    u32 code = 0;
+    u32 symbol_index = 0;
+    for (u8 length = 1; length <= 16; ++length) {
+        auto number_of_codes = table.code_counts[length - 1];
+        table.value_offset[length] = static_cast<i32>(symbol_index) - static_cast<i32>(code);
+        for (int i = 0; i < number_of_codes; i++) {
+            if (length <= HuffmanTableSpec::lookup_bits) {
+                u32 const unused_bits = HuffmanTableSpec::lookup_bits - length;
+                for (u32 suffix = 0; suffix < (1u << unused_bits); ++suffix)
+                    table.lookup[(code << unused_bits) | suffix] = (length << 8) | table.symbols[symbol_index];
+            }
+            code++;
+            symbol_index++;
+        }
+        table.max_code[length] = static_cast<i32>(code) - 1;
+        if (number_of_codes == 0)
+            table.max_code[length] = -1;
+
+        if (code > (1u << length)) {
+            dbgln_if(JPEG_DEBUG, "Too many huffman codes of length {}!", length);
+            return Error::from_string_literal("Too many huffman codes");
+        }
         code <<= 1;
     }
+    return {};
 }
 
-static ErrorOr<size_t> read_huffman_bits(HuffmanStreamState& hstream, size_t count = 1)
+static void fill_bit_buffer(HuffmanStreamState& hstream)
 {
-    if (count > (8 * sizeof(size_t))) {
-        dbgln_if(JPEG_DEBUG, "Can't read {} bits at once!", count);
-        return Error::from_string_literal("Reading too much huffman bits at once");
+    if (hstream.byte_offset + sizeof(u64) <= hstream.stream.size()) {
+        // Adds all of the next bytes that fit, and some bits of the one after that. Those get added again later.
+        u64 next_bytes;
+        memcpy(&next_bytes, hstream.stream.offset_pointer(hstream.byte_offset), sizeof(next_bytes));
+        hstream.bit_buffer |= AK::convert_between_host_and_big_endian(next_bytes) >> hstream.bit_count;
+        u8 const added_bytes = (64 - hstream.bit_count) / 8;
+        hstream.byte_offset += added_bytes;
+        hstream.bit_count += added_bytes * 8;
+        return;
+    }
+
+    while (hstream.bit_count <= 56) {
+        u64 next_byte = hstream.byte_offset < hstream.stream.size() ? hstream.stream[hstream.byte_offset] : 0;
+        hstream.bit_buffer |= next_byte << (56 - hstream.bit_count);
+        hstream.byte_offset++;
+        hstream.bit_count += 8;
     }
-    size_t value = 0;
-    while (count--) {
-        if (hstream.byte_offset >= hstream.stream.size()) {
+}
+
+static ErrorOr<void> consume_bits(HuffmanStreamState& hstream, u8 count)
+{
+    hstream.bit_buffer <<= count;
+    hstream.bit_count -= count;
+
+    if (hstream.byte_offset > hstream.stream.size()) [[unlikely]] {
+        // Some of the buffered bits are padding, make sure that we didn't use any of them.
+        if (hstream.byte_offset * 8 - hstream.bit_count > hstream.stream.size() * 8) {
             dbgln_if(JPEG_DEBUG, "Huffman stream exhausted. This could be an error!");
             return Error::from_string_literal("Huffman stream exhausted.");
         }
-        u8 current_byte = hstream.stream[hstream.byte_offset];
-        u8 current_bit = 1u & (u32)(current_byte >> (7 - hstream.bit_offset)); // MSB first.
-        hstream.bit_offset++;
-        value = (value << 1) | (size_t)current_bit;
-        if (hstream.bit_offset == 8) {
-            hstream.byte_offset++;
-            hstream.bit_offset = 0;
-        }
     }
+    return {};
+}
+
+static ErrorOr<u16> read_huffman_bits(HuffmanStreamState& hstream, u8 count = 1)
+{
+    // Neither codes nor the additional bits of coefficients are longer than 16 bits.
+    if (count > 16) {
+        dbgln_if(JPEG_DEBUG, "Can't read {} bits at once!", count);
+        return Error::from_string_literal("Reading too much huffman bits at once");
+    }
+    if (count == 0)
+        return 0;
+
+    if (hstream.bit_count < count)
+        fill_bit_buffer(hstream);
+    u16 value = hstream.bit_buffer >> (64 - count);
+    TRY(consume_bits(hstream, count));
     return value;
 }
 
 static ErrorOr<u8> get_next_symbol(HuffmanStreamState& hstream, HuffmanTableSpec const& table)
 {
-    unsigned code = 0;
-    size_t code_cursor = 0;
-    for (int i = 0; i < 16; i++) { // Codes can't be longer than 16 bits.
-        auto result = TRY(read_huffman_bits(hstream));
-        code = (code << 1) | (i32)result;
-        for (int j = 0; j < table.code_counts[i]; j++) {
-            if (code == table.codes[code_cursor])
-                return table.symbols[code_cursor];
-            code_cursor++;
+    if (hstream.bit_count < 16)
+        fill_bit_buffer(hstream);
+
+    if (auto entry = table.lookup[hstream.bit_buffer >> (64 - HuffmanTableSpec::lookup_bits)]; entry != 0) {
+        TRY(consume_bits(hstream, entry >> 8));
+        return entry & 0xFF;
+    }
+
+    // F.2.2.3 - Decoding procedure for Huffman tables
+    for (u8 length = HuffmanTableSpec::lookup_bits + 1; length <= 16; length++) { // Codes can't be longer than 16 bits.
+        auto code = static_cast<i32>(hstream.bit_buffer >> (64 - length));
+        if (code <= table.max_code[length]) {
+            TRY(consume_bits(hstream, length));
+            return table.symbols[code + table.value_offset[length]];
         }
     }
 
@@ -327,58 +422,56 @@ static inline auto* get_component(Macroblock& block, unsigned component)
     }
 }
 
-static ErrorOr<void> refine_coefficient(Scan& scan, auto& coefficient)
+static inline auto const* get_component(Macroblock const& block, unsigned component)
+{
+    return get_component(const_cast<Macroblock&>(block), component);
+}
+
+static ErrorOr<void> refine_coefficient(DecodingState& state, Scan const& scan, auto& coefficient)
 {
     // G.1.2.3 - Coding model for subsequent scans of successive approximation
     // See the correction bit from rule b.
-    u8 const bit = TRY(read_huffman_bits(scan.huffman_stream, 1));
+    u8 const bit = TRY(read_huffman_bits(state.huffman_stream, 1));
     if (bit == 1)
         coefficient |= 1 << scan.successive_approximation_low;
 
     return {};
 }
 
-static ErrorOr<void> add_dc(JPEGLoadingContext& context, Macroblock& macroblock, ScanComponent const& scan_component)
+static ErrorOr<void> add_dc(JPEGLoadingContext const& context, DecodingState& state, Macroblock& macroblock, ScanComponent const& scan_component)
 {
-    auto maybe_table = context.dc_tables.get(scan_component.dc_destination_id);
-    if (!maybe_table.has_value()) {
-        dbgln_if(JPEG_DEBUG, "Unable to find a DC table with id: {}", scan_component.dc_destination_id);
-        return Error::from_string_literal("Unable to find corresponding DC table");
-    }
-
-    auto& dc_table = maybe_table.value();
-    auto& scan = context.current_scan;
+    auto const& scan = context.current_scan;
 
     auto* select_component = get_component(macroblock, scan_component.component.index);
     auto& coefficient = select_component[0];
 
-    if (context.current_scan.successive_approximation_high > 0) {
-        TRY(refine_coefficient(scan, coefficient));
+    if (scan.successive_approximation_high > 0) {
+        TRY(refine_coefficient(state, scan, coefficient));
         return {};
     }
 
     // For DC coefficients, symbol encodes the length of the coefficient.
-    auto dc_length = TRY(get_next_symbol(scan.huffman_stream, dc_table));
+    auto dc_length = TRY(get_next_symbol(state.huffman_stream, *scan_component.dc_table));
     if (dc_length > 11) {
         dbgln_if(JPEG_DEBUG, "DC coefficient too long: {}!", dc_length);
         return Error::from_string_literal("DC coefficient too long");
     }
 
     // DC coefficients are encoded as the difference between previous and current DC values.
-    i32 dc_diff = TRY(read_huffman_bits(scan.huffman_stream, dc_length));
+    i32 dc_diff = TRY(read_huffman_bits(state.huffman_stream, dc_length));
 
     // If MSB in diff is 0, the difference is -ve. Otherwise +ve.
     if (dc_length != 0 && dc_diff < (1 << (dc_length - 1)))
         dc_diff -= (1 << dc_length) - 1;
 
-    auto& previous_dc = context.previous_dc_values[scan_component.component.index];
+    auto& previous_dc = state.previous_dc_values[scan_component.component.index];
     previous_dc += dc_diff;
     coefficient = previous_dc << scan.successive_approximation_low;
 
     return {};
 }
 
-static ErrorOr<bool> read_eob(Scan& scan, u32 symbol)
+static ErrorOr<bool> read_eob(DecodingState& state, u32 symbol)
 {
     // G.1.2.2 - Progressive encoding of AC coefficients with Huffman coding
     // Note: We also use it for non-progressive encoding as it supports both EOB and ZRL
@@ -386,13 +479,13 @@ static ErrorOr<bool> read_eob(Scan& scan, u32 symbol)
     if (auto const eob = symbol & 0x0F; eob == 0 && symbol != JPEG_ZRL) {
         // We encountered an EOB marker
         auto const eob_base = symbol >> 4;
-        auto const additional_value = TRY(read_huffman_bits(scan.huffman_stream, eob_base));
+        auto const additional_value = TRY(read_huffman_bits(state.huffman_stream, eob_base));
 
-        scan.end_of_bands_run_count = additional_value + (1 << eob_base) - 1;
+        state.end_of_bands_run_count = additional_value + (1 << eob_base) - 1;
 
-        // end_of_bands_run_count is decremented at the end of `build_macroblocks`.
+        // end_of_bands_run_count is decremented at the end of `decode_block`.
         // And we need to now that we reached End of Block in `add_ac`.
-        ++scan.end_of_bands_run_count;
+        ++state.end_of_bands_run_count;
 
         return true;
     }
@@ -408,18 +501,54 @@ static bool is_progressive(StartOfFrame::FrameType frame_type)
         || frame_type == StartOfFrame::FrameType::Differential_Progressive_DCT_Arithmetic;
 }
 
-static ErrorOr<void> add_ac(JPEGLoadingContext& context, Macroblock& macroblock, ScanComponent const& scan_component)
+static ErrorOr<void> add_sequential_ac(HuffmanStreamState& huffman_stream, i16* coefficients, HuffmanTableSpec const& ac_table)
 {
-    auto maybe_table = context.ac_tables.get(scan_component.ac_destination_id);
-    if (!maybe_table.has_value()) {
-        dbgln_if(JPEG_DEBUG, "Unable to find a AC table with id: {}", scan_component.ac_destination_id);
-        return Error::from_string_literal("Unable to find corresponding AC table");
+    // F.2.2.2 - Decoding procedure for the AC coefficients
+    // Sequential scans don't have end-of-band runs nor successive approximation, which makes this much simpler than
+    // the general case below.
+    for (int k = 1; k <= 63;) {
+        u8 const symbol = TRY(get_next_symbol(huffman_stream, ac_table));
+        u8 const zero_run = symbol >> 4;
+        u8 const coeff_length = symbol & 0x0F;
+
+        if (coeff_length == 0) {
+            if (symbol != JPEG_ZRL)
+                break; // EOB
+            k += 16;
+            continue;
+        }
+
+        k += zero_run;
+        if (k > 63) {
+            dbgln_if(JPEG_DEBUG, "Run-length exceeded boundaries. Cursor: {}, Skipping: {}!", k, zero_run);
+            return Error::from_string_literal("Run-length exceeded boundaries");
+        }
+
+        if (coeff_length > 10) {
+            dbgln_if(JPEG_DEBUG, "AC coefficient too long: {}!", coeff_length);
+            return Error::from_string_literal("AC coefficient too long");
+        }
+
+        i32 ac_coefficient = TRY(read_huffman_bits(huffman_stream, coeff_length));
+        if (ac_coefficient < (1 << (coeff_length - 1)))
+            ac_coefficient -= (1 << coeff_length) - 1;
+
+        coefficients[zigzag_map[k++]] = ac_coefficient;
     }
 
-    auto& ac_table = maybe_table.value();
+    return {};
+}
+
+static ErrorOr<void> add_ac(JPEGLoadingContext const& context, DecodingState& state, Macroblock& macroblock, ScanComponent const& scan_component)
+{
+    auto const& ac_table = *scan_component.ac_table;
     auto* select_component = get_component(macroblock, scan_component.component.index);
 
-    auto& scan = context.current_scan;
+    if (!is_progressive(context.frame.type))
+        return add_sequential_ac(state.huffman_stream, select_component, ac_table);
+
+    auto const& scan = context.current_scan;
+    auto& huffman_stream = state.huffman_stream;
 
     // Compute the AC coefficients.
 
@@ -437,10 +566,10 @@ static ErrorOr<void> add_ac(JPEGLoadingContext& context, Macroblock& macroblock,
         // AC symbols encode 2 pieces of information, the high 4 bits represent
         // number of zeroes to be stuffed before reading the coefficient. Low 4
         // bits represent the magnitude of the coefficient.
-        if (!in_zrl && scan.end_of_bands_run_count == 0 && !saved_symbol.has_value()) {
-            saved_symbol = TRY(get_next_symbol(scan.huffman_stream, ac_table));
+        if (!in_zrl && state.end_of_bands_run_count == 0 && !saved_symbol.has_value()) {
+            saved_symbol = TRY(get_next_symbol(huffman_stream, ac_table));
 
-            if (!TRY(read_eob(scan, *saved_symbol))) {
+            if (!TRY(read_eob(state, *saved_symbol))) {
                 to_skip = *saved_symbol >> 4;
 
                 in_zrl = *saved_symbol == JPEG_ZRL;
@@ -452,13 +581,13 @@ static ErrorOr<void> add_ac(JPEGLoadingContext& context, Macroblock& macroblock,
                 if (!in_zrl && is_progressive(context.frame.type) && scan.successive_approximation_high != 0) {
                     // G.1.2.3 - Coding model for subsequent scans of successive approximation
                     // Bit sign from rule a
-                    saved_bit_for_rule_a = TRY(read_huffman_bits(scan.huffman_stream, 1));
+                    saved_bit_for_rule_a = TRY(read_huffman_bits(huffman_stream, 1));
                 }
             }
         }
 
         if (coefficient != 0) {
-            TRY(refine_coefficient(scan, coefficient));
+            TRY(refine_coefficient(state, scan, coefficient));
             continue;
         }
 
@@ -469,7 +598,7 @@ static ErrorOr<void> add_ac(JPEGLoadingContext& context, Macroblock& macroblock,
             continue;
         }
 
-        if (scan.end_of_bands_run_count > 0)
+        if (state.end_of_bands_run_count > 0)
             continue;
 
         if (is_progressive(context.frame.type) && scan.successive_approximation_high != 0) {
@@ -491,7 +620,7 @@ static ErrorOr<void> add_ac(JPEGLoadingContext& context, Macroblock& macroblock,
             }
 
             if (coeff_length != 0) {
-                i32 ac_coefficient = TRY(read_huffman_bits(scan.huffman_stream, coeff_length));
+                i32 ac_coefficient = TRY(read_huffman_bits(huffman_stream, coeff_length));
                 if (ac_coefficient < (1 << (coeff_length - 1)))
                     ac_coefficient -= (1 << coeff_length) - 1;
 
@@ -510,129 +639,147 @@ static ErrorOr<void> add_ac(JPEGLoadingContext& context, Macroblock& macroblock,
     return {};
 }
 
-/**
- * Build the macroblocks possible by reading single (MCU) subsampled pair of CbCr.
- * Depending on the sampling factors, we may not see triples of y, cb, cr in that
- * order. If sample factors differ from one, we'll read more than one block of y-
- * coefficients before we get to read a cb-cr block.
-
- * In the function below, `hcursor` and `vcursor` denote the location of the block
- * we're building in the macroblock matrix. `vfactor_i` and `hfactor_i` are cursors
- * that iterate over the vertical and horizontal subsampling factors, respectively.
- * When we finish one iteration of the innermost loop, we'll have the coefficients
- * of one of the components of block at position `macroblock_index`. When the outermost
- * loop finishes first iteration, we'll have all the luminance coefficients for all the
- * macroblocks that share the chrominance data. Next two iterations (assuming that
- * we are dealing with three components) will fill up the blocks with chroma data.
- */
-static ErrorOr<void> build_macroblocks(JPEGLoadingContext& context, Vector<Macroblock>& macroblocks, u32 hcursor, u32 vcursor)
+static ErrorOr<void> decode_block(JPEGLoadingContext const& context, DecodingState& state, Macroblock& block, ScanComponent const& scan_component)
 {
-    for (auto const& scan_component : context.current_scan.components) {
-        for (u8 vfactor_i = 0; vfactor_i < scan_component.component.vsample_factor; vfactor_i++) {
-            for (u8 hfactor_i = 0; hfactor_i < scan_component.component.hsample_factor; hfactor_i++) {
-                // A.2.3 - Interleaved order
-                u32 macroblock_index = (vcursor + vfactor_i) * context.mblock_meta.hpadded_count + (hfactor_i + hcursor);
-                if (!context.current_scan.are_components_interleaved()) {
-                    macroblock_index = vcursor * context.mblock_meta.hpadded_count + (hfactor_i + (hcursor * scan_component.component.vsample_factor) + (vfactor_i * scan_component.component.hsample_factor));
-
-                    // A.2.4 Completion of partial MCU
-                    // If the component is [and only if!] to be interleaved, the encoding process
-                    // shall also extend the number of samples by one or more additional blocks.
-
-                    // Horizontally
-                    if (macroblock_index >= context.mblock_meta.hcount && macroblock_index % context.mblock_meta.hpadded_count >= context.mblock_meta.hcount)
-                        continue;
-                    // Vertically
-                    if (macroblock_index >= context.mblock_meta.hpadded_count * context.mblock_meta.vcount)
-                        continue;
-                }
+    auto const& scan = context.current_scan;
 
-                Macroblock& block = macroblocks[macroblock_index];
+    // Sequential scans code all coefficients of a block at once, and AC coefficients that are zero aren't coded at
+    // all. Macroblocks are reused when decoding one MCU row at a time, so clear out the previous block.
+    if (!is_progressive(context.frame.type))
+        memset(get_component(block, scan_component.component.index), 0, 64 * sizeof(i16));
 
-                if (context.current_scan.spectral_selection_start == 0)
-                    TRY(add_dc(context, block, scan_component));
-                if (context.current_scan.spectral_selection_end != 0)
-                    TRY(add_ac(context, block, scan_component));
+    if (scan.spectral_selection_start == 0)
+        TRY(add_dc(context, state, block, scan_component));
+    if (scan.spectral_selection_end != 0)
+        TRY(add_ac(context, state, block, scan_component));
 
-                // G.1.2.2 - Progressive encoding of AC coefficients with Huffman coding
-                if (context.current_scan.end_of_bands_run_count > 0) {
-                    --context.current_scan.end_of_bands_run_count;
-                    continue;
-                }
-            }
-        }
-    }
+    // G.1.2.2 - Progressive encoding of AC coefficients with Huffman coding
+    if (state.end_of_bands_run_count > 0)
+        --state.end_of_bands_run_count;
 
     return {};
 }
 
-static bool is_dct_based(StartOfFrame::FrameType frame_type)
+struct MCUGrid {
+    u32 columns { 0 };
+    u32 rows { 0 };
+};
+
+static MCUGrid mcu_grid_of_current_scan(JPEGLoadingContext const& context)
 {
-    return frame_type == StartOfFrame::FrameType::Baseline_DCT
-        || frame_type == StartOfFrame::FrameType::Extended_Sequential_DCT
-        || frame_type == StartOfFrame::FrameType::Progressive_DCT
-        || frame_type == StartOfFrame::FrameType::Differential_Sequential_DCT
-        || frame_type == StartOfFrame::FrameType::Differential_Progressive_DCT
-        || frame_type == StartOfFrame::FrameType::Progressive_DCT_Arithmetic
-        || frame_type == StartOfFrame::FrameType::Differential_Sequential_DCT_Arithmetic
-        || frame_type == StartOfFrame::FrameType::Differential_Progressive_DCT_Arithmetic;
+    // A.2.3 - Interleaved order
+    auto const& scan = context.current_scan;
+    if (scan.are_components_interleaved())
+        return { context.mblock_meta.hpadded_count / context.hsample_factor, context.mblock_meta.vpadded_count / context.vsample_factor };
+
+    // A.2.2 - Non-interleaved order
+    // Each MCU is a single block of the only component. The blocks only cover the component itself, the extra blocks
+    // of A.2.4 (Completion of partial MCU) are only there in interleaved scans.
+    auto const& component = scan.components[0].component;
+    auto block_count = [](u32 size, u8 sample_factor, u8 maximum_sample_factor) {
+        return ceil_div(ceil_div(size * sample_factor, static_cast<u32>(maximum_sample_factor)), 8u);
+    };
+    return {
+        block_count(context.frame.width, component.hsample_factor, context.hsample_factor),
+        block_count(context.frame.height, component.vsample_factor, context.vsample_factor),
+    };
 }
 
-static void reset_decoder(JPEGLoadingContext& context)
+/**
+ * Decodes the MCU at (mcu_x, mcu_y) into `macroblocks`, whose first row is the macroblock row `first_macroblock_row`
+ * of the image. Depending on the sampling factors, an MCU of an interleaved scan holds several blocks of a component:
+ * we'll read all the luminance blocks of the MCU before we get to read the chrominance blocks that they share.
+ */
+static ErrorOr<void> decode_mcu(JPEGLoadingContext const& context, DecodingState& state, Span<Macroblock> macroblocks, u32 first_macroblock_row, u32 mcu_x, u32 mcu_y)
 {
-    // G.1.2.2 - Progressive encoding of AC coefficients with Huffman coding
-    context.current_scan.end_of_bands_run_count = 0;
+    auto const& scan = context.current_scan;
+    auto macroblock_at = [&](u32 row, u32 column) -> Macroblock& {
+        return macroblocks[(row - first_macroblock_row) * context.mblock_meta.hpadded_count + column];
+    };
 
-    // E.2.4 Control procedure for decoding a restart interval
-    if (is_dct_based(context.frame.type)) {
-        context.previous_dc_values = {};
-        return;
+    if (!scan.are_components_interleaved()) {
+        auto const& scan_component = scan.components[0];
+        auto const& component = scan_component.component;
+        u32 const row = mcu_y / component.vsample_factor * context.vsample_factor + mcu_y % component.vsample_factor;
+        u32 const column = mcu_x / component.hsample_factor * context.hsample_factor + mcu_x % component.hsample_factor;
+        return decode_block(context, state, macroblock_at(row, column), scan_component);
     }
 
-    VERIFY_NOT_REACHED();
+    for (auto const& scan_component : scan.components) {
+        for (u8 vfactor_i = 0; vfactor_i < scan_component.component.vsample_factor; vfactor_i++) {
+            for (u8 hfactor_i = 0; hfactor_i < scan_component.component.hsample_factor; hfactor_i++) {
+                auto& block = macroblock_at(mcu_y * context.vsample_factor + vfactor_i, mcu_x * context.hsample_factor + hfactor_i);
+                TRY(decode_block(context, state, block, scan_component));
+            }
+        }
+    }
+
+    return {};
 }
 
-static ErrorOr<void> decode_huffman_stream(JPEGLoadingContext& context, Vector<Macroblock>& macroblocks)
+static ErrorOr<void> begin_restart_interval(JPEGLoadingContext const& context, DecodingState& state, u32 interval)
 {
-    // Compute huffman codes for DC and AC tables.
-    for (auto it = context.dc_tables.begin(); it != context.dc_tables.end(); ++it)
-        generate_huffman_codes(it->value);
+    // E.2.4 Control procedure for decoding a restart interval
+    auto const& scan = context.current_scan;
+    size_t byte_offset = 0;
+    if (interval > 0) {
+        if (interval > scan.restart_offsets.size()) {
+            dbgln_if(JPEG_DEBUG, "Restart interval {} is missing, there are only {}!", interval, scan.restart_offsets.size() + 1);
+            return Error::from_string_literal("Missing restart marker");
+        }
+        byte_offset = scan.restart_offsets[interval - 1];
+    }
 
-    for (auto it = context.ac_tables.begin(); it != context.ac_tables.end(); ++it)
-        generate_huffman_codes(it->value);
+    state = {};
+    state.huffman_stream.stream = scan.huffman_stream.span();
+    state.huffman_stream.byte_offset = byte_offset;
+    return {};
+}
 
-    for (u32 vcursor = 0; vcursor < context.mblock_meta.vcount; vcursor += context.vsample_factor) {
-        for (u32 hcursor = 0; hcursor < context.mblock_meta.hcount; hcursor += context.hsample_factor) {
-            u32 i = vcursor * context.mblock_meta.hpadded_count + hcursor;
+static ErrorOr<void> find_huffman_tables(JPEGLoadingContext& context)
+{
+    auto& scan = context.current_scan;
+    for (auto& scan_component : scan.components) {
+        if (scan.spectral_selection_start == 0 && scan.successive_approximation_high == 0) {
+            auto it = context.dc_tables.find(scan_component.dc_destination_id);
+            if (it == context.dc_tables.end()) {
+                dbgln_if(JPEG_DEBUG, "Unable to find a DC table with id: {}", scan_component.dc_destination_id);
+                return Error::from_string_literal("Unable to find corresponding DC table");
+            }
+            scan_component.dc_table = &it->value;
+        }
 
-            auto& huffman_stream = context.current_scan.huffman_stream;
+        if (scan.spectral_selection_end != 0) {
+            auto it = context.ac_tables.find(scan_component.ac_destination_id);
+            if (it == context.ac_tables.end()) {
+                dbgln_if(JPEG_DEBUG, "Unable to find a AC table with id: {}", scan_component.ac_destination_id);
+                return Error::from_string_literal("Unable to find corresponding AC table");
+            }
+            scan_component.ac_table = &it->value;
+        }
+    }
+    return {};
+}
 
-            if (context.dc_restart_interval > 0) {
-                if (i != 0 && i % (context.dc_restart_interval * context.vsample_factor * context.hsample_factor) == 0) {
-                    reset_decoder(context);
+// Decodes the whole scan into the macroblocks of the entire image.
+static ErrorOr<void> decode_huffman_stream(JPEGLoadingContext const& context, Span<Macroblock> macroblocks)
+{
+    auto const grid = mcu_grid_of_current_scan(context);
+    u32 const restart_interval = context.dc_restart_interval;
 
-                    // Restart markers are stored in byte boundaries. Advance the huffman stream cursor to
-                    //  the 0th bit of the next byte.
-                    if (huffman_stream.byte_offset < huffman_stream.stream.size()) {
-                        if (huffman_stream.bit_offset > 0) {
-                            huffman_stream.bit_offset = 0;
-                            huffman_stream.byte_offset++;
-                        }
+    DecodingState state;
+    TRY(begin_restart_interval(context, state, 0));
 
-                        // Skip the restart marker (RSTn).
-                        huffman_stream.byte_offset++;
-                    }
-                }
-            }
+    for (u32 mcu = 0; mcu < grid.columns * grid.rows; ++mcu) {
+        if (restart_interval > 0 && mcu > 0 && mcu % restart_interval == 0)
+            TRY(begin_restart_interval(context, state, mcu / restart_interval));
 
-            if (auto result = build_macroblocks(context, macroblocks, hcursor, vcursor); result.is_error()) {
-                if constexpr (JPEG_DEBUG) {
-                    dbgln("Failed to build Macroblock {}: {}", i, result.error());
-                    dbgln("Huffman stream byte offset {}", huffman_stream.byte_offset);
-                    dbgln("Huffman stream bit offset {}", huffman_stream.bit_offset);
-                }
-                return result.release_error();
+        if (auto result = decode_mcu(context, state, macroblocks, 0, mcu % grid.columns, mcu / grid.columns); result.is_error()) {
+            if constexpr (JPEG_DEBUG) {
+                dbgln("Failed to decode MCU {}: {}", mcu, result.error());
+                dbgln("Huffman stream byte offset {}", state.huffman_stream.byte_offset);
             }
+            return result.release_error();
         }
     }
     return {};
@@ -710,7 +857,6 @@ static ErrorOr<void> read_start_of_scan(Stream& stream, JPEGLoadingContext& cont
     u8 const component_count = TRY(stream.read_value<u8>());
 
     Scan current_scan;
-    current_scan.huffman_stream.stream.ensure_capacity(50 * KiB);
 
     Optional<u8> last_read;
     u8 component_read = 0;
@@ -811,14 +957,16 @@ static ErrorOr<void> read_huffman_table(Stream& stream, JPEGLoadingContext& cont
             table.code_counts[i] = count;
         }
 
-        table.codes.ensure_capacity(total_codes);
+        TRY(table.symbols.try_ensure_capacity(total_codes));
 
         // Read symbols. Read X bytes, where X is the sum of the counts of codes read in the previous step.
         for (u32 i = 0; i < total_codes; i++) {
             u8 symbol = TRY(stream.read_value<u8>());
-            table.symbols.append(symbol);
+            table.symbols.unchecked_append(symbol);
         }
 
+        TRY(generate_huffman_codes(table));
+
         auto& huffman_table = table.type == 0 ? context.dc_tables : context.ac_tables;
         huffman_table.set(table.destination_id, table);
         VERIFY(huffman_table.size() <= 2);
@@ -1040,6 +1188,13 @@ static ErrorOr<void> read_start_of_frame(Stream& stream, JPEGLoadingContext& con
         component.hsample_factor = subsample_factors >> 4;
         component.vsample_factor = subsample_factors & 0x0F;
 
+        // A.2.2 - Non-interleaved order
+        // The only scan of a single-component image is non-interleaved, so its sampling factors have no effect.
+        if (component_count == 1 && component.hsample_factor != 0 && component.vsample_factor != 0) {
+            component.hsample_factor = 1;
+            component.vsample_factor = 1;
+        }
+
         if (i == 0) {
             // By convention, downsampling is applied only on chroma components. So we should
             //  hope to see the maximum sampling factor in the luma component.
@@ -1112,410 +1267,519 @@ static ErrorOr<void> skip_segment(Stream& stream)
     return {};
 }
 
-static void dequantize(JPEGLoadingContext& context, Vector<Macroblock>& macroblocks)
-{
-    for (u32 vcursor = 0; vcursor < context.mblock_meta.vcount; vcursor += context.vsample_factor) {
-        for (u32 hcursor = 0; hcursor < context.mblock_meta.hcount; hcursor += context.hsample_factor) {
-            for (u32 i = 0; i < context.components.size(); i++) {
-                auto& component = context.components[i];
-                u32 const* table = component.qtable_id == 0 ? context.luma_table : context.chroma_table;
-                for (u32 vfactor_i = 0; vfactor_i < component.vsample_factor; vfactor_i++) {
-                    for (u32 hfactor_i = 0; hfactor_i < component.hsample_factor; hfactor_i++) {
-                        u32 macroblock_index = (vcursor + vfactor_i) * context.mblock_meta.hpadded_count + (hfactor_i + hcursor);
-                        Macroblock& block = macroblocks[macroblock_index];
-                        auto* block_component = get_component(block, i);
-                        for (u32 k = 0; k < 64; k++)
-                            block_component[k] *= table[k];
-                    }
-                }
-            }
-        }
-    }
+// The inverse DCT uses the same fixed-point arithmetic as the accurate integer IDCT of the IJG's libjpeg (jidctint.c),
+// which is based on the algorithm by Loeffler, Ligtenberg and Moschytz. It works on all eight rows or columns of a
+// block at once: each vector holds one row of the block, so the 1-D transform of the columns becomes a transform of
+// the vectors, and a transpose in between turns the rows into columns.
+static constexpr int idct_constant_bits = 13;
+static constexpr int idct_pass1_bits = 2;
+
+// The multipliers of the IDCT, scaled by 2^13.
+static constexpr i32 fix_0_298631336 = 2446;
+static constexpr i32 fix_0_390180644 = 3196;
+static constexpr i32 fix_0_541196100 = 4433;
+static constexpr i32 fix_0_765366865 = 6270;
+static constexpr i32 fix_0_899976223 = 7373;
+static constexpr i32 fix_1_175875602 = 9633;
+static constexpr i32 fix_1_501321110 = 12299;
+static constexpr i32 fix_1_847759065 = 15137;
+static constexpr i32 fix_1_961570560 = 16069;
+static constexpr i32 fix_2_053119869 = 16819;
+static constexpr i32 fix_2_562915447 = 20995;
+static constexpr i32 fix_3_072711026 = 25172;
+
+ALWAYS_INLINE static void inverse_dct_1d(i32x8 (&v)[8], i32 rounding, int shift)
+{
+    // Even part
+    i32x8 z1 = (v[2] + v[6]) * fix_0_541196100;
+    i32x8 tmp2 = z1 - v[6] * fix_1_847759065;
+    i32x8 tmp3 = z1 + v[2] * fix_0_765366865;
+    i32x8 tmp0 = (v[0] + v[4]) << idct_constant_bits;
+    i32x8 tmp1 = (v[0] - v[4]) << idct_constant_bits;
+
+    i32x8 const tmp10 = tmp0 + tmp3;
+    i32x8 const tmp13 = tmp0 - tmp3;
+    i32x8 const tmp11 = tmp1 + tmp2;
+    i32x8 const tmp12 = tmp1 - tmp2;
+
+    // Odd part
+    tmp0 = v[7];
+    tmp1 = v[5];
+    tmp2 = v[3];
+    tmp3 = v[1];
+
+    z1 = tmp0 + tmp3;
+    i32x8 z2 = tmp1 + tmp2;
+    i32x8 z3 = tmp0 + tmp2;
+    i32x8 z4 = tmp1 + tmp3;
+    i32x8 const z5 = (z3 + z4) * fix_1_175875602;
+
+    tmp0 *= fix_0_298631336;
+    tmp1 *= fix_2_053119869;
+    tmp2 *= fix_3_072711026;
+    tmp3 *= fix_1_501321110;
+    z1 *= -fix_0_899976223;
+    z2 *= -fix_2_562915447;
+    z3 = z3 * -fix_1_961570560 + z5;
+    z4 = z4 * -fix_0_390180644 + z5;
+
+    tmp0 += z1 + z3;
+    tmp1 += z2 + z4;
+    tmp2 += z2 + z3;
+    tmp3 += z1 + z4;
+
+    v[0] = (tmp10 + tmp3 + rounding) >> shift;
+    v[7] = (tmp10 - tmp3 + rounding) >> shift;
+    v[1] = (tmp11 + tmp2 + rounding) >> shift;
+    v[6] = (tmp11 - tmp2 + rounding) >> shift;
+    v[2] = (tmp12 + tmp1 + rounding) >> shift;
+    v[5] = (tmp12 - tmp1 + rounding) >> shift;
+    v[3] = (tmp13 + tmp0 + rounding) >> shift;
+    v[4] = (tmp13 - tmp0 + rounding) >> shift;
 }
 
-static void inverse_dct(JPEGLoadingContext const& context, Vector<Macroblock>& macroblocks)
-{
-    static float const m0 = 2.0f * AK::cos(1.0f / 16.0f * 2.0f * AK::Pi<float>);
-    static float const m1 = 2.0f * AK::cos(2.0f / 16.0f * 2.0f * AK::Pi<float>);
-    static float const m3 = 2.0f * AK::cos(2.0f / 16.0f * 2.0f * AK::Pi<float>);
-    static float const m5 = 2.0f * AK::cos(3.0f / 16.0f * 2.0f * AK::Pi<float>);
-    static float const m2 = m0 - m5;
-    static float const m4 = m0 + m5;
-    static float const s0 = AK::cos(0.0f / 16.0f * AK::Pi<float>) * AK::rsqrt(8.0f);
-    static float const s1 = AK::cos(1.0f / 16.0f * AK::Pi<float>) / 2.0f;
-    static float const s2 = AK::cos(2.0f / 16.0f * AK::Pi<float>) / 2.0f;
-    static float const s3 = AK::cos(3.0f / 16.0f * AK::Pi<float>) / 2.0f;
-    static float const s4 = AK::cos(4.0f / 16.0f * AK::Pi<float>) / 2.0f;
-    static float const s5 = AK::cos(5.0f / 16.0f * AK::Pi<float>) / 2.0f;
-    static float const s6 = AK::cos(6.0f / 16.0f * AK::Pi<float>) / 2.0f;
-    static float const s7 = AK::cos(7.0f / 16.0f * AK::Pi<float>) / 2.0f;
-
-    for (u32 vcursor = 0; vcursor < context.mblock_meta.vcount; vcursor += context.vsample_factor) {
-        for (u32 hcursor = 0; hcursor < context.mblock_meta.hcount; hcursor += context.hsample_factor) {
-            for (u32 component_i = 0; component_i < context.components.size(); component_i++) {
-                auto& component = context.components[component_i];
-                for (u8 vfactor_i = 0; vfactor_i < component.vsample_factor; vfactor_i++) {
-                    for (u8 hfactor_i = 0; hfactor_i < component.hsample_factor; hfactor_i++) {
-                        u32 macroblock_index = (vcursor + vfactor_i) * context.mblock_meta.hpadded_count + (hfactor_i + hcursor);
-                        Macroblock& block = macroblocks[macroblock_index];
-                        auto* block_component = get_component(block, component_i);
-                        for (u32 k = 0; k < 8; ++k) {
-                            float const g0 = block_component[0 * 8 + k] * s0;
-                            float const g1 = block_component[4 * 8 + k] * s4;
-                            float const g2 = block_component[2 * 8 + k] * s2;
-                            float const g3 = block_component[6 * 8 + k] * s6;
-                            float const g4 = block_component[5 * 8 + k] * s5;
-                            float const g5 = block_component[1 * 8 + k] * s1;
-                            float const g6 = block_component[7 * 8 + k] * s7;
-                            float const g7 = block_component[3 * 8 + k] * s3;
-
-                            float const f0 = g0;
-                            float const f1 = g1;
-                            float const f2 = g2;
-                            float const f3 = g3;
-                            float const f4 = g4 - g7;
-                            float const f5 = g5 + g6;
-                            float const f6 = g5 - g6;
-                            float const f7 = g4 + g7;
-
-                            float const e0 = f0;
-                            float const e1 = f1;
-                            float const e2 = f2 - f3;
-                            float const e3 = f2 + f3;
-                            float const e4 = f4;
-                            float const e5 = f5 - f7;
-                            float const e6 = f6;
-                            float const e7 = f5 + f7;
-                            float const e8 = f4 + f6;
-
-                            float const d0 = e0;
-                            float const d1 = e1;
-                            float const d2 = e2 * m1;
-                            float const d3 = e3;
-                            float const d4 = e4 * m2;
-                            float const d5 = e5 * m3;
-                            float const d6 = e6 * m4;
-                            float const d7 = e7;
-                            float const d8 = e8 * m5;
-
-                            float const c0 = d0 + d1;
-                            float const c1 = d0 - d1;
-                            float const c2 = d2 - d3;
-                            float const c3 = d3;
-                            float const c4 = d4 + d8;
-                            float const c5 = d5 + d7;
-                            float const c6 = d6 - d8;
-                            float const c7 = d7;
-                            float const c8 = c5 - c6;
-
-                            float const b0 = c0 + c3;
-                            float const b1 = c1 + c2;
-                            float const b2 = c1 - c2;
-                            float const b3 = c0 - c3;
-                            float const b4 = c4 - c8;
-                            float const b5 = c8;
-                            float const b6 = c6 - c7;
-                            float const b7 = c7;
-
-                            block_component[0 * 8 + k] = b0 + b7;
-                            block_component[1 * 8 + k] = b1 + b6;
-                            block_component[2 * 8 + k] = b2 + b5;
-                            block_component[3 * 8 + k] = b3 + b4;
-                            block_component[4 * 8 + k] = b3 - b4;
-                            block_component[5 * 8 + k] = b2 - b5;
-                            block_component[6 * 8 + k] = b1 - b6;
-                            block_component[7 * 8 + k] = b0 - b7;
-                        }
-                        for (u32 l = 0; l < 8; ++l) {
-                            float const g0 = block_component[l * 8 + 0] * s0;
-                            float const g1 = block_component[l * 8 + 4] * s4;
-                            float const g2 = block_component[l * 8 + 2] * s2;
-                            float const g3 = block_component[l * 8 + 6] * s6;
-                            float const g4 = block_component[l * 8 + 5] * s5;
-                            float const g5 = block_component[l * 8 + 1] * s1;
-                            float const g6 = block_component[l * 8 + 7] * s7;
-                            float const g7 = block_component[l * 8 + 3] * s3;
-
-                            float const f0 = g0;
-                            float const f1 = g1;
-                            float const f2 = g2;
-                            float const f3 = g3;
-                            float const f4 = g4 - g7;
-                            float const f5 = g5 + g6;
-                            float const f6 = g5 - g6;
-                            float const f7 = g4 + g7;
-
-                            float const e0 = f0;
-                            float const e1 = f1;
-                            float const e2 = f2 - f3;
-                            float const e3 = f2 + f3;
-                            float const e4 = f4;
-                            float const e5 = f5 - f7;
-                            float const e6 = f6;
-                            float const e7 = f5 + f7;
-                            float const e8 = f4 + f6;
-
-                            float const d0 = e0;
-                            float const d1 = e1;
-                            float const d2 = e2 * m1;
-                            float const d3 = e3;
-                            float const d4 = e4 * m2;
-                            float const d5 = e5 * m3;
-                            float const d6 = e6 * m4;
-                            float const d7 = e7;
-                            float const d8 = e8 * m5;
-
-                            float const c0 = d0 + d1;
-                            float const c1 = d0 - d1;
-                            float const c2 = d2 - d3;
-                            float const c3 = d3;
-                            float const c4 = d4 + d8;
-                            float const c5 = d5 + d7;
-                            float const c6 = d6 - d8;
-                            float const c7 = d7;
-                            float const c8 = c5 - c6;
-
-                            float const b0 = c0 + c3;
-                            float const b1 = c1 + c2;
-                            float const b2 = c1 - c2;
-                            float const b3 = c0 - c3;
-                            float const b4 = c4 - c8;
-                            float const b5 = c8;
-                            float const b6 = c6 - c7;
-                            float const b7 = c7;
-
-                            block_component[l * 8 + 0] = b0 + b7;
-                            block_component[l * 8 + 1] = b1 + b6;
-                            block_component[l * 8 + 2] = b2 + b5;
-                            block_component[l * 8 + 3] = b3 + b4;
-                            block_component[l * 8 + 4] = b3 - b4;
-                            block_component[l * 8 + 5] = b2 - b5;
-                            block_component[l * 8 + 6] = b1 - b6;
-                            block_component[l * 8 + 7] = b0 - b7;
-                        }
-                    }
-                }
-            }
-        }
+ALWAYS_INLINE static void transpose(i32x8 (&v)[8])
+{
+    // Interleave pairs of rows, then pairs of pairs, then swap the halves of the vectors.
+    i32x8 t[8];
+    for (size_t i = 0; i < 8; i += 2) {
+        t[i] = __builtin_shufflevector(v[i], v[i + 1], 0, 8, 1, 9, 4, 12, 5, 13);
+        t[i + 1] = __builtin_shufflevector(v[i], v[i + 1], 2, 10, 3, 11, 6, 14, 7, 15);
     }
 
-    // F.2.1.5 - Inverse DCT (IDCT)
-
-    for (u32 vcursor = 0; vcursor < context.mblock_meta.vcount; vcursor += context.vsample_factor) {
-        for (u32 hcursor = 0; hcursor < context.mblock_meta.hcount; hcursor += context.hsample_factor) {
-            for (u8 vfactor_i = 0; vfactor_i < context.vsample_factor; ++vfactor_i) {
-                for (u8 hfactor_i = 0; hfactor_i < context.hsample_factor; ++hfactor_i) {
-                    u32 mb_index = (vcursor + vfactor_i) * context.mblock_meta.hpadded_count + (hcursor + hfactor_i);
-                    for (u8 i = 0; i < 8; ++i) {
-                        for (u8 j = 0; j < 8; ++j) {
-                            macroblocks[mb_index].r[i * 8 + j] = clamp(macroblocks[mb_index].r[i * 8 + j] + 128, 0, 255);
-                            macroblocks[mb_index].g[i * 8 + j] = clamp(macroblocks[mb_index].g[i * 8 + j] + 128, 0, 255);
-                            macroblocks[mb_index].b[i * 8 + j] = clamp(macroblocks[mb_index].b[i * 8 + j] + 128, 0, 255);
-                            macroblocks[mb_index].k[i * 8 + j] = clamp(macroblocks[mb_index].b[i * 8 + j] + 128, 0, 255);
-                        }
-                    }
-                }
-            }
-        }
+    i32x8 s[8];
+    for (size_t i = 0; i < 8; i += 4) {
+        s[i] = __builtin_shufflevector(t[i], t[i + 2], 0, 1, 8, 9, 4, 5, 12, 13);
+        s[i + 1] = __builtin_shufflevector(t[i], t[i + 2], 2, 3, 10, 11, 6, 7, 14, 15);
+        s[i + 2] = __builtin_shufflevector(t[i + 1], t[i + 3], 0, 1, 8, 9, 4, 5, 12, 13);
+        s[i + 3] = __builtin_shufflevector(t[i + 1], t[i + 3], 2, 3, 10, 11, 6, 7, 14, 15);
     }
-}
 
-static void ycbcr_to_rgb(JPEGLoadingContext const& context, Vector<Macroblock>& macroblocks)
-{
-    // Conversion from YCbCr to RGB isn't specified in the first JPEG specification but in the JFIF extension:
-    // See: https://www.itu.int/rec/dologin_pub.asp?lang=f&id=T-REC-T.871-201105-I!!PDF-E&type=items
-    // 7 - Conversion to and from RGB
-    for (u32 vcursor = 0; vcursor < context.mblock_meta.vcount; vcursor += context.vsample_factor) {
-        for (u32 hcursor = 0; hcursor < context.mblock_meta.hcount; hcursor += context.hsample_factor) {
-            const u32 chroma_block_index = vcursor * context.mblock_meta.hpadded_count + hcursor;
-            Macroblock const& chroma = macroblocks[chroma_block_index];
-            // Overflows are intentional.
-            for (u8 vfactor_i = context.vsample_factor - 1; vfactor_i < context.vsample_factor; --vfactor_i) {
-                for (u8 hfactor_i = context.hsample_factor - 1; hfactor_i < context.hsample_factor; --hfactor_i) {
-                    u32 macroblock_index = (vcursor + vfactor_i) * context.mblock_meta.hpadded_count + (hcursor + hfactor_i);
-                    auto* y = macroblocks[macroblock_index].y;
-                    auto* cb = macroblocks[macroblock_index].cb;
-                    auto* cr = macroblocks[macroblock_index].cr;
-                    for (u8 i = 7; i < 8; --i) {
-                        for (u8 j = 7; j < 8; --j) {
-                            const u8 pixel = i * 8 + j;
-                            const u32 chroma_pxrow = (i / context.vsample_factor) + 4 * vfactor_i;
-                            const u32 chroma_pxcol = (j / context.hsample_factor) + 4 * hfactor_i;
-                            const u32 chroma_pixel = chroma_pxrow * 8 + chroma_pxcol;
-                            int r = y[pixel] + 1.402f * (chroma.cr[chroma_pixel] - 128);
-                            int g = y[pixel] - 0.3441f * (chroma.cb[chroma_pixel] - 128) - 0.7141f * (chroma.cr[chroma_pixel] - 128);
-                            int b = y[pixel] + 1.772f * (chroma.cb[chroma_pixel] - 128);
-                            y[pixel] = clamp(r, 0, 255);
-                            cb[pixel] = clamp(g, 0, 255);
-                            cr[pixel] = clamp(b, 0, 255);
-                        }
-                    }
-                }
-            }
-        }
+    for (size_t i = 0; i < 4; ++i) {
+        v[i] = __builtin_shufflevector(s[i], s[i + 4], 0, 1, 2, 3, 8, 9, 10, 11);
+        v[i + 4] = __builtin_shufflevector(s[i], s[i + 4], 4, 5, 6, 7, 12, 13, 14, 15);
     }
 }
 
-static void invert_colors_for_adobe_images(JPEGLoadingContext const& context, Vector<Macroblock>& macroblocks)
+ALWAYS_INLINE static i32x8 clamp_to_sample(i32x8 value)
+{
+    i32x8 const zero {};
+    i32x8 const maximum = zero + 255;
+    value = value < zero ? zero : value;
+    return value > maximum ? maximum : value;
+}
+
+// Dequantizes the coefficients of a block, and writes the 8x8 samples that they describe to `output`.
+ALWAYS_INLINE static void inverse_dct(i16 const* coefficients, u32 const* quantization_table, u8* output, size_t pitch)
 {
-    if (!context.color_transform.has_value())
+    i16x8 rows[8];
+    memcpy(rows, coefficients, sizeof(rows));
+
+    // Many blocks are flat, and only have a DC coefficient. This is exactly what the full transform makes of them.
+    i16x8 ac_coefficients = rows[0];
+    ac_coefficients[0] = 0;
+    for (size_t i = 1; i < 8; ++i)
+        ac_coefficients |= rows[i];
+    u64 ac_bits[2];
+    memcpy(ac_bits, &ac_coefficients, sizeof(ac_bits));
+    if ((ac_bits[0] | ac_bits[1]) == 0) {
+        i32 const dc = coefficients[0] * static_cast<i32>(quantization_table[0]);
+        auto const sample = static_cast<u8>(clamp(((dc + 4) >> 3) + 128, 0, 255));
+        for (size_t y = 0; y < 8; ++y)
+            memset(output + y * pitch, sample, 8);
         return;
+    }
 
-    // From libjpeg-turbo's libjpeg.txt:
-    // https://github.com/libjpeg-turbo/libjpeg-turbo/blob/main/libjpeg.txt
-    // CAUTION: it appears that Adobe Photoshop writes inverted data in CMYK JPEG
-    // files: 0 represents 100% ink coverage, rather than 0% ink as you'd expect.
-    // This is arguably a bug in Photoshop, but if you need to work with Photoshop
-    // CMYK files, you will have to deal with it in your application.
-    for (u32 vcursor = 0; vcursor < context.mblock_meta.vcount; vcursor += context.vsample_factor) {
-        for (u32 hcursor = 0; hcursor < context.mblock_meta.hcount; hcursor += context.hsample_factor) {
-            for (u8 vfactor_i = 0; vfactor_i < context.vsample_factor; ++vfactor_i) {
-                for (u8 hfactor_i = 0; hfactor_i < context.hsample_factor; ++hfactor_i) {
-                    u32 mb_index = (vcursor + vfactor_i) * context.mblock_meta.hpadded_count + (hcursor + hfactor_i);
-                    for (u8 i = 0; i < 8; ++i) {
-                        for (u8 j = 0; j < 8; ++j) {
-                            macroblocks[mb_index].r[i * 8 + j] = NumericLimits<u8>::max() - macroblocks[mb_index].r[i * 8 + j];
-                            macroblocks[mb_index].g[i * 8 + j] = NumericLimits<u8>::max() - macroblocks[mb_index].g[i * 8 + j];
-                            macroblocks[mb_index].b[i * 8 + j] = NumericLimits<u8>::max() - macroblocks[mb_index].b[i * 8 + j];
-                            macroblocks[mb_index].k[i * 8 + j] = NumericLimits<u8>::max() - macroblocks[mb_index].k[i * 8 + j];
-                        }
-                    }
-                }
-            }
-        }
+    i32x8 v[8];
+    for (size_t i = 0; i < 8; ++i) {
+        i32x8 quantization_row;
+        memcpy(&quantization_row, quantization_table + i * 8, sizeof(quantization_row));
+        v[i] = __builtin_convertvector(rows[i], i32x8) * quantization_row;
     }
+
+    // The first pass keeps a few extra bits of precision.
+    constexpr int pass1_shift = idct_constant_bits - idct_pass1_bits;
+    inverse_dct_1d(v, 1 << (pass1_shift - 1), pass1_shift);
+    transpose(v);
+
+    // The second pass also removes the extra factor of 8 of the 2-D transform, and undoes the level shift of A.3.1.
+    constexpr int pass2_shift = idct_constant_bits + idct_pass1_bits + 3;
+    inverse_dct_1d(v, (1 << (pass2_shift - 1)) + (128 << pass2_shift), pass2_shift);
+    transpose(v);
+
+    for (size_t y = 0; y < 8; ++y) {
+        auto samples = __builtin_convertvector(clamp_to_sample(v[y]), u8x8);
+        memcpy(output + y * pitch, &samples, sizeof(samples));
+    }
+}
+
+ALWAYS_INLINE static i32x8 load_samples(u8 const* samples)
+{
+    u8x8 vector;
+    memcpy(&vector, samples, sizeof(vector));
+    return __builtin_convertvector(vector, i32x8);
 }
 
-static void cmyk_to_rgb(JPEGLoadingContext const& context, Vector<Macroblock>& macroblocks)
+// Loads 4 samples, and repeats each of them.
+ALWAYS_INLINE static i32x8 load_doubled_samples(u8 const* samples)
 {
-    invert_colors_for_adobe_images(context, macroblocks);
+    u8x4 vector;
+    memcpy(&vector, samples, sizeof(vector));
+    return __builtin_convertvector(__builtin_shufflevector(vector, vector, 0, 0, 1, 1, 2, 2, 3, 3), i32x8);
+}
 
-    for (u32 vcursor = 0; vcursor < context.mblock_meta.vcount; vcursor += context.vsample_factor) {
-        for (u32 hcursor = 0; hcursor < context.mblock_meta.hcount; hcursor += context.hsample_factor) {
-            for (u8 vfactor_i = context.vsample_factor - 1; vfactor_i < context.vsample_factor; --vfactor_i) {
-                for (u8 hfactor_i = context.hsample_factor - 1; hfactor_i < context.hsample_factor; --hfactor_i) {
-                    u32 mb_index = (vcursor + vfactor_i) * context.mblock_meta.hpadded_count + (hcursor + hfactor_i);
-                    auto* c = macroblocks[mb_index].y;
-                    auto* m = macroblocks[mb_index].cb;
-                    auto* y = macroblocks[mb_index].cr;
-                    auto* k = macroblocks[mb_index].k;
-                    for (u8 i = 0; i < 8; ++i) {
-                        for (u8 j = 0; j < 8; ++j) {
-                            u8 const pixel = i * 8 + j;
+ALWAYS_INLINE static void store_pixels(ARGB32* pixels, i32x8 r, i32x8 g, i32x8 b)
+{
+    auto vector = __builtin_convertvector((clamp_to_sample(r) << 16) | (clamp_to_sample(g) << 8) | clamp_to_sample(b), u32x8) | 0xff000000;
+    memcpy(pixels, &vector, sizeof(vector));
+}
 
-                            static constexpr auto max_value = NumericLimits<u8>::max();
+// Conversion from YCbCr to RGB isn't specified in the first JPEG specification but in the JFIF extension:
+// See: https://www.itu.int/rec/dologin_pub.asp?lang=f&id=T-REC-T.871-201105-I!!PDF-E&type=items
+// 7 - Conversion to and from RGB
+// The factors are scaled by 2^16, and the vector and scalar versions compute exactly the same.
+static constexpr i32 cr_to_r = 91881;  // 1.402
+static constexpr i32 cb_to_g = -22554; // -0.344136
+static constexpr i32 cr_to_g = -46802; // -0.714136
+static constexpr i32 cb_to_b = 116130; // 1.772
+static constexpr i32 ycbcr_rounding = 1 << 15;
+
+static Color ycbcr_to_rgb(i32 y, i32 cb, i32 cr)
+{
+    cb -= 128;
+    cr -= 128;
+    i32 const r = y + ((cr_to_r * cr + ycbcr_rounding) >> 16);
+    i32 const g = y + ((cb_to_g * cb + cr_to_g * cr + ycbcr_rounding) >> 16);
+    i32 const b = y + ((cb_to_b * cb + ycbcr_rounding) >> 16);
+    return Color(clamp(r, 0, 255), clamp(g, 0, 255), clamp(b, 0, 255));
+}
 
-                            auto const black_component = max_value - k[pixel];
-                            int const r = ((max_value - c[pixel]) * black_component) / max_value;
-                            int const g = ((max_value - m[pixel]) * black_component) / max_value;
-                            int const b = ((max_value - y[pixel]) * black_component) / max_value;
+// With horizontally subsampled chroma, the chroma rows are half as wide as the luma row, and get upsampled on the way.
+template<bool chroma_is_halved>
+ALWAYS_INLINE static void ycbcr_to_rgb(u8 const* y, u8 const* cb, u8 const* cr, ARGB32* pixels, u32 width)
+{
+    auto load_chroma = [](u8 const* samples, u32 x) {
+        if constexpr (chroma_is_halved)
+            return load_doubled_samples(samples + x / 2);
+        else
+            return load_samples(samples + x);
+    };
 
-                            c[pixel] = clamp(r, 0, max_value);
-                            m[pixel] = clamp(g, 0, max_value);
-                            y[pixel] = clamp(b, 0, max_value);
-                        }
-                    }
-                }
-            }
-        }
+    u32 x = 0;
+    for (; x + 8 <= width; x += 8) {
+        i32x8 const luma = load_samples(y + x);
+        i32x8 const blue_difference = load_chroma(cb, x) - 128;
+        i32x8 const red_difference = load_chroma(cr, x) - 128;
+        store_pixels(pixels + x,
+            luma + ((cr_to_r * red_difference + ycbcr_rounding) >> 16),
+            luma + ((cb_to_g * blue_difference + cr_to_g * red_difference + ycbcr_rounding) >> 16),
+            luma + ((cb_to_b * blue_difference + ycbcr_rounding) >> 16));
     }
+
+    u32 const chroma_shift = chroma_is_halved ? 1 : 0;
+    for (; x < width; ++x)
+        pixels[x] = ycbcr_to_rgb(y[x], cb[x >> chroma_shift], cr[x >> chroma_shift]).value();
 }
 
-static void ycck_to_rgb(JPEGLoadingContext const& context, Vector<Macroblock>& macroblocks)
+ALWAYS_INLINE static void grayscale_to_rgb(u8 const* y, ARGB32* pixels, u32 width)
 {
-    // 7 - Conversions between colour encodings
-    // YCCK is obtained from CMYK by converting the CMY channels to YCC channel.
+    u32 x = 0;
+    for (; x + 8 <= width; x += 8) {
+        i32x8 const luma = load_samples(y + x);
+        store_pixels(pixels + x, luma, luma, luma);
+    }
+    for (; x < width; ++x)
+        pixels[x] = Color(y[x], y[x], y[x]).value();
+}
 
-    // To convert back into RGB, we only need the 3 first components, which are baseline YCbCr
-    ycbcr_to_rgb(context, macroblocks);
+ALWAYS_INLINE static void rgb_to_rgb(u8 const* r, u8 const* g, u8 const* b, ARGB32* pixels, u32 width)
+{
+    u32 x = 0;
+    for (; x + 8 <= width; x += 8)
+        store_pixels(pixels + x, load_samples(r + x), load_samples(g + x), load_samples(b + x));
+    for (; x < width; ++x)
+        pixels[x] = Color(r[x], g[x], b[x]).value();
+}
 
-    // RGB to CMYK, as mentioned in https://www.smcm.iqfr.csic.es/docs/intel/ipp/ipp_manual/IPPI/ippi_ch15/functn_YCCKToCMYK_JPEG.htm#functn_YCCKToCMYK_JPEG
-    for (u32 vcursor = 0; vcursor < context.mblock_meta.vcount; vcursor += context.vsample_factor) {
-        for (u32 hcursor = 0; hcursor < context.mblock_meta.hcount; hcursor += context.hsample_factor) {
-            for (u8 vfactor_i = 0; vfactor_i < context.vsample_factor; ++vfactor_i) {
-                for (u8 hfactor_i = 0; hfactor_i < context.hsample_factor; ++hfactor_i) {
-                    u32 mb_index = (vcursor + vfactor_i) * context.mblock_meta.hpadded_count + (hcursor + hfactor_i);
-                    for (u8 i = 0; i < 8; ++i) {
-                        for (u8 j = 0; j < 8; ++j) {
-                            macroblocks[mb_index].r[i * 8 + j] = NumericLimits<u8>::max() - macroblocks[mb_index].r[i * 8 + j];
-                            macroblocks[mb_index].g[i * 8 + j] = NumericLimits<u8>::max() - macroblocks[mb_index].g[i * 8 + j];
-                            macroblocks[mb_index].b[i * 8 + j] = NumericLimits<u8>::max() - macroblocks[mb_index].b[i * 8 + j];
-                        }
-                    }
-                }
-            }
-        }
+static Color cmyk_to_rgb(u8 c, u8 m, u8 y, u8 k, bool is_inverted)
+{
+    static constexpr auto max_value = NumericLimits<u8>::max();
+
+    // From libjpeg-turbo's libjpeg.txt:
+    // https://github.com/libjpeg-turbo/libjpeg-turbo/blob/main/libjpeg.txt
+    // CAUTION: it appears that Adobe Photoshop writes inverted data in CMYK JPEG
+    // files: 0 represents 100% ink coverage, rather than 0% ink as you'd expect.
+    // This is arguably a bug in Photoshop, but if you need to work with Photoshop
+    // CMYK files, you will have to deal with it in your application.
+    if (is_inverted) {
+        c = max_value - c;
+        m = max_value - m;
+        y = max_value - y;
+        k = max_value - k;
     }
 
-    cmyk_to_rgb(context, macroblocks);
+    auto const black_component = max_value - k;
+    u8 const r = ((max_value - c) * black_component) / max_value;
+    u8 const g = ((max_value - m) * black_component) / max_value;
+    u8 const b = ((max_value - y) * black_component) / max_value;
+    return Color(r, g, b);
 }
 
-static ErrorOr<void> handle_color_transform(JPEGLoadingContext const& context, Vector<Macroblock>& macroblocks)
+// Only the YCbCr conversion takes rows of chroma samples that are still subsampled, see compose_mcu_row().
+ALWAYS_INLINE static void convert_to_rgb(JPEGLoadingContext const& context, Array<u8 const*, 4> const& samples, ARGB32* pixels, u32 width)
 {
+    switch (context.color_encoding) {
+    case ColorEncoding::Grayscale:
+        grayscale_to_rgb(samples[0], pixels, width);
+        return;
+    case ColorEncoding::YCbCr:
+        if (context.hsample_factor == 2)
+            ycbcr_to_rgb<true>(samples[0], samples[1], samples[2], pixels, width);
+        else
+            ycbcr_to_rgb<false>(samples[0], samples[1], samples[2], pixels, width);
+        return;
+    case ColorEncoding::RGB:
+        rgb_to_rgb(samples[0], samples[1], samples[2], pixels, width);
+        return;
+    case ColorEncoding::CMYK:
+    case ColorEncoding::InvertedCMYK: {
+        bool const is_inverted = context.color_encoding == ColorEncoding::InvertedCMYK;
+        for (u32 x = 0; x < width; ++x)
+            pixels[x] = cmyk_to_rgb(samples[0][x], samples[1][x], samples[2][x], samples[3][x], is_inverted).value();
+        return;
+    }
+    case ColorEncoding::YCCK:
+        // 7 - Conversions between colour encodings
+        // YCCK is obtained from CMYK by converting the CMY channels to YCC channel.
+        // To convert back into RGB, we only need the 3 first components, which are baseline YCbCr. Those are then
+        // turned into CMY, as mentioned in https://www.smcm.iqfr.csic.es/docs/intel/ipp/ipp_manual/IPPI/ippi_ch15/functn_YCCKToCMYK_JPEG.htm#functn_YCCKToCMYK_JPEG
+        for (u32 x = 0; x < width; ++x) {
+            auto const cmy = ycbcr_to_rgb(samples[0][x], samples[1][x], samples[2][x]);
+            pixels[x] = cmyk_to_rgb(255 - cmy.red(), 255 - cmy.green(), 255 - cmy.blue(), samples[3][x], true).value();
+        }
+        return;
+    }
+    VERIFY_NOT_REACHED();
+}
+
+static ErrorOr<ColorEncoding> find_color_encoding(JPEGLoadingContext const& context)
+{
+    auto const component_count = context.components.size();
+
     if (context.color_transform.has_value()) {
         // https://www.itu.int/rec/dologin_pub.asp?lang=e&id=T-REC-T.872-201206-I!!PDF-E&type=items
         // 6.5.3 - APP14 marker segment for colour encoding
 
         switch (*context.color_transform) {
         case ColorTransform::CmykOrRgb:
-            if (context.components.size() == 4) {
-                cmyk_to_rgb(context, macroblocks);
-            } else if (context.components.size() == 3) {
-                // Note: components.size() == 3 means that we have an RGB image, so no color transformation is needed.
-            } else {
-                return Error::from_string_literal("Wrong number of components for CMYK or RGB, aborting.");
-            }
-            break;
+            if (component_count == 4)
+                return ColorEncoding::InvertedCMYK;
+            if (component_count == 3)
+                return ColorEncoding::RGB;
+            return Error::from_string_literal("Wrong number of components for CMYK or RGB, aborting.");
         case ColorTransform::YCbCr:
-            ycbcr_to_rgb(context, macroblocks);
-            break;
+            return component_count == 1 ? ColorEncoding::Grayscale : ColorEncoding::YCbCr;
         case ColorTransform::YCCK:
-            ycck_to_rgb(context, macroblocks);
-            break;
+            if (component_count == 4)
+                return ColorEncoding::YCCK;
+            return Error::from_string_literal("Wrong number of components for YCCK, aborting.");
         }
-
-        return {};
+        VERIFY_NOT_REACHED();
     }
 
     // No App14 segment is present, assuming :
     //      - 1 components means grayscale
     //      - 3 components means YCbCr
     //      - 4 components means CMYK
-    if (context.components.size() == 4)
-        cmyk_to_rgb(context, macroblocks);
-    if (context.components.size() == 3)
-        ycbcr_to_rgb(context, macroblocks);
+    if (component_count == 4)
+        return ColorEncoding::CMYK;
+    if (component_count == 3)
+        return ColorEncoding::YCbCr;
+    return ColorEncoding::Grayscale;
+}
+
+// Scratch space for turning MCU rows into pixels. Every thread that does so needs its own.
+struct MCURowBuffers {
+    // The coefficients of an MCU row, when they don't have to stay around until the end of the decoding.
+    Vector<Macroblock> macroblocks;
+    // The samples of each component for the MCU row, with all of the padding of the macroblocks.
+    Array<Vector<u8>, 4> samples;
+    // A row of samples of each subsampled component, at full resolution. The YCbCr conversion doesn't need these.
+    Array<Vector<u8>, 4> upsampled_row;
+
+    static ErrorOr<MCURowBuffers> create(JPEGLoadingContext const& context, bool with_macroblocks)
+    {
+        MCURowBuffers buffers;
+        u32 const macroblocks_per_mcu_row = context.mblock_meta.hpadded_count * context.vsample_factor;
+        if (with_macroblocks)
+            TRY(buffers.macroblocks.try_resize(macroblocks_per_mcu_row));
+
+        u32 const samples_per_row = context.mblock_meta.hpadded_count * 8;
+        for (size_t i = 0; i < context.components.size(); ++i) {
+            TRY(buffers.samples[i].try_resize(macroblocks_per_mcu_row * 64));
+            if (context.components[i].hsample_factor != context.hsample_factor && context.color_encoding != ColorEncoding::YCbCr)
+                TRY(buffers.upsampled_row[i].try_resize(samples_per_row));
+        }
+        return buffers;
+    }
+};
+
+/**
+ * Turns the macroblocks of the MCU row `mcu_row` into pixels: The inverse DCT writes the samples of each component
+ * to a plane, then the planes are upsampled row by row where the components are subsampled, and converted to RGB
+ * right into the bitmap.
+ */
+ALWAYS_INLINE static void compose_mcu_row_impl(JPEGLoadingContext const& context, ReadonlySpan<Macroblock> macroblocks, u32 mcu_row, MCURowBuffers& buffers)
+{
+    u32 const pitch = context.mblock_meta.hpadded_count * 8;
+    u32 const mcus_per_row = context.mblock_meta.hpadded_count / context.hsample_factor;
+
+    for (u32 i = 0; i < context.components.size(); i++) {
+        auto const& component = context.components[i];
+        u32 const* table = component.qtable_id == 0 ? context.luma_table : context.chroma_table;
+        auto* samples = buffers.samples[i].data();
+        for (u32 mcu_x = 0; mcu_x < mcus_per_row; mcu_x++) {
+            for (u32 vfactor_i = 0; vfactor_i < component.vsample_factor; vfactor_i++) {
+                for (u32 hfactor_i = 0; hfactor_i < component.hsample_factor; hfactor_i++) {
+                    auto const& block = macroblocks[vfactor_i * context.mblock_meta.hpadded_count + mcu_x * context.hsample_factor + hfactor_i];
+                    u32 const block_x = (mcu_x * component.hsample_factor + hfactor_i) * 8;
+                    inverse_dct(get_component(block, i), table, samples + vfactor_i * 8 * pitch + block_x, pitch);
+                }
+            }
+        }
+    }
 
-    if (context.components.size() == 1) {
-        // With Cb and Cr being equal to zero, this function assign the Y
-        // value (luminosity) to R, G and B. Providing a proper conversion
-        // from grayscale to RGB.
-        ycbcr_to_rgb(context, macroblocks);
+    u32 const first_y = mcu_row * context.vsample_factor * 8;
+    u32 const row_count = min(context.vsample_factor * 8u, context.frame.height - first_y);
+    for (u32 y = 0; y < row_count; y++) {
+        Array<u8 const*, 4> rows {};
+        for (u32 i = 0; i < context.components.size(); i++) {
+            auto const& component = context.components[i];
+            // Subsampled components are upsampled by repeating their samples. Only the luma component can have
+            // sampling factors other than 1, and they are at most 2.
+            auto const* row = buffers.samples[i].data() + (component.vsample_factor == context.vsample_factor ? y : y / 2) * pitch;
+            if (component.hsample_factor != context.hsample_factor && context.color_encoding != ColorEncoding::YCbCr) {
+                auto* upsampled = buffers.upsampled_row[i].data();
+                for (u32 x = 0; x < context.frame.width; x++)
+                    upsampled[x] = row[x / 2];
+                row = upsampled;
+            }
+            rows[i] = row;
+        }
+        convert_to_rgb(context, rows, context.bitmap->scanline(first_y + y), context.frame.width);
     }
+}
 
-    return {};
+// Like the PixelKernels, this has a version that uses AVX2 on x86-64, which halves the time that the inverse DCT takes.
+#if ARCH(X86_64)
+#    define VECTOR256_TARGET [[gnu::target("avx2")]]
+#else
+#    define VECTOR256_TARGET
+#endif
+
+static void compose_mcu_row_vector128(JPEGLoadingContext const& context, ReadonlySpan<Macroblock> macroblocks, u32 mcu_row, MCURowBuffers& buffers)
+{
+    compose_mcu_row_impl(context, macroblocks, mcu_row, buffers);
+}
+
+VECTOR256_TARGET static void compose_mcu_row_vector256(JPEGLoadingContext const& context, ReadonlySpan<Macroblock> macroblocks, u32 mcu_row, MCURowBuffers& buffers)
+{
+    compose_mcu_row_impl(context, macroblocks, mcu_row, buffers);
 }
 
-static ErrorOr<void> compose_bitmap(JPEGLoadingContext& context, Vector<Macroblock> const& macroblocks)
+static void compose_mcu_row(JPEGLoadingContext const& context, ReadonlySpan<Macroblock> macroblocks, u32 mcu_row, MCURowBuffers& buffers)
 {
-    context.bitmap = TRY(Bitmap::create(BitmapFormat::BGRx8888, { context.frame.width, context.frame.height }));
+    if (PixelKernels::implementation() == PixelKernels::Implementation::Vector256)
+        compose_mcu_row_vector256(context, macroblocks, mcu_row, buffers);
+    else
+        compose_mcu_row_vector128(context, macroblocks, mcu_row, buffers);
+}
 
-    for (u32 y = context.frame.height - 1; y < context.frame.height; y--) {
-        const u32 block_row = y / 8;
-        const u32 pixel_row = y % 8;
-        for (u32 x = 0; x < context.frame.width; x++) {
-            const u32 block_column = x / 8;
-            auto& block = macroblocks[block_row * context.mblock_meta.hpadded_count + block_column];
-            const u32 pixel_column = x % 8;
-            const u32 pixel_index = pixel_row * 8 + pixel_column;
-            const Color color { (u8)block.y[pixel_index], (u8)block.cb[pixel_index], (u8)block.cr[pixel_index] };
-            context.bitmap->set_pixel(x, y, color);
+// Splits the MCU rows into chunks of at least `minimum_rows_per_chunk` rows, and calls `callback` for each of them.
+// The chunks are processed on several threads at once when it's worth it.
+static ErrorOr<void> for_each_chunk_of_mcu_rows(JPEGLoadingContext const& context, u32 row_count, u32 minimum_rows_per_chunk, Function<ErrorOr<void>(u32 first_row, u32 end_row)> const& callback)
+{
+    auto const pixel_count = static_cast<size_t>(context.frame.width) * context.frame.height;
+    auto const rows_per_chunk = lines_per_band(row_count, pixel_count, minimum_rows_per_chunk);
+    return try_for_each_band_of_lines(row_count, rows_per_chunk, [&](int first_row, int end_row) {
+        return callback(first_row, end_row);
+    });
+}
+
+/**
+ * Decodes the MCU rows [first_row, end_row) of a scan that holds the whole image, and composes each of them as soon as
+ * it is complete. Decoding can only begin at the start of a restart interval, so the MCUs of the interval that belong
+ * to earlier rows are decoded too, and thrown away.
+ */
+static ErrorOr<void> decode_and_compose_mcu_rows(JPEGLoadingContext const& context, u32 first_row, u32 end_row)
+{
+    auto const grid = mcu_grid_of_current_scan(context);
+    u32 const restart_interval = context.dc_restart_interval;
+    auto buffers = TRY(MCURowBuffers::create(context, true));
+
+    u32 const first_mcu = first_row * grid.columns;
+    u32 const start_mcu = restart_interval > 0 ? first_mcu - first_mcu % restart_interval : 0;
+
+    DecodingState state;
+    TRY(begin_restart_interval(context, state, restart_interval > 0 ? start_mcu / restart_interval : 0));
+
+    for (u32 mcu = start_mcu; mcu < end_row * grid.columns; ++mcu) {
+        if (restart_interval > 0 && mcu != start_mcu && mcu % restart_interval == 0)
+            TRY(begin_restart_interval(context, state, mcu / restart_interval));
+
+        u32 const mcu_x = mcu % grid.columns;
+        u32 const mcu_y = mcu / grid.columns;
+        if (auto result = decode_mcu(context, state, buffers.macroblocks, mcu_y * context.vsample_factor, mcu_x, mcu_y); result.is_error()) {
+            if constexpr (JPEG_DEBUG) {
+                dbgln("Failed to decode MCU {}: {}", mcu, result.error());
+                dbgln("Huffman stream byte offset {}", state.huffman_stream.byte_offset);
+            }
+            return result.release_error();
         }
-    }
 
+        if (mcu_x == grid.columns - 1 && mcu_y >= first_row)
+            compose_mcu_row(context, buffers.macroblocks, mcu_y, buffers);
+    }
     return {};
 }
 
+static bool can_compose_while_decoding(JPEGLoadingContext const& context)
+{
+    return !is_progressive(context.frame.type)
+        && context.macroblocks.is_empty()
+        && context.current_scan.components.size() == context.components.size();
+}
+
+static ErrorOr<void> decode_and_compose_huffman_stream(JPEGLoadingContext& context)
+{
+    auto const grid = mcu_grid_of_current_scan(context);
+
+    // Without restart intervals, decoding has to start at the beginning of the scan.
+    u32 minimum_rows_per_chunk = grid.rows;
+    if (context.dc_restart_interval > 0) {
+        // Every chunk also decodes the part of its first restart interval that belongs to the previous chunk, this
+        // keeps that part small.
+        minimum_rows_per_chunk = 8 * ceil_div(static_cast<u32>(context.dc_restart_interval), grid.columns);
+    }
+
+    return for_each_chunk_of_mcu_rows(context, grid.rows, minimum_rows_per_chunk, [&](u32 first_row, u32 end_row) {
+        return decode_and_compose_mcu_rows(context, first_row, end_row);
+    });
+}
+
+static ErrorOr<void> compose_bitmap(JPEGLoadingContext& context)
+{
+    u32 const mcu_rows = context.mblock_meta.vpadded_count / context.vsample_factor;
+    u32 const macroblocks_per_mcu_row = context.mblock_meta.hpadded_count * context.vsample_factor;
+
+    return for_each_chunk_of_mcu_rows(context, mcu_rows, 1, [&](u32 first_row, u32 end_row) -> ErrorOr<void> {
+        auto buffers = TRY(MCURowBuffers::create(context, false));
+        for (u32 mcu_row = first_row; mcu_row < end_row; mcu_row++)
+            compose_mcu_row(context, context.macroblocks.span().slice(mcu_row * macroblocks_per_mcu_row, macroblocks_per_mcu_row), mcu_row, buffers);
+        return {};
+    });
+}
+
 static bool is_app_marker(Marker const marker)
 {
     return marker >= JPEG_APPN0 && marker <= JPEG_APPN15;
@@ -1615,39 +1879,48 @@ static ErrorOr<void> parse_header(Stream& stream, JPEGLoadingContext& context)
     VERIFY_NOT_REACHED();
 }
 
-static ErrorOr<void> scan_huffman_stream(AK::SeekableStream& stream, HuffmanStreamState& huffman_stream)
+static ErrorOr<void> scan_huffman_stream(FixedMemoryStream& stream, Scan& scan)
 {
-    u8 last_byte;
-    u8 current_byte = TRY(stream.read_value<u8>());
-
+    // B.1.1.5 - Entropy-coded data segments
+    // The entropy-coded data ends at the first marker that isn't RSTn. 0xFF bytes that are part of the data are
+    // followed by a stuffed 0x00.
+    auto const start_offset = stream.offset();
+    auto const bytes = static_cast<FixedMemoryStream const&>(stream).bytes().slice(start_offset);
+    auto& data = scan.huffman_stream;
+    TRY(data.try_ensure_capacity(bytes.size()));
+
+    size_t offset = 0;
     for (;;) {
-        last_byte = current_byte;
-        current_byte = TRY(stream.read_value<u8>());
-
-        if (last_byte == 0xFF) {
-            if (current_byte == 0xFF)
-                continue;
-            if (current_byte == 0x00) {
-                current_byte = TRY(stream.read_value<u8>());
-                huffman_stream.stream.append(last_byte);
-                continue;
-            }
-            Marker marker = 0xFF00 | current_byte;
-            if (marker >= JPEG_RST0 && marker <= JPEG_RST7) {
-                huffman_stream.stream.append(marker);
-                current_byte = TRY(stream.read_value<u8>());
-                continue;
-            }
+        auto const* next_ff = static_cast<u8 const*>(memchr(bytes.offset_pointer(offset), 0xFF, bytes.size() - offset));
+        if (!next_ff || next_ff + 1 == bytes.data() + bytes.size())
+            return Error::from_string_literal("Huffman stream doesn't end with a marker");
 
-            // Rollback the marker we just read
-            TRY(stream.seek(-2, AK::SeekMode::FromCurrentPosition));
-            return {};
-        } else {
-            huffman_stream.stream.append(last_byte);
+        auto const ff_offset = next_ff - bytes.data();
+        data.unchecked_append(bytes.offset_pointer(offset), ff_offset - offset);
+
+        auto const next_byte = bytes[ff_offset + 1];
+        if (next_byte == 0xFF) {
+            // Markers may be preceded by any number of 0xFF fill bytes.
+            offset = ff_offset + 1;
+            continue;
+        }
+        if (next_byte == 0x00) {
+            data.unchecked_append(0xFF);
+            offset = ff_offset + 2;
+            continue;
         }
-    }
 
-    VERIFY_NOT_REACHED();
+        Marker marker = 0xFF00 | next_byte;
+        if (marker >= JPEG_RST0 && marker <= JPEG_RST7) {
+            TRY(scan.restart_offsets.try_append(data.size()));
+            offset = ff_offset + 2;
+            continue;
+        }
+
+        // Leave the marker for the caller to read.
+        TRY(stream.seek(start_offset + ff_offset, AK::SeekMode::SetPosition));
+        return {};
+    }
 }
 
 static ErrorOr<void> decode_header(JPEGLoadingContext& context)
@@ -1671,25 +1944,47 @@ static ErrorOr<void> decode_header(JPEGLoadingContext& context)
     return {};
 }
 
-static ErrorOr<Vector<Macroblock>> construct_macroblocks(JPEGLoadingContext& context)
+static ErrorOr<void> decode_scans(JPEGLoadingContext& context)
 {
     // B.6 - Summary
     // See: Figure B.16 – Flow of compressed data syntax
     // This function handles the "Multi-scan" loop.
 
-    Vector<Macroblock> macroblocks;
-    TRY(macroblocks.try_resize(context.mblock_meta.padded_total));
-
     Marker marker = TRY(read_marker_at_cursor(*context.stream));
     while (true) {
         if (is_miscellaneous_or_table_marker(marker)) {
             TRY(handle_miscellaneous_or_table(*context.stream, context, marker));
         } else if (marker == JPEG_SOS) {
+            if (context.was_composed_while_decoding) {
+                dbgln_if(JPEG_DEBUG, "Unexpected scan after a scan that held every component!");
+                return Error::from_string_literal("Unexpected scan after a scan that held every component");
+            }
+
             TRY(read_start_of_scan(*context.stream, context));
-            TRY(scan_huffman_stream(*context.stream, context.current_scan.huffman_stream));
-            TRY(decode_huffman_stream(context, macroblocks));
+            TRY(scan_huffman_stream(*context.stream, context.current_scan));
+            TRY(find_huffman_tables(context));
+
+            if (!context.bitmap) {
+                context.color_encoding = TRY(find_color_encoding(context));
+                context.bitmap = TRY(Bitmap::create(BitmapFormat::BGRx8888, { context.frame.width, context.frame.height }));
+            }
+
+            if (can_compose_while_decoding(context)) {
+                TRY(decode_and_compose_huffman_stream(context));
+                context.was_composed_while_decoding = true;
+            } else {
+                if (context.macroblocks.is_empty())
+                    TRY(context.macroblocks.try_resize(context.mblock_meta.padded_total));
+                TRY(decode_huffman_stream(context, context.macroblocks));
+            }
         } else if (marker == JPEG_EOI) {
-            return macroblocks;
+            if (!context.bitmap) {
+                dbgln_if(JPEG_DEBUG, "No scan found before EOI!");
+                return Error::from_string_literal("No scan found before EOI");
+            }
+            if (!context.was_composed_while_decoding)
+                TRY(compose_bitmap(context));
+            return {};
         } else {
             dbgln_if(JPEG_DEBUG, "Unexpected marker {:x}!", marker);
             return Error::from_string_literal("Unexpected marker");
@@ -1702,12 +1997,10 @@ static ErrorOr<Vector<Macroblock>> construct_macroblocks(JPEGLoadingContext& con
 static ErrorOr<void> decode_jpeg(JPEGLoadingContext& context)
 {
     TRY(decode_header(context));
-    auto macroblocks = TRY(construct_macroblocks(context));
-    dequantize(context, macroblocks);
-    inverse_dct(context, macroblocks);
-    TRY(handle_color_transform(context, macroblocks));
-    TRY(compose_bitmap(context, macroblocks));
+    TRY(decode_scans(context));
     context.stream.clear();
+    context.macroblocks.clear();
+    context.current_scan = {};
     return {};
 }
 
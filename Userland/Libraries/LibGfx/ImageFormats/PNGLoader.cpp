@@ -5,16 +5,25 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/BitStream.h>
 #include <AK/Debug.h>
 #include <AK/Endian.h>
+#include <AK/MemoryStream.h>
+#include <AK/SIMD.h>
 #include <AK/Vector.h>
+#include <LibCompress/Deflate.h>
 #include <LibCompress/Zlib.h>
 #include <LibGfx/ImageFormats/PNGLoader.h>
 #include <LibGfx/ImageFormats/PNGShared.h>
+#include <LibGfx/PixelKernels.h>
 #include <string.h>
 
+#pragma GCC diagnostic ignored "-Wpsabi"
+
 namespace Gfx {
 
+using namespace AK::SIMD;
+
 struct PNG_IHDR {
     NetworkOrdered<u32> width;
     NetworkOrdered<u32> height;
@@ -52,11 +61,6 @@ struct EmbeddedICCProfile {
     ReadonlyBytes compressed_data;
 };
 
-struct Scanline {
-    PNG::FilterType filter;
-    ReadonlyBytes data {};
-};
-
 struct [[gnu::packed]] PaletteEntry {
     u8 r;
     u8 g;
@@ -121,11 +125,12 @@ struct PNGLoadingContext {
     u8 channels { 0 };
     bool has_seen_zlib_header { false };
     bool has_alpha() const { return to_underlying(color_type) & 4 || palette_transparency_data.size() > 0; }
-    Vector<Scanline> scanlines;
-    ByteBuffer unfiltered_data;
     RefPtr<Gfx::Bitmap> bitmap;
-    ByteBuffer* decompression_buffer { nullptr };
+    // The number of rows at the top of the bitmap that have been decoded completely.
+    int decoded_height { 0 };
     Vector<u8> compressed_data;
+    // Set when the data ends in the middle of an IDAT chunk.
+    bool compressed_data_is_incomplete { false };
     Vector<PaletteEntry> palette_data;
     Vector<u8> palette_transparency_data;
 
@@ -191,6 +196,7 @@ public:
     }
 
     bool at_end() const { return !m_size_remaining; }
+    size_t remaining() const { return m_size_remaining; }
 
 private:
     u8 const* m_data_ptr { nullptr };
@@ -199,66 +205,116 @@ private:
 
 static bool process_chunk(Streamer&, PNGLoadingContext& context);
 
-union [[gnu::packed]] Pixel {
-    ARGB32 rgba { 0 };
-    u8 v[4];
-    struct {
-        u8 r;
-        u8 g;
-        u8 b;
-        u8 a;
-    };
+// Rows are unfiltered in place, next to the row above them that the filters refer to. Both have room for a pixel in
+// front of them that's always zero, so that the filters can treat the first pixel like any other, and some room
+// behind them, so that whole vectors can be loaded for the last pixels.
+class ScanlineBuffers {
+public:
+    // The biggest pixels have four 16-bit samples.
+    static constexpr size_t padding = 8;
+
+    static ErrorOr<ScanlineBuffers> create(size_t row_size)
+    {
+        auto current = TRY(ByteBuffer::create_zeroed(row_size + 2 * padding));
+        auto previous = TRY(ByteBuffer::create_zeroed(row_size + 2 * padding));
+        return ScanlineBuffers { row_size, move(current), move(previous) };
+    }
+
+    Bytes current() { return m_current.bytes().slice(padding, m_row_size); }
+    ReadonlyBytes previous() const { return m_previous.bytes().slice(padding, m_row_size); }
+
+    void advance() { swap(m_current, m_previous); }
+
+private:
+    ScanlineBuffers(size_t row_size, ByteBuffer current, ByteBuffer previous)
+        : m_row_size(row_size)
+        , m_current(move(current))
+        , m_previous(move(previous))
+    {
+    }
+
+    size_t m_row_size { 0 };
+    ByteBuffer m_current;
+    ByteBuffer m_previous;
 };
-static_assert(AssertSize<Pixel, 4>());
 
-static void unfilter_scanline(PNG::FilterType filter, Bytes scanline_data, ReadonlyBytes previous_scanlines_data, u8 bytes_per_complete_pixel)
+template<typename VectorType>
+ALWAYS_INLINE static VectorType load(u8 const* data)
 {
-    VERIFY(filter != PNG::FilterType::None);
+    VectorType vector;
+    __builtin_memcpy(&vector, data, sizeof(vector));
+    return vector;
+}
 
+template<typename VectorType>
+ALWAYS_INLINE static void store(u8* data, VectorType vector)
+{
+    __builtin_memcpy(data, &vector, sizeof(vector));
+}
+
+template<size_t bytes_per_pixel, typename VectorType>
+ALWAYS_INLINE static void store_pixel(u8* data, VectorType vector)
+{
+    __builtin_memcpy(data, &vector, bytes_per_pixel);
+}
+
+template<typename VectorType>
+ALWAYS_INLINE static VectorType absolute_value(VectorType vector)
+{
+    return vector < 0 ? -vector : vector;
+}
+
+static void unfilter_up(u8* scanline_data, u8 const* previous_scanlines_data, size_t size)
+{
+    size_t i = 0;
+    for (; i + sizeof(u8x16) <= size; i += sizeof(u8x16))
+        store(scanline_data + i, load<u8x16>(scanline_data + i) + load<u8x16>(previous_scanlines_data + i));
+    for (; i < size; ++i)
+        scanline_data[i] += previous_scanlines_data[i];
+}
+
+// The other filters predict each byte from the pixel to its left, so they can't work on more than one pixel at a
+// time. They can work on all bytes of a pixel at once, though. The bytes that are loaded past the end of the pixel
+// are never stored.
+template<size_t bytes_per_pixel>
+static void unfilter_with_left_pixel(PNG::FilterType filter, u8* scanline_data, u8 const* previous_scanlines_data, size_t size)
+{
+    using ByteVector = Conditional<bytes_per_pixel <= 4, u8x4, u8x8>;
+    using WideVector = Conditional<bytes_per_pixel <= 4, i16x4, i16x8>;
+
+    ByteVector left {};
+    ByteVector upper_left {};
     switch (filter) {
     case PNG::FilterType::Sub:
-        // This loop starts at bytes_per_complete_pixel because all bytes before that are
-        // guaranteed to have no valid byte at index (i - bytes_per_complete pixel).
-        // All such invalid byte indexes should be treated as 0, and adding 0 to the current
-        // byte would do nothing, so the first bytes_per_complete_pixel bytes can instead
-        // just be skipped.
-        for (size_t i = bytes_per_complete_pixel; i < scanline_data.size(); ++i) {
-            u8 left = scanline_data[i - bytes_per_complete_pixel];
-            scanline_data[i] += left;
-        }
-        break;
-    case PNG::FilterType::Up:
-        for (size_t i = 0; i < scanline_data.size(); ++i) {
-            u8 above = previous_scanlines_data[i];
-            scanline_data[i] += above;
+        for (size_t i = 0; i < size; i += bytes_per_pixel) {
+            left += load<ByteVector>(scanline_data + i);
+            store_pixel<bytes_per_pixel>(scanline_data + i, left);
         }
         break;
     case PNG::FilterType::Average:
-        for (size_t i = 0; i < scanline_data.size(); ++i) {
-            u32 left = (i < bytes_per_complete_pixel) ? 0 : scanline_data[i - bytes_per_complete_pixel];
-            u32 above = previous_scanlines_data[i];
-            u8 average = (left + above) / 2;
-            scanline_data[i] += average;
+        for (size_t i = 0; i < size; i += bytes_per_pixel) {
+            auto above = __builtin_convertvector(load<ByteVector>(previous_scanlines_data + i), WideVector);
+            auto average = (__builtin_convertvector(left, WideVector) + above) >> 1;
+            left = load<ByteVector>(scanline_data + i) + __builtin_convertvector(average, ByteVector);
+            store_pixel<bytes_per_pixel>(scanline_data + i, left);
         }
         break;
     case PNG::FilterType::Paeth:
-        for (size_t i = 0; i < scanline_data.size(); ++i) {
-            u8 left = (i < bytes_per_complete_pixel) ? 0 : scanline_data[i - bytes_per_complete_pixel];
-            u8 above = previous_scanlines_data[i];
-            u8 upper_left = (i < bytes_per_complete_pixel) ? 0 : previous_scanlines_data[i - bytes_per_complete_pixel];
-            i32 predictor = left + above - upper_left;
-            u32 predictor_left = abs(predictor - left);
-            u32 predictor_above = abs(predictor - above);
-            u32 predictor_upper_left = abs(predictor - upper_left);
-            u8 nearest;
-            if (predictor_left <= predictor_above && predictor_left <= predictor_upper_left) {
-                nearest = left;
-            } else if (predictor_above <= predictor_upper_left) {
-                nearest = above;
-            } else {
-                nearest = upper_left;
-            }
-            scanline_data[i] += nearest;
+        for (size_t i = 0; i < size; i += bytes_per_pixel) {
+            auto above = load<ByteVector>(previous_scanlines_data + i);
+            auto a = __builtin_convertvector(left, WideVector);
+            auto b = __builtin_convertvector(above, WideVector);
+            auto c = __builtin_convertvector(upper_left, WideVector);
+            // These are the distances of the predictor a + b - c to a, b and c.
+            auto predictor_left = absolute_value(b - c);
+            auto predictor_above = absolute_value(a - c);
+            auto predictor_upper_left = absolute_value(a + b - c - c);
+            auto nearest = (predictor_left <= predictor_above) & (predictor_left <= predictor_upper_left)
+                ? a
+                : (predictor_above <= predictor_upper_left ? b : c);
+            left = load<ByteVector>(scanline_data + i) + __builtin_convertvector(nearest, ByteVector);
+            store_pixel<bytes_per_pixel>(scanline_data + i, left);
+            upper_left = above;
         }
         break;
     default:
@@ -266,133 +322,145 @@ static void unfilter_scanline(PNG::FilterType filter, Bytes scanline_data, Reado
     }
 }
 
-template<typename T>
-ALWAYS_INLINE static void unpack_grayscale_without_alpha(PNGLoadingContext& context)
+// Both rows have to come from ScanlineBuffers, the filters read the pixel in front of them and past their end.
+static void unfilter_scanline(PNG::FilterType filter, Bytes scanline_data, ReadonlyBytes previous_scanlines_data, u8 bytes_per_complete_pixel)
 {
-    for (int y = 0; y < context.height; ++y) {
-        auto* gray_values = reinterpret_cast<T const*>(context.scanlines[y].data.data());
-        for (int i = 0; i < context.width; ++i) {
-            auto& pixel = (Pixel&)context.bitmap->scanline(y)[i];
-            pixel.r = gray_values[i];
-            pixel.g = gray_values[i];
-            pixel.b = gray_values[i];
-            pixel.a = 0xff;
-        }
+    switch (filter) {
+    case PNG::FilterType::None:
+        return;
+    case PNG::FilterType::Up:
+        unfilter_up(scanline_data.data(), previous_scanlines_data.data(), scanline_data.size());
+        return;
+    default:
+        break;
+    }
+
+    switch (bytes_per_complete_pixel) {
+    case 1:
+        return unfilter_with_left_pixel<1>(filter, scanline_data.data(), previous_scanlines_data.data(), scanline_data.size());
+    case 2:
+        return unfilter_with_left_pixel<2>(filter, scanline_data.data(), previous_scanlines_data.data(), scanline_data.size());
+    case 3:
+        return unfilter_with_left_pixel<3>(filter, scanline_data.data(), previous_scanlines_data.data(), scanline_data.size());
+    case 4:
+        return unfilter_with_left_pixel<4>(filter, scanline_data.data(), previous_scanlines_data.data(), scanline_data.size());
+    case 6:
+        return unfilter_with_left_pixel<6>(filter, scanline_data.data(), previous_scanlines_data.data(), scanline_data.size());
+    case 8:
+        return unfilter_with_left_pixel<8>(filter, scanline_data.data(), previous_scanlines_data.data(), scanline_data.size());
+    default:
+        VERIFY_NOT_REACHED();
     }
 }
 
+ALWAYS_INLINE static ARGB32 make_pixel(u8 r, u8 g, u8 b, u8 a)
+{
+    return Color(r, g, b, a).value();
+}
+
+// 16-bit samples are read in the machine's byte order and truncated, which keeps their most significant byte.
 template<typename T>
-ALWAYS_INLINE static void unpack_grayscale_with_alpha(PNGLoadingContext& context)
+ALWAYS_INLINE static void unpack_grayscale_without_alpha(ReadonlyBytes data, ARGB32* pixels, int width)
 {
-    for (int y = 0; y < context.height; ++y) {
-        auto* tuples = reinterpret_cast<Tuple<T> const*>(context.scanlines[y].data.data());
-        for (int i = 0; i < context.width; ++i) {
-            auto& pixel = (Pixel&)context.bitmap->scanline(y)[i];
-            pixel.r = tuples[i].gray;
-            pixel.g = tuples[i].gray;
-            pixel.b = tuples[i].gray;
-            pixel.a = tuples[i].a;
+    auto* gray_values = reinterpret_cast<T const*>(data.data());
+    int i = 0;
+    if constexpr (IsSame<T, u8>) {
+        u8x4 const opaque = { 0xff, 0xff, 0xff, 0xff };
+        for (; i + 4 <= width; i += 4) {
+            auto grays = load<u8x4>(gray_values + i);
+            store(bit_cast<u8*>(pixels + i), __builtin_shufflevector(grays, opaque, 0, 0, 0, 4, 1, 1, 1, 4, 2, 2, 2, 4, 3, 3, 3, 4));
         }
     }
+    for (; i < width; ++i)
+        pixels[i] = make_pixel(gray_values[i], gray_values[i], gray_values[i], 0xff);
 }
 
 template<typename T>
-ALWAYS_INLINE static void unpack_triplets_without_alpha(PNGLoadingContext& context)
+ALWAYS_INLINE static void unpack_grayscale_with_alpha(ReadonlyBytes data, ARGB32* pixels, int width)
 {
-    for (int y = 0; y < context.height; ++y) {
-        auto* triplets = reinterpret_cast<Triplet<T> const*>(context.scanlines[y].data.data());
-        for (int i = 0; i < context.width; ++i) {
-            auto& pixel = (Pixel&)context.bitmap->scanline(y)[i];
-            pixel.r = triplets[i].r;
-            pixel.g = triplets[i].g;
-            pixel.b = triplets[i].b;
-            pixel.a = 0xff;
-        }
-    }
+    auto* tuples = reinterpret_cast<Tuple<T> const*>(data.data());
+    for (int i = 0; i < width; ++i)
+        pixels[i] = make_pixel(tuples[i].gray, tuples[i].gray, tuples[i].gray, tuples[i].a);
 }
 
 template<typename T>
-ALWAYS_INLINE static void unpack_triplets_with_transparency_value(PNGLoadingContext& context, Triplet<T> transparency_value)
+ALWAYS_INLINE static void unpack_triplets_without_alpha(ReadonlyBytes data, ARGB32* pixels, int width)
 {
-    for (int y = 0; y < context.height; ++y) {
-        auto* triplets = reinterpret_cast<Triplet<T> const*>(context.scanlines[y].data.data());
-        for (int i = 0; i < context.width; ++i) {
-            auto& pixel = (Pixel&)context.bitmap->scanline(y)[i];
-            pixel.r = triplets[i].r;
-            pixel.g = triplets[i].g;
-            pixel.b = triplets[i].b;
-            if (triplets[i] == transparency_value)
-                pixel.a = 0x00;
-            else
-                pixel.a = 0xff;
+    auto* triplets = reinterpret_cast<Triplet<T> const*>(data.data());
+    int i = 0;
+    if constexpr (IsSame<T, u8>) {
+        // Four pixels at a time, from the first 12 bytes of the vector. ScanlineBuffers has room for the rest.
+        u8x16 const opaque = { 0, 0xff };
+        for (; i + 4 <= width; i += 4) {
+            auto samples = load<u8x16>(data.data() + i * 3);
+            store(bit_cast<u8*>(pixels + i), __builtin_shufflevector(samples, opaque, 2, 1, 0, 17, 5, 4, 3, 17, 8, 7, 6, 17, 11, 10, 9, 17));
         }
     }
+    for (; i < width; ++i)
+        pixels[i] = make_pixel(triplets[i].r, triplets[i].g, triplets[i].b, 0xff);
 }
 
-NEVER_INLINE FLATTEN static ErrorOr<void> unfilter(PNGLoadingContext& context)
+template<typename T>
+ALWAYS_INLINE static void unpack_triplets_with_transparency_value(ReadonlyBytes data, ARGB32* pixels, int width, Triplet<T> transparency_value)
 {
-    // First unfilter the scanlines:
+    auto* triplets = reinterpret_cast<Triplet<T> const*>(data.data());
+    for (int i = 0; i < width; ++i)
+        pixels[i] = make_pixel(triplets[i].r, triplets[i].g, triplets[i].b, triplets[i] == transparency_value ? 0x00 : 0xff);
+}
 
-    // FIXME: Instead of creating a separate buffer for the scanlines that need to be
-    //        mutated, the mutation could be done in place (if the data was non-const).
-    size_t bytes_per_scanline = context.scanlines[0].data.size();
-    size_t bytes_needed_for_all_unfiltered_scanlines = 0;
-    for (int y = 0; y < context.height; ++y) {
-        if (context.scanlines[y].filter != PNG::FilterType::None) {
-            bytes_needed_for_all_unfiltered_scanlines += bytes_per_scanline;
-        }
+template<typename T>
+ALWAYS_INLINE static void unpack_quartets(ReadonlyBytes data, ARGB32* pixels, int width)
+{
+    if constexpr (IsSame<T, u8>) {
+        PixelKernels::swap_red_and_blue(pixels, reinterpret_cast<u32 const*>(data.data()), width);
+    } else {
+        auto* quartets = reinterpret_cast<Quartet<T> const*>(data.data());
+        for (int i = 0; i < width; ++i)
+            pixels[i] = make_pixel(quartets[i].r, quartets[i].g, quartets[i].b, quartets[i].a);
     }
-    context.unfiltered_data = TRY(ByteBuffer::create_uninitialized(bytes_needed_for_all_unfiltered_scanlines));
-
-    // From section 6.3 of http://www.libpng.org/pub/png/spec/1.2/PNG-Filters.html
-    // "bpp is defined as the number of bytes per complete pixel, rounding up to one.
-    // For example, for color type 2 with a bit depth of 16, bpp is equal to 6
-    // (three samples, two bytes per sample); for color type 0 with a bit depth of 2,
-    // bpp is equal to 1 (rounding up); for color type 4 with a bit depth of 16, bpp
-    // is equal to 4 (two-byte grayscale sample, plus two-byte alpha sample)."
-    u8 bytes_per_complete_pixel = (context.bit_depth + 7) / 8 * context.channels;
-
-    u8 dummy_scanline_bytes[bytes_per_scanline];
-    memset(dummy_scanline_bytes, 0, sizeof(dummy_scanline_bytes));
-    auto previous_scanlines_data = ReadonlyBytes { dummy_scanline_bytes, sizeof(dummy_scanline_bytes) };
-
-    for (int y = 0, data_start = 0; y < context.height; ++y) {
-        if (context.scanlines[y].filter != PNG::FilterType::None) {
-            auto scanline_data_slice = context.unfiltered_data.bytes().slice(data_start, bytes_per_scanline);
-
-            // Copy the current values over and set the scanline's data to the to-be-mutated slice
-            context.scanlines[y].data.copy_to(scanline_data_slice);
-            context.scanlines[y].data = scanline_data_slice;
-
-            unfilter_scanline(context.scanlines[y].filter, scanline_data_slice, previous_scanlines_data, bytes_per_complete_pixel);
+}
 
-            data_start += bytes_per_scanline;
+static ErrorOr<void> unpack_palette_indices(PNGLoadingContext const& context, ReadonlyBytes data, ARGB32* pixels, int width, Span<ARGB32 const> palette)
+{
+    if (context.bit_depth == 8) {
+        for (int i = 0; i < width; ++i) {
+            if (data[i] >= palette.size())
+                return Error::from_string_literal("PNGImageDecoderPlugin: Palette index out of range");
+            pixels[i] = palette[data[i]];
         }
-        previous_scanlines_data = context.scanlines[y].data;
+        return {};
+    }
+
+    auto pixels_per_byte = 8 / context.bit_depth;
+    auto mask = (1 << context.bit_depth) - 1;
+    for (int i = 0; i < width; ++i) {
+        auto bit_offset = (8 - context.bit_depth) - (context.bit_depth * (i % pixels_per_byte));
+        auto palette_index = (data[i / pixels_per_byte] >> bit_offset) & mask;
+        if ((size_t)palette_index >= palette.size())
+            return Error::from_string_literal("PNGImageDecoderPlugin: Palette index out of range");
+        pixels[i] = palette[palette_index];
     }
+    return {};
+}
 
-    // Now unpack the scanlines to RGBA:
+// Turns a row of unfiltered samples into BGRA8888 pixels. The palette has to be the one that make_palette() returns.
+static ErrorOr<void> unpack_scanline(PNGLoadingContext const& context, ReadonlyBytes data, ARGB32* pixels, int width, Span<ARGB32 const> palette)
+{
     switch (context.color_type) {
     case PNG::ColorType::Greyscale:
         if (context.bit_depth == 8) {
-            unpack_grayscale_without_alpha<u8>(context);
+            unpack_grayscale_without_alpha<u8>(data, pixels, width);
         } else if (context.bit_depth == 16) {
-            unpack_grayscale_without_alpha<u16>(context);
+            unpack_grayscale_without_alpha<u16>(data, pixels, width);
         } else if (context.bit_depth == 1 || context.bit_depth == 2 || context.bit_depth == 4) {
             auto bit_depth_squared = context.bit_depth * context.bit_depth;
             auto pixels_per_byte = 8 / context.bit_depth;
             auto mask = (1 << context.bit_depth) - 1;
-            for (int y = 0; y < context.height; ++y) {
-                auto* gray_values = context.scanlines[y].data.data();
-                for (int x = 0; x < context.width; ++x) {
-                    auto bit_offset = (8 - context.bit_depth) - (context.bit_depth * (x % pixels_per_byte));
-                    auto value = (gray_values[x / pixels_per_byte] >> bit_offset) & mask;
-                    auto& pixel = (Pixel&)context.bitmap->scanline(y)[x];
-                    pixel.r = value * (0xff / bit_depth_squared);
-                    pixel.g = value * (0xff / bit_depth_squared);
-                    pixel.b = value * (0xff / bit_depth_squared);
-                    pixel.a = 0xff;
-                }
+            for (int x = 0; x < width; ++x) {
+                auto bit_offset = (8 - context.bit_depth) - (context.bit_depth * (x % pixels_per_byte));
+                auto value = (data[x / pixels_per_byte] >> bit_offset) & mask;
+                u8 gray = value * (0xff / bit_depth_squared);
+                pixels[x] = make_pixel(gray, gray, gray, 0xff);
             }
         } else {
             VERIFY_NOT_REACHED();
@@ -400,9 +468,9 @@ NEVER_INLINE FLATTEN static ErrorOr<void> unfilter(PNGLoadingContext& context)
         break;
     case PNG::ColorType::GreyscaleWithAlpha:
         if (context.bit_depth == 8) {
-            unpack_grayscale_with_alpha<u8>(context);
+            unpack_grayscale_with_alpha<u8>(data, pixels, width);
         } else if (context.bit_depth == 16) {
-            unpack_grayscale_with_alpha<u16>(context);
+            unpack_grayscale_with_alpha<u16>(data, pixels, width);
         } else {
             VERIFY_NOT_REACHED();
         }
@@ -410,102 +478,56 @@ NEVER_INLINE FLATTEN static ErrorOr<void> unfilter(PNGLoadingContext& context)
     case PNG::ColorType::Truecolor:
         if (context.palette_transparency_data.size() == 6) {
             if (context.bit_depth == 8) {
-                unpack_triplets_with_transparency_value<u8>(context, Triplet<u8> { context.palette_transparency_data[0], context.palette_transparency_data[2], context.palette_transparency_data[4] });
+                unpack_triplets_with_transparency_value<u8>(data, pixels, width, Triplet<u8> { context.palette_transparency_data[0], context.palette_transparency_data[2], context.palette_transparency_data[4] });
             } else if (context.bit_depth == 16) {
                 u16 tr = context.palette_transparency_data[0] | context.palette_transparency_data[1] << 8;
                 u16 tg = context.palette_transparency_data[2] | context.palette_transparency_data[3] << 8;
                 u16 tb = context.palette_transparency_data[4] | context.palette_transparency_data[5] << 8;
-                unpack_triplets_with_transparency_value<u16>(context, Triplet<u16> { tr, tg, tb });
+                unpack_triplets_with_transparency_value<u16>(data, pixels, width, Triplet<u16> { tr, tg, tb });
             } else {
                 VERIFY_NOT_REACHED();
             }
         } else {
             if (context.bit_depth == 8)
-                unpack_triplets_without_alpha<u8>(context);
+                unpack_triplets_without_alpha<u8>(data, pixels, width);
             else if (context.bit_depth == 16)
-                unpack_triplets_without_alpha<u16>(context);
+                unpack_triplets_without_alpha<u16>(data, pixels, width);
             else
                 VERIFY_NOT_REACHED();
         }
         break;
     case PNG::ColorType::TruecolorWithAlpha:
-        if (context.bit_depth == 8) {
-            for (int y = 0; y < context.height; ++y) {
-                memcpy(context.bitmap->scanline(y), context.scanlines[y].data.data(), context.scanlines[y].data.size());
-            }
-        } else if (context.bit_depth == 16) {
-            for (int y = 0; y < context.height; ++y) {
-                auto* quartets = reinterpret_cast<Quartet<u16> const*>(context.scanlines[y].data.data());
-                for (int i = 0; i < context.width; ++i) {
-                    auto& pixel = (Pixel&)context.bitmap->scanline(y)[i];
-                    pixel.r = quartets[i].r & 0xFF;
-                    pixel.g = quartets[i].g & 0xFF;
-                    pixel.b = quartets[i].b & 0xFF;
-                    pixel.a = quartets[i].a & 0xFF;
-                }
-            }
-        } else {
+        if (context.bit_depth == 8)
+            unpack_quartets<u8>(data, pixels, width);
+        else if (context.bit_depth == 16)
+            unpack_quartets<u16>(data, pixels, width);
+        else
             VERIFY_NOT_REACHED();
-        }
         break;
     case PNG::ColorType::IndexedColor:
-        if (context.bit_depth == 8) {
-            for (int y = 0; y < context.height; ++y) {
-                auto* palette_index = context.scanlines[y].data.data();
-                for (int i = 0; i < context.width; ++i) {
-                    auto& pixel = (Pixel&)context.bitmap->scanline(y)[i];
-                    if (palette_index[i] >= context.palette_data.size())
-                        return Error::from_string_literal("PNGImageDecoderPlugin: Palette index out of range");
-                    auto& color = context.palette_data.at((int)palette_index[i]);
-                    auto transparency = context.palette_transparency_data.size() >= palette_index[i] + 1u
-                        ? context.palette_transparency_data.data()[palette_index[i]]
-                        : 0xff;
-                    pixel.r = color.r;
-                    pixel.g = color.g;
-                    pixel.b = color.b;
-                    pixel.a = transparency;
-                }
-            }
-        } else if (context.bit_depth == 1 || context.bit_depth == 2 || context.bit_depth == 4) {
-            auto pixels_per_byte = 8 / context.bit_depth;
-            auto mask = (1 << context.bit_depth) - 1;
-            for (int y = 0; y < context.height; ++y) {
-                auto* palette_indices = context.scanlines[y].data.data();
-                for (int i = 0; i < context.width; ++i) {
-                    auto bit_offset = (8 - context.bit_depth) - (context.bit_depth * (i % pixels_per_byte));
-                    auto palette_index = (palette_indices[i / pixels_per_byte] >> bit_offset) & mask;
-                    auto& pixel = (Pixel&)context.bitmap->scanline(y)[i];
-                    if ((size_t)palette_index >= context.palette_data.size())
-                        return Error::from_string_literal("PNGImageDecoderPlugin: Palette index out of range");
-                    auto& color = context.palette_data.at(palette_index);
-                    auto transparency = context.palette_transparency_data.size() >= palette_index + 1u
-                        ? context.palette_transparency_data.data()[palette_index]
-                        : 0xff;
-                    pixel.r = color.r;
-                    pixel.g = color.g;
-                    pixel.b = color.b;
-                    pixel.a = transparency;
-                }
-            }
-        } else {
-            VERIFY_NOT_REACHED();
-        }
+        TRY(unpack_palette_indices(context, data, pixels, width, palette));
         break;
     default:
         VERIFY_NOT_REACHED();
         break;
     }
+    return {};
+}
 
-    // Swap r and b values:
-    for (int y = 0; y < context.height; ++y) {
-        auto* pixels = (Pixel*)context.bitmap->scanline(y);
-        for (int i = 0; i < context.bitmap->width(); ++i) {
-            auto& x = pixels[i];
-            swap(x.r, x.b);
-        }
+// Looks up the pixel for each palette index once, instead of for every pixel.
+static ErrorOr<Vector<ARGB32>> make_palette(PNGLoadingContext const& context)
+{
+    Vector<ARGB32> palette;
+    if (context.color_type != PNG::ColorType::IndexedColor)
+        return palette;
+
+    TRY(palette.try_ensure_capacity(context.palette_data.size()));
+    for (size_t i = 0; i < context.palette_data.size(); ++i) {
+        auto& color = context.palette_data[i];
+        auto transparency = i < context.palette_transparency_data.size() ? context.palette_transparency_data[i] : 0xff;
+        palette.unchecked_append(make_pixel(color.r, color.g, color.b, transparency));
     }
-
-    return {};
+    return palette;
 }
 
 static bool decode_png_header(PNGLoadingContext& context)
@@ -585,38 +607,6 @@ static bool decode_png_chunks(PNGLoadingContext& context)
     return true;
 }
 
-static ErrorOr<void> decode_png_bitmap_simple(PNGLoadingContext& context)
-{
-    Streamer streamer(context.decompression_buffer->data(), context.decompression_buffer->size());
-
-    for (int y = 0; y < context.height; ++y) {
-        PNG::FilterType filter;
-        if (!streamer.read(filter)) {
-            context.state = PNGLoadingContext::State::Error;
-            return Error::from_string_literal("PNGImageDecoderPlugin: Decoding failed");
-        }
-
-        if (to_underlying(filter) > 4) {
-            context.state = PNGLoadingContext::State::Error;
-            return Error::from_string_literal("PNGImageDecoderPlugin: Invalid PNG filter");
-        }
-
-        context.scanlines.append({ filter });
-        auto& scanline_buffer = context.scanlines.last().data;
-        auto row_size = context.compute_row_size_for_width(context.width);
-        if (row_size.has_overflow())
-            return Error::from_string_literal("PNGImageDecoderPlugin: Row size overflow");
-
-        if (!streamer.wrap_bytes(scanline_buffer, row_size.value())) {
-            context.state = PNGLoadingContext::State::Error;
-            return Error::from_string_literal("PNGImageDecoderPlugin: Decoding failed");
-        }
-    }
-
-    context.bitmap = TRY(Bitmap::create(context.has_alpha() ? BitmapFormat::BGRA8888 : BitmapFormat::BGRx8888, { context.width, context.height }));
-    return unfilter(context);
-}
-
 static int adam7_height(PNGLoadingContext& context, int pass)
 {
     switch (pass) {
@@ -667,65 +657,122 @@ static int adam7_startx[8] = { 0, 0, 4, 0, 2, 0, 1, 0 };
 static int adam7_stepy[8] = { 1, 8, 8, 8, 4, 4, 2, 2 };
 static int adam7_stepx[8] = { 1, 8, 8, 4, 4, 2, 2, 1 };
 
-static ErrorOr<void> decode_adam7_pass(PNGLoadingContext& context, Streamer& streamer, int pass)
-{
-    PNGLoadingContext subimage_context;
-    subimage_context.width = adam7_width(context, pass);
-    subimage_context.height = adam7_height(context, pass);
-    subimage_context.channels = context.channels;
-    subimage_context.color_type = context.color_type;
-    subimage_context.palette_data = context.palette_data;
-    subimage_context.palette_transparency_data = context.palette_transparency_data;
-    subimage_context.bit_depth = context.bit_depth;
-    subimage_context.filter_method = context.filter_method;
+// Inflates the image data as the rows are read, so that it never has to be kept in memory all at once.
+class ImageDataStream {
+    AK_MAKE_NONCOPYABLE(ImageDataStream);
+    AK_MAKE_NONMOVABLE(ImageDataStream);
 
-    // For small images, some passes might be empty
-    if (!subimage_context.width || !subimage_context.height)
+public:
+    ImageDataStream(ReadonlyBytes compressed_data, bool compressed_data_is_incomplete)
+        : m_compressed_stream(compressed_data)
+        , m_bit_stream(MaybeOwned<Stream>(m_compressed_stream))
+        , m_compressed_data_is_incomplete(compressed_data_is_incomplete)
+    {
+    }
+
+    ErrorOr<void> initialize()
+    {
+        m_decompressor = TRY(Compress::DeflateDecompressor::construct(MaybeOwned<LittleEndianInputBitStream>(m_bit_stream)));
         return {};
+    }
 
-    subimage_context.scanlines.clear_with_capacity();
-    for (int y = 0; y < subimage_context.height; ++y) {
-        PNG::FilterType filter;
-        if (!streamer.read(filter)) {
-            context.state = PNGLoadingContext::State::Error;
-            return Error::from_string_literal("PNGImageDecoderPlugin: Decoding failed");
-        }
+    ErrorOr<void> read(Bytes bytes)
+    {
+        TRY(m_decompressor->read_until_filled(bytes));
+        // The decompressor doesn't notice when the compressed data stops early, and goes on with bits that aren't
+        // there. Only what it has read before the end of the data can be trusted then.
+        if (m_compressed_data_is_incomplete && m_compressed_stream.is_eof())
+            return Error::from_string_literal("Image data ends early");
+        return {};
+    }
 
-        if (to_underlying(filter) > 4) {
-            context.state = PNGLoadingContext::State::Error;
-            return Error::from_string_literal("PNGImageDecoderPlugin: Invalid PNG filter");
-        }
+private:
+    FixedMemoryStream m_compressed_stream;
+    LittleEndianInputBitStream m_bit_stream;
+    OwnPtr<Compress::DeflateDecompressor> m_decompressor;
+    bool m_compressed_data_is_incomplete { false };
+};
 
-        subimage_context.scanlines.append({ filter });
-        auto& scanline_buffer = subimage_context.scanlines.last().data;
+// Inflates the next row of the image data, and unfilters it.
+static ErrorOr<ReadonlyBytes> read_scanline(PNGLoadingContext& context, ImageDataStream& image_data, ScanlineBuffers& buffers)
+{
+    buffers.advance();
 
-        auto row_size = context.compute_row_size_for_width(subimage_context.width);
-        if (row_size.has_overflow())
-            return Error::from_string_literal("PNGImageDecoderPlugin: Row size overflow");
-        if (!streamer.wrap_bytes(scanline_buffer, row_size.value())) {
-            context.state = PNGLoadingContext::State::Error;
-            return Error::from_string_literal("PNGImageDecoderPlugin: Decoding failed");
-        }
+    PNG::FilterType filter;
+    auto scanline_data = buffers.current();
+    if (image_data.read({ &filter, sizeof(filter) }).is_error() || image_data.read(scanline_data).is_error()) {
+        context.state = PNGLoadingContext::State::Error;
+        return Error::from_string_literal("PNGImageDecoderPlugin: Decoding failed");
     }
 
-    subimage_context.bitmap = TRY(Bitmap::create(context.bitmap->format(), { subimage_context.width, subimage_context.height }));
-    TRY(unfilter(subimage_context));
+    if (to_underlying(filter) > 4) {
+        context.state = PNGLoadingContext::State::Error;
+        return Error::from_string_literal("PNGImageDecoderPlugin: Invalid PNG filter");
+    }
 
-    // Copy the subimage data into the main image according to the pass pattern
-    for (int y = 0, dy = adam7_starty[pass]; y < subimage_context.height && dy < context.height; ++y, dy += adam7_stepy[pass]) {
-        for (int x = 0, dx = adam7_startx[pass]; x < subimage_context.width && dy < context.width; ++x, dx += adam7_stepx[pass]) {
-            context.bitmap->set_pixel(dx, dy, subimage_context.bitmap->get_pixel(x, y));
-        }
+    // From section 6.3 of http://www.libpng.org/pub/png/spec/1.2/PNG-Filters.html
+    // "bpp is defined as the number of bytes per complete pixel, rounding up to one.
+    // For example, for color type 2 with a bit depth of 16, bpp is equal to 6
+    // (three samples, two bytes per sample); for color type 0 with a bit depth of 2,
+    // bpp is equal to 1 (rounding up); for color type 4 with a bit depth of 16, bpp
+    // is equal to 4 (two-byte grayscale sample, plus two-byte alpha sample)."
+    u8 bytes_per_complete_pixel = (context.bit_depth + 7) / 8 * context.channels;
+    unfilter_scanline(filter, scanline_data, buffers.previous(), bytes_per_complete_pixel);
+    return scanline_data;
+}
+
+static ErrorOr<ScanlineBuffers> create_scanline_buffers(PNGLoadingContext& context, int width)
+{
+    auto row_size = context.compute_row_size_for_width(width);
+    if (row_size.has_overflow())
+        return Error::from_string_literal("PNGImageDecoderPlugin: Row size overflow");
+    return ScanlineBuffers::create(row_size.value());
+}
+
+static ErrorOr<void> decode_png_bitmap_simple(PNGLoadingContext& context, ImageDataStream& image_data, Span<ARGB32 const> palette)
+{
+    auto buffers = TRY(create_scanline_buffers(context, context.width));
+    for (int y = 0; y < context.height; ++y) {
+        auto scanline_data = TRY(read_scanline(context, image_data, buffers));
+        TRY(unpack_scanline(context, scanline_data, context.bitmap->scanline(y), context.width, palette));
+        context.decoded_height = y + 1;
     }
     return {};
 }
 
-static ErrorOr<void> decode_png_adam7(PNGLoadingContext& context)
+static ErrorOr<void> decode_adam7_pass(PNGLoadingContext& context, ImageDataStream& image_data, Span<ARGB32 const> palette, int pass)
+{
+    int width = adam7_width(context, pass);
+    int height = adam7_height(context, pass);
+
+    // For small images, some passes might be empty
+    if (!width || !height)
+        return {};
+
+    auto buffers = TRY(create_scanline_buffers(context, width));
+    Vector<ARGB32> pixels;
+    TRY(pixels.try_resize(width));
+    for (int y = 0, dy = adam7_starty[pass]; y < height; ++y, dy += adam7_stepy[pass]) {
+        auto scanline_data = TRY(read_scanline(context, image_data, buffers));
+        TRY(unpack_scanline(context, scanline_data, pixels.data(), width, palette));
+
+        // Copy the pass's pixels into the main image according to the pass pattern
+        auto* destination = context.bitmap->scanline(dy);
+        for (int x = 0, dx = adam7_startx[pass]; x < width; ++x, dx += adam7_stepx[pass])
+            destination[dx] = pixels[x];
+
+        // The last pass fills in the odd rows, all others are complete by then.
+        if (pass == 7)
+            context.decoded_height = min(dy + 1, context.height);
+    }
+    return {};
+}
+
+static ErrorOr<void> decode_png_adam7(PNGLoadingContext& context, ImageDataStream& image_data, Span<ARGB32 const> palette)
 {
-    Streamer streamer(context.decompression_buffer->data(), context.decompression_buffer->size());
-    context.bitmap = TRY(Bitmap::create(context.has_alpha() ? BitmapFormat::BGRA8888 : BitmapFormat::BGRx8888, { context.width, context.height }));
     for (int pass = 1; pass <= 7; ++pass)
-        TRY(decode_adam7_pass(context, streamer, pass));
+        TRY(decode_adam7_pass(context, image_data, palette, pass));
+    context.decoded_height = context.height;
     return {};
 }
 
@@ -745,29 +792,28 @@ static ErrorOr<void> decode_png_bitmap(PNGLoadingContext& context)
     if (context.color_type == PNG::ColorType::IndexedColor && context.palette_data.is_empty())
         return Error::from_string_literal("PNGImageDecoderPlugin: Didn't see a PLTE chunk for a palletized image, or it was empty.");
 
-    auto result = Compress::ZlibDecompressor::decompress_all(context.compressed_data.span());
-    if (!result.has_value()) {
+    if (context.interlace_method != PngInterlaceMethod::Null && context.interlace_method != PngInterlaceMethod::Adam7) {
         context.state = PNGLoadingContext::State::Error;
-        return Error::from_string_literal("PNGImageDecoderPlugin: Decompression failed");
+        return Error::from_string_literal("PNGImageDecoderPlugin: Invalid interlace method");
     }
-    context.decompression_buffer = &result.value();
-    context.compressed_data.clear();
 
-    context.scanlines.ensure_capacity(context.height);
-    switch (context.interlace_method) {
-    case PngInterlaceMethod::Null:
-        TRY(decode_png_bitmap_simple(context));
-        break;
-    case PngInterlaceMethod::Adam7:
-        TRY(decode_png_adam7(context));
-        break;
-    default:
+    auto zlib = Compress::ZlibDecompressor::try_create(context.compressed_data.span());
+    if (!zlib.has_value()) {
         context.state = PNGLoadingContext::State::Error;
-        return Error::from_string_literal("PNGImageDecoderPlugin: Invalid interlace method");
+        return Error::from_string_literal("PNGImageDecoderPlugin: Decompression failed");
     }
+    ImageDataStream image_data { zlib->compressed_data(), context.compressed_data_is_incomplete };
+    TRY(image_data.initialize());
+
+    context.bitmap = TRY(Bitmap::create(context.has_alpha() ? BitmapFormat::BGRA8888 : BitmapFormat::BGRx8888, { context.width, context.height }));
+    auto palette = TRY(make_palette(context));
 
-    context.decompression_buffer = nullptr;
+    if (context.interlace_method == PngInterlaceMethod::Adam7)
+        TRY(decode_png_adam7(context, image_data, palette));
+    else
+        TRY(decode_png_bitmap_simple(context, image_data, palette));
 
+    context.compressed_data.clear();
     context.state = PNGLoadingContext::State::BitmapDecoded;
     return {};
 }
@@ -962,6 +1008,12 @@ static bool process_chunk(Streamer& streamer, PNGLoadingContext& context)
     }
     ReadonlyBytes chunk_data;
     if (!streamer.wrap_bytes(chunk_data, chunk_size)) {
+        // An image that hasn't been downloaded completely may end in the middle of its image data. Whatever is there
+        // can still be decoded partially.
+        if (!strcmp((char const*)chunk_type, "IDAT") && streamer.wrap_bytes(chunk_data, streamer.remaining())) {
+            process_IDAT(chunk_data, context);
+            context.compressed_data_is_incomplete = true;
+        }
         dbgln_if(PNG_DEBUG, "Bail at chunk_data");
         return false;
     }
@@ -1079,6 +1131,20 @@ ErrorOr<ImageFrameDescriptor> PNGImageDecoderPlugin::frame(size_t index)
     return ImageFrameDescriptor { m_context->bitmap, 0 };
 }
 
+ErrorOr<PartialImageFrameDescriptor> PNGImageDecoderPlugin::partial_frame()
+{
+    if (m_context->state != PNGLoadingContext::State::Error && m_context->state < PNGLoadingContext::State::BitmapDecoded) {
+        // Rows that were decoded before running out of data are still worth showing.
+        auto result = decode_png_bitmap(*m_context);
+        if (result.is_error() && !m_context->bitmap)
+            return result.release_error();
+    }
+
+    if (!m_context->bitmap)
+        return Error::from_string_literal("PNGImageDecoderPlugin: Decoding failed");
+    return PartialImageFrameDescriptor { m_context->bitmap, m_context->decoded_height };
+}
+
 ErrorOr<Optional<ReadonlyBytes>> PNGImageDecoderPlugin::icc_data()
 {
     if (!decode_png_chunks(*m_context))
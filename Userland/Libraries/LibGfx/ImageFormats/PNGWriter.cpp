@@ -6,14 +6,17 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
-#include <AK/Concepts.h>
-#include <AK/FixedArray.h>
-#include <AK/SIMDExtras.h>
+#include <AK/MemoryStream.h>
+#include <AK/SIMD.h>
 #include <AK/String.h>
+#include <LibCompress/Deflate.h>
 #include <LibCompress/Zlib.h>
+#include <LibCrypto/Checksum/Adler32.h>
 #include <LibCrypto/Checksum/CRC32.h>
 #include <LibGfx/Bitmap.h>
+#include <LibGfx/HelperThreads.h>
 #include <LibGfx/ImageFormats/PNGWriter.h>
+#include <LibGfx/PixelKernels.h>
 
 #pragma GCC diagnostic ignored "-Wpsabi"
 
@@ -149,122 +152,245 @@ ErrorOr<void> PNGWriter::add_IEND_chunk()
     return {};
 }
 
-union [[gnu::packed]] Pixel {
-    ARGB32 rgba { 0 };
-    struct {
-        u8 red;
-        u8 green;
-        u8 blue;
-        u8 alpha;
-    };
-    AK::SIMD::u8x4 simd;
+using AK::SIMD::i16x16;
+using AK::SIMD::i8x16;
+using AK::SIMD::u16x8;
+using AK::SIMD::u8x16;
 
-    ALWAYS_INLINE static AK::SIMD::u8x4 gfx_to_png(Pixel pixel)
-    {
-        swap(pixel.red, pixel.blue);
-        return pixel.simd;
-    }
-};
-static_assert(AssertSize<Pixel, 4>());
+template<typename VectorType>
+ALWAYS_INLINE static VectorType load(u8 const* data)
+{
+    VectorType vector;
+    __builtin_memcpy(&vector, data, sizeof(vector));
+    return vector;
+}
 
-ErrorOr<void> PNGWriter::add_IDAT_chunk(Gfx::Bitmap const& bitmap)
+template<typename VectorType>
+ALWAYS_INLINE static void store(u8* data, VectorType vector)
 {
-    PNGChunk png_chunk { "IDAT"_short_string };
-    TRY(png_chunk.reserve(bitmap.size_in_bytes()));
+    __builtin_memcpy(data, &vector, sizeof(vector));
+}
 
-    ByteBuffer uncompressed_block_data;
-    TRY(uncompressed_block_data.try_ensure_capacity(bitmap.size_in_bytes() + bitmap.height()));
+template<typename VectorType>
+ALWAYS_INLINE static VectorType absolute_value(VectorType vector)
+{
+    return vector < 0 ? -vector : vector;
+}
 
-    auto dummy_scanline = TRY(FixedArray<Pixel>::create(bitmap.width()));
-    auto const* scanline_minus_1 = dummy_scanline.data();
+// Adds up the bytes of vectors in 16-bit lanes, which are emptied before they could overflow.
+class ByteSum {
+public:
+    ALWAYS_INLINE void add(u8x16 bytes)
+    {
+        auto pairs = bit_cast<u16x8>(bytes);
+        m_lanes += (pairs & 0xff) + (pairs >> 8);
+        if (++m_pending_additions == maximum_pending_additions)
+            empty_lanes();
+    }
+
+    u32 total()
+    {
+        empty_lanes();
+        return m_total;
+    }
 
-    for (int y = 0; y < bitmap.height(); ++y) {
-        auto* scanline = reinterpret_cast<Pixel const*>(bitmap.scanline(y));
+private:
+    // Each addition adds at most 2 * 255 to a lane.
+    static constexpr u32 maximum_pending_additions = NumericLimits<u16>::max() / (2 * 255);
 
-        struct Filter {
-            PNG::FilterType type;
-            ByteBuffer buffer {};
-            int sum = 0;
+    void empty_lanes()
+    {
+        for (size_t i = 0; i < 8; ++i)
+            m_total += m_lanes[i];
+        m_lanes = u16x8 {};
+        m_pending_additions = 0;
+    }
 
-            ErrorOr<void> append(u8 byte)
-            {
-                TRY(buffer.try_append(byte));
-                sum += static_cast<i8>(byte);
-                return {};
-            }
+    u16x8 m_lanes {};
+    u32 m_pending_additions { 0 };
+    u32 m_total { 0 };
+};
 
-            ErrorOr<void> append(AK::SIMD::u8x4 simd)
-            {
-                TRY(append(simd[0]));
-                TRY(append(simd[1]));
-                TRY(append(simd[2]));
-                TRY(append(simd[3]));
-                return {};
-            }
-        };
+// Rows are filtered from copies of them in PNG's byte order. The copies have a zero pixel in front of them and are
+// zero-padded to a whole number of vectors, so that the filters can work on all pixels the same way.
+class FilterRows {
+public:
+    static constexpr size_t padding = sizeof(u8x16);
+    static constexpr size_t filter_count = 5;
 
-        Filter none_filter { .type = PNG::FilterType::None };
-        TRY(none_filter.buffer.try_ensure_capacity(sizeof(Pixel) * bitmap.height()));
+    static ErrorOr<FilterRows> create(size_t row_size)
+    {
+        auto padded_row_size = align_up_to(row_size, sizeof(u8x16));
+        FilterRows rows { row_size };
+        rows.m_current = TRY(ByteBuffer::create_zeroed(padding + padded_row_size));
+        rows.m_previous = TRY(ByteBuffer::create_zeroed(padding + padded_row_size));
+        for (auto& output : rows.m_outputs)
+            output = TRY(ByteBuffer::create_uninitialized(padded_row_size));
+        return rows;
+    }
 
-        Filter sub_filter { .type = PNG::FilterType::Sub };
-        TRY(sub_filter.buffer.try_ensure_capacity(sizeof(Pixel) * bitmap.height()));
+    Bytes current() { return m_current.bytes().slice(padding, m_row_size); }
+    void advance() { swap(m_current, m_previous); }
 
-        Filter up_filter { .type = PNG::FilterType::Up };
-        TRY(up_filter.buffer.try_ensure_capacity(sizeof(Pixel) * bitmap.height()));
+    // Writes the filter type and the filtered bytes of the current row to `output`, which has to hold one more byte
+    // than the row.
+    void filter(PNGWriterOptions::FilterSelection, Bytes output);
 
-        Filter average_filter { .type = PNG::FilterType::Average };
-        TRY(average_filter.buffer.try_ensure_capacity(sizeof(ARGB32) * bitmap.height()));
+private:
+    explicit FilterRows(size_t row_size)
+        : m_row_size(row_size)
+    {
+    }
 
-        Filter paeth_filter { .type = PNG::FilterType::Paeth };
-        TRY(paeth_filter.buffer.try_ensure_capacity(sizeof(ARGB32) * bitmap.height()));
+    template<PNG::FilterType>
+    u32 filter_with(u8* output) const;
 
-        auto pixel_x_minus_1 = Pixel::gfx_to_png(dummy_scanline[0]);
-        auto pixel_xy_minus_1 = Pixel::gfx_to_png(dummy_scanline[0]);
+    size_t m_row_size { 0 };
+    ByteBuffer m_current;
+    ByteBuffer m_previous;
+    Array<ByteBuffer, filter_count> m_outputs;
+};
 
-        for (int x = 0; x < bitmap.width(); ++x) {
-            auto pixel = Pixel::gfx_to_png(scanline[x]);
-            auto pixel_y_minus_1 = Pixel::gfx_to_png(scanline_minus_1[x]);
+// Returns the sum of the absolute values of the filtered bytes, taken as signed differences, which is how well the
+// filter is expected to compress.
+template<PNG::FilterType filter>
+u32 FilterRows::filter_with(u8* output) const
+{
+    constexpr u8x16 byte_indices { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15 };
+    constexpr size_t bytes_per_pixel = sizeof(ARGB32);
+
+    u8 const* row = m_current.data() + padding;
+    u8 const* previous_row = m_previous.data() + padding;
+
+    ByteSum sum;
+    for (size_t i = 0; i < m_row_size; i += sizeof(u8x16)) {
+        auto x = load<u8x16>(row + i);
+        auto a = load<u8x16>(row + i - bytes_per_pixel);
+        auto b = load<u8x16>(previous_row + i);
+        auto c = load<u8x16>(previous_row + i - bytes_per_pixel);
+
+        u8x16 filtered;
+        if constexpr (filter == PNG::FilterType::None) {
+            filtered = x;
+        } else if constexpr (filter == PNG::FilterType::Sub) {
+            filtered = x - a;
+        } else if constexpr (filter == PNG::FilterType::Up) {
+            filtered = x - b;
+        } else if constexpr (filter == PNG::FilterType::Average) {
+            // This is floor((a + b) / 2) without overflowing the bytes.
+            filtered = x - ((a & b) + ((a ^ b) >> 1));
+        } else if constexpr (filter == PNG::FilterType::Paeth) {
+            auto wide_a = __builtin_convertvector(a, i16x16);
+            auto wide_b = __builtin_convertvector(b, i16x16);
+            auto wide_c = __builtin_convertvector(c, i16x16);
+            // These are the distances of the predictor a + b - c to a, b and c.
+            auto predictor_left = absolute_value(wide_b - wide_c);
+            auto predictor_above = absolute_value(wide_a - wide_c);
+            auto predictor_upper_left = absolute_value(wide_a + wide_b - wide_c - wide_c);
+            auto nearest = (predictor_left <= predictor_above) & (predictor_left <= predictor_upper_left)
+                ? wide_a
+                : (predictor_above <= predictor_upper_left ? wide_b : wide_c);
+            filtered = x - __builtin_convertvector(nearest, u8x16);
+        }
+        store(output + i, filtered);
 
-            TRY(none_filter.append(pixel));
+        auto magnitudes = bit_cast<u8x16>(absolute_value(bit_cast<i8x16>(filtered)));
+        if (i + sizeof(u8x16) > m_row_size)
+            magnitudes &= bit_cast<u8x16>(byte_indices < static_cast<u8>(m_row_size - i));
+        sum.add(magnitudes);
+    }
+    return sum.total();
+}
 
-            TRY(sub_filter.append(pixel - pixel_x_minus_1));
+void FilterRows::filter(PNGWriterOptions::FilterSelection filter_selection, Bytes output)
+{
+    Array<u32, filter_count> sums;
+    sums.fill(NumericLimits<u32>::max());
+
+    // 12.8 Filter selection: https://www.w3.org/TR/PNG/#12Filter-selection
+    // For best compression of truecolour and greyscale images, the recommended approach
+    // is adaptive filtering in which a filter is chosen for each scanline.
+    // The following simple heuristic has performed well in early tests:
+    // compute the output scanline using all five filters, and select the filter that gives the smallest sum of absolute values of outputs.
+    // (Consider the output bytes as signed differences for this test.)
+    sums[to_underlying(PNG::FilterType::Sub)] = filter_with<PNG::FilterType::Sub>(m_outputs[to_underlying(PNG::FilterType::Sub)].data());
+    sums[to_underlying(PNG::FilterType::Up)] = filter_with<PNG::FilterType::Up>(m_outputs[to_underlying(PNG::FilterType::Up)].data());
+    if (filter_selection == PNGWriterOptions::FilterSelection::Adaptive) {
+        sums[to_underlying(PNG::FilterType::None)] = filter_with<PNG::FilterType::None>(m_outputs[to_underlying(PNG::FilterType::None)].data());
+        sums[to_underlying(PNG::FilterType::Average)] = filter_with<PNG::FilterType::Average>(m_outputs[to_underlying(PNG::FilterType::Average)].data());
+        sums[to_underlying(PNG::FilterType::Paeth)] = filter_with<PNG::FilterType::Paeth>(m_outputs[to_underlying(PNG::FilterType::Paeth)].data());
+    }
 
-            TRY(up_filter.append(pixel - pixel_y_minus_1));
+    size_t best_filter = 0;
+    for (size_t filter = 1; filter < filter_count; ++filter) {
+        if (sums[filter] < sums[best_filter])
+            best_filter = filter;
+    }
 
-            // The sum Orig(a) + Orig(b) shall be performed without overflow (using at least nine-bit arithmetic).
-            auto sum = AK::SIMD::to_u16x4(pixel_x_minus_1) + AK::SIMD::to_u16x4(pixel_y_minus_1);
-            auto average = AK::SIMD::to_u8x4(sum / 2);
-            TRY(average_filter.append(pixel - average));
+    output[0] = best_filter;
+    m_outputs[best_filter].bytes().trim(m_row_size).copy_to(output.slice(1));
+}
 
-            TRY(paeth_filter.append(pixel - PNG::paeth_predictor(pixel_x_minus_1, pixel_y_minus_1, pixel_xy_minus_1)));
+ErrorOr<void> PNGWriter::add_IDAT_chunk(Gfx::Bitmap const& bitmap, Options const& options)
+{
+    PNGChunk png_chunk { "IDAT"_short_string };
 
-            pixel_x_minus_1 = pixel;
-            pixel_xy_minus_1 = pixel_y_minus_1;
+    size_t const row_size = bitmap.width() * sizeof(ARGB32);
+    size_t const filtered_row_size = row_size + 1;
+    auto uncompressed_block_data = TRY(ByteBuffer::create_uninitialized(filtered_row_size * bitmap.height()));
+
+    // Each part of the image is filtered and compressed on its own, and the parts are put together into one zlib stream.
+    auto const compression_level = static_cast<Compress::DeflateCompressor::CompressionLevel>(options.compression_level);
+    auto filter_and_compress = [&](int first_row, int end_row) -> ErrorOr<ByteBuffer> {
+        auto rows = TRY(FilterRows::create(row_size));
+        if (first_row > 0)
+            PixelKernels::swap_red_and_blue(reinterpret_cast<u32*>(rows.current().data()), bitmap.scanline(first_row - 1), bitmap.width());
+
+        for (int y = first_row; y < end_row; ++y) {
+            rows.advance();
+            PixelKernels::swap_red_and_blue(reinterpret_cast<u32*>(rows.current().data()), bitmap.scanline(y), bitmap.width());
+            rows.filter(options.filter_selection, uncompressed_block_data.bytes().slice(y * filtered_row_size, filtered_row_size));
         }
 
-        scanline_minus_1 = scanline;
-
-        // 12.8 Filter selection: https://www.w3.org/TR/PNG/#12Filter-selection
-        // For best compression of truecolour and greyscale images, the recommended approach
-        // is adaptive filtering in which a filter is chosen for each scanline.
-        // The following simple heuristic has performed well in early tests:
-        // compute the output scanline using all five filters, and select the filter that gives the smallest sum of absolute values of outputs.
-        // (Consider the output bytes as signed differences for this test.)
-        Filter& best_filter = none_filter;
-        if (abs(best_filter.sum) > abs(sub_filter.sum))
-            best_filter = sub_filter;
-        if (abs(best_filter.sum) > abs(up_filter.sum))
-            best_filter = up_filter;
-        if (abs(best_filter.sum) > abs(average_filter.sum))
-            best_filter = average_filter;
-        if (abs(best_filter.sum) > abs(paeth_filter.sum))
-            best_filter = paeth_filter;
-
-        TRY(uncompressed_block_data.try_append(to_underlying(best_filter.type)));
-        TRY(uncompressed_block_data.try_append(best_filter.buffer));
+        auto part = uncompressed_block_data.bytes().slice(first_row * filtered_row_size, (end_row - first_row) * filtered_row_size);
+        AllocatingMemoryStream output_stream;
+        auto deflate_stream = TRY(Compress::DeflateCompressor::construct(MaybeOwned<Stream>(output_stream), compression_level));
+        TRY(deflate_stream->write_until_depleted(part));
+        if (end_row == bitmap.height())
+            TRY(deflate_stream->final_flush());
+        else
+            TRY(deflate_stream->final_sync_flush());
+
+        auto compressed_part = TRY(ByteBuffer::create_uninitialized(output_stream.used_buffer_size()));
+        TRY(output_stream.read_until_filled(compressed_part));
+        return compressed_part;
+    };
+
+    // A few parts per thread even out how long each of them takes, but each part should fill a few deflate blocks.
+    int rows_per_part = max(bitmap.height(), 1);
+    if (options.use_helper_threads) {
+        int const minimum_rows_per_part = ceil_div(4 * Compress::DeflateCompressor::block_size, filtered_row_size);
+        rows_per_part = lines_per_band(bitmap.height(), static_cast<size_t>(bitmap.width()) * bitmap.height(), minimum_rows_per_part);
     }
 
-    TRY(png_chunk.compress_and_add(uncompressed_block_data));
+    Vector<ByteBuffer> compressed_parts;
+    TRY(compressed_parts.try_resize(ceil_div(bitmap.height(), rows_per_part)));
+    TRY(try_for_each_band_of_lines(bitmap.height(), rows_per_part, [&](int first_row, int end_row) -> ErrorOr<void> {
+        compressed_parts[first_row / rows_per_part] = TRY(filter_and_compress(first_row, end_row));
+        return {};
+    }));
+
+    size_t compressed_size = 0;
+    for (auto const& part : compressed_parts)
+        compressed_size += part.size();
+    TRY(png_chunk.reserve(png_chunk.data().size() + sizeof(Compress::ZlibHeader) + compressed_size + sizeof(u32)));
+
+    auto header = Compress::ZlibCompressor::header_for(Compress::ZlibCompressionMethod::Deflate, options.compression_level);
+    TRY(png_chunk.add_as_big_endian<u16>(header.as_u16));
+    for (auto const& part : compressed_parts)
+        TRY(png_chunk.add(part));
+    TRY(png_chunk.add_as_big_endian<u32>(Crypto::Checksum::Adler32(uncompressed_block_data).digest()));
+
     TRY(add_chunk(png_chunk));
     return {};
 }
@@ -276,7 +402,7 @@ ErrorOr<ByteBuffer> PNGWriter::encode(Gfx::Bitmap const& bitmap, Options options
     TRY(writer.add_IHDR_chunk(bitmap.width(), bitmap.height(), 8, PNG::ColorType::TruecolorWithAlpha, 0, 0, 0));
     if (options.icc_data.has_value())
         TRY(writer.add_iCCP_chunk(options.icc_data.value()));
-    TRY(writer.add_IDAT_chunk(bitmap));
+    TRY(writer.add_IDAT_chunk(bitmap, options));
     TRY(writer.add_IEND_chunk());
     return ByteBuffer::copy(writer.m_data);
 }
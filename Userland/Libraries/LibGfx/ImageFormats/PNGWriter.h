@@ -9,6 +9,7 @@
 
 #include <AK/Optional.h>
 #include <AK/Vector.h>
+#include <LibCompress/Zlib.h>
 #include <LibGfx/Forward.h>
 #include <LibGfx/ImageFormats/PNGShared.h>
 
@@ -20,7 +21,32 @@ class PNGChunk;
 struct PNGWriterOptions {
     // Data for the iCCP chunk.
     // FIXME: Allow writing cICP, sRGB, or gAMA instead too.
-    Optional<ReadonlyBytes> icc_data;
+    Optional<ReadonlyBytes> icc_data {};
+
+    enum class FilterSelection {
+        // Tries all five filters on each row, and keeps the one that's likely to compress best.
+        Adaptive,
+        // Only tries the Sub and Up filters, which are much cheaper and almost as good for screen contents.
+        Fast,
+    };
+    FilterSelection filter_selection { FilterSelection::Adaptive };
+
+    Compress::ZlibCompressionLevel compression_level { Compress::ZlibCompressionLevel::Best };
+
+    // Big images are compressed in parts by the LibGfx helper threads besides the calling one, which makes them a little
+    // bigger.
+    bool use_helper_threads { false };
+
+    // For images that are written often, or on behalf of someone who's waiting for them, like screenshots and clipboard
+    // contents. They come out bigger, but are encoded many times faster.
+    static PNGWriterOptions fast(bool use_helper_threads = false)
+    {
+        return {
+            .filter_selection = FilterSelection::Fast,
+            .compression_level = Compress::ZlibCompressionLevel::Fast,
+            .use_helper_threads = use_helper_threads,
+        };
+    }
 };
 
 class PNGWriter {
@@ -37,7 +63,7 @@ private:
     ErrorOr<void> add_png_header();
     ErrorOr<void> add_IHDR_chunk(u32 width, u32 height, u8 bit_depth, PNG::ColorType color_type, u8 compression_method, u8 filter_method, u8 interlace_method);
     ErrorOr<void> add_iCCP_chunk(ReadonlyBytes icc_data);
-    ErrorOr<void> add_IDAT_chunk(Gfx::Bitmap const&);
+    ErrorOr<void> add_IDAT_chunk(Gfx::Bitmap const&, Options const&);
     ErrorOr<void> add_IEND_chunk();
 };
 
@@ -6,6 +6,7 @@
 
 #include "QOIWriter.h"
 #include <AK/Endian.h>
+#include <AK/MemoryStream.h>
 
 namespace Gfx {
 
@@ -24,7 +25,17 @@ enum class Channels {
 
 ErrorOr<ByteBuffer> QOIWriter::encode(Bitmap const& bitmap)
 {
-    QOIWriter writer;
+    AllocatingMemoryStream stream;
+    TRY(encode(stream, bitmap));
+
+    auto buffer = TRY(ByteBuffer::create_uninitialized(stream.used_buffer_size()));
+    TRY(stream.read_until_filled(buffer));
+    return buffer;
+}
+
+ErrorOr<void> QOIWriter::encode(Stream& stream, Bitmap const& bitmap)
+{
+    QOIWriter writer { stream };
     TRY(writer.add_header(bitmap.width(), bitmap.height(), Channels::RGBA, Colorspace::sRGB));
 
     Color previous_pixel = { 0, 0, 0, 255 };
@@ -32,9 +43,11 @@ ErrorOr<ByteBuffer> QOIWriter::encode(Bitmap const& bitmap)
     bool creating_run = false;
     int run_length = 0;
 
+    bool const has_alpha_channel = bitmap.has_alpha_channel();
     for (auto y = 0; y < bitmap.height(); y++) {
+        auto const* scanline = bitmap.scanline(y);
         for (auto x = 0; x < bitmap.width(); x++) {
-            auto pixel = bitmap.get_pixel(x, y);
+            auto pixel = has_alpha_channel ? Color::from_argb(scanline[x]) : Color::from_rgb(scanline[x]);
 
             // Check for at most 62 consecutive identical pixels.
             if (pixel == previous_pixel) {
@@ -108,8 +121,24 @@ ErrorOr<ByteBuffer> QOIWriter::encode(Bitmap const& bitmap)
     }
 
     TRY(writer.add_end_marker());
+    TRY(writer.flush());
+    return {};
+}
 
-    return ByteBuffer::copy(writer.m_data);
+ErrorOr<void> QOIWriter::add(ReadonlyBytes bytes)
+{
+    if (m_buffered_size + bytes.size() > m_buffer.size())
+        TRY(flush());
+    bytes.copy_to(m_buffer.span().slice(m_buffered_size));
+    m_buffered_size += bytes.size();
+    return {};
+}
+
+ErrorOr<void> QOIWriter::flush()
+{
+    TRY(m_stream.write_until_depleted(m_buffer.span().trim(m_buffered_size)));
+    m_buffered_size = 0;
+    return {};
 }
 
 ErrorOr<void> QOIWriter::add_header(u32 width, u32 height, Channels channels = Channels::RGBA, Colorspace color_space = Colorspace::sRGB)
@@ -118,19 +147,18 @@ ErrorOr<void> QOIWriter::add_header(u32 width, u32 height, Channels channels = C
     if (channels == Channels::RGB || color_space == Colorspace::Linear)
         TODO();
 
-    TRY(m_data.try_append(qoi_magic_bytes.data(), sizeof(qoi_magic_bytes)));
+    TRY(add(qoi_magic_bytes));
 
     auto big_endian_width = AK::convert_between_host_and_big_endian(width);
-    TRY(m_data.try_append(bit_cast<u8*>(&big_endian_width), sizeof(width)));
+    TRY(add({ &big_endian_width, sizeof(width) }));
 
     auto big_endian_height = AK::convert_between_host_and_big_endian(height);
-    TRY(m_data.try_append(bit_cast<u8*>(&big_endian_height), sizeof(height)));
+    TRY(add({ &big_endian_height, sizeof(height) }));
 
     // Number of channels: 3 = RGB, 4 = RGBA.
-    TRY(m_data.try_append(4));
-
     // Colorspace: 0 = sRGB, 1 = all linear channels.
-    TRY(m_data.try_append(color_space == Colorspace::sRGB ? 0 : 1));
+    u8 const channels_and_color_space[] = { 4, static_cast<u8>(color_space == Colorspace::sRGB ? 0 : 1) };
+    TRY(add({ channels_and_color_space, sizeof(channels_and_color_space) }));
 
     return {};
 }
@@ -139,10 +167,8 @@ ErrorOr<void> QOIWriter::add_rgb_chunk(u8 r, u8 g, u8 b)
 {
     constexpr static u8 rgb_tag = 0b1111'1110;
 
-    TRY(m_data.try_append(rgb_tag));
-    TRY(m_data.try_append(r));
-    TRY(m_data.try_append(g));
-    TRY(m_data.try_append(b));
+    u8 const chunk[] = { rgb_tag, r, g, b };
+    TRY(add({ chunk, sizeof(chunk) }));
     return {};
 }
 
@@ -150,11 +176,8 @@ ErrorOr<void> QOIWriter::add_rgba_chunk(u8 r, u8 g, u8 b, u8 a)
 {
     constexpr static u8 rgba_tag = 0b1111'1111;
 
-    TRY(m_data.try_append(rgba_tag));
-    TRY(m_data.try_append(r));
-    TRY(m_data.try_append(g));
-    TRY(m_data.try_append(b));
-    TRY(m_data.try_append(a));
+    u8 const chunk[] = { rgba_tag, r, g, b, a };
+    TRY(add({ chunk, sizeof(chunk) }));
     return {};
 }
 
@@ -163,7 +186,7 @@ ErrorOr<void> QOIWriter::add_index_chunk(unsigned int index)
     constexpr static u8 index_tag = 0b0000'0000;
 
     u8 chunk = index_tag | index;
-    TRY(m_data.try_append(chunk));
+    TRY(add({ &chunk, sizeof(chunk) }));
     return {};
 }
 
@@ -177,7 +200,7 @@ ErrorOr<void> QOIWriter::add_diff_chunk(i8 red_difference, i8 green_difference,
     u8 blue = blue_difference + bias;
 
     u8 chunk = diff_tag | (red << 4) | (green << 2) | blue;
-    TRY(m_data.try_append(chunk));
+    TRY(add({ &chunk, sizeof(chunk) }));
     return {};
 }
 
@@ -189,8 +212,8 @@ ErrorOr<void> QOIWriter::add_luma_chunk(i8 relative_red_difference, i8 green_dif
 
     u8 chunk1 = luma_tag | (green_difference + green_bias);
     u8 chunk2 = ((relative_red_difference + red_blue_bias) << 4) | (relative_blue_difference + red_blue_bias);
-    TRY(m_data.try_append(chunk1));
-    TRY(m_data.try_append(chunk2));
+    u8 const chunk[] = { chunk1, chunk2 };
+    TRY(add({ chunk, sizeof(chunk) }));
     return {};
 }
 
@@ -200,13 +223,13 @@ ErrorOr<void> QOIWriter::add_run_chunk(unsigned run_length)
     int bias = -1;
 
     u8 chunk = run_tag | (run_length + bias);
-    TRY(m_data.try_append(chunk));
+    TRY(add({ &chunk, sizeof(chunk) }));
     return {};
 }
 
 ErrorOr<void> QOIWriter::add_end_marker()
 {
-    TRY(m_data.try_append(qoi_end_marker.data(), sizeof(qoi_end_marker)));
+    TRY(add(qoi_end_marker));
     return {};
 }
 
@@ -7,7 +7,7 @@
 #pragma once
 
 #include <AK/Error.h>
-#include <AK/Vector.h>
+#include <AK/Stream.h>
 #include <LibGfx/Bitmap.h>
 
 namespace Gfx {
@@ -19,10 +19,21 @@ class QOIWriter {
 public:
     static ErrorOr<ByteBuffer> encode(Gfx::Bitmap const&);
 
+    // Writes the image to the stream while encoding it, a few kilobytes at a time.
+    static ErrorOr<void> encode(Stream&, Gfx::Bitmap const&);
+
 private:
-    QOIWriter() = default;
+    explicit QOIWriter(Stream& stream)
+        : m_stream(stream)
+    {
+    }
+
+    Stream& m_stream;
+    Array<u8, 16 * KiB> m_buffer;
+    size_t m_buffered_size { 0 };
+    ErrorOr<void> add(ReadonlyBytes);
+    ErrorOr<void> flush();
 
-    Vector<u8> m_data;
     ErrorOr<void> add_header(u32 width, u32 height, Channels, Colorspace);
     ErrorOr<void> add_rgb_chunk(u8, u8, u8);
     ErrorOr<void> add_rgba_chunk(u8, u8, u8, u8);
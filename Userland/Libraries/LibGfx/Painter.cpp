@@ -15,12 +15,12 @@
 #include "Font/Emoji.h"
 #include "Font/Font.h"
 #include "Gamma.h"
+#include <AK/Array.h>
 #include <AK/Assertions.h>
 #include <AK/Debug.h>
 #include <AK/Function.h>
 #include <AK/Math.h>
 #include <AK/Memory.h>
-#include <AK/Queue.h>
 #include <AK/QuickSort.h>
 #include <AK/StdLibExtras.h>
 #include <AK/StringBuilder.h>
@@ -28,8 +28,10 @@
 #include <AK/Utf8View.h>
 #include <LibGfx/CharacterBitmap.h>
 #include <LibGfx/Palette.h>
+#include <LibGfx/PixelKernels.h>
 #include <LibGfx/Path.h>
 #include <LibGfx/Quad.h>
+#include <LibGfx/Resampler.h>
 #include <LibGfx/TextDirection.h>
 #include <LibGfx/TextLayout.h>
 #include <LibUnicode/CharacterTypes.h>
@@ -47,6 +49,12 @@ static bool should_paint_as_space(u32 code_point)
     return is_ascii_space(code_point) || code_point == 0xa0;
 }
 
+static bool is_variation_selector(u32 code_point)
+{
+    static auto const variation_selector = Unicode::property_from_string("Variation_Selector"sv);
+    return variation_selector.has_value() && Unicode::code_point_has_property(code_point, *variation_selector);
+}
+
 template<BitmapFormat format = BitmapFormat::Invalid>
 ALWAYS_INLINE Color get_pixel(Gfx::Bitmap const& bitmap, int x, int y)
 {
@@ -122,8 +130,7 @@ void Painter::fill_physical_rect(IntRect const& physical_rect, Color color)
     size_t const dst_skip = m_target->pitch() / sizeof(ARGB32);
 
     for (int i = physical_rect.height() - 1; i >= 0; --i) {
-        for (int j = 0; j < physical_rect.width(); ++j)
-            dst[j] = Color::from_argb(dst[j]).blend(color).value();
+        PixelKernels::blend(dst, color, physical_rect.width());
         dst += dst_skip;
     }
 }
@@ -817,13 +824,6 @@ void Painter::draw_triangle(IntPoint a, IntPoint b, IntPoint c, Color color)
 }
 
 struct BlitState {
-    enum AlphaState {
-        NoAlpha = 0,
-        SrcAlpha = 1,
-        DstAlpha = 2,
-        BothAlpha = SrcAlpha | DstAlpha
-    };
-
     ARGB32 const* src;
     ARGB32* dst;
     size_t src_pitch;
@@ -834,38 +834,33 @@ struct BlitState {
     BitmapFormat src_format;
 };
 
-// FIXME: This is a hack to support blit_with_opacity() with RGBA8888 source.
-//        Ideally we'd have a more generic solution that allows any source format.
-static void swap_red_and_blue_channels(Color& color)
+static void do_blit_with_opacity(BlitState& state, bool apply_source_alpha, PixelKernels::Destination destination)
 {
-    u32 rgba = color.value();
-    u32 bgra = (rgba & 0xff00ff00)
-        | ((rgba & 0x000000ff) << 16)
-        | ((rgba & 0x00ff0000) >> 16);
-    color = Color::from_argb(bgra);
-}
+    // The source alpha only takes 256 different values, so scale them all by the opacity up front.
+    Array<u8, 256> alpha_table;
+    for (size_t alpha = 0; alpha < alpha_table.size(); ++alpha) {
+        if (apply_source_alpha) {
+            float pixel_opacity = alpha / 255.0;
+            alpha_table[alpha] = static_cast<u8>(255 * (state.opacity * pixel_opacity));
+        } else {
+            alpha_table[alpha] = static_cast<u8>(state.opacity * 255);
+        }
+    }
 
-// FIXME: This function is very unoptimized.
-template<BlitState::AlphaState has_alpha>
-static void do_blit_with_opacity(BlitState& state)
-{
+    // Rows are blended in chunks, so that the source pixels with their new alpha fit on the stack.
+    constexpr int chunk_size = 256;
+    ARGB32 chunk[chunk_size];
     for (int row = 0; row < state.row_count; ++row) {
-        for (int x = 0; x < state.column_count; ++x) {
-            Color dest_color = (has_alpha & BlitState::DstAlpha) ? Color::from_argb(state.dst[x]) : Color::from_rgb(state.dst[x]);
-            if constexpr (has_alpha & BlitState::SrcAlpha) {
-                Color src_color_with_alpha = Color::from_argb(state.src[x]);
-                if (state.src_format == BitmapFormat::RGBA8888)
-                    swap_red_and_blue_channels(src_color_with_alpha);
-                float pixel_opacity = src_color_with_alpha.alpha() / 255.0;
-                src_color_with_alpha.set_alpha(255 * (state.opacity * pixel_opacity));
-                state.dst[x] = dest_color.blend(src_color_with_alpha).value();
-            } else {
-                Color src_color_with_alpha = Color::from_rgb(state.src[x]);
-                if (state.src_format == BitmapFormat::RGBA8888)
-                    swap_red_and_blue_channels(src_color_with_alpha);
-                src_color_with_alpha.set_alpha(state.opacity * 255);
-                state.dst[x] = dest_color.blend(src_color_with_alpha).value();
+        for (int x = 0; x < state.column_count; x += chunk_size) {
+            int length = min(chunk_size, state.column_count - x);
+            ARGB32 const* src = state.src + x;
+            if (state.src_format == BitmapFormat::RGBA8888) {
+                PixelKernels::swap_red_and_blue(chunk, src, length);
+                src = chunk;
             }
+            for (int i = 0; i < length; ++i)
+                chunk[i] = (src[i] & 0x00ffffff) | (alpha_table[src[i] >> 24] << 24);
+            PixelKernels::blend(state.dst + x, chunk, length, destination);
         }
         state.dst += state.dst_pitch;
         state.src += state.src_pitch;
@@ -909,17 +904,8 @@ void Painter::blit_with_opacity(IntPoint position, Gfx::Bitmap const& source, In
         .src_format = source.format(),
     };
 
-    if (source.has_alpha_channel() && apply_alpha) {
-        if (m_target->has_alpha_channel())
-            do_blit_with_opacity<BlitState::BothAlpha>(blit_state);
-        else
-            do_blit_with_opacity<BlitState::SrcAlpha>(blit_state);
-    } else {
-        if (m_target->has_alpha_channel())
-            do_blit_with_opacity<BlitState::DstAlpha>(blit_state);
-        else
-            do_blit_with_opacity<BlitState::NoAlpha>(blit_state);
-    }
+    auto destination = m_target->has_alpha_channel() ? PixelKernels::Destination::HasAlpha : PixelKernels::Destination::Opaque;
+    do_blit_with_opacity(blit_state, source.has_alpha_channel() && apply_alpha, destination);
 }
 
 void Painter::blit_filtered(IntPoint position, Gfx::Bitmap const& source, IntRect const& src_rect, Function<Color(Color)> filter)
@@ -987,6 +973,34 @@ void Painter::blit_filtered(IntPoint position, Gfx::Bitmap const& source, IntRec
     }
 }
 
+void Painter::blit_multiplied(IntPoint position, Gfx::Bitmap const& source, IntRect const& src_rect, Color color)
+{
+    if (scale() != 1 || source.scale() != 1) {
+        return blit_filtered(position, source, src_rect, [color](Color pixel) -> Color {
+            return pixel.multiply(color);
+        });
+    }
+
+    IntRect safe_src_rect = src_rect.intersected(source.rect());
+    auto dst_rect = IntRect(position, safe_src_rect.size()).translated(translation());
+    auto clipped_rect = dst_rect.intersected(clip_rect());
+    if (clipped_rect.is_empty())
+        return;
+
+    int const first_row = clipped_rect.top() - dst_rect.top();
+    int const first_column = clipped_rect.left() - dst_rect.left();
+    ARGB32* dst = m_target->scanline(clipped_rect.y()) + clipped_rect.x();
+    size_t const dst_skip = m_target->pitch() / sizeof(ARGB32);
+    ARGB32 const* src = source.scanline(safe_src_rect.top() + first_row) + safe_src_rect.left() + first_column;
+    size_t const src_skip = source.pitch() / sizeof(ARGB32);
+
+    for (int row = 0; row < clipped_rect.height(); ++row) {
+        PixelKernels::blend_multiplied(dst, src, color, clipped_rect.width());
+        dst += dst_skip;
+        src += src_skip;
+    }
+}
+
 void Painter::blit_brightened(IntPoint position, Gfx::Bitmap const& source, IntRect const& src_rect)
 {
     return blit_filtered(position, source, src_rect, [](Color src) {
@@ -1107,13 +1121,7 @@ void Painter::blit(IntPoint position, Gfx::Bitmap const& source, IntRect const&
         u32 const* src = source.scanline(src_rect.top() + first_row) + src_rect.left() + first_column;
         size_t const src_skip = source.pitch() / sizeof(u32);
         for (int row = first_row; row <= last_row; ++row) {
-            for (int i = 0; i < clipped_rect.width(); ++i) {
-                u32 rgba = src[i];
-                u32 bgra = (rgba & 0xff00ff00)
-                    | ((rgba & 0x000000ff) << 16)
-                    | ((rgba & 0x00ff0000) >> 16);
-                dst[i] = bgra;
-            }
+            PixelKernels::swap_red_and_blue(dst, src, clipped_rect.width());
             dst += dst_skip;
             src += src_skip;
         }
@@ -1141,6 +1149,38 @@ ALWAYS_INLINE static void do_draw_integer_scaled_bitmap(Gfx::Bitmap& target, Int
     int x_limit = min(target.physical_width() - 1, dst_rect.right());
     int y_limit = min(target.physical_height() - 1, dst_rect.bottom());
     bool has_opacity = opacity != 1.0f;
+
+    if constexpr (has_alpha_channel) {
+        // Scale up a run of each source row once, and then blend it onto all the destination rows it covers.
+        constexpr size_t run_capacity = 256;
+        ARGB32 run[run_capacity];
+        for (int y = 0; y < src_rect.height(); ++y) {
+            int dst_y = dst_rect.y() + y * vfactor;
+            int run_x = dst_rect.x();
+            size_t run_length = 0;
+            auto blend_run = [&] {
+                for (int yo = 0; yo < vfactor && dst_y + yo <= y_limit; ++yo)
+                    PixelKernels::blend(target.scanline(dst_y + yo) + run_x, run, run_length);
+                run_x += run_length;
+                run_length = 0;
+            };
+
+            for (int x = 0; x < src_rect.width(); ++x) {
+                auto src_pixel = get_pixel(source, x + src_rect.left(), y + src_rect.top());
+                if (has_opacity)
+                    src_pixel.set_alpha(src_pixel.alpha() * opacity);
+                int dst_x = dst_rect.x() + x * hfactor;
+                for (int xo = 0; xo < hfactor && dst_x + xo <= x_limit; ++xo) {
+                    if (run_length == run_capacity)
+                        blend_run();
+                    run[run_length++] = src_pixel.value();
+                }
+            }
+            blend_run();
+        }
+        return;
+    }
+
     for (int y = 0; y < src_rect.height(); ++y) {
         int dst_y = dst_rect.y() + y * vfactor;
         for (int x = 0; x < src_rect.width(); ++x) {
@@ -1150,12 +1190,8 @@ ALWAYS_INLINE static void do_draw_integer_scaled_bitmap(Gfx::Bitmap& target, Int
             for (int yo = 0; yo < vfactor && dst_y + yo <= y_limit; ++yo) {
                 auto* scanline = (Color*)target.scanline(dst_y + yo);
                 int dst_x = dst_rect.x() + x * hfactor;
-                for (int xo = 0; xo < hfactor && dst_x + xo <= x_limit; ++xo) {
-                    if constexpr (has_alpha_channel)
-                        scanline[dst_x + xo] = scanline[dst_x + xo].blend(src_pixel);
-                    else
-                        scanline[dst_x + xo] = src_pixel;
-                }
+                for (int xo = 0; xo < hfactor && dst_x + xo <= x_limit; ++xo)
+                    scanline[dst_x + xo] = src_pixel;
             }
         }
     }
@@ -1201,12 +1237,23 @@ ALWAYS_INLINE static void do_draw_scaled_bitmap(Gfx::Bitmap& target, IntRect con
     i64 clipped_src_bottom_shifted = (clipped_src_rect.y() + clipped_src_rect.height()) * shift;
     i64 clipped_src_right_shifted = (clipped_src_rect.x() + clipped_src_rect.width()) * shift;
 
+    // Sampled pixels are blended in runs of consecutive destination pixels.
+    constexpr size_t run_capacity = 256;
+    [[maybe_unused]] ARGB32 run[run_capacity];
+
     for (int y = clipped_rect.top(); y <= clipped_rect.bottom(); ++y) {
         auto* scanline = (Color*)target.scanline(y);
         auto desired_y = ((y - dst_rect.y()) * vscale + src_top);
         if (desired_y < clipped_src_rect.top() || desired_y > clipped_src_bottom_shifted)
             continue;
 
+        [[maybe_unused]] int run_x = 0;
+        [[maybe_unused]] size_t run_length = 0;
+        [[maybe_unused]] auto blend_run = [&] {
+            PixelKernels::blend(target.scanline(y) + run_x, run, run_length);
+            run_length = 0;
+        };
+
         for (int x = clipped_rect.left(); x <= clipped_rect.right(); ++x) {
             auto desired_x = ((x - dst_rect.x()) * hscale + src_left);
             if (desired_x < clipped_src_rect.left() || desired_x > clipped_src_right_shifted)
@@ -1264,11 +1311,18 @@ ALWAYS_INLINE static void do_draw_scaled_bitmap(Gfx::Bitmap& target, IntRect con
             if (has_opacity)
                 src_pixel.set_alpha(src_pixel.alpha() * opacity);
             if constexpr (has_alpha_channel) {
-                scanline[x] = scanline[x].blend(src_pixel);
+                if (run_length > 0 && (run_x + static_cast<int>(run_length) != x || run_length == run_capacity))
+                    blend_run();
+                if (run_length == 0)
+                    run_x = x;
+                run[run_length++] = src_pixel.value();
             } else {
                 scanline[x] = src_pixel;
             }
         }
+
+        if constexpr (has_alpha_channel)
+            blend_run();
     }
 }
 
@@ -1286,6 +1340,10 @@ ALWAYS_INLINE static void do_draw_scaled_bitmap(Gfx::Bitmap& target, IntRect con
         do_draw_scaled_bitmap<has_alpha_channel, Painter::ScalingMode::SmoothPixels>(target, dst_rect, clipped_rect, source, src_rect, get_pixel, opacity);
         break;
     case Painter::ScalingMode::BilinearBlend:
+    // The resampling modes only end up here if resampling failed.
+    case Painter::ScalingMode::BoxSampling:
+    case Painter::ScalingMode::Bicubic:
+    case Painter::ScalingMode::Lanczos:
         do_draw_scaled_bitmap<has_alpha_channel, Painter::ScalingMode::BilinearBlend>(target, dst_rect, clipped_rect, source, src_rect, get_pixel, opacity);
         break;
     case Painter::ScalingMode::None:
@@ -1294,6 +1352,45 @@ ALWAYS_INLINE static void do_draw_scaled_bitmap(Gfx::Bitmap& target, IntRect con
     }
 }
 
+static Optional<ResamplingFilter> resampling_filter_for(Painter::ScalingMode scaling_mode)
+{
+    switch (scaling_mode) {
+    case Painter::ScalingMode::BoxSampling:
+        return ResamplingFilter::Box;
+    case Painter::ScalingMode::Bicubic:
+        return ResamplingFilter::Bicubic;
+    case Painter::ScalingMode::Lanczos:
+        return ResamplingFilter::Lanczos3;
+    default:
+        return {};
+    }
+}
+
+// Resamples only the part of the scaled bitmap that is visible, and blends that onto the target.
+static ErrorOr<void> draw_resampled_bitmap(Gfx::Bitmap& target, IntRect const& dst_rect, IntRect const& clipped_rect, Gfx::Bitmap const& source, FloatRect const& src_rect, float opacity, ResamplingFilter filter)
+{
+    auto resampled = TRY(Bitmap::create(source.has_alpha_channel() ? BitmapFormat::BGRA8888 : BitmapFormat::BGRx8888, clipped_rect.size()));
+    TRY(resample(*resampled, source, src_rect, dst_rect.size(), clipped_rect.translated(-dst_rect.location()), filter));
+
+    bool const is_opaque = !resampled->has_alpha_channel() && opacity == 1.0f;
+    for (int y = 0; y < clipped_rect.height(); ++y) {
+        auto* dst = target.scanline(clipped_rect.y() + y) + clipped_rect.x();
+        auto* src = resampled->scanline(y);
+        if (is_opaque) {
+            fast_u32_copy(dst, src, clipped_rect.width());
+            continue;
+        }
+        if (opacity != 1.0f) {
+            for (int x = 0; x < clipped_rect.width(); ++x) {
+                auto color = Color::from_argb(src[x]);
+                src[x] = color.with_alpha(color.alpha() * opacity).value();
+            }
+        }
+        PixelKernels::blend(dst, src, clipped_rect.width());
+    }
+    return {};
+}
+
 void Painter::draw_scaled_bitmap(IntRect const& a_dst_rect, Gfx::Bitmap const& source, IntRect const& a_src_rect, float opacity, ScalingMode scaling_mode)
 {
     draw_scaled_bitmap(a_dst_rect, source, FloatRect { a_src_rect }, opacity, scaling_mode);
@@ -1316,6 +1413,15 @@ void Painter::draw_scaled_bitmap(IntRect const& a_dst_rect, Gfx::Bitmap const& s
     if (clipped_rect.is_empty())
         return;
 
+    if (auto filter = resampling_filter_for(scaling_mode); filter.has_value()) {
+        if (enclosing_int_rect(src_rect).intersected(source.rect() * source.scale()).is_empty())
+            return;
+        auto result = draw_resampled_bitmap(*m_target, dst_rect, clipped_rect, source, src_rect, opacity, *filter);
+        if (!result.is_error())
+            return;
+        dbgln("Failed to resample bitmap, falling back to bilinear blending: {}", result.error());
+    }
+
     if (source.has_alpha_channel() || opacity != 1.0f) {
         switch (source.format()) {
         case BitmapFormat::BGRx8888:
@@ -1370,15 +1476,13 @@ FLATTEN void Painter::draw_glyph(FloatPoint point, u32 code_point, Font const& f
         draw_bitmap(top_left.to_type<int>(), glyph.glyph_bitmap(), color);
     } else if (glyph.is_color_bitmap()) {
         float scaled_width = glyph.advance();
-        float ratio = static_cast<float>(glyph.bitmap()->height()) / static_cast<float>(glyph.bitmap()->width());
+        float ratio = static_cast<float>(glyph.bitmap_rect().height()) / static_cast<float>(glyph.bitmap_rect().width());
         float scaled_height = scaled_width * ratio;
 
         FloatRect rect(point.x(), point.y(), scaled_width, scaled_height);
-        draw_scaled_bitmap(rect.to_rounded<int>(), *glyph.bitmap(), glyph.bitmap()->rect(), 1.0f, ScalingMode::BilinearBlend);
+        draw_scaled_bitmap(rect.to_rounded<int>(), *glyph.bitmap(), glyph.bitmap_rect(), 1.0f, ScalingMode::BilinearBlend);
     } else {
-        blit_filtered(glyph_position.blit_position, *glyph.bitmap(), glyph.bitmap()->rect(), [color](Color pixel) -> Color {
-            return pixel.multiply(color);
-        });
+        blit_multiplied(glyph_position.blit_position, *glyph.bitmap(), glyph.bitmap_rect(), color);
     }
 }
 
@@ -1407,16 +1511,12 @@ void Painter::draw_glyph_or_emoji(FloatPoint point, Utf8CodePointIterator& it, F
     auto next_code_point = it.peek(1);
 
     ScopeGuard consume_variation_selector = [&, initial_it = it] {
-        static auto const variation_selector = Unicode::property_from_string("Variation_Selector"sv);
-        if (!variation_selector.has_value())
-            return;
-
         // If we advanced the iterator to consume an emoji sequence, don't look for another variation selector.
         if (initial_it != it)
             return;
 
         // Otherwise, discard one code point if it's a variation selector.
-        if (next_code_point.has_value() && Unicode::code_point_has_property(*next_code_point, *variation_selector))
+        if (next_code_point.has_value() && is_variation_selector(*next_code_point))
             ++it;
     };
 
@@ -2118,17 +2218,12 @@ static bool can_approximate_bezier_curve(FloatPoint p1, FloatPoint p2, FloatPoin
 {
     constexpr float tolerance = 0.015f;
 
-    auto p1x = 3 * control.x() - 2 * p1.x() - p2.x();
-    auto p1y = 3 * control.y() - 2 * p1.y() - p2.y();
-    auto p2x = 3 * control.x() - 2 * p2.x() - p1.x();
-    auto p2y = 3 * control.y() - 2 * p2.y() - p1.y();
-
-    p1x = p1x * p1x;
-    p1y = p1y * p1y;
-    p2x = p2x * p2x;
-    p2y = p2y * p2y;
+    // This is the same flatness test as for cubic curves, with the control points of the cubic curve that is the same
+    // as this one. Both of them are 2 * control - p1 - p2 away from where a straight line would have them.
+    auto dx = 2 * control.x() - p1.x() - p2.x();
+    auto dy = 2 * control.y() - p1.y() - p2.y();
 
-    return max(p1x, p2x) + max(p1y, p2y) <= tolerance;
+    return dx * dx + dy * dy <= tolerance;
 }
 
 // static
@@ -2150,14 +2245,15 @@ void Painter::for_each_line_segment_on_bezier_curve(FloatPoint control_point, Fl
         auto new_segment = po1_midpoint + po2_midpoint;
         new_segment /= 2;
 
-        segments.enqueue({ po1_midpoint, p1, new_segment });
-        segments.enqueue({ po2_midpoint, new_segment, p2 });
+        segments.append({ po2_midpoint, new_segment, p2 });
+        segments.append({ po1_midpoint, p1, new_segment });
     };
 
-    Queue<SegmentDescriptor> segments;
-    segments.enqueue({ control_point, p1, p2 });
+    // The curve is split up depth first, so that the lines come out in order from p1 to p2.
+    Vector<SegmentDescriptor> segments;
+    segments.append({ control_point, p1, p2 });
     while (!segments.is_empty()) {
-        auto segment = segments.dequeue();
+        auto segment = segments.take_last();
 
         if (can_approximate_bezier_curve(segment.p1, segment.p2, segment.control_point))
             callback(segment.p1, segment.p2);
@@ -2230,14 +2326,15 @@ void Painter::for_each_line_segment_on_cubic_bezier_curve(FloatPoint control_poi
         };
         auto level_3_midpoint = (level_2_midpoints[0] + level_2_midpoints[1]) / 2;
 
-        segments.enqueue({ { level_1_midpoints[0], level_2_midpoints[0] }, p1, level_3_midpoint });
-        segments.enqueue({ { level_2_midpoints[1], level_1_midpoints[2] }, level_3_midpoint, p2 });
+        segments.append({ { level_2_midpoints[1], level_1_midpoints[2] }, level_3_midpoint, p2 });
+        segments.append({ { level_1_midpoints[0], level_2_midpoints[0] }, p1, level_3_midpoint });
     };
 
-    Queue<SegmentDescriptor> segments;
-    segments.enqueue({ { control_point_0, control_point_1 }, p1, p2 });
+    // The curve is split up depth first, so that the lines come out in order from p1 to p2.
+    Vector<SegmentDescriptor> segments;
+    segments.append({ { control_point_0, control_point_1 }, p1, p2 });
     while (!segments.is_empty()) {
-        auto segment = segments.dequeue();
+        auto segment = segments.take_last();
 
         if (can_approximate_cubic_bezier_curve(segment.p1, segment.p2, segment.control_points.control_point_0, segment.control_points.control_point_1))
             callback(segment.p1, segment.p2);
@@ -2488,6 +2585,38 @@ void Painter::draw_text_run(FloatPoint baseline_start, Utf8View const& string, F
     auto point = baseline_start;
     point.translate_by(0, -font.pixel_metrics().ascent);
 
+    // Plain glyphs that come from bitmaps (like the glyph atlas of vector fonts) are collected first, and then drawn
+    // in one go. Anything else, like emoji, is drawn as before, after drawing the glyphs in front of it.
+    struct QueuedGlyph {
+        IntPoint position;
+        NonnullRefPtr<Bitmap> bitmap;
+        IntRect bitmap_rect;
+    };
+    Vector<QueuedGlyph, 64> queued_glyphs;
+    auto draw_queued_glyphs = [&] {
+        for (auto const& glyph : queued_glyphs)
+            blit_multiplied(glyph.position, glyph.bitmap, glyph.bitmap_rect, color);
+        queued_glyphs.clear_with_capacity();
+    };
+
+    auto queue_plain_glyph = [&](Utf8CodePointIterator const& it) {
+        auto code_point = *it;
+        if (!font.contains_glyph(code_point))
+            return false;
+        if (!font.has_color_bitmaps() && Unicode::could_be_start_of_emoji_sequence(it, Unicode::SequenceType::EmojiPresentation))
+            return false;
+        if (auto next_code_point = it.peek(1); next_code_point.has_value() && is_variation_selector(*next_code_point))
+            return false;
+
+        auto top_left = point + FloatPoint(font.glyph_left_bearing(code_point), 0);
+        auto glyph_position = Gfx::GlyphRasterPosition::get_nearest_fit_for(top_left);
+        auto glyph = font.glyph(code_point, glyph_position.subpixel_offset);
+        if (glyph.is_glyph_bitmap() || glyph.is_color_bitmap())
+            return false;
+        queued_glyphs.append({ glyph_position.blit_position, *glyph.bitmap(), glyph.bitmap_rect() });
+        return true;
+    };
+
     for (auto code_point_iterator = string.begin(); code_point_iterator != string.end(); ++code_point_iterator) {
         auto code_point = *code_point_iterator;
         if (should_paint_as_space(code_point)) {
@@ -2503,11 +2632,16 @@ void Painter::draw_text_run(FloatPoint baseline_start, Utf8View const& string, F
         auto it = code_point_iterator; // The callback function will advance the iterator, so create a copy for this lookup.
         auto glyph_width = font.glyph_or_emoji_width(it) + font.glyph_spacing();
 
-        draw_glyph_or_emoji(point, code_point_iterator, font, color);
+        if (!queue_plain_glyph(code_point_iterator)) {
+            draw_queued_glyphs();
+            draw_glyph_or_emoji(point, code_point_iterator, font, color);
+        }
 
         point.translate_by(glyph_width, 0);
         last_code_point = code_point;
     }
+
+    draw_queued_glyphs();
 }
 
 void Painter::draw_scaled_bitmap_with_transform(IntRect const& dst_rect, Bitmap const& bitmap, FloatRect const& src_rect, AffineTransform const& transform, float opacity, Painter::ScalingMode scaling_mode)
@@ -12,6 +12,7 @@
 #include <AK/Utf8View.h>
 #include <AK/Vector.h>
 #include <LibGfx/Color.h>
+#include <LibGfx/CoverageRasterizer.h>
 #include <LibGfx/Font/FontDatabase.h>
 #include <LibGfx/Forward.h>
 #include <LibGfx/Gradients.h>
@@ -45,6 +46,10 @@ public:
         NearestNeighbor,
         SmoothPixels,
         BilinearBlend,
+        // These go through Gfx::resample(), which weighs in every source pixel that a destination pixel covers.
+        BoxSampling,
+        Bicubic,
+        Lanczos,
         None,
     };
 
@@ -85,6 +90,8 @@ public:
     void blit_dimmed(IntPoint, Gfx::Bitmap const&, IntRect const& src_rect);
     void blit_brightened(IntPoint, Gfx::Bitmap const&, IntRect const& src_rect);
     void blit_filtered(IntPoint, Gfx::Bitmap const&, IntRect const& src_rect, Function<Color(Color)>);
+    // Like blit_filtered() with a filter that multiplies each pixel with the color, which is how glyphs are drawn.
+    void blit_multiplied(IntPoint, Gfx::Bitmap const&, IntRect const& src_rect, Color);
     void draw_tiled_bitmap(IntRect const& dst_rect, Gfx::Bitmap const&);
     void blit_offset(IntPoint, Gfx::Bitmap const&, IntRect const& src_rect, IntPoint);
     void blit_disabled(IntPoint, Gfx::Bitmap const&, IntRect const&, Palette const&);
@@ -139,10 +146,7 @@ public:
 
     void stroke_path(Path const&, Color, int thickness);
 
-    enum class WindingRule {
-        Nonzero,
-        EvenOdd,
-    };
+    using WindingRule = Gfx::WindingRule;
 
     void fill_path(Path const&, Color, WindingRule rule = WindingRule::Nonzero);
     void fill_path(Path const&, PaintStyle const& paint_style, WindingRule rule = WindingRule::Nonzero);
@@ -222,14 +226,13 @@ private:
 
     void antialiased_fill_path(Path const&, Color, WindingRule rule, FloatPoint translation);
     void antialiased_fill_path(Path const&, PaintStyle const& paint_style, WindingRule rule, FloatPoint translation);
-    enum class FillPathMode {
-        PlaceOnIntGrid,
-        AllowFloatingPoints,
-    };
-    template<typename T, typename TColorOrFunction>
-    void draw_scanline_for_fill_path(int y, T x_start, T x_end, TColorOrFunction color);
-    template<FillPathMode fill_path_mode, typename ColorOrFunction>
-    void fill_path_impl(Path const& path, ColorOrFunction color, Gfx::Painter::WindingRule winding_rule, Optional<FloatPoint> offset = {});
+    // Fills the pixels of the rasterizer, which are in physical coordinates and have to be inside the clip rect.
+    void fill_coverage(CoverageRasterizer&, WindingRule, Color);
+    void fill_coverage(CoverageRasterizer&, WindingRule, PaintStyle::SamplerFunction const&, IntPoint sampler_origin);
+    template<typename TColorOrFunction>
+    void draw_scanline_for_fill_path(int y, int x_start, int x_end, TColorOrFunction color);
+    template<typename ColorOrFunction>
+    void fill_path_impl(Path const& path, ColorOrFunction color, Gfx::Painter::WindingRule winding_rule);
 };
 
 class PainterStateSaver {
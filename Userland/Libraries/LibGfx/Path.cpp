@@ -237,54 +237,19 @@ DeprecatedString Path::to_deprecated_string() const
     return builder.to_deprecated_string();
 }
 
-void Path::segmentize_path()
+void Path::for_each_line(Function<void(FloatPoint from, FloatPoint to, bool starts_subpath)> const& callback) const
 {
-    Vector<SplitLineSegment> segments;
-    float min_x = 0;
-    float min_y = 0;
-    float max_x = 0;
-    float max_y = 0;
-
-    auto add_point_to_bbox = [&](Gfx::FloatPoint point) {
-        float x = point.x();
-        float y = point.y();
-        min_x = min(min_x, x);
-        min_y = min(min_y, y);
-        max_x = max(max_x, x);
-        max_y = max(max_y, y);
-    };
-
-    auto add_line = [&](auto const& p0, auto const& p1) {
-        float ymax = p0.y(), ymin = p1.y(), x_of_ymin = p1.x(), x_of_ymax = p0.x();
-        auto slope = p0.x() == p1.x() ? 0 : ((float)(p0.y() - p1.y())) / ((float)(p0.x() - p1.x()));
-        if (p0.y() < p1.y()) {
-            swap(ymin, ymax);
-            swap(x_of_ymin, x_of_ymax);
-        }
-
-        segments.append({ FloatPoint(p0.x(), p0.y()),
-            FloatPoint(p1.x(), p1.y()),
-            slope == 0 ? 0 : 1 / slope,
-            x_of_ymin,
-            ymax, ymin, x_of_ymax });
-
-        add_point_to_bbox(p1);
-    };
-
     FloatPoint cursor { 0, 0 };
-    bool first = true;
+    bool starts_subpath = true;
+    auto add_line = [&](FloatPoint p0, FloatPoint p1) {
+        callback(p0, p1, starts_subpath);
+        starts_subpath = false;
+    };
 
     for (auto& segment : m_segments) {
         switch (segment->type()) {
         case Segment::Type::MoveTo:
-            if (first) {
-                min_x = segment->point().x();
-                min_y = segment->point().y();
-                max_x = segment->point().x();
-                max_y = segment->point().y();
-            } else {
-                add_point_to_bbox(segment->point());
-            }
+            starts_subpath = true;
             cursor = segment->point();
             break;
         case Segment::Type::LineTo: {
@@ -321,10 +286,61 @@ void Path::segmentize_path()
         case Segment::Type::Invalid:
             VERIFY_NOT_REACHED();
         }
+    }
+}
+
+void Path::segmentize_path()
+{
+    Vector<SplitLineSegment> segments;
+    float min_x = 0;
+    float min_y = 0;
+    float max_x = 0;
+    float max_y = 0;
+
+    auto add_point_to_bbox = [&](Gfx::FloatPoint point) {
+        float x = point.x();
+        float y = point.y();
+        min_x = min(min_x, x);
+        min_y = min(min_y, y);
+        max_x = max(max_x, x);
+        max_y = max(max_y, y);
+    };
+
+    auto add_line = [&](auto const& p0, auto const& p1) {
+        float ymax = p0.y(), ymin = p1.y(), x_of_ymin = p1.x(), x_of_ymax = p0.x();
+        auto slope = p0.x() == p1.x() ? 0 : ((float)(p0.y() - p1.y())) / ((float)(p0.x() - p1.x()));
+        if (p0.y() < p1.y()) {
+            swap(ymin, ymax);
+            swap(x_of_ymin, x_of_ymax);
+        }
+
+        segments.append({ FloatPoint(p0.x(), p0.y()),
+            FloatPoint(p1.x(), p1.y()),
+            slope == 0 ? 0 : 1 / slope,
+            x_of_ymin,
+            ymax, ymin, x_of_ymax });
 
-        first = false;
+        add_point_to_bbox(p1);
+    };
+
+    for (size_t i = 0; i < m_segments.size(); ++i) {
+        auto const& segment = m_segments[i];
+        if (segment->type() != Segment::Type::MoveTo)
+            continue;
+        if (i == 0) {
+            min_x = segment->point().x();
+            min_y = segment->point().y();
+            max_x = segment->point().x();
+            max_y = segment->point().y();
+        } else {
+            add_point_to_bbox(segment->point());
+        }
     }
 
+    for_each_line([&](FloatPoint p0, FloatPoint p1, bool) {
+        add_line(p0, p1);
+    });
+
     // sort segments by ymax
     quick_sort(segments, [](auto const& line0, auto const& line1) {
         return line1.maximum_y < line0.maximum_y;
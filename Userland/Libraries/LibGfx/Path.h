@@ -7,6 +7,7 @@
 #pragma once
 
 #include <AK/DeprecatedString.h>
+#include <AK/Function.h>
 #include <AK/HashMap.h>
 #include <AK/Optional.h>
 #include <AK/Vector.h>
@@ -218,6 +219,11 @@ public:
     };
 
     Vector<NonnullRefPtr<Segment const>> const& segments() const { return m_segments; }
+
+    // Calls `callback` for each line of the path in order, with the curves split up into lines. `starts_subpath` is
+    // set for the first line after each move.
+    void for_each_line(Function<void(FloatPoint from, FloatPoint to, bool starts_subpath)> const& callback) const;
+
     auto& split_lines() const
     {
         if (!m_split_lines.has_value()) {
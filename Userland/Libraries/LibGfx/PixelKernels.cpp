@@ -0,0 +1,294 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Platform.h>
+#include <AK/SIMD.h>
+#include <LibGfx/PixelKernels.h>
+
+#if ARCH(X86_64)
+#    include <cpuid.h>
+#endif
+
+#pragma GCC diagnostic ignored "-Wpsabi"
+
+namespace Gfx::PixelKernels {
+
+using namespace AK::SIMD;
+
+#if ARCH(X86_64)
+static bool cpu_supports_avx2()
+{
+    unsigned eax, ebx, ecx, edx;
+    if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx))
+        return false;
+
+    // The kernel also has to save the AVX registers when switching between threads.
+    if (!(ecx & bit_OSXSAVE) || !(ecx & bit_AVX))
+        return false;
+    unsigned xcr0_low, xcr0_high;
+    asm volatile("xgetbv"
+                 : "=a"(xcr0_low), "=d"(xcr0_high)
+                 : "c"(0));
+    if ((xcr0_low & 0x6) != 0x6)
+        return false;
+
+    if (__get_cpuid_max(0, nullptr) < 7)
+        return false;
+    __cpuid_count(7, 0, eax, ebx, ecx, edx);
+    return ebx & bit_AVX2;
+}
+#endif
+
+bool is_supported(Implementation implementation)
+{
+    switch (implementation) {
+    case Implementation::Scalar:
+    case Implementation::Vector128:
+        return true;
+    case Implementation::Vector256:
+#if ARCH(X86_64)
+        static bool const supports_avx2 = cpu_supports_avx2();
+        return supports_avx2;
+#else
+        return false;
+#endif
+    }
+    VERIFY_NOT_REACHED();
+}
+
+static Implementation& current_implementation()
+{
+    static Implementation implementation = is_supported(Implementation::Vector256) ? Implementation::Vector256 : Implementation::Vector128;
+    return implementation;
+}
+
+Implementation implementation()
+{
+    return current_implementation();
+}
+
+void set_implementation(Implementation implementation)
+{
+    VERIFY(is_supported(implementation));
+    current_implementation() = implementation;
+}
+
+static constexpr u32 opaque_alpha = 0xff000000;
+
+ALWAYS_INLINE static u32 swap_red_and_blue(u32 pixel)
+{
+    return (pixel & 0xff00ff00) | ((pixel & 0x000000ff) << 16) | ((pixel & 0x00ff0000) >> 16);
+}
+
+// All of the products and sums in Color::blend() stay below 2^24, so floats hold them exactly, and the quotients are
+// far enough from the next integer for a correctly rounded float division to truncate to the same value.
+template<typename U32xN, typename I32xN, typename F32xN>
+ALWAYS_INLINE static U32xN blend_pixels(U32xN dst, U32xN src)
+{
+    auto channel = [](U32xN pixels, int shift) {
+        return __builtin_convertvector(__builtin_convertvector((pixels >> shift) & 0xff, I32xN), F32xN);
+    };
+
+    F32xN dst_alpha = channel(dst, 24);
+    F32xN src_alpha = channel(src, 24);
+    F32xN dst_weight = dst_alpha * (255 - src_alpha);
+    F32xN src_weight = 255 * src_alpha;
+    F32xN divisor = 255 * (dst_alpha + src_alpha) - dst_alpha * src_alpha;
+
+    // Color::blend() returns the source pixel if both are fully transparent.
+    I32xN both_transparent = divisor == 0;
+    F32xN safe_divisor = divisor + __builtin_convertvector(both_transparent & 1, F32xN);
+
+    auto blend_channel = [&](int shift) {
+        F32xN blended = channel(dst, shift) * dst_weight + channel(src, shift) * src_weight;
+        return __builtin_convertvector(__builtin_convertvector(blended / safe_divisor, I32xN), U32xN) << shift;
+    };
+
+    U32xN alpha = __builtin_convertvector(__builtin_convertvector(divisor / 255, I32xN), U32xN) << 24;
+    U32xN result = blend_channel(0) | blend_channel(8) | blend_channel(16) | alpha;
+    U32xN source_mask = __builtin_convertvector(both_transparent, U32xN);
+    return (result & ~source_mask) | (src & source_mask);
+}
+
+template<typename VectorType>
+ALWAYS_INLINE static VectorType load(u32 const* pixels)
+{
+    VectorType vector;
+    __builtin_memcpy(&vector, pixels, sizeof(vector));
+    return vector;
+}
+
+template<typename VectorType>
+ALWAYS_INLINE static void store(u32* pixels, VectorType vector)
+{
+    __builtin_memcpy(pixels, &vector, sizeof(vector));
+}
+
+template<typename VectorType>
+ALWAYS_INLINE static VectorType splat(u32 value)
+{
+    VectorType vector;
+    for (size_t i = 0; i < sizeof(vector) / sizeof(u32); ++i)
+        vector[i] = value;
+    return vector;
+}
+
+template<typename U32xN, typename I32xN, typename F32xN, typename GetSource>
+ALWAYS_INLINE static size_t blend_vectors(ARGB32* dst, size_t count, Destination destination, GetSource get_source)
+{
+    constexpr size_t pixels_per_vector = sizeof(U32xN) / sizeof(u32);
+    U32xN const dst_alpha_fill = splat<U32xN>(destination == Destination::Opaque ? opaque_alpha : 0);
+
+    size_t i = 0;
+    for (; i + pixels_per_vector <= count; i += pixels_per_vector)
+        store(dst + i, blend_pixels<U32xN, I32xN, F32xN>(load<U32xN>(dst + i) | dst_alpha_fill, get_source(i)));
+    return i;
+}
+
+// Like blend_pixels(), the products of two channels are exact in floats and their quotients truncate correctly.
+template<typename U32xN, typename I32xN, typename F32xN>
+ALWAYS_INLINE static U32xN multiply_pixels(U32xN pixels, U32xN color)
+{
+    auto multiply_channel = [&](int shift) {
+        auto pixel_channel = __builtin_convertvector(__builtin_convertvector((pixels >> shift) & 0xff, I32xN), F32xN);
+        auto color_channel = __builtin_convertvector(__builtin_convertvector((color >> shift) & 0xff, I32xN), F32xN);
+        return __builtin_convertvector(__builtin_convertvector(pixel_channel * color_channel / 255, I32xN), U32xN) << shift;
+    };
+    return multiply_channel(0) | multiply_channel(8) | multiply_channel(16) | multiply_channel(24);
+}
+
+template<typename U32xN, typename I32xN, typename F32xN>
+ALWAYS_INLINE static size_t blend_multiplied_vectors(ARGB32* dst, ARGB32 const* src, Color color, size_t count)
+{
+    constexpr size_t pixels_per_vector = sizeof(U32xN) / sizeof(u32);
+    U32xN const color_vector = splat<U32xN>(color.value());
+
+    size_t i = 0;
+    for (; i + pixels_per_vector <= count; i += pixels_per_vector) {
+        auto source = load<U32xN>(src + i);
+        auto destination = load<U32xN>(dst + i);
+        auto blended = blend_pixels<U32xN, I32xN, F32xN>(destination, multiply_pixels<U32xN, I32xN, F32xN>(source, color_vector));
+        U32xN transparent_mask = __builtin_convertvector((source >> 24) == 0, U32xN);
+        store(dst + i, (blended & ~transparent_mask) | (destination & transparent_mask));
+    }
+    return i;
+}
+
+template<typename U32xN>
+ALWAYS_INLINE static size_t swap_red_and_blue_vectors(u32* dst, u32 const* src, size_t count)
+{
+    constexpr size_t pixels_per_vector = sizeof(U32xN) / sizeof(u32);
+
+    size_t i = 0;
+    for (; i + pixels_per_vector <= count; i += pixels_per_vector) {
+        auto pixels = load<U32xN>(src + i);
+        store(dst + i, (pixels & 0xff00ff00) | ((pixels & 0x000000ff) << 16) | ((pixels & 0x00ff0000) >> 16));
+    }
+    return i;
+}
+
+static size_t blend_vector128(ARGB32* dst, ARGB32 const* src, size_t count, Destination destination)
+{
+    return blend_vectors<u32x4, i32x4, f32x4>(dst, count, destination, [src](size_t i) { return load<u32x4>(src + i); });
+}
+
+static size_t blend_vector128(ARGB32* dst, Color color, size_t count, Destination destination)
+{
+    auto src = splat<u32x4>(color.value());
+    return blend_vectors<u32x4, i32x4, f32x4>(dst, count, destination, [src](size_t) { return src; });
+}
+
+static size_t blend_multiplied_vector128(ARGB32* dst, ARGB32 const* src, Color color, size_t count)
+{
+    return blend_multiplied_vectors<u32x4, i32x4, f32x4>(dst, src, color, count);
+}
+
+static size_t swap_red_and_blue_vector128(u32* dst, u32 const* src, size_t count)
+{
+    return swap_red_and_blue_vectors<u32x4>(dst, src, count);
+}
+
+// Only the x86-64 build ever uses these, everywhere else is_supported() rules them out.
+#if ARCH(X86_64)
+#    define VECTOR256_TARGET [[gnu::target("avx2")]]
+#else
+#    define VECTOR256_TARGET
+#endif
+
+VECTOR256_TARGET static size_t blend_vector256(ARGB32* dst, ARGB32 const* src, size_t count, Destination destination)
+{
+    return blend_vectors<u32x8, i32x8, f32x8>(dst, count, destination, [src](size_t i) { return load<u32x8>(src + i); });
+}
+
+VECTOR256_TARGET static size_t blend_vector256(ARGB32* dst, Color color, size_t count, Destination destination)
+{
+    auto src = splat<u32x8>(color.value());
+    return blend_vectors<u32x8, i32x8, f32x8>(dst, count, destination, [src](size_t) { return src; });
+}
+
+VECTOR256_TARGET static size_t blend_multiplied_vector256(ARGB32* dst, ARGB32 const* src, Color color, size_t count)
+{
+    return blend_multiplied_vectors<u32x8, i32x8, f32x8>(dst, src, color, count);
+}
+
+VECTOR256_TARGET static size_t swap_red_and_blue_vector256(u32* dst, u32 const* src, size_t count)
+{
+    return swap_red_and_blue_vectors<u32x8>(dst, src, count);
+}
+
+// The vector kernels only process whole vectors, and return how many pixels that was. The scalar loops do the rest.
+#define RUN_VECTOR_KERNEL(kernel, ...)                  \
+    [&]() -> size_t {                                   \
+        switch (current_implementation()) {             \
+        case Implementation::Scalar:                    \
+            return 0;                                   \
+        case Implementation::Vector128:                 \
+            return kernel##_vector128(__VA_ARGS__);     \
+        case Implementation::Vector256:                 \
+            return kernel##_vector256(__VA_ARGS__);     \
+        }                                               \
+        VERIFY_NOT_REACHED();                           \
+    }()
+
+void blend(ARGB32* dst, ARGB32 const* src, size_t count, Destination destination)
+{
+    size_t done = RUN_VECTOR_KERNEL(blend, dst, src, count, destination);
+
+    u32 const dst_alpha_fill = destination == Destination::Opaque ? opaque_alpha : 0;
+    for (size_t i = done; i < count; ++i)
+        dst[i] = Color::from_argb(dst[i] | dst_alpha_fill).blend(Color::from_argb(src[i])).value();
+}
+
+void blend(ARGB32* dst, Color color, size_t count, Destination destination)
+{
+    size_t done = RUN_VECTOR_KERNEL(blend, dst, color, count, destination);
+
+    u32 const dst_alpha_fill = destination == Destination::Opaque ? opaque_alpha : 0;
+    for (size_t i = done; i < count; ++i)
+        dst[i] = Color::from_argb(dst[i] | dst_alpha_fill).blend(color).value();
+}
+
+void blend_multiplied(ARGB32* dst, ARGB32 const* src, Color color, size_t count)
+{
+    size_t done = RUN_VECTOR_KERNEL(blend_multiplied, dst, src, color, count);
+
+    for (size_t i = done; i < count; ++i) {
+        auto source = Color::from_argb(src[i]);
+        if (source.alpha() == 0)
+            continue;
+        dst[i] = Color::from_argb(dst[i]).blend(source.multiply(color)).value();
+    }
+}
+
+void swap_red_and_blue(u32* dst, u32 const* src, size_t count)
+{
+    size_t done = RUN_VECTOR_KERNEL(swap_red_and_blue, dst, src, count);
+
+    for (size_t i = done; i < count; ++i)
+        dst[i] = swap_red_and_blue(src[i]);
+}
+
+}
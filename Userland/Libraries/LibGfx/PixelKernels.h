@@ -0,0 +1,47 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Types.h>
+#include <LibGfx/Color.h>
+
+// Loops over runs of pixels that the Painter spends most of its time in, written so that they can process several
+// pixels at once.
+namespace Gfx::PixelKernels {
+
+// The fastest implementation the CPU supports is used by default. On x86-64, the vector implementations use SSE2 and
+// AVX2; elsewhere they use whatever vector instructions the compiler targets.
+enum class Implementation {
+    Scalar,
+    Vector128,
+    Vector256,
+};
+
+bool is_supported(Implementation);
+Implementation implementation();
+
+// Only meant for tests and benchmarks, which want to compare the implementations.
+void set_implementation(Implementation);
+
+enum class Destination {
+    HasAlpha,
+    // The alpha channel of the destination pixels is ignored, they are treated as fully opaque.
+    Opaque,
+};
+
+// Blends each source pixel over the destination pixel, with exactly the same results as Color::blend().
+void blend(ARGB32* dst, ARGB32 const* src, size_t count, Destination = Destination::HasAlpha);
+void blend(ARGB32* dst, Color, size_t count, Destination = Destination::HasAlpha);
+
+// Multiplies each source pixel with the color like Color::multiply() does, and blends the result over the destination
+// pixel. Fully transparent source pixels are skipped. This is how glyphs get tinted with the text color.
+void blend_multiplied(ARGB32* dst, ARGB32 const* src, Color, size_t count);
+
+// Converts between RGBA8888 and BGRA8888. The destination and source may be the same.
+void swap_red_and_blue(u32* dst, u32 const* src, size_t count);
+
+}
@@ -0,0 +1,326 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/BitCast.h>
+#include <AK/FixedArray.h>
+#include <AK/Math.h>
+#include <AK/SIMDExtras.h>
+#include <AK/Vector.h>
+#include <LibGfx/Bitmap.h>
+#include <LibGfx/HelperThreads.h>
+#include <LibGfx/Resampler.h>
+#include <math.h>
+
+#pragma GCC diagnostic ignored "-Wpsabi"
+
+namespace Gfx {
+
+using namespace AK::SIMD;
+
+struct FilterFunction {
+    // The weight is zero outside of [-support, support].
+    float support;
+    float (*weight)(float);
+};
+
+static float box_weight(float x)
+{
+    return x > -0.5f && x <= 0.5f ? 1.0f : 0.0f;
+}
+
+static float triangle_weight(float x)
+{
+    x = fabsf(x);
+    return x < 1.0f ? 1.0f - x : 0.0f;
+}
+
+static float catmull_rom_weight(float x)
+{
+    constexpr float a = -0.5f;
+    x = fabsf(x);
+    if (x < 1.0f)
+        return ((a + 2.0f) * x - (a + 3.0f)) * x * x + 1.0f;
+    if (x < 2.0f)
+        return (((x - 5.0f) * x + 8.0f) * x - 4.0f) * a;
+    return 0.0f;
+}
+
+static float sinc(float x)
+{
+    if (x == 0.0f)
+        return 1.0f;
+    x *= AK::Pi<float>;
+    return sinf(x) / x;
+}
+
+static float lanczos3_weight(float x)
+{
+    if (x <= -3.0f || x >= 3.0f)
+        return 0.0f;
+    return sinc(x) * sinc(x / 3.0f);
+}
+
+static FilterFunction filter_function(ResamplingFilter filter)
+{
+    switch (filter) {
+    case ResamplingFilter::Box:
+        return { 0.5f, box_weight };
+    case ResamplingFilter::Bilinear:
+        return { 1.0f, triangle_weight };
+    case ResamplingFilter::Bicubic:
+        return { 2.0f, catmull_rom_weight };
+    case ResamplingFilter::Lanczos3:
+        return { 3.0f, lanczos3_weight };
+    }
+    VERIFY_NOT_REACHED();
+}
+
+// The source pixels that each destination pixel along one axis is made of, and how much each of them counts.
+struct Contributions {
+    // The source pixels that any destination pixel needs, the indices below count from `source_begin`.
+    int source_begin { 0 };
+    int source_end { 0 };
+
+    Vector<int> first_index;
+    Vector<int> tap_count;
+    // `max_tap_count` weights for each destination pixel, of which the first `tap_count` ones are used.
+    Vector<float> weights;
+    int max_tap_count { 0 };
+
+    size_t destination_length() const { return first_index.size(); }
+    float const* weights_for(size_t index) const { return weights.data() + index * max_tap_count; }
+};
+
+// Computes the weights for the destination pixels [visible_begin, visible_begin + visible_length) of an axis that is
+// scaled from [source_offset, source_offset + source_length) to [0, scaled_length). Only the source pixels in
+// [source_begin, source_end) exist, the weights of the others are spread over them.
+static ErrorOr<Contributions> compute_contributions(ResamplingFilter filter, float source_offset, float source_length, int source_begin, int source_end, int scaled_length, int visible_begin, int visible_length)
+{
+    auto const function = filter_function(filter);
+    float const scale = source_length / static_cast<float>(scaled_length);
+    // When scaling down, the filter gets stretched to cover every source pixel in between two destination pixels.
+    float const filter_scale = max(scale, 1.0f);
+    float const support = function.support * filter_scale;
+
+    Contributions contributions;
+    contributions.max_tap_count = static_cast<int>(ceilf(2.0f * support)) + 1;
+    TRY(contributions.first_index.try_resize(visible_length));
+    TRY(contributions.tap_count.try_resize(visible_length));
+    TRY(contributions.weights.try_resize(static_cast<size_t>(visible_length) * contributions.max_tap_count));
+
+    for (int i = 0; i < visible_length; ++i) {
+        // The center of source pixel j is at j + 0.5.
+        float const center = source_offset + (static_cast<float>(visible_begin + i) + 0.5f) * scale;
+        int first = max(static_cast<int>(floorf(center - support)), source_begin);
+        int const end = min(static_cast<int>(ceilf(center + support)), source_end);
+
+        auto* weights = contributions.weights.data() + static_cast<size_t>(i) * contributions.max_tap_count;
+        float total = 0.0f;
+        for (int j = first; j < end; ++j) {
+            auto weight = function.weight((static_cast<float>(j) + 0.5f - center) / filter_scale);
+            weights[j - first] = weight;
+            total += weight;
+        }
+
+        int leading_zeros = 0;
+        int count = max(end - first, 0);
+        while (count > 0 && weights[leading_zeros] == 0.0f) {
+            ++leading_zeros;
+            --count;
+        }
+        while (count > 0 && weights[leading_zeros + count - 1] == 0.0f)
+            --count;
+
+        if (count == 0 || total == 0.0f) {
+            // The center is too far outside of the source pixels for the filter to reach them, so the nearest one is used.
+            first = clamp(static_cast<int>(floorf(center)), source_begin, source_end - 1);
+            weights[0] = 1.0f;
+            count = 1;
+        } else {
+            first += leading_zeros;
+            for (int tap = 0; tap < count; ++tap)
+                weights[tap] = weights[leading_zeros + tap] / total;
+        }
+
+        contributions.first_index[i] = first;
+        contributions.tap_count[i] = count;
+    }
+
+    // The first indices only ever grow, since the centers do.
+    contributions.source_begin = contributions.first_index.first();
+    contributions.source_end = contributions.source_begin;
+    for (int i = 0; i < visible_length; ++i) {
+        contributions.source_end = max(contributions.source_end, contributions.first_index[i] + contributions.tap_count[i]);
+        contributions.first_index[i] -= contributions.source_begin;
+    }
+    return contributions;
+}
+
+ALWAYS_INLINE static f32x4 premultiplied(f32x4 pixel)
+{
+    float const alpha = pixel[3] / 255.0f;
+    return pixel * f32x4 { alpha, alpha, alpha, 1.0f };
+}
+
+// Converts four pixels at a time: their channels are split up into one vector per channel, and transposed back into one
+// vector per pixel at the end.
+template<bool is_opaque>
+ALWAYS_INLINE static void load_four_pixels(ARGB32 const* pixels, f32x4* row)
+{
+    u32x4 packed;
+    __builtin_memcpy(&packed, pixels, sizeof(packed));
+    auto channel = [&](u32 shift) { return to_f32x4(to_i32x4((packed >> shift) & 0xffu)); };
+
+    f32x4 blue = channel(0);
+    f32x4 green = channel(8);
+    f32x4 red = channel(16);
+    f32x4 alpha = expand4(255.0f);
+    if constexpr (!is_opaque) {
+        alpha = channel(24);
+        auto factor = alpha / 255.0f;
+        blue *= factor;
+        green *= factor;
+        red *= factor;
+    }
+
+    f32x4 blue_green_low = __builtin_shufflevector(blue, green, 0, 4, 1, 5);
+    f32x4 blue_green_high = __builtin_shufflevector(blue, green, 2, 6, 3, 7);
+    f32x4 red_alpha_low = __builtin_shufflevector(red, alpha, 0, 4, 1, 5);
+    f32x4 red_alpha_high = __builtin_shufflevector(red, alpha, 2, 6, 3, 7);
+    row[0] = __builtin_shufflevector(blue_green_low, red_alpha_low, 0, 1, 4, 5);
+    row[1] = __builtin_shufflevector(blue_green_low, red_alpha_low, 2, 3, 6, 7);
+    row[2] = __builtin_shufflevector(blue_green_high, red_alpha_high, 0, 1, 4, 5);
+    row[3] = __builtin_shufflevector(blue_green_high, red_alpha_high, 2, 3, 6, 7);
+}
+
+template<bool is_opaque>
+static void load_row(ARGB32 const* pixels, int count, f32x4* row)
+{
+    int x = 0;
+    for (; x + 4 <= count; x += 4)
+        load_four_pixels<is_opaque>(pixels + x, row + x);
+    for (; x < count; ++x) {
+        auto pixel = to_f32x4(bit_cast<u8x4>(pixels[x]));
+        if constexpr (is_opaque)
+            pixel[3] = 255.0f;
+        row[x] = is_opaque ? pixel : premultiplied(pixel);
+    }
+}
+
+// Loads source pixels as premultiplied floats, in the order B, G, R, A.
+static void load_row(Bitmap const& source, int y, int first_x, int end_x, f32x4* row)
+{
+    switch (source.format()) {
+    case BitmapFormat::BGRx8888:
+        return load_row<true>(source.scanline(y) + first_x, end_x - first_x, row);
+    case BitmapFormat::BGRA8888:
+        return load_row<false>(source.scanline(y) + first_x, end_x - first_x, row);
+    default:
+        for (int x = first_x; x < end_x; ++x)
+            row[x - first_x] = premultiplied(to_f32x4(bit_cast<u8x4>(source.get_pixel(x, y).value())));
+        return;
+    }
+}
+
+static void filter_row(f32x4 const* source_row, Contributions const& columns, f32x4* row)
+{
+    for (size_t x = 0; x < columns.destination_length(); ++x) {
+        auto const* pixels = source_row + columns.first_index[x];
+        auto const* weights = columns.weights_for(x);
+        f32x4 sum = pixels[0] * weights[0];
+        for (int tap = 1; tap < columns.tap_count[x]; ++tap)
+            sum += pixels[tap] * weights[tap];
+        row[x] = sum;
+    }
+}
+
+ALWAYS_INLINE static ARGB32 to_argb32(f32x4 pixel)
+{
+    // Filters with negative weights can overshoot, and colors can't be brighter than the alpha they were multiplied with.
+    float const alpha = clamp(pixel[3], 0.0f, 255.0f);
+    if (alpha < 0.5f)
+        return 0;
+    f32x4 const zero {};
+    f32x4 const limit = expand4(alpha);
+    pixel = pixel < zero ? zero : pixel;
+    pixel = pixel > limit ? limit : pixel;
+    pixel *= 255.0f / alpha;
+    pixel[3] = alpha;
+    return bit_cast<ARGB32>(to_u8x4(to_i32x4(pixel + 0.5f)));
+}
+
+// Produces the destination rows [first_row, end_row). Rows are scaled horizontally into a ring buffer that holds as
+// many of them as a destination row can be made of, so each source row is only scaled once.
+static ErrorOr<void> resample_rows(Bitmap& destination, Bitmap const& source, Contributions const& columns, Contributions const& rows, int first_row, int end_row)
+{
+    size_t const width = columns.destination_length();
+    int const ring_size = rows.max_tap_count;
+
+    auto source_row = TRY(FixedArray<f32x4>::create(columns.source_end - columns.source_begin));
+    auto filtered_rows = TRY(FixedArray<f32x4>::create(width * ring_size));
+    auto sum = TRY(FixedArray<f32x4>::create(width));
+
+    auto filtered_row = [&](int index) { return filtered_rows.data() + (index % ring_size) * width; };
+
+    int next_index = rows.first_index[first_row];
+    for (int y = first_row; y < end_row; ++y) {
+        int const first_index = rows.first_index[y];
+        int const tap_count = rows.tap_count[y];
+
+        // Rows that an earlier destination row needed are still in the ring buffer, since the windows only move down.
+        next_index = max(next_index, first_index);
+        for (; next_index < first_index + tap_count; ++next_index) {
+            load_row(source, rows.source_begin + next_index, columns.source_begin, columns.source_end, source_row.data());
+            filter_row(source_row.data(), columns, filtered_row(next_index));
+        }
+
+        auto const* weights = rows.weights_for(y);
+        auto const* row = filtered_row(first_index);
+        for (size_t x = 0; x < width; ++x)
+            sum[x] = row[x] * weights[0];
+        for (int tap = 1; tap < tap_count; ++tap) {
+            row = filtered_row(first_index + tap);
+            for (size_t x = 0; x < width; ++x)
+                sum[x] += row[x] * weights[tap];
+        }
+
+        auto* scanline = destination.scanline(y);
+        for (size_t x = 0; x < width; ++x)
+            scanline[x] = to_argb32(sum[x]);
+    }
+    return {};
+}
+
+ErrorOr<void> resample(Bitmap& destination, Bitmap const& source, FloatRect const& source_rect, IntSize scaled_size, IntRect const& visible_rect, ResamplingFilter filter)
+{
+    VERIFY(destination.format() == BitmapFormat::BGRA8888 || destination.format() == BitmapFormat::BGRx8888);
+    VERIFY(destination.physical_width() >= visible_rect.width() && destination.physical_height() >= visible_rect.height());
+    VERIFY(!scaled_size.is_empty());
+    if (visible_rect.is_empty())
+        return {};
+
+    int const source_left = max(static_cast<int>(floorf(source_rect.x())), 0);
+    int const source_right = min(static_cast<int>(ceilf(source_rect.x() + source_rect.width())), source.physical_width());
+    int const source_top = max(static_cast<int>(floorf(source_rect.y())), 0);
+    int const source_bottom = min(static_cast<int>(ceilf(source_rect.y() + source_rect.height())), source.physical_height());
+    if (source_left >= source_right || source_top >= source_bottom)
+        return Error::from_string_literal("Source rect doesn't overlap the source bitmap");
+
+    auto const columns = TRY(compute_contributions(filter, source_rect.x(), source_rect.width(), source_left, source_right, scaled_size.width(), visible_rect.x(), visible_rect.width()));
+    auto const rows = TRY(compute_contributions(filter, source_rect.y(), source_rect.height(), source_top, source_bottom, scaled_size.height(), visible_rect.y(), visible_rect.height()));
+
+    // Each band of rows scales the source rows it needs on its own, so the source rows at the borders of the bands get
+    // scaled more than once.
+    static constexpr int minimum_rows_per_band = 16;
+
+    int const row_count = visible_rect.height();
+    auto const source_pixel_count = static_cast<size_t>(columns.source_end - columns.source_begin) * (rows.source_end - rows.source_begin);
+    return try_for_each_band_of_lines(row_count, lines_per_band(row_count, source_pixel_count, minimum_rows_per_band), [&](int first_row, int end_row) {
+        return resample_rows(destination, source, columns, rows, first_row, end_row);
+    });
+}
+
+}
@@ -0,0 +1,35 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Error.h>
+#include <LibGfx/Forward.h>
+#include <LibGfx/Rect.h>
+#include <LibGfx/Size.h>
+
+namespace Gfx {
+
+// Filters that weigh in every source pixel a destination pixel covers, so that they don't alias when scaling down by a
+// lot. They are listed from the softest to the sharpest.
+enum class ResamplingFilter {
+    // Averages the source pixels that each destination pixel covers.
+    Box,
+    // The triangle filter, which is bilinear interpolation when scaling up.
+    Bilinear,
+    // The Catmull-Rom spline, a cubic convolution with a = -0.5.
+    Bicubic,
+    // A sinc windowed to three lobes. It can ring a little next to hard edges.
+    Lanczos3,
+};
+
+// Scales the `source_rect` part of `source` to `scaled_size`, and writes the `visible_rect` part of the result to the
+// top left of `destination`. Everything is in physical pixels. Rows are scaled first and columns second, in
+// premultiplied alpha, with weights that are computed once for each destination row and column. The rows of big images
+// are split up between the calling thread and the LibGfx helper threads.
+ErrorOr<void> resample(Bitmap& destination, Bitmap const& source, FloatRect const& source_rect, IntSize scaled_size, IntRect const& visible_rect, ResamplingFilter);
+
+}
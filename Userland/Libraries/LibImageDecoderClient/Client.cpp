@@ -16,6 +16,11 @@ Client::Client(NonnullOwnPtr<Core::LocalSocket> socket)
 
 void Client::die()
 {
+    // Nothing is coming back for the images that were still being decoded.
+    auto pending_decodes = move(m_pending_decodes);
+    for (auto& it : pending_decodes)
+        (void)it.value->resolve({});
+
     if (on_death)
         on_death();
 }
@@ -58,4 +63,67 @@ Optional<DecodedImage> Client::decode_image(ReadonlyBytes encoded_data, Optional
     return image;
 }
 
+NonnullRefPtr<Client::DecodePromise> Client::decode_image_async(ReadonlyBytes encoded_data, Optional<DeprecatedString> mime_type)
+{
+    auto promise = DecodePromise::construct();
+
+    // The promise is always resolved from the event loop, so callers can set it up after this returns.
+    auto fail = [&] {
+        Core::deferred_invoke([promise] {
+            (void)promise->resolve({});
+        });
+        return promise;
+    };
+
+    if (encoded_data.is_empty())
+        return fail();
+
+    auto encoded_buffer_or_error = Core::AnonymousBuffer::create_with_size(encoded_data.size());
+    if (encoded_buffer_or_error.is_error()) {
+        dbgln("Could not allocate encoded buffer");
+        return fail();
+    }
+    auto encoded_buffer = encoded_buffer_or_error.release_value();
+    memcpy(encoded_buffer.data<void>(), encoded_data.data(), encoded_data.size());
+
+    auto request_id = m_next_request_id++;
+    if (post_message(Messages::ImageDecoderServer::StartDecodingImage { request_id, move(encoded_buffer), move(mime_type) }).is_error()) {
+        dbgln("ImageDecoder died heroically");
+        return fail();
+    }
+
+    m_pending_decodes.set(request_id, promise);
+    return promise;
+}
+
+void Client::did_decode_image(i32 request_id, bool is_animated, u32 loop_count, Vector<Gfx::ShareableBitmap> const& bitmaps, Vector<u32> const& durations)
+{
+    DecodedImage image;
+    image.is_animated = is_animated;
+    image.loop_count = loop_count;
+    image.frames.resize(bitmaps.size());
+    for (size_t i = 0; i < image.frames.size(); ++i) {
+        auto& frame = image.frames[i];
+        frame.bitmap = bitmaps[i].bitmap();
+        frame.duration = durations[i];
+    }
+    resolve_pending_decode(request_id, move(image));
+}
+
+void Client::did_fail_to_decode_image(i32 request_id)
+{
+    resolve_pending_decode(request_id, {});
+}
+
+void Client::resolve_pending_decode(i32 request_id, Optional<DecodedImage> image)
+{
+    auto promise = m_pending_decodes.take(request_id);
+    if (!promise.has_value()) {
+        dbgln("ImageDecoder sent a result for an unknown request {}", request_id);
+        return;
+    }
+    if (auto result = promise.value()->resolve(move(image)); result.is_error())
+        dbgln("Failed to handle decoded image: {}", result.error());
+}
+
 }
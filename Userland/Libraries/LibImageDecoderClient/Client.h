@@ -9,6 +9,7 @@
 #include <AK/HashMap.h>
 #include <ImageDecoder/ImageDecoderClientEndpoint.h>
 #include <ImageDecoder/ImageDecoderServerEndpoint.h>
+#include <LibCore/Promise.h>
 #include <LibIPC/ConnectionToServer.h>
 
 namespace ImageDecoderClient {
@@ -32,12 +33,26 @@ class Client final
 public:
     Optional<DecodedImage> decode_image(ReadonlyBytes, Optional<DeprecatedString> mime_type = {});
 
+    using DecodePromise = Core::Promise<Optional<DecodedImage>>;
+
+    // Starts decoding an image without waiting for it, so several images can be decoded at once. The promise resolves
+    // to an empty value if the image couldn't be decoded.
+    NonnullRefPtr<DecodePromise> decode_image_async(ReadonlyBytes, Optional<DeprecatedString> mime_type = {});
+
     Function<void()> on_death;
 
 private:
     Client(NonnullOwnPtr<Core::LocalSocket>);
 
     virtual void die() override;
+
+    virtual void did_decode_image(i32 request_id, bool is_animated, u32 loop_count, Vector<Gfx::ShareableBitmap> const& bitmaps, Vector<u32> const& durations) override;
+    virtual void did_fail_to_decode_image(i32 request_id) override;
+
+    void resolve_pending_decode(i32 request_id, Optional<DecodedImage>);
+
+    HashMap<i32, NonnullRefPtr<DecodePromise>> m_pending_decodes;
+    i32 m_next_request_id { 0 };
 };
 
 }
@@ -64,4 +64,38 @@ void BasicBlock::grow(size_t additional_size)
     VERIFY(m_buffer_size <= m_buffer_capacity);
 }
 
+void BasicBlock::append_copy_of(Instruction const& instruction)
+{
+    VERIFY(can_grow(instruction.length()));
+
+    // NOTE: NewBigInt is the only instruction that isn't trivially copyable.
+    if (instruction.type() == Instruction::Type::NewBigInt)
+        new (next_slot()) Op::NewBigInt(static_cast<Op::NewBigInt const&>(instruction));
+    else
+        memcpy(next_slot(), &instruction, instruction.length());
+    grow(instruction.length());
+}
+
+void BasicBlock::swap_instruction_stream(BasicBlock& other)
+{
+    swap(m_buffer, other.m_buffer);
+    swap(m_buffer_capacity, other.m_buffer_capacity);
+    swap(m_buffer_size, other.m_buffer_size);
+
+    // The terminator points into the instruction stream, and the passes may have replaced it with a different one.
+    update_terminator();
+    other.update_terminator();
+}
+
+void BasicBlock::update_terminator()
+{
+    m_terminator = nullptr;
+    for (InstructionStreamIterator it(instruction_stream()); !it.at_end(); ++it) {
+        if ((*it).is_terminator()) {
+            m_terminator = &*it;
+            return;
+        }
+    }
+}
+
 }
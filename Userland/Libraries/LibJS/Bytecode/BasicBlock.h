@@ -35,6 +35,11 @@ public:
     bool can_grow(size_t additional_size) const { return m_buffer_size + additional_size <= m_buffer_capacity; }
     void grow(size_t additional_size);
 
+    // Used by optimization passes that rebuild a block's instructions while keeping the block itself
+    // (and thus all labels pointing to it) intact.
+    void append_copy_of(Instruction const&);
+    void swap_instruction_stream(BasicBlock& other);
+
     void terminate(Badge<Generator>, Instruction const* terminator) { m_terminator = terminator; }
     bool is_terminated() const { return m_terminator != nullptr; }
     Instruction const* terminator() const { return m_terminator; }
@@ -44,6 +49,8 @@ public:
 private:
     BasicBlock(DeprecatedString name, size_t size);
 
+    void update_terminator();
+
     u8* m_buffer { nullptr };
     Instruction const* m_terminator { nullptr };
     size_t m_buffer_capacity { 0 };
@@ -4,7 +4,10 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <LibJS/Bytecode/BasicBlock.h>
 #include <LibJS/Bytecode/Executable.h>
+#include <LibJS/Bytecode/Instruction.h>
+#include <LibJS/JIT/Compiler.h>
 
 namespace JS::Bytecode {
 
@@ -23,4 +26,23 @@ void Executable::dump() const
     }
 }
 
+size_t Executable::instruction_count() const
+{
+    size_t count = 0;
+    for (auto& block : basic_blocks) {
+        for (InstructionStreamIterator it { block->instruction_stream() }; !it.at_end(); ++it)
+            ++count;
+    }
+    return count;
+}
+
+JIT::NativeExecutable const* Executable::get_or_create_native_executable() const
+{
+    if (!did_try_jitting) {
+        did_try_jitting = true;
+        native_executable = JIT::Compiler::compile(*this);
+    }
+    return native_executable;
+}
+
 }
@@ -11,6 +11,7 @@
 #include <LibJS/Bytecode/BasicBlock.h>
 #include <LibJS/Bytecode/IdentifierTable.h>
 #include <LibJS/Bytecode/StringTable.h>
+#include <LibJS/JIT/NativeExecutable.h>
 
 namespace JS::Bytecode {
 
@@ -26,6 +27,13 @@ struct Executable {
     DeprecatedFlyString const& get_identifier(IdentifierTableIndex index) const { return identifier_table->get(index); }
 
     void dump() const;
+    size_t instruction_count() const;
+
+    // NOTE: These are mutable because we JIT lazily, the first time a (const) executable is run.
+    mutable OwnPtr<JIT::NativeExecutable> native_executable;
+    mutable bool did_try_jitting { false };
+
+    JIT::NativeExecutable const* get_or_create_native_executable() const;
 };
 
 }
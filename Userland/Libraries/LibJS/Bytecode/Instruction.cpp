@@ -25,4 +25,169 @@ void Instruction::destroy(Instruction& instruction)
 #undef __BYTECODE_OP
 }
 
+void Instruction::for_each_register_read(Function<void(Register)> const& callback) const
+{
+    using enum Type;
+    switch (type()) {
+    case Load:
+        callback(static_cast<Op::Load const&>(*this).src());
+        return;
+    case NewArray: {
+        auto const& new_array = static_cast<Op::NewArray const&>(*this);
+        if (new_array.element_count() == 0)
+            return;
+        for (auto index = new_array.start().index(); index <= new_array.end().index(); ++index)
+            callback(Register { index });
+        return;
+    }
+    case LoadImmediate:
+    case NewString:
+    case NewObject:
+    case NewRegExp:
+    case NewBigInt:
+    case NewFunction:
+    case GetVariable:
+    case TypeofVariable:
+    case ResolveThisBinding:
+    case GetNewTarget:
+    case CreateEnvironment:
+    case CreateVariable:
+    case LeaveEnvironment:
+    case PushDeclarativeEnvironment:
+    case EnterUnwindContext:
+    case LeaveUnwindContext:
+    case Jump:
+        return;
+#define __BYTECODE_OP(op, ...)                             \
+    case op:                                               \
+        callback(static_cast<Op::op const&>(*this).lhs()); \
+        break;
+        JS_ENUMERATE_COMMON_BINARY_OPS(__BYTECODE_OP)
+#undef __BYTECODE_OP
+    case CopyObjectExcludingProperties: {
+        auto const& copy = static_cast<Op::CopyObjectExcludingProperties const&>(*this);
+        callback(copy.from_object());
+        for (auto excluded_name : copy.excluded_names())
+            callback(excluded_name);
+        break;
+    }
+    case Append:
+        callback(static_cast<Op::Append const&>(*this).lhs());
+        break;
+    case ConcatString:
+        callback(static_cast<Op::ConcatString const&>(*this).lhs());
+        break;
+    case PutById:
+        callback(static_cast<Op::PutById const&>(*this).base());
+        break;
+    case GetByValue:
+        callback(static_cast<Op::GetByValue const&>(*this).base());
+        break;
+    case PutByValue:
+        callback(static_cast<Op::PutByValue const&>(*this).base());
+        callback(static_cast<Op::PutByValue const&>(*this).property());
+        break;
+    case DeleteByValue:
+        callback(static_cast<Op::DeleteByValue const&>(*this).base());
+        break;
+    case Call:
+        callback(static_cast<Op::Call const&>(*this).callee());
+        callback(static_cast<Op::Call const&>(*this).this_value());
+        break;
+    case BitwiseNot:
+    case ContinuePendingUnwind:
+    case Decrement:
+    case DeleteById:
+    case DeleteVariable:
+    case EnterObjectEnvironment:
+    case GetById:
+    case GetIterator:
+    case GetMethod:
+    case GetObjectPropertyIterator:
+    case Increment:
+    case IteratorClose:
+    case IteratorNext:
+    case IteratorResultDone:
+    case IteratorResultValue:
+    case IteratorToArray:
+    case JumpConditional:
+    case JumpNullish:
+    case JumpUndefined:
+    case NewClass:
+    case NewTypeError:
+    case Not:
+    case Return:
+    case ScheduleJump:
+    case SetVariable:
+    case Store:
+    case SuperCall:
+    case Throw:
+    case ThrowIfNotObject:
+    case Typeof:
+    case UnaryMinus:
+    case UnaryPlus:
+    case Yield:
+        break;
+    }
+
+    // Everything that isn't known to leave the accumulator alone is assumed to look at it.
+    callback(Register::accumulator());
+}
+
+Optional<Register> Instruction::register_written() const
+{
+    using enum Type;
+    switch (type()) {
+    case Store:
+        return static_cast<Op::Store const&>(*this).dst();
+    case ConcatString:
+        return static_cast<Op::ConcatString const&>(*this).lhs();
+#define __BYTECODE_OP(op, ...) case op:
+        JS_ENUMERATE_COMMON_BINARY_OPS(__BYTECODE_OP)
+        JS_ENUMERATE_COMMON_UNARY_OPS(__BYTECODE_OP)
+#undef __BYTECODE_OP
+    case Load:
+    case LoadImmediate:
+    case Increment:
+    case Decrement:
+    case NewString:
+    case NewObject:
+    case NewRegExp:
+    case NewBigInt:
+    case NewArray:
+    case NewFunction:
+    case GetVariable:
+    case TypeofVariable:
+    case ResolveThisBinding:
+    case GetNewTarget:
+    case GetById:
+    case GetByValue:
+        return Register::accumulator();
+    default:
+        return {};
+    }
+}
+
+bool Instruction::may_throw() const
+{
+    using enum Type;
+    switch (type()) {
+    case Load:
+    case LoadImmediate:
+    case Store:
+    case Jump:
+    case JumpConditional:
+    case JumpNullish:
+    case JumpUndefined:
+    case NewString:
+    case NewObject:
+    case NewArray:
+    case NewFunction:
+    case GetNewTarget:
+        return false;
+    default:
+        return true;
+    }
+}
+
 }
@@ -7,7 +7,10 @@
 #pragma once
 
 #include <AK/Forward.h>
+#include <AK/Function.h>
+#include <AK/Optional.h>
 #include <AK/Span.h>
+#include <LibJS/Bytecode/Register.h>
 #include <LibJS/Forward.h>
 
 #define ENUMERATE_BYTECODE_OPS(O)    \
@@ -116,6 +119,13 @@ public:
     void replace_references(Register, Register);
     static void destroy(Instruction&);
 
+    // Data flow information for the optimization passes. All of these err on the safe side:
+    // registers that might be read are reported as read, and a register is only reported as
+    // written if it is overwritten whenever the instruction completes normally.
+    void for_each_register_read(Function<void(Register)> const&) const;
+    Optional<Register> register_written() const;
+    bool may_throw() const;
+
 protected:
     explicit Instruction(Type type)
         : m_type(type)
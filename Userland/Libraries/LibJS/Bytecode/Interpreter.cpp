@@ -11,6 +11,7 @@
 #include <LibJS/Bytecode/Interpreter.h>
 #include <LibJS/Bytecode/Op.h>
 #include <LibJS/Interpreter.h>
+#include <LibJS/JIT/NativeExecutable.h>
 #include <LibJS/Runtime/GlobalEnvironment.h>
 #include <LibJS/Runtime/GlobalObject.h>
 #include <LibJS/Runtime/Realm.h>
@@ -19,6 +20,9 @@ namespace JS::Bytecode {
 
 static Interpreter* s_current;
 bool g_dump_bytecode = false;
+bool g_use_jit = false;
+bool g_optimize_bytecode = false;
+bool g_dump_instruction_counts = false;
 
 Interpreter* Interpreter::current()
 {
@@ -39,6 +43,18 @@ Interpreter::~Interpreter()
     s_current = nullptr;
 }
 
+ThrowCompletionOr<void> Interpreter::execute_instruction_from_native_code(BasicBlock const& block, Instruction const& instruction)
+{
+    auto offset = reinterpret_cast<u8 const*>(&instruction) - block.instruction_stream().data();
+    VERIFY(offset >= 0 && static_cast<size_t>(offset) < block.instruction_stream().size());
+
+    m_current_block = &block;
+    InstructionStreamIterator pc(block.instruction_stream());
+    pc.jump(offset);
+    TemporaryChange change_pc { m_pc, &pc };
+    return instruction.execute(*this);
+}
+
 Interpreter::ValueAndFrame Interpreter::run_and_return_frame(Executable const& executable, BasicBlock const* entry_point, RegisterWindow* in_frame)
 {
     dbgln_if(JS_BYTECODE_DEBUG, "Bytecode::Interpreter will run unit {:p}", &executable);
@@ -71,6 +87,10 @@ Interpreter::ValueAndFrame Interpreter::run_and_return_frame(Executable const& e
 
     registers().resize(executable.number_of_registers);
 
+    JIT::NativeExecutable const* native_executable = nullptr;
+    if (g_use_jit)
+        native_executable = executable.get_or_create_native_executable();
+
     for (;;) {
         Bytecode::InstructionStreamIterator pc(m_current_block->instruction_stream());
         TemporaryChange temp_change { m_pc, &pc };
@@ -79,17 +99,18 @@ Interpreter::ValueAndFrame Interpreter::run_and_return_frame(Executable const& e
         bool will_jump = false;
         bool will_return = false;
         bool will_yield = false;
-        while (!pc.at_end()) {
-            auto& instruction = *pc;
-            auto ran_or_error = instruction.execute(*this);
+        bool ran_off_end_of_block = false;
+
+        // Returns true if the instruction caused us to leave the current block.
+        auto handle_instruction_result = [&](Instruction const& instruction, ThrowCompletionOr<void>& ran_or_error) {
             if (ran_or_error.is_error()) {
                 auto exception_value = *ran_or_error.throw_completion().value();
                 m_saved_exception = make_handle(exception_value);
                 if (unwind_contexts().is_empty())
-                    break;
+                    return true;
                 auto& unwind_context = unwind_contexts().last();
                 if (unwind_context.executable != m_current_executable)
-                    break;
+                    return true;
                 if (unwind_context.handler) {
                     m_current_block = unwind_context.handler;
                     unwind_context.handler = nullptr;
@@ -97,12 +118,12 @@ Interpreter::ValueAndFrame Interpreter::run_and_return_frame(Executable const& e
                     accumulator() = exception_value;
                     m_saved_exception = {};
                     will_jump = true;
-                    break;
+                    return true;
                 }
                 if (unwind_context.finalizer) {
                     m_current_block = unwind_context.finalizer;
                     will_jump = true;
-                    break;
+                    return true;
                 }
                 // An unwind context with no handler or finalizer? We have nowhere to jump, and continuing on will make us crash on the next `Call` to a non-native function if there's an exception! So let's crash here instead.
                 // If you run into this, you probably forgot to remove the current unwind_context somewhere.
@@ -111,7 +132,7 @@ Interpreter::ValueAndFrame Interpreter::run_and_return_frame(Executable const& e
             if (m_pending_jump.has_value()) {
                 m_current_block = m_pending_jump.release_value();
                 will_jump = true;
-                break;
+                return true;
             }
             if (!m_return_value.is_empty()) {
                 will_return = true;
@@ -121,9 +142,29 @@ Interpreter::ValueAndFrame Interpreter::run_and_return_frame(Executable const& e
                 //       generators as well, so we need to check if it will actually
                 //       continue or is a `return` in disguise
                 will_yield = instruction.type() == Instruction::Type::Yield && static_cast<Op::Yield const&>(instruction).continuation().has_value();
-                break;
+                return true;
+            }
+            return false;
+        };
+
+        if (native_executable) {
+            // NOTE: Native code only comes back to us when an instruction needs our attention, or when it runs off the end of a block.
+            auto exit_state = native_executable->run(*this, *m_current_block, registers().data());
+            if (exit_state.instruction) {
+                auto left_block = handle_instruction_result(*exit_state.instruction, exit_state.result);
+                VERIFY(left_block);
+            } else {
+                ran_off_end_of_block = true;
             }
-            ++pc;
+        } else {
+            while (!pc.at_end()) {
+                auto& instruction = *pc;
+                auto ran_or_error = instruction.execute(*this);
+                if (handle_instruction_result(instruction, ran_or_error))
+                    break;
+                ++pc;
+            }
+            ran_off_end_of_block = pc.at_end();
         }
 
         if (will_jump)
@@ -140,7 +181,7 @@ Interpreter::ValueAndFrame Interpreter::run_and_return_frame(Executable const& e
             }
         }
 
-        if (pc.at_end())
+        if (ran_off_end_of_block)
             break;
 
         if (!m_saved_exception.is_null())
@@ -272,6 +313,10 @@ Bytecode::PassManager& Interpreter::optimization_pipeline(Interpreter::Optimizat
         pm->add<Passes::GenerateCFG>();
         pm->add<Passes::PlaceBlocks>();
         pm->add<Passes::EliminateLoads>();
+        pm->add<Passes::FoldConstants>();
+        pm->add<Passes::PropagateCopies>();
+        pm->add<Passes::GenerateCFG>();
+        pm->add<Passes::EliminateDeadStores>();
     } else {
         VERIFY_NOT_REACHED();
     }
@@ -71,6 +71,8 @@ public:
         m_saved_exception = {};
     }
 
+    bool has_pending_control_flow() const { return m_pending_jump.has_value() || !m_return_value.is_empty(); }
+
     void enter_unwind_context(Optional<Label> handler_target, Optional<Label> finalizer_target);
     void leave_unwind_context();
     ThrowCompletionOr<void> continue_pending_unwind(Label const& resume_label);
@@ -83,6 +85,10 @@ public:
         return DeprecatedString::formatted("{}:{:2}:{:4x}", m_current_executable->name, m_current_block->name(), pc());
     }
 
+    // Native code jumps between blocks on its own, so it reports where it is before handing an instruction
+    // back to us. This keeps current_block(), pc() and debug_position() accurate while the instruction runs.
+    ThrowCompletionOr<void> execute_instruction_from_native_code(BasicBlock const&, Instruction const&);
+
     enum class OptimizationLevel {
         None,
         Optimize,
@@ -123,5 +129,8 @@ private:
 };
 
 extern bool g_dump_bytecode;
+extern bool g_use_jit;
+// Run the optimization pipeline on every executable, not just the top-level script.
+extern bool g_optimize_bytecode;
 
 }
@@ -19,6 +19,7 @@
 #include <LibJS/Runtime/FunctionEnvironment.h>
 #include <LibJS/Runtime/GlobalEnvironment.h>
 #include <LibJS/Runtime/GlobalObject.h>
+#include <LibJS/Runtime/IndexedProperties.h>
 #include <LibJS/Runtime/Iterator.h>
 #include <LibJS/Runtime/IteratorOperations.h>
 #include <LibJS/Runtime/NativeFunction.h>
@@ -369,35 +370,37 @@ ThrowCompletionOr<void> ConcatString::execute_impl(Bytecode::Interpreter& interp
     return {};
 }
 
-ThrowCompletionOr<void> GetVariable::execute_impl(Bytecode::Interpreter& interpreter) const
+// Resolves a binding, using (and updating) the environment coordinate cached in the instruction.
+// This way only the first execution of an instruction has to look the binding up by name.
+static ThrowCompletionOr<Reference> resolve_binding_with_cache(VM& vm, DeprecatedFlyString const& name, Environment* environment, Optional<EnvironmentCoordinate>& cached_environment_coordinate)
 {
-    auto& vm = interpreter.vm();
-
-    auto get_reference = [&]() -> ThrowCompletionOr<Reference> {
-        auto const& string = interpreter.current_executable().get_identifier(m_identifier);
-        if (m_cached_environment_coordinate.has_value()) {
-            Environment* environment = nullptr;
-            if (m_cached_environment_coordinate->index == EnvironmentCoordinate::global_marker) {
-                environment = &interpreter.vm().current_realm()->global_environment();
-            } else {
-                environment = vm.running_execution_context().lexical_environment;
-                for (size_t i = 0; i < m_cached_environment_coordinate->hops; ++i)
-                    environment = environment->outer_environment();
-                VERIFY(environment);
-                VERIFY(environment->is_declarative_environment());
-            }
-            if (!environment->is_permanently_screwed_by_eval()) {
-                return Reference { *environment, string, vm.in_strict_mode(), m_cached_environment_coordinate };
-            }
-            m_cached_environment_coordinate = {};
+    if (cached_environment_coordinate.has_value()) {
+        Environment* target = nullptr;
+        if (cached_environment_coordinate->index == EnvironmentCoordinate::global_marker) {
+            target = &vm.current_realm()->global_environment();
+        } else {
+            target = environment;
+            for (size_t i = 0; i < cached_environment_coordinate->hops; ++i)
+                target = target->outer_environment();
+            VERIFY(target);
+            VERIFY(target->is_declarative_environment());
         }
+        if (!target->is_permanently_screwed_by_eval())
+            return Reference { *target, name, vm.in_strict_mode(), cached_environment_coordinate };
+        cached_environment_coordinate = {};
+    }
 
-        auto reference = TRY(vm.resolve_binding(string));
-        if (reference.environment_coordinate().has_value())
-            m_cached_environment_coordinate = reference.environment_coordinate();
-        return reference;
-    };
-    auto reference = TRY(get_reference());
+    auto reference = TRY(vm.resolve_binding(name, environment));
+    if (reference.environment_coordinate().has_value())
+        cached_environment_coordinate = reference.environment_coordinate();
+    return reference;
+}
+
+ThrowCompletionOr<void> GetVariable::execute_impl(Bytecode::Interpreter& interpreter) const
+{
+    auto& vm = interpreter.vm();
+    auto const& name = interpreter.current_executable().get_identifier(m_identifier);
+    auto reference = TRY(resolve_binding_with_cache(vm, name, vm.running_execution_context().lexical_environment, m_cached_environment_coordinate));
     interpreter.accumulator() = TRY(reference.get_value(vm));
     return {};
 }
@@ -472,7 +475,10 @@ ThrowCompletionOr<void> SetVariable::execute_impl(Bytecode::Interpreter& interpr
     auto& vm = interpreter.vm();
     auto const& name = interpreter.current_executable().get_identifier(m_identifier);
     auto environment = m_mode == EnvironmentMode::Lexical ? vm.running_execution_context().lexical_environment : vm.running_execution_context().variable_environment;
-    auto reference = TRY(vm.resolve_binding(name, environment));
+    // NOTE: Only plain assignments go through the cache, as initialization is done by name.
+    auto reference = m_initialization_mode == InitializationMode::Set
+        ? TRY(resolve_binding_with_cache(vm, name, environment, m_cached_environment_coordinate))
+        : TRY(vm.resolve_binding(name, environment));
     switch (m_initialization_mode) {
     case InitializationMode::Initialize:
         TRY(reference.initialize_referenced_binding(vm, interpreter.accumulator()));
@@ -851,9 +857,33 @@ void Yield::replace_references_impl(BasicBlock const& from, BasicBlock const& to
         m_continuation_label = Label { to };
 }
 
+// Returns the element storage of the given base if it's an object whose integer-indexed properties can be accessed
+// without going through its internal methods, and the given property is a number that's a valid array index.
+static SimpleIndexedPropertyStorage* simple_storage_for_fast_indexed_access(Value base, Value property, u32& index)
+{
+    if (!base.is_object() || !property.is_number())
+        return nullptr;
+    auto number = property.as_double();
+    if (number < 0 || number >= NumericLimits<u32>::max() || trunc(number) != number)
+        return nullptr;
+    auto& object = base.as_object();
+    if (object.may_interfere_with_indexed_property_access())
+        return nullptr;
+    index = static_cast<u32>(number);
+    return object.indexed_properties().simple_storage();
+}
+
 ThrowCompletionOr<void> GetByValue::execute_impl(Bytecode::Interpreter& interpreter) const
 {
     auto& vm = interpreter.vm();
+
+    // Fast path: Reading an element that's stored directly on the object.
+    u32 index = 0;
+    if (auto* storage = simple_storage_for_fast_indexed_access(interpreter.reg(m_base), interpreter.accumulator(), index); storage && storage->has_index(index)) {
+        interpreter.accumulator() = storage->element_at(index);
+        return {};
+    }
+
     auto object = TRY(interpreter.reg(m_base).to_object(vm));
 
     auto property_key = TRY(interpreter.accumulator().to_property_key(vm));
@@ -865,6 +895,17 @@ ThrowCompletionOr<void> GetByValue::execute_impl(Bytecode::Interpreter& interpre
 ThrowCompletionOr<void> PutByValue::execute_impl(Bytecode::Interpreter& interpreter) const
 {
     auto& vm = interpreter.vm();
+
+    // Fast path: Overwriting an element that's stored directly on the object. Since simple storage only holds
+    // writable data properties, this can't run into setters or fail.
+    if (m_kind == PropertyKind::KeyValue) {
+        u32 index = 0;
+        if (auto* storage = simple_storage_for_fast_indexed_access(interpreter.reg(m_base), interpreter.reg(m_property), index); storage && storage->has_index(index)) {
+            storage->put(index, interpreter.accumulator());
+            return {};
+        }
+    }
+
     auto object = TRY(interpreter.reg(m_base).to_object(vm));
 
     auto property_key = TRY(interpreter.reg(m_property).to_property_key(vm));
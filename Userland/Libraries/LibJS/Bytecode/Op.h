@@ -40,6 +40,8 @@ public:
             m_src = to;
     }
 
+    Register src() const { return m_src; }
+
 private:
     Register m_src;
 };
@@ -57,6 +59,8 @@ public:
     void replace_references_impl(BasicBlock const&, BasicBlock const&) { }
     void replace_references_impl(Register, Register) { }
 
+    Value value() const { return m_value; }
+
 private:
     Value m_value;
 };
@@ -124,6 +128,8 @@ private:
                 m_lhs_reg = to;                                                        \
         }                                                                              \
                                                                                        \
+        Register lhs() const { return m_lhs_reg; }                                     \
+                                                                                       \
     private:                                                                           \
         Register m_lhs_reg;                                                            \
     };
@@ -255,6 +261,9 @@ public:
 
     size_t length_impl() const { return sizeof(*this) + sizeof(Register) * m_excluded_names_count; }
 
+    Register from_object() const { return m_from_object; }
+    ReadonlySpan<Register> excluded_names() const { return { m_excluded_names, m_excluded_names_count }; }
+
 private:
     Register m_from_object;
     size_t m_excluded_names_count { 0 };
@@ -342,6 +351,8 @@ public:
     // Note: This should never do anything, the lhs should always be an array, that is currently being constructed
     void replace_references_impl(Register from, Register) { VERIFY(from != m_lhs); }
 
+    Register lhs() const { return m_lhs; }
+
 private:
     Register m_lhs;
     bool m_is_spread = false;
@@ -374,6 +385,8 @@ public:
     // Note: lhs should always be a string in construction, so this should never do anything
     void replace_references_impl(Register from, Register) { VERIFY(from != m_lhs); }
 
+    Register lhs() const { return m_lhs; }
+
 private:
     Register m_lhs;
 };
@@ -462,6 +475,8 @@ private:
     IdentifierTableIndex m_identifier;
     EnvironmentMode m_mode;
     InitializationMode m_initialization_mode { InitializationMode::Set };
+
+    Optional<EnvironmentCoordinate> mutable m_cached_environment_coordinate;
 };
 
 class GetVariable final : public Instruction {
@@ -548,6 +563,8 @@ public:
             m_base = to;
     }
 
+    Register base() const { return m_base; }
+
 private:
     Register m_base;
     IdentifierTableIndex m_property;
@@ -588,6 +605,8 @@ public:
             m_base = to;
     }
 
+    Register base() const { return m_base; }
+
 private:
     Register m_base;
 };
@@ -611,6 +630,9 @@ public:
             m_base = to;
     }
 
+    Register base() const { return m_base; }
+    Register property() const { return m_property; }
+
 private:
     Register m_base;
     Register m_property;
@@ -634,6 +656,8 @@ public:
             m_base = to;
     }
 
+    Register base() const { return m_base; }
+
 private:
     Register m_base;
 };
@@ -732,6 +756,9 @@ public:
 
     Completion throw_type_error_for_callee(Bytecode::Interpreter&, StringView callee_type) const;
 
+    Register callee() const { return m_callee; }
+    Register this_value() const { return m_this_value; }
+
 private:
     Register m_callee;
     Register m_this_value;
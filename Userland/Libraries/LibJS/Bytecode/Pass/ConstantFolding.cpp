@@ -0,0 +1,275 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/HashMap.h>
+#include <LibJS/Bytecode/Op.h>
+#include <LibJS/Bytecode/PassManager.h>
+#include <LibJS/Runtime/Value.h>
+#include <math.h>
+
+namespace JS::Bytecode::Passes {
+
+// We only track values that can be operated on without a VM: numbers, booleans, undefined and null.
+static bool is_foldable(Value value)
+{
+    return !value.is_empty() && !value.is_cell();
+}
+
+// Numbers that ToInt32() would leave untouched.
+static Optional<i32> as_int32(Value value)
+{
+    if (!value.is_number())
+        return {};
+    auto number = value.as_double();
+    if (number < NumericLimits<i32>::min() || number > NumericLimits<i32>::max() || trunc(number) != number)
+        return {};
+    return static_cast<i32>(number);
+}
+
+static Optional<Value> fold_binary_operation(Instruction::Type type, Value lhs, Value rhs)
+{
+    using enum Instruction::Type;
+
+    if (auto left_int32 = as_int32(lhs), right_int32 = as_int32(rhs); left_int32.has_value() && right_int32.has_value()) {
+        auto left = *left_int32;
+        auto right = *right_int32;
+        auto shift_count = static_cast<u32>(right) & 0x1f;
+        switch (type) {
+        case BitwiseAnd:
+            return Value(left & right);
+        case BitwiseOr:
+            return Value(left | right);
+        case BitwiseXor:
+            return Value(left ^ right);
+        case LeftShift:
+            return Value(static_cast<i32>(static_cast<u32>(left) << shift_count));
+        case RightShift:
+            return Value(left >> shift_count);
+        case UnsignedRightShift:
+            return Value(static_cast<double>(static_cast<u32>(left) >> shift_count));
+        default:
+            break;
+        }
+    }
+
+    if (lhs.is_number() && rhs.is_number()) {
+        auto left = lhs.as_double();
+        auto right = rhs.as_double();
+        switch (type) {
+        case Add:
+            return Value(left + right);
+        case Sub:
+            return Value(left - right);
+        case Mul:
+            return Value(left * right);
+        case Div:
+            return Value(left / right);
+        case Mod:
+            return Value(fmod(left, right));
+        case LessThan:
+            return Value(left < right);
+        case LessThanEquals:
+            return Value(left <= right);
+        case GreaterThan:
+            return Value(left > right);
+        case GreaterThanEquals:
+            return Value(left >= right);
+        case LooselyEquals:
+        case StrictlyEquals:
+            return Value(left == right);
+        case LooselyInequals:
+        case StrictlyInequals:
+            return Value(!(left == right));
+        default:
+            return {};
+        }
+    }
+
+    switch (type) {
+    case StrictlyEquals:
+        return Value(is_strictly_equal(lhs, rhs));
+    case StrictlyInequals:
+        return Value(!is_strictly_equal(lhs, rhs));
+    case LooselyEquals:
+    case LooselyInequals: {
+        // Anything else would need type coercion.
+        bool are_equal;
+        if (lhs.is_nullish() && rhs.is_nullish())
+            are_equal = true;
+        else if (lhs.is_boolean() && rhs.is_boolean())
+            are_equal = lhs.as_bool() == rhs.as_bool();
+        else
+            return {};
+        return Value(type == LooselyEquals ? are_equal : !are_equal);
+    }
+    default:
+        return {};
+    }
+}
+
+static Optional<Value> fold_unary_operation(Instruction::Type type, Value value)
+{
+    using enum Instruction::Type;
+
+    switch (type) {
+    case Not:
+        return Value(!value.to_boolean());
+    case BitwiseNot:
+        if (auto int32 = as_int32(value); int32.has_value())
+            return Value(~*int32);
+        return {};
+    case UnaryPlus:
+        if (value.is_number())
+            return value;
+        return {};
+    case UnaryMinus:
+        if (value.is_number())
+            return Value(-value.as_double());
+        return {};
+    case Increment:
+        if (value.is_number())
+            return Value(value.as_double() + 1);
+        return {};
+    case Decrement:
+        if (value.is_number())
+            return Value(value.as_double() - 1);
+        return {};
+    default:
+        return {};
+    }
+}
+
+static Optional<Label> folded_jump_target(Op::Jump const& jump, Value condition)
+{
+    bool take_true_branch = false;
+    switch (jump.type()) {
+    case Instruction::Type::JumpConditional:
+        take_true_branch = condition.to_boolean();
+        break;
+    case Instruction::Type::JumpNullish:
+        take_true_branch = condition.is_nullish();
+        break;
+    case Instruction::Type::JumpUndefined:
+        take_true_branch = condition.is_undefined();
+        break;
+    default:
+        VERIFY_NOT_REACHED();
+    }
+    return take_true_branch ? jump.true_target() : jump.false_target();
+}
+
+// Tracks the values of the accumulator and registers through a single block, and replaces
+// operations on known values with their result.
+static void fold_constants(BasicBlock& block)
+{
+    // NOTE: Folding an operation into a LoadImmediate can at most double its size.
+    auto new_block = BasicBlock::create(block.name(), block.size() * 2);
+    HashMap<u32, Value> register_values;
+    Optional<Value> accumulator_value;
+    bool changed = false;
+
+    auto emit_load_immediate = [&](Value value) {
+        new (new_block->next_slot()) Op::LoadImmediate(value);
+        new_block->grow(sizeof(Op::LoadImmediate));
+        accumulator_value = value;
+        changed = true;
+    };
+
+    for (InstructionStreamIterator it { block.instruction_stream() }; !it.at_end(); ++it) {
+        auto const& instruction = *it;
+
+        using enum Instruction::Type;
+        switch (instruction.type()) {
+        case LoadImmediate: {
+            auto value = static_cast<Op::LoadImmediate const&>(instruction).value();
+            new_block->append_copy_of(instruction);
+            if (is_foldable(value))
+                accumulator_value = value;
+            else
+                accumulator_value.clear();
+            continue;
+        }
+        case Load: {
+            auto src = static_cast<Op::Load const&>(instruction).src();
+            if (auto value = register_values.get(src.index()); value.has_value()) {
+                emit_load_immediate(*value);
+                continue;
+            }
+            new_block->append_copy_of(instruction);
+            accumulator_value.clear();
+            continue;
+        }
+        case Store: {
+            auto dst = static_cast<Op::Store const&>(instruction).dst();
+            new_block->append_copy_of(instruction);
+            if (accumulator_value.has_value())
+                register_values.set(dst.index(), *accumulator_value);
+            else
+                register_values.remove(dst.index());
+            continue;
+        }
+#define __BYTECODE_OP(op, ...)                                                                           \
+    case op: {                                                                                           \
+        auto lhs = register_values.get(static_cast<Op::op const&>(instruction).lhs().index());           \
+        if (lhs.has_value() && accumulator_value.has_value()) {                                          \
+            if (auto result = fold_binary_operation(op, *lhs, *accumulator_value); result.has_value()) { \
+                emit_load_immediate(*result);                                                            \
+                continue;                                                                                \
+            }                                                                                            \
+        }                                                                                                \
+        break;                                                                                           \
+    }
+            JS_ENUMERATE_COMMON_BINARY_OPS(__BYTECODE_OP)
+#undef __BYTECODE_OP
+        case Not:
+        case BitwiseNot:
+        case UnaryPlus:
+        case UnaryMinus:
+        case Increment:
+        case Decrement:
+            if (accumulator_value.has_value()) {
+                if (auto result = fold_unary_operation(instruction.type(), *accumulator_value); result.has_value()) {
+                    emit_load_immediate(*result);
+                    continue;
+                }
+            }
+            break;
+        case JumpConditional:
+        case JumpNullish:
+        case JumpUndefined:
+            if (accumulator_value.has_value()) {
+                auto target = folded_jump_target(static_cast<Op::Jump const&>(instruction), *accumulator_value);
+                new (new_block->next_slot()) Op::Jump(target);
+                new_block->grow(sizeof(Op::Jump));
+                changed = true;
+                continue;
+            }
+            break;
+        default:
+            break;
+        }
+
+        new_block->append_copy_of(instruction);
+        accumulator_value.clear();
+        if (auto written = instruction.register_written(); written.has_value() && *written != Register::accumulator())
+            register_values.remove(written->index());
+    }
+
+    if (changed)
+        block.swap_instruction_stream(*new_block);
+}
+
+void FoldConstants::perform(PassPipelineExecutable& executable)
+{
+    started();
+
+    for (auto& block : executable.executable.basic_blocks)
+        fold_constants(*block);
+
+    finished();
+}
+
+}
@@ -0,0 +1,106 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/GenericShorthands.h>
+#include <AK/HashMap.h>
+#include <LibJS/Bytecode/Op.h>
+#include <LibJS/Bytecode/PassManager.h>
+#include <string.h>
+
+namespace JS::Bytecode::Passes {
+
+// Within a block, keeps track of which registers hold the same value as another register (or as the
+// accumulator), rewrites reads to use the original register, and drops moves that don't change anything.
+// This leaves the copies themselves unused, so that EliminateDeadStores can clean them up.
+static void propagate_copies(BasicBlock& block)
+{
+    auto new_block = BasicBlock::create(block.name(), block.size());
+    // Maps a register to the register it was copied from.
+    HashMap<u32, Register> copies;
+    // The register whose value is currently in the accumulator, if any.
+    Optional<Register> accumulator_source;
+    bool changed = false;
+
+    auto original_of = [&](Register reg) {
+        return copies.get(reg.index()).value_or(reg);
+    };
+
+    auto invalidate = [&](Register reg) {
+        copies.remove(reg.index());
+        copies.remove_all_matching([&](auto, auto source) { return source == reg; });
+        if (accumulator_source == reg)
+            accumulator_source.clear();
+    };
+
+    for (InstructionStreamIterator it { block.instruction_stream() }; !it.at_end(); ++it) {
+        auto const& instruction = *it;
+
+        using enum Instruction::Type;
+        switch (instruction.type()) {
+        case Load: {
+            auto src = original_of(static_cast<Op::Load const&>(instruction).src());
+            if (accumulator_source == src) {
+                changed = true;
+                continue;
+            }
+            if (src != static_cast<Op::Load const&>(instruction).src())
+                changed = true;
+            new (new_block->next_slot()) Op::Load(src);
+            new_block->grow(sizeof(Op::Load));
+            accumulator_source = src;
+            continue;
+        }
+        case Store: {
+            auto dst = static_cast<Op::Store const&>(instruction).dst();
+            if (accumulator_source.has_value() && original_of(dst) == *accumulator_source) {
+                // The register already holds this value.
+                changed = true;
+                continue;
+            }
+            new_block->append_copy_of(instruction);
+            invalidate(dst);
+            if (accumulator_source.has_value())
+                copies.set(dst.index(), *accumulator_source);
+            else
+                accumulator_source = dst;
+            continue;
+        }
+        default:
+            break;
+        }
+
+        auto& new_instruction = *reinterpret_cast<Instruction*>(new_block->next_slot());
+        new_block->append_copy_of(instruction);
+
+        // NOTE: These refuse to have their registers replaced, as they write to them or treat them as a range.
+        //       NewBigInt has no register operands, and isn't a plain byte copy of the original.
+        if (!copies.is_empty() && !first_is_one_of(instruction.type(), NewArray, Append, ConcatString, NewBigInt)) {
+            for (auto& [reg, source] : copies)
+                new_instruction.replace_references(Register { reg }, source);
+            if (memcmp(&new_instruction, &instruction, instruction.length()) != 0)
+                changed = true;
+        }
+
+        if (auto written = instruction.register_written(); written.has_value() && *written != Register::accumulator())
+            invalidate(*written);
+        accumulator_source.clear();
+    }
+
+    if (changed)
+        block.swap_instruction_stream(*new_block);
+}
+
+void PropagateCopies::perform(PassPipelineExecutable& executable)
+{
+    started();
+
+    for (auto& block : executable.executable.basic_blocks)
+        propagate_copies(*block);
+
+    finished();
+}
+
+}
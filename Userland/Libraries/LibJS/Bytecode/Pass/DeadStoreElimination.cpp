@@ -0,0 +1,257 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/GenericShorthands.h>
+#include <AK/HashMap.h>
+#include <AK/HashTable.h>
+#include <LibJS/Bytecode/Op.h>
+#include <LibJS/Bytecode/PassManager.h>
+
+namespace JS::Bytecode::Passes {
+
+namespace {
+
+class RegisterSet {
+public:
+    explicit RegisterSet(size_t register_count)
+    {
+        m_words.resize(ceil_div(register_count, bits_per_word));
+    }
+
+    bool contains(Register reg) const { return m_words[reg.index() / bits_per_word] & (1ull << (reg.index() % bits_per_word)); }
+    void set(Register reg) { m_words[reg.index() / bits_per_word] |= 1ull << (reg.index() % bits_per_word); }
+    void clear(Register reg) { m_words[reg.index() / bits_per_word] &= ~(1ull << (reg.index() % bits_per_word)); }
+
+    void set_all()
+    {
+        for (auto& word : m_words)
+            word = NumericLimits<u64>::max();
+    }
+
+    // Returns whether any new register was added.
+    bool merge(RegisterSet const& other)
+    {
+        bool changed = false;
+        for (size_t i = 0; i < m_words.size(); ++i) {
+            auto merged = m_words[i] | other.m_words[i];
+            changed |= merged != m_words[i];
+            m_words[i] = merged;
+        }
+        return changed;
+    }
+
+private:
+    static constexpr size_t bits_per_word = 64;
+    Vector<u64> m_words;
+};
+
+struct BlockInfo {
+    BlockInfo(BasicBlock& block, size_t register_count)
+        : block(&block)
+        , live_in(register_count)
+        , live_out(register_count)
+        , live_on_unwind(register_count)
+    {
+    }
+
+    BasicBlock* block { nullptr };
+    Vector<Instruction const*> instructions;
+    Vector<size_t> successors;
+    // Handlers and finalizers we may end up in if one of our instructions throws.
+    Vector<size_t> unwind_successors;
+    // Control may leave the executable at the end of this block, which makes the accumulator observable.
+    bool may_exit { false };
+    // Control may continue somewhere the CFG doesn't tell us about (e.g. a scheduled jump out of a finalizer).
+    bool has_unknown_successors { false };
+    bool is_known_to_cfg { false };
+    RegisterSet live_in;
+    RegisterSet live_out;
+    RegisterSet live_on_unwind;
+};
+
+}
+
+// Instructions whose only effect is writing the register returned by register_written().
+static bool has_no_side_effects(Instruction const& instruction)
+{
+    using enum Instruction::Type;
+    return first_is_one_of(instruction.type(), Load, LoadImmediate, Store, NewString, NewObject);
+}
+
+static void update_liveness(Instruction const& instruction, RegisterSet& live, RegisterSet const& live_on_unwind)
+{
+    if (auto written = instruction.register_written(); written.has_value())
+        live.clear(*written);
+    instruction.for_each_register_read([&](Register reg) { live.set(reg); });
+    if (instruction.may_throw())
+        live.merge(live_on_unwind);
+}
+
+void EliminateDeadStores::perform(PassPipelineExecutable& executable)
+{
+    started();
+
+    VERIFY(executable.cfg.has_value());
+    VERIFY(executable.inverted_cfg.has_value());
+
+    auto& basic_blocks = executable.executable.basic_blocks;
+    auto register_count = executable.executable.number_of_registers;
+
+    HashMap<BasicBlock const*, size_t> block_indices;
+    HashTable<BasicBlock const*> unwind_targets;
+    Vector<BlockInfo> blocks;
+    blocks.ensure_capacity(basic_blocks.size());
+
+    for (auto& block : basic_blocks) {
+        block_indices.set(block.ptr(), blocks.size());
+        BlockInfo info { *block, register_count };
+        for (InstructionStreamIterator it { block->instruction_stream() }; !it.at_end(); ++it) {
+            auto const& instruction = *it;
+            info.instructions.append(&instruction);
+            if (instruction.type() == Instruction::Type::EnterUnwindContext) {
+                auto const& enter_unwind_context = static_cast<Op::EnterUnwindContext const&>(instruction);
+                if (enter_unwind_context.handler_target().has_value())
+                    unwind_targets.set(&enter_unwind_context.handler_target()->block());
+                if (enter_unwind_context.finalizer_target().has_value())
+                    unwind_targets.set(&enter_unwind_context.finalizer_target()->block());
+            }
+        }
+        blocks.append(move(info));
+    }
+
+    for (auto& info : blocks) {
+        auto add_successor = [&](BasicBlock const& successor) {
+            auto index = block_indices.get(&successor);
+            if (!index.has_value()) {
+                info.has_unknown_successors = true;
+                return;
+            }
+            if (info.successors.contains_slow(*index))
+                return;
+            info.successors.append(*index);
+            if (unwind_targets.contains(&successor))
+                info.unwind_successors.append(*index);
+        };
+
+        info.is_known_to_cfg = info.block == basic_blocks.first().ptr()
+            || executable.cfg->contains(info.block)
+            || executable.inverted_cfg->contains(info.block);
+        if (!info.is_known_to_cfg) {
+            // We don't know where exceptions thrown in here end up, so leave this block alone.
+            info.has_unknown_successors = true;
+            continue;
+        }
+
+        if (auto cfg_successors = executable.cfg->get(info.block); cfg_successors.has_value()) {
+            for (auto const* successor : *cfg_successors)
+                add_successor(*successor);
+        }
+
+        auto const* terminator = info.instructions.is_empty() ? nullptr : info.instructions.last();
+        if (!terminator || !terminator->is_terminator()) {
+            info.may_exit = true;
+            continue;
+        }
+
+        using enum Instruction::Type;
+        switch (terminator->type()) {
+        case Jump:
+        case JumpConditional:
+        case JumpNullish:
+        case JumpUndefined: {
+            auto const& jump = static_cast<Op::Jump const&>(*terminator);
+            if (jump.true_target().has_value())
+                add_successor(jump.true_target()->block());
+            if (jump.false_target().has_value())
+                add_successor(jump.false_target()->block());
+            break;
+        }
+        case EnterUnwindContext: {
+            auto const& enter_unwind_context = static_cast<Op::EnterUnwindContext const&>(*terminator);
+            add_successor(enter_unwind_context.entry_point().block());
+            if (enter_unwind_context.handler_target().has_value())
+                add_successor(enter_unwind_context.handler_target()->block());
+            if (enter_unwind_context.finalizer_target().has_value())
+                add_successor(enter_unwind_context.finalizer_target()->block());
+            break;
+        }
+        case Yield: {
+            auto const& yield = static_cast<Op::Yield const&>(*terminator);
+            if (yield.continuation().has_value())
+                add_successor(yield.continuation()->block());
+            info.may_exit = true;
+            break;
+        }
+        case Return:
+        case Throw:
+            info.may_exit = true;
+            break;
+        default:
+            // ContinuePendingUnwind and ScheduleJump may end up in any block the finalizer was meant to return to.
+            info.has_unknown_successors = true;
+            break;
+        }
+    }
+
+    // Classic backwards liveness analysis, iterated until nothing changes anymore.
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (size_t i = blocks.size(); i > 0; --i) {
+            auto& info = blocks[i - 1];
+
+            if (info.has_unknown_successors)
+                info.live_out.set_all();
+            if (info.may_exit)
+                info.live_out.set(Register::accumulator());
+            for (auto successor : info.successors)
+                info.live_out.merge(blocks[successor].live_in);
+            for (auto successor : info.unwind_successors)
+                info.live_on_unwind.merge(blocks[successor].live_in);
+
+            auto live = info.live_out;
+            for (size_t j = info.instructions.size(); j > 0; --j)
+                update_liveness(*info.instructions[j - 1], live, info.live_on_unwind);
+
+            changed |= info.live_in.merge(live);
+        }
+    }
+
+    for (auto& info : blocks) {
+        if (!info.is_known_to_cfg)
+            continue;
+
+        Vector<bool> is_dead;
+        is_dead.resize(info.instructions.size());
+        bool found_dead_instruction = false;
+
+        auto live = info.live_out;
+        for (size_t j = info.instructions.size(); j > 0; --j) {
+            auto const& instruction = *info.instructions[j - 1];
+            auto written = instruction.register_written();
+            if (written.has_value() && !live.contains(*written) && has_no_side_effects(instruction)) {
+                is_dead[j - 1] = true;
+                found_dead_instruction = true;
+                continue;
+            }
+            update_liveness(instruction, live, info.live_on_unwind);
+        }
+
+        if (!found_dead_instruction)
+            continue;
+
+        auto new_block = BasicBlock::create(info.block->name(), info.block->size());
+        for (size_t j = 0; j < info.instructions.size(); ++j) {
+            if (!is_dead[j])
+                new_block->append_copy_of(*info.instructions[j]);
+        }
+        info.block->swap_instruction_stream(*new_block);
+    }
+
+    finished();
+}
+
+}
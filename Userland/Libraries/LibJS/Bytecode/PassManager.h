@@ -12,6 +12,8 @@
 
 namespace JS::Bytecode {
 
+extern bool g_dump_instruction_counts;
+
 struct PassPipelineExecutable {
     Executable& executable;
     Optional<HashMap<BasicBlock const*, HashTable<BasicBlock const*>>> cfg {};
@@ -53,8 +55,13 @@ public:
 
     void perform(Executable& executable)
     {
+        auto instruction_count_before = g_dump_instruction_counts ? executable.instruction_count() : 0;
+
         PassPipelineExecutable pipeline_executable { executable };
         perform(pipeline_executable);
+
+        if (g_dump_instruction_counts)
+            dbgln("{}: {} -> {} instructions", executable.name, instruction_count_before, executable.instruction_count());
     }
 
     virtual void perform(PassPipelineExecutable& executable) override
@@ -131,6 +138,34 @@ private:
     virtual void perform(PassPipelineExecutable&) override;
 };
 
+class FoldConstants : public Pass {
+public:
+    FoldConstants() = default;
+    virtual ~FoldConstants() override = default;
+
+private:
+    virtual void perform(PassPipelineExecutable&) override;
+};
+
+class PropagateCopies : public Pass {
+public:
+    PropagateCopies() = default;
+    virtual ~PropagateCopies() override = default;
+
+private:
+    virtual void perform(PassPipelineExecutable&) override;
+};
+
+// Requires an up-to-date CFG.
+class EliminateDeadStores : public Pass {
+public:
+    EliminateDeadStores() = default;
+    virtual ~EliminateDeadStores() override = default;
+
+private:
+    virtual void perform(PassPipelineExecutable&) override;
+};
+
 }
 
 }
@@ -83,6 +83,7 @@ Cell* Heap::allocate_cell(size_t size)
         ++m_allocations_since_last_gc;
     }
 
+    ++m_statistics.allocated_cells;
     auto& allocator = allocator_for_size(size);
     return allocator.allocate_cell(*this);
 }
@@ -97,9 +98,7 @@ void Heap::collect_garbage(CollectionType collection_type, bool print_report)
     perf_event(PERF_EVENT_SIGNPOST, gc_perf_string_id, global_gc_counter++);
 #endif
 
-    Core::ElapsedTimer collection_measurement_timer;
-    if (print_report)
-        collection_measurement_timer.start();
+    auto collection_measurement_timer = Core::ElapsedTimer::start_new();
 
     if (collection_type == CollectionType::CollectGarbage) {
         if (m_gc_deferrals) {
@@ -112,6 +111,9 @@ void Heap::collect_garbage(CollectionType collection_type, bool print_report)
     }
     finalize_unmarked_cells();
     sweep_dead_cells(print_report, collection_measurement_timer);
+
+    ++m_statistics.collections;
+    m_statistics.time_spent_collecting += collection_measurement_timer.elapsed_time();
 }
 
 void Heap::gather_roots(HashTable<Cell*>& roots)
@@ -0,0 +1,443 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/BitCast.h>
+#include <AK/Optional.h>
+#include <AK/Vector.h>
+
+namespace JS::JIT {
+
+// A tiny x86_64 assembler, just big enough for the bytecode JIT.
+// Memory operands are always encoded as [base + disp32] to keep things simple.
+struct Assembler {
+    Assembler(Vector<u8>& output)
+        : m_output(output)
+    {
+    }
+
+    Vector<u8>& m_output;
+
+    enum class Reg {
+        RAX = 0,
+        RCX = 1,
+        RDX = 2,
+        RBX = 3,
+        RSP = 4,
+        RBP = 5,
+        RSI = 6,
+        RDI = 7,
+        R8 = 8,
+        R9 = 9,
+        R10 = 10,
+        R11 = 11,
+        R12 = 12,
+        R13 = 13,
+        R14 = 14,
+        R15 = 15,
+    };
+
+    struct Operand {
+        enum class Type {
+            Reg,
+            Imm32,
+            Imm64,
+            Mem64BaseAndOffset,
+        };
+
+        Type type {};
+
+        Reg reg {};
+        u64 offset_or_immediate { 0 };
+
+        static Operand Register(Reg reg)
+        {
+            Operand operand;
+            operand.type = Type::Reg;
+            operand.reg = reg;
+            return operand;
+        }
+
+        static Operand Imm32(u32 imm)
+        {
+            Operand operand;
+            operand.type = Type::Imm32;
+            operand.offset_or_immediate = imm;
+            return operand;
+        }
+
+        static Operand Imm64(u64 imm)
+        {
+            Operand operand;
+            operand.type = Type::Imm64;
+            operand.offset_or_immediate = imm;
+            return operand;
+        }
+
+        static Operand Mem64BaseAndOffset(Reg base, u32 offset)
+        {
+            Operand operand;
+            operand.type = Type::Mem64BaseAndOffset;
+            operand.reg = base;
+            operand.offset_or_immediate = offset;
+            return operand;
+        }
+
+        bool is_register_or_memory() const { return type == Type::Reg || type == Type::Mem64BaseAndOffset; }
+    };
+
+    enum class Condition {
+        Overflow = 0x0,
+        Below = 0x2,
+        AboveOrEqual = 0x3,
+        EqualTo = 0x4,
+        NotEqualTo = 0x5,
+        BelowOrEqual = 0x6,
+        Above = 0x7,
+        Sign = 0x8,
+        SignedLessThan = 0xc,
+        SignedGreaterThanOrEqualTo = 0xd,
+        SignedLessThanOrEqualTo = 0xe,
+        SignedGreaterThan = 0xf,
+    };
+
+    struct Label {
+        Optional<size_t> offset_of_label_in_instruction_stream;
+        Vector<size_t> jump_slot_offsets_in_instruction_stream;
+
+        void add_jump(Assembler& assembler, size_t offset)
+        {
+            jump_slot_offsets_in_instruction_stream.append(offset);
+            if (offset_of_label_in_instruction_stream.has_value())
+                link_jump(assembler, offset);
+        }
+
+        void link(Assembler& assembler)
+        {
+            link_to(assembler, assembler.m_output.size());
+        }
+
+        void link_to(Assembler& assembler, size_t link_offset)
+        {
+            VERIFY(!offset_of_label_in_instruction_stream.has_value());
+            offset_of_label_in_instruction_stream = link_offset;
+            for (auto offset : jump_slot_offsets_in_instruction_stream)
+                link_jump(assembler, offset);
+        }
+
+    private:
+        void link_jump(Assembler& assembler, size_t offset_in_instruction_stream)
+        {
+            auto offset = offset_of_label_in_instruction_stream.value() - offset_in_instruction_stream;
+            auto jump_slot = offset_in_instruction_stream - 4;
+            assembler.m_output[jump_slot + 0] = (offset >> 0) & 0xff;
+            assembler.m_output[jump_slot + 1] = (offset >> 8) & 0xff;
+            assembler.m_output[jump_slot + 2] = (offset >> 16) & 0xff;
+            assembler.m_output[jump_slot + 3] = (offset >> 24) & 0xff;
+        }
+    };
+
+    [[nodiscard]] Label make_label()
+    {
+        return Label {};
+    }
+
+    static constexpr u8 encode_reg(Reg reg)
+    {
+        return to_underlying(reg) & 0x7;
+    }
+
+    static constexpr bool is_extended_reg(Reg reg)
+    {
+        return to_underlying(reg) >= 8;
+    }
+
+    // Emits REX (if needed), the opcode bytes, and a ModR/M (+SIB/disp32) for "reg_field, rm".
+    void emit_modrm(bool is_64bit, u8 reg_field, bool reg_field_is_extended, Operand rm, ReadonlyBytes opcode, bool force_rex = false)
+    {
+        u8 rex = 0x40;
+        if (is_64bit)
+            rex |= 0x08;
+        if (reg_field_is_extended)
+            rex |= 0x04;
+        if (is_extended_reg(rm.reg))
+            rex |= 0x01;
+        if (rex != 0x40 || force_rex)
+            emit8(rex);
+
+        for (auto byte : opcode)
+            emit8(byte);
+
+        if (rm.type == Operand::Type::Reg) {
+            emit8(0xc0 | ((reg_field & 7) << 3) | encode_reg(rm.reg));
+            return;
+        }
+
+        VERIFY(rm.type == Operand::Type::Mem64BaseAndOffset);
+        emit8(0x80 | ((reg_field & 7) << 3) | encode_reg(rm.reg));
+        // RSP and R12 as a base register require a SIB byte.
+        if (encode_reg(rm.reg) == encode_reg(Reg::RSP))
+            emit8(0x24);
+        emit32(rm.offset_or_immediate);
+    }
+
+    void emit_modrm(bool is_64bit, Reg reg, Operand rm, ReadonlyBytes opcode)
+    {
+        emit_modrm(is_64bit, encode_reg(reg), is_extended_reg(reg), rm, opcode);
+    }
+
+    void mov(Operand dst, Operand src)
+    {
+        if (dst.type == Operand::Type::Reg && src.type == Operand::Type::Imm64) {
+            // MOV r64, imm64
+            emit8(0x48 | (is_extended_reg(dst.reg) ? 1 : 0));
+            emit8(0xb8 | encode_reg(dst.reg));
+            emit64(src.offset_or_immediate);
+            return;
+        }
+
+        if (dst.is_register_or_memory() && src.type == Operand::Type::Reg) {
+            // MOV r/m64, r64
+            u8 const opcode[] = { 0x89 };
+            emit_modrm(true, src.reg, dst, opcode);
+            return;
+        }
+
+        if (dst.type == Operand::Type::Reg && src.type == Operand::Type::Mem64BaseAndOffset) {
+            // MOV r64, r/m64
+            u8 const opcode[] = { 0x8b };
+            emit_modrm(true, dst.reg, src, opcode);
+            return;
+        }
+
+        VERIFY_NOT_REACHED();
+    }
+
+    // MOV r32, r/m32 (zero-extends into the upper half of the destination)
+    void mov32(Operand dst, Operand src)
+    {
+        VERIFY(dst.type == Operand::Type::Reg && src.is_register_or_memory());
+        u8 const opcode[] = { 0x8b };
+        emit_modrm(false, dst.reg, src, opcode);
+    }
+
+    // Shifts a 64-bit register by an immediate amount.
+    void shift_right(Operand dst, u8 amount)
+    {
+        VERIFY(dst.type == Operand::Type::Reg);
+        u8 const opcode[] = { 0xc1 };
+        emit_modrm(true, 5, false, dst, opcode);
+        emit8(amount);
+    }
+
+    enum class Shift32 : u8 {
+        Left = 4,
+        LogicalRight = 5,
+        ArithmeticRight = 7,
+    };
+
+    // Shifts a 32-bit register by CL. The CPU masks the count to 5 bits, which is what JS wants.
+    void shift32_by_cl(Shift32 kind, Operand dst)
+    {
+        VERIFY(dst.type == Operand::Type::Reg);
+        u8 const opcode[] = { 0xd3 };
+        emit_modrm(false, to_underlying(kind), false, dst, opcode);
+    }
+
+    enum class Arithmetic32 : u8 {
+        Add = 0x01,
+        Or = 0x09,
+        And = 0x21,
+        Sub = 0x29,
+        Xor = 0x31,
+        Compare = 0x39,
+    };
+
+    // op r/m32, r32
+    void arithmetic32(Arithmetic32 kind, Operand dst, Operand src)
+    {
+        VERIFY(dst.is_register_or_memory() && src.type == Operand::Type::Reg);
+        u8 const opcode[] = { to_underlying(kind) };
+        emit_modrm(false, src.reg, dst, opcode);
+    }
+
+    // IMUL r32, r/m32
+    void imul32(Operand dst, Operand src)
+    {
+        VERIFY(dst.type == Operand::Type::Reg && src.is_register_or_memory());
+        u8 const opcode[] = { 0x0f, 0xaf };
+        emit_modrm(false, dst.reg, src, opcode);
+    }
+
+    // ADD r/m32, imm32 / SUB r/m32, imm32
+    void add32(Operand dst, Operand src)
+    {
+        VERIFY(dst.type == Operand::Type::Reg && src.type == Operand::Type::Imm32);
+        u8 const opcode[] = { 0x81 };
+        emit_modrm(false, 0, false, dst, opcode);
+        emit32(src.offset_or_immediate);
+    }
+
+    void sub32(Operand dst, Operand src)
+    {
+        VERIFY(dst.type == Operand::Type::Reg && src.type == Operand::Type::Imm32);
+        u8 const opcode[] = { 0x81 };
+        emit_modrm(false, 5, false, dst, opcode);
+        emit32(src.offset_or_immediate);
+    }
+
+    void cmp(Operand lhs, Operand rhs)
+    {
+        if (lhs.type == Operand::Type::Reg && rhs.type == Operand::Type::Imm32) {
+            // CMP r/m32, imm32 (callers only compare against small tags)
+            u8 const opcode[] = { 0x81 };
+            emit_modrm(false, 7, false, lhs, opcode);
+            emit32(rhs.offset_or_immediate);
+            return;
+        }
+
+        if (lhs.is_register_or_memory() && rhs.type == Operand::Type::Reg) {
+            // CMP r/m64, r64
+            u8 const opcode[] = { 0x39 };
+            emit_modrm(true, rhs.reg, lhs, opcode);
+            return;
+        }
+
+        VERIFY_NOT_REACHED();
+    }
+
+    // TEST r/m32, r32
+    void test32(Operand lhs, Operand rhs)
+    {
+        VERIFY(lhs.is_register_or_memory() && rhs.type == Operand::Type::Reg);
+        u8 const opcode[] = { 0x85 };
+        emit_modrm(false, rhs.reg, lhs, opcode);
+    }
+
+    // NOT r/m32
+    void not32(Operand dst)
+    {
+        VERIFY(dst.type == Operand::Type::Reg);
+        u8 const opcode[] = { 0xf7 };
+        emit_modrm(false, 2, false, dst, opcode);
+    }
+
+    // AND r/m32, imm32
+    void and32(Operand dst, Operand src)
+    {
+        VERIFY(dst.type == Operand::Type::Reg && src.type == Operand::Type::Imm32);
+        u8 const opcode[] = { 0x81 };
+        emit_modrm(false, 4, false, dst, opcode);
+        emit32(src.offset_or_immediate);
+    }
+
+    // OR r/m64, r64
+    void bitwise_or(Operand dst, Operand src)
+    {
+        VERIFY(dst.is_register_or_memory() && src.type == Operand::Type::Reg);
+        u8 const opcode[] = { 0x09 };
+        emit_modrm(true, src.reg, dst, opcode);
+    }
+
+    // SETcc r/m8 followed by MOVZX r32, r/m8
+    void set_and_zero_extend(Condition condition, Reg dst)
+    {
+        u8 const setcc[] = { 0x0f, static_cast<u8>(0x90 | to_underlying(condition)) };
+        // A REX prefix is needed to address the low byte of RSI/RDI and friends.
+        emit_modrm(false, 0, false, Operand::Register(dst), setcc, true);
+        u8 const movzx[] = { 0x0f, 0xb6 };
+        emit_modrm(false, encode_reg(dst), is_extended_reg(dst), Operand::Register(dst), movzx, true);
+    }
+
+    void jump(Label& label)
+    {
+        // JMP rel32
+        emit8(0xe9);
+        emit32(0xdeadbeef);
+        label.add_jump(*this, m_output.size());
+    }
+
+    void jump(Operand target)
+    {
+        VERIFY(target.type == Operand::Type::Reg);
+        // JMP r/m64
+        u8 const opcode[] = { 0xff };
+        emit_modrm(false, 4, false, target, opcode);
+    }
+
+    void jump_if(Condition condition, Label& label)
+    {
+        // Jcc rel32
+        emit8(0x0f);
+        emit8(0x80 | to_underlying(condition));
+        emit32(0xdeadbeef);
+        label.add_jump(*this, m_output.size());
+    }
+
+    void jump_if_equal(Operand lhs, Operand rhs, Label& label)
+    {
+        cmp(lhs, rhs);
+        jump_if(Condition::EqualTo, label);
+    }
+
+    void jump_if_not_equal(Operand lhs, Operand rhs, Label& label)
+    {
+        cmp(lhs, rhs);
+        jump_if(Condition::NotEqualTo, label);
+    }
+
+    void push(Operand op)
+    {
+        VERIFY(op.type == Operand::Type::Reg);
+        if (is_extended_reg(op.reg))
+            emit8(0x41);
+        emit8(0x50 | encode_reg(op.reg));
+    }
+
+    void pop(Operand op)
+    {
+        VERIFY(op.type == Operand::Type::Reg);
+        if (is_extended_reg(op.reg))
+            emit8(0x41);
+        emit8(0x58 | encode_reg(op.reg));
+    }
+
+    void native_call(void* callee)
+    {
+        // NOTE: RAX is clobbered by the call anyway, so it's safe to use as the call target.
+        mov(Operand::Register(Reg::RAX), Operand::Imm64(bit_cast<u64>(callee)));
+        // CALL RAX
+        emit8(0xff);
+        emit8(0xd0);
+    }
+
+    void ret()
+    {
+        emit8(0xc3);
+    }
+
+    void emit8(u8 value)
+    {
+        m_output.append(value);
+    }
+
+    void emit32(u32 value)
+    {
+        m_output.append((value >> 0) & 0xff);
+        m_output.append((value >> 8) & 0xff);
+        m_output.append((value >> 16) & 0xff);
+        m_output.append((value >> 24) & 0xff);
+    }
+
+    void emit64(u64 value)
+    {
+        for (size_t i = 0; i < 8; ++i)
+            m_output.append((value >> (i * 8)) & 0xff);
+    }
+};
+
+}
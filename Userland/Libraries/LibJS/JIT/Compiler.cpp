@@ -0,0 +1,465 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Debug.h>
+#include <LibJS/Bytecode/Instruction.h>
+#include <LibJS/Bytecode/Interpreter.h>
+#include <LibJS/JIT/Compiler.h>
+#include <LibJS/Runtime/Value.h>
+
+namespace JS::JIT {
+
+#if ARCH(X86_64)
+
+void Compiler::load_vm_register(Assembler::Reg dst, Bytecode::Register src)
+{
+    m_assembler.mov(
+        Assembler::Operand::Register(dst),
+        Assembler::Operand::Mem64BaseAndOffset(REGISTER_ARRAY_BASE, src.index() * sizeof(Value)));
+}
+
+void Compiler::store_vm_register(Bytecode::Register dst, Assembler::Reg src)
+{
+    m_assembler.mov(
+        Assembler::Operand::Mem64BaseAndOffset(REGISTER_ARRAY_BASE, dst.index() * sizeof(Value)),
+        Assembler::Operand::Register(src));
+}
+
+void Compiler::branch_if_not_int32(Assembler::Reg reg, Assembler::Label& label)
+{
+    // NOTE: GPR2 is used as a scratch register here, so don't pass it in.
+    VERIFY(reg != GPR2);
+    m_assembler.mov(Assembler::Operand::Register(GPR2), Assembler::Operand::Register(reg));
+    m_assembler.shift_right(Assembler::Operand::Register(GPR2), TAG_SHIFT);
+    m_assembler.jump_if_not_equal(
+        Assembler::Operand::Register(GPR2),
+        Assembler::Operand::Imm32(INT32_TAG),
+        label);
+}
+
+void Compiler::store_accumulator_as_int32(Assembler::Reg reg)
+{
+    // NOTE: Every 32-bit operation leaves the upper half of the register cleared, so we can simply OR in the tag.
+    VERIFY(reg != GPR2);
+    m_assembler.mov(Assembler::Operand::Register(GPR2), Assembler::Operand::Imm64(SHIFTED_INT32_TAG));
+    m_assembler.bitwise_or(Assembler::Operand::Register(reg), Assembler::Operand::Register(GPR2));
+    store_vm_register(Bytecode::Register::accumulator(), reg);
+}
+
+void Compiler::store_accumulator_as_boolean(Assembler::Reg reg)
+{
+    VERIFY(reg != GPR2);
+    m_assembler.mov(Assembler::Operand::Register(GPR2), Assembler::Operand::Imm64(BOOLEAN_TAG << TAG_SHIFT));
+    m_assembler.bitwise_or(Assembler::Operand::Register(reg), Assembler::Operand::Register(GPR2));
+    store_vm_register(Bytecode::Register::accumulator(), reg);
+}
+
+void Compiler::jump_to_exit_if_nonzero(Assembler::Reg reg)
+{
+    m_assembler.test32(Assembler::Operand::Register(reg), Assembler::Operand::Register(reg));
+    m_assembler.jump_if(Assembler::Condition::NotEqualTo, m_exit_label);
+}
+
+Assembler::Label* Compiler::label_for(Bytecode::Label const& label)
+{
+    auto index = m_block_indices.get(&label.block());
+    if (!index.has_value())
+        return nullptr;
+    return &m_block_labels[index.value()];
+}
+
+static u64 cxx_execute(Bytecode::Interpreter& interpreter, Bytecode::Instruction const& instruction, NativeExecutable::ExitState& exit_state, Bytecode::BasicBlock const& block)
+{
+    auto result = interpreter.execute_instruction_from_native_code(block, instruction);
+    if (!result.is_error() && !interpreter.has_pending_control_flow())
+        return 0;
+    exit_state.instruction = &instruction;
+    exit_state.result = move(result);
+    return 1;
+}
+
+void Compiler::compile_generic(Bytecode::Instruction const& instruction)
+{
+    m_assembler.mov(Assembler::Operand::Register(ARG0), Assembler::Operand::Register(INTERPRETER));
+    m_assembler.mov(Assembler::Operand::Register(ARG1), Assembler::Operand::Imm64(bit_cast<u64>(&instruction)));
+    m_assembler.mov(Assembler::Operand::Register(ARG2), Assembler::Operand::Register(EXIT_STATE));
+    m_assembler.mov(Assembler::Operand::Register(ARG3), Assembler::Operand::Imm64(bit_cast<u64>(m_current_block)));
+    m_assembler.native_call(bit_cast<void*>(&cxx_execute));
+    jump_to_exit_if_nonzero(GPR0);
+}
+
+void Compiler::compile_load(Bytecode::Op::Load const& op)
+{
+    load_vm_register(GPR0, op.src());
+    store_vm_register(Bytecode::Register::accumulator(), GPR0);
+}
+
+void Compiler::compile_load_immediate(Bytecode::Op::LoadImmediate const& op)
+{
+    m_assembler.mov(Assembler::Operand::Register(GPR0), Assembler::Operand::Imm64(op.value().encoded()));
+    store_vm_register(Bytecode::Register::accumulator(), GPR0);
+}
+
+void Compiler::compile_store(Bytecode::Op::Store const& op)
+{
+    load_vm_register(GPR0, Bytecode::Register::accumulator());
+    store_vm_register(op.dst(), GPR0);
+}
+
+bool Compiler::compile_jump(Bytecode::Op::Jump const& op)
+{
+    if (!op.true_target().has_value())
+        return false;
+    auto* target = label_for(*op.true_target());
+    if (!target)
+        return false;
+    m_assembler.jump(*target);
+    return true;
+}
+
+static u64 cxx_to_boolean(Value const& value)
+{
+    return value.to_boolean();
+}
+
+bool Compiler::compile_jump_conditional(Bytecode::Op::JumpConditional const& op)
+{
+    if (!op.true_target().has_value() || !op.false_target().has_value())
+        return false;
+    auto* true_target = label_for(*op.true_target());
+    auto* false_target = label_for(*op.false_target());
+    if (!true_target || !false_target)
+        return false;
+
+    load_vm_register(GPR0, Bytecode::Register::accumulator());
+
+    // Booleans and Int32s are truthy if their payload is non-zero.
+    auto not_boolean = m_assembler.make_label();
+    auto slow_case = m_assembler.make_label();
+    m_assembler.mov(Assembler::Operand::Register(GPR1), Assembler::Operand::Register(GPR0));
+    m_assembler.shift_right(Assembler::Operand::Register(GPR1), TAG_SHIFT);
+    m_assembler.jump_if_not_equal(Assembler::Operand::Register(GPR1), Assembler::Operand::Imm32(BOOLEAN_TAG), not_boolean);
+    m_assembler.test32(Assembler::Operand::Register(GPR0), Assembler::Operand::Register(GPR0));
+    m_assembler.jump_if(Assembler::Condition::NotEqualTo, *true_target);
+    m_assembler.jump(*false_target);
+
+    not_boolean.link(m_assembler);
+    m_assembler.jump_if_not_equal(Assembler::Operand::Register(GPR1), Assembler::Operand::Imm32(INT32_TAG), slow_case);
+    m_assembler.test32(Assembler::Operand::Register(GPR0), Assembler::Operand::Register(GPR0));
+    m_assembler.jump_if(Assembler::Condition::NotEqualTo, *true_target);
+    m_assembler.jump(*false_target);
+
+    // Everything else goes through Value::to_boolean(), which can't throw.
+    slow_case.link(m_assembler);
+    static_assert(Bytecode::Register::accumulator_index == 0);
+    m_assembler.mov(Assembler::Operand::Register(ARG0), Assembler::Operand::Register(REGISTER_ARRAY_BASE));
+    m_assembler.native_call(bit_cast<void*>(&cxx_to_boolean));
+    m_assembler.test32(Assembler::Operand::Register(GPR0), Assembler::Operand::Register(GPR0));
+    m_assembler.jump_if(Assembler::Condition::NotEqualTo, *true_target);
+    m_assembler.jump(*false_target);
+    return true;
+}
+
+bool Compiler::compile_jump_nullish(Bytecode::Op::JumpNullish const& op)
+{
+    if (!op.true_target().has_value() || !op.false_target().has_value())
+        return false;
+    auto* true_target = label_for(*op.true_target());
+    auto* false_target = label_for(*op.false_target());
+    if (!true_target || !false_target)
+        return false;
+
+    load_vm_register(GPR0, Bytecode::Register::accumulator());
+    m_assembler.shift_right(Assembler::Operand::Register(GPR0), TAG_SHIFT);
+    m_assembler.and32(Assembler::Operand::Register(GPR0), Assembler::Operand::Imm32(IS_NULLISH_EXTRACT_PATTERN));
+    m_assembler.jump_if_equal(Assembler::Operand::Register(GPR0), Assembler::Operand::Imm32(IS_NULLISH_PATTERN), *true_target);
+    m_assembler.jump(*false_target);
+    return true;
+}
+
+bool Compiler::compile_jump_undefined(Bytecode::Op::JumpUndefined const& op)
+{
+    if (!op.true_target().has_value() || !op.false_target().has_value())
+        return false;
+    auto* true_target = label_for(*op.true_target());
+    auto* false_target = label_for(*op.false_target());
+    if (!true_target || !false_target)
+        return false;
+
+    load_vm_register(GPR0, Bytecode::Register::accumulator());
+    m_assembler.shift_right(Assembler::Operand::Register(GPR0), TAG_SHIFT);
+    m_assembler.jump_if_equal(Assembler::Operand::Register(GPR0), Assembler::Operand::Imm32(UNDEFINED_TAG), *true_target);
+    m_assembler.jump(*false_target);
+    return true;
+}
+
+void Compiler::compile_increment(Bytecode::Op::Increment const& op)
+{
+    auto slow_case = m_assembler.make_label();
+    auto end = m_assembler.make_label();
+
+    load_vm_register(GPR0, Bytecode::Register::accumulator());
+    branch_if_not_int32(GPR0, slow_case);
+    m_assembler.add32(Assembler::Operand::Register(GPR0), Assembler::Operand::Imm32(1));
+    m_assembler.jump_if(Assembler::Condition::Overflow, slow_case);
+    store_accumulator_as_int32(GPR0);
+    m_assembler.jump(end);
+
+    slow_case.link(m_assembler);
+    compile_generic(op);
+    end.link(m_assembler);
+}
+
+void Compiler::compile_decrement(Bytecode::Op::Decrement const& op)
+{
+    auto slow_case = m_assembler.make_label();
+    auto end = m_assembler.make_label();
+
+    load_vm_register(GPR0, Bytecode::Register::accumulator());
+    branch_if_not_int32(GPR0, slow_case);
+    m_assembler.sub32(Assembler::Operand::Register(GPR0), Assembler::Operand::Imm32(1));
+    m_assembler.jump_if(Assembler::Condition::Overflow, slow_case);
+    store_accumulator_as_int32(GPR0);
+    m_assembler.jump(end);
+
+    slow_case.link(m_assembler);
+    compile_generic(op);
+    end.link(m_assembler);
+}
+
+void Compiler::compile_bitwise_not(Bytecode::Op::BitwiseNot const& op)
+{
+    auto slow_case = m_assembler.make_label();
+    auto end = m_assembler.make_label();
+
+    load_vm_register(GPR0, Bytecode::Register::accumulator());
+    branch_if_not_int32(GPR0, slow_case);
+    m_assembler.not32(Assembler::Operand::Register(GPR0));
+    store_accumulator_as_int32(GPR0);
+    m_assembler.jump(end);
+
+    slow_case.link(m_assembler);
+    compile_generic(op);
+    end.link(m_assembler);
+}
+
+void Compiler::compile_int32_binary_operation(Bytecode::Instruction const& instruction, Bytecode::Register lhs, Int32BinaryOperation operation)
+{
+    auto slow_case = m_assembler.make_label();
+    auto end = m_assembler.make_label();
+
+    // GPR0 = lhs, GPR1 = rhs (the accumulator)
+    load_vm_register(GPR0, lhs);
+    load_vm_register(GPR1, Bytecode::Register::accumulator());
+    branch_if_not_int32(GPR0, slow_case);
+    branch_if_not_int32(GPR1, slow_case);
+
+    auto lhs_operand = Assembler::Operand::Register(GPR0);
+    auto rhs_operand = Assembler::Operand::Register(GPR1);
+
+    switch (operation) {
+    case Int32BinaryOperation::Add:
+        m_assembler.arithmetic32(Assembler::Arithmetic32::Add, lhs_operand, rhs_operand);
+        m_assembler.jump_if(Assembler::Condition::Overflow, slow_case);
+        break;
+    case Int32BinaryOperation::Sub:
+        m_assembler.arithmetic32(Assembler::Arithmetic32::Sub, lhs_operand, rhs_operand);
+        m_assembler.jump_if(Assembler::Condition::Overflow, slow_case);
+        break;
+    case Int32BinaryOperation::Mul:
+        m_assembler.imul32(lhs_operand, rhs_operand);
+        m_assembler.jump_if(Assembler::Condition::Overflow, slow_case);
+        // A zero result might have to be -0, let the slow path figure that out.
+        m_assembler.test32(lhs_operand, lhs_operand);
+        m_assembler.jump_if(Assembler::Condition::EqualTo, slow_case);
+        break;
+    case Int32BinaryOperation::BitwiseAnd:
+        m_assembler.arithmetic32(Assembler::Arithmetic32::And, lhs_operand, rhs_operand);
+        break;
+    case Int32BinaryOperation::BitwiseOr:
+        m_assembler.arithmetic32(Assembler::Arithmetic32::Or, lhs_operand, rhs_operand);
+        break;
+    case Int32BinaryOperation::BitwiseXor:
+        m_assembler.arithmetic32(Assembler::Arithmetic32::Xor, lhs_operand, rhs_operand);
+        break;
+    case Int32BinaryOperation::LeftShift:
+        m_assembler.shift32_by_cl(Assembler::Shift32::Left, lhs_operand);
+        break;
+    case Int32BinaryOperation::RightShift:
+        m_assembler.shift32_by_cl(Assembler::Shift32::ArithmeticRight, lhs_operand);
+        break;
+    case Int32BinaryOperation::UnsignedRightShift:
+        m_assembler.shift32_by_cl(Assembler::Shift32::LogicalRight, lhs_operand);
+        // Results that don't fit in an i32 have to become doubles.
+        m_assembler.test32(lhs_operand, lhs_operand);
+        m_assembler.jump_if(Assembler::Condition::Sign, slow_case);
+        break;
+    }
+
+    store_accumulator_as_int32(GPR0);
+    m_assembler.jump(end);
+
+    slow_case.link(m_assembler);
+    compile_generic(instruction);
+    end.link(m_assembler);
+}
+
+void Compiler::compile_int32_comparison(Bytecode::Instruction const& instruction, Bytecode::Register lhs, Assembler::Condition condition)
+{
+    auto slow_case = m_assembler.make_label();
+    auto end = m_assembler.make_label();
+
+    load_vm_register(GPR0, lhs);
+    load_vm_register(GPR1, Bytecode::Register::accumulator());
+    branch_if_not_int32(GPR0, slow_case);
+    branch_if_not_int32(GPR1, slow_case);
+
+    m_assembler.arithmetic32(Assembler::Arithmetic32::Compare, Assembler::Operand::Register(GPR0), Assembler::Operand::Register(GPR1));
+    m_assembler.set_and_zero_extend(condition, GPR0);
+    store_accumulator_as_boolean(GPR0);
+    m_assembler.jump(end);
+
+    slow_case.link(m_assembler);
+    compile_generic(instruction);
+    end.link(m_assembler);
+}
+
+bool Compiler::compile_instruction(Bytecode::Instruction const& instruction)
+{
+    using enum Bytecode::Instruction::Type;
+
+#    define DO_INT32_BINARY_OPERATION(OpTitleCase, operation)                                                                                           \
+    case OpTitleCase:                                                                                                                                   \
+        compile_int32_binary_operation(instruction, static_cast<Bytecode::Op::OpTitleCase const&>(instruction).lhs(), Int32BinaryOperation::operation); \
+        return true;
+
+#    define DO_INT32_COMPARISON(OpTitleCase, condition)                                                                                           \
+    case OpTitleCase:                                                                                                                             \
+        compile_int32_comparison(instruction, static_cast<Bytecode::Op::OpTitleCase const&>(instruction).lhs(), Assembler::Condition::condition); \
+        return true;
+
+    switch (instruction.type()) {
+    case Load:
+        compile_load(static_cast<Bytecode::Op::Load const&>(instruction));
+        return true;
+    case LoadImmediate:
+        compile_load_immediate(static_cast<Bytecode::Op::LoadImmediate const&>(instruction));
+        return true;
+    case Store:
+        compile_store(static_cast<Bytecode::Op::Store const&>(instruction));
+        return true;
+    case Jump:
+        return compile_jump(static_cast<Bytecode::Op::Jump const&>(instruction));
+    case JumpConditional:
+        return compile_jump_conditional(static_cast<Bytecode::Op::JumpConditional const&>(instruction));
+    case JumpNullish:
+        return compile_jump_nullish(static_cast<Bytecode::Op::JumpNullish const&>(instruction));
+    case JumpUndefined:
+        return compile_jump_undefined(static_cast<Bytecode::Op::JumpUndefined const&>(instruction));
+    case Increment:
+        compile_increment(static_cast<Bytecode::Op::Increment const&>(instruction));
+        return true;
+    case Decrement:
+        compile_decrement(static_cast<Bytecode::Op::Decrement const&>(instruction));
+        return true;
+    case BitwiseNot:
+        compile_bitwise_not(static_cast<Bytecode::Op::BitwiseNot const&>(instruction));
+        return true;
+
+        DO_INT32_BINARY_OPERATION(Add, Add)
+        DO_INT32_BINARY_OPERATION(Sub, Sub)
+        DO_INT32_BINARY_OPERATION(Mul, Mul)
+        DO_INT32_BINARY_OPERATION(BitwiseAnd, BitwiseAnd)
+        DO_INT32_BINARY_OPERATION(BitwiseOr, BitwiseOr)
+        DO_INT32_BINARY_OPERATION(BitwiseXor, BitwiseXor)
+        DO_INT32_BINARY_OPERATION(LeftShift, LeftShift)
+        DO_INT32_BINARY_OPERATION(RightShift, RightShift)
+        DO_INT32_BINARY_OPERATION(UnsignedRightShift, UnsignedRightShift)
+
+        DO_INT32_COMPARISON(LessThan, SignedLessThan)
+        DO_INT32_COMPARISON(LessThanEquals, SignedLessThanOrEqualTo)
+        DO_INT32_COMPARISON(GreaterThan, SignedGreaterThan)
+        DO_INT32_COMPARISON(GreaterThanEquals, SignedGreaterThanOrEqualTo)
+        DO_INT32_COMPARISON(StrictlyEquals, EqualTo)
+        DO_INT32_COMPARISON(StrictlyInequals, NotEqualTo)
+        DO_INT32_COMPARISON(LooselyEquals, EqualTo)
+        DO_INT32_COMPARISON(LooselyInequals, NotEqualTo)
+
+    default:
+        compile_generic(instruction);
+        return true;
+    }
+
+#    undef DO_INT32_BINARY_OPERATION
+#    undef DO_INT32_COMPARISON
+}
+
+OwnPtr<NativeExecutable> Compiler::compile(Bytecode::Executable const& bytecode_executable)
+{
+    Compiler compiler { bytecode_executable };
+    auto& assembler = compiler.m_assembler;
+
+    for (size_t i = 0; i < bytecode_executable.basic_blocks.size(); ++i) {
+        compiler.m_block_indices.set(bytecode_executable.basic_blocks[i].ptr(), i);
+        compiler.m_block_labels.append(assembler.make_label());
+    }
+
+    // The native code is entered with the SysV calling convention:
+    // void entry(Interpreter&, Value* registers, void* entry_address, NativeExecutable::ExitState&)
+    assembler.push(Assembler::Operand::Register(Assembler::Reg::RBP));
+    assembler.mov(Assembler::Operand::Register(Assembler::Reg::RBP), Assembler::Operand::Register(Assembler::Reg::RSP));
+    // NOTE: Pushing four more registers keeps the stack 16-byte aligned for the calls we make.
+    assembler.push(Assembler::Operand::Register(REGISTER_ARRAY_BASE));
+    assembler.push(Assembler::Operand::Register(INTERPRETER));
+    assembler.push(Assembler::Operand::Register(EXIT_STATE));
+    assembler.push(Assembler::Operand::Register(Assembler::Reg::R14));
+    assembler.mov(Assembler::Operand::Register(INTERPRETER), Assembler::Operand::Register(ARG0));
+    assembler.mov(Assembler::Operand::Register(REGISTER_ARRAY_BASE), Assembler::Operand::Register(ARG1));
+    assembler.mov(Assembler::Operand::Register(EXIT_STATE), Assembler::Operand::Register(ARG3));
+    assembler.jump(Assembler::Operand::Register(ARG2));
+
+    HashMap<Bytecode::BasicBlock const*, size_t> block_entry_offsets;
+
+    for (size_t i = 0; i < bytecode_executable.basic_blocks.size(); ++i) {
+        auto const& block = *bytecode_executable.basic_blocks[i];
+        compiler.m_current_block = &block;
+        block_entry_offsets.set(&block, compiler.m_output.size());
+        compiler.m_block_labels[i].link(assembler);
+
+        for (Bytecode::InstructionStreamIterator it(block.instruction_stream()); !it.at_end(); ++it) {
+            if (!compiler.compile_instruction(*it)) {
+                dbgln_if(JS_JIT_DEBUG, "JIT: Could not compile {} in {}", (*it).to_deprecated_string(bytecode_executable), bytecode_executable.name);
+                return nullptr;
+            }
+        }
+
+        // Falling off the end of a block hands control back to the interpreter, just like the bytecode loop does.
+        assembler.jump(compiler.m_exit_label);
+    }
+
+    compiler.m_exit_label.link(assembler);
+    assembler.pop(Assembler::Operand::Register(Assembler::Reg::R14));
+    assembler.pop(Assembler::Operand::Register(EXIT_STATE));
+    assembler.pop(Assembler::Operand::Register(INTERPRETER));
+    assembler.pop(Assembler::Operand::Register(REGISTER_ARRAY_BASE));
+    assembler.pop(Assembler::Operand::Register(Assembler::Reg::RBP));
+    assembler.ret();
+
+    auto native_executable = NativeExecutable::create(compiler.m_output, move(block_entry_offsets));
+    dbgln_if(JS_JIT_DEBUG, "JIT: Compiled {} ({} blocks) into {} bytes of native code", bytecode_executable.name, bytecode_executable.basic_blocks.size(), compiler.m_output.size());
+    return native_executable;
+}
+
+#else
+
+OwnPtr<NativeExecutable> Compiler::compile(Bytecode::Executable const&)
+{
+    return nullptr;
+}
+
+#endif
+
+}
@@ -0,0 +1,92 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/HashMap.h>
+#include <AK/OwnPtr.h>
+#include <LibJS/Bytecode/Executable.h>
+#include <LibJS/Bytecode/Op.h>
+#include <LibJS/JIT/Assembler.h>
+#include <LibJS/JIT/NativeExecutable.h>
+
+namespace JS::JIT {
+
+// A baseline JIT that translates each basic block of a Bytecode::Executable into x86_64 machine code.
+// Simple operations on Int32 values get inline fast paths; everything else calls back into the
+// instruction's regular execute_impl(). Whenever an instruction raises an exception, schedules a jump
+// the JIT doesn't know about, or returns, we leave native code and let the interpreter take over.
+class Compiler {
+public:
+    static OwnPtr<NativeExecutable> compile(Bytecode::Executable const&);
+
+private:
+#if ARCH(X86_64)
+    static constexpr auto GPR0 = Assembler::Reg::RAX;
+    static constexpr auto GPR1 = Assembler::Reg::RCX;
+    static constexpr auto GPR2 = Assembler::Reg::RDX;
+    static constexpr auto ARG0 = Assembler::Reg::RDI;
+    static constexpr auto ARG1 = Assembler::Reg::RSI;
+    static constexpr auto ARG2 = Assembler::Reg::RDX;
+    static constexpr auto ARG3 = Assembler::Reg::RCX;
+    static constexpr auto REGISTER_ARRAY_BASE = Assembler::Reg::RBX;
+    static constexpr auto INTERPRETER = Assembler::Reg::R12;
+    static constexpr auto EXIT_STATE = Assembler::Reg::R13;
+
+    explicit Compiler(Bytecode::Executable const& bytecode_executable)
+        : m_bytecode_executable(bytecode_executable)
+    {
+    }
+
+    bool compile_instruction(Bytecode::Instruction const&);
+
+    void compile_load(Bytecode::Op::Load const&);
+    void compile_load_immediate(Bytecode::Op::LoadImmediate const&);
+    void compile_store(Bytecode::Op::Store const&);
+    bool compile_jump(Bytecode::Op::Jump const&);
+    bool compile_jump_conditional(Bytecode::Op::JumpConditional const&);
+    bool compile_jump_nullish(Bytecode::Op::JumpNullish const&);
+    bool compile_jump_undefined(Bytecode::Op::JumpUndefined const&);
+    void compile_increment(Bytecode::Op::Increment const&);
+    void compile_decrement(Bytecode::Op::Decrement const&);
+    void compile_bitwise_not(Bytecode::Op::BitwiseNot const&);
+
+    enum class Int32BinaryOperation {
+        Add,
+        Sub,
+        Mul,
+        BitwiseAnd,
+        BitwiseOr,
+        BitwiseXor,
+        LeftShift,
+        RightShift,
+        UnsignedRightShift,
+    };
+    void compile_int32_binary_operation(Bytecode::Instruction const&, Bytecode::Register lhs, Int32BinaryOperation);
+    void compile_int32_comparison(Bytecode::Instruction const&, Bytecode::Register lhs, Assembler::Condition);
+
+    void compile_generic(Bytecode::Instruction const&);
+
+    void load_vm_register(Assembler::Reg, Bytecode::Register);
+    void store_vm_register(Bytecode::Register, Assembler::Reg);
+    void branch_if_not_int32(Assembler::Reg, Assembler::Label&);
+    void store_accumulator_as_int32(Assembler::Reg);
+    void store_accumulator_as_boolean(Assembler::Reg);
+    void jump_to_exit_if_nonzero(Assembler::Reg);
+
+    Assembler::Label* label_for(Bytecode::Label const&);
+
+    Bytecode::Executable const& m_bytecode_executable;
+    Bytecode::BasicBlock const* m_current_block { nullptr };
+    Vector<u8> m_output;
+    Assembler m_assembler { m_output };
+    Assembler::Label m_exit_label;
+    HashMap<Bytecode::BasicBlock const*, size_t> m_block_indices;
+    Vector<Assembler::Label> m_block_labels;
+#endif
+};
+
+}
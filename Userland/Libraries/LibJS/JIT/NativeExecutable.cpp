@@ -0,0 +1,58 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Debug.h>
+#include <LibJS/Bytecode/BasicBlock.h>
+#include <LibJS/JIT/NativeExecutable.h>
+#include <sys/mman.h>
+
+namespace JS::JIT {
+
+OwnPtr<NativeExecutable> NativeExecutable::create(ReadonlyBytes code, HashMap<Bytecode::BasicBlock const*, size_t> block_entry_offsets)
+{
+    auto* memory = mmap(nullptr, code.size(), PROT_READ | PROT_WRITE, MAP_ANONYMOUS | MAP_PRIVATE, -1, 0);
+    if (memory == MAP_FAILED) {
+        dbgln_if(JS_JIT_DEBUG, "JIT: Failed to allocate {} bytes for native code", code.size());
+        return nullptr;
+    }
+
+    memcpy(memory, code.data(), code.size());
+
+    // NOTE: The mapping is never writable and executable at the same time.
+    if (mprotect(memory, code.size(), PROT_READ | PROT_EXEC) < 0) {
+        dbgln_if(JS_JIT_DEBUG, "JIT: Failed to make native code executable");
+        munmap(memory, code.size());
+        return nullptr;
+    }
+
+    return adopt_own(*new NativeExecutable(memory, code.size(), move(block_entry_offsets)));
+}
+
+NativeExecutable::NativeExecutable(void* code, size_t size, HashMap<Bytecode::BasicBlock const*, size_t> block_entry_offsets)
+    : m_code(code)
+    , m_size(size)
+    , m_block_entry_offsets(move(block_entry_offsets))
+{
+}
+
+NativeExecutable::~NativeExecutable()
+{
+    munmap(m_code, m_size);
+}
+
+NativeExecutable::ExitState NativeExecutable::run(Bytecode::Interpreter& interpreter, Bytecode::BasicBlock const& entry_block, Value* registers) const
+{
+    auto entry_offset = m_block_entry_offsets.get(&entry_block);
+    VERIFY(entry_offset.has_value());
+
+    ExitState exit_state;
+    using EntryPoint = void (*)(Bytecode::Interpreter&, Value* registers, void* entry_address, ExitState&);
+    auto entry_point = bit_cast<EntryPoint>(m_code);
+    entry_point(interpreter, registers, static_cast<u8*>(m_code) + entry_offset.value(), exit_state);
+    return exit_state;
+}
+
+}
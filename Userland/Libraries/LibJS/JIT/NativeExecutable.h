@@ -0,0 +1,47 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/HashMap.h>
+#include <AK/Noncopyable.h>
+#include <AK/OwnPtr.h>
+#include <AK/Types.h>
+#include <LibJS/Bytecode/Instruction.h>
+#include <LibJS/Forward.h>
+#include <LibJS/Runtime/Completion.h>
+
+namespace JS::JIT {
+
+class NativeExecutable {
+    AK_MAKE_NONCOPYABLE(NativeExecutable);
+    AK_MAKE_NONMOVABLE(NativeExecutable);
+
+public:
+    // Filled in by the generated code whenever it hands control back to the interpreter.
+    struct ExitState {
+        // The instruction that caused us to leave native code, or null if we ran off the end of a block.
+        Bytecode::Instruction const* instruction { nullptr };
+        ThrowCompletionOr<void> result {};
+    };
+
+    static OwnPtr<NativeExecutable> create(ReadonlyBytes code, HashMap<Bytecode::BasicBlock const*, size_t> block_entry_offsets);
+    ~NativeExecutable();
+
+    // Runs native code starting at the given block until an instruction needs the interpreter's attention.
+    ExitState run(Bytecode::Interpreter&, Bytecode::BasicBlock const& entry_block, Value* registers) const;
+
+    size_t code_size() const { return m_size; }
+
+private:
+    NativeExecutable(void* code, size_t size, HashMap<Bytecode::BasicBlock const*, size_t> block_entry_offsets);
+
+    void* m_code { nullptr };
+    size_t m_size { 0 };
+    HashMap<Bytecode::BasicBlock const*, size_t> m_block_entry_offsets;
+};
+
+}
@@ -708,6 +708,8 @@ ThrowCompletionOr<Value> perform_eval(VM& vm, Value x, CallerMode strict_caller,
 
         auto executable = executable_result.release_value();
         executable->name = "eval"sv;
+        if (Bytecode::g_optimize_bytecode)
+            Bytecode::Interpreter::optimization_pipeline(Bytecode::Interpreter::OptimizationLevel::Optimize).perform(*executable);
         if (Bytecode::g_dump_bytecode)
             executable->dump();
         auto result_or_error = bytecode_interpreter->run_and_return_frame(*executable, nullptr);
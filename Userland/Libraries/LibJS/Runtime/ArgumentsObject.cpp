@@ -20,6 +20,7 @@ ThrowCompletionOr<void> ArgumentsObject::initialize(Realm& realm)
 {
     MUST_OR_THROW_OOM(Base::initialize(realm));
     set_has_parameter_map();
+    set_may_interfere_with_indexed_property_access();
     m_parameter_map = Object::create(realm, nullptr);
 
     return {};
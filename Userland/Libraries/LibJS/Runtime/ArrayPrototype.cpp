@@ -19,6 +19,7 @@
 #include <LibJS/Runtime/Error.h>
 #include <LibJS/Runtime/FunctionObject.h>
 #include <LibJS/Runtime/GlobalObject.h>
+#include <LibJS/Runtime/IndexedProperties.h>
 #include <LibJS/Runtime/Map.h>
 #include <LibJS/Runtime/ObjectPrototype.h>
 #include <LibJS/Runtime/Realm.h>
@@ -149,6 +150,85 @@ static ThrowCompletionOr<Object*> array_species_create(VM& vm, Object& original_
     return TRY(construct(vm, constructor.as_function(), Value(length))).ptr();
 }
 
+// Returns the element storage of the given object if its elements in [0, length) can be accessed directly: They are
+// all present, and reading or overwriting them can't have any observable side effects.
+static SimpleIndexedPropertyStorage* packed_elements_for_fast_access(Object& object, size_t length)
+{
+    if (object.may_interfere_with_indexed_property_access())
+        return nullptr;
+    auto* storage = object.indexed_properties().packed_storage();
+    if (!storage || storage->array_like_size() < length)
+        return nullptr;
+    return storage;
+}
+
+// Returns the element storage of the given object if elements can be appended to it directly: It must be an extensible
+// array with a writable length, and nothing on its prototype chain may have indexed properties a [[Set]] could run into.
+static SimpleIndexedPropertyStorage* simple_storage_for_fast_append(Object& object)
+{
+    if (!is<Array>(object) || !static_cast<Array&>(object).length_is_writable())
+        return nullptr;
+    if (object.may_interfere_with_indexed_property_access() || !MUST(object.is_extensible()))
+        return nullptr;
+    for (auto const* prototype = object.shape().prototype(); prototype; prototype = prototype->shape().prototype()) {
+        if (prototype->may_interfere_with_indexed_property_access() || !prototype->indexed_properties().is_empty())
+            return nullptr;
+    }
+    return object.indexed_properties().simple_storage();
+}
+
+enum class SearchDirection {
+    Forward,
+    Backward,
+};
+
+enum class SearchComparison {
+    IsStrictlyEqual,
+    SameValueZero,
+};
+
+// Searches the packed elements in [start, end) for the given value. The numeric element kinds let us compare raw numbers.
+static Optional<size_t> search_packed_elements(SimpleIndexedPropertyStorage const& storage, Value search_element, size_t start, size_t end, SearchDirection direction, SearchComparison comparison)
+{
+    auto search = [&](auto elements, auto matches) -> Optional<size_t> {
+        if (direction == SearchDirection::Forward) {
+            for (size_t i = start; i < end; ++i) {
+                if (matches(elements[i]))
+                    return i;
+            }
+        } else {
+            for (size_t i = end; i > start; --i) {
+                if (matches(elements[i - 1]))
+                    return i - 1;
+            }
+        }
+        return {};
+    };
+
+    // NOTE: Packed storage only holds numbers, so nothing else can ever match.
+    if (!search_element.is_number())
+        return {};
+    auto needle = search_element.as_double();
+
+    switch (storage.element_kind()) {
+    case SimpleIndexedPropertyStorage::ElementKind::PackedInt32:
+        // NOTE: This also rejects NaN.
+        if (needle < NumericLimits<i32>::min() || needle > NumericLimits<i32>::max() || trunc(needle) != needle)
+            return {};
+        return search(storage.int32_elements(), [needle = static_cast<i32>(needle)](i32 element) { return element == needle; });
+    case SimpleIndexedPropertyStorage::ElementKind::PackedDouble:
+        if (isnan(needle)) {
+            if (comparison == SearchComparison::IsStrictlyEqual)
+                return {};
+            return search(storage.double_elements(), [](double element) { return isnan(element); });
+        }
+        return search(storage.double_elements(), [needle](double element) { return element == needle; });
+    case SimpleIndexedPropertyStorage::ElementKind::Values:
+        break;
+    }
+    VERIFY_NOT_REACHED();
+}
+
 // 23.1.3.1 Array.prototype.at ( index ), https://tc39.es/ecma262/#sec-array.prototype.at
 JS_DEFINE_NATIVE_FUNCTION(ArrayPrototype::at)
 {
@@ -383,9 +463,23 @@ JS_DEFINE_NATIVE_FUNCTION(ArrayPrototype::fill)
     else
         to = min(relative_end, length);
 
+    // OPTIMIZATION: Packed elements can be overwritten directly.
+    if (auto* storage = packed_elements_for_fast_access(this_object, to)) {
+        for (u64 i = from; i < to; i++)
+            storage->put(i, vm.argument(0));
+        return this_object;
+    }
+
     for (u64 i = from; i < to; i++)
         TRY(this_object->set(i, vm.argument(0), Object::ShouldThrowExceptions::Yes));
 
+    // NOTE: Filling an array created with holes (e.g. `new Array(n).fill(0)`) is a common way of initializing one, so
+    //       let's give it a chance to use one of the packed element kinds again.
+    if (from == 0 && !this_object->may_interfere_with_indexed_property_access()) {
+        if (auto* storage = this_object->indexed_properties().simple_storage(); storage && storage->array_like_size() == to)
+            storage->pack_if_possible();
+    }
+
     return this_object;
 }
 
@@ -903,6 +997,11 @@ JS_DEFINE_NATIVE_FUNCTION(ArrayPrototype::includes)
             from_index = from_argument;
     }
     auto value_to_find = vm.argument(0);
+
+    // OPTIMIZATION: Packed elements can be searched directly, as reading them has no side effects.
+    if (auto const* storage = packed_elements_for_fast_access(this_object, length))
+        return Value(search_packed_elements(*storage, value_to_find, from_index, length, SearchDirection::Forward, SearchComparison::SameValueZero).has_value());
+
     for (u64 i = from_index; i < length; ++i) {
         auto element = TRY(this_object->get(i));
         if (same_value_zero(element, value_to_find))
@@ -956,6 +1055,12 @@ JS_DEFINE_NATIVE_FUNCTION(ArrayPrototype::index_of)
         k = max(length + n, 0);
     }
 
+    // OPTIMIZATION: Packed elements can be searched directly, as neither HasProperty nor Get have any side effects for them.
+    if (auto const* storage = packed_elements_for_fast_access(object, length)) {
+        auto index = search_packed_elements(*storage, search_element, k, length, SearchDirection::Forward, SearchComparison::IsStrictlyEqual);
+        return index.has_value() ? Value(*index) : Value(-1);
+    }
+
     // 10. Repeat, while k < len,
     for (; k < length; ++k) {
         auto property_key = PropertyKey { k };
@@ -1067,6 +1172,12 @@ JS_DEFINE_NATIVE_FUNCTION(ArrayPrototype::last_index_of)
         k = (double)length + n;
     }
 
+    // OPTIMIZATION: Packed elements can be searched directly, as neither HasProperty nor Get have any side effects for them.
+    if (auto const* storage = packed_elements_for_fast_access(object, length); storage && k >= 0) {
+        auto index = search_packed_elements(*storage, search_element, 0, k + 1, SearchDirection::Backward, SearchComparison::IsStrictlyEqual);
+        return index.has_value() ? Value(*index) : Value(-1);
+    }
+
     // 8. Repeat, while k ≥ 0,
     for (; k >= 0; --k) {
         auto property_key = PropertyKey { k };
@@ -1150,6 +1261,12 @@ JS_DEFINE_NATIVE_FUNCTION(ArrayPrototype::pop)
         TRY(this_object->set(vm.names.length, Value(0), Object::ShouldThrowExceptions::Yes));
         return js_undefined();
     }
+    // OPTIMIZATION: Removing the last packed element of an array can't have any side effects.
+    if (is<Array>(*this_object) && static_cast<Array&>(*this_object).length_is_writable()) {
+        if (auto* storage = packed_elements_for_fast_access(this_object, length); storage && storage->array_like_size() == length)
+            return storage->take_last().value;
+    }
+
     auto index = length - 1;
     auto element = TRY(this_object->get(index));
     TRY(this_object->delete_property_or_throw(index));
@@ -1166,6 +1283,16 @@ JS_DEFINE_NATIVE_FUNCTION(ArrayPrototype::push)
     auto new_length = length + argument_count;
     if (new_length > MAX_ARRAY_LIKE_INDEX)
         return vm.throw_completion<TypeError>(ErrorType::ArrayMaxSize);
+
+    // OPTIMIZATION: Appending to an ordinary array can't run into any setters, and its length follows the elements.
+    if (new_length <= NumericLimits<i32>::max()) {
+        if (auto* storage = simple_storage_for_fast_append(this_object); storage && storage->array_like_size() == length) {
+            for (size_t i = 0; i < argument_count; ++i)
+                storage->put(length + i, vm.argument(i));
+            return Value(new_length);
+        }
+    }
+
     for (size_t i = 0; i < argument_count; ++i)
         TRY(this_object->set(length + i, vm.argument(i), Object::ShouldThrowExceptions::Yes));
     auto new_length_value = Value(new_length);
@@ -1343,6 +1470,12 @@ JS_DEFINE_NATIVE_FUNCTION(ArrayPrototype::reverse)
     auto this_object = TRY(vm.this_value().to_object(vm));
     auto length = TRY(length_of_array_like(vm, this_object));
 
+    // OPTIMIZATION: Swapping packed elements around can't have any side effects.
+    if (auto* storage = packed_elements_for_fast_access(this_object, length); storage && storage->array_like_size() == length) {
+        storage->reverse();
+        return this_object;
+    }
+
     auto middle = length / 2;
     for (size_t lower = 0; lower < middle; ++lower) {
         auto upper = length - lower - 1;
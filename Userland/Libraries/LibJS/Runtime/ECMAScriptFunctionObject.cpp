@@ -842,7 +842,7 @@ Completion ECMAScriptFunctionObject::ordinary_call_evaluate_body()
 
                 auto bytecode_executable = executable_result.release_value();
                 bytecode_executable->name = name;
-                auto& passes = Bytecode::Interpreter::optimization_pipeline();
+                auto& passes = Bytecode::Interpreter::optimization_pipeline(Bytecode::g_optimize_bytecode ? Bytecode::Interpreter::OptimizationLevel::Optimize : Bytecode::Interpreter::OptimizationLevel::Default);
                 passes.perform(*bytecode_executable);
                 if constexpr (JS_BYTECODE_DEBUG) {
                     dbgln("Optimisation passes took {}us", passes.elapsed());
@@ -15,78 +15,198 @@ constexpr const size_t LENGTH_SETTER_GENERIC_STORAGE_THRESHOLD = 4 * MiB;
 
 SimpleIndexedPropertyStorage::SimpleIndexedPropertyStorage(Vector<Value>&& initial_values)
     : m_array_size(initial_values.size())
-    , m_packed_elements(move(initial_values))
+    , m_element_kind(ElementKind::Values)
+    , m_value_elements(move(initial_values))
 {
+    pack_if_possible();
+}
+
+SimpleIndexedPropertyStorage::ElementKind SimpleIndexedPropertyStorage::element_kind_for(Value value)
+{
+    if (value.is_int32())
+        return ElementKind::PackedInt32;
+    if (value.is_number())
+        return ElementKind::PackedDouble;
+    return ElementKind::Values;
+}
+
+void SimpleIndexedPropertyStorage::transition_to(ElementKind new_kind)
+{
+    if (new_kind <= m_element_kind)
+        return;
+
+    if (new_kind == ElementKind::PackedDouble) {
+        VERIFY(m_element_kind == ElementKind::PackedInt32);
+        m_double_elements.ensure_capacity(m_int32_elements.capacity());
+        for (auto element : m_int32_elements)
+            m_double_elements.unchecked_append(element);
+        m_int32_elements.clear();
+    } else {
+        VERIFY(new_kind == ElementKind::Values);
+        if (m_element_kind == ElementKind::PackedInt32) {
+            m_value_elements.ensure_capacity(m_int32_elements.capacity());
+            for (auto element : m_int32_elements)
+                m_value_elements.unchecked_append(Value(element));
+            m_int32_elements.clear();
+        } else {
+            m_value_elements.ensure_capacity(m_double_elements.capacity());
+            for (auto element : m_double_elements)
+                m_value_elements.unchecked_append(Value(element));
+            m_double_elements.clear();
+        }
+    }
+
+    m_element_kind = new_kind;
 }
 
 bool SimpleIndexedPropertyStorage::has_index(u32 index) const
 {
-    return index < m_array_size && !m_packed_elements[index].is_empty();
+    if (index >= m_array_size)
+        return false;
+    if (is_packed())
+        return true;
+    return !m_value_elements[index].is_empty();
 }
 
 Optional<ValueAndAttributes> SimpleIndexedPropertyStorage::get(u32 index) const
 {
     if (!has_index(index))
         return {};
-    return ValueAndAttributes { m_packed_elements[index], default_attributes };
+    return ValueAndAttributes { element_at(index), default_attributes };
 }
 
-void SimpleIndexedPropertyStorage::grow_storage_if_needed()
+template<typename T>
+static void resize_elements_vector(Vector<T>& elements, size_t new_size)
 {
-    if (m_array_size <= m_packed_elements.size())
-        return;
-
-    if (m_array_size <= m_packed_elements.capacity()) {
-        m_packed_elements.resize_and_keep_capacity(m_array_size);
-    } else {
+    if (new_size > elements.capacity()) {
         // When the array is actually full grow storage by 25% at a time.
-        m_packed_elements.resize_and_keep_capacity(m_array_size + (m_array_size / 4));
+        elements.ensure_capacity(new_size + (new_size / 4));
     }
+    elements.resize_and_keep_capacity(new_size);
+}
+
+void SimpleIndexedPropertyStorage::resize_elements(size_t new_size)
+{
+    switch (m_element_kind) {
+    case ElementKind::PackedInt32:
+        resize_elements_vector(m_int32_elements, new_size);
+        break;
+    case ElementKind::PackedDouble:
+        resize_elements_vector(m_double_elements, new_size);
+        break;
+    case ElementKind::Values:
+        resize_elements_vector(m_value_elements, new_size);
+        break;
+    }
+    m_array_size = new_size;
 }
 
 void SimpleIndexedPropertyStorage::put(u32 index, Value value, PropertyAttributes attributes)
 {
     VERIFY(attributes == default_attributes);
 
-    if (index >= m_array_size) {
-        m_array_size = index + 1;
-        grow_storage_if_needed();
+    // Anything but appending to the end leaves a hole behind, which only generic values can represent.
+    if (index > m_array_size)
+        transition_to(ElementKind::Values);
+    transition_to(element_kind_for(value));
+
+    if (index >= m_array_size)
+        resize_elements(index + 1);
+
+    if (m_element_kind == ElementKind::Values) {
+        m_value_elements[index] = value;
+        return;
     }
-    m_packed_elements[index] = value;
+    auto success = try_set_existing_element(index, value);
+    VERIFY(success);
 }
 
 void SimpleIndexedPropertyStorage::remove(u32 index)
 {
     VERIFY(index < m_array_size);
-    m_packed_elements[index] = {};
+    transition_to(ElementKind::Values);
+    m_value_elements[index] = {};
 }
 
 ValueAndAttributes SimpleIndexedPropertyStorage::take_first()
 {
+    auto first_element = element_at(0);
+    switch (m_element_kind) {
+    case ElementKind::PackedInt32:
+        m_int32_elements.remove(0);
+        break;
+    case ElementKind::PackedDouble:
+        m_double_elements.remove(0);
+        break;
+    case ElementKind::Values:
+        m_value_elements.remove(0);
+        break;
+    }
     m_array_size--;
-    return { m_packed_elements.take_first(), default_attributes };
+    return { first_element, default_attributes };
 }
 
 ValueAndAttributes SimpleIndexedPropertyStorage::take_last()
 {
-    m_array_size--;
-    auto last_element = m_packed_elements[m_array_size];
-    m_packed_elements[m_array_size] = {};
+    auto last_element = element_at(m_array_size - 1);
+    resize_elements(m_array_size - 1);
     return { last_element, default_attributes };
 }
 
 bool SimpleIndexedPropertyStorage::set_array_like_size(size_t new_size)
 {
-    m_array_size = new_size;
-    m_packed_elements.resize_and_keep_capacity(new_size);
+    // Growing the array fills it with holes.
+    if (new_size > m_array_size)
+        transition_to(ElementKind::Values);
+    resize_elements(new_size);
     return true;
 }
 
+void SimpleIndexedPropertyStorage::reverse()
+{
+    switch (m_element_kind) {
+    case ElementKind::PackedInt32:
+        m_int32_elements.reverse();
+        break;
+    case ElementKind::PackedDouble:
+        m_double_elements.reverse();
+        break;
+    case ElementKind::Values:
+        m_value_elements.reverse();
+        break;
+    }
+}
+
+void SimpleIndexedPropertyStorage::pack_if_possible()
+{
+    if (m_element_kind != ElementKind::Values)
+        return;
+
+    auto element_kind = ElementKind::PackedInt32;
+    for (auto value : m_value_elements) {
+        element_kind = max(element_kind, element_kind_for(value));
+        if (element_kind == ElementKind::Values)
+            return;
+    }
+
+    if (element_kind == ElementKind::PackedInt32) {
+        m_int32_elements.ensure_capacity(m_value_elements.capacity());
+        for (auto value : m_value_elements)
+            m_int32_elements.unchecked_append(value.as_i32());
+    } else {
+        m_double_elements.ensure_capacity(m_value_elements.capacity());
+        for (auto value : m_value_elements)
+            m_double_elements.unchecked_append(value.as_double());
+    }
+    m_value_elements.clear();
+    m_element_kind = element_kind;
+}
+
 GenericIndexedPropertyStorage::GenericIndexedPropertyStorage(SimpleIndexedPropertyStorage&& storage)
 {
     m_array_size = storage.array_like_size();
-    for (size_t i = 0; i < storage.m_packed_elements.size(); ++i) {
-        auto value = storage.m_packed_elements[i];
+    for (size_t i = 0; i < m_array_size; ++i) {
+        auto value = storage.element_at(i);
         if (!value.is_empty())
             m_sparse_elements.set(i, { value, default_attributes });
     }
@@ -265,9 +385,11 @@ size_t IndexedProperties::real_size() const
     if (!m_storage)
         return 0;
     if (m_storage->is_simple_storage()) {
-        auto& packed_elements = static_cast<SimpleIndexedPropertyStorage const&>(*m_storage).elements();
+        auto const& storage = static_cast<SimpleIndexedPropertyStorage const&>(*m_storage);
+        if (storage.is_packed())
+            return storage.array_like_size();
         size_t size = 0;
-        for (auto& element : packed_elements) {
+        for (auto& element : storage.value_elements()) {
             if (!element.is_empty())
                 ++size;
         }
@@ -282,11 +404,10 @@ Vector<u32> IndexedProperties::indices() const
         return {};
     if (m_storage->is_simple_storage()) {
         auto const& storage = static_cast<SimpleIndexedPropertyStorage const&>(*m_storage);
-        auto const& elements = storage.elements();
         Vector<u32> indices;
         indices.ensure_capacity(storage.array_like_size());
-        for (size_t i = 0; i < elements.size(); ++i) {
-            if (!elements.at(i).is_empty())
+        for (size_t i = 0; i < storage.array_like_size(); ++i) {
+            if (storage.has_index(i))
                 indices.unchecked_append(i);
         }
         return indices;
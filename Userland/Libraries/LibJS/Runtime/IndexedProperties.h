@@ -42,6 +42,18 @@ public:
 
 class SimpleIndexedPropertyStorage final : public IndexedPropertyStorage {
 public:
+    // Arrays that only ever hold numbers keep them unboxed, and only fall back to storing
+    // full Values once something else (or a hole) is put into them. Transitions only go
+    // downwards in this list.
+    enum class ElementKind : u8 {
+        // Every element is an int32, and there are no holes.
+        PackedInt32,
+        // Every element is a number, and there are no holes.
+        PackedDouble,
+        // Elements are arbitrary values, holes are stored as empty values.
+        Values,
+    };
+
     SimpleIndexedPropertyStorage() = default;
     explicit SimpleIndexedPropertyStorage(Vector<Value>&& initial_values);
 
@@ -53,20 +65,99 @@ public:
     virtual ValueAndAttributes take_first() override;
     virtual ValueAndAttributes take_last() override;
 
-    virtual size_t size() const override { return m_packed_elements.size(); }
+    virtual size_t size() const override { return m_array_size; }
     virtual size_t array_like_size() const override { return m_array_size; }
     virtual bool set_array_like_size(size_t new_size) override;
 
     virtual bool is_simple_storage() const override { return true; }
-    Vector<Value> const& elements() const { return m_packed_elements; }
+
+    ElementKind element_kind() const { return m_element_kind; }
+    bool is_packed() const { return m_element_kind != ElementKind::Values; }
+
+    // NOTE: Only valid for the element kind they are named after.
+    ReadonlySpan<i32> int32_elements() const
+    {
+        VERIFY(m_element_kind == ElementKind::PackedInt32);
+        return m_int32_elements.span();
+    }
+    ReadonlySpan<double> double_elements() const
+    {
+        VERIFY(m_element_kind == ElementKind::PackedDouble);
+        return m_double_elements.span();
+    }
+    ReadonlySpan<Value> value_elements() const
+    {
+        VERIFY(m_element_kind == ElementKind::Values);
+        return m_value_elements.span();
+    }
+
+    // Returns the element at the given index, or an empty value for holes.
+    Value element_at(u32 index) const
+    {
+        VERIFY(index < m_array_size);
+        switch (m_element_kind) {
+        case ElementKind::PackedInt32:
+            return Value(m_int32_elements.data()[index]);
+        case ElementKind::PackedDouble:
+            return Value(m_double_elements.data()[index]);
+        case ElementKind::Values:
+            return m_value_elements.data()[index];
+        }
+        VERIFY_NOT_REACHED();
+    }
+
+    // Overwrites an existing element without going through put(). Returns false if the value doesn't fit the
+    // current element kind, in which case the caller should fall back to put().
+    bool try_set_existing_element(u32 index, Value value)
+    {
+        VERIFY(index < m_array_size);
+        switch (m_element_kind) {
+        case ElementKind::PackedInt32:
+            if (!value.is_int32())
+                return false;
+            m_int32_elements.data()[index] = value.as_i32();
+            return true;
+        case ElementKind::PackedDouble:
+            if (!value.is_number())
+                return false;
+            m_double_elements.data()[index] = value.as_double();
+            return true;
+        case ElementKind::Values:
+            if (value.is_empty())
+                return false;
+            m_value_elements.data()[index] = value;
+            return true;
+        }
+        VERIFY_NOT_REACHED();
+    }
+
+    void reverse();
+
+    // Switches back to one of the packed element kinds if there are no holes, and all elements are numbers.
+    void pack_if_possible();
+
+    template<typename Callback>
+    void for_each_cell_value(Callback callback)
+    {
+        // NOTE: Packed numeric elements never point into the heap, so there's nothing to visit.
+        if (m_element_kind != ElementKind::Values)
+            return;
+        for (auto& value : m_value_elements)
+            callback(value);
+    }
 
 private:
     friend GenericIndexedPropertyStorage;
 
-    void grow_storage_if_needed();
+    static ElementKind element_kind_for(Value);
+    void transition_to(ElementKind);
+    void resize_elements(size_t new_size);
 
     size_t m_array_size { 0 };
-    Vector<Value> m_packed_elements;
+    ElementKind m_element_kind { ElementKind::PackedInt32 };
+    Vector<i32> m_int32_elements;
+    Vector<double> m_double_elements;
+    Vector<Value> m_value_elements;
 };
 
 class GenericIndexedPropertyStorage final : public IndexedPropertyStorage {
@@ -140,14 +231,29 @@ public:
 
     Vector<u32> indices() const;
 
+    SimpleIndexedPropertyStorage const* simple_storage() const
+    {
+        if (!m_storage || !m_storage->is_simple_storage())
+            return nullptr;
+        return static_cast<SimpleIndexedPropertyStorage const*>(m_storage.ptr());
+    }
+    SimpleIndexedPropertyStorage* simple_storage() { return const_cast<SimpleIndexedPropertyStorage*>(const_cast<IndexedProperties const&>(*this).simple_storage()); }
+
+    // Returns the simple storage if it has no holes. All of its elements are then plain data properties with default attributes.
+    SimpleIndexedPropertyStorage const* packed_storage() const
+    {
+        auto const* storage = simple_storage();
+        return storage && storage->is_packed() ? storage : nullptr;
+    }
+    SimpleIndexedPropertyStorage* packed_storage() { return const_cast<SimpleIndexedPropertyStorage*>(const_cast<IndexedProperties const&>(*this).packed_storage()); }
+
     template<typename Callback>
     void for_each_value(Callback callback)
     {
         if (!m_storage)
             return;
         if (m_storage->is_simple_storage()) {
-            for (auto& value : static_cast<SimpleIndexedPropertyStorage&>(*m_storage).elements())
-                callback(value);
+            static_cast<SimpleIndexedPropertyStorage&>(*m_storage).for_each_cell_value(callback);
         } else {
             for (auto& element : static_cast<GenericIndexedPropertyStorage const&>(*m_storage).sparse_elements())
                 callback(element.value.value);
@@ -4,7 +4,10 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/CharacterTypes.h>
+#include <AK/FloatingPointStringConversions.h>
 #include <AK/Function.h>
+#include <AK/GenericLexer.h>
 #include <AK/JsonArray.h>
 #include <AK/JsonObject.h>
 #include <AK/JsonParser.h>
@@ -106,7 +109,11 @@ ThrowCompletionOr<DeprecatedString> JSONObject::stringify_impl(VM& vm, Value val
 
     auto wrapper = Object::create(realm, realm.intrinsics().object_prototype());
     MUST(wrapper->create_data_property_or_throw(DeprecatedString::empty(), value));
-    return serialize_json_property(vm, state, DeprecatedString::empty(), wrapper);
+
+    StringBuilder builder;
+    if (!TRY(serialize_json_property(vm, state, DeprecatedString::empty(), wrapper, builder)))
+        return DeprecatedString {};
+    return builder.to_deprecated_string();
 }
 
 // 25.5.2 JSON.stringify ( value [ , replacer [ , space ] ] ), https://tc39.es/ecma262/#sec-json.stringify
@@ -127,7 +134,7 @@ JS_DEFINE_NATIVE_FUNCTION(JSONObject::stringify)
 }
 
 // 25.5.2.1 SerializeJSONProperty ( state, key, holder ), https://tc39.es/ecma262/#sec-serializejsonproperty
-ThrowCompletionOr<DeprecatedString> JSONObject::serialize_json_property(VM& vm, StringifyState& state, PropertyKey const& key, Object* holder)
+ThrowCompletionOr<bool> JSONObject::serialize_json_property(VM& vm, StringifyState& state, PropertyKey const& key, Object* holder, StringBuilder& builder)
 {
     // 1. Let value be ? Get(holder, key).
     auto value = TRY(holder->get(key));
@@ -177,26 +184,33 @@ ThrowCompletionOr<DeprecatedString> JSONObject::serialize_json_property(VM& vm,
     }
 
     // 5. If value is null, return "null".
-    if (value.is_null())
-        return "null"sv;
+    if (value.is_null()) {
+        builder.append("null"sv);
+        return true;
+    }
 
     // 6. If value is true, return "true".
     // 7. If value is false, return "false".
-    if (value.is_boolean())
-        return value.as_bool() ? "true"sv : "false"sv;
+    if (value.is_boolean()) {
+        builder.append(value.as_bool() ? "true"sv : "false"sv);
+        return true;
+    }
 
     // 8. If Type(value) is String, return QuoteJSONString(value).
-    if (value.is_string())
-        return quote_json_string(TRY(value.as_string().deprecated_string()));
+    if (value.is_string()) {
+        quote_json_string(builder, TRY(value.as_string().deprecated_string()));
+        return true;
+    }
 
     // 9. If Type(value) is Number, then
     if (value.is_number()) {
         // a. If value is finite, return ! ToString(value).
         if (value.is_finite_number())
-            return MUST(value.to_deprecated_string(vm));
-
+            builder.append(MUST(value.to_deprecated_string(vm)));
         // b. Return "null".
-        return "null"sv;
+        else
+            builder.append("null"sv);
+        return true;
     }
 
     // 10. If Type(value) is BigInt, throw a TypeError exception.
@@ -210,18 +224,35 @@ ThrowCompletionOr<DeprecatedString> JSONObject::serialize_json_property(VM& vm,
 
         // b. If isArray is true, return ? SerializeJSONArray(state, value).
         if (is_array)
-            return serialize_json_array(vm, state, value.as_object());
-
+            TRY(serialize_json_array(vm, state, value.as_object(), builder));
         // c. Return ? SerializeJSONObject(state, value).
-        return serialize_json_object(vm, state, value.as_object());
+        else
+            TRY(serialize_json_object(vm, state, value.as_object(), builder));
+        return true;
     }
 
     // 12. Return undefined.
-    return DeprecatedString {};
+    return false;
+}
+
+// Collects the keys EnumerableOwnPropertyNames(object, key) would return straight from the object's shape, without
+// going through [[OwnPropertyKeys]] and [[GetOwnProperty]]. Only ordinary objects without indexed properties qualify.
+static Optional<Vector<PropertyKey>> enumerable_own_string_keys_of_ordinary_object(Object const& object)
+{
+    if (object.may_interfere_with_indexed_property_access() || is<Array>(object) || !object.indexed_properties().is_empty())
+        return {};
+
+    Vector<PropertyKey> keys;
+    keys.ensure_capacity(object.shape().property_count());
+    for (auto& property : object.shape().property_table_ordered()) {
+        if (property.key.is_string() && property.value.attributes.is_enumerable())
+            keys.unchecked_append(property.key.as_string());
+    }
+    return keys;
 }
 
 // 25.5.2.4 SerializeJSONObject ( state, value ), https://tc39.es/ecma262/#sec-serializejsonobject
-ThrowCompletionOr<DeprecatedString> JSONObject::serialize_json_object(VM& vm, StringifyState& state, Object& object)
+ThrowCompletionOr<void> JSONObject::serialize_json_object(VM& vm, StringifyState& state, Object& object, StringBuilder& builder)
 {
     if (state.seen_objects.contains(&object))
         return vm.throw_completion<TypeError>(ErrorType::JsonCircular);
@@ -229,19 +260,32 @@ ThrowCompletionOr<DeprecatedString> JSONObject::serialize_json_object(VM& vm, St
     state.seen_objects.set(&object);
     DeprecatedString previous_indent = state.indent;
     state.indent = DeprecatedString::formatted("{}{}", state.indent, state.gap);
-    Vector<DeprecatedString> property_strings;
+    bool is_empty = true;
+
+    builder.append('{');
 
     auto process_property = [&](PropertyKey const& key) -> ThrowCompletionOr<void> {
         if (key.is_symbol())
             return {};
-        auto serialized_property_string = TRY(serialize_json_property(vm, state, key, &object));
-        if (!serialized_property_string.is_null()) {
-            property_strings.append(DeprecatedString::formatted(
-                "{}:{}{}",
-                quote_json_string(key.to_string()),
-                state.gap.is_empty() ? "" : " ",
-                serialized_property_string));
+
+        auto start_of_property = builder.length();
+        if (!is_empty)
+            builder.append(',');
+        if (!state.gap.is_empty()) {
+            builder.append('\n');
+            builder.append(state.indent);
+        }
+        if (key.is_string())
+            quote_json_string(builder, key.as_string());
+        else
+            quote_json_string(builder, key.to_string());
+        builder.append(state.gap.is_empty() ? ":"sv : ": "sv);
+
+        if (!TRY(serialize_json_property(vm, state, key, &object, builder))) {
+            builder.trim(builder.length() - start_of_property);
+            return {};
         }
+        is_empty = false;
         return {};
     };
 
@@ -249,47 +293,28 @@ ThrowCompletionOr<DeprecatedString> JSONObject::serialize_json_object(VM& vm, St
         auto property_list = state.property_list.value();
         for (auto& property : property_list)
             TRY(process_property(property));
+    } else if (auto keys = enumerable_own_string_keys_of_ordinary_object(object); keys.has_value()) {
+        for (auto& key : *keys)
+            TRY(process_property(key));
     } else {
         auto property_list = TRY(object.enumerable_own_property_names(PropertyKind::Key));
         for (auto& property : property_list)
             TRY(process_property(TRY(property.as_string().deprecated_string())));
     }
-    StringBuilder builder;
-    if (property_strings.is_empty()) {
-        builder.append("{}"sv);
-    } else {
-        bool first = true;
-        builder.append('{');
-        if (state.gap.is_empty()) {
-            for (auto& property_string : property_strings) {
-                if (!first)
-                    builder.append(',');
-                first = false;
-                builder.append(property_string);
-            }
-        } else {
-            builder.append('\n');
-            builder.append(state.indent);
-            auto separator = DeprecatedString::formatted(",\n{}", state.indent);
-            for (auto& property_string : property_strings) {
-                if (!first)
-                    builder.append(separator);
-                first = false;
-                builder.append(property_string);
-            }
-            builder.append('\n');
-            builder.append(previous_indent);
-        }
-        builder.append('}');
+
+    if (!is_empty && !state.gap.is_empty()) {
+        builder.append('\n');
+        builder.append(previous_indent);
     }
+    builder.append('}');
 
     state.seen_objects.remove(&object);
     state.indent = previous_indent;
-    return builder.to_deprecated_string();
+    return {};
 }
 
 // 25.5.2.5 SerializeJSONArray ( state, value ), https://tc39.es/ecma262/#sec-serializejsonarray
-ThrowCompletionOr<DeprecatedString> JSONObject::serialize_json_array(VM& vm, StringifyState& state, Object& object)
+ThrowCompletionOr<void> JSONObject::serialize_json_array(VM& vm, StringifyState& state, Object& object, StringBuilder& builder)
 {
     if (state.seen_objects.contains(&object))
         return vm.throw_completion<TypeError>(ErrorType::JsonCircular);
@@ -297,65 +322,69 @@ ThrowCompletionOr<DeprecatedString> JSONObject::serialize_json_array(VM& vm, Str
     state.seen_objects.set(&object);
     DeprecatedString previous_indent = state.indent;
     state.indent = DeprecatedString::formatted("{}{}", state.indent, state.gap);
-    Vector<DeprecatedString> property_strings;
 
     auto length = TRY(length_of_array_like(vm, object));
 
-    // Optimization
-    property_strings.ensure_capacity(length);
+    builder.append('[');
 
-    for (size_t i = 0; i < length; ++i) {
-        auto serialized_property_string = TRY(serialize_json_property(vm, state, i, &object));
-        if (serialized_property_string.is_null()) {
-            property_strings.append("null"sv);
-        } else {
-            property_strings.append(serialized_property_string);
+    auto append_separator = [&](size_t index) {
+        if (index != 0)
+            builder.append(',');
+        if (!state.gap.is_empty()) {
+            builder.append('\n');
+            builder.append(state.indent);
         }
-    }
+    };
 
-    StringBuilder builder;
-    if (property_strings.is_empty()) {
-        builder.append("[]"sv);
+    // OPTIMIZATION: Elements of the packed element kinds are all numbers, so unless there's a replacer function that
+    //               could turn them into something else, there is nothing observable about serializing them.
+    auto const* packed_storage = object.may_interfere_with_indexed_property_access() ? nullptr : object.indexed_properties().packed_storage();
+    if (packed_storage && !state.replacer_function && packed_storage->array_like_size() >= length) {
+        for (size_t i = 0; i < length; ++i) {
+            append_separator(i);
+            auto element = packed_storage->element_at(i);
+            if (element.is_finite_number())
+                builder.append(MUST(element.to_deprecated_string(vm)));
+            else
+                builder.append("null"sv);
+        }
     } else {
-        if (state.gap.is_empty()) {
-            builder.append('[');
-            bool first = true;
-            for (auto& property_string : property_strings) {
-                if (!first)
-                    builder.append(',');
-                first = false;
-                builder.append(property_string);
-            }
-            builder.append(']');
-        } else {
-            builder.append("[\n"sv);
-            builder.append(state.indent);
-            auto separator = DeprecatedString::formatted(",\n{}", state.indent);
-            bool first = true;
-            for (auto& property_string : property_strings) {
-                if (!first)
-                    builder.append(separator);
-                first = false;
-                builder.append(property_string);
-            }
-            builder.append('\n');
-            builder.append(previous_indent);
-            builder.append(']');
+        for (size_t i = 0; i < length; ++i) {
+            append_separator(i);
+            if (!TRY(serialize_json_property(vm, state, i, &object, builder)))
+                builder.append("null"sv);
         }
     }
 
+    if (length != 0 && !state.gap.is_empty()) {
+        builder.append('\n');
+        builder.append(previous_indent);
+    }
+    builder.append(']');
+
     state.seen_objects.remove(&object);
     state.indent = previous_indent;
-    return builder.to_deprecated_string();
+    return {};
+}
+
+static bool needs_no_escaping_in_json_string(StringView string)
+{
+    return all_of(string, [](char ch) { return ch >= 0x20 && ch < 0x7f && ch != '"' && ch != '\\'; });
 }
 
 // 25.5.2.2 QuoteJSONString ( value ), https://tc39.es/ecma262/#sec-quotejsonstring
-DeprecatedString JSONObject::quote_json_string(DeprecatedString string)
+void JSONObject::quote_json_string(StringBuilder& builder, StringView string)
 {
     // 1. Let product be the String value consisting solely of the code unit 0x0022 (QUOTATION MARK).
-    StringBuilder builder;
     builder.append('"');
 
+    // OPTIMIZATION: Most strings (and almost all keys) are plain ASCII without anything to escape.
+    if (needs_no_escaping_in_json_string(string)) {
+        builder.append(string);
+        builder.append('"');
+        return;
+    }
+
     // 2. For each code point C of StringToCodePoints(value), do
     auto utf_view = Utf8View(string);
     for (auto code_point : utf_view) {
@@ -401,7 +430,302 @@ DeprecatedString JSONObject::quote_json_string(DeprecatedString string)
     builder.append('"');
 
     // 4. Return product.
-    return builder.to_deprecated_string();
+}
+
+namespace {
+
+// Turns JSON text straight into JS values, without building an AK::JsonValue tree first. The accepted grammar is
+// the same as AK::JsonParser's, which is the one from ECMA-404.
+class JSONTextParser : public GenericLexer {
+public:
+    JSONTextParser(VM& vm, StringView text)
+        : GenericLexer(text)
+        , m_vm(vm)
+        , m_realm(*vm.current_realm())
+    {
+    }
+
+    ThrowCompletionOr<Value> parse()
+    {
+        auto value = TRY(parse_value());
+        skip_whitespace();
+        if (!is_eof())
+            return syntax_error();
+        return value;
+    }
+
+private:
+    // Objects created from JSON tend to come in large groups with the same keys in the same order (think of an array
+    // of records), which all end up with the same shape. Instead of walking the shape transitions for every one of
+    // them, we remember the shapes we built for each key sequence, and create matching objects from those directly.
+    struct CachedShape {
+        Handle<Shape> shape;
+        Vector<DeprecatedString> keys;
+    };
+
+    static bool is_whitespace(char ch) { return ch == '\t' || ch == '\n' || ch == '\r' || ch == ' '; }
+    void skip_whitespace() { ignore_while(is_whitespace); }
+
+    ThrowCompletionOr<Value> syntax_error() { return m_vm.throw_completion<SyntaxError>(ErrorType::JsonMalformed); }
+
+    ThrowCompletionOr<Value> parse_value()
+    {
+        if (m_vm.did_reach_stack_space_limit())
+            return m_vm.throw_completion<InternalError>(ErrorType::CallStackSizeExceeded);
+
+        skip_whitespace();
+        switch (peek()) {
+        case '{':
+            return parse_object();
+        case '[':
+            return parse_array();
+        case '"':
+            return PrimitiveString::create(m_vm, TRY(parse_string()));
+        case 't':
+            if (consume_specific("true"sv))
+                return Value(true);
+            break;
+        case 'f':
+            if (consume_specific("false"sv))
+                return Value(false);
+            break;
+        case 'n':
+            if (consume_specific("null"sv))
+                return js_null();
+            break;
+        default:
+            if (next_is('-') || next_is(is_ascii_digit))
+                return parse_number();
+            break;
+        }
+        return syntax_error();
+    }
+
+    ThrowCompletionOr<Value> parse_object()
+    {
+        VERIFY(consume_specific('{'));
+
+        Vector<DeprecatedString> keys;
+        MarkedVector<Value> values { m_vm.heap() };
+
+        skip_whitespace();
+        if (!consume_specific('}')) {
+            for (;;) {
+                skip_whitespace();
+                if (!next_is('"'))
+                    return syntax_error();
+                keys.append(TRY(parse_string()));
+                skip_whitespace();
+                if (!consume_specific(':'))
+                    return syntax_error();
+                values.append(TRY(parse_value()));
+                skip_whitespace();
+                if (consume_specific('}'))
+                    break;
+                if (!consume_specific(','))
+                    return syntax_error();
+            }
+        }
+
+        u32 hash = keys.size();
+        for (auto& key : keys)
+            hash = pair_int_hash(hash, key.hash());
+
+        if (auto cached_shape = m_shape_cache.get(hash); cached_shape.has_value() && cached_shape->keys == keys) {
+            auto object = Object::create_with_premade_shape(*cached_shape->shape);
+            for (size_t i = 0; i < values.size(); ++i)
+                object->put_direct(i, values[i]);
+            return object;
+        }
+
+        auto object = Object::create(m_realm, m_realm.intrinsics().object_prototype());
+        for (size_t i = 0; i < keys.size(); ++i)
+            object->define_direct_property(keys[i], values[i], default_attributes);
+
+        // NOTE: We can only reuse shapes that have exactly one property for each key, in order. Duplicate keys and
+        //       array indices (which go into the indexed property storage instead) leave the property count short.
+        auto& shape = object->shape();
+        if (!shape.is_unique() && shape.property_count() == keys.size() && object->indexed_properties().is_empty())
+            m_shape_cache.set(hash, { make_handle(shape), move(keys) });
+
+        return object;
+    }
+
+    ThrowCompletionOr<Value> parse_array()
+    {
+        VERIFY(consume_specific('['));
+
+        MarkedVector<Value> elements { m_vm.heap() };
+
+        skip_whitespace();
+        if (!consume_specific(']')) {
+            for (;;) {
+                elements.append(TRY(parse_value()));
+                skip_whitespace();
+                if (consume_specific(']'))
+                    break;
+                if (!consume_specific(','))
+                    return syntax_error();
+            }
+        }
+
+        // NOTE: This lets the array pick the most compact element kind for its elements right away.
+        auto array = MUST(Array::create(m_realm, 0));
+        array->set_indexed_property_elements(Vector<Value> { elements.span() });
+        return array;
+    }
+
+    ThrowCompletionOr<DeprecatedString> parse_string()
+    {
+        VERIFY(consume_specific('"'));
+
+        auto is_special = [](char ch) { return ch == '"' || ch == '\\' || is_ascii_c0_control(ch); };
+
+        // OPTIMIZATION: Strings without any escape sequences can be copied out of the text as they are.
+        auto start = tell();
+        ignore_until(is_special);
+        if (consume_specific('"'))
+            return DeprecatedString(m_input.substring_view(start, tell() - start - 1));
+
+        StringBuilder builder;
+        builder.append(m_input.substring_view(start, tell() - start));
+
+        for (;;) {
+            if (is_eof() || is_ascii_c0_control(peek()))
+                return m_vm.throw_completion<SyntaxError>(ErrorType::JsonMalformed);
+            if (consume_specific('"'))
+                break;
+
+            if (!consume_specific('\\')) {
+                builder.append(consume_until(is_special));
+                continue;
+            }
+
+            if (is_eof())
+                return m_vm.throw_completion<SyntaxError>(ErrorType::JsonMalformed);
+            switch (consume()) {
+            case '"':
+                builder.append('"');
+                break;
+            case '\\':
+                builder.append('\\');
+                break;
+            case '/':
+                builder.append('/');
+                break;
+            case 'b':
+                builder.append('\b');
+                break;
+            case 'f':
+                builder.append('\f');
+                break;
+            case 'n':
+                builder.append('\n');
+                break;
+            case 'r':
+                builder.append('\r');
+                break;
+            case 't':
+                builder.append('\t');
+                break;
+            case 'u': {
+                auto code_unit = parse_hex_code_unit();
+                if (!code_unit.has_value())
+                    return m_vm.throw_completion<SyntaxError>(ErrorType::JsonMalformed);
+                u32 code_point = *code_unit;
+
+                // Strings are stored as UTF-8, so a surrogate pair has to be turned back into the code point it encodes.
+                if (Utf16View::is_high_surrogate(*code_unit) && next_is("\\u"sv)) {
+                    auto position = tell();
+                    ignore(2);
+                    if (auto low_surrogate = parse_hex_code_unit(); low_surrogate.has_value() && Utf16View::is_low_surrogate(*low_surrogate))
+                        code_point = Utf16View::decode_surrogate_pair(*code_unit, *low_surrogate);
+                    else
+                        retreat(tell() - position);
+                }
+
+                builder.append_code_point(code_point);
+                break;
+            }
+            default:
+                return m_vm.throw_completion<SyntaxError>(ErrorType::JsonMalformed);
+            }
+        }
+
+        return builder.to_deprecated_string();
+    }
+
+    Optional<u16> parse_hex_code_unit()
+    {
+        if (tell_remaining() < 4)
+            return {};
+        u16 code_unit = 0;
+        for (size_t i = 0; i < 4; ++i) {
+            auto ch = consume();
+            if (!is_ascii_hex_digit(ch))
+                return {};
+            code_unit = (code_unit << 4) | parse_ascii_hex_digit(ch);
+        }
+        return code_unit;
+    }
+
+    ThrowCompletionOr<Value> parse_number()
+    {
+        auto start = tell();
+
+        bool is_negative = consume_specific('-');
+        if (consume_specific('0')) {
+            // Leading zeros are not allowed.
+            if (next_is(is_ascii_digit))
+                return syntax_error();
+        } else if (next_is(is_ascii_digit)) {
+            ignore_while(is_ascii_digit);
+        } else {
+            return syntax_error();
+        }
+
+        bool is_integer = true;
+        if (consume_specific('.')) {
+            is_integer = false;
+            if (!next_is(is_ascii_digit))
+                return syntax_error();
+            ignore_while(is_ascii_digit);
+        }
+        if (consume_specific('e') || consume_specific('E')) {
+            is_integer = false;
+            if (!consume_specific('+'))
+                consume_specific('-');
+            if (!next_is(is_ascii_digit))
+                return syntax_error();
+            ignore_while(is_ascii_digit);
+        }
+
+        auto number = m_input.substring_view(start, tell() - start);
+
+        // OPTIMIZATION: Most numbers in JSON are small integers, which don't need the full floating point parser.
+        //               Anything with up to 9 digits fits into an i32, except for negative zero, which has to be a double.
+        if (is_integer && number.length() - (is_negative ? 1 : 0) <= 9) {
+            auto value = number.to_int<i32>().release_value();
+            if (value != 0 || !is_negative)
+                return Value(value);
+        }
+
+        auto result = parse_first_floating_point(number.characters_without_null_termination(), number.characters_without_null_termination() + number.length());
+        VERIFY(result.end_ptr == number.characters_without_null_termination() + number.length());
+        return Value(result.value);
+    }
+
+    VM& m_vm;
+    Realm& m_realm;
+    HashMap<u32, CachedShape> m_shape_cache;
+};
+
+}
+
+ThrowCompletionOr<Value> JSONObject::parse_json_text(VM& vm, StringView text)
+{
+    JSONTextParser parser(vm, text);
+    return parser.parse();
 }
 
 // 25.5.1 JSON.parse ( text [ , reviver ] ), https://tc39.es/ecma262/#sec-json.parse
@@ -412,10 +736,7 @@ JS_DEFINE_NATIVE_FUNCTION(JSONObject::parse)
     auto string = TRY(vm.argument(0).to_deprecated_string(vm));
     auto reviver = vm.argument(1);
 
-    auto json = JsonValue::from_string(string);
-    if (json.is_error())
-        return vm.throw_completion<SyntaxError>(ErrorType::JsonMalformed);
-    Value unfiltered = parse_json_value(vm, json.value());
+    Value unfiltered = TRY(parse_json_text(vm, string));
     if (reviver.is_function()) {
         auto root = Object::create(realm, realm.intrinsics().object_prototype());
         auto root_name = DeprecatedString::empty();
@@ -425,6 +746,27 @@ JS_DEFINE_NATIVE_FUNCTION(JSONObject::parse)
     return unfiltered;
 }
 
+static Object* parse_json_object(VM& vm, JsonObject const& json_object)
+{
+    auto& realm = *vm.current_realm();
+    auto object = Object::create(realm, realm.intrinsics().object_prototype());
+    json_object.for_each_member([&](auto& key, auto& value) {
+        object->define_direct_property(key, JSONObject::parse_json_value(vm, value), default_attributes);
+    });
+    return object;
+}
+
+static Array* parse_json_array(VM& vm, JsonArray const& json_array)
+{
+    auto& realm = *vm.current_realm();
+    auto array = MUST(Array::create(realm, 0));
+    size_t index = 0;
+    json_array.for_each([&](auto& value) {
+        array->define_direct_property(index++, JSONObject::parse_json_value(vm, value), default_attributes);
+    });
+    return array;
+}
+
 Value JSONObject::parse_json_value(VM& vm, JsonValue const& value)
 {
     if (value.is_object())
@@ -444,27 +786,6 @@ Value JSONObject::parse_json_value(VM& vm, JsonValue const& value)
     VERIFY_NOT_REACHED();
 }
 
-Object* JSONObject::parse_json_object(VM& vm, JsonObject const& json_object)
-{
-    auto& realm = *vm.current_realm();
-    auto object = Object::create(realm, realm.intrinsics().object_prototype());
-    json_object.for_each_member([&](auto& key, auto& value) {
-        object->define_direct_property(key, parse_json_value(vm, value), default_attributes);
-    });
-    return object;
-}
-
-Array* JSONObject::parse_json_array(VM& vm, JsonArray const& json_array)
-{
-    auto& realm = *vm.current_realm();
-    auto array = MUST(Array::create(realm, 0));
-    size_t index = 0;
-    json_array.for_each([&](auto& value) {
-        array->define_direct_property(index++, parse_json_value(vm, value), default_attributes);
-    });
-    return array;
-}
-
 // 25.5.1.1 InternalizeJSONProperty ( holder, name, reviver ), https://tc39.es/ecma262/#sec-internalizejsonproperty
 ThrowCompletionOr<Value> JSONObject::internalize_json_property(VM& vm, Object* holder, PropertyKey const& name, FunctionObject& reviver)
 {
@@ -35,14 +35,16 @@ private:
     };
 
     // Stringify helpers
-    static ThrowCompletionOr<DeprecatedString> serialize_json_property(VM&, StringifyState&, PropertyKey const& key, Object* holder);
-    static ThrowCompletionOr<DeprecatedString> serialize_json_object(VM&, StringifyState&, Object&);
-    static ThrowCompletionOr<DeprecatedString> serialize_json_array(VM&, StringifyState&, Object&);
-    static DeprecatedString quote_json_string(DeprecatedString);
+    // NOTE: These append to the given builder instead of returning the serialized strings, so that nested values
+    //       don't have to be copied into their parents. serialize_json_property() returns false if the value is
+    //       undefined (i.e. should be skipped), in which case nothing was appended.
+    static ThrowCompletionOr<bool> serialize_json_property(VM&, StringifyState&, PropertyKey const& key, Object* holder, StringBuilder&);
+    static ThrowCompletionOr<void> serialize_json_object(VM&, StringifyState&, Object&, StringBuilder&);
+    static ThrowCompletionOr<void> serialize_json_array(VM&, StringifyState&, Object&, StringBuilder&);
+    static void quote_json_string(StringBuilder&, StringView);
 
     // Parse helpers
-    static Object* parse_json_object(VM&, JsonObject const&);
-    static Array* parse_json_array(VM&, JsonArray const&);
+    static ThrowCompletionOr<Value> parse_json_text(VM&, StringView);
     static ThrowCompletionOr<Value> internalize_json_property(VM&, Object* holder, PropertyKey const& name, FunctionObject& reviver);
 
     JS_DECLARE_NATIVE_FUNCTION(stringify);
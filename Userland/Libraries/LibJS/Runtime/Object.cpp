@@ -36,6 +36,11 @@ NonnullGCPtr<Object> Object::create(Realm& realm, Object* prototype)
     return realm.heap().allocate<Object>(realm, ConstructWithPrototypeTag::Tag, *prototype).release_allocated_value_but_fixme_should_propagate_errors();
 }
 
+NonnullGCPtr<Object> Object::create_with_premade_shape(Shape& shape)
+{
+    return shape.heap().allocate<Object>(shape.realm(), shape).release_allocated_value_but_fixme_should_propagate_errors();
+}
+
 Object::Object(GlobalObjectTag, Realm& realm)
 {
     // This is the global object
@@ -45,6 +45,10 @@ class Object : public Cell {
 public:
     static NonnullGCPtr<Object> create(Realm&, Object* prototype);
 
+    // Creates an object that already has all the properties of the given shape. Their values must be filled in
+    // with put_direct() before the object is handed out to anyone.
+    static NonnullGCPtr<Object> create_with_premade_shape(Shape&);
+
     virtual ThrowCompletionOr<void> initialize(Realm&) override;
     virtual ~Object();
 
@@ -171,9 +175,15 @@ public:
     bool has_parameter_map() const { return m_has_parameter_map; }
     void set_has_parameter_map() { m_has_parameter_map = true; }
 
+    // Set by exotic objects whose integer-indexed properties don't simply live in (or aren't simply read from)
+    // the indexed property storage. Fast paths that bypass the internal methods must bail out for these.
+    bool may_interfere_with_indexed_property_access() const { return m_may_interfere_with_indexed_property_access; }
+    void set_may_interfere_with_indexed_property_access() { m_may_interfere_with_indexed_property_access = true; }
+
     virtual void visit_edges(Cell::Visitor&) override;
 
     Value get_direct(size_t index) const { return m_storage[index]; }
+    void put_direct(size_t index, Value value) { m_storage[index] = value; }
 
     IndexedProperties const& indexed_properties() const { return m_indexed_properties; }
     IndexedProperties& indexed_properties() { return m_indexed_properties; }
@@ -206,6 +216,8 @@ protected:
     // [[ParameterMap]]
     bool m_has_parameter_map { false };
 
+    bool m_may_interfere_with_indexed_property_access { false };
+
 private:
     void set_shape(Shape& shape) { m_shape = &shape; }
 
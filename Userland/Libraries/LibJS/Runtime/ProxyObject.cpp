@@ -25,6 +25,7 @@ ProxyObject::ProxyObject(Object& target, Object& handler, Object& prototype)
     , m_target(target)
     , m_handler(handler)
 {
+    set_may_interfere_with_indexed_property_access();
 }
 
 static Value property_key_to_value(VM& vm, PropertyKey const& property_key)
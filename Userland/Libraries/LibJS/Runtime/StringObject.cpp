@@ -33,6 +33,7 @@ StringObject::StringObject(PrimitiveString& string, Object& prototype)
     : Object(ConstructWithPrototypeTag::Tag, prototype)
     , m_string(string)
 {
+    set_may_interfere_with_indexed_property_access();
 }
 
 ThrowCompletionOr<void> StringObject::initialize(Realm& realm)
@@ -65,6 +65,7 @@ protected:
         : Object(ConstructWithPrototypeTag::Tag, prototype)
         , m_intrinsic_constructor(intrinsic_constructor)
     {
+        set_may_interfere_with_indexed_property_access();
     }
 
     u32 m_array_length { 0 };
@@ -0,0 +1,156 @@
+describe("packed element kind transitions", () => {
+    test("int32 elements", () => {
+        const a = [1, 2, 3];
+        a[1] = -5;
+        a.push(7);
+        expect(a).toEqual([1, -5, 3, 7]);
+        expect(a[4]).toBeUndefined();
+    });
+
+    test("int32 to double", () => {
+        const a = [1, 2, 3];
+        a[0] = 1.5;
+        a.push(-0);
+        expect(a).toEqual([1.5, 2, 3, -0]);
+        expect(Object.is(a[3], -0)).toBeTrue();
+        a[1] = NaN;
+        expect(a[1]).toBeNaN();
+        a[2] = Infinity;
+        expect(a[2]).toBe(Infinity);
+    });
+
+    test("numbers to arbitrary values", () => {
+        const a = [1, 2.5, 3];
+        a[1] = "foo";
+        a.push({});
+        expect(a[0]).toBe(1);
+        expect(a[1]).toBe("foo");
+        expect(typeof a[3]).toBe("object");
+        expect(a).toHaveLength(4);
+    });
+
+    test("holes", () => {
+        const a = [1, 2, 3];
+        a[5] = 6;
+        expect(a).toHaveLength(6);
+        expect(3 in a).toBeFalse();
+        expect(a[3]).toBeUndefined();
+        expect(a[5]).toBe(6);
+
+        const b = [1, 2, 3];
+        delete b[1];
+        expect(1 in b).toBeFalse();
+        expect(b).toHaveLength(3);
+
+        const c = [1, 2, 3];
+        c.length = 5;
+        expect(4 in c).toBeFalse();
+        c.length = 2;
+        expect(c).toEqual([1, 2]);
+    });
+
+    test("holes read through the prototype chain", () => {
+        const a = [1, , 3];
+        Object.setPrototypeOf(a, [10, 20, 30]);
+        expect(a[1]).toBe(20);
+        expect(a.indexOf(20)).toBe(1);
+        expect(a.includes(20)).toBeTrue();
+    });
+
+    test("shift and pop", () => {
+        const a = [1.5, 2, 3];
+        expect(a.shift()).toBe(1.5);
+        expect(a.pop()).toBe(3);
+        expect(a).toEqual([2]);
+        expect(a.pop()).toBe(2);
+        expect(a.pop()).toBeUndefined();
+        expect(a).toHaveLength(0);
+    });
+
+    test("frozen arrays", () => {
+        const a = Object.freeze([1, 2, 3]);
+        a[0] = 5;
+        expect(a[0]).toBe(1);
+        expect(() => {
+            "use strict";
+            a[0] = 5;
+        }).toThrow(TypeError);
+        expect(() => a.push(4)).toThrow(TypeError);
+        expect(() => a.pop()).toThrow(TypeError);
+        expect(() => a.reverse()).toThrow(TypeError);
+        expect(() => a.fill(0)).toThrow(TypeError);
+    });
+});
+
+describe("built-in fast paths", () => {
+    test("indexOf, lastIndexOf and includes", () => {
+        const ints = [1, 2, 3, 2, 1];
+        expect(ints.indexOf(2)).toBe(1);
+        expect(ints.indexOf(2.0)).toBe(1);
+        expect(ints.indexOf(2.5)).toBe(-1);
+        expect(ints.indexOf("2")).toBe(-1);
+        expect(ints.indexOf(2, 2)).toBe(3);
+        expect(ints.lastIndexOf(2)).toBe(3);
+        expect(ints.lastIndexOf(2, 2)).toBe(1);
+        expect(ints.lastIndexOf(1, -6)).toBe(-1);
+        expect(ints.includes(3)).toBeTrue();
+        expect(ints.includes(3, 3)).toBeFalse();
+        expect([0].indexOf(-0)).toBe(0);
+
+        const doubles = [0.5, NaN, -0, 2];
+        expect(doubles.indexOf(NaN)).toBe(-1);
+        expect(doubles.lastIndexOf(NaN)).toBe(-1);
+        expect(doubles.includes(NaN)).toBeTrue();
+        expect(doubles.indexOf(0)).toBe(2);
+        expect(doubles.includes(0)).toBeTrue();
+        expect(doubles.indexOf(2)).toBe(3);
+    });
+
+    test("fill", () => {
+        const a = [1, 2, 3, 4];
+        a.fill(0.5, 1, 3);
+        expect(a).toEqual([1, 0.5, 0.5, 4]);
+        a.fill("x", 3);
+        expect(a).toEqual([1, 0.5, 0.5, "x"]);
+
+        const b = new Array(4).fill(7);
+        expect(b).toEqual([7, 7, 7, 7]);
+        b[1] = 8;
+        expect(b.indexOf(8)).toBe(1);
+    });
+
+    test("push and reverse", () => {
+        const a = [];
+        for (let i = 0; i < 10; ++i) expect(a.push(i, i + 0.5)).toBe((i + 1) * 2);
+        a.reverse();
+        expect(a[0]).toBe(9.5);
+        expect(a[19]).toBe(0);
+        expect(a).toHaveLength(20);
+    });
+
+    test("push respects setters on the prototype chain", () => {
+        const a = [1, 2];
+        let setterValue;
+        Object.defineProperty(Array.prototype, 2, {
+            set(value) {
+                setterValue = value;
+            },
+            configurable: true,
+        });
+        try {
+            expect(a.push(3)).toBe(3);
+            expect(setterValue).toBe(3);
+            expect(Object.hasOwn(a, 2)).toBeFalse();
+        } finally {
+            delete Array.prototype[2];
+        }
+    });
+
+    test("mapped arguments objects", () => {
+        function f(a) {
+            arguments[0] = 5;
+            return [a, Array.prototype.indexOf.call(arguments, 5)];
+        }
+        expect(f(1)).toEqual([5, 0]);
+    });
+});
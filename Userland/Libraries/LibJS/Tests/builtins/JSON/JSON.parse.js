@@ -74,3 +74,116 @@ test("does not truncate large integers", () => {
     expect(JSON.parse("18446744073709551616")).toEqual(18446744073709551616);
     expect(JSON.parse("18446744073709551617")).toEqual(18446744073709551617);
 });
+
+test("more syntax errors", () => {
+    [
+        "01",
+        "-",
+        "1.",
+        ".5",
+        "1e",
+        "1e+",
+        "+1",
+        "[",
+        "[1 2]",
+        "{",
+        '{"foo":1 "bar":2}',
+        '{"foo"',
+        '{"foo":}',
+        "{1:2}",
+        '"unterminated',
+        '"\\x41"',
+        '"\\u12"',
+        '"\\u12G4"',
+        '"\\',
+        '"\t"',
+        "[1] 2",
+        "tru",
+        "nul",
+    ].forEach(test => {
+        expect(() => {
+            JSON.parse(test);
+        }).toThrow(SyntaxError);
+    });
+});
+
+test("numbers", () => {
+    expect(JSON.parse("0")).toBe(0);
+    expect(JSON.parse("-123456789")).toBe(-123456789);
+    expect(JSON.parse("999999999")).toBe(999999999);
+    expect(JSON.parse("-2147483648")).toBe(-2147483648);
+    expect(JSON.parse("1.5e3")).toBe(1500);
+    expect(JSON.parse("1E-2")).toBe(0.01);
+    expect(JSON.parse("-0e5")).toBe(-0);
+    expect(JSON.parse("1e400")).toBe(Infinity);
+});
+
+test("string escapes", () => {
+    expect(JSON.parse('"\\"\\\\\\/\\b\\f\\n\\r\\t"')).toBe('"\\/\b\f\n\r\t');
+    expect(JSON.parse('"\\u0041\\u00e9"')).toBe("Aé");
+    expect(JSON.parse('"\\ud83d\\ude04"')).toBe("😄");
+    expect(JSON.parse('"\\ud83d"')).toBe("\ud83d");
+    expect(JSON.parse('"\\ude04\\ud83d"')).toBe("\ude04\ud83d");
+    expect(JSON.parse('"\\ud83d\\u0041"')).toBe("\ud83dA");
+    expect(JSON.parse('"😄 ünïcödé"')).toBe("😄 ünïcödé");
+});
+
+test("objects with the same keys", () => {
+    const records = JSON.parse('[{"a":1,"b":"x"},{"a":2,"b":"y"},{"b":"z","a":3},{"a":4,"b":"w","c":null}]');
+    expect(records).toEqual([
+        { a: 1, b: "x" },
+        { a: 2, b: "y" },
+        { b: "z", a: 3 },
+        { a: 4, b: "w", c: null },
+    ]);
+    expect(Object.keys(records[1])).toEqual(["a", "b"]);
+    expect(Object.keys(records[2])).toEqual(["b", "a"]);
+
+    // Objects created from the same shape must still be independent of each other.
+    records[0].a = 10;
+    records[1].c = true;
+    delete records[1].b;
+    expect(records[0]).toEqual({ a: 10, b: "x" });
+    expect(records[1]).toEqual({ a: 2, c: true });
+    expect(Object.getPrototypeOf(records[1])).toBe(Object.prototype);
+    expect(Object.getOwnPropertyDescriptor(records[1], "a")).toEqual({
+        value: 2,
+        writable: true,
+        enumerable: true,
+        configurable: true,
+    });
+});
+
+test("duplicate keys", () => {
+    const records = JSON.parse('[{"a":1,"b":2,"a":3},{"a":4,"b":5,"a":6}]');
+    expect(records).toEqual([
+        { a: 3, b: 2 },
+        { a: 6, b: 5 },
+    ]);
+    expect(Object.keys(records[1])).toEqual(["a", "b"]);
+});
+
+test("array index keys", () => {
+    const records = JSON.parse('[{"b":1,"0":2,"a":3},{"b":4,"0":5,"a":6}]');
+    expect(Object.keys(records[0])).toEqual(["0", "b", "a"]);
+    expect(records[1]).toEqual({ 0: 5, a: 6, b: 4 });
+});
+
+test("arrays", () => {
+    const array = JSON.parse("[1, 2.5, -0, 3]");
+    expect(array).toHaveLength(4);
+    expect(Object.is(array[2], -0)).toBeTrue();
+    array.push("foo");
+    expect(array).toEqual([1, 2.5, -0, 3, "foo"]);
+
+    expect(JSON.parse("[]")).toEqual([]);
+    expect(JSON.parse("[[],[[]],{}]")).toEqual([[], [[]], {}]);
+});
+
+test("deep nesting", () => {
+    const depth = 1000;
+    const parsed = JSON.parse("[".repeat(depth) + "]".repeat(depth));
+    let array = parsed;
+    for (let i = 1; i < depth; ++i) array = array[0];
+    expect(array).toEqual([]);
+});
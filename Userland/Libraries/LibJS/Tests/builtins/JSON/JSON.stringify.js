@@ -97,3 +97,42 @@ describe("errors", () => {
         });
     });
 });
+
+describe("objects and arrays", () => {
+    test("numeric arrays", () => {
+        expect(JSON.stringify([1, 2, 3])).toBe("[1,2,3]");
+        expect(JSON.stringify([1.5, -0, NaN, Infinity, 1e21])).toBe("[1.5,0,null,null,1e+21]");
+        expect(JSON.stringify([1, 2], null, 2)).toBe("[\n  1,\n  2\n]");
+        expect(JSON.stringify([1, 2], (key, value) => (key === "1" ? "two" : value))).toBe('[1,"two"]');
+        expect(JSON.stringify([1, , 3])).toBe("[1,null,3]");
+    });
+
+    test("property order and deletion", () => {
+        const o = { b: 1, a: 2, 1: "one", 0: "zero", c: undefined };
+        delete o.b;
+        o.b = 3;
+        expect(JSON.stringify(o)).toBe('{"0":"zero","1":"one","a":2,"b":3}');
+        expect(JSON.stringify({ a: undefined, b: () => {} })).toBe("{}");
+        expect(JSON.stringify({ a: undefined, b: 1 }, null, 1)).toBe('{\n "b": 1\n}');
+    });
+
+    test("getters that delete later properties", () => {
+        const o = {
+            get a() {
+                delete this.b;
+                return 1;
+            },
+            b: 2,
+        };
+        expect(JSON.stringify(o)).toBe('{"a":1}');
+    });
+
+    test("escaped keys", () => {
+        expect(JSON.stringify({ 'a"b': 1, "\n": 2 })).toBe('{"a\\"b":1,"\\n":2}');
+    });
+
+    test("round trip", () => {
+        const text = '[{"id":1,"name":"foo","tags":["a","b"],"nested":{"x":1.5,"y":null}},{"id":2,"name":"bar","tags":[],"nested":{"x":-2,"y":true}}]';
+        expect(JSON.stringify(JSON.parse(text))).toBe(text);
+    });
+});
@@ -0,0 +1,453 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/CharacterTypes.h>
+#include <AK/DeprecatedString.h>
+#include <AK/Utf16View.h>
+#include <LibRegex/RegexDFA.h>
+
+namespace regex {
+
+constexpr static u32 const LineSeparator { 0x2028 };
+constexpr static u32 const ParagraphSeparator { 0x2029 };
+
+// Once the cache holds this many states, it is thrown away and rebuilt from the current state on.
+static constexpr size_t c_max_states = 2048;
+// A search that has to throw the cache away more often than this is better left to the backtracking Matcher.
+static constexpr size_t c_max_flushes_per_search = 4;
+
+static constexpr u64 make_thread(u32 instruction_position, u32 consumed)
+{
+    return (static_cast<u64>(instruction_position) << 32) | consumed;
+}
+
+static constexpr u32 thread_position(u64 thread) { return thread >> 32; }
+static constexpr u32 thread_consumed(u64 thread) { return thread & 0xffffffff; }
+
+// Transitions on other code units are only cached if the code unit alone decides how the bytecode treats it, which
+// is not the case for the halves of a surrogate pair in a UTF-16 view.
+static bool is_cacheable(u32 code_unit)
+{
+    return code_unit < 0xd800 || (code_unit >= 0xe000 && code_unit <= 0xffff);
+}
+
+template<typename T>
+static u32 jump_target(OpCode const& opcode, size_t next)
+{
+    return static_cast<u32>(static_cast<ssize_t>(next) + static_cast<T const&>(opcode).offset());
+}
+
+unsigned LazyDFA::StateKeyTraits::hash(StateKey const& key)
+{
+    unsigned hash = int_hash(to_underlying(key.previous_character));
+    for (auto thread : key.threads)
+        hash = pair_int_hash(hash, u64_hash(thread));
+    return hash;
+}
+
+OwnPtr<LazyDFA> LazyDFA::try_create(ByteCode const& bytecode)
+{
+    Vector<Node> nodes;
+    nodes.resize(bytecode.size());
+    bool uses_previous_character = false;
+
+    MatchState state;
+    for (size_t instruction_position = 0; instruction_position < bytecode.size();) {
+        state.instruction_position = instruction_position;
+        auto& opcode = bytecode.get_opcode(state);
+        auto& node = nodes[instruction_position];
+        node.next = instruction_position + opcode.size();
+
+        switch (opcode.opcode_id()) {
+        case OpCodeId::Compare: {
+            auto& compare = static_cast<OpCode_Compare const&>(opcode);
+            if (compare.arguments_count() == 1 && (CharacterCompareType)bytecode.at(instruction_position + 3) == CharacterCompareType::String) {
+                auto length = bytecode.at(instruction_position + 4);
+                for (size_t i = 0; i < length; ++i) {
+                    // These would turn into two code units when matching UTF-16.
+                    if (bytecode.at(instruction_position + 5 + i) > 0xffff)
+                        return nullptr;
+                }
+                node.kind = length == 0 ? Node::Kind::Continue : Node::Kind::CompareString;
+                node.argument = length;
+                break;
+            }
+            for (auto& [type, value] : compare.flat_compares()) {
+                if (type == CharacterCompareType::Reference || type == CharacterCompareType::String)
+                    return nullptr;
+            }
+            node.kind = Node::Kind::Compare;
+            break;
+        }
+        case OpCodeId::Jump:
+            node.kind = Node::Kind::Jump;
+            node.target = jump_target<OpCode_Jump>(opcode, node.next);
+            break;
+        case OpCodeId::ForkJump:
+        case OpCodeId::ForkReplaceJump:
+            // The optimizer only makes forks replace earlier ones where it expects the dropped alternatives to fail.
+            node.kind = Node::Kind::ForkPreferringTarget;
+            node.target = jump_target<OpCode_ForkJump>(opcode, node.next);
+            break;
+        case OpCodeId::ForkStay:
+        case OpCodeId::ForkReplaceStay:
+            node.kind = Node::Kind::ForkPreferringNext;
+            node.target = jump_target<OpCode_ForkStay>(opcode, node.next);
+            break;
+        case OpCodeId::JumpNonEmpty: {
+            auto& jump = static_cast<OpCode_JumpNonEmpty const&>(opcode);
+            node.kind = Node::Kind::JumpNonEmpty;
+            node.target = jump_target<OpCode_JumpNonEmpty>(opcode, node.next);
+            node.argument = static_cast<u32>(static_cast<ssize_t>(node.next) + jump.checkpoint());
+            switch (jump.form()) {
+            case OpCodeId::Jump:
+                node.non_empty_kind = Node::Kind::Jump;
+                break;
+            case OpCodeId::ForkJump:
+            case OpCodeId::ForkReplaceJump:
+                node.non_empty_kind = Node::Kind::ForkPreferringTarget;
+                break;
+            case OpCodeId::ForkStay:
+            case OpCodeId::ForkReplaceStay:
+                node.non_empty_kind = Node::Kind::ForkPreferringNext;
+                break;
+            default:
+                node.non_empty_kind = Node::Kind::Continue;
+                break;
+            }
+            break;
+        }
+        case OpCodeId::Checkpoint:
+            node.kind = Node::Kind::Checkpoint;
+            break;
+        case OpCodeId::SaveLeftCaptureGroup:
+        case OpCodeId::SaveRightCaptureGroup:
+        case OpCodeId::SaveRightNamedCaptureGroup:
+        case OpCodeId::ClearCaptureGroup:
+            node.kind = Node::Kind::Continue;
+            break;
+        case OpCodeId::CheckBegin:
+        case OpCodeId::CheckBoundary:
+            uses_previous_character = true;
+            node.kind = Node::Kind::Assertion;
+            break;
+        case OpCodeId::CheckEnd:
+            node.kind = Node::Kind::Assertion;
+            break;
+        case OpCodeId::Exit:
+            node.kind = Node::Kind::Fail;
+            break;
+        case OpCodeId::FailForks:
+        case OpCodeId::Save:
+        case OpCodeId::Restore:
+        case OpCodeId::GoBack:
+        case OpCodeId::Repeat:
+        case OpCodeId::ResetRepeat:
+            return nullptr;
+        }
+
+        instruction_position = node.next;
+    }
+
+    return adopt_own(*new LazyDFA(move(nodes), uses_previous_character));
+}
+
+LazyDFA::LazyDFA(Vector<Node> nodes, bool uses_previous_character)
+    : m_nodes(move(nodes))
+    , m_uses_previous_character(uses_previous_character)
+{
+    m_visited.resize(m_nodes.size() + 1);
+}
+
+bool LazyDFA::can_match(RegexStringView const& view)
+{
+    // Without the Unicode flag, every code unit is matched on its own.
+    return !view.unicode() && !view.is_u8_view();
+}
+
+LazyDFA::PreviousCharacter LazyDFA::classify(u32 code_unit)
+{
+    if (code_unit == '\r' || code_unit == '\n' || code_unit == LineSeparator || code_unit == ParagraphSeparator)
+        return PreviousCharacter::LineTerminator;
+    if (is_ascii_alphanumeric(code_unit) || code_unit == '_')
+        return PreviousCharacter::WordCharacter;
+    return PreviousCharacter::Other;
+}
+
+void LazyDFA::reset_if_options_changed(AllOptions options)
+{
+    // The options change what the compares and assertions accept, and so every transition.
+    if (m_options.has_value() && m_options->value() == options.value())
+        return;
+
+    m_options = options;
+    for (auto& automaton : m_automata) {
+        automaton.states.clear();
+        automaton.state_indices.clear();
+        automaton.start_states = {};
+    }
+}
+
+u32 LazyDFA::intern_state(Automaton& automaton, Vector<Thread> threads, PreviousCharacter previous_character)
+{
+    StateKey key { move(threads), previous_character };
+    if (auto index = automaton.state_indices.get(key); index.has_value())
+        return *index;
+
+    auto state = make<State>();
+    state->threads = key.threads;
+    state->previous_character = previous_character;
+
+    u32 index = automaton.states.size();
+    automaton.states.append(move(state));
+    automaton.state_indices.set(move(key), index);
+    return index;
+}
+
+u32 LazyDFA::start_state(Automaton& automaton, PreviousCharacter previous_character)
+{
+    auto& start_state = automaton.start_states[to_underlying(previous_character)];
+    if (!start_state.has_value())
+        start_state = intern_state(automaton, { make_thread(0, 0) }, previous_character);
+    return *start_state;
+}
+
+u32 LazyDFA::flush(Automaton& automaton, u32 state_index)
+{
+    auto& state = *automaton.states[state_index];
+    auto threads = move(state.threads);
+    auto previous_character = state.previous_character;
+
+    automaton.states.clear();
+    automaton.state_indices.clear();
+    automaton.start_states = {};
+    return intern_state(automaton, move(threads), previous_character);
+}
+
+bool LazyDFA::evaluate(ByteCode const& bytecode, MatchInput const& input, u32 instruction_position, size_t position)
+{
+    m_scratch_state.instruction_position = instruction_position;
+    m_scratch_state.string_position = position;
+    m_scratch_state.string_position_in_code_units = position;
+
+    auto& opcode = bytecode.get_opcode(m_scratch_state);
+    if (opcode.execute(input, m_scratch_state) != ExecutionResult::Continue)
+        return false;
+
+    // Compares have to consume exactly the code unit at the position, assertions nothing at all.
+    if (opcode.opcode_id() == OpCodeId::Compare)
+        return m_scratch_state.string_position == position + 1;
+    return true;
+}
+
+// Follows every thread through the bytecode up to the compares that would consume the code unit at the position,
+// collecting them in m_consuming_threads in the order the Matcher would try them. Returns whether a match ends at the
+// position first, in which case every thread the Matcher would only try after that match is dropped.
+bool LazyDFA::compute_closure(Vector<Thread> const& threads, ByteCode const& bytecode, MatchInput const& input, size_t position)
+{
+    m_consuming_threads.clear_with_capacity();
+    ++m_visit_generation;
+
+    // The Checkpoints on the path to a node, as a linked list; zero is the empty list.
+    struct CheckpointLink {
+        u32 checkpoint;
+        u32 previous;
+    };
+    Vector<CheckpointLink, 8> checkpoints;
+    checkpoints.empend(0u, 0u);
+
+    auto path_contains = [&](u32 link, u32 checkpoint) {
+        for (; link != 0; link = checkpoints[link].previous) {
+            if (checkpoints[link].checkpoint == checkpoint)
+                return true;
+        }
+        return false;
+    };
+
+    struct PendingNode {
+        u32 instruction_position;
+        u32 checkpoints;
+    };
+    Vector<PendingNode, 16> stack;
+
+    for (auto thread : threads) {
+        if (thread_consumed(thread) != 0) {
+            m_consuming_threads.append(thread);
+            continue;
+        }
+
+        stack.append({ thread_position(thread), 0 });
+        while (!stack.is_empty()) {
+            auto [instruction_position, link] = stack.take_last();
+            if (instruction_position >= m_nodes.size())
+                return true;
+
+            if (m_visited[instruction_position] == m_visit_generation)
+                continue;
+            m_visited[instruction_position] = m_visit_generation;
+
+            auto const& node = m_nodes[instruction_position];
+            auto kind = node.kind;
+            if (kind == Node::Kind::JumpNonEmpty) {
+                // If the Checkpoint was passed since the last consumed code unit, the iteration was empty.
+                kind = path_contains(link, node.argument) ? Node::Kind::Continue : node.non_empty_kind;
+            }
+
+            // The stack is popped from the back, so the preferred alternative is pushed last.
+            switch (kind) {
+            case Node::Kind::Compare:
+            case Node::Kind::CompareString:
+                m_consuming_threads.append(make_thread(instruction_position, 0));
+                break;
+            case Node::Kind::Continue:
+                stack.append({ node.next, link });
+                break;
+            case Node::Kind::Jump:
+                stack.append({ node.target, link });
+                break;
+            case Node::Kind::ForkPreferringTarget:
+                stack.append({ node.next, link });
+                stack.append({ node.target, link });
+                break;
+            case Node::Kind::ForkPreferringNext:
+                stack.append({ node.target, link });
+                stack.append({ node.next, link });
+                break;
+            case Node::Kind::Checkpoint:
+                checkpoints.empend(instruction_position, link);
+                stack.append({ node.next, static_cast<u32>(checkpoints.size() - 1) });
+                break;
+            case Node::Kind::Assertion:
+                if (evaluate(bytecode, input, instruction_position, position))
+                    stack.append({ node.next, link });
+                break;
+            case Node::Kind::Fail:
+                break;
+            case Node::Kind::JumpNonEmpty:
+                VERIFY_NOT_REACHED();
+            }
+        }
+    }
+    return false;
+}
+
+u32 LazyDFA::compute_transition(Automaton& automaton, Search search, u32 state_index, ByteCode const& bytecode, MatchInput const& input, size_t position)
+{
+    auto& state = *automaton.states[state_index];
+    bool matched = compute_closure(state.threads, bytecode, input, position);
+
+    Vector<Thread> next_threads;
+    ++m_visit_generation;
+    auto append_unique = [&](Thread thread) {
+        // Only threads at the start of a compare can show up twice.
+        if (thread_consumed(thread) == 0) {
+            auto& visited = m_visited[thread_position(thread)];
+            if (visited == m_visit_generation)
+                return;
+            visited = m_visit_generation;
+        }
+        next_threads.append(thread);
+    };
+
+    for (auto thread : m_consuming_threads) {
+        auto instruction_position = thread_position(thread);
+        auto const& node = m_nodes[instruction_position];
+
+        if (node.kind == Node::Kind::Compare) {
+            if (evaluate(bytecode, input, instruction_position, position))
+                append_unique(make_thread(node.next, 0));
+            continue;
+        }
+
+        auto consumed = thread_consumed(thread);
+        u32 expected = bytecode.at(instruction_position + 5 + consumed);
+        Optional<DeprecatedString> string_storage;
+        Utf16Data utf16_storage;
+        auto expected_view = input.view.construct_as_same({ &expected, 1 }, string_storage, utf16_storage);
+        auto subject = input.view.substring_view(position, 1);
+        bool equals = (input.regex_options & AllFlags::Insensitive) ? subject.equals_ignoring_case(expected_view) : subject.equals(expected_view);
+        if (!equals)
+            continue;
+        if (consumed + 1 == node.argument)
+            append_unique(make_thread(node.next, 0));
+        else
+            append_unique(make_thread(instruction_position, consumed + 1));
+    }
+
+    // Searching for a match anywhere means a new attempt can start at every position.
+    if (search == Search::Unanchored)
+        append_unique(make_thread(0, 0));
+
+    auto code_unit = input.view[position];
+    auto previous_character = m_uses_previous_character ? classify(code_unit) : PreviousCharacter::None;
+    auto next_index = intern_state(automaton, move(next_threads), previous_character);
+
+    u32 transition = ((next_index + 1) << 1) | (matched ? 1 : 0);
+    if (code_unit < 256)
+        state.transitions[code_unit] = transition;
+    else if (is_cacheable(code_unit))
+        state.wide_transitions.set(code_unit, transition);
+    return transition;
+}
+
+Optional<size_t> LazyDFA::find_match_end(Search search, ByteCode const& bytecode, MatchInput const& input, size_t start, size_t& operations, bool& gave_up)
+{
+    reset_if_options_changed(input.regex_options);
+    auto& automaton = m_automata[to_underlying(search)];
+
+    auto previous_character = PreviousCharacter::None;
+    if (m_uses_previous_character && start > 0)
+        previous_character = classify(input.view[start - 1]);
+    auto state_index = start_state(automaton, previous_character);
+
+    Optional<size_t> match_end;
+    size_t flushes = 0;
+    auto length = input.view.length();
+
+    for (auto position = start;; ++position) {
+        ++operations;
+        auto* state = automaton.states[state_index].ptr();
+
+        if (position == length) {
+            if (!state->matches_at_end.has_value())
+                state->matches_at_end = compute_closure(state->threads, bytecode, input, position);
+            if (*state->matches_at_end)
+                match_end = position;
+            return match_end;
+        }
+
+        auto code_unit = input.view[position];
+        u32 transition = 0;
+        if (code_unit < 256) {
+            transition = state->transitions[code_unit];
+        } else if (auto it = state->wide_transitions.find(code_unit); it != state->wide_transitions.end()) {
+            transition = it->value;
+        }
+
+        if (transition == 0) {
+            if (automaton.states.size() >= c_max_states) {
+                if (++flushes > c_max_flushes_per_search) {
+                    gave_up = true;
+                    return {};
+                }
+                state_index = flush(automaton, state_index);
+            }
+            transition = compute_transition(automaton, search, state_index, bytecode, input, position);
+        }
+
+        if (transition & 1) {
+            match_end = position;
+            if (search == Search::Unanchored)
+                return match_end;
+        }
+
+        state_index = (transition >> 1) - 1;
+        if (automaton.states[state_index]->threads.is_empty())
+            return match_end;
+    }
+}
+
+}
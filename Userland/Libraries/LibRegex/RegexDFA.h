@@ -0,0 +1,138 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include "RegexByteCode.h"
+#include "RegexMatch.h"
+
+#include <AK/Array.h>
+#include <AK/HashMap.h>
+#include <AK/Noncopyable.h>
+#include <AK/NonnullOwnPtr.h>
+#include <AK/Optional.h>
+#include <AK/OwnPtr.h>
+#include <AK/Types.h>
+#include <AK/Vector.h>
+
+namespace regex {
+
+// Runs the bytecode of a pattern as a DFA whose states are built lazily, as the input needs them. Every state is the
+// ordered set of bytecode positions the backtracking Matcher could be at after consuming the same input, so a match
+// is found in a single pass over the input without ever backtracking, and the match it finds is the same one the
+// Matcher would have found.
+// This only works for patterns without backreferences, lookarounds or counted repetitions, and only tells where a
+// match ends; capture groups are still left to the Matcher.
+class LazyDFA {
+    AK_MAKE_NONCOPYABLE(LazyDFA);
+    AK_MAKE_NONMOVABLE(LazyDFA);
+
+public:
+    // Returns null if the bytecode uses anything the DFA can't handle.
+    static OwnPtr<LazyDFA> try_create(ByteCode const&);
+
+    // Whether the DFA understands the code units of this view.
+    static bool can_match(RegexStringView const&);
+
+    enum class Search : u8 {
+        // Finds the match starting at the given position that the Matcher would pick.
+        Anchored,
+        // Finds the earliest position any match starting at or after the given position ends at.
+        Unanchored,
+    };
+
+    // Returns where the match ends, or nothing if there is no match. If the state cache keeps overflowing on this
+    // input, the DFA gives up and sets `gave_up`, and the caller has to fall back to the Matcher.
+    Optional<size_t> find_match_end(Search, ByteCode const&, MatchInput const&, size_t start, size_t& operations, bool& gave_up);
+
+private:
+    // A thread is a bytecode position, and how much of the string compared there has been consumed so far.
+    using Thread = u64;
+
+    struct Node {
+        enum class Kind : u8 {
+            Compare,
+            CompareString,
+            Continue,
+            Jump,
+            ForkPreferringTarget,
+            ForkPreferringNext,
+            Checkpoint,
+            JumpNonEmpty,
+            Assertion,
+            Fail,
+        };
+
+        Kind kind { Kind::Fail };
+        // How a JumpNonEmpty behaves after a non-empty iteration (Jump or one of the Forks).
+        Kind non_empty_kind { Kind::Fail };
+        u32 next { 0 };
+        u32 target { 0 };
+        // The Checkpoint of a JumpNonEmpty, or the length of the string of a CompareString.
+        u32 argument { 0 };
+    };
+
+    // What came before the current position, as far as ^, $, \b and \B are concerned.
+    enum class PreviousCharacter : u8 {
+        None,
+        LineTerminator,
+        WordCharacter,
+        Other,
+    };
+
+    struct State {
+        Vector<Thread> threads;
+        PreviousCharacter previous_character { PreviousCharacter::None };
+
+        // The transitions on the code units below 256, encoded as (next state index + 1) << 1 | matched before
+        // consuming the code unit. Zero means it hasn't been computed yet.
+        Array<u32, 256> transitions {};
+        HashMap<u32, u32> wide_transitions;
+        Optional<bool> matches_at_end;
+    };
+
+    struct StateKey {
+        Vector<Thread> threads;
+        PreviousCharacter previous_character;
+
+        bool operator==(StateKey const&) const = default;
+    };
+
+    struct StateKeyTraits : public GenericTraits<StateKey> {
+        static unsigned hash(StateKey const&);
+    };
+
+    struct Automaton {
+        Vector<NonnullOwnPtr<State>> states;
+        HashMap<StateKey, u32, StateKeyTraits> state_indices;
+        Array<Optional<u32>, 4> start_states;
+    };
+
+    LazyDFA(Vector<Node>, bool uses_previous_character);
+
+    void reset_if_options_changed(AllOptions);
+    u32 start_state(Automaton&, PreviousCharacter);
+    u32 intern_state(Automaton&, Vector<Thread>, PreviousCharacter);
+    u32 flush(Automaton&, u32 state_index);
+    u32 compute_transition(Automaton&, Search, u32 state_index, ByteCode const&, MatchInput const&, size_t position);
+    bool compute_closure(Vector<Thread> const& threads, ByteCode const&, MatchInput const&, size_t position);
+    bool evaluate(ByteCode const&, MatchInput const&, u32 instruction_position, size_t position);
+    static PreviousCharacter classify(u32 code_unit);
+
+    Vector<Node> m_nodes;
+    bool m_uses_previous_character { false };
+
+    Optional<AllOptions> m_options;
+    Array<Automaton, 2> m_automata;
+
+    // Scratch space for computing transitions, kept around to avoid reallocating it.
+    Vector<u32> m_visited;
+    u32 m_visit_generation { 0 };
+    Vector<Thread> m_consuming_threads;
+    MatchState m_scratch_state;
+};
+
+}
@@ -4,9 +4,12 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/BuiltinWrappers.h>
 #include <AK/BumpAllocator.h>
 #include <AK/Debug.h>
 #include <AK/DeprecatedString.h>
+#include <AK/MemMem.h>
+#include <AK/SIMD.h>
 #include <AK/StringBuilder.h>
 #include <LibRegex/RegexMatcher.h>
 #include <LibRegex/RegexParser.h>
@@ -99,6 +102,44 @@ DeprecatedString Regex<Parser>::error_string(Optional<DeprecatedString> message)
     return eb.to_deprecated_string();
 }
 
+// Finds the first of a few bytes, sixteen bytes at a time.
+static Optional<size_t> find_first_of(ReadonlyBytes bytes, size_t start, ReadonlySpan<u8> needles)
+{
+    using AK::SIMD::u64x2;
+    using AK::SIMD::u8x16;
+
+    if (needles.is_empty())
+        return {};
+
+    auto position = start;
+    for (; position + sizeof(u8x16) <= bytes.size(); position += sizeof(u8x16)) {
+        u8x16 chunk;
+        __builtin_memcpy(&chunk, bytes.offset_pointer(position), sizeof(chunk));
+        auto found = chunk == needles[0];
+        for (size_t i = 1; i < needles.size(); ++i)
+            found |= chunk == needles[i];
+        auto found_bits = bit_cast<u64x2>(found);
+        if ((found_bits[0] | found_bits[1]) == 0)
+            continue;
+        auto lane = found_bits[0] != 0 ? count_trailing_zeroes(found_bits[0]) / 8 : 8 + count_trailing_zeroes(found_bits[1]) / 8;
+        return position + lane;
+    }
+    for (; position < bytes.size(); ++position) {
+        if (needles.contains_slow(bytes[position]))
+            return position;
+    }
+    return {};
+}
+
+static Optional<size_t> find_first_in_set(ReadonlyBytes bytes, size_t start, Array<bool, 256> const& set)
+{
+    for (auto position = start; position < bytes.size(); ++position) {
+        if (set[bytes[position]])
+            return position;
+    }
+    return {};
+}
+
 template<typename Parser>
 RegexResult Matcher<Parser>::match(RegexStringView view, Optional<typename ParserTraits<Parser>::OptionsType> regex_options) const
 {
@@ -185,6 +226,84 @@ RegexResult Matcher<Parser>::match(Vector<RegexStringView> const& views, Optiona
 
     auto single_match_only = input.regex_options.has_flag_set(AllFlags::SingleMatch);
 
+    // Patterns the DFA can handle are matched without backtracking. It only finds where matches end though, so if
+    // the capture groups are needed, the backtracking VM still has to run over the match the DFA found.
+    auto* dfa = unicode ? nullptr : lazy_dfa();
+    auto needs_capture_groups = m_pattern->parser_result.capture_groups_count > 0 && !input.regex_options.has_flag_set(AllFlags::SkipSubExprResults);
+    auto& bytecode = m_pattern->parser_result.bytecode;
+
+    auto execute_at = [&](size_t view_index) {
+        if (dfa && LazyDFA::can_match(input.view)) {
+            bool gave_up = false;
+            auto match_end = dfa->find_match_end(LazyDFA::Search::Anchored, bytecode, input, view_index, operations, gave_up);
+            if (!gave_up) {
+                if (!match_end.has_value())
+                    return false;
+                if (!needs_capture_groups) {
+                    state.string_position = *match_end;
+                    state.string_position_in_code_units = *match_end;
+                    return true;
+                }
+            } else {
+                dfa = nullptr;
+            }
+        }
+        return execute(input, state, operations);
+    };
+
+    // When searching for more than one match, first make sure there is one left at all, as looking for it at every
+    // single position is much slower than a single unanchored pass over the input.
+    auto has_match_at_or_after = [&](size_t view_index) {
+        if (!dfa || !continue_search || !LazyDFA::can_match(input.view))
+            return true;
+        bool gave_up = false;
+        auto match_end = dfa->find_match_end(LazyDFA::Search::Unanchored, bytecode, input, view_index, operations, gave_up);
+        return gave_up || match_end.has_value();
+    };
+
+    // What the optimizer found out about every match lets us skip over input that can't contain one, but it only
+    // holds for byte strings matched with the options it was computed for.
+    auto& optimization_data = m_pattern->parser_result.optimization_data;
+    auto can_use_optimization_data = !unicode && optimization_data.applies_to(input.regex_options);
+    Vector<u8, 3> first_byte_list;
+    if (can_use_optimization_data && optimization_data.first_bytes.has_value()) {
+        for (size_t byte = 0; byte < 256 && first_byte_list.size() <= 3; ++byte) {
+            if ((*optimization_data.first_bytes)[byte])
+                first_byte_list.append(byte);
+        }
+    }
+
+    // Returns whether the view still contains the literal every match has to contain from the given position on.
+    auto contains_required_literal = [&](size_t view_index) {
+        auto& literal = optimization_data.required_literal;
+        if (!can_use_optimization_data || literal.is_empty() || !input.view.is_string_view())
+            return true;
+        auto bytes = input.view.string_view().bytes();
+        if (view_index > bytes.size())
+            return true;
+        return AK::memmem_optional(bytes.offset_pointer(view_index), bytes.size() - view_index, literal.characters(), literal.length()).has_value();
+    };
+
+    // Returns the first position at or after the given one that a match could start at, if any.
+    auto next_possible_start = [&](size_t view_index) -> Optional<size_t> {
+        if (!can_use_optimization_data || !input.view.is_string_view())
+            return view_index;
+        auto bytes = input.view.string_view().bytes();
+        if (view_index >= bytes.size())
+            return view_index;
+        if (auto& prefix = optimization_data.literal_prefix; !prefix.is_empty()) {
+            auto offset = AK::memmem_optional(bytes.offset_pointer(view_index), bytes.size() - view_index, prefix.characters(), prefix.length());
+            if (!offset.has_value())
+                return {};
+            return view_index + *offset;
+        }
+        if (!optimization_data.first_bytes.has_value())
+            return view_index;
+        if (first_byte_list.size() <= 3)
+            return find_first_of(bytes, view_index, first_byte_list);
+        return find_first_in_set(bytes, view_index, *optimization_data.first_bytes);
+    };
+
     for (auto const& view : views) {
         if (lines_to_skip != 0) {
             ++input.line;
@@ -231,10 +350,32 @@ RegexResult Matcher<Parser>::match(Vector<RegexStringView> const& views, Optiona
             }
         }
 
+        bool should_look_ahead_for_match = true;
         for (; view_index <= view_length; ++view_index) {
             if (view_index == view_length && input.regex_options.has_flag_set(AllFlags::Multiline))
                 break;
 
+            if (should_look_ahead_for_match) {
+                should_look_ahead_for_match = false;
+                if (!contains_required_literal(view_index)) {
+                    ++m_statistics.views_rejected;
+                    m_statistics.start_positions_skipped += view_length - view_index + 1;
+                    break;
+                }
+                if (!has_match_at_or_after(view_index))
+                    break;
+            }
+
+            if (continue_search) {
+                auto next_start = next_possible_start(view_index);
+                if (!next_start.has_value()) {
+                    m_statistics.start_positions_skipped += view_length - view_index + 1;
+                    break;
+                }
+                m_statistics.start_positions_skipped += *next_start - view_index;
+                view_index = *next_start;
+            }
+
             auto& match_length_minimum = m_pattern->parser_result.match_length_minimum;
             // FIXME: More performant would be to know the remaining minimum string
             //        length needed to match from the current position onwards within
@@ -253,7 +394,8 @@ RegexResult Matcher<Parser>::match(Vector<RegexStringView> const& views, Optiona
             state.instruction_position = 0;
             state.repetition_marks.clear();
 
-            auto success = execute(input, state, operations);
+            ++m_statistics.start_positions_tried;
+            auto success = execute_at(view_index);
             if (success) {
                 succeeded = true;
 
@@ -280,6 +422,7 @@ RegexResult Matcher<Parser>::match(Vector<RegexStringView> const& views, Optiona
                     view_index = state.string_position - (has_zero_length ? 0 : 1);
                     if (single_match_only)
                         break;
+                    should_look_ahead_for_match = true;
                     continue;
                 }
                 if (input.regex_options.has_flag_set(AllFlags::Internal_Stateful)) {
@@ -416,6 +559,16 @@ private:
     Node* m_last { nullptr };
 };
 
+template<class Parser>
+LazyDFA* Matcher<Parser>::lazy_dfa() const
+{
+    if (!m_tried_to_create_lazy_dfa) {
+        m_tried_to_create_lazy_dfa = true;
+        m_lazy_dfa = LazyDFA::try_create(m_pattern->parser_result.bytecode);
+    }
+    return m_lazy_dfa.ptr();
+}
+
 template<class Parser>
 bool Matcher<Parser>::execute(MatchInput const& input, MatchState& state, size_t& operations) const
 {
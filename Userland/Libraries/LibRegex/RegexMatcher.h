@@ -7,6 +7,7 @@
 #pragma once
 
 #include "RegexByteCode.h"
+#include "RegexDFA.h"
 #include "RegexMatch.h"
 #include "RegexOptions.h"
 #include "RegexParser.h"
@@ -72,11 +73,27 @@ public:
         m_pattern = pattern;
     }
 
+    // How many start positions the optimization data of the pattern allowed skipping, over all matches so far.
+    struct Statistics {
+        size_t start_positions_tried { 0 };
+        size_t start_positions_skipped { 0 };
+        // Views that were skipped entirely (from the start position on), as they lack the required literal.
+        size_t views_rejected { 0 };
+    };
+    Statistics const& statistics() const { return m_statistics; }
+
 private:
     bool execute(MatchInput const& input, MatchState& state, size_t& operations) const;
+    LazyDFA* lazy_dfa() const;
 
     Regex<Parser> const* m_pattern;
     typename ParserTraits<Parser>::OptionsType const m_regex_options;
+
+    // Built on first use, if the pattern allows it.
+    mutable OwnPtr<LazyDFA> m_lazy_dfa;
+    mutable bool m_tried_to_create_lazy_dfa { false };
+
+    mutable Statistics m_statistics;
 };
 
 template<class Parser>
@@ -231,6 +248,7 @@ public:
 private:
     void run_optimization_passes();
     void attempt_rewrite_loops_as_atomic_groups(BasicBlockList const&);
+    void fill_optimization_data();
 };
 
 // free standing functions for match, search and has_match
@@ -4,7 +4,10 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/BinarySearch.h>
+#include <AK/CharacterTypes.h>
 #include <AK/Debug.h>
+#include <AK/HashTable.h>
 #include <AK/QuickSort.h>
 #include <AK/RedBlackTree.h>
 #include <AK/Stack.h>
@@ -29,6 +32,9 @@ void Regex<Parser>::run_optimization_passes()
     attempt_rewrite_loops_as_atomic_groups(split_basic_blocks(parser_result.bytecode));
 
     parser_result.bytecode.flatten();
+
+    // Find out what every match has to look like, so the matcher can skip input that can't contain one.
+    fill_optimization_data();
 }
 
 template<typename Parser>
@@ -641,6 +647,345 @@ void Regex<Parser>::attempt_rewrite_loops_as_atomic_groups(BasicBlockList const&
     }
 }
 
+namespace {
+
+// An instruction as far as the optimization data is concerned: where it can go next, and the literal it matches if
+// it's a compare against a fixed string.
+struct LiteralInstruction {
+    size_t position { 0 };
+    size_t next { 0 };
+    Vector<size_t, 2> successors;
+    Optional<DeprecatedString> literal;
+    bool is_compare { false };
+    // Doesn't consume anything, and always continues with the next instruction.
+    bool is_transparent { false };
+};
+
+}
+
+// Returns the instructions of the bytecode, or nothing if it uses an instruction whose effect on the input position
+// isn't known statically.
+static Optional<Vector<LiteralInstruction>> collect_literal_instructions(ByteCode const& bytecode)
+{
+    Vector<LiteralInstruction> instructions;
+    MatchState state;
+    for (size_t position = 0; position < bytecode.size();) {
+        state.instruction_position = position;
+        auto& opcode = bytecode.get_opcode(state);
+        LiteralInstruction instruction;
+        instruction.position = position;
+        instruction.next = position + opcode.size();
+
+        auto jump_target = [&]<typename T>() {
+            return static_cast<size_t>(static_cast<ssize_t>(instruction.next) + static_cast<T const&>(opcode).offset());
+        };
+
+        switch (opcode.opcode_id()) {
+        case OpCodeId::Compare: {
+            auto& compare = static_cast<OpCode_Compare const&>(opcode);
+            instruction.is_compare = true;
+            instruction.successors.append(instruction.next);
+            if (compare.arguments_count() != 1)
+                break;
+            auto type = (CharacterCompareType)bytecode.at(position + 3);
+            StringBuilder builder;
+            if (type == CharacterCompareType::Char) {
+                auto code_point = bytecode.at(position + 4);
+                if (code_point > 0xff)
+                    break;
+                builder.append(static_cast<char>(code_point));
+            } else if (type == CharacterCompareType::String) {
+                auto length = bytecode.at(position + 4);
+                bool is_byte_string = true;
+                for (size_t i = 0; i < length && is_byte_string; ++i) {
+                    auto code_point = bytecode.at(position + 5 + i);
+                    is_byte_string = code_point <= 0xff;
+                    builder.append(static_cast<char>(code_point));
+                }
+                if (!is_byte_string)
+                    break;
+            } else {
+                break;
+            }
+            instruction.literal = builder.to_deprecated_string();
+            break;
+        }
+        case OpCodeId::Jump:
+            instruction.successors.append(jump_target.operator()<OpCode_Jump>());
+            break;
+        case OpCodeId::JumpNonEmpty:
+            instruction.successors.append(instruction.next);
+            instruction.successors.append(jump_target.operator()<OpCode_JumpNonEmpty>());
+            break;
+        case OpCodeId::ForkJump:
+        case OpCodeId::ForkReplaceJump:
+            instruction.successors.append(instruction.next);
+            instruction.successors.append(jump_target.operator()<OpCode_ForkJump>());
+            break;
+        case OpCodeId::ForkStay:
+        case OpCodeId::ForkReplaceStay:
+            instruction.successors.append(instruction.next);
+            instruction.successors.append(jump_target.operator()<OpCode_ForkStay>());
+            break;
+        case OpCodeId::SaveLeftCaptureGroup:
+        case OpCodeId::SaveRightCaptureGroup:
+        case OpCodeId::SaveRightNamedCaptureGroup:
+        case OpCodeId::ClearCaptureGroup:
+        case OpCodeId::Checkpoint:
+        case OpCodeId::CheckBegin:
+        case OpCodeId::CheckEnd:
+        case OpCodeId::CheckBoundary:
+            instruction.is_transparent = true;
+            instruction.successors.append(instruction.next);
+            break;
+        case OpCodeId::Exit:
+            break;
+        case OpCodeId::FailForks:
+        case OpCodeId::Save:
+        case OpCodeId::Restore:
+        case OpCodeId::GoBack:
+        case OpCodeId::Repeat:
+        case OpCodeId::ResetRepeat:
+            return {};
+        }
+
+        instructions.append(move(instruction));
+        position = instructions.last().next;
+    }
+    return instructions;
+}
+
+// Finds the longest run of literal compares that every path to the end of the bytecode goes through back to back.
+static DeprecatedString find_required_literal(Vector<LiteralInstruction> const& instructions, size_t bytecode_size)
+{
+    static constexpr size_t max_analysis_cost = 1 << 20;
+
+    Vector<size_t> index_of_position;
+    index_of_position.ensure_capacity(bytecode_size + 1);
+    for (size_t i = 0; i <= bytecode_size; ++i)
+        index_of_position.unchecked_append(NumericLimits<size_t>::max());
+    for (size_t i = 0; i < instructions.size(); ++i)
+        index_of_position[instructions[i].position] = i;
+    index_of_position[bytecode_size] = instructions.size();
+
+    auto index_of = [&](size_t position) {
+        if (position > bytecode_size)
+            return instructions.size();
+        return index_of_position[position];
+    };
+
+    Vector<size_t> predecessor_counts;
+    predecessor_counts.resize(instructions.size() + 1);
+    predecessor_counts[0] = 1;
+    for (auto& instruction : instructions) {
+        for (auto successor : instruction.successors) {
+            auto index = index_of(successor);
+            if (index == NumericLimits<size_t>::max())
+                return DeprecatedString::empty();
+            ++predecessor_counts[index];
+        }
+    }
+
+    size_t literal_count = 0;
+    for (auto& instruction : instructions)
+        literal_count += instruction.literal.has_value() ? 1 : 0;
+    if (literal_count * instructions.size() > max_analysis_cost)
+        return DeprecatedString::empty();
+
+    // An instruction is mandatory if the end can't be reached without it.
+    Vector<bool> visited;
+    Vector<size_t> worklist;
+    auto is_mandatory = [&](size_t excluded_index) {
+        visited.clear_with_capacity();
+        visited.resize(instructions.size() + 1);
+        worklist.clear_with_capacity();
+        worklist.append(0);
+        visited[0] = true;
+        while (!worklist.is_empty()) {
+            auto index = worklist.take_last();
+            if (index == instructions.size())
+                return false;
+            if (index == excluded_index)
+                continue;
+            for (auto successor : instructions[index].successors) {
+                auto successor_index = index_of(successor);
+                if (!visited[successor_index]) {
+                    visited[successor_index] = true;
+                    worklist.append(successor_index);
+                }
+            }
+        }
+        return true;
+    };
+
+    Vector<bool> mandatory;
+    mandatory.resize(instructions.size());
+    for (size_t i = 0; i < instructions.size(); ++i)
+        mandatory[i] = instructions[i].literal.has_value() && is_mandatory(i);
+
+    auto longest_literal = DeprecatedString::empty();
+    Vector<bool> is_continuation;
+    is_continuation.resize(instructions.size());
+    for (size_t i = 0; i < instructions.size(); ++i) {
+        if (!mandatory[i] || is_continuation[i])
+            continue;
+
+        // Whatever can only be reached through the end of a mandatory literal directly continues it, as long as
+        // nothing in between consumes anything.
+        StringBuilder builder;
+        builder.append(*instructions[i].literal);
+        for (auto index = index_of(instructions[i].next); index < instructions.size() && predecessor_counts[index] == 1;) {
+            auto& instruction = instructions[index];
+            if (instruction.is_transparent) {
+                index = index_of(instruction.next);
+                continue;
+            }
+            if (!mandatory[index])
+                break;
+            builder.append(*instruction.literal);
+            is_continuation[index] = true;
+            index = index_of(instruction.next);
+        }
+
+        if (builder.length() > longest_literal.length())
+            longest_literal = builder.to_deprecated_string();
+    }
+    return longest_literal;
+}
+
+// Finds the literal that the first path through the bytecode matches before it first branches.
+static DeprecatedString find_literal_prefix(Vector<LiteralInstruction> const& instructions)
+{
+    StringBuilder builder;
+    for (auto& instruction : instructions) {
+        if (instruction.literal.has_value()) {
+            builder.append(*instruction.literal);
+            continue;
+        }
+        if (!instruction.is_transparent)
+            break;
+    }
+    return builder.to_deprecated_string();
+}
+
+// Finds the bytes a match can start with, by trying every byte on every compare that can come first.
+static Optional<Array<bool, 256>> find_first_bytes(Vector<LiteralInstruction> const& instructions, ByteCode const& bytecode, AllOptions options)
+{
+    if (options.has_flag_set(AllFlags::Unicode))
+        return {};
+
+    HashTable<size_t> visited;
+    Vector<size_t> worklist;
+    Vector<size_t> compare_positions;
+    // Lowercased if the pattern ignores case.
+    Vector<u8> first_string_characters;
+    auto ignore_case = options.has_flag_set(AllFlags::Insensitive);
+    worklist.append(0);
+    visited.set(0);
+
+    auto find_instruction = [&](size_t position) {
+        return binary_search(instructions, position, nullptr, [](size_t position, LiteralInstruction const& instruction) {
+            return position < instruction.position ? -1 : (position > instruction.position ? 1 : 0);
+        });
+    };
+
+    MatchState state;
+    while (!worklist.is_empty()) {
+        auto position = worklist.take_last();
+        auto* instruction = find_instruction(position);
+        // A match could end without consuming anything, so it can start with any byte.
+        if (!instruction)
+            return {};
+        if (instruction->is_compare) {
+            state.instruction_position = position;
+            auto& compare = static_cast<OpCode_Compare const&>(bytecode.get_opcode(state));
+            // Strings don't fit in a single byte view, so only their first character is looked at.
+            if (compare.arguments_count() == 1 && (CharacterCompareType)bytecode.at(position + 3) == CharacterCompareType::String) {
+                if (bytecode.at(position + 4) == 0 || bytecode.at(position + 5) > 0xff)
+                    return {};
+                auto character = static_cast<u8>(bytecode.at(position + 5));
+                first_string_characters.append(ignore_case ? to_ascii_lowercase(character) : character);
+                continue;
+            }
+            for (auto& [type, value] : compare.flat_compares()) {
+                if (type == CharacterCompareType::Reference || type == CharacterCompareType::String)
+                    return {};
+            }
+            compare_positions.append(position);
+            continue;
+        }
+        for (auto successor : instruction->successors) {
+            if (visited.set(successor) == HashSetResult::InsertedNewEntry)
+                worklist.append(successor);
+        }
+    }
+
+    Array<bool, 256> first_bytes {};
+    size_t first_byte_count = 0;
+    MatchInput input;
+    input.regex_options = options;
+    for (size_t byte = 0; byte < 256; ++byte) {
+        if (first_string_characters.contains_slow(static_cast<u8>(ignore_case ? to_ascii_lowercase(byte) : byte))) {
+            first_bytes[byte] = true;
+            ++first_byte_count;
+            continue;
+        }
+        char character = static_cast<char>(byte);
+        input.view = StringView { &character, 1 };
+        for (auto position : compare_positions) {
+            state.instruction_position = position;
+            state.string_position = 0;
+            state.string_position_in_code_units = 0;
+            auto& opcode = bytecode.get_opcode(state);
+            if (opcode.execute(input, state) == ExecutionResult::Continue && state.string_position == 1) {
+                first_bytes[byte] = true;
+                ++first_byte_count;
+                break;
+            }
+        }
+    }
+
+    if (first_byte_count == 256)
+        return {};
+    return first_bytes;
+}
+
+template<typename Parser>
+void Regex<Parser>::fill_optimization_data()
+{
+    auto& data = parser_result.optimization_data;
+    data = {};
+    data.options = parser_result.options;
+
+    if (parser_result.error != Error::NoError)
+        return;
+
+    auto& bytecode = parser_result.bytecode;
+    auto instructions = collect_literal_instructions(bytecode);
+    if (!instructions.has_value())
+        return;
+
+    // The literals are compared byte for byte, which doesn't work if the pattern ignores case.
+    if (!data.options.has_flag_set(AllFlags::Insensitive)) {
+        data.literal_prefix = find_literal_prefix(*instructions);
+        data.required_literal = find_required_literal(*instructions, bytecode.size());
+    }
+    if (data.literal_prefix.is_empty())
+        data.first_bytes = find_first_bytes(*instructions, bytecode, data.options);
+
+    dbgln_if(REGEX_DEBUG, "Optimization data: prefix='{}' required='{}' first bytes: {}", data.literal_prefix, data.required_literal, data.first_bytes.has_value());
+}
+
+bool OptimizationData::applies_to(AllOptions options) const
+{
+    // These change what the compares match.
+    for (auto flag : { AllFlags::Insensitive, AllFlags::SingleLine, AllFlags::Unicode, AllFlags::Internal_ConsiderNewline, AllFlags::Internal_ECMA262DotSemantics }) {
+        if (options.has_flag_set(flag) != this->options.has_flag_set(flag))
+            return false;
+    }
+    return true;
+}
+
 void Optimizer::append_alternation(ByteCode& target, ByteCode&& left, ByteCode&& right)
 {
     Array<ByteCode, 2> alternatives;
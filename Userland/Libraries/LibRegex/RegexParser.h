@@ -11,7 +11,10 @@
 #include "RegexLexer.h"
 #include "RegexOptions.h"
 
+#include <AK/Array.h>
+#include <AK/DeprecatedString.h>
 #include <AK/Forward.h>
+#include <AK/Optional.h>
 #include <AK/StringBuilder.h>
 #include <AK/Types.h>
 #include <AK/Vector.h>
@@ -44,6 +47,21 @@ template<>
 struct ParserTraits<ECMA262Parser> : public GenericParserTraits<ECMAScriptOptions> {
 };
 
+// What the optimizer found out about every possible match of a pattern, so the Matcher can skip over input that can't
+// contain one before starting the VM.
+struct OptimizationData {
+    // Every match starts with this.
+    DeprecatedString literal_prefix;
+    // Every match contains this.
+    DeprecatedString required_literal;
+    // Every match starts with one of these bytes.
+    Optional<Array<bool, 256>> first_bytes;
+    // The options the above was computed for; it only holds for views matched with the same ones.
+    AllOptions options;
+
+    bool applies_to(AllOptions) const;
+};
+
 class Parser {
 public:
     struct Result {
@@ -55,6 +73,7 @@ public:
         Token error_token;
         Vector<DeprecatedFlyString> capture_groups;
         AllOptions options;
+        OptimizationData optimization_data;
     };
 
     explicit Parser(Lexer& lexer)
@@ -363,6 +363,8 @@ inline JSFileResult TestRunner::run_file_test(DeprecatedString const& test_path)
     if (g_run_bytecode) {
         auto executable = MUST(JS::Bytecode::Generator::generate(test_script->parse_node()));
         executable->name = test_path;
+        if (JS::Bytecode::g_optimize_bytecode)
+            JS::Bytecode::Interpreter::optimization_pipeline(JS::Bytecode::Interpreter::OptimizationLevel::Optimize).perform(*executable);
         if (JS::Bytecode::g_dump_bytecode)
             executable->dump();
         JS::Bytecode::Interpreter bytecode_interpreter(interpreter->realm());
@@ -382,6 +384,8 @@ inline JSFileResult TestRunner::run_file_test(DeprecatedString const& test_path)
         if (!executable_result.is_error()) {
             auto executable = executable_result.release_value();
             executable->name = test_path;
+            if (JS::Bytecode::g_optimize_bytecode)
+                JS::Bytecode::Interpreter::optimization_pipeline(JS::Bytecode::Interpreter::OptimizationLevel::Optimize).perform(*executable);
             if (JS::Bytecode::g_dump_bytecode)
                 executable->dump();
             JS::Bytecode::Interpreter bytecode_interpreter(interpreter->realm());
@@ -120,6 +120,9 @@ int main(int argc, char** argv)
     args_parser.add_option(g_collect_on_every_allocation, "Collect garbage after every allocation", "collect-often", 'g');
     args_parser.add_option(g_run_bytecode, "Use the bytecode interpreter", "run-bytecode", 'b');
     args_parser.add_option(JS::Bytecode::g_dump_bytecode, "Dump the bytecode", "dump-bytecode", 'd');
+    args_parser.add_option(JS::Bytecode::g_use_jit, "Compile the bytecode to native code (x86_64 only)", "jit", 0);
+    args_parser.add_option(JS::Bytecode::g_optimize_bytecode, "Optimize the bytecode", "optimize-bytecode", 0);
+    args_parser.add_option(JS::Bytecode::g_dump_instruction_counts, "Dump instruction counts before and after optimization", "dump-instruction-counts", 0);
     args_parser.add_option(test_glob, "Only run tests matching the given glob", "filter", 'f', "glob");
     for (auto& entry : g_extra_args)
         args_parser.add_option(*entry.key, entry.value.get<0>().characters(), entry.value.get<1>().characters(), entry.value.get<2>());
@@ -141,6 +144,16 @@ int main(int argc, char** argv)
         return 1;
     }
 
+    if (JS::Bytecode::g_use_jit && !g_run_bytecode) {
+        warnln("--jit can only be used when --run-bytecode is specified.");
+        return 1;
+    }
+
+    if (JS::Bytecode::g_optimize_bytecode && !g_run_bytecode) {
+        warnln("--optimize-bytecode can only be used when --run-bytecode is specified.");
+        return 1;
+    }
+
     DeprecatedString test_root;
 
     if (!specified_test_root.is_empty()) {
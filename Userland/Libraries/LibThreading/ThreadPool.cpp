@@ -0,0 +1,115 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibThreading/ThreadPool.h>
+
+namespace Threading {
+
+static thread_local size_t s_running_job_count { 0 };
+
+bool ThreadPool::is_running_a_job_on_current_thread()
+{
+    return s_running_job_count > 0;
+}
+
+void ThreadPool::run_job(Function<void(size_t)> const& job, size_t index)
+{
+    ++s_running_job_count;
+    job(index);
+    --s_running_job_count;
+}
+
+ErrorOr<NonnullOwnPtr<ThreadPool>> ThreadPool::try_create(size_t thread_count, StringView thread_name)
+{
+    auto pool = TRY(adopt_nonnull_own_or_enomem(new (nothrow) ThreadPool));
+    TRY(pool->m_threads.try_ensure_capacity(thread_count));
+    for (size_t i = 0; i < thread_count; ++i) {
+        auto thread = TRY(Thread::try_create([pool = pool.ptr()] { return pool->worker_main(); }, thread_name));
+        thread->start();
+        pool->m_threads.unchecked_append(move(thread));
+    }
+    return pool;
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        MutexLocker locker(m_mutex);
+        m_exiting = true;
+        m_work_available.broadcast();
+    }
+    for (auto& thread : m_threads)
+        (void)thread->join();
+}
+
+void ThreadPool::for_each(size_t job_count, Function<void(size_t)> const& job)
+{
+    if (job_count == 0)
+        return;
+
+    if (m_threads.is_empty() || job_count == 1) {
+        for (size_t i = 0; i < job_count; ++i)
+            run_job(job, i);
+        return;
+    }
+
+    {
+        MutexLocker locker(m_mutex);
+        m_job = &job;
+        m_job_count = job_count;
+        m_next_job_index = 0;
+        ++m_generation;
+        m_work_available.broadcast();
+    }
+
+    run_jobs(job, job_count);
+
+    MutexLocker locker(m_mutex);
+    // Threads only pick up the job while it's set, so once none of them are busy, nothing can call it anymore.
+    while (m_busy_threads > 0)
+        m_work_done.wait();
+    m_job = nullptr;
+}
+
+void ThreadPool::run_jobs(Function<void(size_t)> const& job, size_t job_count)
+{
+    for (;;) {
+        auto index = m_next_job_index.fetch_add(1);
+        if (index >= job_count)
+            return;
+        run_job(job, index);
+    }
+}
+
+intptr_t ThreadPool::worker_main()
+{
+    u64 seen_generation = 0;
+    for (;;) {
+        Function<void(size_t)> const* job = nullptr;
+        size_t job_count = 0;
+        {
+            MutexLocker locker(m_mutex);
+            while (!m_exiting && (m_generation == seen_generation || !m_job)) {
+                seen_generation = m_generation;
+                m_work_available.wait();
+            }
+            if (m_exiting)
+                return 0;
+            seen_generation = m_generation;
+            job = m_job;
+            job_count = m_job_count;
+            ++m_busy_threads;
+        }
+
+        run_jobs(*job, job_count);
+
+        MutexLocker locker(m_mutex);
+        if (--m_busy_threads == 0)
+            m_work_done.broadcast();
+    }
+}
+
+}
@@ -0,0 +1,63 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Atomic.h>
+#include <AK/Function.h>
+#include <AK/NonnullOwnPtr.h>
+#include <AK/Vector.h>
+#include <LibThreading/ConditionVariable.h>
+#include <LibThreading/Mutex.h>
+#include <LibThreading/Thread.h>
+
+namespace Threading {
+
+// A fixed set of threads for splitting up work that the caller has to wait for anyway, like painting the tiles of a
+// frame. The calling thread runs jobs too while it waits, so a pool without any threads just runs everything inline.
+class ThreadPool {
+    AK_MAKE_NONCOPYABLE(ThreadPool);
+    AK_MAKE_NONMOVABLE(ThreadPool);
+
+public:
+    static ErrorOr<NonnullOwnPtr<ThreadPool>> try_create(size_t thread_count, StringView thread_name = "ThreadPool"sv);
+    ~ThreadPool();
+
+    // The number of jobs that can run at the same time, counting the calling thread.
+    size_t concurrency() const { return m_threads.size() + 1; }
+
+    // Calls `job` once for each index below `job_count`, and returns once all of those calls have returned. The calls
+    // happen in no particular order, and on several threads at the same time.
+    void for_each(size_t job_count, Function<void(size_t)> const& job);
+
+    // Whether the calling thread is in the middle of a job of any pool. Splitting that job up further would only make
+    // the threads of the pools fight over the same processors.
+    static bool is_running_a_job_on_current_thread();
+
+private:
+    ThreadPool() = default;
+
+    intptr_t worker_main();
+    void run_jobs(Function<void(size_t)> const& job, size_t job_count);
+    static void run_job(Function<void(size_t)> const& job, size_t index);
+
+    Vector<NonnullRefPtr<Thread>> m_threads;
+
+    Mutex m_mutex;
+    ConditionVariable m_work_available { m_mutex };
+    ConditionVariable m_work_done { m_mutex };
+
+    // These are guarded by m_mutex.
+    Function<void(size_t)> const* m_job { nullptr };
+    size_t m_job_count { 0 };
+    u64 m_generation { 0 };
+    size_t m_busy_threads { 0 };
+    bool m_exiting { false };
+
+    Atomic<size_t> m_next_job_index { 0 };
+};
+
+}
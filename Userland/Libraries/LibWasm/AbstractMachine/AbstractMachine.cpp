@@ -13,14 +13,14 @@
 
 namespace Wasm {
 
-Optional<FunctionAddress> Store::allocate(ModuleInstance& module, Module::Function const& function)
+Optional<FunctionAddress> Store::allocate(ModuleInstance& module, Module::Function const& function, RefPtr<PrecompiledFunction const> precompiled)
 {
     FunctionAddress address { m_functions.size() };
     if (function.type().value() > module.types().size())
         return {};
 
     auto& type = module.types()[function.type().value()];
-    m_functions.empend(WasmFunction { type, module, function });
+    m_functions.empend(WasmFunction { type, module, function, move(precompiled) });
     return address;
 }
 
@@ -43,7 +43,7 @@ Optional<TableAddress> Store::allocate(TableType const& type)
 Optional<MemoryAddress> Store::allocate(MemoryType const& type)
 {
     MemoryAddress address { m_memories.size() };
-    auto instance = MemoryInstance::create(type);
+    auto instance = MemoryInstance::create(type, m_memory_backing);
     if (instance.is_error())
         return {};
 
@@ -51,6 +51,42 @@ Optional<MemoryAddress> Store::allocate(MemoryType const& type)
     return address;
 }
 
+bool MemoryInstance::grow(size_t size_to_grow, InhibitGrowCallback inhibit_callback)
+{
+    if (size_to_grow == 0)
+        return true;
+    // Everything up to the end of the accessible pages has to be in bounds, as nothing checks for accesses past the end.
+    if (m_guarded_memory.has_value())
+        size_to_grow = align_up_to(size_to_grow, Constants::page_size);
+    u64 new_size = m_size + size_to_grow;
+    // Can't grow past 2^16 pages.
+    if (new_size >= Constants::page_size * 65536)
+        return false;
+    if (auto max = m_type.limits().max(); max.has_value()) {
+        if (max.value() * Constants::page_size < new_size)
+            return false;
+    }
+    auto previous_size = m_size;
+    if (m_guarded_memory.has_value()) {
+        // Newly accessible pages are already zeroed, and nothing has to move.
+        if (m_guarded_memory->make_accessible(new_size).is_error())
+            return false;
+    } else {
+        if (m_data.try_resize(new_size).is_error())
+            return false;
+        // The spec requires that we zero out everything on grow
+        __builtin_memset(m_data.offset_pointer(previous_size), 0, size_to_grow);
+    }
+    m_size = new_size;
+
+    // NOTE: This exists because wasm-js-api wants to execute code after a successful grow,
+    //       See [this issue](https://github.com/WebAssembly/spec/issues/1635) for more details.
+    if (inhibit_callback == InhibitGrowCallback::No && successful_grow_hook)
+        successful_grow_hook();
+
+    return true;
+}
+
 Optional<GlobalAddress> Store::allocate(GlobalType const& type, Value value)
 {
     GlobalAddress address { m_globals.size() };
@@ -355,7 +391,7 @@ InstantiationResult AbstractMachine::instantiate(Module const& module, Vector<Ex
                         }
                         if (instance->size() < data.init.size() + offset)
                             instance->grow(data.init.size() + offset - instance->size());
-                        instance->data().overwrite(offset, data.init.data(), data.init.size());
+                        instance->bytes().overwrite(offset, data.init.data(), data.init.size());
                     }
                 },
                 [&](DataSection::Data::Passive const& passive) {
@@ -399,8 +435,10 @@ Optional<InstantiationError> AbstractMachine::allocate_all_initial_phase(Module
 
     // FIXME: What if this fails?
 
+    // The module has been validated by now, so its functions can be lowered into the register-based form.
+    auto precompile_context = PrecompiledFunction::ModuleContext::create(module);
     for (auto& func : module.functions()) {
-        auto address = m_store.allocate(module_instance, func);
+        auto address = m_store.allocate(module_instance, func, PrecompiledFunction::try_create(precompile_context, func));
         VERIFY(address.has_value());
         module_instance.functions().append(*address);
     }
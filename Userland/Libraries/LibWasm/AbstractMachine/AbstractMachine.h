@@ -11,6 +11,8 @@
 #include <AK/HashTable.h>
 #include <AK/OwnPtr.h>
 #include <AK/Result.h>
+#include <LibWasm/AbstractMachine/GuardedMemory.h>
+#include <LibWasm/AbstractMachine/PrecompiledFunction.h>
 #include <LibWasm/Types.h>
 
 // NOTE: Special case for Wasm::Result.
@@ -312,21 +314,24 @@ private:
 
 class WasmFunction {
 public:
-    explicit WasmFunction(FunctionType const& type, ModuleInstance const& module, Module::Function const& code)
+    explicit WasmFunction(FunctionType const& type, ModuleInstance const& module, Module::Function const& code, RefPtr<PrecompiledFunction const> precompiled = nullptr)
         : m_type(type)
         , m_module(module)
         , m_code(code)
+        , m_precompiled(move(precompiled))
     {
     }
 
     auto& type() const { return m_type; }
     auto& module() const { return m_module; }
     auto& code() const { return m_code; }
+    PrecompiledFunction const* precompiled() const { return m_precompiled.ptr(); }
 
 private:
     FunctionType m_type;
     ModuleInstance const& m_module;
     Module::Function const& m_code;
+    RefPtr<PrecompiledFunction const> m_precompiled;
 };
 
 class HostFunction {
@@ -383,10 +388,19 @@ private:
 
 class MemoryInstance {
 public:
-    static ErrorOr<MemoryInstance> create(MemoryType const& type)
+    enum class Backing {
+        ByteBuffer,
+        // Out-of-bounds accesses fault, see GuardedMemory. Falls back to a ByteBuffer where that isn't supported.
+        GuardPages,
+    };
+
+    static ErrorOr<MemoryInstance> create(MemoryType const& type, Backing backing = Backing::ByteBuffer)
     {
         MemoryInstance instance { type };
 
+        if (backing == Backing::GuardPages && GuardedMemory::is_supported())
+            instance.m_guarded_memory = TRY(GuardedMemory::create());
+
         if (!instance.grow(type.limits().min() * Constants::page_size))
             return Error::from_string_literal("Failed to grow to requested size");
 
@@ -395,40 +409,30 @@ public:
 
     auto& type() const { return m_type; }
     auto size() const { return m_size; }
-    auto& data() const { return m_data; }
-    auto& data() { return m_data; }
+
+    Bytes bytes() { return { data_pointer(), m_size }; }
+    ReadonlyBytes bytes() const { return { data_pointer(), m_size }; }
+
+    // Only memories backed by a ByteBuffer can hand it out, e.g. to be shared with an ArrayBuffer.
+    auto& data() const
+    {
+        VERIFY(!m_guarded_memory.has_value());
+        return m_data;
+    }
+    auto& data()
+    {
+        VERIFY(!m_guarded_memory.has_value());
+        return m_data;
+    }
+
+    GuardedMemory const* guarded_memory() const { return m_guarded_memory.has_value() ? &*m_guarded_memory : nullptr; }
 
     enum class InhibitGrowCallback {
         No,
         Yes,
     };
 
-    bool grow(size_t size_to_grow, InhibitGrowCallback inhibit_callback = InhibitGrowCallback::No)
-    {
-        if (size_to_grow == 0)
-            return true;
-        u64 new_size = m_data.size() + size_to_grow;
-        // Can't grow past 2^16 pages.
-        if (new_size >= Constants::page_size * 65536)
-            return false;
-        if (auto max = m_type.limits().max(); max.has_value()) {
-            if (max.value() * Constants::page_size < new_size)
-                return false;
-        }
-        auto previous_size = m_size;
-        if (m_data.try_resize(new_size).is_error())
-            return false;
-        m_size = new_size;
-        // The spec requires that we zero out everything on grow
-        __builtin_memset(m_data.offset_pointer(previous_size), 0, size_to_grow);
-
-        // NOTE: This exists because wasm-js-api wants to execute code after a successful grow,
-        //       See [this issue](https://github.com/WebAssembly/spec/issues/1635) for more details.
-        if (inhibit_callback == InhibitGrowCallback::No && successful_grow_hook)
-            successful_grow_hook();
-
-        return true;
-    }
+    bool grow(size_t size_to_grow, InhibitGrowCallback inhibit_callback = InhibitGrowCallback::No);
 
     Function<void()> successful_grow_hook;
 
@@ -438,9 +442,12 @@ private:
     {
     }
 
+    u8* data_pointer() const { return m_guarded_memory.has_value() ? m_guarded_memory->data() : const_cast<u8*>(m_data.data()); }
+
     MemoryType const& m_type;
     size_t m_size { 0 };
     ByteBuffer m_data;
+    Optional<GuardedMemory> m_guarded_memory;
 };
 
 class GlobalInstance {
@@ -501,7 +508,7 @@ class Store {
 public:
     Store() = default;
 
-    Optional<FunctionAddress> allocate(ModuleInstance& module, Module::Function const& function);
+    Optional<FunctionAddress> allocate(ModuleInstance& module, Module::Function const& function, RefPtr<PrecompiledFunction const> precompiled = nullptr);
     Optional<FunctionAddress> allocate(HostFunction&&);
     Optional<TableAddress> allocate(TableType const&);
     Optional<MemoryAddress> allocate(MemoryType const&);
@@ -516,6 +523,8 @@ public:
     DataInstance* get(DataAddress);
     ElementInstance* get(ElementAddress);
 
+    void set_memory_backing(MemoryInstance::Backing backing) { m_memory_backing = backing; }
+
 private:
     Vector<FunctionInstance> m_functions;
     Vector<TableInstance> m_tables;
@@ -523,6 +532,7 @@ private:
     Vector<GlobalInstance> m_globals;
     Vector<ElementInstance> m_elements;
     Vector<DataInstance> m_datas;
+    MemoryInstance::Backing m_memory_backing { MemoryInstance::Backing::ByteBuffer };
 };
 
 class Label {
@@ -543,11 +553,12 @@ private:
 
 class Frame {
 public:
-    explicit Frame(ModuleInstance const& module, Vector<Value> locals, Expression const& expression, size_t arity)
+    explicit Frame(ModuleInstance const& module, Vector<Value> locals, Expression const& expression, size_t arity, PrecompiledFunction const* precompiled_function = nullptr)
         : m_module(module)
         , m_locals(move(locals))
         , m_expression(expression)
         , m_arity(arity)
+        , m_precompiled_function(precompiled_function)
     {
     }
 
@@ -556,12 +567,14 @@ public:
     auto& locals() { return m_locals; }
     auto& expression() const { return m_expression; }
     auto arity() const { return m_arity; }
+    auto precompiled_function() const { return m_precompiled_function; }
 
 private:
     ModuleInstance const& m_module;
     Vector<Value> m_locals;
     Expression const& m_expression;
     size_t m_arity { 0 };
+    PrecompiledFunction const* m_precompiled_function { nullptr };
 };
 
 class Stack {
@@ -600,6 +613,9 @@ public:
     auto& store() { return m_store; }
 
     void enable_instruction_count_limit() { m_should_limit_instruction_count = true; }
+    // Memories allocated from now on rely on guard pages rather than bounds checks where possible.
+    // Their contents can't be shared through MemoryInstance::data().
+    void enable_guard_page_backed_memories() { m_store.set_memory_backing(MemoryInstance::Backing::GuardPages); }
 
 private:
     Optional<InstantiationError> allocate_all_initial_phase(Module const&, ModuleInstance&, Vector<ExternValue>&, Vector<Value>& global_values);
@@ -35,6 +35,12 @@ namespace Wasm {
 void BytecodeInterpreter::interpret(Configuration& configuration)
 {
     m_trap = Empty {};
+    if (auto const* precompiled_function = configuration.frame().precompiled_function(); precompiled_function && may_run_precompiled_code()) {
+        // The precompiled form doesn't count instructions, so leave limited executions to the stack-based interpreter.
+        if (!configuration.should_limit_instruction_count())
+            return interpret_precompiled(configuration, *precompiled_function);
+    }
+
     auto& instructions = configuration.frame().expression().instructions();
     auto max_ip_value = InstructionPointer { instructions.size() };
     auto& current_ip_value = configuration.ip();
@@ -106,7 +112,7 @@ void BytecodeInterpreter::load_and_push(Configuration& configuration, Instructio
         return;
     }
     dbgln_if(WASM_TRACE_DEBUG, "load({} : {}) -> stack", instance_address, sizeof(ReadType));
-    auto slice = memory->data().bytes().slice(instance_address, sizeof(ReadType));
+    auto slice = memory->bytes().slice(instance_address, sizeof(ReadType));
     configuration.stack().peek() = Value(static_cast<PushType>(read_value<ReadType>(slice)));
 }
 
@@ -250,7 +256,7 @@ void BytecodeInterpreter::store_to_memory(Configuration& configuration, Instruct
         return;
     }
     dbgln_if(WASM_TRACE_DEBUG, "temporary({}b) -> store({})", data.size(), instance_address);
-    data.copy_to(memory->data().bytes().slice(instance_address, data.size()));
+    data.copy_to(memory->bytes().slice(instance_address, data.size()));
 }
 
 template<typename T>
@@ -627,7 +633,7 @@ void BytecodeInterpreter::interpret(Configuration& configuration, InstructionPoi
         auto value = configuration.stack().pop().get<Value>().to<i32>().value();
         auto destination_offset = configuration.stack().pop().get<Value>().to<i32>().value();
 
-        TRAP_IF_NOT(static_cast<size_t>(destination_offset + count) <= instance->data().size());
+        TRAP_IF_NOT(static_cast<size_t>(destination_offset + count) <= instance->size());
 
         if (count == 0)
             return;
@@ -650,8 +656,8 @@ void BytecodeInterpreter::interpret(Configuration& configuration, InstructionPoi
         auto source_offset = configuration.stack().pop().get<Value>().to<i32>().value();
         auto destination_offset = configuration.stack().pop().get<Value>().to<i32>().value();
 
-        TRAP_IF_NOT(static_cast<size_t>(source_offset + count) <= instance->data().size());
-        TRAP_IF_NOT(static_cast<size_t>(destination_offset + count) <= instance->data().size());
+        TRAP_IF_NOT(static_cast<size_t>(source_offset + count) <= instance->size());
+        TRAP_IF_NOT(static_cast<size_t>(destination_offset + count) <= instance->size());
 
         if (count == 0)
             return;
@@ -663,12 +669,12 @@ void BytecodeInterpreter::interpret(Configuration& configuration, InstructionPoi
 
         if (destination_offset <= source_offset) {
             for (auto i = 0; i < count; ++i) {
-                auto value = instance->data()[source_offset + i];
+                auto value = instance->bytes()[source_offset + i];
                 store_to_memory(configuration, synthetic_store_instruction, { &value, sizeof(value) }, destination_offset + i);
             }
         } else {
             for (auto i = count - 1; i >= 0; --i) {
-                auto value = instance->data()[source_offset + i];
+                auto value = instance->bytes()[source_offset + i];
                 store_to_memory(configuration, synthetic_store_instruction, { &value, sizeof(value) }, destination_offset + i);
             }
         }
@@ -9,6 +9,7 @@
 #include <AK/StackInfo.h>
 #include <LibWasm/AbstractMachine/Configuration.h>
 #include <LibWasm/AbstractMachine/Interpreter.h>
+#include <LibWasm/AbstractMachine/PrecompiledFunction.h>
 
 namespace Wasm {
 
@@ -40,6 +41,15 @@ struct BytecodeInterpreter : public Interpreter {
 
 protected:
     virtual void interpret(Configuration&, InstructionPointer&, Instruction const&);
+
+    // Interpreters that need to observe each instruction of a function body must not run the precompiled form instead.
+    virtual bool may_run_precompiled_code() const { return true; }
+    void interpret_precompiled(Configuration&, PrecompiledFunction const&);
+    Optional<u32> run_precompiled(Configuration&, ModuleInstance const&, PrecompiledFunction const&, size_t window_base);
+    template<bool memory_is_guarded>
+    Optional<u32> execute_precompiled(Configuration&, ModuleInstance const&, Optional<MemoryAddress>, PrecompiledFunction const&, size_t window_base);
+    bool call_from_precompiled(Configuration&, FunctionAddress, size_t arguments_base);
+
     void branch_to_label(Configuration&, LabelIndex);
     template<typename ReadT, typename PushT>
     void load_and_push(Configuration&, Instruction const&);
@@ -73,6 +83,8 @@ protected:
 
     Variant<Trap, JS::Completion, Empty> m_trap;
     StackInfo m_stack_info;
+    // Slots of all active precompiled function invocations, each one getting a window starting after its caller's.
+    Vector<u64> m_precompiled_slots;
 };
 
 struct DebuggerBytecodeInterpreter : public BytecodeInterpreter {
@@ -83,6 +95,7 @@ struct DebuggerBytecodeInterpreter : public BytecodeInterpreter {
 
 private:
     virtual void interpret(Configuration&, InstructionPointer&, Instruction const&) override;
+    virtual bool may_run_precompiled_code() const override { return false; }
 };
 
 }
@@ -0,0 +1,122 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Platform.h>
+#include <AK/StdLibExtras.h>
+#include <LibWasm/AbstractMachine/GuardedMemory.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace Wasm {
+
+static thread_local GuardedMemory::TrapScope* s_innermost_trap_scope { nullptr };
+
+static struct sigaction s_previous_segv_action;
+static struct sigaction s_previous_bus_action;
+
+static void handle_fault(int signal_number, siginfo_t* info, void* context)
+{
+    if (auto* scope = s_innermost_trap_scope; scope && scope->contains(info->si_addr))
+        siglongjmp(scope->jump_buffer(), 1);
+
+    // Not ours, so let whoever handled this signal before deal with it.
+    auto& previous_action = signal_number == SIGSEGV ? s_previous_segv_action : s_previous_bus_action;
+    if (previous_action.sa_flags & SA_SIGINFO) {
+        previous_action.sa_sigaction(signal_number, info, context);
+        return;
+    }
+    if (previous_action.sa_handler != SIG_DFL && previous_action.sa_handler != SIG_IGN) {
+        previous_action.sa_handler(signal_number);
+        return;
+    }
+    // Returning re-runs the faulting instruction, which will now crash as usual.
+    signal(signal_number, SIG_DFL);
+}
+
+static ErrorOr<void> install_fault_handler()
+{
+    static int const error = [] {
+        struct sigaction action {};
+        action.sa_sigaction = handle_fault;
+        // The handler leaves through siglongjmp without restoring the signal mask, so it must not block its own signal.
+        action.sa_flags = SA_SIGINFO | SA_NODEFER;
+        sigemptyset(&action.sa_mask);
+        if (sigaction(SIGSEGV, &action, &s_previous_segv_action) < 0)
+            return errno;
+        if (sigaction(SIGBUS, &action, &s_previous_bus_action) < 0)
+            return errno;
+        return 0;
+    }();
+    if (error != 0)
+        return Error::from_errno(error);
+    return {};
+}
+
+bool GuardedMemory::is_supported()
+{
+    // The reservation needs a 64-bit address space, and faults have to report the address they happened at.
+#if defined(AK_ARCH_64_BIT) && !defined(AK_OS_SERENITY)
+    return true;
+#else
+    return false;
+#endif
+}
+
+ErrorOr<GuardedMemory> GuardedMemory::create()
+{
+    if (!is_supported())
+        return Error::from_string_literal("Guarded memory is not supported on this platform");
+
+    TRY(install_fault_handler());
+
+    auto* data = mmap(nullptr, reserved_size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (data == MAP_FAILED)
+        return Error::from_errno(errno);
+    return GuardedMemory { static_cast<u8*>(data) };
+}
+
+GuardedMemory::GuardedMemory(GuardedMemory&& other)
+    : m_data(exchange(other.m_data, nullptr))
+    , m_accessible_size(exchange(other.m_accessible_size, 0))
+{
+}
+
+GuardedMemory::~GuardedMemory()
+{
+    if (m_data)
+        munmap(m_data, reserved_size);
+}
+
+ErrorOr<void> GuardedMemory::make_accessible(size_t size)
+{
+    static auto const page_size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    size = align_up_to(size, page_size);
+    if (size <= m_accessible_size)
+        return {};
+    if (size > reserved_size)
+        return Error::from_errno(ENOMEM);
+
+    // The pages have never been touched, so they are still zeroed.
+    if (mprotect(m_data + m_accessible_size, size - m_accessible_size, PROT_READ | PROT_WRITE) < 0)
+        return Error::from_errno(errno);
+    m_accessible_size = size;
+    return {};
+}
+
+GuardedMemory::TrapScope::TrapScope(GuardedMemory const& memory)
+    : m_data(memory.data())
+    , m_previous(s_innermost_trap_scope)
+{
+    s_innermost_trap_scope = this;
+}
+
+GuardedMemory::TrapScope::~TrapScope()
+{
+    s_innermost_trap_scope = m_previous;
+}
+
+}
@@ -0,0 +1,69 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Error.h>
+#include <AK/Noncopyable.h>
+#include <AK/Types.h>
+#include <setjmp.h>
+
+namespace Wasm {
+
+// The storage for a linear memory that reserves every address a load or store could compute from a 32-bit base and
+// a 32-bit offset up front. Only the part of the reservation that is in use is accessible, so an access outside of
+// the memory faults instead of needing a bounds check, and growing the memory never has to move its contents.
+class GuardedMemory {
+    AK_MAKE_NONCOPYABLE(GuardedMemory);
+
+public:
+    // Any base + offset + access size stays below this.
+    static constexpr u64 reserved_size = 8 * GiB + 64 * KiB;
+
+    static bool is_supported();
+    static ErrorOr<GuardedMemory> create();
+
+    GuardedMemory(GuardedMemory&&);
+    ~GuardedMemory();
+
+    u8* data() const { return m_data; }
+    size_t accessible_size() const { return m_accessible_size; }
+    bool contains(void const* address) const { return address >= m_data && address < m_data + reserved_size; }
+
+    // Newly accessible pages are zeroed.
+    ErrorOr<void> make_accessible(size_t size);
+
+    // While a TrapScope is the innermost one on its thread, faults inside its memory jump back to it, with
+    // sigsetjmp(scope.jump_buffer(), 0) returning a non-zero value. Nothing between the two may need unwinding.
+    // The GuardedMemory itself may be moved while the scope is active, so the scope only remembers its reservation.
+    class TrapScope {
+        AK_MAKE_NONCOPYABLE(TrapScope);
+        AK_MAKE_NONMOVABLE(TrapScope);
+
+    public:
+        explicit TrapScope(GuardedMemory const&);
+        ~TrapScope();
+
+        sigjmp_buf& jump_buffer() { return m_jump_buffer; }
+        bool contains(void const* address) const { return address >= m_data && address < m_data + reserved_size; }
+
+    private:
+        sigjmp_buf m_jump_buffer;
+        u8 const* m_data { nullptr };
+        TrapScope* m_previous { nullptr };
+    };
+
+private:
+    explicit GuardedMemory(u8* data)
+        : m_data(data)
+    {
+    }
+
+    u8* m_data { nullptr };
+    size_t m_accessible_size { 0 };
+};
+
+}
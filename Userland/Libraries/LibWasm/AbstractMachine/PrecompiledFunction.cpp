@@ -0,0 +1,671 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Debug.h>
+#include <AK/HashMap.h>
+#include <LibWasm/AbstractMachine/PrecompiledFunction.h>
+#include <LibWasm/Opcode.h>
+#include <LibWasm/Printer/Printer.h>
+
+namespace Wasm {
+
+PrecompiledFunction::ModuleContext PrecompiledFunction::ModuleContext::create(Module const& module)
+{
+    ModuleContext context;
+
+    module.for_each_section_of_type<TypeSection>([&](TypeSection const& section) {
+        context.types = section.types();
+    });
+
+    module.for_each_section_of_type<ImportSection>([&](ImportSection const& section) {
+        for (auto& import_ : section.imports()) {
+            import_.description().visit(
+                [&](TypeIndex const& index) { context.functions.append(context.types[index.value()]); },
+                [&](FunctionType const& type) { context.functions.append(type); },
+                [&](GlobalType const& type) { context.globals.append(type); },
+                [](auto const&) {});
+        }
+    });
+
+    module.for_each_section_of_type<FunctionSection>([&](FunctionSection const& section) {
+        for (auto& index : section.types())
+            context.functions.append(context.types[index.value()]);
+    });
+
+    module.for_each_section_of_type<GlobalSection>([&](GlobalSection const& section) {
+        for (auto& entry : section.entries())
+            context.globals.append(entry.type());
+    });
+
+    return context;
+}
+
+static bool has_reference_types(Vector<ValueType> const& types)
+{
+    return any_of(types, [](auto& type) { return type.is_reference(); });
+}
+
+static bool has_reference_types(FunctionType const& type)
+{
+    return has_reference_types(type.parameters()) || has_reference_types(type.results());
+}
+
+class PrecompiledFunctionBuilder {
+public:
+    PrecompiledFunctionBuilder(PrecompiledFunction::ModuleContext const& context, Module::Function const& code, FunctionType const& type)
+        : m_context(context)
+        , m_code(code)
+        , m_function(adopt_ref(*new PrecompiledFunction(type, type.parameters().size() + code.locals().size())))
+    {
+    }
+
+    RefPtr<PrecompiledFunction> build();
+
+private:
+    using OpCode = PrecompiledFunction::OpCode;
+
+    struct ControlFrame {
+        enum class Kind {
+            Function,
+            Block,
+            Loop,
+            If,
+        };
+
+        Kind kind { Kind::Block };
+        // Operand stack height below the parameters of this block.
+        size_t base { 0 };
+        size_t parameter_count { 0 };
+        size_t result_count { 0 };
+        size_t loop_start { 0 };
+        // Forward jumps to the end of this block, to be patched once we get there.
+        Vector<size_t> pending_jumps;
+        Optional<size_t> else_jump;
+        Vector<u32> saved_parameters;
+        bool unreachable { false };
+
+        size_t branch_arity() const { return kind == Kind::Loop ? parameter_count : result_count; }
+    };
+
+    struct BlockSignature {
+        size_t parameter_count { 0 };
+        size_t result_count { 0 };
+    };
+
+    Optional<BlockSignature> block_signature(BlockType const&) const;
+    bool lower(Instruction const&);
+
+    u32 home(size_t height) const { return static_cast<u32>(m_stack_base + height); }
+    bool is_local(u32 slot) const { return slot < m_function->m_local_count; }
+
+    void push(u32 slot)
+    {
+        m_stack.append(slot);
+        m_max_height = max(m_max_height, m_stack.size());
+    }
+    u32 pop() { return m_stack.take_last(); }
+
+    size_t emit(OpCode opcode, u32 a = 0, u32 b = 0, u32 c = 0, u32 d = 0)
+    {
+        m_last_producer.clear();
+        m_function->m_instructions.append({ opcode, a, b, c, d });
+        return m_function->m_instructions.size() - 1;
+    }
+
+    // Emits an instruction writing its result to the home slot of the next operand stack entry.
+    void emit_producer(OpCode opcode, u32 b = 0, u32 c = 0, u32 d = 0)
+    {
+        auto destination = home(m_stack.size());
+        auto index = emit(opcode, destination, b, c, d);
+        m_last_producer = index;
+        push(destination);
+    }
+
+    void materialize(size_t position)
+    {
+        auto destination = home(position);
+        if (m_stack[position] == destination)
+            return;
+        emit(OpCode::Copy, destination, m_stack[position]);
+        m_stack[position] = destination;
+    }
+
+    void materialize_local_references(Optional<u32> local = {})
+    {
+        for (size_t i = 0; i < m_stack.size(); ++i) {
+            if (is_local(m_stack[i]) && (!local.has_value() || m_stack[i] == *local))
+                materialize(i);
+        }
+    }
+
+    // Copies the topmost `count` operands to the home slots starting at `base`. Entries are either in their own home
+    // slot or somewhere outside the operand stack, so copying in ascending order never clobbers a pending source.
+    void emit_copies_to(size_t base, size_t count)
+    {
+        auto first = m_stack.size() - count;
+        for (size_t i = 0; i < count; ++i) {
+            if (m_stack[first + i] != home(base + i))
+                emit(OpCode::Copy, home(base + i), m_stack[first + i]);
+        }
+    }
+
+    void bind_label(size_t target)
+    {
+        for (auto index : m_frames[target].pending_jumps)
+            patch_jump(index, m_function->m_instructions.size());
+        m_frames[target].pending_jumps.clear();
+        if (auto else_jump = m_frames[target].else_jump; else_jump.has_value()) {
+            patch_jump(*else_jump, m_function->m_instructions.size());
+            m_frames[target].else_jump.clear();
+        }
+        m_last_producer.clear();
+    }
+
+    void patch_jump(size_t index, size_t target)
+    {
+        auto& instruction = m_function->m_instructions[index];
+        if (instruction.opcode == OpCode::Jump)
+            instruction.a = target;
+        else
+            instruction.b = target;
+    }
+
+    size_t frame_index_for_label(LabelIndex label) const { return m_frames.size() - 1 - label.value(); }
+
+    // Moves the branch operands to where the target block expects them, then jumps there.
+    void emit_branch(size_t target)
+    {
+        auto& frame = m_frames[target];
+        emit_copies_to(frame.base, frame.branch_arity());
+        if (frame.kind == ControlFrame::Kind::Loop) {
+            emit(OpCode::Jump, frame.loop_start);
+            return;
+        }
+        frame.pending_jumps.append(emit(OpCode::Jump));
+    }
+
+    void emit_return(size_t result_count)
+    {
+        if (result_count == 1) {
+            emit(OpCode::Return, m_stack.last());
+            return;
+        }
+        auto first = m_stack.size() - result_count;
+        for (size_t i = first; i < m_stack.size(); ++i)
+            materialize(i);
+        emit(OpCode::Return, home(first));
+    }
+
+    void mark_unreachable()
+    {
+        m_frames.last().unreachable = true;
+        m_skipped_block_depth = 0;
+    }
+
+    void end_block();
+
+    PrecompiledFunction::ModuleContext const& m_context;
+    Module::Function const& m_code;
+    NonnullRefPtr<PrecompiledFunction> m_function;
+
+    HashMap<u64, u32> m_constant_slots;
+    size_t m_stack_base { 0 };
+    Vector<u32> m_stack;
+    size_t m_max_height { 0 };
+    Vector<ControlFrame> m_frames;
+    // The last emitted instruction, if it computed the value on top of the operand stack and nothing may have jumped
+    // past it since; its destination may be changed to skip a copy.
+    Optional<size_t> m_last_producer;
+    size_t m_skipped_block_depth { 0 };
+};
+
+Optional<PrecompiledFunctionBuilder::BlockSignature> PrecompiledFunctionBuilder::block_signature(BlockType const& type) const
+{
+    switch (type.kind()) {
+    case BlockType::Empty:
+        return BlockSignature {};
+    case BlockType::Type:
+        if (type.value_type().is_reference())
+            return {};
+        return BlockSignature { 0, 1 };
+    case BlockType::Index: {
+        auto& function_type = m_context.types[type.type_index().value()];
+        if (has_reference_types(function_type))
+            return {};
+        return BlockSignature { function_type.parameters().size(), function_type.results().size() };
+    }
+    }
+    VERIFY_NOT_REACHED();
+}
+
+static Optional<u64> constant_value(Instruction const& instruction)
+{
+    switch (instruction.opcode().value()) {
+    case Instructions::i32_const.value():
+        return bit_cast<u32>(instruction.arguments().get<i32>());
+    case Instructions::i64_const.value():
+        return bit_cast<u64>(instruction.arguments().get<i64>());
+    case Instructions::f32_const.value():
+        return bit_cast<u32>(instruction.arguments().get<float>());
+    case Instructions::f64_const.value():
+        return bit_cast<u64>(instruction.arguments().get<double>());
+    default:
+        return {};
+    }
+}
+
+RefPtr<PrecompiledFunction> PrecompiledFunctionBuilder::build()
+{
+    if (has_reference_types(m_function->type()) || has_reference_types(m_code.locals()))
+        return nullptr;
+
+    auto& instructions = m_code.body().instructions();
+
+    // Every distinct constant gets a slot of its own, right after the locals.
+    for (auto& instruction : instructions) {
+        auto value = constant_value(instruction);
+        if (!value.has_value() || m_constant_slots.contains(*value))
+            continue;
+        m_constant_slots.set(*value, m_function->m_local_count + m_function->m_constants.size());
+        m_function->m_constants.append(*value);
+    }
+    m_stack_base = m_function->m_local_count + m_function->m_constants.size();
+
+    ControlFrame function_frame;
+    function_frame.kind = ControlFrame::Kind::Function;
+    function_frame.result_count = m_function->type().results().size();
+    m_frames.append(move(function_frame));
+
+    for (auto& instruction : instructions) {
+        if (m_frames.is_empty())
+            break;
+        if (!lower(instruction))
+            return nullptr;
+    }
+
+    // The body of a function isn't terminated by an explicit `end`.
+    if (!m_frames.is_empty())
+        end_block();
+
+    m_function->m_slot_count = m_stack_base + m_max_height;
+
+    if constexpr (WASM_TRACE_DEBUG)
+        m_function->dump();
+
+    return m_function;
+}
+
+void PrecompiledFunctionBuilder::end_block()
+{
+    auto& frame = m_frames.last();
+    bool has_incoming_jumps = !frame.pending_jumps.is_empty() || frame.else_jump.has_value();
+
+    if (frame.kind == ControlFrame::Kind::Function) {
+        if (!has_incoming_jumps) {
+            if (!frame.unreachable)
+                emit_return(frame.result_count);
+        } else {
+            if (!frame.unreachable)
+                emit_copies_to(0, frame.result_count);
+            bind_label(0);
+            emit(OpCode::Return, home(0));
+        }
+        m_frames.clear();
+        return;
+    }
+
+    // A loop's label is at its start, so only falling through reaches its end and the operands can stay where they
+    // are. The same goes for blocks nothing branches out of.
+    if (!frame.unreachable && (frame.kind == ControlFrame::Kind::Loop || !has_incoming_jumps)) {
+        m_frames.take_last();
+        return;
+    }
+
+    if (!frame.unreachable)
+        emit_copies_to(frame.base, frame.result_count);
+    if (has_incoming_jumps)
+        bind_label(m_frames.size() - 1);
+
+    auto base = frame.base;
+    auto result_count = frame.result_count;
+    m_frames.take_last();
+
+    m_stack.shrink(base);
+    for (size_t i = 0; i < result_count; ++i)
+        push(home(base + i));
+
+    // Nothing reaches the end of this block, so whatever follows it is dead as well.
+    if (!has_incoming_jumps)
+        mark_unreachable();
+}
+
+bool PrecompiledFunctionBuilder::lower(Instruction const& instruction)
+{
+    auto opcode = instruction.opcode();
+
+    if (m_frames.last().unreachable) {
+        // Skip dead code until the end of the current block, or the start of the else branch.
+        switch (opcode.value()) {
+        case Instructions::block.value():
+        case Instructions::loop.value():
+        case Instructions::if_.value():
+            ++m_skipped_block_depth;
+            return true;
+        case Instructions::structured_else.value():
+            if (m_skipped_block_depth > 0)
+                return true;
+            break;
+        case Instructions::structured_end.value():
+            if (m_skipped_block_depth > 0) {
+                --m_skipped_block_depth;
+                return true;
+            }
+            break;
+        default:
+            return true;
+        }
+    }
+
+    switch (opcode.value()) {
+#define __LOWER_BINARY_OP(name, ...)           \
+    case Instructions::name.value(): {         \
+        auto rhs = pop();                      \
+        auto lhs = pop();                      \
+        emit_producer(OpCode::name, lhs, rhs); \
+        return true;                           \
+    }
+        ENUMERATE_WASM_PRECOMPILED_BINARY_OPS(__LOWER_BINARY_OP)
+#undef __LOWER_BINARY_OP
+
+#define __LOWER_UNARY_OP(name, ...)           \
+    case Instructions::name.value(): {        \
+        auto operand = pop();                 \
+        emit_producer(OpCode::name, operand); \
+        return true;                          \
+    }
+        ENUMERATE_WASM_PRECOMPILED_UNARY_OPS(__LOWER_UNARY_OP)
+#undef __LOWER_UNARY_OP
+
+#define __LOWER_LOAD_OP(name, ...)                                                                               \
+    case Instructions::name.value(): {                                                                           \
+        auto address = pop();                                                                                    \
+        emit_producer(OpCode::name, address, instruction.arguments().get<Instruction::MemoryArgument>().offset); \
+        return true;                                                                                             \
+    }
+        ENUMERATE_WASM_PRECOMPILED_LOAD_OPS(__LOWER_LOAD_OP)
+#undef __LOWER_LOAD_OP
+
+#define __LOWER_STORE_OP(name, ...)                                                                            \
+    case Instructions::name.value(): {                                                                         \
+        auto value = pop();                                                                                    \
+        auto address = pop();                                                                                  \
+        emit(OpCode::name, address, value, instruction.arguments().get<Instruction::MemoryArgument>().offset); \
+        return true;                                                                                           \
+    }
+        ENUMERATE_WASM_PRECOMPILED_STORE_OPS(__LOWER_STORE_OP)
+#undef __LOWER_STORE_OP
+
+    case Instructions::unreachable.value():
+        emit(OpCode::Unreachable);
+        mark_unreachable();
+        return true;
+    case Instructions::nop.value():
+        return true;
+    case Instructions::i32_const.value():
+    case Instructions::i64_const.value():
+    case Instructions::f32_const.value():
+    case Instructions::f64_const.value():
+        push(m_constant_slots.get(*constant_value(instruction)).value());
+        return true;
+    case Instructions::local_get.value():
+        push(instruction.arguments().get<LocalIndex>().value());
+        return true;
+    case Instructions::local_set.value():
+    case Instructions::local_tee.value(): {
+        auto local = static_cast<u32>(instruction.arguments().get<LocalIndex>().value());
+        auto value = m_stack.last();
+        if (value == local) {
+            if (opcode == Instructions::local_set)
+                pop();
+            return true;
+        }
+
+        bool is_only_reference = !m_stack.span().slice(0, m_stack.size() - 1).contains_slow(local);
+        if (m_last_producer.has_value() && value == home(m_stack.size() - 1) && is_only_reference) {
+            // Have the instruction that computed the value write it to the local directly.
+            m_function->m_instructions[*m_last_producer].a = local;
+            m_last_producer.clear();
+            pop();
+            if (opcode == Instructions::local_tee)
+                push(local);
+            return true;
+        }
+
+        pop();
+        materialize_local_references(local);
+        emit(OpCode::Copy, local, value);
+        if (opcode == Instructions::local_tee)
+            push(value);
+        return true;
+    }
+    case Instructions::global_get.value(): {
+        auto index = instruction.arguments().get<GlobalIndex>().value();
+        if (m_context.globals[index].type().is_reference())
+            return false;
+        emit_producer(OpCode::GlobalGet, index);
+        return true;
+    }
+    case Instructions::global_set.value(): {
+        auto index = instruction.arguments().get<GlobalIndex>().value();
+        if (m_context.globals[index].type().is_reference())
+            return false;
+        auto value = pop();
+        emit(OpCode::GlobalSet, index, value);
+        return true;
+    }
+    case Instructions::drop.value():
+        pop();
+        return true;
+    case Instructions::select.value():
+    case Instructions::select_typed.value(): {
+        if (opcode == Instructions::select_typed && has_reference_types(instruction.arguments().get<Vector<ValueType>>()))
+            return false;
+        auto condition = pop();
+        auto rhs = pop();
+        auto lhs = pop();
+        emit_producer(OpCode::Select, lhs, rhs, condition);
+        return true;
+    }
+    case Instructions::memory_size.value():
+        emit_producer(OpCode::MemorySize);
+        return true;
+    case Instructions::memory_grow.value(): {
+        auto pages = pop();
+        emit_producer(OpCode::MemoryGrow, pages);
+        return true;
+    }
+    case Instructions::memory_fill.value():
+    case Instructions::memory_copy.value(): {
+        auto count = pop();
+        auto source_or_value = pop();
+        auto destination = pop();
+        emit(opcode == Instructions::memory_fill ? OpCode::MemoryFill : OpCode::MemoryCopy, destination, source_or_value, count);
+        return true;
+    }
+    case Instructions::block.value():
+    case Instructions::loop.value():
+    case Instructions::if_.value(): {
+        auto& args = instruction.arguments().get<Instruction::StructuredInstructionArgs>();
+        auto signature = block_signature(args.block_type);
+        if (!signature.has_value())
+            return false;
+
+        Optional<u32> condition;
+        if (opcode == Instructions::if_)
+            condition = pop();
+
+        // Locals may change inside the block, so anything referring to them has to be copied out first.
+        materialize_local_references();
+
+        ControlFrame frame;
+        frame.base = m_stack.size() - signature->parameter_count;
+        frame.parameter_count = signature->parameter_count;
+        frame.result_count = signature->result_count;
+
+        if (opcode == Instructions::block) {
+            frame.kind = ControlFrame::Kind::Block;
+        } else {
+            // Both the loop label and the end of an if without an else branch expect the parameters in their home slots.
+            for (size_t i = frame.base; i < m_stack.size(); ++i)
+                materialize(i);
+
+            if (opcode == Instructions::loop) {
+                frame.kind = ControlFrame::Kind::Loop;
+                frame.loop_start = m_function->m_instructions.size();
+                m_last_producer.clear();
+            } else {
+                frame.kind = ControlFrame::Kind::If;
+                frame.else_jump = emit(OpCode::JumpIfZero, *condition);
+                frame.saved_parameters.append(m_stack.data() + frame.base, m_stack.size() - frame.base);
+            }
+        }
+
+        m_frames.append(move(frame));
+        return true;
+    }
+    case Instructions::structured_else.value(): {
+        auto& frame = m_frames.last();
+        VERIFY(frame.kind == ControlFrame::Kind::If);
+        if (!frame.unreachable) {
+            emit_copies_to(frame.base, frame.result_count);
+            frame.pending_jumps.append(emit(OpCode::Jump));
+        }
+        patch_jump(*frame.else_jump, m_function->m_instructions.size());
+        frame.else_jump.clear();
+        m_last_producer.clear();
+
+        m_stack.shrink(frame.base);
+        m_stack.extend(frame.saved_parameters);
+        frame.unreachable = false;
+        return true;
+    }
+    case Instructions::structured_end.value():
+        end_block();
+        return true;
+    case Instructions::br.value():
+        emit_branch(frame_index_for_label(instruction.arguments().get<LabelIndex>()));
+        mark_unreachable();
+        return true;
+    case Instructions::br_if.value(): {
+        auto condition = pop();
+        auto target = frame_index_for_label(instruction.arguments().get<LabelIndex>());
+        auto& frame = m_frames[target];
+        if (frame.branch_arity() == 0) {
+            if (frame.kind == ControlFrame::Kind::Loop)
+                emit(OpCode::JumpIfNotZero, condition, frame.loop_start);
+            else
+                frame.pending_jumps.append(emit(OpCode::JumpIfNotZero, condition));
+            return true;
+        }
+        auto skip = emit(OpCode::JumpIfZero, condition);
+        emit_branch(target);
+        patch_jump(skip, m_function->m_instructions.size());
+        return true;
+    }
+    case Instructions::br_table.value(): {
+        auto& args = instruction.arguments().get<Instruction::TableBranchArgs>();
+        auto index = pop();
+        auto& table = m_function->m_branch_table_targets;
+        auto first_entry = table.size();
+        emit(OpCode::BranchTable, index, first_entry, args.labels.size());
+        table.resize(first_entry + args.labels.size() + 1);
+
+        // Each distinct target gets a small stub that moves the operands and jumps there.
+        HashMap<size_t, u32> stubs;
+        auto entry_for_label = [&](LabelIndex label) -> u32 {
+            auto target = frame_index_for_label(label);
+            auto& frame = m_frames[target];
+            if (frame.kind == ControlFrame::Kind::Loop && frame.branch_arity() == 0)
+                return frame.loop_start;
+            if (auto stub = stubs.get(target); stub.has_value())
+                return *stub;
+            u32 stub = m_function->m_instructions.size();
+            emit_branch(target);
+            stubs.set(target, stub);
+            return stub;
+        };
+        for (size_t i = 0; i < args.labels.size(); ++i)
+            table[first_entry + i] = entry_for_label(args.labels[i]);
+        table[first_entry + args.labels.size()] = entry_for_label(args.default_);
+
+        mark_unreachable();
+        return true;
+    }
+    case Instructions::return_.value():
+        emit_return(m_function->type().results().size());
+        mark_unreachable();
+        return true;
+    case Instructions::call.value():
+    case Instructions::call_indirect.value(): {
+        Optional<u32> table_index;
+        FunctionType const* type = nullptr;
+        if (opcode == Instructions::call) {
+            type = &m_context.functions[instruction.arguments().get<FunctionIndex>().value()];
+        } else {
+            type = &m_context.types[instruction.arguments().get<Instruction::IndirectCallArgs>().type.value()];
+            table_index = pop();
+        }
+        if (has_reference_types(*type))
+            return false;
+
+        auto first_argument = m_stack.size() - type->parameters().size();
+        for (size_t i = first_argument; i < m_stack.size(); ++i)
+            materialize(i);
+        m_stack.shrink(first_argument);
+
+        if (opcode == Instructions::call) {
+            emit(OpCode::Call, instruction.arguments().get<FunctionIndex>().value(), home(first_argument));
+        } else {
+            auto& args = instruction.arguments().get<Instruction::IndirectCallArgs>();
+            emit(OpCode::CallIndirect, args.type.value(), home(first_argument), args.table.value(), *table_index);
+        }
+
+        for (size_t i = 0; i < type->results().size(); ++i)
+            push(home(first_argument + i));
+        return true;
+    }
+    default:
+        // Reference types, tables and passive data segments are left to the stack-based interpreter.
+        dbgln_if(WASM_TRACE_DEBUG, "Not precompiling function using '{}'", instruction_name(opcode));
+        return false;
+    }
+}
+
+RefPtr<PrecompiledFunction> PrecompiledFunction::try_create(ModuleContext const& context, Module::Function const& function)
+{
+    return PrecompiledFunctionBuilder { context, function, context.types[function.type().value()] }.build();
+}
+
+void PrecompiledFunction::dump() const
+{
+    static constexpr StringView opcode_names[] = {
+#define __ENUMERATE_OP(name, ...) #name##sv,
+        ENUMERATE_WASM_PRECOMPILED_OTHER_OPS(__ENUMERATE_OP)
+            ENUMERATE_WASM_PRECOMPILED_BINARY_OPS(__ENUMERATE_OP)
+                ENUMERATE_WASM_PRECOMPILED_UNARY_OPS(__ENUMERATE_OP)
+                    ENUMERATE_WASM_PRECOMPILED_LOAD_OPS(__ENUMERATE_OP)
+                        ENUMERATE_WASM_PRECOMPILED_STORE_OPS(__ENUMERATE_OP)
+#undef __ENUMERATE_OP
+    };
+
+    dbgln("Precompiled function: {} locals, {} constants, {} slots", m_local_count, m_constants.size(), m_slot_count);
+    for (size_t i = 0; i < m_instructions.size(); ++i) {
+        auto& instruction = m_instructions[i];
+        dbgln("  [{:4}] {} {}, {}, {}, {}", i, opcode_names[to_underlying(instruction.opcode)], instruction.a, instruction.b, instruction.c, instruction.d);
+    }
+}
+
+}
@@ -0,0 +1,448 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Debug.h>
+#include <AK/Endian.h>
+#include <LibWasm/AbstractMachine/AbstractMachine.h>
+#include <LibWasm/AbstractMachine/BytecodeInterpreter.h>
+#include <LibWasm/AbstractMachine/Configuration.h>
+#include <LibWasm/AbstractMachine/Operators.h>
+#include <LibWasm/AbstractMachine/PrecompiledFunction.h>
+
+namespace Wasm {
+
+// Slots hold the raw bits of their value: 32-bit types in the low half, zero-extended.
+template<typename T>
+ALWAYS_INLINE static T from_raw(u64 raw)
+{
+    if constexpr (sizeof(T) == sizeof(u32))
+        return bit_cast<T>(static_cast<u32>(raw));
+    else
+        return bit_cast<T>(raw);
+}
+
+template<typename T>
+ALWAYS_INLINE static u64 to_raw(T value)
+{
+    if constexpr (sizeof(T) == sizeof(u32))
+        return bit_cast<u32>(value);
+    else
+        return bit_cast<u64>(value);
+}
+
+static u64 value_to_raw(Value const& value)
+{
+    return value.value().visit(
+        [](i32 value) { return to_raw(value); },
+        [](i64 value) { return to_raw(value); },
+        [](float value) { return to_raw(value); },
+        [](double value) { return to_raw(value); },
+        [](Reference const&) -> u64 { VERIFY_NOT_REACHED(); });
+}
+
+static Value raw_to_value(ValueType type, u64 raw)
+{
+    switch (type.kind()) {
+    case ValueType::I32:
+        return Value { from_raw<i32>(raw) };
+    case ValueType::I64:
+        return Value { from_raw<i64>(raw) };
+    case ValueType::F32:
+        return Value { from_raw<float>(raw) };
+    case ValueType::F64:
+        return Value { from_raw<double>(raw) };
+    default:
+        VERIFY_NOT_REACHED();
+    }
+}
+
+template<typename T>
+ALWAYS_INLINE static T read_from_memory(u8 const* data)
+{
+    if constexpr (IsFloatingPoint<T>) {
+        using Bits = Conditional<sizeof(T) == sizeof(u32), u32, u64>;
+        return bit_cast<T>(read_from_memory<Bits>(data));
+    } else {
+        T value;
+        __builtin_memcpy(&value, data, sizeof(T));
+        return AK::convert_between_host_and_little_endian(value);
+    }
+}
+
+template<typename T>
+ALWAYS_INLINE static void write_to_memory(u8* data, T value)
+{
+    if constexpr (IsFloatingPoint<T>) {
+        using Bits = Conditional<sizeof(T) == sizeof(u32), u32, u64>;
+        write_to_memory(data, bit_cast<Bits>(value));
+    } else {
+        value = AK::convert_between_host_and_little_endian(value);
+        __builtin_memcpy(data, &value, sizeof(T));
+    }
+}
+
+template<typename PushType, typename CallResult>
+ALWAYS_INLINE static Optional<StringView> store_result(u64& destination, CallResult call_result)
+{
+    PushType result;
+    if constexpr (IsSpecializationOf<CallResult, AK::Result>) {
+        if (call_result.is_error())
+            return call_result.error();
+        result = call_result.release_value();
+    } else {
+        result = call_result;
+    }
+    destination = to_raw(result);
+    return {};
+}
+
+void BytecodeInterpreter::interpret_precompiled(Configuration& configuration, PrecompiledFunction const& function)
+{
+    auto& frame = configuration.frame();
+    auto window_base = m_precompiled_slots.size();
+    m_precompiled_slots.resize(window_base + function.slot_count(), true);
+
+    auto* slots = m_precompiled_slots.data() + window_base;
+    for (size_t i = 0; i < frame.locals().size(); ++i)
+        slots[i] = value_to_raw(frame.locals()[i]);
+    for (size_t i = 0; i < function.constants().size(); ++i)
+        slots[function.local_count() + i] = function.constants()[i];
+
+    auto result_slot = run_precompiled(configuration, frame.module(), function, window_base);
+    if (result_slot.has_value()) {
+        auto& result_types = function.type().results();
+        slots = m_precompiled_slots.data() + window_base + *result_slot;
+        for (size_t i = 0; i < result_types.size(); ++i)
+            configuration.stack().push(raw_to_value(result_types[i], slots[i]));
+    }
+
+    m_precompiled_slots.shrink(window_base, true);
+}
+
+bool BytecodeInterpreter::call_from_precompiled(Configuration& configuration, FunctionAddress address, size_t arguments_base)
+{
+    if (trap_if_not(m_stack_info.size_free() >= Constants::minimum_stack_space_to_keep_free, "m_stack_info.size_free() >= Constants::minimum_stack_space_to_keep_free"sv))
+        return false;
+
+    auto* instance = configuration.store().get(address);
+    auto* wasm_function = instance->get_pointer<WasmFunction>();
+    if (wasm_function && wasm_function->precompiled()) {
+        // Calls between precompiled functions don't need to go through the configuration at all.
+        auto& callee = *wasm_function->precompiled();
+        auto window_base = m_precompiled_slots.size();
+        m_precompiled_slots.resize(window_base + callee.slot_count(), true);
+
+        auto* slots = m_precompiled_slots.data();
+        for (size_t i = 0; i < callee.type().parameters().size(); ++i)
+            slots[window_base + i] = slots[arguments_base + i];
+        for (size_t i = callee.type().parameters().size(); i < callee.local_count(); ++i)
+            slots[window_base + i] = 0;
+        for (size_t i = 0; i < callee.constants().size(); ++i)
+            slots[window_base + callee.local_count() + i] = callee.constants()[i];
+
+        auto result_slot = run_precompiled(configuration, wasm_function->module(), callee, window_base);
+        if (result_slot.has_value()) {
+            slots = m_precompiled_slots.data();
+            for (size_t i = 0; i < callee.type().results().size(); ++i)
+                slots[arguments_base + i] = slots[window_base + *result_slot + i];
+        }
+
+        m_precompiled_slots.shrink(window_base, true);
+        return result_slot.has_value();
+    }
+
+    FunctionType const* type { nullptr };
+    instance->visit([&](auto const& function) { type = &function.type(); });
+
+    Vector<Value> arguments;
+    arguments.ensure_capacity(type->parameters().size());
+    for (size_t i = 0; i < type->parameters().size(); ++i)
+        arguments.unchecked_append(raw_to_value(type->parameters()[i], m_precompiled_slots[arguments_base + i]));
+
+    Result result { Trap { ""sv } };
+    {
+        CallFrameHandle handle { *this, configuration };
+        result = configuration.call(*this, address, move(arguments));
+    }
+
+    if (result.is_trap()) {
+        m_trap = move(result.trap());
+        return false;
+    }
+
+    if (result.is_completion()) {
+        m_trap = move(result.completion());
+        return false;
+    }
+
+    // Results are handed to us in reverse order.
+    auto& values = result.values();
+    for (size_t i = 0; i < values.size(); ++i)
+        m_precompiled_slots[arguments_base + i] = value_to_raw(values[values.size() - i - 1]);
+    return true;
+}
+
+// Executes a precompiled function whose slots start at `window_base`, returning the slot index of its first result.
+Optional<u32> BytecodeInterpreter::run_precompiled(Configuration& configuration, ModuleInstance const& module, PrecompiledFunction const& function, size_t window_base)
+{
+    Optional<MemoryAddress> memory_address;
+    if (!module.memories().is_empty())
+        memory_address = module.memories().first();
+
+    GuardedMemory const* guarded_memory = nullptr;
+    if (memory_address.has_value())
+        guarded_memory = configuration.store().get(*memory_address)->guarded_memory();
+
+    if (!guarded_memory)
+        return execute_precompiled<false>(configuration, module, memory_address, function, window_base);
+
+    // Loads and stores skip their bounds checks, and come back here if they fault instead.
+    // Any precompiled function they call sets up its own scope, so there's nothing to unwind in between.
+    GuardedMemory::TrapScope scope { *guarded_memory };
+    if (sigsetjmp(scope.jump_buffer(), 0) != 0) {
+        m_trap = Trap { "Memory access out of bounds" };
+        return {};
+    }
+    return execute_precompiled<true>(configuration, module, memory_address, function, window_base);
+}
+
+// The operands of each instruction are:
+// - Numeric instructions:     a = destination slot, b = first operand slot, c = second operand slot
+// - Loads:                    a = destination slot, b = address slot, c = offset
+// - Stores:                   a = address slot, b = value slot, c = offset
+// - Copy:                     a = destination slot, b = source slot
+// - Select:                   a = destination slot, b = first operand slot, c = second operand slot, d = condition slot
+// - Jump:                     a = target
+// - JumpIfZero/JumpIfNotZero: a = condition slot, b = target
+// - BranchTable:              a = index slot, b = first entry in the branch table, c = entry count (excluding the default)
+// - Return:                   a = slot of the first result
+// - Call:                     a = function index, b = first argument slot, which also receives the results
+// - CallIndirect:             a = type index, b = first argument slot, c = table index, d = element index slot
+// - GlobalGet:                a = destination slot, b = global index
+// - GlobalSet:                a = global index, b = value slot
+// - MemorySize:               a = destination slot
+// - MemoryGrow:               a = destination slot, b = page count slot
+// - MemoryFill:               a = destination address slot, b = value slot, c = count slot
+// - MemoryCopy:               a = destination address slot, b = source address slot, c = count slot
+template<bool memory_is_guarded>
+NEVER_INLINE Optional<u32> BytecodeInterpreter::execute_precompiled(Configuration& configuration, ModuleInstance const& module, Optional<MemoryAddress> memory_address, PrecompiledFunction const& function, size_t window_base)
+{
+    using Instruction = PrecompiledFunction::Instruction;
+
+    static void* const handlers[] = {
+#define __ENUMERATE_OP(name, ...) &&handle_##name,
+        ENUMERATE_WASM_PRECOMPILED_OTHER_OPS(__ENUMERATE_OP)
+            ENUMERATE_WASM_PRECOMPILED_BINARY_OPS(__ENUMERATE_OP)
+                ENUMERATE_WASM_PRECOMPILED_UNARY_OPS(__ENUMERATE_OP)
+                    ENUMERATE_WASM_PRECOMPILED_LOAD_OPS(__ENUMERATE_OP)
+                        ENUMERATE_WASM_PRECOMPILED_STORE_OPS(__ENUMERATE_OP)
+#undef __ENUMERATE_OP
+    };
+
+    Instruction const* instructions = function.instructions().data();
+    Instruction const* ip = instructions;
+    u64* slots = m_precompiled_slots.data() + window_base;
+
+    u8* memory_data = nullptr;
+    u64 memory_size = 0;
+    auto refresh_memory = [&] {
+        if (!memory_address.has_value())
+            return;
+        auto& memory = *configuration.store().get(*memory_address);
+        memory_data = memory.bytes().data();
+        memory_size = memory.size();
+    };
+    refresh_memory();
+
+    // Anything that may call out of this function may also resize the slots or the memory, or allocate
+    // in the store, which may move the memory instance itself. So we only ever hold on to its address.
+    auto refresh_after_call = [&] {
+        slots = m_precompiled_slots.data() + window_base;
+        refresh_memory();
+    };
+
+    auto trap = [&](StringView reason) -> Optional<u32> {
+        m_trap = Trap { reason };
+        return {};
+    };
+
+#define DISPATCH() goto* handlers[to_underlying(ip->opcode)]
+#define NEXT()      \
+    do {            \
+        ++ip;       \
+        DISPATCH(); \
+    } while (false)
+#define JUMP(target)                  \
+    do {                              \
+        ip = instructions + (target); \
+        DISPATCH();                   \
+    } while (false)
+
+    DISPATCH();
+
+handle_Unreachable:
+    return trap("Unreachable"sv);
+
+handle_Copy:
+    slots[ip->a] = slots[ip->b];
+    NEXT();
+
+handle_Select:
+    slots[ip->a] = static_cast<u32>(slots[ip->d]) != 0 ? slots[ip->b] : slots[ip->c];
+    NEXT();
+
+handle_Jump:
+    JUMP(ip->a);
+
+handle_JumpIfZero:
+    if (static_cast<u32>(slots[ip->a]) == 0)
+        JUMP(ip->b);
+    NEXT();
+
+handle_JumpIfNotZero:
+    if (static_cast<u32>(slots[ip->a]) != 0)
+        JUMP(ip->b);
+    NEXT();
+
+handle_BranchTable: {
+    auto const* entries = function.branch_table_targets().data() + ip->b;
+    auto index = static_cast<u32>(slots[ip->a]);
+    JUMP(index < ip->c ? entries[index] : entries[ip->c]);
+}
+
+handle_Return:
+    return ip->a;
+
+handle_Call: {
+    if (!call_from_precompiled(configuration, module.functions()[ip->a], window_base + ip->b))
+        return {};
+    refresh_after_call();
+    NEXT();
+}
+
+handle_CallIndirect: {
+    auto* table = configuration.store().get(module.tables()[ip->c]);
+    auto index = static_cast<u32>(slots[ip->d]);
+    if (index >= table->elements().size())
+        return trap("Undefined element in indirect call"sv);
+    auto const& element = table->elements()[index];
+    if (!element.has_value() || !element->ref().has<Reference::Func>())
+        return trap("Uninitialized element in indirect call"sv);
+    auto address = element->ref().get<Reference::Func>().address;
+
+    FunctionType const* type { nullptr };
+    configuration.store().get(address)->visit([&](auto const& function) { type = &function.type(); });
+    auto& expected_type = module.types()[ip->a];
+    if (type->parameters() != expected_type.parameters() || type->results() != expected_type.results())
+        return trap("Indirect call type mismatch"sv);
+
+    if (!call_from_precompiled(configuration, address, window_base + ip->b))
+        return {};
+    refresh_after_call();
+    NEXT();
+}
+
+handle_GlobalGet:
+    slots[ip->a] = value_to_raw(configuration.store().get(module.globals()[ip->b])->value());
+    NEXT();
+
+handle_GlobalSet: {
+    auto* global = configuration.store().get(module.globals()[ip->a]);
+    global->set_value(raw_to_value(global->value().type(), slots[ip->b]));
+    NEXT();
+}
+
+handle_MemorySize:
+    slots[ip->a] = to_raw(static_cast<i32>(memory_size / Constants::page_size));
+    NEXT();
+
+handle_MemoryGrow: {
+    auto old_pages = static_cast<i32>(memory_size / Constants::page_size);
+    auto new_pages = static_cast<u64>(static_cast<u32>(slots[ip->b]));
+    auto& memory = *configuration.store().get(*memory_address);
+    slots[ip->a] = to_raw(memory.grow(new_pages * Constants::page_size) ? old_pages : -1);
+    refresh_after_call();
+    NEXT();
+}
+
+handle_MemoryFill: {
+    auto destination = static_cast<u32>(slots[ip->a]);
+    auto value = static_cast<u8>(slots[ip->b]);
+    auto count = static_cast<u32>(slots[ip->c]);
+    if (static_cast<u64>(destination) + count > memory_size)
+        return trap("Memory access out of bounds"sv);
+    __builtin_memset(memory_data + destination, value, count);
+    NEXT();
+}
+
+handle_MemoryCopy: {
+    auto destination = static_cast<u32>(slots[ip->a]);
+    auto source = static_cast<u32>(slots[ip->b]);
+    auto count = static_cast<u32>(slots[ip->c]);
+    if (static_cast<u64>(source) + count > memory_size || static_cast<u64>(destination) + count > memory_size)
+        return trap("Memory access out of bounds"sv);
+    __builtin_memmove(memory_data + destination, memory_data + source, count);
+    NEXT();
+}
+
+#define __HANDLE_BINARY_OP(name, PopType, PushType, Operator)                                             \
+    handle_##name:                                                                                        \
+    {                                                                                                     \
+        auto call_result = Operator {}(from_raw<PopType>(slots[ip->b]), from_raw<PopType>(slots[ip->c])); \
+        if (auto error = store_result<PushType>(slots[ip->a], move(call_result)); error.has_value())      \
+            return trap(*error);                                                                          \
+        NEXT();                                                                                           \
+    }
+    ENUMERATE_WASM_PRECOMPILED_BINARY_OPS(__HANDLE_BINARY_OP)
+#undef __HANDLE_BINARY_OP
+
+#define __HANDLE_UNARY_OP(name, PopType, PushType, Operator)                                         \
+    handle_##name:                                                                                   \
+    {                                                                                                \
+        auto call_result = Operator {}(from_raw<PopType>(slots[ip->b]));                             \
+        if (auto error = store_result<PushType>(slots[ip->a], move(call_result)); error.has_value()) \
+            return trap(*error);                                                                     \
+        NEXT();                                                                                      \
+    }
+    ENUMERATE_WASM_PRECOMPILED_UNARY_OPS(__HANDLE_UNARY_OP)
+#undef __HANDLE_UNARY_OP
+
+#define __HANDLE_LOAD_OP(name, ReadType, PushType)                                                       \
+    handle_##name:                                                                                       \
+    {                                                                                                    \
+        auto address = static_cast<u64>(static_cast<u32>(slots[ip->b])) + ip->c;                         \
+        if constexpr (!memory_is_guarded) {                                                              \
+            if (address + sizeof(ReadType) > memory_size) [[unlikely]]                                   \
+                return trap("Memory access out of bounds"sv);                                            \
+        }                                                                                                \
+        slots[ip->a] = to_raw(static_cast<PushType>(read_from_memory<ReadType>(memory_data + address))); \
+        NEXT();                                                                                          \
+    }
+    ENUMERATE_WASM_PRECOMPILED_LOAD_OPS(__HANDLE_LOAD_OP)
+#undef __HANDLE_LOAD_OP
+
+#define __HANDLE_STORE_OP(name, StoreType, PopType)                                                      \
+    handle_##name:                                                                                       \
+    {                                                                                                    \
+        auto address = static_cast<u64>(static_cast<u32>(slots[ip->a])) + ip->c;                         \
+        if constexpr (!memory_is_guarded) {                                                              \
+            if (address + sizeof(StoreType) > memory_size) [[unlikely]]                                  \
+                return trap("Memory access out of bounds"sv);                                            \
+        }                                                                                                \
+        write_to_memory(memory_data + address, static_cast<StoreType>(from_raw<PopType>(slots[ip->b]))); \
+        NEXT();                                                                                          \
+    }
+    ENUMERATE_WASM_PRECOMPILED_STORE_OPS(__HANDLE_STORE_OP)
+#undef __HANDLE_STORE_OP
+
+#undef DISPATCH
+#undef NEXT
+#undef JUMP
+
+    VERIFY_NOT_REACHED();
+}
+
+}
@@ -14,6 +14,7 @@ namespace Web::Bindings {
 LegacyPlatformObject::LegacyPlatformObject(JS::Realm& realm)
     : PlatformObject(realm)
 {
+    set_may_interfere_with_indexed_property_access();
 }
 
 LegacyPlatformObject::~LegacyPlatformObject() = default;
@@ -166,9 +166,10 @@ inline Gfx::Painter::ScalingMode to_gfx_scaling_mode(CSS::ImageRendering css_val
 {
     switch (css_value) {
     case CSS::ImageRendering::Auto:
-    case CSS::ImageRendering::HighQuality:
     case CSS::ImageRendering::Smooth:
         return Gfx::Painter::ScalingMode::BilinearBlend;
+    case CSS::ImageRendering::HighQuality:
+        return Gfx::Painter::ScalingMode::Bicubic;
     case CSS::ImageRendering::CrispEdges:
         return Gfx::Painter::ScalingMode::NearestNeighbor;
     case CSS::ImageRendering::Pixelated:
@@ -0,0 +1,70 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Array.h>
+#include <AK/NumericLimits.h>
+#include <AK/Types.h>
+
+namespace Web::CSS {
+
+// A Bloom filter of 32-bit hashes that keys can also be removed from again. Each key is counted in two buckets, picked
+// by two different parts of its hash. A bucket that overflows stays full forever, which keeps the filter from ever
+// claiming that a key it has seen is missing.
+template<typename CounterType, size_t key_bits>
+class CountingBloomFilter {
+public:
+    void add(u32 hash)
+    {
+        increment(m_buckets[first_bucket(hash)]);
+        increment(m_buckets[second_bucket(hash)]);
+    }
+
+    void remove(u32 hash)
+    {
+        decrement(m_buckets[first_bucket(hash)]);
+        decrement(m_buckets[second_bucket(hash)]);
+    }
+
+    // False means the key is definitely not in the filter; true means it might be.
+    bool may_contain(u32 hash) const
+    {
+        return m_buckets[first_bucket(hash)] != 0 && m_buckets[second_bucket(hash)] != 0;
+    }
+
+    bool is_empty() const
+    {
+        for (auto counter : m_buckets) {
+            if (counter != 0)
+                return false;
+        }
+        return true;
+    }
+
+private:
+    static_assert(key_bits <= 16);
+    static constexpr u32 key_mask = (1u << key_bits) - 1;
+
+    static size_t first_bucket(u32 hash) { return hash & key_mask; }
+    static size_t second_bucket(u32 hash) { return (hash >> 16) & key_mask; }
+
+    static void increment(CounterType& counter)
+    {
+        if (counter != NumericLimits<CounterType>::max())
+            ++counter;
+    }
+
+    static void decrement(CounterType& counter)
+    {
+        if (counter != NumericLimits<CounterType>::max())
+            --counter;
+    }
+
+    Array<CounterType, 1u << key_bits> m_buckets {};
+};
+
+}
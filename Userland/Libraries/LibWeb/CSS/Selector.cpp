@@ -23,6 +23,69 @@ Selector::Selector(Vector<CompoundSelector>&& compound_selectors)
             }
         }
     }
+
+    for (auto const& compound_selector : m_compound_selectors) {
+        if (compound_selector.combinator == Combinator::NextSibling || compound_selector.combinator == Combinator::SubsequentSibling)
+            m_depends_on_siblings_or_children = true;
+        for (auto const& simple_selector : compound_selector.simple_selectors) {
+            if (simple_selector.type != SimpleSelector::Type::PseudoClass)
+                continue;
+            auto const& pseudo_class = simple_selector.pseudo_class();
+            switch (pseudo_class.type) {
+            case SimpleSelector::PseudoClass::Type::FirstChild:
+            case SimpleSelector::PseudoClass::Type::LastChild:
+            case SimpleSelector::PseudoClass::Type::OnlyChild:
+            case SimpleSelector::PseudoClass::Type::NthChild:
+            case SimpleSelector::PseudoClass::Type::NthLastChild:
+            case SimpleSelector::PseudoClass::Type::FirstOfType:
+            case SimpleSelector::PseudoClass::Type::LastOfType:
+            case SimpleSelector::PseudoClass::Type::OnlyOfType:
+            case SimpleSelector::PseudoClass::Type::NthOfType:
+            case SimpleSelector::PseudoClass::Type::NthLastOfType:
+            case SimpleSelector::PseudoClass::Type::Empty:
+                m_depends_on_siblings_or_children = true;
+                break;
+            default:
+                break;
+            }
+            for (auto const& argument_selector : pseudo_class.argument_selector_list) {
+                if (argument_selector->depends_on_siblings_or_children())
+                    m_depends_on_siblings_or_children = true;
+            }
+        }
+    }
+
+    collect_ancestor_hashes();
+}
+
+void Selector::collect_ancestor_hashes()
+{
+    // Everything to the left of a descendant or child combinator has to match an ancestor of the element. Compound
+    // selectors between the element and the first such combinator are about the element or its siblings instead.
+    if (m_compound_selectors.is_empty())
+        return;
+    bool is_ancestor = false;
+    for (size_t i = m_compound_selectors.size() - 1; i > 0; --i) {
+        auto combinator = m_compound_selectors[i].combinator;
+        if (combinator == Combinator::Descendant || combinator == Combinator::ImmediateChild)
+            is_ancestor = true;
+        if (!is_ancestor)
+            continue;
+
+        for (auto const& simple_selector : m_compound_selectors[i - 1].simple_selectors) {
+            switch (simple_selector.type) {
+            case SimpleSelector::Type::TagName:
+            case SimpleSelector::Type::Id:
+            case SimpleSelector::Type::Class:
+                m_ancestor_hashes.append(ancestor_filter_hash(simple_selector.name().bytes_as_string_view()));
+                if (m_ancestor_hashes.size() == max_ancestor_hashes)
+                    return;
+                break;
+            default:
+                break;
+            }
+        }
+    }
 }
 
 // https://www.w3.org/TR/selectors-4/#specificity-rules
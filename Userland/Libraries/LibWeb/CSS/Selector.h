@@ -10,6 +10,7 @@
 #include <AK/FlyString.h>
 #include <AK/RefCounted.h>
 #include <AK/String.h>
+#include <AK/StringHash.h>
 #include <AK/Vector.h>
 
 namespace Web::CSS {
@@ -204,12 +205,25 @@ public:
     u32 specificity() const;
     ErrorOr<String> serialize() const;
 
+    // Hashes of tag names, IDs and classes that some ancestor of every matching element has, so that an element
+    // can be rejected without walking its ancestors when a filter of the names of its ancestors has none of them.
+    static constexpr size_t max_ancestor_hashes = 8;
+    Vector<u32, max_ancestor_hashes> const& ancestor_hashes() const { return m_ancestor_hashes; }
+    static u32 ancestor_filter_hash(StringView name) { return AK::case_insensitive_string_hash(name.characters_without_null_termination(), name.length()); }
+
+    // Whether this can match one element but not another one with the same attributes and parent.
+    bool depends_on_siblings_or_children() const { return m_depends_on_siblings_or_children; }
+
 private:
     explicit Selector(Vector<CompoundSelector>&&);
 
+    void collect_ancestor_hashes();
+
     Vector<CompoundSelector> m_compound_selectors;
     mutable Optional<u32> m_specificity;
     Optional<Selector::PseudoElement> m_pseudo_element;
+    Vector<u32, max_ancestor_hashes> m_ancestor_hashes;
+    bool m_depends_on_siblings_or_children { false };
 };
 
 constexpr StringView pseudo_element_name(Selector::PseudoElement pseudo_element)
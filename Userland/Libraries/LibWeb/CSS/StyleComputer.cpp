@@ -50,7 +50,14 @@
 #include <LibWeb/DOM/Document.h>
 #include <LibWeb/DOM/Element.h>
 #include <LibWeb/FontCache.h>
+#include <LibWeb/HTML/HTMLButtonElement.h>
+#include <LibWeb/HTML/HTMLFieldSetElement.h>
 #include <LibWeb/HTML/HTMLHtmlElement.h>
+#include <LibWeb/HTML/HTMLInputElement.h>
+#include <LibWeb/HTML/HTMLOptGroupElement.h>
+#include <LibWeb/HTML/HTMLOptionElement.h>
+#include <LibWeb/HTML/HTMLSelectElement.h>
+#include <LibWeb/HTML/HTMLTextAreaElement.h>
 #include <LibWeb/Loader/ResourceLoader.h>
 #include <LibWeb/Platform/FontPlugin.h>
 #include <stdio.h>
@@ -217,16 +224,131 @@ Vector<MatchingRule> StyleComputer::collect_matching_rules(DOM::Element const& e
         add_rules_to_run(it->value);
     add_rules_to_run(rule_cache.other_rules);
 
+    bool const use_ancestor_filter = ancestor_filter_applies_to(element);
+
     Vector<MatchingRule> matching_rules;
     matching_rules.ensure_capacity(rules_to_run.size());
     for (auto const& rule_to_run : rules_to_run) {
         auto const& selector = rule_to_run.rule->selectors()[rule_to_run.selector_index];
+        ++m_statistics.rules_tested;
+        if (use_ancestor_filter && ancestor_filter_rejects(selector)) {
+            ++m_statistics.rules_rejected_by_ancestor_filter;
+            continue;
+        }
         if (SelectorEngine::matches(selector, element, pseudo_element))
             matching_rules.append(rule_to_run);
     }
     return matching_rules;
 }
 
+static void for_each_ancestor_filter_hash(DOM::Element const& element, auto callback)
+{
+    callback(Selector::ancestor_filter_hash(element.local_name().view()));
+    if (auto id = element.get_attribute(HTML::AttributeNames::id); !id.is_empty())
+        callback(Selector::ancestor_filter_hash(id.view()));
+    for (auto const& class_name : element.class_names())
+        callback(Selector::ancestor_filter_hash(class_name.bytes_as_string_view()));
+}
+
+void StyleComputer::push_ancestor(DOM::Element const& element)
+{
+    for_each_ancestor_filter_hash(element, [&](u32 hash) { m_ancestor_filter.add(hash); });
+    m_ancestors.append({ element, {} });
+}
+
+void StyleComputer::pop_ancestor(DOM::Element const& element)
+{
+    VERIFY(m_ancestors.last().element.ptr() == &element);
+    m_ancestors.take_last();
+    for_each_ancestor_filter_hash(element, [&](u32 hash) { m_ancestor_filter.remove(hash); });
+}
+
+bool StyleComputer::ancestor_filter_applies_to(DOM::Element const& element) const
+{
+    // NOTE: The filter is only filled in while we're styling the children of the innermost ancestor we were told about.
+    //       Each of those was pushed while styling the children of the one before it, so together they are all the
+    //       ancestors of the element.
+    return !m_ancestors.is_empty() && element.parent_element() == m_ancestors.last().element.ptr();
+}
+
+bool StyleComputer::ancestor_filter_rejects(Selector const& selector) const
+{
+    for (auto hash : selector.ancestor_hashes()) {
+        if (!m_ancestor_filter.may_contain(hash))
+            return true;
+    }
+    return false;
+}
+
+// Whether the style of the element follows from its attributes, its parent and the style sheets alone.
+static bool style_depends_only_on_attributes_and_parent(DOM::Element const& element)
+{
+    if (element.inline_style() || element.shadow_root_internal() || !element.is_defined())
+        return false;
+
+    // Form controls can be :checked, :disabled or :indeterminate regardless of their attributes.
+    if (is<HTML::HTMLButtonElement>(element) || is<HTML::HTMLInputElement>(element) || is<HTML::HTMLSelectElement>(element) || is<HTML::HTMLTextAreaElement>(element) || is<HTML::HTMLOptGroupElement>(element) || is<HTML::HTMLOptionElement>(element) || is<HTML::HTMLFieldSetElement>(element))
+        return false;
+
+    if (element.is_active())
+        return false;
+    auto const& document = element.document();
+    if (auto const* hovered_node = document.hovered_node(); hovered_node && element.is_inclusive_ancestor_of(*hovered_node))
+        return false;
+    if (auto const* focused_element = document.focused_element(); focused_element && element.is_inclusive_ancestor_of(*focused_element))
+        return false;
+    return true;
+}
+
+static bool have_same_attributes(DOM::Element const& a, DOM::Element const& b)
+{
+    if (a.attribute_list_size() != b.attribute_list_size())
+        return false;
+    bool same = true;
+    a.for_each_attribute([&](auto const& name, auto const& value) {
+        if (same && b.get_attribute(name) != value)
+            same = false;
+    });
+    return same;
+}
+
+RefPtr<StyleProperties> StyleComputer::find_shareable_style(DOM::Element& element) const
+{
+    if (!ancestor_filter_applies_to(element))
+        return nullptr;
+    if (m_author_rule_cache->has_selectors_depending_on_siblings_or_children || m_user_agent_rule_cache->has_selectors_depending_on_siblings_or_children)
+        return nullptr;
+    if (!style_depends_only_on_attributes_and_parent(element))
+        return nullptr;
+
+    auto const& candidates = m_ancestors.last().style_sharing_candidates;
+    for (size_t i = candidates.size(); i > 0; --i) {
+        auto& candidate = *candidates[i - 1];
+        if (!candidate.computed_css_values())
+            continue;
+        if (candidate.local_name() != element.local_name() || candidate.namespace_() != element.namespace_())
+            continue;
+        if (!have_same_attributes(candidate, element) || !style_depends_only_on_attributes_and_parent(candidate))
+            continue;
+
+        element.set_custom_properties(candidate.custom_properties());
+        ++m_statistics.styles_shared;
+        return candidate.computed_css_values();
+    }
+    return nullptr;
+}
+
+void StyleComputer::add_style_sharing_candidate(DOM::Element& element) const
+{
+    if (!ancestor_filter_applies_to(element) || !style_depends_only_on_attributes_and_parent(element))
+        return;
+
+    auto& candidates = m_ancestors.last().style_sharing_candidates;
+    if (candidates.size() == max_style_sharing_candidates)
+        candidates.remove(0);
+    candidates.append(element);
+}
+
 static void sort_matching_rules(Vector<MatchingRule>& matching_rules)
 {
     quick_sort(matching_rules, [&](MatchingRule& a, MatchingRule& b) {
@@ -1503,7 +1625,16 @@ NonnullRefPtr<StyleProperties> StyleComputer::create_document_style() const
 
 ErrorOr<NonnullRefPtr<StyleProperties>> StyleComputer::compute_style(DOM::Element& element, Optional<CSS::Selector::PseudoElement> pseudo_element) const
 {
-    auto style = TRY(compute_style_impl(element, move(pseudo_element), ComputeStyleMode::Normal));
+    if (!pseudo_element.has_value()) {
+        build_rule_cache_if_needed();
+        if (auto shared_style = find_shareable_style(element))
+            return shared_style.release_nonnull();
+    }
+
+    auto style = TRY(compute_style_impl(element, pseudo_element, ComputeStyleMode::Normal));
+    ++m_statistics.styles_computed;
+    if (!pseudo_element.has_value())
+        add_style_sharing_candidate(element);
     return style.release_nonnull();
 }
 
@@ -1608,6 +1739,9 @@ NonnullOwnPtr<StyleComputer::RuleCache> StyleComputer::make_rule_cache_for_casca
                     }
                 }
 
+                if (selector.depends_on_siblings_or_children())
+                    rule_cache->has_selectors_depending_on_siblings_or_children = true;
+
                 bool added_to_bucket = false;
                 for (auto const& simple_selector : selector.compound_selectors().last().simple_selectors) {
                     if (simple_selector.type == CSS::Selector::SimpleSelector::Type::Id) {
@@ -1655,6 +1789,10 @@ void StyleComputer::build_rule_cache()
 {
     m_author_rule_cache = make_rule_cache_for_cascade_origin(CascadeOrigin::Author);
     m_user_agent_rule_cache = make_rule_cache_for_cascade_origin(CascadeOrigin::UserAgent);
+
+    // Styles shared before the rules changed might not be the same anymore.
+    for (auto& ancestor : m_ancestors)
+        ancestor.style_sharing_candidates.clear();
 }
 
 void StyleComputer::invalidate_rule_cache()
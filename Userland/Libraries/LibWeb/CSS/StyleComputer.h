@@ -12,6 +12,7 @@
 #include <AK/OwnPtr.h>
 #include <LibWeb/CSS/CSSFontFaceRule.h>
 #include <LibWeb/CSS/CSSStyleDeclaration.h>
+#include <LibWeb/CSS/CountingBloomFilter.h>
 #include <LibWeb/CSS/Parser/ComponentValue.h>
 #include <LibWeb/CSS/Parser/TokenStream.h>
 #include <LibWeb/CSS/Selector.h>
@@ -73,6 +74,22 @@ public:
 
     void invalidate_rule_cache();
 
+    // Called around styling the children of each element during a style update, so that selectors can be rejected
+    // without walking up the ancestors of an element, and siblings can share their computed style.
+    void push_ancestor(DOM::Element const&);
+    void pop_ancestor(DOM::Element const&);
+
+    struct Statistics {
+        size_t styles_computed { 0 };
+        size_t styles_shared { 0 };
+        size_t rules_tested { 0 };
+        size_t rules_rejected_by_ancestor_filter { 0 };
+    };
+    Statistics const& statistics() const { return m_statistics; }
+    void reset_statistics() { m_statistics = {}; }
+
+    CountingBloomFilter<u8, 14> const& ancestor_filter() const { return m_ancestor_filter; }
+
     Gfx::Font const& initial_font() const;
 
     void did_load_font(FlyString const& family_name);
@@ -116,6 +133,12 @@ private:
     void build_rule_cache();
     void build_rule_cache_if_needed() const;
 
+    bool ancestor_filter_applies_to(DOM::Element const&) const;
+    bool ancestor_filter_rejects(Selector const&) const;
+
+    RefPtr<StyleProperties> find_shareable_style(DOM::Element&) const;
+    void add_style_sharing_candidate(DOM::Element&) const;
+
     JS::NonnullGCPtr<DOM::Document> m_document;
 
     struct RuleCache {
@@ -123,6 +146,7 @@ private:
         HashMap<FlyString, Vector<MatchingRule>> rules_by_class;
         HashMap<FlyString, Vector<MatchingRule>> rules_by_tag_name;
         Vector<MatchingRule> other_rules;
+        bool has_selectors_depending_on_siblings_or_children { false };
     };
 
     NonnullOwnPtr<RuleCache> make_rule_cache_for_cascade_origin(CascadeOrigin);
@@ -132,6 +156,17 @@ private:
     OwnPtr<RuleCache> m_author_rule_cache;
     OwnPtr<RuleCache> m_user_agent_rule_cache;
 
+    static constexpr size_t max_style_sharing_candidates = 4;
+    struct Ancestor {
+        JS::NonnullGCPtr<DOM::Element const> element;
+        // The most recently styled children of the element, whose style might be shared with their later siblings.
+        Vector<JS::NonnullGCPtr<DOM::Element>, max_style_sharing_candidates> style_sharing_candidates;
+    };
+    Vector<Ancestor> mutable m_ancestors;
+    CountingBloomFilter<u8, 14> m_ancestor_filter;
+
+    Statistics mutable m_statistics;
+
     class FontLoader;
     HashMap<String, NonnullOwnPtr<FontLoader>> m_loaded_fonts;
 };
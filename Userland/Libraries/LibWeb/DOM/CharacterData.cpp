@@ -10,6 +10,7 @@
 #include <LibWeb/DOM/MutationType.h>
 #include <LibWeb/DOM/Range.h>
 #include <LibWeb/DOM/StaticNodeList.h>
+#include <LibWeb/Layout/Node.h>
 
 namespace Web::DOM {
 
@@ -113,7 +114,12 @@ WebIDL::ExceptionOr<void> CharacterData::replace_data(size_t offset, size_t coun
         parent()->children_changed();
 
     set_needs_style_update(true);
-    document().set_needs_layout();
+
+    // Only the text itself changed, so the rest of the layout can be reused.
+    if (auto* layout_node = this->layout_node())
+        layout_node->set_needs_layout();
+    else
+        document().set_needs_layout();
     return {};
 }
 
@@ -72,6 +72,7 @@
 #include <LibWeb/Layout/Viewport.h>
 #include <LibWeb/Namespace.h>
 #include <LibWeb/Page/Page.h>
+#include <LibWeb/Page/PhaseTimings.h>
 #include <LibWeb/PermissionsPolicy/AutoplayAllowlist.h>
 #include <LibWeb/Platform/Timer.h>
 #include <LibWeb/SVG/TagNames.h>
@@ -468,7 +469,17 @@ WebIDL::ExceptionOr<Document*> Document::open(DeprecatedString const&, Deprecate
     if (m_active_parser_was_aborted)
         return this;
 
-    // FIXME: 8. If document's browsing context is non-null and there is an existing attempt to navigate document's browsing context, then stop document loading given document.
+    // 8. If document's browsing context is non-null and there is an existing attempt to navigate document's browsing context, then stop document loading given document.
+    // NOTE: We don't track a navigation past the point where its response has been handed to a parser, which is then
+    //       fed the rest of the document a chunk at a time. That parser must not keep inserting nodes into the document
+    //       (and eventually run "the end" on it) after it has been given a new parser below, so we stop it here.
+    if (browsing_context() && m_parser && m_parser->is_fed_incrementally() && !m_parser->aborted()) {
+        stop_document_loading();
+
+        // NOTE: Aborting the document sets its "active parser was aborted" flag, which would make every document.write()
+        //       on the parser we create in step 16 a no-op. That parser is the document's active parser from then on.
+        m_active_parser_was_aborted = false;
+    }
 
     // FIXME: 9. For each shadow-including inclusive descendant node of document, erase all event listeners and handlers given node.
 
@@ -718,6 +729,7 @@ void Document::tear_down_layout_tree()
     }
 
     m_layout_root = nullptr;
+    m_last_layout_state = nullptr;
 }
 
 Color Document::background_color(Gfx::Palette const& palette) const
@@ -807,6 +819,17 @@ AK::URL Document::parse_url(DeprecatedString const& url) const
 }
 
 void Document::set_needs_layout()
+{
+    // We don't know what changed, so none of the last layout can be reused.
+    m_last_layout_state = nullptr;
+
+    if (m_needs_layout)
+        return;
+    m_needs_layout = true;
+    schedule_layout_update();
+}
+
+void Document::set_needs_partial_layout(Badge<Layout::Node>)
 {
     if (m_needs_layout)
         return;
@@ -845,6 +868,7 @@ void Document::update_layout()
     if (!browsing_context())
         return;
 
+    PhaseTimer timer(Phase::Layout);
     auto viewport_rect = browsing_context()->viewport_rect();
 
     if (!m_layout_root) {
@@ -853,9 +877,14 @@ void Document::update_layout()
         m_layout_root = verify_cast<Layout::Viewport>(*tree_builder.build(*this));
     }
 
-    Layout::LayoutState layout_state;
+    // NOTE: The LayoutState is kept around after the layout, so it has to live on the heap.
+    auto layout_state_ptr = make<Layout::LayoutState>();
+    auto& layout_state = *layout_state_ptr;
     layout_state.used_values_per_layout_node.resize(layout_node_count());
 
+    auto previous_layout_state = move(m_last_layout_state);
+    layout_state.previous_layout = previous_layout_state.ptr();
+
     {
         Layout::BlockFormattingContext root_formatting_context(layout_state, *m_layout_root, nullptr);
 
@@ -874,6 +903,10 @@ void Document::update_layout()
 
     layout_state.commit();
 
+    layout_state.previous_layout = nullptr;
+    m_last_layout_state = move(layout_state_ptr);
+    m_layout_root->clear_needs_layout();
+
     browsing_context()->set_needs_display();
 
     if (browsing_context()->is_top_level() && browsing_context()->active_document() == this) {
@@ -898,6 +931,10 @@ void Document::update_layout()
     node.set_needs_style_update(false);
 
     if (needs_full_style_update || node.child_needs_style_update()) {
+        auto& style_computer = node.document().style_computer();
+        if (node.is_element())
+            style_computer.push_ancestor(static_cast<Element&>(node));
+
         if (node.is_element()) {
             if (auto* shadow_root = static_cast<DOM::Element&>(node).shadow_root_internal()) {
                 if (needs_full_style_update || shadow_root->needs_style_update() || shadow_root->child_needs_style_update())
@@ -909,6 +946,9 @@ void Document::update_layout()
                 needs_relayout |= update_style_recursively(child);
             return IterationDecision::Continue;
         });
+
+        if (node.is_element())
+            style_computer.pop_ancestor(static_cast<Element&>(node));
     }
 
     node.set_child_needs_style_update(false);
@@ -926,11 +966,19 @@ void Document::update_style()
     if (m_created_for_appropriate_template_contents)
         return;
 
+    PhaseTimer timer(Phase::Style);
     evaluate_media_rules();
+    style_computer().reset_statistics();
     if (update_style_recursively(*this))
         invalidate_layout();
     m_needs_full_style_update = false;
     m_style_update_timer->stop();
+
+    if constexpr (LIBWEB_CSS_DEBUG) {
+        auto const& statistics = style_computer().statistics();
+        dbgln("Updated style: {} computed, {} shared, {} rules tested, {} of them rejected by the ancestor filter",
+            statistics.styles_computed, statistics.styles_shared, statistics.rules_tested, statistics.rules_rejected_by_ancestor_filter);
+    }
 }
 
 void Document::set_link_color(Color color)
@@ -1890,8 +1938,11 @@ void Document::set_parser(Badge<HTML::HTMLParser>, HTML::HTMLParser& parser)
     m_parser = parser;
 }
 
-void Document::detach_parser(Badge<HTML::HTMLParser>)
+void Document::detach_parser(Badge<HTML::HTMLParser>, HTML::HTMLParser& parser)
 {
+    // NOTE: document.open() may have replaced the parser that is finishing up with a new one in the meantime.
+    if (m_parser != &parser)
+        return;
     m_parser = nullptr;
 }
 
@@ -2291,6 +2342,22 @@ void Document::abort()
     }
 }
 
+// https://html.spec.whatwg.org/multipage/browsing-the-web.html#stop-document-loading
+void Document::stop_document_loading()
+{
+    // 1. Let browsingContext be document's browsing context.
+    auto* browsing_context = this->browsing_context();
+
+    // 2. If browsingContext's active document is not document, then return.
+    if (!browsing_context || browsing_context->active_document() != this)
+        return;
+
+    // FIXME: 3. If there is an existing attempt to navigate browsingContext and document's unload counter is 0, then cancel that navigation.
+
+    // 4. Abort document.
+    abort();
+}
+
 // https://html.spec.whatwg.org/multipage/dom.html#active-parser
 JS::GCPtr<HTML::HTMLParser> Document::active_parser()
 {
@@ -196,8 +196,12 @@ public:
     void update_style();
     void update_layout();
 
+    // Relayouts everything on the next layout update, reusing the layout tree.
     void set_needs_layout();
 
+    // Relayouts only the layout nodes that were marked as needing it, see Layout::Node::set_needs_layout().
+    void set_needs_partial_layout(Badge<Layout::Node>);
+
     void invalidate_layout();
     void invalidate_stacking_context_tree();
 
@@ -378,7 +382,7 @@ public:
     bool has_focus() const;
 
     void set_parser(Badge<HTML::HTMLParser>, HTML::HTMLParser&);
-    void detach_parser(Badge<HTML::HTMLParser>);
+    void detach_parser(Badge<HTML::HTMLParser>, HTML::HTMLParser&);
 
     static bool is_valid_name(DeprecatedString const&);
 
@@ -444,6 +448,9 @@ public:
     // https://html.spec.whatwg.org/multipage/browsing-the-web.html#abort-a-document
     void abort();
 
+    // https://html.spec.whatwg.org/multipage/browsing-the-web.html#stop-document-loading
+    void stop_document_loading();
+
     // https://html.spec.whatwg.org/multipage/browsing-the-web.html#unload-a-document
     void unload(bool recursive_flag = false, Optional<DocumentUnloadTimingInfo> = {});
 
@@ -498,6 +505,9 @@ private:
 
     JS::GCPtr<Layout::Viewport> m_layout_root;
 
+    // The used values of the last layout, which lets a partial layout skip the subtrees that haven't changed.
+    OwnPtr<Layout::LayoutState> m_last_layout_state;
+
     Optional<Color> m_link_color;
     Optional<Color> m_active_link_color;
     Optional<Color> m_visited_link_color;
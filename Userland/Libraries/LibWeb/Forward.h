@@ -377,6 +377,7 @@ class Path2D;
 class Plugin;
 class PluginArray;
 class PromiseRejectionEvent;
+class SpeculativeHTMLParser;
 class Storage;
 class SubmitEvent;
 class TextMetrics;
@@ -166,8 +166,17 @@ WebIDL::ExceptionOr<void> CanvasRenderingContext2D::draw_image_internal(CanvasIm
     draw_clipped([&](auto& painter) {
         auto scaling_mode = Gfx::Painter::ScalingMode::NearestNeighbor;
         if (drawing_state().image_smoothing_enabled) {
-            // FIXME: Honor drawing_state().image_smoothing_quality
-            scaling_mode = Gfx::Painter::ScalingMode::BilinearBlend;
+            switch (drawing_state().image_smoothing_quality) {
+            case Bindings::ImageSmoothingQuality::Low:
+                scaling_mode = Gfx::Painter::ScalingMode::BilinearBlend;
+                break;
+            case Bindings::ImageSmoothingQuality::Medium:
+                scaling_mode = Gfx::Painter::ScalingMode::Bicubic;
+                break;
+            case Bindings::ImageSmoothingQuality::High:
+                scaling_mode = Gfx::Painter::ScalingMode::Lanczos;
+                break;
+            }
         }
 
         painter.underlying_painter().draw_scaled_bitmap_with_transform(destination_rect.to_rounded<int>(), *bitmap, source_rect, drawing_state().transform, 1.0f, scaling_mode);
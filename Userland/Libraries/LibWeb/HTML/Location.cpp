@@ -25,6 +25,7 @@ namespace Web::HTML {
 Location::Location(JS::Realm& realm)
     : PlatformObject(realm)
 {
+    set_may_interfere_with_indexed_property_access();
 }
 
 Location::~Location() = default;
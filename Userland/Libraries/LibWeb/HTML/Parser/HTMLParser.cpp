@@ -7,6 +7,7 @@
 
 #include <AK/Debug.h>
 #include <AK/SourceLocation.h>
+#include <AK/TemporaryChange.h>
 #include <AK/Utf32View.h>
 #include <LibTextCodec/Decoder.h>
 #include <LibWeb/Bindings/MainThreadVM.h>
@@ -30,10 +31,12 @@
 #include <LibWeb/HTML/Parser/HTMLEncodingDetection.h>
 #include <LibWeb/HTML/Parser/HTMLParser.h>
 #include <LibWeb/HTML/Parser/HTMLToken.h>
+#include <LibWeb/HTML/Parser/SpeculativeHTMLParser.h>
 #include <LibWeb/HTML/Window.h>
 #include <LibWeb/HighResolutionTime/TimeOrigin.h>
 #include <LibWeb/Infra/CharacterTypes.h>
 #include <LibWeb/Namespace.h>
+#include <LibWeb/Page/PhaseTimings.h>
 #include <LibWeb/SVG/TagNames.h>
 
 namespace Web::HTML {
@@ -163,6 +166,7 @@ void HTMLParser::visit_edges(Cell::Visitor& visitor)
 
 void HTMLParser::run()
 {
+    PhaseTimer timer(Phase::Parse);
     for (;;) {
         // FIXME: Find a better way to say that we come from Document::close() and want to process EOF.
         if (!m_tokenizer.is_eof_inserted() && m_tokenizer.is_insertion_point_reached())
@@ -214,7 +218,67 @@ void HTMLParser::run(const AK::URL& url)
     m_document->set_source(m_tokenizer.source());
     run();
     the_end();
-    m_document->detach_parser({});
+    m_document->detach_parser({}, *this);
+}
+
+void HTMLParser::append_input(StringView input)
+{
+    // https://html.spec.whatwg.org/multipage/parsing.html#abort-a-parser
+    // Any future content that would have been added to the input stream of an aborted parser is discarded.
+    if (m_aborted)
+        return;
+
+    m_tokenizer.append_to_input_stream(input);
+    if (m_speculative_parser) {
+        m_speculative_parser->append_input(input);
+        if (m_speculative_parser_is_active)
+            m_speculative_parser->run(*m_document);
+    }
+    parse_available_input();
+}
+
+void HTMLParser::finish_input(Function<void()> on_finished)
+{
+    if (m_aborted)
+        return;
+
+    m_on_finished = move(on_finished);
+    m_tokenizer.close_input_stream();
+    if (m_speculative_parser)
+        m_speculative_parser->close_input();
+    parse_available_input();
+}
+
+void HTMLParser::parse_available_input()
+{
+    // If the parser is already running further up the stack, e.g. waiting for a parser-blocking script in a nested
+    // event loop, it picks up the new input once it gets going again.
+    if (m_is_parsing_available_input)
+        return;
+
+    {
+        TemporaryChange change(m_is_parsing_available_input, true);
+        run();
+    }
+
+    if (m_aborted || !m_tokenizer.is_input_stream_closed())
+        return;
+
+    the_end();
+    m_document->detach_parser({}, *this);
+    if (auto on_finished = move(m_on_finished))
+        on_finished();
+}
+
+// https://html.spec.whatwg.org/multipage/parsing.html#start-the-speculative-html-parser
+void HTMLParser::start_the_speculative_html_parser()
+{
+    // NOTE: The speculative parser is kept around between scripts, as it has usually already looked through all of
+    //       the input the parser has now caught up with, and only needs to continue from where it left off.
+    if (!m_speculative_parser)
+        m_speculative_parser = make<SpeculativeHTMLParser>(m_tokenizer.unconsumed_input(), m_tokenizer.is_input_stream_closed());
+    m_speculative_parser_is_active = true;
+    m_speculative_parser->run(*m_document);
 }
 
 // https://html.spec.whatwg.org/multipage/parsing.html#the-end
@@ -244,7 +308,10 @@ void HTMLParser::the_end()
     if (m_parsing_fragment)
         return;
 
-    // FIXME: 1. If the active speculative HTML parser is not null, then stop the speculative HTML parser and return.
+    // 1. If the active speculative HTML parser is not null, then stop the speculative HTML parser and return.
+    // NOTE: Our speculative HTML parser never runs "the end" itself, so there's nothing to return from here.
+    m_speculative_parser = nullptr;
+    m_speculative_parser_is_active = false;
 
     // 2. Set the insertion point to undefined.
     m_tokenizer.undefine_insertion_point();
@@ -2386,7 +2453,8 @@ void HTMLParser::handle_text(HTMLToken& token)
                     // 2. Set the pending parsing-blocking script to null.
                     auto the_script = document().take_pending_parsing_blocking_script({});
 
-                    // FIXME: 3. Start the speculative HTML parser for this instance of the HTML parser.
+                    // 3. Start the speculative HTML parser for this instance of the HTML parser.
+                    start_the_speculative_html_parser();
 
                     // 4. Block the tokenizer for this instance of the HTML parser, such that the event loop will not run tasks that invoke the tokenizer.
                     m_tokenizer.set_blocked(true);
@@ -2405,7 +2473,8 @@ void HTMLParser::handle_text(HTMLToken& token)
                     if (m_aborted)
                         return;
 
-                    // FIXME: 7. Stop the speculative HTML parser for this instance of the HTML parser.
+                    // 7. Stop the speculative HTML parser for this instance of the HTML parser.
+                    m_speculative_parser_is_active = false;
 
                     // 8. Unblock the tokenizer for this instance of the HTML parser, such that tasks that invoke the tokenizer can again be run.
                     m_tokenizer.set_blocked(false);
@@ -3622,6 +3691,14 @@ JS::NonnullGCPtr<HTMLParser> HTMLParser::create(DOM::Document& document, StringV
     return document.heap().allocate_without_realm<HTMLParser>(document, input, encoding);
 }
 
+JS::NonnullGCPtr<HTMLParser> HTMLParser::create_for_incremental_input(DOM::Document& document, DeprecatedString const& encoding)
+{
+    auto parser = document.heap().allocate_without_realm<HTMLParser>(document, ""sv, encoding);
+    parser->m_is_fed_incrementally = true;
+    parser->m_tokenizer.open_input_stream();
+    return parser;
+}
+
 // https://html.spec.whatwg.org/multipage/parsing.html#html-fragment-serialisation-algorithm
 DeprecatedString HTMLParser::serialize_html_fragment(DOM::Node const& node)
 {
@@ -3947,7 +4024,9 @@ void HTMLParser::abort()
     // 1. Throw away any pending content in the input stream, and discard any future content that would have been added to it.
     m_tokenizer.abort();
 
-    // FIXME: 2. Stop the speculative HTML parser for this HTML parser.
+    // 2. Stop the speculative HTML parser for this HTML parser.
+    m_speculative_parser = nullptr;
+    m_speculative_parser_is_active = false;
 
     // 3. Update the current document readiness to "interactive".
     m_document->update_readiness(DocumentReadyState::Interactive);
@@ -51,6 +51,14 @@ public:
     static JS::NonnullGCPtr<HTMLParser> create_with_uncertain_encoding(DOM::Document&, ByteBuffer const& input);
     static JS::NonnullGCPtr<HTMLParser> create(DOM::Document&, StringView input, DeprecatedString const& encoding);
 
+    // Creates a parser that is given its (already decoded) input a piece at a time with append_input(), e.g. as it
+    // arrives from the network, and parses as much of it as it can each time. Once finish_input() has been called, it
+    // parses the rest of the document, runs "the end", and then calls `on_finished`.
+    static JS::NonnullGCPtr<HTMLParser> create_for_incremental_input(DOM::Document&, DeprecatedString const& encoding);
+    void append_input(StringView);
+    void finish_input(Function<void()> on_finished);
+    bool is_fed_incrementally() const { return m_is_fed_incrementally; }
+
     void run();
     void run(const AK::URL&);
 
@@ -115,6 +123,9 @@ private:
 
     void the_end();
 
+    void parse_available_input();
+    void start_the_speculative_html_parser();
+
     void stop_parsing() { m_stop_parsing = true; }
 
     void generate_implied_end_tags(DeprecatedFlyString const& exception = {});
@@ -196,6 +207,14 @@ private:
 
     JS::GCPtr<DOM::Text> m_character_insertion_node;
     StringBuilder m_character_insertion_builder;
+
+    bool m_is_fed_incrementally { false };
+    bool m_is_parsing_available_input { false };
+    Function<void()> m_on_finished;
+
+    // https://html.spec.whatwg.org/multipage/parsing.html#active-speculative-html-parser
+    OwnPtr<SpeculativeHTMLParser> m_speculative_parser;
+    bool m_speculative_parser_is_active { false };
 };
 
 RefPtr<CSS::StyleValue> parse_dimension_value(StringView);
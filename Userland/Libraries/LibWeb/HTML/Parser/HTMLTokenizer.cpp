@@ -20,8 +20,19 @@ namespace Web::HTML {
 
 #pragma GCC diagnostic ignored "-Wunused-label"
 
-#define CONSUME_NEXT_INPUT_CHARACTER \
-    current_input_character = next_code_point();
+#define CONSUME_NEXT_INPUT_CHARACTER                                    \
+    current_input_character = next_code_point();                        \
+    if (!current_input_character.has_value() && !m_input_stream_closed) \
+        PAUSE_UNTIL_MORE_INPUT_ARRIVES;
+
+// Returns to the caller without changing the state, so that the next call picks up where this one left off.
+#define PAUSE_UNTIL_MORE_INPUT_ARRIVES        \
+    do {                                      \
+        m_paused = true;                      \
+        if (!m_queued_tokens.is_empty())      \
+            return m_queued_tokens.dequeue(); \
+        return {};                            \
+    } while (0)
 
 #define SWITCH_TO(new_state)                       \
     do {                                           \
@@ -188,6 +199,10 @@ Optional<u32> HTMLTokenizer::next_code_point()
     if (m_utf8_iterator == m_utf8_view.end())
         return {};
 
+    // A CR at the end of the input so far may turn out to be the first half of a CRLF pair.
+    if (!m_input_stream_closed && peek_code_point(0).value_or(0) == '\r' && !peek_code_point(1).has_value())
+        return {};
+
     u32 code_point;
     // https://html.spec.whatwg.org/multipage/parsing.html#preprocessing-the-input-stream:tokenization
     // https://infra.spec.whatwg.org/#normalize-newlines
@@ -237,6 +252,13 @@ Optional<u32> HTMLTokenizer::peek_code_point(size_t offset) const
     return *it;
 }
 
+// Whether the states that look at more than one code point at a time have to wait for more input before deciding what
+// they've got, because the input stream is still open and doesn't have `code_point_count` code points left yet.
+bool HTMLTokenizer::needs_more_input_to_look_ahead(size_t code_point_count) const
+{
+    return !m_input_stream_closed && !peek_code_point(code_point_count - 1).has_value();
+}
+
 HTMLToken::Position HTMLTokenizer::nth_last_position(size_t n)
 {
     if (n + 1 > m_source_positions.size()) {
@@ -248,7 +270,8 @@ HTMLToken::Position HTMLTokenizer::nth_last_position(size_t n)
 
 Optional<HTMLToken> HTMLTokenizer::next_token()
 {
-    if (!m_source_positions.is_empty()) {
+    // After a pause, the positions from before it are still needed for the token that was in progress.
+    if (!m_source_positions.is_empty() && !exchange(m_paused, false)) {
         auto last_position = m_source_positions.last();
         m_source_positions.clear_with_capacity();
         m_source_positions.append(move(last_position));
@@ -262,6 +285,8 @@ _StartOfFunction:
 
     for (;;) {
         auto current_input_character = next_code_point();
+        if (!current_input_character.has_value() && !m_input_stream_closed)
+            PAUSE_UNTIL_MORE_INPUT_ARRIVES;
         switch (m_state) {
             // 13.2.5.1 Data state, https://html.spec.whatwg.org/multipage/parsing.html#data-state
             BEGIN_STATE(Data)
@@ -410,6 +435,8 @@ _StartOfFunction:
             BEGIN_STATE(MarkupDeclarationOpen)
             {
                 DONT_CONSUME_NEXT_INPUT_CHARACTER;
+                if (needs_more_input_to_look_ahead("[CDATA["sv.length()))
+                    PAUSE_UNTIL_MORE_INPUT_ARRIVES;
                 if (consume_next_if_match("--"sv)) {
                     create_new_token(HTMLToken::Type::Comment);
                     m_current_token.set_start_position({}, nth_last_position(3));
@@ -598,6 +625,10 @@ _StartOfFunction:
                 }
                 ANYTHING_ELSE
                 {
+                    if (needs_more_input_to_look_ahead("UBLIC"sv.length())) {
+                        DONT_CONSUME_NEXT_INPUT_CHARACTER;
+                        PAUSE_UNTIL_MORE_INPUT_ARRIVES;
+                    }
                     if (to_ascii_uppercase(current_input_character.value()) == 'P' && consume_next_if_match("UBLIC"sv, CaseSensitivity::CaseInsensitive)) {
                         SWITCH_TO(AfterDOCTYPEPublicKeyword);
                     }
@@ -1638,9 +1669,15 @@ _StartOfFunction:
             // 13.2.5.73 Named character reference state, https://html.spec.whatwg.org/multipage/parsing.html#named-character-reference-state
             BEGIN_STATE(NamedCharacterReference)
             {
+                // The longest entity is 32 code points long, and we need to see the one after it as well.
+                if (needs_more_input_to_look_ahead(32)) {
+                    DONT_CONSUME_NEXT_INPUT_CHARACTER;
+                    PAUSE_UNTIL_MORE_INPUT_ARRIVES;
+                }
+
                 size_t byte_offset = m_utf8_view.byte_offset_of(m_prev_utf8_iterator);
 
-                auto match = HTML::code_points_from_entity(m_decoded_input.substring_view(byte_offset, m_decoded_input.length() - byte_offset));
+                auto match = HTML::code_points_from_entity(m_decoded_input.string_view().substring_view(byte_offset));
 
                 if (match.has_value()) {
                     skip(match->entity.length() - 1);
@@ -2789,8 +2826,7 @@ void HTMLTokenizer::create_new_token(HTMLToken::Type type)
 
 HTMLTokenizer::HTMLTokenizer()
 {
-    m_decoded_input = "";
-    m_utf8_view = Utf8View(m_decoded_input);
+    m_utf8_view = Utf8View(m_decoded_input.string_view());
     m_utf8_iterator = m_utf8_view.begin();
     m_prev_utf8_iterator = m_utf8_view.begin();
     m_source_positions.empend(0u, 0u);
@@ -2800,8 +2836,8 @@ HTMLTokenizer::HTMLTokenizer(StringView input, DeprecatedString const& encoding)
 {
     auto decoder = TextCodec::decoder_for(encoding);
     VERIFY(decoder.has_value());
-    m_decoded_input = decoder->to_utf8(input).release_value_but_fixme_should_propagate_errors().to_deprecated_string();
-    m_utf8_view = Utf8View(m_decoded_input);
+    m_decoded_input.append(decoder->to_utf8(input).release_value_but_fixme_should_propagate_errors());
+    m_utf8_view = Utf8View(m_decoded_input.string_view());
     m_utf8_iterator = m_utf8_view.begin();
     m_prev_utf8_iterator = m_utf8_view.begin();
     m_source_positions.empend(0u, 0u);
@@ -2810,20 +2846,45 @@ HTMLTokenizer::HTMLTokenizer(StringView input, DeprecatedString const& encoding)
 void HTMLTokenizer::insert_input_at_insertion_point(DeprecatedString const& input)
 {
     auto utf8_iterator_byte_offset = m_utf8_view.byte_offset_of(m_utf8_iterator);
+    auto prev_utf8_iterator_byte_offset = m_utf8_view.byte_offset_of(m_prev_utf8_iterator);
 
     // FIXME: Implement a InputStream to handle insertion_point and iterators.
-    StringBuilder builder {};
-    builder.append(m_decoded_input.substring(0, m_insertion_point.position));
+    auto old_input = m_decoded_input.string_view();
+    StringBuilder builder;
+    builder.append(old_input.substring_view(0, m_insertion_point.position));
     builder.append(input);
-    builder.append(m_decoded_input.substring(m_insertion_point.position));
-    m_decoded_input = builder.to_deprecated_string();
+    builder.append(old_input.substring_view(m_insertion_point.position));
+    m_decoded_input = move(builder);
 
-    m_utf8_view = Utf8View(m_decoded_input);
-    m_utf8_iterator = m_utf8_view.iterator_at_byte_offset(utf8_iterator_byte_offset);
+    // Neither iterator is past the insertion point, so their byte offsets stay the same.
+    m_utf8_view = Utf8View(m_decoded_input.string_view());
+    m_utf8_iterator = m_utf8_view.iterator_at_byte_offset_without_validation(utf8_iterator_byte_offset);
+    m_prev_utf8_iterator = m_utf8_view.iterator_at_byte_offset_without_validation(prev_utf8_iterator_byte_offset);
 
     m_insertion_point.position += input.length();
 }
 
+StringView HTMLTokenizer::unconsumed_input() const
+{
+    return m_decoded_input.string_view().substring_view(m_utf8_view.byte_offset_of(m_utf8_iterator));
+}
+
+void HTMLTokenizer::append_to_input_stream(StringView input)
+{
+    VERIFY(!m_input_stream_closed);
+
+    auto utf8_iterator_byte_offset = m_utf8_view.byte_offset_of(m_utf8_iterator);
+    auto prev_utf8_iterator_byte_offset = m_utf8_view.byte_offset_of(m_prev_utf8_iterator);
+
+    // The input only ever grows at the end, so appending to it is cheap, and the iterators can be moved over to the
+    // (possibly reallocated) buffer by their byte offsets without walking the input again.
+    m_decoded_input.append(input);
+
+    m_utf8_view = Utf8View(m_decoded_input.string_view());
+    m_utf8_iterator = m_utf8_view.iterator_at_byte_offset_without_validation(utf8_iterator_byte_offset);
+    m_prev_utf8_iterator = m_utf8_view.iterator_at_byte_offset_without_validation(prev_utf8_iterator_byte_offset);
+}
+
 void HTMLTokenizer::insert_eof()
 {
     m_explicit_eof_inserted = true;
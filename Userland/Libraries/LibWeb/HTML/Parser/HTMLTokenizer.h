@@ -101,6 +101,9 @@ namespace Web::HTML {
     __ENUMERATE_TOKENIZER_STATE(NumericCharacterReferenceEnd)
 
 class HTMLTokenizer {
+    AK_MAKE_NONCOPYABLE(HTMLTokenizer);
+    AK_MAKE_NONMOVABLE(HTMLTokenizer);
+
 public:
     explicit HTMLTokenizer();
     explicit HTMLTokenizer(StringView input, DeprecatedString const& encoding);
@@ -124,7 +127,18 @@ public:
     void set_blocked(bool b) { m_blocked = b; }
     bool is_blocked() const { return m_blocked; }
 
-    DeprecatedString source() const { return m_decoded_input; }
+    DeprecatedString source() const { return m_decoded_input.to_deprecated_string(); }
+
+    // The input that hasn't been tokenized yet.
+    StringView unconsumed_input() const;
+
+    // While the input stream is open, more input can be appended to it as it arrives, e.g. from the network. Running
+    // out of input then only pauses the tokenizer: next_token() returns nothing until more input is appended or the
+    // stream is closed. The input stream is closed from the start if all of the input is given to the constructor.
+    void open_input_stream() { m_input_stream_closed = false; }
+    void append_to_input_stream(StringView);
+    void close_input_stream() { m_input_stream_closed = true; }
+    bool is_input_stream_closed() const { return m_input_stream_closed; }
 
     void insert_input_at_insertion_point(DeprecatedString const& input);
     void insert_eof();
@@ -151,6 +165,7 @@ private:
     void skip(size_t count);
     Optional<u32> next_code_point();
     Optional<u32> peek_code_point(size_t offset) const;
+    bool needs_more_input_to_look_ahead(size_t code_point_count) const;
     bool consume_next_if_match(StringView, CaseSensitivity = CaseSensitivity::CaseSensitive);
     void create_new_token(HTMLToken::Type);
     bool current_end_tag_token_is_appropriate() const;
@@ -184,7 +199,8 @@ private:
 
     Vector<u32> m_temporary_buffer;
 
-    DeprecatedString m_decoded_input;
+    // m_utf8_view and the iterators point into this buffer, so they have to be updated whenever it changes.
+    StringBuilder m_decoded_input;
 
     struct InsertionPoint {
         size_t position { 0 };
@@ -213,6 +229,9 @@ private:
 
     bool m_aborted { false };
 
+    bool m_input_stream_closed { true };
+    bool m_paused { false };
+
     Vector<HTMLToken::Position> m_source_positions;
 };
 
@@ -0,0 +1,155 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Debug.h>
+#include <LibWeb/DOM/Document.h>
+#include <LibWeb/HTML/AttributeNames.h>
+#include <LibWeb/HTML/Parser/SpeculativeHTMLParser.h>
+#include <LibWeb/HTML/TagNames.h>
+#include <LibWeb/Infra/CharacterTypes.h>
+#include <LibWeb/Infra/Strings.h>
+#include <LibWeb/Loader/ResourceLoader.h>
+#include <LibWeb/MimeSniff/MimeType.h>
+
+namespace Web::HTML {
+
+SpeculativeHTMLParser::SpeculativeHTMLParser(StringView input, bool input_stream_closed)
+{
+    m_tokenizer.open_input_stream();
+    m_tokenizer.append_to_input_stream(input);
+    if (input_stream_closed)
+        m_tokenizer.close_input_stream();
+}
+
+void SpeculativeHTMLParser::append_input(StringView input)
+{
+    m_tokenizer.append_to_input_stream(input);
+}
+
+void SpeculativeHTMLParser::close_input()
+{
+    m_tokenizer.close_input_stream();
+}
+
+void SpeculativeHTMLParser::run(DOM::Document& document)
+{
+    for (;;) {
+        auto token = m_tokenizer.next_token();
+        if (!token.has_value())
+            return;
+        if (!token->is_start_tag())
+            continue;
+
+        process_start_tag(document, *token);
+
+        // The tree builder is what switches the tokenizer into the text states, so do the same for the elements
+        // whose contents must not be mistaken for tags.
+        auto const& tag_name = token->tag_name();
+        if (tag_name == TagNames::script)
+            m_tokenizer.switch_to(HTMLTokenizer::State::ScriptData);
+        else if (tag_name.is_one_of(TagNames::style, TagNames::xmp, TagNames::iframe, TagNames::noembed, TagNames::noframes))
+            m_tokenizer.switch_to(HTMLTokenizer::State::RAWTEXT);
+        else if (tag_name == TagNames::noscript && document.is_scripting_enabled())
+            m_tokenizer.switch_to(HTMLTokenizer::State::RAWTEXT);
+        else if (tag_name.is_one_of(TagNames::textarea, TagNames::title))
+            m_tokenizer.switch_to(HTMLTokenizer::State::RCDATA);
+        else if (tag_name == TagNames::plaintext)
+            m_tokenizer.switch_to(HTMLTokenizer::State::PLAINTEXT);
+    }
+}
+
+void SpeculativeHTMLParser::process_start_tag(DOM::Document& document, HTMLToken const& token)
+{
+    auto const& tag_name = token.tag_name();
+
+    // Only the first base element with an href attribute counts.
+    if (tag_name == TagNames::base) {
+        auto href = token.attribute(AttributeNames::href);
+        if (!m_base_url.has_value() && !href.is_null())
+            m_base_url = document.fallback_base_url().complete_url(href);
+        return;
+    }
+
+    if (tag_name == TagNames::script) {
+        // Only classic scripts are fetched the same way here and in HTMLScriptElement, so leave module scripts alone,
+        // as well as anything that won't run anyway.
+        auto src = token.attribute(AttributeNames::src);
+        if (src.is_null() || !document.is_scripting_enabled() || !token.attribute(AttributeNames::nomodule).is_null())
+            return;
+        auto type = token.attribute(AttributeNames::type);
+        auto language = token.attribute(AttributeNames::language);
+        if (!type.is_null()) {
+            if (!type.is_empty() && !MimeSniff::is_javascript_mime_type_essence_match(type.trim(Infra::ASCII_WHITESPACE)))
+                return;
+        } else if (!language.is_empty() && !MimeSniff::is_javascript_mime_type_essence_match(DeprecatedString::formatted("text/{}", language))) {
+            return;
+        }
+        fetch(document, src, Resource::Type::Generic);
+        return;
+    }
+
+    if (tag_name == TagNames::img) {
+        auto src = token.attribute(AttributeNames::src);
+        if (!src.is_empty())
+            fetch(document, src, Resource::Type::Image);
+        return;
+    }
+
+    if (tag_name == TagNames::link) {
+        auto href = token.attribute(AttributeNames::href);
+        if (href.is_empty())
+            return;
+        bool is_style_sheet = false;
+        for (auto keyword : token.attribute(AttributeNames::rel).split_view_if(Infra::is_ascii_whitespace)) {
+            if (Infra::is_ascii_case_insensitive_match(keyword, "alternate"sv))
+                return;
+            if (Infra::is_ascii_case_insensitive_match(keyword, "stylesheet"sv))
+                is_style_sheet = true;
+        }
+        // FIXME: Style sheets are fetched with Fetch, which doesn't use the resource cache, so the best we can do for
+        //        now is to have a connection to their server ready.
+        if (is_style_sheet)
+            preconnect(document, href);
+        return;
+    }
+}
+
+Optional<AK::URL> SpeculativeHTMLParser::resolve_url_not_seen_before(DOM::Document& document, StringView url_string)
+{
+    auto url = (m_base_url.has_value() ? *m_base_url : document.base_url()).complete_url(url_string);
+    if (!url.is_valid() || m_seen_urls.set(url) != HashSetResult::InsertedNewEntry)
+        return {};
+    return url;
+}
+
+void SpeculativeHTMLParser::fetch(DOM::Document& document, StringView url_string, Resource::Type type)
+{
+    auto url = resolve_url_not_seen_before(document, url_string);
+    if (!url.has_value())
+        return;
+
+    // The element that needs the resource wouldn't find it without the cache, and would load it all over again.
+    if (!ResourceLoader::is_cacheable(*url))
+        return;
+
+    dbgln_if(HTML_PARSER_DEBUG, "Speculatively fetching {}", *url);
+
+    // The resource stays in the resource cache, which is where the element that needs it will find it.
+    auto request = LoadRequest::create_for_url_on_page(*url, document.page());
+    (void)ResourceLoader::the().load_resource(type, request);
+}
+
+void SpeculativeHTMLParser::preconnect(DOM::Document& document, StringView url_string)
+{
+    auto url = resolve_url_not_seen_before(document, url_string);
+    if (!url.has_value())
+        return;
+
+    dbgln_if(HTML_PARSER_DEBUG, "Speculatively connecting to {}", *url);
+    ResourceLoader::the().preconnect(*url);
+}
+
+}
@@ -0,0 +1,43 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/HashTable.h>
+#include <AK/URL.h>
+#include <LibWeb/Forward.h>
+#include <LibWeb/HTML/Parser/HTMLTokenizer.h>
+#include <LibWeb/Loader/Resource.h>
+
+namespace Web::HTML {
+
+// https://html.spec.whatwg.org/multipage/parsing.html#speculative-html-parsing
+// Looks ahead of an HTML parser that is blocked on a script, and starts fetching the scripts, images and style sheets
+// that come later in the document, so they are on their way by the time the parser gets to them. It doesn't build a
+// DOM; it only tokenizes the input, keeping track of just enough state to find the tags that fetch something.
+class SpeculativeHTMLParser {
+public:
+    // `input` is where the HTML parser's input stream currently is, up to the end of what has arrived so far.
+    SpeculativeHTMLParser(StringView input, bool input_stream_closed);
+
+    void append_input(StringView);
+    void close_input();
+
+    // Goes through the input that hasn't been looked at yet.
+    void run(DOM::Document&);
+
+private:
+    void process_start_tag(DOM::Document&, HTMLToken const&);
+    Optional<AK::URL> resolve_url_not_seen_before(DOM::Document&, StringView url_string);
+    void fetch(DOM::Document&, StringView url_string, Resource::Type);
+    void preconnect(DOM::Document&, StringView url_string);
+
+    HTMLTokenizer m_tokenizer;
+    Optional<AK::URL> m_base_url;
+    HashTable<AK::URL> m_seen_urls;
+};
+
+}
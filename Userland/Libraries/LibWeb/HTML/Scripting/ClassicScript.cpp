@@ -11,6 +11,7 @@
 #include <LibWeb/HTML/Scripting/ClassicScript.h>
 #include <LibWeb/HTML/Scripting/Environments.h>
 #include <LibWeb/HTML/Scripting/ExceptionReporter.h>
+#include <LibWeb/Page/PhaseTimings.h>
 #include <LibWeb/WebIDL/DOMException.h>
 
 namespace Web::HTML {
@@ -47,6 +48,7 @@ JS::NonnullGCPtr<ClassicScript> ClassicScript::create(DeprecatedString filename,
 
     // 10. Let result be ParseScript(source, settings's Realm, script).
     auto parse_timer = Core::ElapsedTimer::start_new();
+    PhaseTimer phase_timer(Phase::JavaScript);
     auto result = JS::Script::parse(source, environment_settings_object.realm(), script->filename(), script, source_line_number);
     dbgln_if(HTML_SCRIPT_DEBUG, "ClassicScript: Parsed {} in {}ms", script->filename(), parse_timer.elapsed());
 
@@ -93,6 +95,7 @@ JS::Completion ClassicScript::run(RethrowErrors rethrow_errors, JS::GCPtr<JS::En
         evaluation_status = vm.throw_completion<JS::SyntaxError>(TRY_OR_THROW_OOM(vm, m_error_to_rethrow.value().to_string()));
     } else {
         auto timer = Core::ElapsedTimer::start_new();
+        PhaseTimer phase_timer(Phase::JavaScript);
 
         // 6. Otherwise, set evaluationStatus to ScriptEvaluation(script's record).
         auto interpreter = JS::Interpreter::create_with_existing_realm(m_script_record->realm());
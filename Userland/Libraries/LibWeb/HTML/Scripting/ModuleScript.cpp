@@ -9,6 +9,7 @@
 #include <LibWeb/HTML/Scripting/Environments.h>
 #include <LibWeb/HTML/Scripting/Fetching.h>
 #include <LibWeb/HTML/Scripting/ModuleScript.h>
+#include <LibWeb/Page/PhaseTimings.h>
 #include <LibWeb/WebIDL/DOMException.h>
 #include <LibWeb/WebIDL/ExceptionOr.h>
 
@@ -52,6 +53,7 @@ WebIDL::ExceptionOr<JS::GCPtr<JavaScriptModuleScript>> JavaScriptModuleScript::c
     // NOTE: Parse error and error to rethrow were set to null in the construction of Script.
 
     // 7. Let result be ParseModule(source, settings's Realm, script).
+    PhaseTimer phase_timer(Phase::JavaScript);
     auto result = JS::SourceTextModule::parse(source, settings_object.realm(), filename.view(), script);
 
     // 8. If result is a list of errors, then:
@@ -130,6 +132,7 @@ JS::Promise* JavaScriptModuleScript::run(PreventErrorReporting)
         // 1. Let record be script's record.
         auto record = m_record;
 
+        PhaseTimer phase_timer(Phase::JavaScript);
         auto interpreter = JS::Interpreter::create_with_existing_realm(settings.realm());
         JS::VM::InterpreterExecutionScope scope(*interpreter);
 
@@ -17,6 +17,7 @@ VideoTrackList::VideoTrackList(JS::Realm& realm)
     : DOM::EventTarget(realm)
     , m_video_tracks(realm.heap())
 {
+    set_may_interfere_with_indexed_property_access();
 }
 
 JS::ThrowCompletionOr<void> VideoTrackList::initialize(JS::Realm& realm)
@@ -367,6 +367,12 @@ void BlockFormattingContext::layout_inline_children(BlockContainer const& block_
 
     auto& block_container_state = m_state.get_mutable(block_container);
 
+    // NOTE: The line boxes can't be reused if floats in this BFC might have moved around them.
+    if (m_left_floats.all_boxes.is_empty() && m_right_floats.all_boxes.is_empty()
+        && m_state.try_to_reuse_previous_layout(block_container, layout_mode, available_space, false)) {
+        return;
+    }
+
     InlineFormattingContext context(m_state, block_container, *this);
     context.run(
         block_container,
@@ -499,13 +505,17 @@ void BlockFormattingContext::layout_block_level_box(Box const& box, BlockContain
     place_block_level_element_in_normal_flow_horizontally(box, available_space);
 
     OwnPtr<FormattingContext> independent_formatting_context;
+    bool reused_previous_layout = false;
     if (!box.is_replaced_box() && box.has_children()) {
         independent_formatting_context = create_independent_formatting_context_if_needed(m_state, box);
         if (independent_formatting_context) {
             // Margins of elements that establish new formatting contexts do not collapse with their in-flow children
             m_margin_state.reset();
 
-            independent_formatting_context->run(box, layout_mode, box_state.available_inner_space_or_constraints_from(available_space));
+            auto available_inner_space = box_state.available_inner_space_or_constraints_from(available_space);
+            reused_previous_layout = m_state.try_to_reuse_previous_layout(box, layout_mode, available_inner_space, true);
+            if (!reused_previous_layout)
+                independent_formatting_context->run(box, layout_mode, available_inner_space);
         } else {
             if (box.children_are_inline()) {
                 layout_inline_children(verify_cast<BlockContainer>(box), layout_mode, box_state.available_inner_space_or_constraints_from(available_space));
@@ -525,7 +535,9 @@ void BlockFormattingContext::layout_block_level_box(Box const& box, BlockContain
         }
     }
 
-    compute_height(box, available_space);
+    // NOTE: A reused layout comes with the height it resulted in.
+    if (!reused_previous_layout)
+        compute_height(box, available_space);
 
     if (!margins_collapse_through(box, m_state)) {
         if (!m_margin_state.box_last_in_flow_child_margin_bottom_collapsed) {
@@ -546,7 +558,7 @@ void BlockFormattingContext::layout_block_level_box(Box const& box, BlockContain
 
     bottom_of_lowest_margin_box = max(bottom_of_lowest_margin_box, box_state.offset.y() + box_state.content_height() + box_state.margin_box_bottom());
 
-    if (independent_formatting_context)
+    if (independent_formatting_context && !reused_previous_layout)
         independent_formatting_context->parent_context_did_dimension_child_root_box();
 }
 
@@ -78,7 +78,8 @@ void LayoutState::commit()
             auto& paint_box = const_cast<Painting::PaintableBox&>(*box.paint_box());
             paint_box.set_offset(used_values.offset);
             paint_box.set_content_size(used_values.content_width(), used_values.content_height());
-            paint_box.set_overflow_data(move(used_values.overflow_data));
+            // NOTE: The used values are copied rather than moved, so the next layout can reuse them.
+            paint_box.set_overflow_data(used_values.overflow_data);
             paint_box.set_containing_line_box_fragment(used_values.containing_line_box_fragment);
 
             if (is<Layout::BlockContainer>(box)) {
@@ -88,7 +89,8 @@ void LayoutState::commit()
                             text_nodes.set(static_cast<Layout::TextNode*>(const_cast<Layout::Node*>(&fragment.layout_node())));
                     }
                 }
-                static_cast<Painting::PaintableWithLines&>(paint_box).set_line_boxes(move(used_values.line_boxes));
+                auto line_boxes = used_values.line_boxes;
+                static_cast<Painting::PaintableWithLines&>(paint_box).set_line_boxes(move(line_boxes));
             }
         }
     }
@@ -97,6 +99,55 @@ void LayoutState::commit()
         text_node->set_paintable(text_node->create_paintable());
 }
 
+bool LayoutState::try_to_reuse_previous_layout(Box const& box, LayoutMode layout_mode, AvailableSpace const& available_space, bool allow_floating_descendants)
+{
+    // Only the top-level state is committed and kept around, so that's the only one that can be reused.
+    if (m_parent || layout_mode != LayoutMode::Normal)
+        return false;
+
+    auto& box_state = get_mutable(box);
+    UsedValues::ContentsLayoutInput input {
+        .available_space = available_space,
+        .content_width = box_state.content_width(),
+        .content_height = box_state.content_height(),
+        .has_definite_width = box_state.has_definite_width(),
+        .has_definite_height = box_state.has_definite_height(),
+    };
+    box_state.contents_layout_input = input;
+
+    if (!previous_layout || box.needs_layout() || box.child_needs_layout())
+        return false;
+
+    auto const& previous_used_values = previous_layout->used_values_per_layout_node;
+    if (box.serial_id() >= previous_used_values.size() || !previous_used_values[box.serial_id()])
+        return false;
+    auto const& previous_box_state = *previous_used_values[box.serial_id()];
+    if (previous_box_state.contents_layout_input != input)
+        return false;
+
+    // Positioned boxes are laid out by whichever formatting context their containing block is in, and floats
+    // affect the line boxes around them, so their layout depends on more than the input above.
+    bool depends_on_surroundings = false;
+    box.for_each_in_subtree([&](Node const& descendant) {
+        if (descendant.is_absolutely_positioned() || (!allow_floating_descendants && descendant.is_floating())) {
+            depends_on_surroundings = true;
+            return IterationDecision::Break;
+        }
+        return IterationDecision::Continue;
+    });
+    if (depends_on_surroundings)
+        return false;
+
+    box.for_each_in_subtree_of_type<NodeWithStyleAndBoxModelMetrics>([&](auto const& descendant) {
+        auto serial_id = descendant.serial_id();
+        if (serial_id < previous_used_values.size() && previous_used_values[serial_id])
+            used_values_per_layout_node[serial_id] = make<UsedValues>(*previous_used_values[serial_id]);
+        return IterationDecision::Continue;
+    });
+    box_state.reuse_contents_layout_from(previous_box_state);
+    return true;
+}
+
 CSSPixels box_baseline(LayoutState const& state, Box const& box)
 {
     auto const& box_state = state.get(box);
@@ -344,6 +395,17 @@ void LayoutState::UsedValues::set_content_height(CSSPixels height)
     m_has_definite_height = true;
 }
 
+void LayoutState::UsedValues::reuse_contents_layout_from(UsedValues const& previous)
+{
+    m_content_width = previous.m_content_width;
+    m_content_height = previous.m_content_height;
+    m_has_definite_width = previous.m_has_definite_width;
+    m_has_definite_height = previous.m_has_definite_height;
+    line_boxes = previous.line_boxes;
+    overflow_data = previous.overflow_data;
+    m_floating_descendants = previous.m_floating_descendants;
+}
+
 void LayoutState::UsedValues::set_temporary_content_width(CSSPixels width)
 {
     m_content_width = width;
@@ -8,6 +8,7 @@
 
 #include <AK/HashMap.h>
 #include <LibGfx/Point.h>
+#include <LibWeb/Layout/AvailableSpace.h>
 #include <LibWeb/Layout/Box.h>
 #include <LibWeb/Layout/LineBox.h>
 #include <LibWeb/Painting/PaintableBox.h>
@@ -20,9 +21,6 @@ enum class SizeConstraint {
     MaxContent,
 };
 
-class AvailableSize;
-class AvailableSpace;
-
 struct LayoutState {
     LayoutState()
         : m_root(*this)
@@ -130,6 +128,22 @@ struct LayoutState {
         void add_floating_descendant(Box const& box) { m_floating_descendants.set(&box); }
         auto const& floating_descendants() const { return m_floating_descendants; }
 
+        // Everything outside of a box that the layout of its contents depends on, as long as none of them are
+        // floating or positioned against something outside of the box.
+        struct ContentsLayoutInput {
+            AvailableSpace available_space;
+            CSSPixels content_width;
+            CSSPixels content_height;
+            bool has_definite_width { false };
+            bool has_definite_height { false };
+
+            bool operator==(ContentsLayoutInput const&) const = default;
+        };
+        Optional<ContentsLayoutInput> contents_layout_input;
+
+        // Takes over the size and line boxes that laying out the contents of this box resulted in last time.
+        void reuse_contents_layout_from(UsedValues const&);
+
     private:
         AvailableSize available_width_inside() const;
         AvailableSize available_height_inside() const;
@@ -150,6 +164,10 @@ struct LayoutState {
 
     void commit();
 
+    // If the contents of the box can't have changed since the previous layout, copies the used values of its
+    // descendants from there instead of laying them out again, and returns true.
+    bool try_to_reuse_previous_layout(Box const&, LayoutMode, AvailableSpace const&, bool allow_floating_descendants);
+
     // NOTE: get_mutable() will CoW the UsedValues if it's inherited from an ancestor state;
     UsedValues& get_mutable(NodeWithStyleAndBoxModelMetrics const&);
 
@@ -176,6 +194,9 @@ struct LayoutState {
 
     HashMap<JS::GCPtr<NodeWithStyleAndBoxModelMetrics const>, NonnullOwnPtr<IntrinsicSizes>> mutable intrinsic_sizes;
 
+    // The committed state of the last layout of the same layout tree, if there was one.
+    LayoutState const* previous_layout { nullptr };
+
     LayoutState const* m_parent { nullptr };
     LayoutState const& m_root;
 };
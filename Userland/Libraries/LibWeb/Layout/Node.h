@@ -135,6 +135,13 @@ public:
 
     virtual void set_needs_display();
 
+    // Marks this node for layout, and its ancestors as having a descendant that needs it, so that the next
+    // layout can reuse the last layout of every other subtree.
+    void set_needs_layout();
+    void clear_needs_layout();
+    bool needs_layout() const { return m_needs_layout; }
+    bool child_needs_layout() const { return m_child_needs_layout; }
+
     bool children_are_inline() const { return m_children_are_inline; }
     void set_children_are_inline(bool value) { m_children_are_inline = value; }
 
@@ -170,6 +177,8 @@ private:
     bool m_has_style { false };
     bool m_visible { true };
     bool m_children_are_inline { false };
+    bool m_needs_layout { false };
+    bool m_child_needs_layout { false };
     SelectionState m_selection_state { SelectionState::None };
 
     bool m_is_flex_item { false };
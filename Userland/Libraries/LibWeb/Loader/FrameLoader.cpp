@@ -17,6 +17,7 @@
 #include <LibWeb/DOM/ElementFactory.h>
 #include <LibWeb/DOM/Text.h>
 #include <LibWeb/HTML/BrowsingContext.h>
+#include <LibWeb/HTML/EventLoop/EventLoop.h>
 #include <LibWeb/HTML/HTMLIFrameElement.h>
 #include <LibWeb/HTML/NavigationParams.h>
 #include <LibWeb/HTML/Parser/HTMLEncodingDetection.h>
@@ -204,14 +205,50 @@ static bool build_video_document(DOM::Document& document)
     return true;
 }
 
-bool FrameLoader::parse_document(DOM::Document& document, ByteBuffer const& data)
+// HTML is handed to the parser in chunks of this size, each one in a task of its own, so that the event loop gets to
+// render what has been parsed so far, and to fetch what it refers to, while the rest is still being parsed.
+static constexpr size_t html_parser_input_chunk_size = 64 * KiB;
+
+static void append_next_chunk_to_html_parser(JS::Handle<HTML::HTMLParser> parser, DeprecatedString input, size_t offset, Function<void()> on_parsed)
 {
-    auto& mime_type = document.content_type();
-    if (mime_type == "text/html" || mime_type == "image/svg+xml") {
-        auto parser = HTML::HTMLParser::create_with_uncertain_encoding(document, data);
-        parser->run(document.url());
-        return true;
+    // document.open() aborts this parser and gives the document a new one, in which case the rest of the input is dropped.
+    if (parser->aborted() || parser->document().active_parser() != parser.ptr())
+        return;
+
+    auto chunk_end = min(offset + html_parser_input_chunk_size, input.length());
+    // Don't split a code point in half.
+    while (chunk_end < input.length() && (static_cast<u8>(input[chunk_end]) & 0xc0) == 0x80)
+        ++chunk_end;
+
+    parser->append_input(input.substring_view(offset, chunk_end - offset));
+    if (parser->aborted())
+        return;
+
+    if (chunk_end == input.length()) {
+        parser->finish_input(move(on_parsed));
+        return;
     }
+
+    HTML::old_queue_global_task_with_document(HTML::Task::Source::Networking, parser->document(), [parser = move(parser), input = move(input), chunk_end, on_parsed = move(on_parsed)]() mutable {
+        append_next_chunk_to_html_parser(move(parser), move(input), chunk_end, move(on_parsed));
+    });
+}
+
+static void parse_html_document_incrementally(DOM::Document& document, ByteBuffer const& data, Function<void()> on_parsed)
+{
+    auto encoding = document.has_encoding() ? document.encoding().value() : HTML::run_encoding_sniffing_algorithm(document, data);
+    auto decoder = TextCodec::decoder_for(encoding);
+    VERIFY(decoder.has_value());
+    auto input = decoder->to_utf8(data).release_value_but_fixme_should_propagate_errors().to_deprecated_string();
+    document.set_source(input);
+
+    auto parser = HTML::HTMLParser::create_for_incremental_input(document, encoding);
+    append_next_chunk_to_html_parser(JS::make_handle(parser), move(input), 0, move(on_parsed));
+}
+
+static bool build_document(DOM::Document& document, ByteBuffer const& data)
+{
+    auto& mime_type = document.content_type();
     if (mime_type.ends_with("+xml"sv) || mime_type.is_one_of("text/xml", "application/xml"))
         return build_xml_document(document, data);
     if (mime_type.starts_with("image/"sv))
@@ -228,6 +265,20 @@ bool FrameLoader::parse_document(DOM::Document& document, ByteBuffer const& data
     return false;
 }
 
+bool FrameLoader::parse_document(DOM::Document& document, ByteBuffer const& data, Function<void()> on_parsed)
+{
+    auto& mime_type = document.content_type();
+    if (mime_type == "text/html" || mime_type == "image/svg+xml") {
+        parse_html_document_incrementally(document, data, move(on_parsed));
+        return true;
+    }
+
+    if (!build_document(document, data))
+        return false;
+    on_parsed();
+    return true;
+}
+
 bool FrameLoader::load(LoadRequest& request, Type type)
 {
     if (!request.is_valid()) {
@@ -477,18 +528,24 @@ void FrameLoader::resource_did_load()
     if (auto* page = browsing_context().page())
         page->client().page_did_create_main_document();
 
-    if (!parse_document(*document, resource()->encoded_data())) {
+    auto did_parse_document = [this, url, document = JS::make_handle(*document)] {
+        // Parsing HTML spans several tasks, so this may have been navigated away from in the meantime.
+        if (browsing_context().has_been_discarded() || browsing_context().active_document() != document.ptr())
+            return;
+
+        if (!url.fragment().is_empty())
+            browsing_context().scroll_to_anchor(url.fragment());
+        else
+            browsing_context().scroll_to({ 0, 0 });
+
+        if (auto* page = browsing_context().page())
+            page->client().page_did_finish_loading(url);
+    };
+
+    if (!parse_document(*document, resource()->encoded_data(), move(did_parse_document))) {
         load_error_page(url, "Failed to parse content.");
         return;
     }
-
-    if (!url.fragment().is_empty())
-        browsing_context().scroll_to_anchor(url.fragment());
-    else
-        browsing_context().scroll_to({ 0, 0 });
-
-    if (auto* page = browsing_context().page())
-        page->client().page_did_finish_loading(url);
 }
 
 void FrameLoader::resource_did_fail()
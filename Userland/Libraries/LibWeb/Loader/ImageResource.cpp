@@ -7,7 +7,6 @@
 #include <AK/Function.h>
 #include <LibGfx/Bitmap.h>
 #include <LibWeb/Loader/ImageResource.h>
-#include <LibWeb/Platform/ImageCodecPlugin.h>
 
 namespace Web {
 
@@ -36,18 +35,39 @@ int ImageResource::frame_duration(size_t frame_index) const
     return m_decoded_frames[frame_index].duration;
 }
 
+void ImageResource::did_receive_data()
+{
+    if (!has_encoded_data() || !mime_type().starts_with("image/"sv)) {
+        finish_loading();
+        return;
+    }
+
+    // Large images can take a while to decode, so that happens without blocking, and our clients are only told that
+    // the image has loaded once it's been decoded.
+    m_is_decoding = true;
+    Platform::ImageCodecPlugin::the().decode_image_async(encoded_data(), [strong_this = NonnullRefPtr(*this)](Optional<Platform::DecodedImage> image) {
+        strong_this->m_is_decoding = false;
+        strong_this->set_decoded_image(move(image));
+        strong_this->finish_loading();
+    });
+}
+
 void ImageResource::decode_if_needed() const
 {
     if (!has_encoded_data())
         return;
 
-    if (m_has_attempted_decode)
+    if (m_has_attempted_decode || m_is_decoding)
         return;
 
     if (!m_decoded_frames.is_empty())
         return;
 
-    auto image = Platform::ImageCodecPlugin::the().decode_image(encoded_data());
+    set_decoded_image(Platform::ImageCodecPlugin::the().decode_image(encoded_data()));
+}
+
+void ImageResource::set_decoded_image(Optional<Platform::DecodedImage> image) const
+{
     m_has_attempted_decode = true;
 
     if (!image.has_value()) {
@@ -7,6 +7,7 @@
 #pragma once
 
 #include <LibWeb/Loader/Resource.h>
+#include <LibWeb/Platform/ImageCodecPlugin.h>
 
 namespace Web {
 
@@ -47,12 +48,17 @@ private:
     explicit ImageResource(LoadRequest const&);
     explicit ImageResource(Resource&);
 
+    // ^Resource
+    virtual void did_receive_data() override;
+
     void decode_if_needed() const;
+    void set_decoded_image(Optional<Platform::DecodedImage>) const;
 
     mutable bool m_animated { false };
     mutable int m_loop_count { 0 };
     mutable Vector<Frame> m_decoded_frames;
     mutable bool m_has_attempted_decode { false };
+    bool m_is_decoding { false };
 };
 
 class ImageResourceClient : public ResourceClient {
@@ -93,7 +93,6 @@ void Resource::did_load(Badge<ResourceLoader>, ReadonlyBytes data, HashMap<Depre
     m_encoded_data = ByteBuffer::copy(data).release_value_but_fixme_should_propagate_errors();
     m_response_headers = headers;
     m_status_code = move(status_code);
-    m_loaded = true;
 
     auto content_type = headers.get("Content-Type");
 
@@ -126,6 +125,14 @@ void Resource::did_load(Badge<ResourceLoader>, ReadonlyBytes data, HashMap<Depre
         }
     }
 
+    did_receive_data();
+}
+
+void Resource::finish_loading()
+{
+    VERIFY(!m_loaded);
+    m_loaded = true;
+
     for_each_client([](auto& client) {
         client.resource_did_load();
     });
@@ -67,6 +67,11 @@ protected:
     explicit Resource(Type, LoadRequest const&);
     Resource(Type, Resource&);
 
+    // Called once all of the data has arrived. The resource only counts as loaded once finish_loading() is called, so
+    // subclasses that have to process the data first can delay that until they're done.
+    virtual void did_receive_data() { finish_loading(); }
+    void finish_loading();
+
 private:
     LoadRequest m_request;
     ByteBuffer m_encoded_data;
@@ -17,6 +17,7 @@
 #include <LibWeb/Loader/ProxyMappings.h>
 #include <LibWeb/Loader/Resource.h>
 #include <LibWeb/Loader/ResourceLoader.h>
+#include <LibWeb/Page/PhaseTimings.h>
 #include <LibWeb/Platform/EventLoopPlugin.h>
 #include <LibWeb/Platform/Timer.h>
 
@@ -84,12 +85,17 @@ void ResourceLoader::preconnect(AK::URL const& url)
 
 static HashMap<LoadRequest, NonnullRefPtr<Resource>> s_resource_cache;
 
+bool ResourceLoader::is_cacheable(AK::URL const& url)
+{
+    return url.scheme() != "file";
+}
+
 RefPtr<Resource> ResourceLoader::load_resource(Resource::Type type, LoadRequest& request)
 {
     if (!request.is_valid())
         return nullptr;
 
-    bool use_cache = request.url().scheme() != "file";
+    bool use_cache = is_cacheable(request.url());
 
     if (use_cache) {
         auto it = s_resource_cache.find(request);
@@ -168,12 +174,14 @@ void ResourceLoader::load(LoadRequest& request, Function<void(ReadonlyBytes, Has
 
     auto const log_success = [url_for_logging, id](auto const& request) {
         auto load_time_ms = request.load_time().to_milliseconds();
+        PhaseTimings::add(Phase::Fetch, request.load_time());
         emit_signpost(DeprecatedString::formatted("Finished load: {}", url_for_logging), id);
         dbgln("ResourceLoader: Finished load of: \"{}\", Duration: {}ms", url_for_logging, load_time_ms);
     };
 
     auto const log_failure = [url_for_logging, id](auto const& request, auto const& error_message) {
         auto load_time_ms = request.load_time().to_milliseconds();
+        PhaseTimings::add(Phase::Fetch, request.load_time());
         emit_signpost(DeprecatedString::formatted("Failed load: {}", url_for_logging), id);
         dbgln("ResourceLoader: Failed load of: \"{}\", \033[31;1mError: {}\033[0m, Duration: {}ms", url_for_logging, error_message, load_time_ms);
     };
@@ -110,6 +110,9 @@ public:
     DeprecatedString const& user_agent() const { return m_user_agent; }
     void set_user_agent(DeprecatedString const& user_agent) { m_user_agent = user_agent; }
 
+    // Whether load_resource() keeps the resources it loads from the URL in the cache, and hands them out again.
+    static bool is_cacheable(AK::URL const&);
+
     void clear_cache();
     void evict_from_cache(LoadRequest const&);
 
@@ -0,0 +1,65 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibWeb/Page/PhaseTimings.h>
+
+namespace Web {
+
+bool PhaseTimings::s_enabled = false;
+Array<PhaseTimings::Totals, to_underlying(Phase::__Count)> PhaseTimings::s_totals;
+
+static PhaseTimer* s_current_timer = nullptr;
+
+StringView phase_name(Phase phase)
+{
+    switch (phase) {
+#define __ENUMERATE_PHASE(phase, name) \
+    case Phase::phase:                 \
+        return name##sv;
+        ENUMERATE_PHASES
+#undef __ENUMERATE_PHASE
+    case Phase::__Count:
+        break;
+    }
+    VERIFY_NOT_REACHED();
+}
+
+void PhaseTimings::reset()
+{
+    s_totals.fill({});
+}
+
+void PhaseTimings::add(Phase phase, Time time)
+{
+    if (!s_enabled)
+        return;
+    auto& totals = s_totals[to_underlying(phase)];
+    totals.time += time;
+    ++totals.count;
+}
+
+PhaseTimer::PhaseTimer(Phase phase)
+    : m_phase(phase)
+    , m_enabled(PhaseTimings::is_enabled())
+{
+    if (!m_enabled)
+        return;
+    m_outer_timer = exchange(s_current_timer, this);
+    m_start = Time::now_monotonic();
+}
+
+PhaseTimer::~PhaseTimer()
+{
+    if (!m_enabled)
+        return;
+    auto elapsed = Time::now_monotonic() - m_start;
+    PhaseTimings::add(m_phase, elapsed - m_time_in_inner_phases);
+    if (m_outer_timer)
+        m_outer_timer->m_time_in_inner_phases += elapsed;
+    s_current_timer = m_outer_timer;
+}
+
+}
@@ -0,0 +1,76 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Array.h>
+#include <AK/Noncopyable.h>
+#include <AK/StdLibExtras.h>
+#include <AK/StringView.h>
+#include <AK/Time.h>
+
+namespace Web {
+
+#define ENUMERATE_PHASES                \
+    __ENUMERATE_PHASE(Fetch, "fetch")   \
+    __ENUMERATE_PHASE(Parse, "parse")   \
+    __ENUMERATE_PHASE(Style, "style")   \
+    __ENUMERATE_PHASE(Layout, "layout") \
+    __ENUMERATE_PHASE(Paint, "paint")   \
+    __ENUMERATE_PHASE(JavaScript, "javascript")
+
+enum class Phase {
+#define __ENUMERATE_PHASE(phase, name) phase,
+    ENUMERATE_PHASES
+#undef __ENUMERATE_PHASE
+        __Count,
+};
+
+StringView phase_name(Phase);
+
+// Where the time goes while pages are loaded and rendered, for benchmarking. Nothing is recorded unless this has been
+// enabled, and only work done on the main thread is recorded.
+// Fetches happen in parallel with everything else, so the time for those is the sum of how long each resource took
+// to arrive, rather than time spent by the process itself.
+class PhaseTimings {
+public:
+    struct Totals {
+        Time time;
+        size_t count { 0 };
+    };
+
+    static bool is_enabled() { return s_enabled; }
+    static void set_enabled(bool enabled) { s_enabled = enabled; }
+
+    static Totals const& totals(Phase phase) { return s_totals[to_underlying(phase)]; }
+    static void reset();
+
+    static void add(Phase, Time);
+
+private:
+    static bool s_enabled;
+    static Array<Totals, to_underlying(Phase::__Count)> s_totals;
+};
+
+// Measures the time spent in a phase, from construction to destruction. When a phase is entered from inside another
+// one, e.g. a script run by the parser or a layout forced by a script, that time only counts for the inner phase.
+class PhaseTimer {
+    AK_MAKE_NONCOPYABLE(PhaseTimer);
+    AK_MAKE_NONMOVABLE(PhaseTimer);
+
+public:
+    explicit PhaseTimer(Phase);
+    ~PhaseTimer();
+
+private:
+    Phase m_phase;
+    bool m_enabled { false };
+    Time m_start;
+    Time m_time_in_inner_phases;
+    PhaseTimer* m_outer_timer { nullptr };
+};
+
+}
@@ -134,8 +134,11 @@ void paint_border(PaintContext& context, BorderEdge edge, DevicePixelRect const&
             break;
         }
         if (border_style == CSS::LineStyle::Dotted) {
-            Gfx::AntiAliasingPainter aa_painter { context.painter() };
-            aa_painter.draw_line(p1.to_type<int>(), p2.to_type<int>(), color, device_pixel_width.value(), gfx_line_style);
+            auto bounding_rect = Gfx::IntRect::from_two_points(p1.to_type<int>(), p2.to_type<int>()).inflated(device_pixel_width.value() * 2, device_pixel_width.value() * 2);
+            context.painter().paint_with(bounding_rect, [=](Gfx::Painter& painter) {
+                Gfx::AntiAliasingPainter aa_painter { painter };
+                aa_painter.draw_line(p1.to_type<int>(), p2.to_type<int>(), color, device_pixel_width.value(), gfx_line_style);
+            });
             return;
         }
         context.painter().draw_line(p1.to_type<int>(), p2.to_type<int>(), color, device_pixel_width.value(), gfx_line_style);
@@ -314,20 +317,6 @@ void paint_all_borders(PaintContext& context, CSSPixelRect const& bordered_rect,
             top_right.vertical_radius + bottom_right.vertical_radius + expand_height.value())
     };
 
-    auto corner_bitmap = get_cached_corner_bitmap(corner_mask_rect.size());
-    if (!corner_bitmap)
-        return;
-    Gfx::Painter painter { *corner_bitmap };
-
-    Gfx::AntiAliasingPainter aa_painter { painter };
-
-    // Paint a little tile sheet for the corners
-    // TODO: Support various line styles on the corners (dotted, dashes, etc)
-
-    // Paint the outer (minimal) corner rounded rectangle:
-    aa_painter.fill_rect_with_rounded_corners(corner_mask_rect.to_type<int>(), border_color_no_alpha, top_left, top_right, bottom_right, bottom_left);
-
-    // Subtract the inner corner rectangle:
     auto inner_corner_mask_rect = corner_mask_rect.shrunken(
         context.enclosing_device_pixels(borders_data.top.width),
         context.enclosing_device_pixels(borders_data.right.width),
@@ -345,35 +334,54 @@ void paint_all_borders(PaintContext& context, CSSPixelRect const& bordered_rect,
     inner_bottom_right.vertical_radius = max(0, inner_bottom_right.vertical_radius - context.enclosing_device_pixels(borders_data.bottom.width).value());
     inner_bottom_left.horizontal_radius = max(0, inner_bottom_left.horizontal_radius - context.enclosing_device_pixels(borders_data.left.width).value());
     inner_bottom_left.vertical_radius = max(0, inner_bottom_left.vertical_radius - context.enclosing_device_pixels(borders_data.bottom.width).value());
-    aa_painter.fill_rect_with_rounded_corners(inner_corner_mask_rect.to_type<int>(), border_color_no_alpha, inner_top_left, inner_top_right, inner_bottom_right, inner_bottom_left, Gfx::AntiAliasingPainter::BlendMode::AlphaSubtract);
-
-    // TODO: Support dual color corners. Other browsers will render a rounded corner between two borders of
-    // different colors using both colours, normally split at a 45 degree angle (though the exact angle is interpolated).
-    auto blit_corner = [&](Gfx::IntPoint position, Gfx::IntRect const& src_rect, Color corner_color) {
-        context.painter().blit_filtered(position, *corner_bitmap, src_rect, [&](auto const& corner_pixel) {
-            return corner_color.with_alpha((corner_color.alpha() * corner_pixel.alpha()) / 255);
-        });
-    };
 
-    // FIXME: Corners should actually split between the two colors, if both are provided (and differ)
-    auto pick_corner_color = [](auto const& border, auto const& adjacent_border) {
-        if (border.width > 0)
-            return border.color;
-        return adjacent_border.color;
-    };
+    // The corners are drawn through a bitmap that is shared with other painting, so all of it has to happen when
+    // the display list is replayed.
+    context.painter().paint_with(border_rect.to_type<int>(), [=](Gfx::Painter& page_painter) {
+        auto corner_bitmap = get_cached_corner_bitmap(corner_mask_rect.size());
+        if (!corner_bitmap)
+            return;
+        Gfx::Painter painter { *corner_bitmap };
+
+        Gfx::AntiAliasingPainter aa_painter { painter };
+
+        // Paint a little tile sheet for the corners
+        // TODO: Support various line styles on the corners (dotted, dashes, etc)
+
+        // Paint the outer (minimal) corner rounded rectangle:
+        aa_painter.fill_rect_with_rounded_corners(corner_mask_rect.to_type<int>(), border_color_no_alpha, top_left, top_right, bottom_right, bottom_left);
+
+        // Subtract the inner corner rectangle:
+        aa_painter.fill_rect_with_rounded_corners(inner_corner_mask_rect.to_type<int>(), border_color_no_alpha, inner_top_left, inner_top_right, inner_bottom_right, inner_bottom_left, Gfx::AntiAliasingPainter::BlendMode::AlphaSubtract);
+
+        // TODO: Support dual color corners. Other browsers will render a rounded corner between two borders of
+        // different colors using both colours, normally split at a 45 degree angle (though the exact angle is interpolated).
+        auto blit_corner = [&](Gfx::IntPoint position, Gfx::IntRect const& src_rect, Color corner_color) {
+            page_painter.blit_filtered(position, *corner_bitmap, src_rect, [&](auto const& corner_pixel) {
+                return corner_color.with_alpha((corner_color.alpha() * corner_pixel.alpha()) / 255);
+            });
+        };
+
+        // FIXME: Corners should actually split between the two colors, if both are provided (and differ)
+        auto pick_corner_color = [](auto const& border, auto const& adjacent_border) {
+            if (border.width > 0)
+                return border.color;
+            return adjacent_border.color;
+        };
 
-    // Blit the corners into to their corresponding locations:
-    if (top_left)
-        blit_corner(border_rect.top_left().to_type<int>(), top_left.as_rect(), pick_corner_color(borders_data.top, borders_data.left));
+        // Blit the corners into to their corresponding locations:
+        if (top_left)
+            blit_corner(border_rect.top_left().to_type<int>(), top_left.as_rect(), pick_corner_color(borders_data.top, borders_data.left));
 
-    if (top_right)
-        blit_corner(border_rect.top_right().to_type<int>().translated(-top_right.horizontal_radius + 1, 0), top_right.as_rect().translated(corner_mask_rect.width().value() - top_right.horizontal_radius, 0), pick_corner_color(borders_data.top, borders_data.right));
+        if (top_right)
+            blit_corner(border_rect.top_right().to_type<int>().translated(-top_right.horizontal_radius + 1, 0), top_right.as_rect().translated(corner_mask_rect.width().value() - top_right.horizontal_radius, 0), pick_corner_color(borders_data.top, borders_data.right));
 
-    if (bottom_right)
-        blit_corner(border_rect.bottom_right().to_type<int>().translated(-bottom_right.horizontal_radius + 1, -bottom_right.vertical_radius + 1), bottom_right.as_rect().translated(corner_mask_rect.width().value() - bottom_right.horizontal_radius, corner_mask_rect.height().value() - bottom_right.vertical_radius), pick_corner_color(borders_data.bottom, borders_data.right));
+        if (bottom_right)
+            blit_corner(border_rect.bottom_right().to_type<int>().translated(-bottom_right.horizontal_radius + 1, -bottom_right.vertical_radius + 1), bottom_right.as_rect().translated(corner_mask_rect.width().value() - bottom_right.horizontal_radius, corner_mask_rect.height().value() - bottom_right.vertical_radius), pick_corner_color(borders_data.bottom, borders_data.right));
 
-    if (bottom_left)
-        blit_corner(border_rect.bottom_left().to_type<int>().translated(0, -bottom_left.vertical_radius + 1), bottom_left.as_rect().translated(0, corner_mask_rect.height().value() - bottom_left.vertical_radius), pick_corner_color(borders_data.bottom, borders_data.left));
+        if (bottom_left)
+            blit_corner(border_rect.bottom_left().to_type<int>().translated(0, -bottom_left.vertical_radius + 1), bottom_left.as_rect().translated(0, corner_mask_rect.height().value() - bottom_left.vertical_radius), pick_corner_color(borders_data.bottom, borders_data.left));
+    });
 }
 
 }
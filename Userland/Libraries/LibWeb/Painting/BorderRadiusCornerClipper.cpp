@@ -10,7 +10,7 @@
 
 namespace Web::Painting {
 
-ErrorOr<BorderRadiusCornerClipper> BorderRadiusCornerClipper::create(PaintContext& context, DevicePixelRect const& border_rect, BorderRadiiData const& border_radii, CornerClip corner_clip, UseCachedBitmap use_cached_bitmap)
+ErrorOr<NonnullRefPtr<BorderRadiusCornerClipper>> BorderRadiusCornerClipper::create(PaintContext& context, DevicePixelRect const& border_rect, BorderRadiiData const& border_radii, CornerClip corner_clip)
 {
     VERIFY(border_radii.has_any_radius());
 
@@ -28,15 +28,6 @@ ErrorOr<BorderRadiusCornerClipper> BorderRadiusCornerClipper::create(PaintContex
             top_right.vertical_radius + bottom_right.vertical_radius)
     };
 
-    RefPtr<Gfx::Bitmap> corner_bitmap;
-    if (use_cached_bitmap == UseCachedBitmap::Yes) {
-        corner_bitmap = get_cached_corner_bitmap(corners_bitmap_size);
-        if (!corner_bitmap)
-            return Error::from_errno(ENOMEM);
-    } else {
-        corner_bitmap = TRY(Gfx::Bitmap::create(Gfx::BitmapFormat::BGRA8888, corners_bitmap_size.to_type<int>()));
-    }
-
     CornerData corner_data {
         .corner_radii = {
             .top_left = top_left,
@@ -48,15 +39,48 @@ ErrorOr<BorderRadiusCornerClipper> BorderRadiusCornerClipper::create(PaintContex
         .corner_bitmap_size = corners_bitmap_size
     };
 
-    return BorderRadiusCornerClipper { corner_data, corner_bitmap.release_nonnull(), corner_clip };
+    return adopt_nonnull_ref_or_enomem(new (nothrow) BorderRadiusCornerClipper(corner_data, corner_clip));
+}
+
+Gfx::IntRect BorderRadiusCornerClipper::page_rect() const
+{
+    auto rect_of_corner = [](DevicePixelPoint location, CornerRadius const& radius) {
+        return radius.as_rect().translated(location.to_type<int>());
+    };
+    return rect_of_corner(m_data.page_locations.top_left, m_data.corner_radii.top_left)
+        .united(rect_of_corner(m_data.page_locations.top_right, m_data.corner_radii.top_right))
+        .united(rect_of_corner(m_data.page_locations.bottom_right, m_data.corner_radii.bottom_right))
+        .united(rect_of_corner(m_data.page_locations.bottom_left, m_data.corner_radii.bottom_left));
+}
+
+void BorderRadiusCornerClipper::sample_under_corners(RecordingPainter& page_painter)
+{
+    page_painter.sample_with(page_rect(), [clipper = NonnullRefPtr(*this)](Gfx::Painter& painter) {
+        if (auto result = clipper->sample_under_corners(painter); result.is_error())
+            dbgln("Failed to sample under border-radius corners: {}", result.error());
+    });
+}
+
+void BorderRadiusCornerClipper::blit_corner_clipping(RecordingPainter& page_painter)
+{
+    page_painter.paint_with(page_rect(), [clipper = NonnullRefPtr(*this)](Gfx::Painter& painter) {
+        clipper->blit_corner_clipping(painter);
+    });
 }
 
-void BorderRadiusCornerClipper::sample_under_corners(Gfx::Painter& page_painter)
+ErrorOr<void> BorderRadiusCornerClipper::sample_under_corners(Gfx::Painter& page_painter)
 {
+    Gfx::IntRect corner_rect { { 0, 0 }, m_data.corner_bitmap_size };
+    RefPtr<Gfx::Bitmap> corner_bitmap = m_corner_bitmaps.get(page_painter.target()).value_or(nullptr);
+    if (!corner_bitmap) {
+        corner_bitmap = TRY(Gfx::Bitmap::create(Gfx::BitmapFormat::BGRA8888, corner_rect.size()));
+        TRY(m_corner_bitmaps.try_set(page_painter.target(), *corner_bitmap));
+    }
+
     // Generate a mask for the corners:
-    Gfx::Painter corner_painter { *m_corner_bitmap };
+    Gfx::Painter corner_painter { *corner_bitmap };
     Gfx::AntiAliasingPainter corner_aa_painter { corner_painter };
-    Gfx::IntRect corner_rect { { 0, 0 }, m_data.corner_bitmap_size };
+    corner_painter.clear_rect(corner_rect, Color());
     corner_aa_painter.fill_rect_with_rounded_corners(corner_rect, Color::NamedColor::Black,
         m_data.corner_radii.top_left, m_data.corner_radii.top_right, m_data.corner_radii.bottom_right, m_data.corner_radii.bottom_left);
 
@@ -64,7 +88,7 @@ void BorderRadiusCornerClipper::sample_under_corners(Gfx::Painter& page_painter)
         for (int row = 0; row < mask_src.height(); ++row) {
             for (int col = 0; col < mask_src.width(); ++col) {
                 auto corner_location = mask_src.location().translated(col, row);
-                auto mask_pixel = m_corner_bitmap->get_pixel(corner_location);
+                auto mask_pixel = corner_bitmap->get_pixel(corner_location);
                 u8 mask_alpha = mask_pixel.alpha();
                 if (m_corner_clip == CornerClip::Outside)
                     mask_alpha = ~mask_pixel.alpha();
@@ -74,7 +98,7 @@ void BorderRadiusCornerClipper::sample_under_corners(Gfx::Painter& page_painter)
                     if (page_pixel.has_value())
                         final_pixel = page_pixel.value().with_alpha(mask_alpha);
                 }
-                m_corner_bitmap->set_pixel(corner_location, final_pixel);
+                corner_bitmap->set_pixel(corner_location, final_pixel);
             }
         }
     };
@@ -89,22 +113,24 @@ void BorderRadiusCornerClipper::sample_under_corners(Gfx::Painter& page_painter)
     if (m_data.corner_radii.bottom_left)
         copy_page_masked(m_data.corner_radii.bottom_left.as_rect().translated(m_data.bitmap_locations.bottom_left.to_type<int>()), m_data.page_locations.bottom_left.to_type<int>());
 
-    m_has_sampled = true;
+    return {};
 }
 
 void BorderRadiusCornerClipper::blit_corner_clipping(Gfx::Painter& painter)
 {
-    VERIFY(m_has_sampled);
+    auto corner_bitmap = m_corner_bitmaps.get(painter.target());
+    if (!corner_bitmap.has_value())
+        return;
 
     // Restore the corners:
     if (m_data.corner_radii.top_left)
-        painter.blit(m_data.page_locations.top_left.to_type<int>(), *m_corner_bitmap, m_data.corner_radii.top_left.as_rect().translated(m_data.bitmap_locations.top_left.to_type<int>()));
+        painter.blit(m_data.page_locations.top_left.to_type<int>(), **corner_bitmap, m_data.corner_radii.top_left.as_rect().translated(m_data.bitmap_locations.top_left.to_type<int>()));
     if (m_data.corner_radii.top_right)
-        painter.blit(m_data.page_locations.top_right.to_type<int>(), *m_corner_bitmap, m_data.corner_radii.top_right.as_rect().translated(m_data.bitmap_locations.top_right.to_type<int>()));
+        painter.blit(m_data.page_locations.top_right.to_type<int>(), **corner_bitmap, m_data.corner_radii.top_right.as_rect().translated(m_data.bitmap_locations.top_right.to_type<int>()));
     if (m_data.corner_radii.bottom_right)
-        painter.blit(m_data.page_locations.bottom_right.to_type<int>(), *m_corner_bitmap, m_data.corner_radii.bottom_right.as_rect().translated(m_data.bitmap_locations.bottom_right.to_type<int>()));
+        painter.blit(m_data.page_locations.bottom_right.to_type<int>(), **corner_bitmap, m_data.corner_radii.bottom_right.as_rect().translated(m_data.bitmap_locations.bottom_right.to_type<int>()));
     if (m_data.corner_radii.bottom_left)
-        painter.blit(m_data.page_locations.bottom_left.to_type<int>(), *m_corner_bitmap, m_data.corner_radii.bottom_left.as_rect().translated(m_data.bitmap_locations.bottom_left.to_type<int>()));
+        painter.blit(m_data.page_locations.bottom_left.to_type<int>(), **corner_bitmap, m_data.corner_radii.bottom_left.as_rect().translated(m_data.bitmap_locations.bottom_left.to_type<int>()));
 }
 
 }
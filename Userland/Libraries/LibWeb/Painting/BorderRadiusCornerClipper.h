@@ -6,6 +6,7 @@
 
 #pragma once
 
+#include <AK/HashMap.h>
 #include <LibGfx/AntiAliasingPainter.h>
 #include <LibWeb/Painting/BorderPainting.h>
 
@@ -16,16 +17,17 @@ enum class CornerClip {
     Inside
 };
 
-class BorderRadiusCornerClipper {
+class BorderRadiusCornerClipper : public RefCounted<BorderRadiusCornerClipper> {
 public:
-    enum class UseCachedBitmap {
-        Yes,
-        No
-    };
+    static ErrorOr<NonnullRefPtr<BorderRadiusCornerClipper>> create(PaintContext&, DevicePixelRect const& border_rect, BorderRadiiData const& border_radii, CornerClip corner_clip = CornerClip::Outside);
 
-    static ErrorOr<BorderRadiusCornerClipper> create(PaintContext&, DevicePixelRect const& border_rect, BorderRadiiData const& border_radii, CornerClip corner_clip = CornerClip::Outside, UseCachedBitmap use_cached_bitmap = UseCachedBitmap::Yes);
+    // These record the sampling and restoring of the corners, which happen when the display list is replayed.
+    void sample_under_corners(RecordingPainter& page_painter);
+    void blit_corner_clipping(RecordingPainter& page_painter);
 
-    void sample_under_corners(Gfx::Painter& page_painter);
+    // The corners are sampled separately for each bitmap that is painted onto, so that the tiles of a page can be
+    // painted at the same time. Like all paint functions, these never run at the same time as each other.
+    ErrorOr<void> sample_under_corners(Gfx::Painter& page_painter);
     void blit_corner_clipping(Gfx::Painter& page_painter);
 
 private:
@@ -48,24 +50,24 @@ private:
         DevicePixelSize corner_bitmap_size;
     } m_data;
 
-    NonnullRefPtr<Gfx::Bitmap> m_corner_bitmap;
-    bool m_has_sampled { false };
+    Gfx::IntRect page_rect() const;
+
+    HashMap<Gfx::Bitmap const*, NonnullRefPtr<Gfx::Bitmap>> m_corner_bitmaps;
     CornerClip m_corner_clip { false };
 
-    BorderRadiusCornerClipper(CornerData corner_data, NonnullRefPtr<Gfx::Bitmap> corner_bitmap, CornerClip corner_clip)
+    BorderRadiusCornerClipper(CornerData corner_data, CornerClip corner_clip)
         : m_data(move(corner_data))
-        , m_corner_bitmap(corner_bitmap)
         , m_corner_clip(corner_clip)
     {
     }
 };
 
 struct ScopedCornerRadiusClip {
-    ScopedCornerRadiusClip(PaintContext& context, Gfx::Painter& painter, DevicePixelRect const& border_rect, BorderRadiiData const& border_radii, CornerClip corner_clip = CornerClip::Outside, BorderRadiusCornerClipper::UseCachedBitmap use_cached_bitmap = BorderRadiusCornerClipper::UseCachedBitmap::Yes)
+    ScopedCornerRadiusClip(PaintContext& context, RecordingPainter& painter, DevicePixelRect const& border_rect, BorderRadiiData const& border_radii, CornerClip corner_clip = CornerClip::Outside)
         : m_painter(painter)
     {
         if (border_radii.has_any_radius()) {
-            auto clipper = BorderRadiusCornerClipper::create(context, border_rect, border_radii, corner_clip, use_cached_bitmap);
+            auto clipper = BorderRadiusCornerClipper::create(context, border_rect, border_radii, corner_clip);
             if (!clipper.is_error()) {
                 m_corner_clipper = clipper.release_value();
                 m_corner_clipper->sample_under_corners(m_painter);
@@ -75,7 +77,7 @@ struct ScopedCornerRadiusClip {
 
     ~ScopedCornerRadiusClip()
     {
-        if (m_corner_clipper.has_value()) {
+        if (m_corner_clipper) {
             m_corner_clipper->blit_corner_clipping(m_painter);
         }
     }
@@ -84,8 +86,8 @@ struct ScopedCornerRadiusClip {
     AK_MAKE_NONCOPYABLE(ScopedCornerRadiusClip);
 
 private:
-    Gfx::Painter& m_painter;
-    Optional<BorderRadiusCornerClipper> m_corner_clipper;
+    RecordingPainter& m_painter;
+    RefPtr<BorderRadiusCornerClipper> m_corner_clipper;
 };
 
 }
@@ -44,7 +44,9 @@ void ImagePaintable::paint(PaintContext& context, PaintPhase phase) const
             auto& image_element = verify_cast<HTML::HTMLImageElement>(*dom_node());
             auto enclosing_rect = context.enclosing_device_rect(absolute_rect()).to_type<int>();
             context.painter().set_font(Platform::FontPlugin::the().default_font());
-            Gfx::StylePainter::paint_frame(context.painter(), enclosing_rect, context.palette(), Gfx::FrameShape::Container, Gfx::FrameShadow::Sunken, 2);
+            context.painter().paint_with(enclosing_rect, [enclosing_rect, palette = context.palette()](Gfx::Painter& painter) {
+                Gfx::StylePainter::paint_frame(painter, enclosing_rect, palette, Gfx::FrameShape::Container, Gfx::FrameShadow::Sunken, 2);
+            });
             auto alt = image_element.alt();
             if (alt.is_empty())
                 alt = image_element.src();
@@ -11,6 +11,7 @@
 #include <LibGfx/Forward.h>
 #include <LibGfx/Palette.h>
 #include <LibGfx/Rect.h>
+#include <LibWeb/Painting/RecordingPainter.h>
 #include <LibWeb/PixelUnits.h>
 #include <LibWeb/SVG/SVGContext.h>
 
@@ -18,9 +19,9 @@ namespace Web {
 
 class PaintContext {
 public:
-    PaintContext(Gfx::Painter& painter, Palette const& palette, float device_pixels_per_css_pixel);
+    PaintContext(Painting::RecordingPainter& painter, Palette const& palette, float device_pixels_per_css_pixel);
 
-    Gfx::Painter& painter() const { return m_painter; }
+    Painting::RecordingPainter& painter() const { return m_painter; }
     Palette const& palette() const { return m_palette; }
 
     bool has_svg_context() const { return m_svg_context.has_value(); }
@@ -52,7 +53,7 @@ public:
     CSSPixelSize scale_to_css_size(DevicePixelSize) const;
     CSSPixelRect scale_to_css_rect(DevicePixelRect) const;
 
-    PaintContext clone(Gfx::Painter& painter) const
+    PaintContext clone(Painting::RecordingPainter& painter) const
     {
         auto clone = PaintContext(painter, m_palette, m_device_pixels_per_css_pixel);
         clone.m_device_viewport_rect = m_device_viewport_rect;
@@ -65,7 +66,7 @@ public:
     float device_pixels_per_css_pixel() const { return m_device_pixels_per_css_pixel; }
 
 private:
-    Gfx::Painter& m_painter;
+    Painting::RecordingPainter& m_painter;
     Palette m_palette;
     Optional<SVGContext> m_svg_context;
     float m_device_pixels_per_css_pixel;
@@ -365,7 +365,7 @@ void PaintableBox::apply_clip_overflow_rect(PaintContext& context, PaintPhase ph
     if (overflow_y == CSS::Overflow::Hidden && overflow_x == CSS::Overflow::Hidden) {
         auto border_radii_data = normalized_border_radii_data(ShrinkRadiiForBorders::Yes);
         if (border_radii_data.has_any_radius()) {
-            auto corner_clipper = BorderRadiusCornerClipper::create(context, context.rounded_device_rect(*clip_rect), border_radii_data, CornerClip::Outside, BorderRadiusCornerClipper::UseCachedBitmap::No);
+            auto corner_clipper = BorderRadiusCornerClipper::create(context, context.rounded_device_rect(*clip_rect), border_radii_data, CornerClip::Outside);
             if (corner_clipper.is_error()) {
                 dbgln("Failed to create overflow border-radius corner clipper: {}", corner_clipper.error());
                 return;
@@ -387,9 +387,9 @@ void PaintableBox::clear_clip_overflow_rect(PaintContext& context, PaintPhase ph
         context.painter().restore();
         m_clipping_overflow = false;
     }
-    if (m_overflow_corner_radius_clipper.has_value()) {
+    if (m_overflow_corner_radius_clipper) {
         m_overflow_corner_radius_clipper->blit_corner_clipping(context.painter());
-        m_overflow_corner_radius_clipper = {};
+        m_overflow_corner_radius_clipper = nullptr;
     }
 }
 
@@ -427,7 +427,7 @@ static void paint_cursor_if_needed(PaintContext& context, Layout::TextNode const
     context.painter().draw_rect(cursor_device_rect, text_node.computed_values().color());
 }
 
-static void paint_text_decoration(PaintContext& context, Gfx::Painter& painter, Layout::Node const& text_node, Layout::LineBoxFragment const& fragment)
+static void paint_text_decoration(PaintContext& context, RecordingPainter& painter, Layout::Node const& text_node, Layout::LineBoxFragment const& fragment)
 {
     auto& font = fragment.layout_node().font();
     auto fragment_box = fragment.absolute_rect();
@@ -531,7 +531,7 @@ static void paint_text_fragment(PaintContext& context, Layout::TextNode const& t
         auto selection_rect = context.enclosing_device_rect(fragment.selection_rect(text_node.font())).to_type<int>();
         if (!selection_rect.is_empty()) {
             painter.fill_rect(selection_rect, context.palette().selection());
-            Gfx::PainterStateSaver saver(painter);
+            RecordingPainterStateSaver saver(painter);
             painter.add_clip_rect(selection_rect);
             painter.draw_text_run(baseline_start.to_type<int>(), view, scaled_font, context.palette().selection_text());
         }
@@ -552,16 +552,15 @@ void PaintableWithLines::paint(PaintContext& context, PaintPhase phase) const
         return;
 
     bool should_clip_overflow = computed_values().overflow_x() != CSS::Overflow::Visible && computed_values().overflow_y() != CSS::Overflow::Visible;
-    Optional<BorderRadiusCornerClipper> corner_clipper;
+    RefPtr<BorderRadiusCornerClipper> corner_clipper;
 
     if (should_clip_overflow) {
         context.painter().save();
         // FIXME: Handle overflow-x and overflow-y being different values.
         auto clip_box = context.rounded_device_rect(absolute_padding_box_rect());
         context.painter().add_clip_rect(clip_box.to_type<int>());
-        auto scroll_offset = context.rounded_device_point(static_cast<Layout::BlockContainer const&>(layout_box()).scroll_offset());
-        context.painter().translate(-scroll_offset.to_type<int>());
 
+        // The corners have to be sampled before scrolling, as they're blitted back after the translation is restored.
         auto border_radii = normalized_border_radii_data(ShrinkRadiiForBorders::Yes);
         if (border_radii.has_any_radius()) {
             auto clipper = BorderRadiusCornerClipper::create(context, clip_box, border_radii);
@@ -570,6 +569,9 @@ void PaintableWithLines::paint(PaintContext& context, PaintPhase phase) const
                 corner_clipper->sample_under_corners(context.painter());
             }
         }
+
+        auto scroll_offset = context.rounded_device_point(static_cast<Layout::BlockContainer const&>(layout_box()).scroll_offset());
+        context.painter().translate(-scroll_offset.to_type<int>());
     }
 
     // Text shadows
@@ -617,7 +619,7 @@ void PaintableWithLines::paint(PaintContext& context, PaintPhase phase) const
 
     if (should_clip_overflow) {
         context.painter().restore();
-        if (corner_clipper.has_value())
+        if (corner_clipper)
             corner_clipper->blit_corner_clipping(context.painter());
     }
 
@@ -34,9 +34,14 @@ void ProgressPaintable::paint(PaintContext& context, PaintPhase phase) const
         auto min_frame_thickness = context.rounded_device_pixels(3);
         auto frame_thickness = min(min(progress_rect.width(), progress_rect.height()) / 6, min_frame_thickness);
 
-        Gfx::StylePainter::paint_progressbar(context.painter(), progress_rect.shrunken(frame_thickness, frame_thickness).to_type<int>(), context.palette(), 0, round_to<int>(layout_box().dom_node().max()), round_to<int>(layout_box().dom_node().value()), ""sv);
+        auto max = round_to<int>(layout_box().dom_node().max());
+        auto value = round_to<int>(layout_box().dom_node().value());
 
-        Gfx::StylePainter::paint_frame(context.painter(), progress_rect.to_type<int>(), context.palette(), Gfx::FrameShape::Box, Gfx::FrameShadow::Raised, frame_thickness.value());
+        context.painter().paint_with(progress_rect.to_type<int>(), [=, palette = context.palette()](Gfx::Painter& painter) {
+            Gfx::StylePainter::paint_progressbar(painter, progress_rect.shrunken(frame_thickness, frame_thickness).to_type<int>(), palette, 0, max, value, ""sv);
+
+            Gfx::StylePainter::paint_frame(painter, progress_rect.to_type<int>(), palette, Gfx::FrameShape::Box, Gfx::FrameShadow::Raised, frame_thickness.value());
+        });
     }
 }
 
@@ -0,0 +1,546 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/HashMap.h>
+#include <LibGfx/Font/FontDatabase.h>
+#include <LibWeb/Painting/RecordingPainter.h>
+
+namespace Web::Painting {
+
+static Gfx::IntRect rect_between(Gfx::IntPoint a, Gfx::IntPoint b)
+{
+    return Gfx::IntRect::from_two_points(a, b).inflated(1, 1);
+}
+
+Gfx::IntRect DrawLine::bounding_rect() const
+{
+    return rect_between(from, to).inflated(thickness * 2, thickness * 2);
+}
+
+Gfx::IntRect DrawTriangleWave::bounding_rect() const
+{
+    return rect_between(from, to).inflated((amplitude + thickness) * 2, (amplitude + thickness) * 2);
+}
+
+Gfx::IntRect DrawTriangle::bounding_rect() const
+{
+    return rect_between(a, b).united(rect_between(b, c));
+}
+
+Gfx::IntRect StrokePath::bounding_rect() const
+{
+    auto inflation = static_cast<int>(ceilf(thickness)) * 2 + 2;
+    return path.bounding_box().to_rounded<int>().inflated(inflation, inflation);
+}
+
+static bool color_stops_are_equal(ReadonlySpan<Gfx::ColorStop> a, ReadonlySpan<Gfx::ColorStop> b)
+{
+    if (a.size() != b.size())
+        return false;
+    for (size_t i = 0; i < a.size(); ++i) {
+        if (a[i].color != b[i].color || a[i].position != b[i].position || a[i].transition_hint != b[i].transition_hint)
+            return false;
+    }
+    return true;
+}
+
+bool DrawSignedDistanceField::operator==(DrawSignedDistanceField const& other) const
+{
+    return rect == other.rect && color == other.color && smoothing == other.smoothing
+        && sdf.data().data() == other.sdf.data().data() && sdf.size() == other.sdf.size();
+}
+
+bool FillRectWithLinearGradient::operator==(FillRectWithLinearGradient const& other) const
+{
+    return rect == other.rect && angle == other.angle && repeat_length == other.repeat_length
+        && color_stops_are_equal(color_stops, other.color_stops);
+}
+
+bool FillRectWithConicGradient::operator==(FillRectWithConicGradient const& other) const
+{
+    return rect == other.rect && center == other.center && start_angle == other.start_angle
+        && repeat_length == other.repeat_length && color_stops_are_equal(color_stops, other.color_stops);
+}
+
+bool FillRectWithRadialGradient::operator==(FillRectWithRadialGradient const& other) const
+{
+    return rect == other.rect && center == other.center && size == other.size
+        && repeat_length == other.repeat_length && color_stops_are_equal(color_stops, other.color_stops);
+}
+
+static bool corner_radii_are_equal(Gfx::AntiAliasingPainter::CornerRadius const& a, Gfx::AntiAliasingPainter::CornerRadius const& b)
+{
+    return a.horizontal_radius == b.horizontal_radius && a.vertical_radius == b.vertical_radius;
+}
+
+bool FillRectWithRoundedCorners::operator==(FillRectWithRoundedCorners const& other) const
+{
+    return rect == other.rect && color == other.color
+        && corner_radii_are_equal(top_left, other.top_left) && corner_radii_are_equal(top_right, other.top_right)
+        && corner_radii_are_equal(bottom_right, other.bottom_right) && corner_radii_are_equal(bottom_left, other.bottom_left);
+}
+
+// Paths are compared by the lines they're split into, which are computed while recording anyway.
+static bool paths_are_equal(Gfx::Path const& a, Gfx::Path const& b)
+{
+    auto const& a_lines = a.split_lines();
+    auto const& b_lines = b.split_lines();
+    if (a_lines.size() != b_lines.size())
+        return false;
+    for (size_t i = 0; i < a_lines.size(); ++i) {
+        if (a_lines[i].from != b_lines[i].from || a_lines[i].to != b_lines[i].to)
+            return false;
+    }
+    return true;
+}
+
+bool FillPath::operator==(FillPath const& other) const
+{
+    return color == other.color && winding_rule == other.winding_rule && paths_are_equal(path, other.path);
+}
+
+bool StrokePath::operator==(StrokePath const& other) const
+{
+    return color == other.color && thickness == other.thickness && paths_are_equal(path, other.path);
+}
+
+static Optional<Gfx::IntRect> bounding_rect_of(PaintingCommand const& command)
+{
+    return command.visit(
+        [](SetClipRect const&) -> Optional<Gfx::IntRect> { return {}; },
+        [](PaintFunction const& paint_function) { return paint_function.bounding_rect; },
+        [](auto const& command) -> Optional<Gfx::IntRect> { return command.bounding_rect(); });
+}
+
+static bool commands_are_equal(PaintingCommand const& a, PaintingCommand const& b)
+{
+    return a.visit(
+        [](PaintFunction const&) { return false; },
+        [&]<typename T>(T const& command) {
+            if (!b.has<T>())
+                return false;
+            return command == b.get<T>();
+        });
+}
+
+void DisplayList::execute(Gfx::Painter& painter, Optional<Gfx::IntRect> damage_rect, Threading::Mutex* shared_state_lock) const
+{
+    auto run_exclusively = [&](auto const& callback) {
+        if (!shared_state_lock) {
+            callback();
+            return;
+        }
+        Threading::MutexLocker locker(*shared_state_lock);
+        callback();
+    };
+
+    Gfx::PainterStateSaver saver(painter);
+
+    auto base_clip_rect = painter.clip_rect().translated(-painter.translation());
+    if (damage_rect.has_value())
+        base_clip_rect.intersect(*damage_rect);
+    if (base_clip_rect.is_empty())
+        return;
+
+    auto clip_rect = base_clip_rect;
+    auto apply_clip_rect = [&](Gfx::IntRect const& rect) {
+        painter.clear_clip_rect();
+        painter.add_clip_rect(base_clip_rect);
+        painter.add_clip_rect(rect);
+        clip_rect = base_clip_rect.intersected(rect);
+    };
+
+    Gfx::AntiAliasingPainter aa_painter { painter };
+
+    for (auto const& command : m_commands) {
+        if (auto const* set_clip_rect = command.get_pointer<SetClipRect>()) {
+            apply_clip_rect(set_clip_rect->rect);
+            continue;
+        }
+
+        // Functions are only culled against the damage rect, since they may read from outside the clip rect.
+        if (auto const* paint_function = command.get_pointer<PaintFunction>()) {
+            if (paint_function->bounding_rect.has_value() && !paint_function->bounding_rect->intersects(base_clip_rect))
+                continue;
+            run_exclusively([&] {
+                Gfx::PainterStateSaver function_saver(painter);
+                painter.translate(paint_function->translation);
+                paint_function->function(painter);
+            });
+            continue;
+        }
+
+        if (clip_rect.is_empty() || !bounding_rect_of(command)->intersects(clip_rect))
+            continue;
+
+        command.visit(
+            [](SetClipRect const&) { VERIFY_NOT_REACHED(); },
+            [](PaintFunction const&) { VERIFY_NOT_REACHED(); },
+            [&](FillRect const& command) { painter.fill_rect(command.rect, command.color); },
+            [&](ClearRect const& command) { painter.clear_rect(command.rect, command.color); },
+            [&](DrawRect const& command) { painter.draw_rect(command.rect, command.color, command.rough); },
+            [&](DrawFocusRect const& command) { painter.draw_focus_rect(command.rect, command.color); },
+            [&](DrawLine const& command) {
+                painter.draw_line(command.from, command.to, command.color, command.thickness, command.style, command.alternate_color);
+            },
+            [&](DrawTriangleWave const& command) {
+                painter.draw_triangle_wave(command.from, command.to, command.color, command.amplitude, command.thickness);
+            },
+            [&](DrawTriangle const& command) { painter.draw_triangle(command.a, command.b, command.c, command.color); },
+            [&](DrawText const& command) {
+                run_exclusively([&] {
+                    painter.draw_text(command.rect, command.text, *command.font, command.alignment, command.color, command.elision, command.wrapping);
+                });
+            },
+            [&](DrawTextRun const& command) {
+                run_exclusively([&] {
+                    painter.draw_text_run(command.baseline_start, Utf8View(command.text), *command.font, command.color);
+                });
+            },
+            [&](DrawScaledBitmap const& command) {
+                painter.draw_scaled_bitmap(command.dst_rect, *command.bitmap, command.src_rect, command.opacity, command.scaling_mode);
+            },
+            [&](Blit const& command) { painter.blit(command.position, *command.bitmap, command.src_rect, command.opacity); },
+            [&](DrawSignedDistanceField const& command) {
+                painter.draw_signed_distance_field(command.rect, command.color, command.sdf, command.smoothing);
+            },
+            [&](FillRectWithLinearGradient const& command) {
+                painter.fill_rect_with_linear_gradient(command.rect, command.color_stops, command.angle, command.repeat_length);
+            },
+            [&](FillRectWithConicGradient const& command) {
+                painter.fill_rect_with_conic_gradient(command.rect, command.color_stops, command.center, command.start_angle, command.repeat_length);
+            },
+            [&](FillRectWithRadialGradient const& command) {
+                painter.fill_rect_with_radial_gradient(command.rect, command.color_stops, command.center, command.size, command.repeat_length);
+            },
+            [&](FillRectWithRoundedCorners const& command) {
+                aa_painter.fill_rect_with_rounded_corners(command.rect, command.color, command.top_left, command.top_right, command.bottom_right, command.bottom_left);
+            },
+            [&](FillEllipse const& command) { aa_painter.fill_ellipse(command.rect, command.color); },
+            [&](DrawEllipse const& command) { aa_painter.draw_ellipse(command.rect, command.color, command.thickness); },
+            [&](FillPath const& command) { aa_painter.fill_path(command.path, command.color, command.winding_rule); },
+            [&](StrokePath const& command) { aa_painter.stroke_path(command.path, command.color, command.thickness); });
+    }
+}
+
+Gfx::IntRect DisplayList::compute_damage(DisplayList const& previous, Gfx::IntRect const& viewport_rect) const
+{
+    // Two commands only paint the same pixels if they are also clipped the same way.
+    struct ClippedCommand {
+        PaintingCommand const* command;
+        Gfx::IntRect clip_rect;
+    };
+    auto clip_commands = [&](Vector<PaintingCommand> const& commands) {
+        Vector<ClippedCommand> clipped_commands;
+        clipped_commands.ensure_capacity(commands.size());
+        auto clip_rect = viewport_rect;
+        for (auto const& command : commands) {
+            if (auto const* set_clip_rect = command.get_pointer<SetClipRect>())
+                clip_rect = set_clip_rect->rect;
+            else
+                clipped_commands.unchecked_append({ &command, clip_rect });
+        }
+        return clipped_commands;
+    };
+    auto old_commands = clip_commands(previous.m_commands);
+    auto new_commands = clip_commands(m_commands);
+
+    Gfx::IntRect damage;
+    auto add_damage = [&](ClippedCommand const& command) {
+        if (auto const* paint_function = command.command->get_pointer<PaintFunction>()) {
+            if (!paint_function->only_samples)
+                damage = damage.united(paint_function->bounding_rect.value_or(viewport_rect));
+            return;
+        }
+        damage = damage.united(bounding_rect_of(*command.command)->intersected(command.clip_rect));
+    };
+
+    // Functions can't be compared, so they always damage their area. Two of them with the same area still line up,
+    // though, so that they don't get in the way of matching up the commands around them.
+    auto commands_match = [](ClippedCommand const& a, ClippedCommand const& b) {
+        if (a.clip_rect != b.clip_rect)
+            return false;
+        if (auto const* a_function = a.command->get_pointer<PaintFunction>()) {
+            auto const* b_function = b.command->get_pointer<PaintFunction>();
+            return b_function && a_function->bounding_rect == b_function->bounding_rect && a_function->only_samples == b_function->only_samples;
+        }
+        return commands_are_equal(*a.command, *b.command);
+    };
+
+    // Most repaints only change a few commands somewhere in the middle, so skip over the common prefix and suffix of
+    // both lists first. Functions among them still damage their area.
+    auto skip_matched_command = [&](ClippedCommand const& command) {
+        if (command.command->has<PaintFunction>())
+            add_damage(command);
+    };
+    auto const common_size_limit = min(old_commands.size(), new_commands.size());
+    size_t common_prefix = 0;
+    while (common_prefix < common_size_limit && commands_match(old_commands[common_prefix], new_commands[common_prefix]))
+        skip_matched_command(new_commands[common_prefix++]);
+    size_t common_suffix = 0;
+    while (common_prefix + common_suffix < common_size_limit
+        && commands_match(old_commands[old_commands.size() - common_suffix - 1], new_commands[new_commands.size() - common_suffix - 1])) {
+        skip_matched_command(new_commands[new_commands.size() - common_suffix - 1]);
+        ++common_suffix;
+    }
+    auto old_middle = old_commands.span().slice(common_prefix, old_commands.size() - common_prefix - common_suffix);
+    auto new_middle = new_commands.span().slice(common_prefix, new_commands.size() - common_prefix - common_suffix);
+
+    auto key_of = [](ClippedCommand const& command) {
+        auto rect = bounding_rect_of(*command.command).value_or({});
+        return pair_int_hash(pair_int_hash(rect.x(), rect.y()), pair_int_hash(rect.width(), rect.height()));
+    };
+
+    // Match up the rest of the commands of both lists in order, and damage the area of everything that's left over.
+    // Since the matched commands are painted in the same order, any pixel outside of the left over commands ends up
+    // the same. Each new command is matched to the first unmatched old command after the last match that equals it,
+    // which finds everything but reordered commands.
+    struct Candidates {
+        Vector<size_t> old_indices;
+        size_t next { 0 };
+    };
+    HashMap<u32, Candidates> candidates_by_key;
+    for (size_t i = 0; i < old_middle.size(); ++i)
+        candidates_by_key.ensure(key_of(old_middle[i])).old_indices.append(i);
+
+    Vector<bool> old_command_matched;
+    old_command_matched.resize(old_middle.size());
+    size_t first_unmatchable_index = 0;
+
+    for (auto const& new_command : new_middle) {
+        if (new_command.command->has<PaintFunction>())
+            add_damage(new_command);
+
+        bool matched = false;
+        if (auto it = candidates_by_key.find(key_of(new_command)); it != candidates_by_key.end()) {
+            auto& candidates = it->value;
+            while (candidates.next < candidates.old_indices.size() && candidates.old_indices[candidates.next] < first_unmatchable_index)
+                ++candidates.next;
+            // Commands that only differ in something like their color share a key, so don't look too far.
+            static constexpr size_t max_candidates_to_compare = 16;
+            auto end = min(candidates.old_indices.size(), candidates.next + max_candidates_to_compare);
+            for (auto i = candidates.next; i < end; ++i) {
+                auto old_index = candidates.old_indices[i];
+                if (commands_match(old_middle[old_index], new_command)) {
+                    old_command_matched[old_index] = true;
+                    first_unmatchable_index = old_index + 1;
+                    candidates.next = i + 1;
+                    matched = true;
+                    break;
+                }
+            }
+        }
+        if (!matched && !new_command.command->has<PaintFunction>())
+            add_damage(new_command);
+    }
+
+    for (size_t i = 0; i < old_middle.size(); ++i) {
+        if (!old_command_matched[i])
+            add_damage(old_middle[i]);
+    }
+
+    return damage.intersected(viewport_rect);
+}
+
+RecordingPainter::RecordingPainter(DisplayList& display_list, Gfx::IntRect const& target_rect)
+    : m_display_list(display_list)
+    , m_target_rect(target_rect)
+{
+    m_state_stack.append(State { .translation = {}, .clip_rect = target_rect, .font = nullptr });
+}
+
+void RecordingPainter::push_command(PaintingCommand&& command)
+{
+    if (m_recorded_clip_rect != clip_rect()) {
+        m_display_list.append(SetClipRect { clip_rect() });
+        m_recorded_clip_rect = clip_rect();
+    }
+    m_display_list.append(move(command));
+}
+
+Gfx::Font const& RecordingPainter::font() const
+{
+    if (!state().font)
+        return Gfx::FontDatabase::default_font();
+    return *state().font;
+}
+
+void RecordingPainter::add_clip_rect(Gfx::IntRect const& rect)
+{
+    state().clip_rect.intersect(to_target(rect));
+}
+
+void RecordingPainter::clear_rect(Gfx::IntRect const& rect, Color color)
+{
+    push_command(ClearRect { to_target(rect), color });
+}
+
+void RecordingPainter::fill_rect(Gfx::IntRect const& rect, Color color)
+{
+    push_command(FillRect { to_target(rect), color });
+}
+
+void RecordingPainter::draw_rect(Gfx::IntRect const& rect, Color color, bool rough)
+{
+    push_command(DrawRect { to_target(rect), color, rough });
+}
+
+void RecordingPainter::draw_focus_rect(Gfx::IntRect const& rect, Color color)
+{
+    push_command(DrawFocusRect { to_target(rect), color });
+}
+
+void RecordingPainter::draw_line(Gfx::IntPoint from, Gfx::IntPoint to, Color color, int thickness, Gfx::Painter::LineStyle style, Color alternate_color)
+{
+    push_command(DrawLine { to_target(from), to_target(to), color, thickness, style, alternate_color });
+}
+
+void RecordingPainter::draw_triangle_wave(Gfx::IntPoint from, Gfx::IntPoint to, Color color, int amplitude, int thickness)
+{
+    push_command(DrawTriangleWave { to_target(from), to_target(to), color, amplitude, thickness });
+}
+
+void RecordingPainter::draw_triangle(Gfx::IntPoint offset, ReadonlySpan<Gfx::IntPoint> points, Color color)
+{
+    VERIFY(points.size() == 3);
+    auto origin = to_target(offset);
+    push_command(DrawTriangle { points[0].translated(origin), points[1].translated(origin), points[2].translated(origin), color });
+}
+
+void RecordingPainter::draw_text(Gfx::IntRect const& rect, StringView raw_text, Gfx::Font const& font, Gfx::TextAlignment alignment, Color color, Gfx::TextElision elision, Gfx::TextWrapping wrapping)
+{
+    // The text may be aligned to any side of the rect, so allow for it to stick out by its whole size on each side.
+    auto target_rect = to_target(rect);
+    auto text_width = static_cast<int>(ceilf(font.width(raw_text)));
+    auto text_height = static_cast<int>(ceilf(font.preferred_line_height()));
+    auto text_bounding_rect = target_rect.inflated(text_height * 2, text_width * 2, text_height * 2, text_width * 2);
+    if (elision == Gfx::TextElision::Right && wrapping == Gfx::TextWrapping::DontWrap)
+        text_bounding_rect = target_rect.inflated(text_height, text_height);
+
+    push_command(DrawText {
+        .rect = target_rect,
+        .text = raw_text,
+        .font = font,
+        .alignment = alignment,
+        .color = color,
+        .elision = elision,
+        .wrapping = wrapping,
+        .text_bounding_rect = text_bounding_rect,
+    });
+}
+
+void RecordingPainter::draw_text(Gfx::IntRect const& rect, StringView raw_text, Gfx::TextAlignment alignment, Color color, Gfx::TextElision elision, Gfx::TextWrapping wrapping)
+{
+    draw_text(rect, raw_text, font(), alignment, color, elision, wrapping);
+}
+
+void RecordingPainter::draw_text_run(Gfx::IntPoint baseline_start, Utf8View const& string, Gfx::Font const& font, Color color)
+{
+    auto target_baseline_start = to_target(baseline_start);
+    auto metrics = font.pixel_metrics();
+    // Glyphs can overhang their advance (think of italics), so leave some room on every side.
+    auto overhang = static_cast<int>(ceilf(font.pixel_size()));
+    Gfx::IntRect text_bounding_rect {
+        target_baseline_start.x(),
+        target_baseline_start.y() - static_cast<int>(ceilf(metrics.ascent)),
+        static_cast<int>(ceilf(font.width(string))),
+        static_cast<int>(ceilf(metrics.ascent + metrics.descent)),
+    };
+
+    push_command(DrawTextRun {
+        .baseline_start = target_baseline_start,
+        .text = string.as_string(),
+        .font = font,
+        .color = color,
+        .text_bounding_rect = text_bounding_rect.inflated(overhang, overhang),
+    });
+}
+
+void RecordingPainter::draw_scaled_bitmap(Gfx::IntRect const& dst_rect, Gfx::Bitmap const& bitmap, Gfx::IntRect const& src_rect, float opacity, Gfx::Painter::ScalingMode scaling_mode)
+{
+    push_command(DrawScaledBitmap { to_target(dst_rect), bitmap, src_rect, opacity, scaling_mode });
+}
+
+void RecordingPainter::blit(Gfx::IntPoint position, Gfx::Bitmap const& bitmap, Gfx::IntRect const& src_rect, float opacity)
+{
+    push_command(Blit { to_target(position), bitmap, src_rect, opacity });
+}
+
+void RecordingPainter::draw_signed_distance_field(Gfx::IntRect const& dst_rect, Color color, Gfx::GrayscaleBitmap const& sdf, float smoothing)
+{
+    push_command(DrawSignedDistanceField { to_target(dst_rect), color, sdf, smoothing });
+}
+
+void RecordingPainter::fill_rect_with_linear_gradient(Gfx::IntRect const& rect, ReadonlySpan<Gfx::ColorStop> color_stops, float angle, Optional<float> repeat_length)
+{
+    push_command(FillRectWithLinearGradient { to_target(rect), Vector<Gfx::ColorStop> { color_stops }, angle, repeat_length });
+}
+
+void RecordingPainter::fill_rect_with_conic_gradient(Gfx::IntRect const& rect, ReadonlySpan<Gfx::ColorStop> color_stops, Gfx::IntPoint center, float start_angle, Optional<float> repeat_length)
+{
+    push_command(FillRectWithConicGradient { to_target(rect), Vector<Gfx::ColorStop> { color_stops }, center, start_angle, repeat_length });
+}
+
+void RecordingPainter::fill_rect_with_radial_gradient(Gfx::IntRect const& rect, ReadonlySpan<Gfx::ColorStop> color_stops, Gfx::IntPoint center, Gfx::IntSize size, Optional<float> repeat_length)
+{
+    push_command(FillRectWithRadialGradient { to_target(rect), Vector<Gfx::ColorStop> { color_stops }, center, size, repeat_length });
+}
+
+void RecordingPainter::fill_rect_with_rounded_corners(Gfx::IntRect const& rect, Color color, int radius)
+{
+    Gfx::AntiAliasingPainter::CornerRadius corner_radius { radius, radius };
+    fill_rect_with_rounded_corners(rect, color, corner_radius, corner_radius, corner_radius, corner_radius);
+}
+
+void RecordingPainter::fill_rect_with_rounded_corners(Gfx::IntRect const& rect, Color color, Gfx::AntiAliasingPainter::CornerRadius top_left, Gfx::AntiAliasingPainter::CornerRadius top_right, Gfx::AntiAliasingPainter::CornerRadius bottom_right, Gfx::AntiAliasingPainter::CornerRadius bottom_left)
+{
+    push_command(FillRectWithRoundedCorners { to_target(rect), color, top_left, top_right, bottom_right, bottom_left });
+}
+
+void RecordingPainter::fill_ellipse(Gfx::IntRect const& rect, Color color)
+{
+    push_command(FillEllipse { to_target(rect), color });
+}
+
+void RecordingPainter::draw_ellipse(Gfx::IntRect const& rect, Color color, int thickness)
+{
+    push_command(DrawEllipse { to_target(rect), color, thickness });
+}
+
+// Paths split themselves into lines the first time they're asked for them, which has to happen before the command
+// can be replayed on several threads at once.
+static Gfx::Path translated_and_split_path(Gfx::Path const& path, Gfx::IntPoint translation)
+{
+    auto translated_path = path.copy_transformed(Gfx::AffineTransform {}.translate(translation.to_type<float>()));
+    (void)translated_path.split_lines();
+    return translated_path;
+}
+
+void RecordingPainter::fill_path(Gfx::Path const& path, Color color, Gfx::Painter::WindingRule winding_rule)
+{
+    push_command(FillPath { translated_and_split_path(path, translation()), color, winding_rule });
+}
+
+void RecordingPainter::stroke_path(Gfx::Path const& path, Color color, float thickness)
+{
+    push_command(StrokePath { translated_and_split_path(path, translation()), color, thickness });
+}
+
+void RecordingPainter::paint_with(Optional<Gfx::IntRect> bounding_rect, Function<void(Gfx::Painter&)> function)
+{
+    if (bounding_rect.has_value())
+        bounding_rect = to_target(*bounding_rect);
+    push_command(PaintFunction { translation(), bounding_rect, false, move(function) });
+}
+
+void RecordingPainter::sample_with(Optional<Gfx::IntRect> bounding_rect, Function<void(Gfx::Painter&)> function)
+{
+    if (bounding_rect.has_value())
+        bounding_rect = to_target(*bounding_rect);
+    push_command(PaintFunction { translation(), bounding_rect, true, move(function) });
+}
+
+}
@@ -0,0 +1,416 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/DeprecatedString.h>
+#include <AK/Function.h>
+#include <AK/Noncopyable.h>
+#include <AK/NonnullRefPtr.h>
+#include <AK/Optional.h>
+#include <AK/Variant.h>
+#include <AK/Vector.h>
+#include <LibGfx/AntiAliasingPainter.h>
+#include <LibGfx/Bitmap.h>
+#include <LibGfx/Font/Font.h>
+#include <LibGfx/Gradients.h>
+#include <LibGfx/GrayscaleBitmap.h>
+#include <LibGfx/Painter.h>
+#include <LibGfx/Path.h>
+#include <LibGfx/Rect.h>
+#include <LibGfx/TextAlignment.h>
+#include <LibGfx/TextElision.h>
+#include <LibGfx/TextWrapping.h>
+#include <LibThreading/Mutex.h>
+
+namespace Web::Painting {
+
+// All the rects and points of painting commands are in the coordinates of the target bitmap: the translation the
+// painting code had applied when it recorded a command is already part of it.
+
+struct SetClipRect {
+    Gfx::IntRect rect;
+
+    bool operator==(SetClipRect const&) const = default;
+};
+
+struct FillRect {
+    Gfx::IntRect rect;
+    Color color;
+
+    Gfx::IntRect bounding_rect() const { return rect; }
+    bool operator==(FillRect const&) const = default;
+};
+
+struct ClearRect {
+    Gfx::IntRect rect;
+    Color color;
+
+    Gfx::IntRect bounding_rect() const { return rect; }
+    bool operator==(ClearRect const&) const = default;
+};
+
+struct DrawRect {
+    Gfx::IntRect rect;
+    Color color;
+    bool rough { false };
+
+    Gfx::IntRect bounding_rect() const { return rect; }
+    bool operator==(DrawRect const&) const = default;
+};
+
+struct DrawFocusRect {
+    Gfx::IntRect rect;
+    Color color;
+
+    Gfx::IntRect bounding_rect() const { return rect; }
+    bool operator==(DrawFocusRect const&) const = default;
+};
+
+struct DrawLine {
+    Gfx::IntPoint from;
+    Gfx::IntPoint to;
+    Color color;
+    int thickness { 1 };
+    Gfx::Painter::LineStyle style { Gfx::Painter::LineStyle::Solid };
+    Color alternate_color { Color::Transparent };
+
+    Gfx::IntRect bounding_rect() const;
+    bool operator==(DrawLine const&) const = default;
+};
+
+struct DrawTriangleWave {
+    Gfx::IntPoint from;
+    Gfx::IntPoint to;
+    Color color;
+    int amplitude { 0 };
+    int thickness { 1 };
+
+    Gfx::IntRect bounding_rect() const;
+    bool operator==(DrawTriangleWave const&) const = default;
+};
+
+struct DrawTriangle {
+    Gfx::IntPoint a;
+    Gfx::IntPoint b;
+    Gfx::IntPoint c;
+    Color color;
+
+    Gfx::IntRect bounding_rect() const;
+    bool operator==(DrawTriangle const&) const = default;
+};
+
+struct DrawText {
+    Gfx::IntRect rect;
+    DeprecatedString text;
+    NonnullRefPtr<Gfx::Font const> font;
+    Gfx::TextAlignment alignment;
+    Color color;
+    Gfx::TextElision elision;
+    Gfx::TextWrapping wrapping;
+    // The text may extend past `rect` when it is not elided, so this is computed when the command is recorded.
+    Gfx::IntRect text_bounding_rect;
+
+    Gfx::IntRect bounding_rect() const { return text_bounding_rect; }
+    bool operator==(DrawText const&) const = default;
+};
+
+struct DrawTextRun {
+    Gfx::IntPoint baseline_start;
+    DeprecatedString text;
+    NonnullRefPtr<Gfx::Font const> font;
+    Color color;
+    Gfx::IntRect text_bounding_rect;
+
+    Gfx::IntRect bounding_rect() const { return text_bounding_rect; }
+    bool operator==(DrawTextRun const&) const = default;
+};
+
+// Bitmaps are compared by identity. Code that changes the pixels of a bitmap in place (like <canvas>) invalidates
+// the area it is painted to instead.
+struct DrawScaledBitmap {
+    Gfx::IntRect dst_rect;
+    NonnullRefPtr<Gfx::Bitmap const> bitmap;
+    Gfx::IntRect src_rect;
+    float opacity { 1.0f };
+    Gfx::Painter::ScalingMode scaling_mode { Gfx::Painter::ScalingMode::NearestNeighbor };
+
+    Gfx::IntRect bounding_rect() const { return dst_rect; }
+    bool operator==(DrawScaledBitmap const&) const = default;
+};
+
+struct Blit {
+    Gfx::IntPoint position;
+    NonnullRefPtr<Gfx::Bitmap const> bitmap;
+    Gfx::IntRect src_rect;
+    float opacity { 1.0f };
+
+    Gfx::IntRect bounding_rect() const { return { position, src_rect.size() }; }
+    bool operator==(Blit const&) const = default;
+};
+
+struct DrawSignedDistanceField {
+    Gfx::IntRect rect;
+    Color color;
+    Gfx::GrayscaleBitmap sdf;
+    float smoothing { 0 };
+
+    Gfx::IntRect bounding_rect() const { return rect; }
+    bool operator==(DrawSignedDistanceField const&) const;
+};
+
+struct FillRectWithLinearGradient {
+    Gfx::IntRect rect;
+    Vector<Gfx::ColorStop> color_stops;
+    float angle { 0 };
+    Optional<float> repeat_length;
+
+    Gfx::IntRect bounding_rect() const { return rect; }
+    bool operator==(FillRectWithLinearGradient const&) const;
+};
+
+struct FillRectWithConicGradient {
+    Gfx::IntRect rect;
+    Vector<Gfx::ColorStop> color_stops;
+    Gfx::IntPoint center;
+    float start_angle { 0 };
+    Optional<float> repeat_length;
+
+    Gfx::IntRect bounding_rect() const { return rect; }
+    bool operator==(FillRectWithConicGradient const&) const;
+};
+
+struct FillRectWithRadialGradient {
+    Gfx::IntRect rect;
+    Vector<Gfx::ColorStop> color_stops;
+    Gfx::IntPoint center;
+    Gfx::IntSize size;
+    Optional<float> repeat_length;
+
+    Gfx::IntRect bounding_rect() const { return rect; }
+    bool operator==(FillRectWithRadialGradient const&) const;
+};
+
+// The commands below are painted with anti-aliasing.
+
+struct FillRectWithRoundedCorners {
+    Gfx::IntRect rect;
+    Color color;
+    Gfx::AntiAliasingPainter::CornerRadius top_left;
+    Gfx::AntiAliasingPainter::CornerRadius top_right;
+    Gfx::AntiAliasingPainter::CornerRadius bottom_right;
+    Gfx::AntiAliasingPainter::CornerRadius bottom_left;
+
+    Gfx::IntRect bounding_rect() const { return rect; }
+    bool operator==(FillRectWithRoundedCorners const&) const;
+};
+
+struct FillEllipse {
+    Gfx::IntRect rect;
+    Color color;
+
+    Gfx::IntRect bounding_rect() const { return rect; }
+    bool operator==(FillEllipse const&) const = default;
+};
+
+struct DrawEllipse {
+    Gfx::IntRect rect;
+    Color color;
+    int thickness { 1 };
+
+    Gfx::IntRect bounding_rect() const { return rect; }
+    bool operator==(DrawEllipse const&) const = default;
+};
+
+// Paths aren't compared, so these always count as a change to their bounding rect.
+struct FillPath {
+    Gfx::Path path;
+    Color color;
+    Gfx::Painter::WindingRule winding_rule { Gfx::Painter::WindingRule::Nonzero };
+
+    Gfx::IntRect bounding_rect() const { return path.bounding_box().to_rounded<int>().inflated(2, 2); }
+    bool operator==(FillPath const&) const;
+};
+
+struct StrokePath {
+    Gfx::Path path;
+    Color color;
+    float thickness { 1 };
+
+    Gfx::IntRect bounding_rect() const;
+    bool operator==(StrokePath const&) const;
+};
+
+// Painting that can't be expressed with the commands above, like anything that reads back from the target bitmap.
+// The function is called with the painter translated the same way it was when the command was recorded. It can't
+// be compared to anything, so it always counts as a change to its bounding rect, or to everything if it has none.
+// Functions that only sample the target never count as a change.
+struct PaintFunction {
+    Gfx::IntPoint translation;
+    Optional<Gfx::IntRect> bounding_rect;
+    bool only_samples { false };
+    Function<void(Gfx::Painter&)> function;
+};
+
+using PaintingCommand = Variant<
+    SetClipRect,
+    FillRect,
+    ClearRect,
+    DrawRect,
+    DrawFocusRect,
+    DrawLine,
+    DrawTriangleWave,
+    DrawTriangle,
+    DrawText,
+    DrawTextRun,
+    DrawScaledBitmap,
+    Blit,
+    DrawSignedDistanceField,
+    FillRectWithLinearGradient,
+    FillRectWithConicGradient,
+    FillRectWithRadialGradient,
+    FillRectWithRoundedCorners,
+    FillEllipse,
+    DrawEllipse,
+    FillPath,
+    StrokePath,
+    PaintFunction>;
+
+// A recorded sequence of painting commands that can be replayed onto a Gfx::Painter any number of times.
+class DisplayList {
+    AK_MAKE_NONCOPYABLE(DisplayList);
+
+public:
+    DisplayList() = default;
+    DisplayList(DisplayList&&) = default;
+    DisplayList& operator=(DisplayList&&) = default;
+
+    void append(PaintingCommand&& command) { m_commands.append(move(command)); }
+
+    bool is_empty() const { return m_commands.is_empty(); }
+    size_t size() const { return m_commands.size(); }
+    Vector<PaintingCommand> const& commands() const { return m_commands; }
+
+    // Replays the commands onto the painter. Commands that can't touch any pixel inside `damage_rect` (in the
+    // painter's coordinates) are skipped, and nothing outside of it is painted.
+    // To replay parts of the same list on several threads at once, pass the same lock to each of them. Commands that
+    // touch state shared between threads, like glyph caches, reference counts and paint functions, hold it while
+    // they run.
+    void execute(Gfx::Painter&, Optional<Gfx::IntRect> damage_rect = {}, Threading::Mutex* shared_state_lock = nullptr) const;
+
+    // Returns the area that painting this list would change on a bitmap that `previous` has been painted onto.
+    // Commands that were only added or removed, like when content scrolls into view, damage just their own area.
+    // Anything that can't be bounded is assumed to cover all of `viewport_rect`.
+    Gfx::IntRect compute_damage(DisplayList const& previous, Gfx::IntRect const& viewport_rect) const;
+
+private:
+    Vector<PaintingCommand> m_commands;
+};
+
+// Records painting commands into a DisplayList, with an API that mirrors the parts of Gfx::Painter that LibWeb
+// painting uses. The translation, clip rect and font are tracked while recording, so that painting code can keep
+// querying them.
+class RecordingPainter {
+    AK_MAKE_NONCOPYABLE(RecordingPainter);
+    AK_MAKE_NONMOVABLE(RecordingPainter);
+
+public:
+    RecordingPainter(DisplayList&, Gfx::IntRect const& target_rect);
+
+    void clear_rect(Gfx::IntRect const&, Color);
+    void fill_rect(Gfx::IntRect const&, Color);
+    void draw_rect(Gfx::IntRect const&, Color, bool rough = false);
+    void draw_focus_rect(Gfx::IntRect const&, Color);
+    void draw_line(Gfx::IntPoint, Gfx::IntPoint, Color, int thickness = 1, Gfx::Painter::LineStyle style = Gfx::Painter::LineStyle::Solid, Color alternate_color = Color::Transparent);
+    void draw_triangle_wave(Gfx::IntPoint, Gfx::IntPoint, Color color, int amplitude, int thickness = 1);
+    void draw_triangle(Gfx::IntPoint offset, ReadonlySpan<Gfx::IntPoint>, Color);
+
+    void draw_text(Gfx::IntRect const&, StringView, Gfx::Font const&, Gfx::TextAlignment = Gfx::TextAlignment::TopLeft, Color = Color::Black, Gfx::TextElision = Gfx::TextElision::None, Gfx::TextWrapping = Gfx::TextWrapping::DontWrap);
+    void draw_text(Gfx::IntRect const&, StringView, Gfx::TextAlignment = Gfx::TextAlignment::TopLeft, Color = Color::Black, Gfx::TextElision = Gfx::TextElision::None, Gfx::TextWrapping = Gfx::TextWrapping::DontWrap);
+    void draw_text_run(Gfx::IntPoint baseline_start, Utf8View const&, Gfx::Font const&, Color);
+
+    void draw_scaled_bitmap(Gfx::IntRect const& dst_rect, Gfx::Bitmap const&, Gfx::IntRect const& src_rect, float opacity = 1.0f, Gfx::Painter::ScalingMode = Gfx::Painter::ScalingMode::NearestNeighbor);
+    void blit(Gfx::IntPoint, Gfx::Bitmap const&, Gfx::IntRect const& src_rect, float opacity = 1.0f);
+    void draw_signed_distance_field(Gfx::IntRect const& dst_rect, Color, Gfx::GrayscaleBitmap const&, float smoothing);
+
+    void fill_rect_with_linear_gradient(Gfx::IntRect const&, ReadonlySpan<Gfx::ColorStop>, float angle, Optional<float> repeat_length = {});
+    void fill_rect_with_conic_gradient(Gfx::IntRect const&, ReadonlySpan<Gfx::ColorStop>, Gfx::IntPoint center, float start_angle, Optional<float> repeat_length = {});
+    void fill_rect_with_radial_gradient(Gfx::IntRect const&, ReadonlySpan<Gfx::ColorStop>, Gfx::IntPoint center, Gfx::IntSize size, Optional<float> repeat_length = {});
+
+    void fill_rect_with_rounded_corners(Gfx::IntRect const&, Color, int radius);
+    void fill_rect_with_rounded_corners(Gfx::IntRect const&, Color, Gfx::AntiAliasingPainter::CornerRadius top_left, Gfx::AntiAliasingPainter::CornerRadius top_right, Gfx::AntiAliasingPainter::CornerRadius bottom_right, Gfx::AntiAliasingPainter::CornerRadius bottom_left);
+    void fill_ellipse(Gfx::IntRect const&, Color);
+    void draw_ellipse(Gfx::IntRect const&, Color, int thickness);
+    void fill_path(Gfx::Path const&, Color, Gfx::Painter::WindingRule = Gfx::Painter::WindingRule::Nonzero);
+    void stroke_path(Gfx::Path const&, Color, float thickness);
+
+    // Records a function that paints directly onto the target painter when the display list is replayed. The
+    // bounding rect is in the current coordinates, like the rects passed to the other functions.
+    void paint_with(Optional<Gfx::IntRect> bounding_rect, Function<void(Gfx::Painter&)>);
+    // Records a function that reads from the target painter without painting anything onto it. It is skipped
+    // along with everything else that's outside the damaged area, so whatever paints with what it sampled should
+    // use the same bounding rect.
+    void sample_with(Optional<Gfx::IntRect> bounding_rect, Function<void(Gfx::Painter&)>);
+
+    Gfx::Font const& font() const;
+    void set_font(Gfx::Font const& font) { state().font = &font; }
+
+    void translate(int dx, int dy) { translate({ dx, dy }); }
+    void translate(Gfx::IntPoint delta) { state().translation.translate_by(delta); }
+    Gfx::IntPoint translation() const { return state().translation; }
+
+    void add_clip_rect(Gfx::IntRect const&);
+    void clear_clip_rect() { state().clip_rect = m_target_rect; }
+    Gfx::IntRect clip_rect() const { return state().clip_rect; }
+
+    void save() { m_state_stack.append(m_state_stack.last()); }
+    void restore()
+    {
+        VERIFY(m_state_stack.size() > 1);
+        m_state_stack.take_last();
+    }
+
+    Gfx::IntRect const& target_rect() const { return m_target_rect; }
+
+private:
+    struct State {
+        Gfx::IntPoint translation;
+        Gfx::IntRect clip_rect;
+        Gfx::Font const* font { nullptr };
+    };
+
+    State& state() { return m_state_stack.last(); }
+    State const& state() const { return m_state_stack.last(); }
+
+    Gfx::IntRect to_target(Gfx::IntRect const& rect) const { return rect.translated(translation()); }
+    Gfx::IntPoint to_target(Gfx::IntPoint point) const { return point.translated(translation()); }
+
+    void push_command(PaintingCommand&&);
+
+    DisplayList& m_display_list;
+    Gfx::IntRect m_target_rect;
+    Vector<State, 8> m_state_stack;
+    Optional<Gfx::IntRect> m_recorded_clip_rect;
+};
+
+class RecordingPainterStateSaver {
+public:
+    explicit RecordingPainterStateSaver(RecordingPainter& painter)
+        : m_painter(painter)
+    {
+        m_painter.save();
+    }
+
+    ~RecordingPainterStateSaver()
+    {
+        m_painter.restore();
+    }
+
+private:
+    RecordingPainter& m_painter;
+};
+
+}
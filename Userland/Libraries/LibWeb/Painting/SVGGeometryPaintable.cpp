@@ -5,7 +5,6 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
-#include <LibGfx/AntiAliasingPainter.h>
 #include <LibWeb/Layout/ImageBox.h>
 #include <LibWeb/Painting/SVGGeometryPaintable.h>
 #include <LibWeb/SVG/SVGSVGElement.h>
@@ -54,18 +53,19 @@ void SVGGeometryPaintable::paint(PaintContext& context, PaintPhase phase) const
 
     auto& geometry_element = layout_box().dom_node();
 
-    Gfx::AntiAliasingPainter painter { context.painter() };
+    auto& painter = context.painter();
     auto& svg_context = context.svg_context();
 
+    RecordingPainterStateSaver save_painter { painter };
+    painter.add_clip_rect(context.enclosing_device_rect(absolute_rect()).to_type<int>());
+
     // FIXME: This should not be trucated to an int.
-    Gfx::PainterStateSaver save_painter { context.painter() };
-    auto offset = context.floored_device_point(svg_context.svg_element_position()).to_type<int>().to_type<float>();
+    auto offset = context.floored_device_point(svg_context.svg_element_position()).to_type<int>();
     painter.translate(offset);
 
     auto const* svg_element = geometry_element.first_ancestor_of_type<SVG::SVGSVGElement>();
     auto maybe_view_box = svg_element->view_box();
 
-    context.painter().add_clip_rect(context.enclosing_device_rect(absolute_rect()).to_type<int>());
     auto css_scale = context.device_pixels_per_css_pixel();
 
     auto transform = layout_box().layout_transform();
@@ -363,9 +363,10 @@ Gfx::AffineTransform StackingContext::affine_transform_matrix() const
 
 void StackingContext::paint(PaintContext& context) const
 {
-    Gfx::PainterStateSaver saver(context.painter());
+    RecordingPainterStateSaver saver(context.painter());
     if (m_box->is_fixed_position()) {
-        context.painter().translate(-context.painter().translation());
+        // Pages are recorded in document coordinates, so fixed position boxes are moved to wherever the viewport is.
+        context.painter().translate(-context.painter().translation() + context.device_viewport_rect().location().to_type<int>());
     }
 
     auto opacity = m_box->computed_values().opacity();
@@ -387,37 +388,49 @@ void StackingContext::paint(PaintContext& context) const
         // to the size of the source (which could add some artefacts, though just scaling the bitmap already does that).
         // We need to copy the background at the destination because a bunch of our rendering effects now rely on
         // being able to sample the painter (see border radii, shadows, filters, etc).
-        CSSPixelPoint destination_clipped_fixup {};
-        auto try_get_scaled_destination_bitmap = [&]() -> ErrorOr<NonnullRefPtr<Gfx::Bitmap>> {
-            Gfx::IntRect actual_destination_rect;
-            auto bitmap = TRY(context.painter().get_region_bitmap(destination_rect, Gfx::BitmapFormat::BGRA8888, actual_destination_rect));
-            // get_region_bitmap() may clip to a smaller region if the requested rect goes outside the painter, so we need to account for that.
-            destination_clipped_fixup = CSSPixelPoint { destination_rect.location() - actual_destination_rect.location() };
-            destination_rect = actual_destination_rect;
-            if (source_rect.size() != transformed_destination_rect.size()) {
-                auto sx = static_cast<float>(source_rect.width()) / transformed_destination_rect.width();
-                auto sy = static_cast<float>(source_rect.height()) / transformed_destination_rect.height();
-                bitmap = TRY(bitmap->scaled(sx, sy));
-                destination_clipped_fixup.scale_by(sx, sy);
-            }
-            return bitmap;
-        };
+        // The layer is recorded into a display list of its own, which is replayed into that bitmap once the
+        // background at the destination can be read back.
+        DisplayList layer_display_list;
+        {
+            RecordingPainter layer_painter(layer_display_list, { {}, source_rect.size().to_type<int>() });
+            layer_painter.translate(context.rounded_device_point(-paintable().absolute_paint_rect().location()).to_type<int>());
+            auto paint_context = context.clone(layer_painter);
+            paint_internal(paint_context);
+        }
 
-        auto bitmap_or_error = try_get_scaled_destination_bitmap();
-        if (bitmap_or_error.is_error())
-            return;
-        auto bitmap = bitmap_or_error.release_value_but_fixme_should_propagate_errors();
-        Gfx::Painter painter(bitmap);
-        painter.translate(context.rounded_device_point(-paintable().absolute_paint_rect().location() + destination_clipped_fixup).to_type<int>());
-        auto paint_context = context.clone(painter);
-        paint_internal(paint_context);
-
-        if (destination_rect.size() == bitmap->size())
-            context.painter().blit(destination_rect.location(), *bitmap, bitmap->rect(), opacity);
-        else
-            context.painter().draw_scaled_bitmap(destination_rect, *bitmap, bitmap->rect(), opacity, Gfx::Painter::ScalingMode::BilinearBlend);
+        context.painter().paint_with(destination_rect, [=, layer_display_list = move(layer_display_list)](Gfx::Painter& painter) {
+            auto destination_rect = transformed_destination_rect.to_rounded<int>();
+            Gfx::FloatPoint destination_clipped_fixup {};
+            auto try_get_scaled_destination_bitmap = [&]() -> ErrorOr<NonnullRefPtr<Gfx::Bitmap>> {
+                Gfx::IntRect actual_destination_rect;
+                auto bitmap = TRY(painter.get_region_bitmap(destination_rect, Gfx::BitmapFormat::BGRA8888, actual_destination_rect));
+                // get_region_bitmap() may clip to a smaller region if the requested rect goes outside the painter, so we need to account for that.
+                destination_clipped_fixup = (destination_rect.location() - actual_destination_rect.location()).to_type<float>();
+                destination_rect = actual_destination_rect;
+                if (source_rect.size() != transformed_destination_rect.size()) {
+                    auto sx = static_cast<float>(source_rect.width()) / transformed_destination_rect.width();
+                    auto sy = static_cast<float>(source_rect.height()) / transformed_destination_rect.height();
+                    bitmap = TRY(bitmap->scaled(sx, sy));
+                    destination_clipped_fixup.scale_by(sx, sy);
+                }
+                return bitmap;
+            };
+
+            auto bitmap_or_error = try_get_scaled_destination_bitmap();
+            if (bitmap_or_error.is_error())
+                return;
+            auto bitmap = bitmap_or_error.release_value_but_fixme_should_propagate_errors();
+            Gfx::Painter bitmap_painter(bitmap);
+            bitmap_painter.translate(destination_clipped_fixup.to_rounded<int>());
+            layer_display_list.execute(bitmap_painter);
+
+            if (destination_rect.size() == bitmap->size())
+                painter.blit(destination_rect.location(), *bitmap, bitmap->rect(), opacity);
+            else
+                painter.draw_scaled_bitmap(destination_rect, *bitmap, bitmap->rect(), opacity, Gfx::Painter::ScalingMode::BilinearBlend);
+        });
     } else {
-        Gfx::PainterStateSaver saver(context.painter());
+        RecordingPainterStateSaver saver(context.painter());
         context.painter().translate(affine_transform.translation().to_rounded<int>());
         paint_internal(context);
     }
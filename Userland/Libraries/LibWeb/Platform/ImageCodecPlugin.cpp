@@ -5,6 +5,8 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <LibGfx/Bitmap.h>
+#include <LibWeb/Platform/EventLoopPlugin.h>
 #include <LibWeb/Platform/ImageCodecPlugin.h>
 
 namespace Web::Platform {
@@ -25,4 +27,11 @@ void ImageCodecPlugin::install(ImageCodecPlugin& plugin)
     s_the = &plugin;
 }
 
+void ImageCodecPlugin::decode_image_async(ReadonlyBytes data, Function<void(Optional<DecodedImage>)> on_complete)
+{
+    EventLoopPlugin::the().deferred_invoke([image = decode_image(data), on_complete = move(on_complete)]() mutable {
+        on_complete(move(image));
+    });
+}
+
 }
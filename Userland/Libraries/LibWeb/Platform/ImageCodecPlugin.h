@@ -7,6 +7,7 @@
 
 #pragma once
 
+#include <AK/Function.h>
 #include <AK/RefPtr.h>
 #include <AK/Vector.h>
 #include <LibGfx/Forward.h>
@@ -32,6 +33,11 @@ public:
     virtual ~ImageCodecPlugin();
 
     virtual Optional<DecodedImage> decode_image(ReadonlyBytes) = 0;
+
+    // Decodes an image without waiting for the result, which is passed to `on_complete` from the event loop later on.
+    // The data doesn't have to stay alive after this returns. By default, this decodes right away and only defers
+    // the callback, for plugins that can't decode in the background.
+    virtual void decode_image_async(ReadonlyBytes, Function<void(Optional<DecodedImage>)> on_complete);
 };
 
 }
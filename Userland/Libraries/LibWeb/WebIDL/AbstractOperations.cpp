@@ -12,6 +12,7 @@
 #include <LibJS/Runtime/DataView.h>
 #include <LibJS/Runtime/PropertyKey.h>
 #include <LibJS/Runtime/TypedArray.h>
+#include <LibWeb/Page/PhaseTimings.h>
 #include <LibWeb/WebIDL/AbstractOperations.h>
 #include <LibWeb/WebIDL/Promise.h>
 
@@ -113,6 +114,8 @@ inline JS::Completion clean_up_on_return(HTML::EnvironmentSettingsObject& stored
 
 JS::Completion call_user_object_operation(WebIDL::CallbackType& callback, DeprecatedString const& operation_name, Optional<JS::Value> this_argument, JS::MarkedVector<JS::Value> args)
 {
+    PhaseTimer timer(Phase::JavaScript);
+
     // 1. Let completion be an uninitialized variable.
     JS::Completion completion;
 
@@ -190,6 +193,8 @@ JS::Completion call_user_object_operation(WebIDL::CallbackType& callback, Deprec
 // https://webidl.spec.whatwg.org/#invoke-a-callback-function
 JS::Completion invoke_callback(WebIDL::CallbackType& callback, Optional<JS::Value> this_argument, JS::MarkedVector<JS::Value> args)
 {
+    PhaseTimer timer(Phase::JavaScript);
+
     // 1. Let completion be an uninitialized variable.
     JS::Completion completion;
 
@@ -5,10 +5,15 @@
  */
 
 #include <AK/Debug.h>
+#include <AK/Queue.h>
 #include <ImageDecoder/ConnectionFromClient.h>
 #include <ImageDecoder/ImageDecoderClientEndpoint.h>
 #include <LibGfx/Bitmap.h>
 #include <LibGfx/ImageFormats/ImageDecoder.h>
+#include <LibGfx/HelperThreads.h>
+#include <LibThreading/ConditionVariable.h>
+#include <LibThreading/Mutex.h>
+#include <LibThreading/Thread.h>
 
 namespace ImageDecoder {
 
@@ -72,4 +77,96 @@ Messages::ImageDecoderServer::DecodeImageResponse ConnectionFromClient::decode_i
     return { is_animated, loop_count, bitmaps, durations };
 }
 
+// Images that were asked for with start_decoding_image() are decoded on a few threads of their own, so that a big image
+// doesn't hold up the ones after it. Big images still use the helper threads as well, if nothing else is using them.
+static constexpr size_t max_decode_thread_count = 4;
+
+// A job is created and destroyed on the main thread, which is the only one that talks to the client. A decode thread
+// only fills in the results in between.
+struct DecodeJob {
+    NonnullRefPtr<ConnectionFromClient> client;
+    i32 request_id { 0 };
+    Core::AnonymousBuffer encoded_buffer;
+    Optional<DeprecatedString> mime_type;
+    Core::EventLoop& event_loop;
+
+    bool is_animated { false };
+    u32 loop_count { 0 };
+    Vector<Gfx::ShareableBitmap> bitmaps {};
+    Vector<u32> durations {};
+};
+
+struct DecodeQueue {
+    Threading::Mutex mutex;
+    Threading::ConditionVariable job_available { mutex };
+    Queue<DecodeJob*> jobs;
+    Vector<NonnullRefPtr<Threading::Thread>> threads;
+};
+
+// Lives until the process exits, just like the threads waiting on it.
+static DecodeQueue* s_decode_queue;
+
+static intptr_t decode_thread_main()
+{
+    for (;;) {
+        DecodeJob* job = nullptr;
+        {
+            Threading::MutexLocker locker(s_decode_queue->mutex);
+            s_decode_queue->job_available.wait_while([] { return s_decode_queue->jobs.is_empty(); });
+            job = s_decode_queue->jobs.dequeue();
+        }
+
+        decode_image_to_details(job->encoded_buffer, job->mime_type, job->is_animated, job->loop_count, job->bitmaps, job->durations);
+
+        // NOTE: The job may be gone as soon as it's been handed back.
+        auto& event_loop = job->event_loop;
+        event_loop.deferred_invoke([job] {
+            if (job->bitmaps.is_empty())
+                job->client->async_did_fail_to_decode_image(job->request_id);
+            else
+                job->client->async_did_decode_image(job->request_id, job->is_animated, job->loop_count, move(job->bitmaps), move(job->durations));
+            delete job;
+        });
+        event_loop.wake();
+    }
+}
+
+static ErrorOr<void> enqueue_decode_job(NonnullOwnPtr<DecodeJob> job)
+{
+    if (!s_decode_queue) {
+        auto queue = TRY(adopt_nonnull_own_or_enomem(new (nothrow) DecodeQueue));
+        auto thread_count = min(Gfx::helper_thread_count_for_online_processors() + 1, max_decode_thread_count);
+        for (size_t i = 0; i < thread_count; ++i)
+            TRY(queue->threads.try_append(TRY(Threading::Thread::try_create(decode_thread_main, "ImageDecoder"sv))));
+        s_decode_queue = queue.leak_ptr();
+        for (auto& thread : s_decode_queue->threads)
+            thread->start();
+    }
+
+    Threading::MutexLocker locker(s_decode_queue->mutex);
+    s_decode_queue->jobs.enqueue(job.leak_ptr());
+    s_decode_queue->job_available.signal();
+    return {};
+}
+
+void ConnectionFromClient::start_decoding_image(i32 request_id, Core::AnonymousBuffer const& encoded_buffer, Optional<DeprecatedString> const& mime_type)
+{
+    if (!encoded_buffer.is_valid()) {
+        dbgln_if(IMAGE_DECODER_DEBUG, "Encoded data is invalid");
+        async_did_fail_to_decode_image(request_id);
+        return;
+    }
+
+    // NOTE: Reference counts aren't atomic, so the job gets a MIME type string that nothing else shares.
+    Optional<DeprecatedString> job_mime_type;
+    if (mime_type.has_value() && !mime_type->is_empty())
+        job_mime_type = DeprecatedString(mime_type->view());
+
+    auto job_or_error = adopt_nonnull_own_or_enomem(new (nothrow) DecodeJob { *this, request_id, encoded_buffer, move(job_mime_type), Core::EventLoop::current() });
+    if (job_or_error.is_error() || enqueue_decode_job(job_or_error.release_value()).is_error()) {
+        dbgln("Could not start decoding image");
+        async_did_fail_to_decode_image(request_id);
+    }
+}
+
 }
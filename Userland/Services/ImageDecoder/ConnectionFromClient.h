@@ -27,6 +27,7 @@ private:
     explicit ConnectionFromClient(NonnullOwnPtr<Core::LocalSocket>);
 
     virtual Messages::ImageDecoderServer::DecodeImageResponse decode_image(Core::AnonymousBuffer const&, Optional<DeprecatedString> const& mime_type) override;
+    virtual void start_decoding_image(i32 request_id, Core::AnonymousBuffer const&, Optional<DeprecatedString> const& mime_type) override;
 };
 
 }
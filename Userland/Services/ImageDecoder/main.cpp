@@ -7,17 +7,21 @@
 #include <ImageDecoder/ConnectionFromClient.h>
 #include <LibCore/EventLoop.h>
 #include <LibCore/System.h>
+#include <LibGfx/HelperThreads.h>
 #include <LibIPC/SingleServer.h>
 #include <LibMain/Main.h>
 
 ErrorOr<int> serenity_main(Main::Arguments)
 {
     Core::EventLoop event_loop;
-    TRY(Core::System::pledge("stdio recvfd sendfd unix"));
+    TRY(Core::System::pledge("stdio recvfd sendfd unix thread"));
     TRY(Core::System::unveil(nullptr, nullptr));
 
+    // Big images are decoded by several threads, while the thread that asked for them keeps working too.
+    Gfx::set_maximum_helper_thread_count(Gfx::helper_thread_count_for_online_processors());
+
     auto client = TRY(IPC::take_over_accepted_client_from_system_server<ImageDecoder::ConnectionFromClient>());
 
-    TRY(Core::System::pledge("stdio recvfd sendfd"));
+    TRY(Core::System::pledge("stdio recvfd sendfd thread"));
     return event_loop.exec();
 }
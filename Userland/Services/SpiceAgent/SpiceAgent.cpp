@@ -78,7 +78,8 @@ void SpiceAgent::on_message_received()
         ReadonlyBytes bytes;
         if (mime == "image/x-serenityos") {
             auto bitmap = m_clipboard_connection.get_bitmap();
-            backing_byte_buffer = MUST(Gfx::PNGWriter::encode(*bitmap));
+            // The other side of the clipboard is waiting for the image.
+            backing_byte_buffer = MUST(Gfx::PNGWriter::encode(*bitmap, Gfx::PNGWriterOptions::fast()));
             bytes = backing_byte_buffer;
         } else {
             auto data = clipboard.data();
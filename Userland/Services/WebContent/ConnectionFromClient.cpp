@@ -28,6 +28,7 @@
 #include <LibWeb/Loader/ContentFilter.h>
 #include <LibWeb/Loader/ProxyMappings.h>
 #include <LibWeb/Loader/ResourceLoader.h>
+#include <LibWeb/Page/PhaseTimings.h>
 #include <LibWeb/Painting/PaintableBox.h>
 #include <LibWeb/Painting/StackingContext.h>
 #include <LibWeb/PermissionsPolicy/AutoplayAllowlist.h>
@@ -634,6 +635,47 @@ Messages::WebContentServer::DumpLayoutTreeResponse ConnectionFromClient::dump_la
     return builder.to_deprecated_string();
 }
 
+void ConnectionFromClient::set_phase_timings_enabled(bool enabled)
+{
+    Web::PhaseTimings::set_enabled(enabled);
+    Web::PhaseTimings::reset();
+    m_heap_statistics_at_phase_timings_reset = Web::Bindings::main_thread_vm().heap().statistics();
+}
+
+// Returns the time spent in each phase since phase timings were enabled or last taken, and starts over.
+Messages::WebContentServer::TakePhaseTimingsResponse ConnectionFromClient::take_phase_timings()
+{
+    auto to_milliseconds = [](Time time) {
+        return static_cast<double>(time.to_microseconds()) / 1000.0;
+    };
+
+    JsonObject phases;
+    for (size_t i = 0; i < to_underlying(Web::Phase::__Count); ++i) {
+        auto phase = static_cast<Web::Phase>(i);
+        auto const& totals = Web::PhaseTimings::totals(phase);
+        JsonObject phase_object;
+        phase_object.set("ms", to_milliseconds(totals.time));
+        phase_object.set("count", totals.count);
+        phases.set(Web::phase_name(phase), move(phase_object));
+    }
+
+    auto const& heap_statistics = Web::Bindings::main_thread_vm().heap().statistics();
+    auto const& baseline = m_heap_statistics_at_phase_timings_reset;
+    JsonObject gc;
+    gc.set("ms", to_milliseconds(heap_statistics.time_spent_collecting - baseline.time_spent_collecting));
+    gc.set("count", heap_statistics.collections - baseline.collections);
+    phases.set("gc", move(gc));
+
+    JsonObject timings;
+    timings.set("phases", move(phases));
+    timings.set("allocated_cells", heap_statistics.allocated_cells - baseline.allocated_cells);
+
+    Web::PhaseTimings::reset();
+    m_heap_statistics_at_phase_timings_reset = heap_statistics;
+
+    return timings.to_deprecated_string();
+}
+
 void ConnectionFromClient::set_content_filters(Vector<DeprecatedString> const& filters)
 {
     for (auto& filter : filters)
@@ -13,6 +13,7 @@
 #include <LibIPC/ConnectionFromClient.h>
 #include <LibJS/Forward.h>
 #include <LibJS/Heap/Handle.h>
+#include <LibJS/Heap/Heap.h>
 #include <LibWeb/CSS/PreferredColorScheme.h>
 #include <LibWeb/Forward.h>
 #include <LibWeb/Loader/FileRequest.h>
@@ -74,6 +75,8 @@ private:
     virtual void inspect_accessibility_tree() override;
     virtual Messages::WebContentServer::GetHoveredNodeIdResponse get_hovered_node_id() override;
     virtual Messages::WebContentServer::DumpLayoutTreeResponse dump_layout_tree() override;
+    virtual void set_phase_timings_enabled(bool) override;
+    virtual Messages::WebContentServer::TakePhaseTimingsResponse take_phase_timings() override;
     virtual void set_content_filters(Vector<DeprecatedString> const&) override;
     virtual void set_autoplay_allowed_on_all_websites() override;
     virtual void set_autoplay_allowlist(Vector<String> const& allowlist) override;
@@ -123,6 +126,8 @@ private:
     JS::Handle<JS::GlobalObject> m_console_global_object;
 
     HashMap<int, Web::FileRequest> m_requested_files {};
+
+    JS::Heap::Statistics m_heap_statistics_at_phase_timings_reset;
     int last_id { 0 };
 
     struct QueuedMouseEvent {
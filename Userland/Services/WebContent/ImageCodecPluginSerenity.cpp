@@ -13,7 +13,7 @@ namespace WebContent {
 ImageCodecPluginSerenity::ImageCodecPluginSerenity() = default;
 ImageCodecPluginSerenity::~ImageCodecPluginSerenity() = default;
 
-Optional<Web::Platform::DecodedImage> ImageCodecPluginSerenity::decode_image(ReadonlyBytes bytes)
+ImageDecoderClient::Client& ImageCodecPluginSerenity::client()
 {
     if (!m_client) {
         m_client = ImageDecoderClient::Client::try_create().release_value_but_fixme_should_propagate_errors();
@@ -21,20 +21,37 @@ Optional<Web::Platform::DecodedImage> ImageCodecPluginSerenity::decode_image(Rea
             m_client = nullptr;
         };
     }
+    return *m_client;
+}
 
-    auto result_or_empty = m_client->decode_image(bytes);
+static Optional<Web::Platform::DecodedImage> to_web_decoded_image(Optional<ImageDecoderClient::DecodedImage> const& result_or_empty)
+{
     if (!result_or_empty.has_value())
         return {};
-    auto result = result_or_empty.release_value();
+    auto const& result = result_or_empty.value();
 
     Web::Platform::DecodedImage decoded_image;
     decoded_image.is_animated = result.is_animated;
     decoded_image.loop_count = result.loop_count;
     for (auto const& frame : result.frames) {
-        decoded_image.frames.empend(move(frame.bitmap), frame.duration);
+        decoded_image.frames.empend(frame.bitmap, frame.duration);
     }
 
     return decoded_image;
 }
 
+Optional<Web::Platform::DecodedImage> ImageCodecPluginSerenity::decode_image(ReadonlyBytes bytes)
+{
+    return to_web_decoded_image(client().decode_image(bytes));
+}
+
+void ImageCodecPluginSerenity::decode_image_async(ReadonlyBytes bytes, Function<void(Optional<Web::Platform::DecodedImage>)> on_complete)
+{
+    auto promise = client().decode_image_async(bytes);
+    promise->on_resolved = [on_complete = move(on_complete)](Optional<ImageDecoderClient::DecodedImage>& result) -> ErrorOr<void> {
+        on_complete(to_web_decoded_image(result));
+        return {};
+    };
+}
+
 }
@@ -7,12 +7,14 @@
 
 #include "PageHost.h"
 #include "ConnectionFromClient.h"
+#include <LibGfx/HelperThreads.h>
 #include <LibGfx/Painter.h>
 #include <LibGfx/ShareableBitmap.h>
 #include <LibGfx/SystemTheme.h>
 #include <LibWeb/Cookie/ParsedCookie.h>
 #include <LibWeb/HTML/BrowsingContext.h>
 #include <LibWeb/Layout/Viewport.h>
+#include <LibWeb/Page/PhaseTimings.h>
 #include <LibWeb/Painting/PaintableBox.h>
 #include <LibWeb/Platform/Timer.h>
 #include <WebContent/WebContentClientEndpoint.h>
@@ -108,8 +110,20 @@ Web::Layout::Viewport* PageHost::layout_root()
     return document->layout_node();
 }
 
+// The smallest rect made of whole tiles that covers `rect`.
+static Gfx::IntRect tile_aligned_rect(Gfx::IntRect const& rect, int tile_size)
+{
+    auto round_down = [&](int value) { return value >= 0 ? value / tile_size * tile_size : -((-value + tile_size - 1) / tile_size) * tile_size; };
+    auto left = round_down(rect.x());
+    auto top = round_down(rect.y());
+    auto right = round_down(rect.x() + rect.width() + tile_size - 1);
+    auto bottom = round_down(rect.y() + rect.height() + tile_size - 1);
+    return { left, top, right - left, bottom - top };
+}
+
 void PageHost::paint(Web::DevicePixelRect const& content_rect, Gfx::Bitmap& target)
 {
+    Web::PhaseTimer timer(Web::Phase::Paint);
     Gfx::Painter painter(target);
     Gfx::IntRect bitmap_rect { {}, content_rect.size().to_type<int>() };
 
@@ -122,11 +136,94 @@ void PageHost::paint(Web::DevicePixelRect const& content_rect, Gfx::Bitmap& targ
         return;
     }
 
-    Web::PaintContext context(painter, palette(), device_pixels_per_css_pixel());
+    // The display list is recorded in document coordinates, so it can be compared against the previous one even if
+    // the page has been scrolled since.
+    auto visible_rect = content_rect.to_type<int>();
+    auto recorded_rect = tile_aligned_rect(visible_rect, tile_size);
+
+    Web::Painting::DisplayList display_list;
+    Web::Painting::RecordingPainter recording_painter(display_list, recorded_rect);
+    recording_painter.translate(visible_rect.location());
+
+    Web::PaintContext context(recording_painter, palette(), device_pixels_per_css_pixel());
     context.set_should_show_line_box_borders(m_should_show_line_box_borders);
     context.set_device_viewport_rect(content_rect);
     context.set_has_focus(m_has_focus);
     layout_root->paint_all_phases(context);
+
+    // Changes outside of the recorded area aren't tracked, so tiles out there can't be trusted next time.
+    m_tiles.remove_all_matching([&](auto index, auto&) { return !tile_rect(index).intersects(recorded_rect); });
+    mark_tiles_dirty(display_list.compute_damage(m_previous_display_list, recorded_rect.united(m_previous_recorded_rect)));
+
+    if (auto result = paint_tiles(display_list, visible_rect, target); result.is_error()) {
+        dbgln("Failed to paint page tiles: {}", result.error());
+        m_tiles.clear();
+        painter.translate(-visible_rect.location());
+        display_list.execute(painter);
+    }
+
+    m_previous_display_list = move(display_list);
+    m_previous_recorded_rect = recorded_rect;
+}
+
+void PageHost::mark_tiles_dirty(Gfx::IntRect const& rect)
+{
+    if (rect.is_empty())
+        return;
+    for (auto& it : m_tiles) {
+        auto dirty_rect = tile_rect(it.key).intersected(rect);
+        if (!dirty_rect.is_empty())
+            it.value.dirty_rect = it.value.dirty_rect.united(dirty_rect);
+    }
+}
+
+ErrorOr<void> PageHost::paint_tiles(Web::Painting::DisplayList const& display_list, Gfx::IntRect const& content_rect, Gfx::Bitmap& target)
+{
+    if (!m_rasterization_pool) {
+        // The thread that asked for the paint works on tiles too.
+        m_rasterization_pool = TRY(Threading::ThreadPool::try_create(Gfx::helper_thread_count_for_online_processors(), "Rasterizer"sv));
+    }
+
+    auto visible_tiles = tile_aligned_rect(content_rect, tile_size);
+    Vector<Gfx::IntPoint> indices;
+    for (int y = visible_tiles.y(); y < visible_tiles.y() + visible_tiles.height(); y += tile_size) {
+        for (int x = visible_tiles.x(); x < visible_tiles.x() + visible_tiles.width(); x += tile_size)
+            TRY(indices.try_append({ x / tile_size, y / tile_size }));
+    }
+
+    for (auto index : indices) {
+        if (m_tiles.contains(index))
+            continue;
+        auto bitmap = TRY(Gfx::Bitmap::create(Gfx::BitmapFormat::BGRx8888, { tile_size, tile_size }));
+        TRY(m_tiles.try_set(index, { move(bitmap), tile_rect(index) }));
+    }
+
+    // The map isn't changed from here on, so pointers into it stay valid while the tiles are painted.
+    struct DirtyTile {
+        Tile* tile;
+        Gfx::IntRect rect;
+    };
+    Vector<DirtyTile> dirty_tiles;
+    for (auto index : indices) {
+        auto& tile = m_tiles.find(index)->value;
+        if (!tile.dirty_rect.is_empty())
+            TRY(dirty_tiles.try_append({ &tile, tile_rect(index) }));
+    }
+
+    m_rasterization_pool->for_each(dirty_tiles.size(), [&](size_t i) {
+        auto& [tile, rect] = dirty_tiles[i];
+        Gfx::Painter painter(*tile->bitmap);
+        painter.translate(-rect.location());
+        display_list.execute(painter, tile->dirty_rect, &m_paint_shared_state_lock);
+        tile->dirty_rect = {};
+    });
+
+    Gfx::Painter painter(target);
+    for (auto index : indices) {
+        auto& tile = m_tiles.find(index)->value;
+        painter.blit(tile_rect(index).location() - content_rect.location(), *tile.bitmap, tile.bitmap->rect());
+    }
+    return {};
 }
 
 void PageHost::set_viewport_rect(Web::DevicePixelRect const& rect)
@@ -136,7 +233,9 @@ void PageHost::set_viewport_rect(Web::DevicePixelRect const& rect)
 
 void PageHost::page_did_invalidate(Web::CSSPixelRect const& content_rect)
 {
-    m_invalidation_rect = m_invalidation_rect.united(page().enclosing_device_rect(content_rect));
+    auto device_rect = page().enclosing_device_rect(content_rect);
+    m_invalidation_rect = m_invalidation_rect.united(device_rect);
+    mark_tiles_dirty(device_rect.to_type<int>());
     if (!m_invalidation_coalescing_timer->is_active())
         m_invalidation_coalescing_timer->start();
 }
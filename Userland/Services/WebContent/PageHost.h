@@ -7,8 +7,12 @@
 
 #pragma once
 
+#include <AK/HashMap.h>
 #include <LibGfx/Rect.h>
+#include <LibThreading/Mutex.h>
+#include <LibThreading/ThreadPool.h>
 #include <LibWeb/Page/Page.h>
+#include <LibWeb/Painting/RecordingPainter.h>
 #include <LibWeb/PixelUnits.h>
 #include <WebContent/Forward.h>
 
@@ -119,6 +123,26 @@ private:
 
     RefPtr<Web::Platform::Timer> m_invalidation_coalescing_timer;
     Web::DevicePixelRect m_invalidation_rect;
+
+    // The page is painted into tiles that are cached across frames, so that scrolling only has to paint the tiles
+    // that scroll into view, and a change only has to repaint the tiles it touches.
+    static constexpr int tile_size = 256;
+    struct Tile {
+        NonnullRefPtr<Gfx::Bitmap> bitmap;
+        Gfx::IntRect dirty_rect;
+    };
+    static Gfx::IntRect tile_rect(Gfx::IntPoint index) { return { index.x() * tile_size, index.y() * tile_size, tile_size, tile_size }; }
+    void mark_tiles_dirty(Gfx::IntRect const&);
+    ErrorOr<void> paint_tiles(Web::Painting::DisplayList const&, Gfx::IntRect const& content_rect, Gfx::Bitmap& target);
+
+    HashMap<Gfx::IntPoint, Tile> m_tiles;
+    Web::Painting::DisplayList m_previous_display_list;
+    Gfx::IntRect m_previous_recorded_rect;
+
+    OwnPtr<Threading::ThreadPool> m_rasterization_pool;
+    // Held while the tiles run paint functions and paint text, since those share caches that aren't thread-safe.
+    Threading::Mutex m_paint_shared_state_lock;
+
     Web::CSS::PreferredColorScheme m_preferred_color_scheme { Web::CSS::PreferredColorScheme::Auto };
 
     RefPtr<WebDriverConnection> m_webdriver;
@@ -47,12 +47,12 @@ static WallpaperMode mode_to_enum(DeprecatedString const& name)
 Compositor::Compositor()
 {
     m_display_link_notify_timer = add<Core::Timer>(
-        1000 / 60, [this] {
+        frame_interval_ms, [this] {
             notify_display_links();
         });
 
     m_compose_timer = Core::Timer::create_single_shot(
-        1000 / 60,
+        frame_interval_ms,
         [this] {
             compose();
         },
@@ -182,6 +182,8 @@ void Compositor::compose()
         return;
     }
 
+    m_last_compose_timer.start();
+
     if (m_occlusions_dirty) {
         m_occlusions_dirty = false;
         recompute_occlusions();
@@ -447,7 +449,9 @@ void Compositor::compose()
                 auto dst = backing_rect.location().translated(dirty_rect_in_backing_coordinates.location());
 
                 if (window.client() && window.client()->is_unresponsive()) {
-                    if (window.is_opaque()) {
+                    if (auto* unresponsive_layer = window.unresponsive_layer()) {
+                        painter.blit(dst, *unresponsive_layer, dirty_rect_in_backing_coordinates);
+                    } else if (window.is_opaque()) {
                         painter.blit_filtered(dst, *backing_store, dirty_rect_in_backing_coordinates, [](Color src) {
                             return src.to_grayscale().darkened(0.75f);
                         });
@@ -617,6 +621,12 @@ void Compositor::compose()
         flush(screen);
         return IterationDecision::Continue;
     });
+
+    auto compose_time = m_last_compose_timer.elapsed_time();
+    ++m_statistics.compose_count;
+    m_statistics.compose_time += compose_time;
+    if (compose_time > m_statistics.longest_compose_time)
+        m_statistics.longest_compose_time = compose_time;
 }
 
 void Compositor::flush(Screen& screen)
@@ -716,6 +726,7 @@ void Compositor::flush(Screen& screen)
             from_ptr = (const Gfx::ARGB32*)((const u8*)from_ptr + pitch);
             to_ptr = (Gfx::ARGB32*)((u8*)to_ptr + pitch);
         }
+        m_statistics.pixels_flushed += scaled_rect.size().area();
         if (device_can_flush_buffers) {
             // Whether or not we need to flush buffers, we need to at least track what we modified
             // so that we can flush these areas next time before we flip buffers. Or, if we don't
@@ -779,13 +790,43 @@ void Compositor::invalidate_window()
 
 void Compositor::start_compose_async_timer()
 {
-    // We delay composition by a timer interval, but to not affect latency too
-    // much, if a pending compose is not already scheduled, we also schedule an
-    // immediate compose the next spin of the event loop.
-    if (!m_compose_timer->is_active()) {
-        m_compose_timer->start();
+    // Anything invalidated while a compose is already scheduled gets coalesced
+    // into that compose. We compose at most once per frame interval: to not affect
+    // latency too much, if a full interval has already passed since the last
+    // compose we compose on the next spin of the event loop, otherwise we wait
+    // until the next frame is due.
+    if (m_compose_timer->is_active() || m_immediate_compose_timer->is_active())
+        return;
+
+    i64 elapsed_ms = m_last_compose_timer.is_valid() ? m_last_compose_timer.elapsed() : frame_interval_ms;
+    if (elapsed_ms >= frame_interval_ms)
         m_immediate_compose_timer->start();
+    else
+        m_compose_timer->start(frame_interval_ms - elapsed_ms);
+}
+
+void Compositor::set_show_statistics(bool show)
+{
+    if (show == (m_statistics_overlay != nullptr))
+        return;
+
+    if (!show) {
+        m_statistics_timer->stop();
+        m_statistics_overlay = nullptr;
+        return;
     }
+
+    m_statistics = {};
+    m_statistics_overlay = create_overlay<CompositorStatsOverlay>();
+    m_statistics_overlay->set_enabled(true);
+    if (!m_statistics_timer) {
+        m_statistics_timer = add<Core::Timer>(1000, [this] {
+            if (m_statistics_overlay)
+                m_statistics_overlay->update_statistics(m_statistics);
+            m_statistics = {};
+        });
+    }
+    m_statistics_timer->start();
 }
 
 bool Compositor::set_background_color(DeprecatedString const& background_color)
@@ -1649,6 +1690,7 @@ void Compositor::finish_window_stack_switch()
     VERIFY(m_current_window_stack);
     VERIFY(m_transitioning_to_window_stack != m_current_window_stack);
 
+    invalidate_window_stack_transition_rects();
     m_current_window_stack->set_transition_offset({}, {});
     m_transitioning_to_window_stack->set_transition_offset({}, {});
 
@@ -1664,14 +1706,25 @@ void Compositor::finish_window_stack_switch()
     wm.did_switch_window_stack({}, *previous_window_stack, *m_current_window_stack);
 
     invalidate_occlusions();
-
-    // Rather than invalidating the entire we could invalidate all render rectangles
-    // that are affected by the transition offset before and after changing it.
-    invalidate_screen();
+    invalidate_window_stack_transition_rects();
 
     start_window_stack_switch_overlay_timer();
 }
 
+void Compositor::invalidate_window_stack_transition_rects()
+{
+    // Only the windows that are part of a window stack move during a transition,
+    // the wallpaper and stationary windows stay where they are. Calling this both
+    // before and after changing the transition offsets damages exactly the areas
+    // windows are moving away from and the areas they are moving to.
+    WindowManager::the().for_each_visible_window_from_back_to_front([&](Window& window) {
+        if (WindowManager::is_stationary_window_type(window.type()) || window.is_moving_to_another_stack())
+            return IterationDecision::Continue;
+        invalidate_screen(window.frame().render_rect().translated(window_transition_offset(window)));
+        return IterationDecision::Continue;
+    });
+}
+
 void Compositor::set_current_window_stack_no_transition(WindowStack& new_window_stack)
 {
     if (m_transitioning_to_window_stack) {
@@ -1762,6 +1815,7 @@ void Compositor::switch_to_window_stack(WindowStack& new_window_stack, bool show
             translated_dirty_rects.translate_by(transition_delta);
             m_dirty_screen_rects.add(translated_dirty_rects.intersected(Screen::bounding_rect()));
         }
+        invalidate_window_stack_transition_rects();
         m_current_window_stack->set_transition_offset({}, transition_offset_from);
 
         // Set transition offset for the window stack we're transitioning to
@@ -1769,10 +1823,7 @@ void Compositor::switch_to_window_stack(WindowStack& new_window_stack, bool show
         m_transitioning_to_window_stack->set_transition_offset({}, transition_offset_to);
 
         invalidate_occlusions();
-
-        // Rather than invalidating the entire we could invalidate all render rectangles
-        // that are affected by the transition offset before and after changing it.
-        invalidate_screen();
+        invalidate_window_stack_transition_rects();
     };
 
     m_window_stack_transition_animation->on_stop = [this] {
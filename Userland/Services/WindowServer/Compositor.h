@@ -8,6 +8,8 @@
 
 #include <AK/OwnPtr.h>
 #include <AK/RefPtr.h>
+#include <AK/Time.h>
+#include <LibCore/ElapsedTimer.h>
 #include <LibCore/Object.h>
 #include <LibGfx/Color.h>
 #include <LibGfx/DisjointRectSet.h>
@@ -32,6 +34,15 @@ enum class WallpaperMode {
     Unchecked
 };
 
+struct CompositorStatistics {
+    size_t compose_count { 0 };
+    Time compose_time;
+    Time longest_compose_time;
+    u64 pixels_flushed { 0 };
+    u32 client_frames_presented { 0 };
+    u32 client_frames_dropped { 0 };
+};
+
 struct CompositorScreenData {
     RefPtr<Gfx::Bitmap> m_front_bitmap;
     RefPtr<Gfx::Bitmap> m_back_bitmap;
@@ -184,6 +195,14 @@ public:
 
     void set_flash_flush(bool b) { m_flash_flush = b; }
 
+    void set_show_statistics(bool);
+    CompositorStatistics const& statistics() const { return m_statistics; }
+    void did_present_client_frame(Badge<Window>, u32 frames_dropped)
+    {
+        ++m_statistics.client_frames_presented;
+        m_statistics.client_frames_dropped += frames_dropped;
+    }
+
     static NonnullOwnPtr<CompositorScreenData> create_screen_data(Badge<Screen>)
     {
         return adopt_own(*new CompositorScreenData());
@@ -201,6 +220,7 @@ private:
     void update_fonts();
     void notify_display_links();
     void start_compose_async_timer();
+    void invalidate_window_stack_transition_rects();
     void recompute_overlay_rects();
     void recompute_occlusions();
     void change_cursor(Cursor const*);
@@ -214,8 +234,11 @@ private:
     void finish_window_stack_switch();
     void update_wallpaper_bitmap();
 
+    static constexpr int frame_interval_ms = 1000 / 60;
+
     RefPtr<Core::Timer> m_compose_timer;
     RefPtr<Core::Timer> m_immediate_compose_timer;
+    Core::ElapsedTimer m_last_compose_timer { true };
     bool m_flash_flush { false };
     bool m_occlusions_dirty { true };
     bool m_invalidated_any { true };
@@ -251,6 +274,10 @@ private:
     Optional<Gfx::Color> m_custom_background_color;
 
     HashTable<Animation*> m_animations;
+
+    CompositorStatistics m_statistics;
+    OwnPtr<CompositorStatsOverlay> m_statistics_overlay;
+    RefPtr<Core::Timer> m_statistics_timer;
 };
 
 }
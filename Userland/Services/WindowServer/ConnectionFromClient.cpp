@@ -748,6 +748,7 @@ void ConnectionFromClient::did_finish_painting(i32 window_id, Vector<Gfx::IntRec
         return;
     }
     auto& window = *(*it).value;
+    window.present_ready_frame();
     for (auto& rect : rects)
         window.invalidate(rect);
     if (window.has_alpha_channel() && window.alpha_hit_threshold() > 0.0f)
@@ -766,6 +767,7 @@ void ConnectionFromClient::set_window_backing_store(i32 window_id, [[maybe_unuse
         return;
     }
     auto& window = *(*it).value;
+    window.clear_frame_ring();
     if (window.last_backing_store() && window.last_backing_store_serial() == serial) {
         window.swap_backing_stores();
     } else {
@@ -792,6 +794,29 @@ void ConnectionFromClient::set_window_backing_store(i32 window_id, [[maybe_unuse
         window.invalidate(false);
 }
 
+void ConnectionFromClient::set_window_frame_ring(i32 window_id, Core::AnonymousBuffer const& state, Vector<Gfx::ShareableBitmap> const& bitmaps, Vector<i32> const& serials)
+{
+    auto it = m_windows.find(window_id);
+    if (it == m_windows.end()) {
+        did_misbehave("SetWindowFrameRing: Bad window ID");
+        return;
+    }
+    if (!state.is_valid() || state.size() < sizeof(FrameRingState) || bitmaps.size() != FrameRingState::buffer_count || serials.size() != bitmaps.size()) {
+        did_misbehave("SetWindowFrameRing: Bad frame ring");
+        return;
+    }
+    Vector<NonnullRefPtr<Gfx::Bitmap>, FrameRingState::buffer_count> ring_bitmaps;
+    for (auto shareable_bitmap : bitmaps) {
+        if (!shareable_bitmap.is_valid() || shareable_bitmap.bitmap()->size() != bitmaps.first().bitmap()->size()) {
+            did_misbehave("SetWindowFrameRing: Bad backing store");
+            return;
+        }
+        ring_bitmaps.append(*shareable_bitmap.bitmap());
+    }
+    auto& window = *(*it).value;
+    window.set_frame_ring(state, move(ring_bitmaps), serials);
+}
+
 void ConnectionFromClient::set_global_mouse_tracking(bool enabled)
 {
     m_does_global_mouse_tracking = enabled;
@@ -1155,6 +1180,7 @@ void ConnectionFromClient::set_unresponsive(bool unresponsive)
             window.set_cursor_override(WindowManager::the().wait_cursor());
         } else {
             window.remove_cursor_override();
+            window.discard_unresponsive_layer();
         }
     }
     Compositor::the().invalidate_cursor();
@@ -1336,6 +1362,11 @@ void ConnectionFromClient::set_flash_flush(bool enabled)
     Compositor::the().set_flash_flush(enabled);
 }
 
+void ConnectionFromClient::set_show_compositor_statistics(bool enabled)
+{
+    Compositor::the().set_show_statistics(enabled);
+}
+
 void ConnectionFromClient::set_window_parent_from_client(i32 client_id, i32 parent_id, i32 child_id)
 {
     auto* child_window = window_from_id(child_id);
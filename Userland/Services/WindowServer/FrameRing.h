@@ -0,0 +1,71 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Atomic.h>
+#include <AK/Time.h>
+#include <AK/Types.h>
+
+namespace WindowServer {
+
+// A double-buffered window shares a ring of three backing stores with WindowServer,
+// along with this state in a shared memory buffer.
+//
+// At any time the client owns one buffer (the one it paints into), WindowServer owns
+// one (the one it composes from), and the third one is the "pending" buffer. Both
+// sides only ever trade buffers by exchanging their own buffer with the pending one:
+// - When the client has painted a frame, it exchanges its buffer with the pending
+//   one, marking the pending buffer as ready. It can then continue painting into the
+//   buffer it got back right away, without waiting for WindowServer.
+// - When WindowServer learns that a frame has been painted, it exchanges its buffer
+//   with the pending one if it is ready, and presents it.
+// If the client publishes a frame before WindowServer picked up the previous one, the
+// previous one is dropped.
+struct FrameRingState {
+    static constexpr u32 buffer_count = 3;
+
+    static constexpr u32 buffer_index_mask = 0x3;
+    static constexpr u32 ready_flag = 0x4;
+    static constexpr u32 sequence_shift = 3;
+
+    static constexpr u32 initial_client_buffer_index = 0;
+    static constexpr u32 initial_pending_buffer_index = 1;
+    static constexpr u32 initial_server_buffer_index = 2;
+
+    static constexpr u32 encode_pending_buffer(u32 buffer_index, u32 sequence, bool ready)
+    {
+        return (sequence << sequence_shift) | (ready ? ready_flag : 0) | buffer_index;
+    }
+    static constexpr u32 buffer_index_of(u32 pending_buffer) { return pending_buffer & buffer_index_mask; }
+    static constexpr bool is_ready(u32 pending_buffer) { return pending_buffer & ready_flag; }
+    static constexpr u32 sequence_of(u32 pending_buffer) { return pending_buffer >> sequence_shift; }
+
+    // Written by the client before it publishes the buffer.
+    struct Frame {
+        i32 visible_width { 0 };
+        i32 visible_height { 0 };
+        i64 ready_time_us { 0 };
+    };
+    Frame frames[buffer_count];
+
+    Atomic<u32> pending_buffer { encode_pending_buffer(initial_pending_buffer_index, 0, false) };
+
+    // Written by WindowServer when it presents a frame.
+    Atomic<u32> frames_presented { 0 };
+    Atomic<u32> frames_dropped { 0 };
+    Atomic<u64> total_latency_us { 0 };
+    Atomic<u64> longest_latency_us { 0 };
+};
+
+struct FrameRingStatistics {
+    u32 frames_presented { 0 };
+    u32 frames_dropped { 0 };
+    Time average_latency;
+    Time longest_latency;
+};
+
+}
@@ -22,6 +22,12 @@ bool Overlay::invalidate()
 {
     if (m_invalidated)
         return false;
+    if (is_enabled() && m_rect == m_current_rect && !m_current_rect.is_empty()) {
+        // Only the contents changed, so the occlusions are still valid and it's
+        // enough to damage the area we're already rendering to.
+        Compositor::the().invalidate_screen(m_current_rect);
+        return true;
+    }
     m_invalidated = true;
     if (is_enabled())
         Compositor::the().overlay_rects_changed();
@@ -341,6 +347,47 @@ void WindowGeometryOverlay::render_overlay_bitmap(Gfx::Painter& painter)
     painter.draw_text(Gfx::IntRect { {}, rect().size() }, m_label, WindowManager::the().font(), Gfx::TextAlignment::Center, Color::White);
 }
 
+CompositorStatsOverlay::CompositorStatsOverlay()
+{
+    update_statistics({});
+}
+
+void CompositorStatsOverlay::update_statistics(CompositorStatistics const& statistics)
+{
+    double average_compose_ms = 0;
+    if (statistics.compose_count > 0)
+        average_compose_ms = statistics.compose_time.to_microseconds() / 1000.0 / statistics.compose_count;
+    double longest_compose_ms = statistics.longest_compose_time.to_microseconds() / 1000.0;
+
+    m_lines.clear_with_capacity();
+    m_lines.append(DeprecatedString::formatted("{} composes/s", statistics.compose_count));
+    m_lines.append(DeprecatedString::formatted("{:.2} ms avg, {:.2} ms max", average_compose_ms, longest_compose_ms));
+    m_lines.append(DeprecatedString::formatted("{} pixels flushed/s", statistics.pixels_flushed));
+    m_lines.append(DeprecatedString::formatted("{} client frames/s, {} dropped", statistics.client_frames_presented, statistics.client_frames_dropped));
+
+    auto& font = WindowManager::the().font();
+    float text_width = 0;
+    for (auto& line : m_lines)
+        text_width = max(text_width, font.width(line));
+    Gfx::IntSize content_size { static_cast<int>(ceilf(text_width)) + 16, font.pixel_size_rounded_up() * static_cast<int>(m_lines.size()) + 10 };
+
+    auto screen_rect = Screen::main().rect();
+    Gfx::IntRect content_rect { { screen_rect.right() - default_offset - content_size.width(), screen_rect.top() + default_offset }, content_size };
+    set_content_rect(content_rect);
+    invalidate_content();
+}
+
+void CompositorStatsOverlay::render_overlay_bitmap(Gfx::Painter& painter)
+{
+    auto& font = WindowManager::the().font();
+    int line_height = font.pixel_size_rounded_up();
+    Gfx::IntRect line_rect { 0, (rect().height() - line_height * static_cast<int>(m_lines.size())) / 2, rect().width(), line_height };
+    for (auto& line : m_lines) {
+        painter.draw_text(line_rect, line, font, Gfx::TextAlignment::Center, Color::White);
+        line_rect.translate_by(0, line_height);
+    }
+}
+
 DndOverlay::DndOverlay(DeprecatedString const& text, Gfx::Bitmap const* bitmap)
     : m_bitmap(bitmap)
     , m_text(text)
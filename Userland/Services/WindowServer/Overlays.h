@@ -18,6 +18,7 @@
 namespace WindowServer {
 
 class Animation;
+struct CompositorStatistics;
 class Screen;
 class TileWindowOverlay;
 class Window;
@@ -35,6 +36,7 @@ public:
         Dnd,
         WindowStackSwitch,
         ScreenNumber,
+        CompositorStats,
     };
     [[nodiscard]] virtual ZOrder zorder() const = 0;
     virtual void render(Gfx::Painter&, Screen const&) = 0;
@@ -221,6 +223,21 @@ private:
     int const m_target_column;
 };
 
+class CompositorStatsOverlay : public RectangularOverlay {
+public:
+    static constexpr int default_offset = 20;
+
+    CompositorStatsOverlay();
+
+    void update_statistics(CompositorStatistics const&);
+
+    virtual ZOrder zorder() const override { return ZOrder::CompositorStats; }
+    virtual void render_overlay_bitmap(Gfx::Painter&) override;
+
+private:
+    Vector<DeprecatedString, 4> m_lines;
+};
+
 class TileWindowOverlay : public Overlay {
 public:
     TileWindowOverlay(Window&, Gfx::IntRect const&, Gfx::Palette&&);
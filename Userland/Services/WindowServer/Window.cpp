@@ -400,6 +400,106 @@ void Window::set_has_alpha_channel(bool value)
     Compositor::the().invalidate_occlusions();
 }
 
+void Window::set_frame_ring(Core::AnonymousBuffer state_buffer, Vector<NonnullRefPtr<Gfx::Bitmap>, FrameRingState::buffer_count> bitmaps, Vector<i32> const& serials)
+{
+    VERIFY(bitmaps.size() == FrameRingState::buffer_count);
+    VERIFY(serials.size() == FrameRingState::buffer_count);
+    m_frame_ring_state_buffer = move(state_buffer);
+    m_frame_ring_bitmaps = move(bitmaps);
+    m_frame_ring_serials.clear_with_capacity();
+    m_frame_ring_serials.extend(serials);
+    m_frame_ring_index = FrameRingState::initial_server_buffer_index;
+    m_last_presented_frame_sequence = 0;
+}
+
+void Window::clear_frame_ring()
+{
+    m_frame_ring_state_buffer = {};
+    m_frame_ring_bitmaps.clear();
+    m_frame_ring_serials.clear();
+}
+
+bool Window::present_ready_frame()
+{
+    if (!m_frame_ring_state_buffer.is_valid())
+        return false;
+
+    auto& state = *reinterpret_cast<FrameRingState*>(m_frame_ring_state_buffer.data<void>());
+    if (!FrameRingState::is_ready(state.pending_buffer.load(AK::memory_order_acquire)))
+        return false;
+
+    // Only we ever take the ready flag away, so the pending buffer is still ready, although the
+    // client may have replaced it with an even newer frame in the meantime.
+    auto pending_buffer = state.pending_buffer.exchange(FrameRingState::encode_pending_buffer(m_frame_ring_index, 0, false), AK::memory_order_acq_rel);
+    auto ring_index = FrameRingState::buffer_index_of(pending_buffer);
+    if (!FrameRingState::is_ready(pending_buffer) || ring_index >= FrameRingState::buffer_count) {
+        dbgln("Window {}: Client corrupted its frame ring, no longer using it", m_window_id);
+        clear_frame_ring();
+        return false;
+    }
+    m_frame_ring_index = ring_index;
+
+    auto const& frame = state.frames[ring_index];
+    set_backing_store(m_frame_ring_bitmaps[ring_index], m_frame_ring_serials[ring_index]);
+    set_backing_store_visible_size({ max(frame.visible_width, 0), max(frame.visible_height, 0) });
+
+    auto sequence = FrameRingState::sequence_of(pending_buffer);
+    auto frames_since_last_presented = (sequence - m_last_presented_frame_sequence) & (NumericLimits<u32>::max() >> FrameRingState::sequence_shift);
+    auto frames_dropped = frames_since_last_presented > 0 ? frames_since_last_presented - 1 : 0;
+    m_last_presented_frame_sequence = sequence;
+
+    u64 latency_us = max<i64>(Time::now_monotonic().to_microseconds() - frame.ready_time_us, 0);
+    state.frames_presented.fetch_add(1, AK::memory_order_relaxed);
+    state.frames_dropped.fetch_add(frames_dropped, AK::memory_order_relaxed);
+    state.total_latency_us.fetch_add(latency_us, AK::memory_order_relaxed);
+    if (latency_us > state.longest_latency_us.load(AK::memory_order_relaxed))
+        state.longest_latency_us.store(latency_us, AK::memory_order_relaxed);
+
+    Compositor::the().did_present_client_frame({}, frames_dropped);
+    return true;
+}
+
+Gfx::Bitmap const* Window::unresponsive_layer()
+{
+    if (!m_backing_store)
+        return nullptr;
+
+    Optional<u8> alpha;
+    if (!is_opaque())
+        alpha = 255 * m_opacity;
+
+    if (m_unresponsive_layer && m_unresponsive_layer_source == m_backing_store.ptr() && m_unresponsive_layer_serial == m_backing_store_serial && m_unresponsive_layer_alpha == alpha)
+        return m_unresponsive_layer.ptr();
+
+    auto layer_or_error = Gfx::Bitmap::create(Gfx::BitmapFormat::BGRA8888, m_backing_store->size(), m_backing_store->scale());
+    if (layer_or_error.is_error()) {
+        m_unresponsive_layer = nullptr;
+        return nullptr;
+    }
+    auto layer = layer_or_error.release_value();
+    for (int y = 0; y < layer->physical_height(); ++y) {
+        auto const* source = m_backing_store->scanline(y);
+        auto* destination = layer->scanline(y);
+        for (int x = 0; x < layer->physical_width(); ++x) {
+            auto color = Color::from_argb(source[x]);
+            if (color.alpha() == 0) {
+                destination[x] = 0;
+                continue;
+            }
+            color = color.to_grayscale().darkened(0.75f);
+            if (alpha.has_value())
+                color.set_alpha(alpha.value());
+            destination[x] = color.value();
+        }
+    }
+
+    m_unresponsive_layer = move(layer);
+    m_unresponsive_layer_source = m_backing_store.ptr();
+    m_unresponsive_layer_serial = m_backing_store_serial;
+    m_unresponsive_layer_alpha = alpha;
+    return m_unresponsive_layer.ptr();
+}
+
 void Window::set_occluded(bool occluded)
 {
     if (m_occluded == occluded)
@@ -9,11 +9,13 @@
 #include "HitTestResult.h"
 #include <AK/DeprecatedString.h>
 #include <AK/WeakPtr.h>
+#include <LibCore/AnonymousBuffer.h>
 #include <LibCore/Object.h>
 #include <LibGfx/Bitmap.h>
 #include <LibGfx/DisjointRectSet.h>
 #include <LibGfx/Rect.h>
 #include <WindowServer/Cursor.h>
+#include <WindowServer/FrameRing.h>
 #include <WindowServer/Menubar.h>
 #include <WindowServer/Screen.h>
 #include <WindowServer/WindowFrame.h>
@@ -254,6 +256,16 @@ public:
     Gfx::Bitmap* last_backing_store() { return m_last_backing_store.ptr(); }
     i32 last_backing_store_serial() const { return m_last_backing_store_serial; }
 
+    void set_frame_ring(Core::AnonymousBuffer, Vector<NonnullRefPtr<Gfx::Bitmap>, FrameRingState::buffer_count>, Vector<i32> const& serials);
+    void clear_frame_ring();
+    // Takes the newest frame the client has finished painting, if any, and makes it the backing store.
+    bool present_ready_frame();
+
+    // The backing store with the effect for unresponsive clients applied. It's rendered
+    // once and reused until the backing store or the opacity changes.
+    Gfx::Bitmap const* unresponsive_layer();
+    void discard_unresponsive_layer() { m_unresponsive_layer = nullptr; }
+
     void set_automatic_cursor_tracking_enabled(bool enabled) { m_automatic_cursor_tracking_enabled = enabled; }
     bool is_automatic_cursor_tracking() const { return m_automatic_cursor_tracking_enabled; }
 
@@ -442,6 +454,15 @@ private:
     Gfx::IntSize m_backing_store_visible_size {};
     i32 m_backing_store_serial { -1 };
     i32 m_last_backing_store_serial { -1 };
+    Core::AnonymousBuffer m_frame_ring_state_buffer;
+    Vector<NonnullRefPtr<Gfx::Bitmap>, FrameRingState::buffer_count> m_frame_ring_bitmaps;
+    Vector<i32, FrameRingState::buffer_count> m_frame_ring_serials;
+    u32 m_frame_ring_index { FrameRingState::initial_server_buffer_index };
+    u32 m_last_presented_frame_sequence { 0 };
+    RefPtr<Gfx::Bitmap> m_unresponsive_layer;
+    Gfx::Bitmap const* m_unresponsive_layer_source { nullptr };
+    i32 m_unresponsive_layer_serial { -1 };
+    Optional<u8> m_unresponsive_layer_alpha;
     int m_window_id { -1 };
     i32 m_client_id { -1 };
     float m_opacity { 1 };
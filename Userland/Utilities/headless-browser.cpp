@@ -14,13 +14,18 @@
 #include <AK/Badge.h>
 #include <AK/DeprecatedString.h>
 #include <AK/Function.h>
+#include <AK/JsonArray.h>
+#include <AK/JsonObject.h>
 #include <AK/LexicalPath.h>
 #include <AK/NonnullOwnPtr.h>
+#include <AK/QuickSort.h>
 #include <AK/String.h>
 #include <AK/URL.h>
 #include <AK/Vector.h>
 #include <LibCore/ArgsParser.h>
 #include <LibCore/DeprecatedFile.h>
+#include <LibCore/DirIterator.h>
+#include <LibCore/ElapsedTimer.h>
 #include <LibCore/EventLoop.h>
 #include <LibCore/File.h>
 #include <LibCore/Timer.h>
@@ -82,6 +87,17 @@ public:
         return String::from_deprecated_string(client().dump_layout_tree());
     }
 
+    void set_phase_timings_enabled(bool enabled)
+    {
+        client().async_set_phase_timings_enabled(enabled);
+    }
+
+    ErrorOr<JsonObject> take_phase_timings()
+    {
+        auto timings = TRY(JsonValue::from_string(client().take_phase_timings()));
+        return timings.as_object();
+    }
+
     Function<void(const URL&)> on_load_finish;
 
 private:
@@ -190,6 +206,132 @@ static ErrorOr<NonnullRefPtr<Core::Timer>> load_page_for_screenshot_and_exit(Cor
     return timer;
 }
 
+// Loads each page a number of times, after one load to warm up, and prints statistics about how long the load itself
+// and each phase of it took as JSON, one object per page. Each load is followed by painting the whole page.
+class PageLoadBenchmark {
+public:
+    PageLoadBenchmark(Core::EventLoop& event_loop, HeadlessWebContentView& view, Vector<URL> urls, size_t iterations)
+        : m_event_loop(event_loop)
+        , m_view(view)
+        , m_urls(move(urls))
+        , m_iterations(iterations)
+    {
+        // NOTE: The URL the page finished loading at may differ from the one we asked for (e.g. after a redirect),
+        //       so this doesn't compare URLs, but takes the first finished load after each load_page().
+        m_view.on_load_finish = [this](auto const&) {
+            if (!m_is_loading)
+                return;
+            m_is_loading = false;
+            m_load_timeout_timer->stop();
+            did_load_page();
+        };
+    }
+
+    ErrorOr<void> start()
+    {
+        m_load_timeout_timer = TRY(Core::Timer::create_single_shot(load_timeout_ms, [this] {
+            warnln("Timed out after {} seconds while loading {}", load_timeout_ms / 1000, m_urls[m_url_index]);
+            m_event_loop.quit(1);
+        }));
+
+        m_view.set_phase_timings_enabled(true);
+        load_page();
+        return {};
+    }
+
+private:
+    static constexpr int load_timeout_ms = 60'000;
+
+    void load_page()
+    {
+        (void)m_view.take_phase_timings();
+        m_is_loading = true;
+        m_load_timeout_timer->restart();
+        m_load_timer.start();
+        m_view.load(m_urls[m_url_index]);
+    }
+
+    void did_load_page()
+    {
+        // Taking a screenshot makes sure the page has been styled, laid out and painted completely.
+        (void)m_view.take_screenshot();
+        auto load_time = m_load_timer.elapsed_time();
+        auto timings = m_view.take_phase_timings().release_value_but_fixme_should_propagate_errors();
+
+        // The first load is only for warming up caches.
+        if (m_iteration > 0)
+            record_sample(load_time, timings);
+
+        if (++m_iteration <= m_iterations) {
+            load_page();
+            return;
+        }
+
+        m_results.append(summarize_samples());
+        m_samples.clear();
+        m_iteration = 0;
+
+        if (++m_url_index < m_urls.size()) {
+            load_page();
+            return;
+        }
+
+        outln("{}", m_results.to_deprecated_string());
+        m_event_loop.quit(0);
+    }
+
+    void record_sample(Time load_time, JsonObject const& timings)
+    {
+        auto add = [&](DeprecatedString const& metric, double value) {
+            m_samples.ensure(metric).append(value);
+        };
+
+        add("load_ms", static_cast<double>(load_time.to_microseconds()) / 1000.0);
+        timings.get_object("phases"sv)->for_each_member([&](auto const& phase, auto const& totals) {
+            add(DeprecatedString::formatted("{}.ms", phase), totals.as_object().get_double("ms"sv).value_or(0));
+            add(DeprecatedString::formatted("{}.count", phase), totals.as_object().get_double("count"sv).value_or(0));
+        });
+        add("allocated_cells", timings.get_double("allocated_cells"sv).value_or(0));
+    }
+
+    JsonObject summarize_samples()
+    {
+        JsonObject metrics;
+        for (auto& [metric, samples] : m_samples) {
+            quick_sort(samples);
+            double sum = 0;
+            for (auto sample : samples)
+                sum += sample;
+
+            JsonObject summary;
+            summary.set("min", samples.first());
+            summary.set("median", samples[samples.size() / 2]);
+            summary.set("mean", sum / samples.size());
+            summary.set("max", samples.last());
+            metrics.set(metric, move(summary));
+        }
+
+        JsonObject result;
+        result.set("url", m_urls[m_url_index].to_deprecated_string());
+        result.set("iterations", m_iterations);
+        result.set("metrics", move(metrics));
+        return result;
+    }
+
+    Core::EventLoop& m_event_loop;
+    HeadlessWebContentView& m_view;
+    Vector<URL> m_urls;
+    size_t m_iterations { 0 };
+
+    size_t m_url_index { 0 };
+    size_t m_iteration { 0 };
+    bool m_is_loading { false };
+    Core::ElapsedTimer m_load_timer;
+    RefPtr<Core::Timer> m_load_timeout_timer;
+    HashMap<DeprecatedString, Vector<double>> m_samples;
+    JsonArray m_results;
+};
+
 static ErrorOr<URL> format_url(StringView url)
 {
     if (FileSystem::exists(url))
@@ -202,6 +344,28 @@ static ErrorOr<URL> format_url(StringView url)
     return formatted_url;
 }
 
+// Directories stand for all of the HTML files in them.
+static ErrorOr<void> append_benchmark_urls(Vector<URL>& urls, StringView url)
+{
+    if (!FileSystem::is_directory(url)) {
+        TRY(urls.try_append(TRY(format_url(url))));
+        return {};
+    }
+
+    Vector<DeprecatedString> paths;
+    Core::DirIterator iterator(url, Core::DirIterator::SkipDots);
+    while (iterator.has_next()) {
+        auto path = iterator.next_full_path();
+        if (path.ends_with(".html"sv, CaseSensitivity::CaseInsensitive))
+            TRY(paths.try_append(move(path)));
+    }
+    quick_sort(paths);
+
+    for (auto const& path : paths)
+        TRY(urls.try_append(TRY(format_url(path))));
+    return {};
+}
+
 ErrorOr<int> serenity_main(Main::Arguments arguments)
 {
 #if !defined(AK_OS_SERENITY)
@@ -210,20 +374,33 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
     Core::EventLoop event_loop;
 
     int screenshot_timeout = 1;
-    StringView url;
+    Vector<StringView> urls;
     auto resources_folder = "/res"sv;
     StringView web_driver_ipc_path;
     bool dump_layout_tree = false;
+    bool benchmark = false;
+    size_t benchmark_iterations = 10;
 
     Core::ArgsParser args_parser;
     args_parser.set_general_help("This utility runs the Browser in headless mode.");
     args_parser.add_option(screenshot_timeout, "Take a screenshot after [n] seconds (default: 1)", "screenshot", 's', "n");
     args_parser.add_option(dump_layout_tree, "Dump layout tree and exit", "dump-layout-tree", 'd');
+    args_parser.add_option(benchmark, "Load each page repeatedly and print how long loading and rendering it took, as JSON", "benchmark", 'b');
+    args_parser.add_option(benchmark_iterations, "Number of times to load each page when benchmarking (default: 10)", "iterations", 'n', "n");
     args_parser.add_option(resources_folder, "Path of the base resources folder (defaults to /res)", "resources", 'r', "resources-root-path");
     args_parser.add_option(web_driver_ipc_path, "Path to the WebDriver IPC socket", "webdriver-ipc-path", 0, "path");
-    args_parser.add_positional_argument(url, "URL to open", "url", Core::ArgsParser::Required::Yes);
+    args_parser.add_positional_argument(urls, "URL to open, or when benchmarking, any number of URLs, files and directories of HTML files", "url", Core::ArgsParser::Required::Yes);
     args_parser.parse(arguments);
 
+    if (!benchmark && urls.size() > 1) {
+        warnln("Only one URL can be opened unless benchmarking");
+        return 1;
+    }
+    if (benchmark && benchmark_iterations == 0) {
+        warnln("At least one iteration is needed for benchmarking");
+        return 1;
+    }
+
     Gfx::FontDatabase::set_default_font_query("Katica 10 400 0");
     Gfx::FontDatabase::set_window_title_font_query("Katica 10 700 0");
     Gfx::FontDatabase::set_fixed_width_font_query("Csilla 10 400 0");
@@ -240,6 +417,21 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
     auto view = TRY(HeadlessWebContentView::create(move(theme), window_size, web_driver_ipc_path));
     RefPtr<Core::Timer> timer;
 
+    if (benchmark) {
+        Vector<URL> benchmark_urls;
+        for (auto url : urls)
+            TRY(append_benchmark_urls(benchmark_urls, url));
+
+        if (benchmark_urls.is_empty()) {
+            warnln("No pages to benchmark were found");
+            return 1;
+        }
+
+        PageLoadBenchmark page_load_benchmark(event_loop, *view, move(benchmark_urls), benchmark_iterations);
+        TRY(page_load_benchmark.start());
+        return event_loop.exec();
+    }
+
     if (dump_layout_tree) {
         view->on_load_finish = [&](auto const&) {
             auto layout_tree = view->dump_layout_tree().release_value_but_fixme_should_propagate_errors();
@@ -253,6 +445,6 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
         timer = TRY(load_page_for_screenshot_and_exit(event_loop, *view, screenshot_timeout));
     }
 
-    view->load(TRY(format_url(url)));
+    view->load(TRY(format_url(urls.first())));
     return event_loop.exec();
 }
@@ -71,7 +71,6 @@ private:
 
 static bool s_dump_ast = false;
 static bool s_run_bytecode = false;
-static bool s_opt_bytecode = false;
 static bool s_as_module = false;
 static bool s_print_last_result = false;
 static bool s_strip_ansi = false;
@@ -220,7 +219,7 @@ static ErrorOr<bool> parse_and_run(JS::Interpreter& interpreter, StringView sour
 
             auto executable = executable_result.release_value();
             executable->name = source_name;
-            if (s_opt_bytecode) {
+            if (JS::Bytecode::g_optimize_bytecode) {
                 auto& passes = JS::Bytecode::Interpreter::optimization_pipeline(JS::Bytecode::Interpreter::OptimizationLevel::Optimize);
                 passes.perform(*executable);
                 dbgln("Optimisation passes took {}us", passes.elapsed());
@@ -606,7 +605,9 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
     args_parser.add_option(s_dump_ast, "Dump the AST", "dump-ast", 'A');
     args_parser.add_option(JS::Bytecode::g_dump_bytecode, "Dump the bytecode", "dump-bytecode", 'd');
     args_parser.add_option(s_run_bytecode, "Run the bytecode", "run-bytecode", 'b');
-    args_parser.add_option(s_opt_bytecode, "Optimize the bytecode", "optimize-bytecode", 'p');
+    args_parser.add_option(JS::Bytecode::g_optimize_bytecode, "Optimize the bytecode", "optimize-bytecode", 'p');
+    args_parser.add_option(JS::Bytecode::g_dump_instruction_counts, "Dump instruction counts before and after optimization", "dump-instruction-counts", 0);
+    args_parser.add_option(JS::Bytecode::g_use_jit, "Compile the bytecode to native code (x86_64 only)", "jit", 'j');
     args_parser.add_option(s_as_module, "Treat as module", "as-module", 'm');
     args_parser.add_option(s_print_last_result, "Print last result", "print-last-result", 'l');
     args_parser.add_option(s_strip_ansi, "Disable ANSI colors", "disable-ansi-colors", 'i');
@@ -19,6 +19,7 @@
 #include <LibGUI/Painter.h>
 #include <LibGUI/Widget.h>
 #include <LibGUI/Window.h>
+#include <LibGfx/HelperThreads.h>
 #include <LibGfx/ImageFormats/PNGWriter.h>
 #include <LibGfx/Palette.h>
 #include <LibMain/Main.h>
@@ -150,7 +151,10 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
         return 0;
     }
 
-    auto encoded_bitmap_or_error = Gfx::PNGWriter::encode(*bitmap);
+    // Someone is waiting for the screenshot, so it's encoded quickly, on all processors, rather than as small as possible.
+    Gfx::set_maximum_helper_thread_count(Gfx::helper_thread_count_for_online_processors());
+
+    auto encoded_bitmap_or_error = Gfx::PNGWriter::encode(*bitmap, Gfx::PNGWriterOptions::fast(true));
     if (encoded_bitmap_or_error.is_error()) {
         warnln("Failed to encode PNG");
         return 1;
@@ -128,7 +128,7 @@ static bool pre_interpret_hook(Wasm::Configuration& config, Wasm::InstructionPoi
                     warnln("invalid memory index {} (not found)", args[2]);
                     continue;
                 }
-                warnln("{:>32hex-dump}", mem->data().bytes());
+                warnln("{:>32hex-dump}", mem->bytes());
                 continue;
             }
             if (what.is_one_of("i", "instr", "instruction")) {
@@ -278,6 +278,7 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
     bool debug = false;
     bool export_all_imports = false;
     bool shell_mode = false;
+    bool use_guard_pages = false;
     DeprecatedString exported_function_to_execute;
     Vector<u64> values_to_push;
     Vector<DeprecatedString> modules_to_link_in;
@@ -290,6 +291,7 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
     parser.add_option(exported_function_to_execute, "Attempt to execute the named exported function from the module (implies -i)", "execute", 'e', "name");
     parser.add_option(export_all_imports, "Export noop functions corresponding to imports", "export-noop", 0);
     parser.add_option(shell_mode, "Launch a REPL in the module's context (implies -i)", "shell", 's');
+    parser.add_option(use_guard_pages, "Back linear memories with guard pages instead of checking the bounds of every access", "guard-pages", 0);
     parser.add_option(Core::ArgsParser::Option {
         .argument_mode = Core::ArgsParser::OptionArgumentMode::Required,
         .help_string = "Extra modules to link with, use to resolve imports",
@@ -351,6 +353,8 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
 
     if (attempt_instantiate) {
         Wasm::AbstractMachine machine;
+        if (use_guard_pages)
+            machine.enable_guard_page_backed_memories();
         Core::EventLoop main_loop;
         if (debug) {
             g_line_editor = Line::Editor::construct();
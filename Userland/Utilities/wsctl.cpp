@@ -13,11 +13,15 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
     auto app = TRY(GUI::Application::try_create(arguments));
 
     int flash_flush = -1;
+    int show_statistics = -1;
     Core::ArgsParser args_parser;
     args_parser.add_option(flash_flush, "Flash flush (repaint) rectangles", "flash-flush", 'f', "0/1");
+    args_parser.add_option(show_statistics, "Show compositor statistics overlay", "statistics", 's', "0/1");
     args_parser.parse(arguments);
 
     if (flash_flush != -1)
         GUI::ConnectionToWindowServer::the().async_set_flash_flush(flash_flush);
+    if (show_statistics != -1)
+        GUI::ConnectionToWindowServer::the().async_set_show_compositor_statistics(show_statistics);
     return 0;
 }